@@ -41,6 +41,12 @@ struct NanoVDBEditorArgs : public argparse::Args
     int& instance_count = kwarg("instance-count", "Number of headless instances to launch").set_default(1);
     int& device_index = kwarg("d,device", "Vulkan device index").set_default(0);
     std::string& shader_name = kwarg("shader", "Shader name to use").set_default("");
+    int& lod_levels = kwarg("lod", "Number of 2x downsampled LOD levels appended to the input grid").set_default(0);
+    int& residency_budget_mb =
+        kwarg("residency-budget-mb", "Stream NanoVDB leaves when the grid exceeds this device budget").set_default(0);
+    int& gpu_memory_budget_mb =
+        kwarg("gpu-budget-mb", "Evict scene objects not drawn when device memory exceeds this budget").set_default(0);
+    std::string& trace_file = kwarg("trace", "Record a Chrome trace and write it to this path on exit").set_default("");
 };
 
 int main(int argc, char* argv[])
@@ -80,6 +86,13 @@ int main(int argc, char* argv[])
     printf("Instance Count: %d\n", args.instance_count);
     printf("Vulkan device index: %d\n", args.device_index);
     printf("Shader name: '%s'\n", args.shader_name.c_str());
+    printf("LOD levels: %d\n", args.lod_levels);
+    printf("Residency budget: %d MB\n", args.residency_budget_mb);
+    printf("GPU memory budget: %d MB\n", args.gpu_memory_budget_mb);
+    if (!args.trace_file.empty())
+    {
+        printf("Trace file: '%s'\n", args.trace_file.c_str());
+    }
 
     pnanovdb_editor_config_t config = {};
     config.ip_address = args.ip_address.c_str();
@@ -87,6 +100,8 @@ int main(int argc, char* argv[])
     config.headless = args.headless ? PNANOVDB_TRUE : PNANOVDB_FALSE;
     config.streaming = args.streaming ? PNANOVDB_TRUE : PNANOVDB_FALSE;
     config.stream_to_file = args.stream_to_file ? PNANOVDB_TRUE : PNANOVDB_FALSE;
+    config.residency_budget_mb = (pnanovdb_uint32_t)args.residency_budget_mb;
+    config.gpu_memory_budget_mb = (pnanovdb_uint32_t)args.gpu_memory_budget_mb;
 
     if (!args.headless || args.instance_count <= 1u)
     {
@@ -104,6 +119,11 @@ int main(int argc, char* argv[])
             compute.device_interface.create_device_manager(PNANOVDB_FALSE);
         pnanovdb_compute_device_t* device = compute.device_interface.create_device(device_manager, &device_desc);
 
+        if (!args.trace_file.empty())
+        {
+            compute.device_interface.enable_trace(PNANOVDB_TRUE);
+        }
+
         const char* file = args.input_file.c_str();
 
         pnanovdb_editor_t editor = {};
@@ -111,6 +131,16 @@ int main(int argc, char* argv[])
 
 #if 1
         pnanovdb_compute_array_t* data_nanovdb = compute.load_nanovdb(file);
+        if (data_nanovdb && args.lod_levels > 0)
+        {
+            pnanovdb_compute_array_t* data_lod =
+                compute.create_nanovdb_lod(data_nanovdb, (pnanovdb_uint32_t)args.lod_levels);
+            if (data_lod)
+            {
+                compute.destroy_array(data_nanovdb);
+                data_nanovdb = data_lod;
+            }
+        }
 
         pnanovdb_editor_token_t* scene_main = editor.get_token("main");
         pnanovdb_editor_token_t* volume_token = editor.get_token("dragon");
@@ -133,6 +163,11 @@ int main(int argc, char* argv[])
 
         editor.show(&editor, device, &config);
 
+        if (!args.trace_file.empty() && !compute.device_interface.save_trace(args.trace_file.c_str()))
+        {
+            printf("Error: failed to write trace '%s'\n", args.trace_file.c_str());
+        }
+
         pnanovdb_editor_free(&editor);
 
         compute.device_interface.destroy_device(device_manager, device);
@@ -168,6 +203,12 @@ int main(int argc, char* argv[])
             inst.device_manager = inst.compute.device_interface.create_device_manager(PNANOVDB_FALSE);
             inst.device = inst.compute.device_interface.create_device(inst.device_manager, &device_desc);
 
+            // the trace ring is process wide, one instance enables it for all
+            if (inst_idx == 0u && !args.trace_file.empty())
+            {
+                inst.compute.device_interface.enable_trace(PNANOVDB_TRUE);
+            }
+
             const char* file = args.input_file.c_str();
 
             pnanovdb_editor_load(&inst.editor, &inst.compute, &inst.compiler);
@@ -198,6 +239,8 @@ int main(int argc, char* argv[])
             config.headless = args.headless ? PNANOVDB_TRUE : PNANOVDB_FALSE;
             config.streaming = args.streaming ? PNANOVDB_TRUE : PNANOVDB_FALSE;
             config.stream_to_file = args.stream_to_file ? PNANOVDB_TRUE : PNANOVDB_FALSE;
+            config.residency_budget_mb = (pnanovdb_uint32_t)args.residency_budget_mb;
+            config.gpu_memory_budget_mb = (pnanovdb_uint32_t)args.gpu_memory_budget_mb;
             inst.editor.start(&inst.editor, inst.device, &config);
         }
 
@@ -244,6 +287,12 @@ int main(int argc, char* argv[])
 
         printf("Editor wait completed. Cleaning up.\n");
 
+        if (!args.trace_file.empty() &&
+            !instances[0u].compute.device_interface.save_trace(args.trace_file.c_str()))
+        {
+            printf("Error: failed to write trace '%s'\n", args.trace_file.c_str());
+        }
+
         for (size_t inst_idx = 0u; inst_idx < instances.size(); inst_idx++)
         {
             auto& inst = instances[inst_idx];
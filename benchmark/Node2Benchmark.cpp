@@ -0,0 +1,715 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/benchmark/Node2Benchmark.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  CPU access benchmark comparing NanoVDB trees against their Node2 conversion.
+
+            Every benchmark runs over the same query set for both formats, so ns/query is directly comparable.
+            Grids come from .nvdb files, from a NanoVDB level set sphere converted to Node2, or from the
+            Node2 sphere generator (Node2 only, there is no NanoVDB counterpart).
+*/
+
+#define PNANOVDB_C
+#define PNANOVDB_CMATH
+
+#include "nanovdb_editor/PNanoVDBExt.h"
+#include "nanovdb_editor/putil/ThreadPool.hpp"
+
+#include <nanovdb/io/IO.h>
+#include <nanovdb/tools/CreatePrimitives.h>
+
+#include <nlohmann/json.hpp>
+#include <argparse/argparse.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "raster/Sphere.h"
+
+struct Node2BenchmarkArgs : public argparse::Args
+{
+    std::vector<std::string>& input_files =
+        kwarg("i,input", "Input NanoVDB files, float grids only").multi_argument().set_default(std::vector<std::string>{});
+    bool& sphere = flag("sphere", "Benchmark a NanoVDB level set sphere and its Node2 conversion").set_default(false);
+    bool& node2_sphere = flag("node2-sphere", "Benchmark the Node2 sphere generator output (Node2 only)").set_default(false);
+    float& sphere_radius = kwarg("sphere-radius", "Sphere radius in world units").set_default(64.f);
+    float& sphere_voxel_size = kwarg("sphere-voxel-size", "Sphere voxel size").set_default(0.125f);
+    int& query_count = kwarg("q,queries", "Queries per random/stencil benchmark").set_default(1 << 22);
+    int& coherent_count = kwarg("coherent-queries", "Maximum queries per coherent benchmark").set_default(1 << 24);
+    int& repeat = kwarg("r,repeat", "Repetitions per measurement, fastest is reported").set_default(3);
+    int& max_threads = kwarg("t,threads", "Maximum thread count, 0 uses hardware concurrency").set_default(0);
+    int& node2_capacity_mb =
+        kwarg("node2-capacity-mb", "Scratch buffer size for the Node2 conversion/generation").set_default(1024);
+    std::string& json_path = kwarg("j,json", "Write results as JSON to this path").set_default("");
+};
+
+namespace pnanovdb_benchmark
+{
+
+struct nanovdb_grid_t
+{
+    std::vector<pnanovdb_uint32_t> data;
+    pnanovdb_buf_t buf;
+    pnanovdb_grid_type_t grid_type;
+    pnanovdb_root_handle_t root;
+    std::vector<pnanovdb_leaf_handle_t> leaves;
+};
+
+struct node2_grid_t
+{
+    std::vector<pnanovdb_uint32_t> data;
+    pnanovdb_buf_t buf;
+    pnanovdb_node2_handle_t root;
+    pnanovdb_address_t values;
+    pnanovdb_address_t node_inactive_idxs;
+    pnanovdb_address_t inactive_value_idxs;
+    pnanovdb_bool_t is_levelset;
+    std::vector<pnanovdb_node2_handle_t> leaves;
+};
+
+struct benchmark_grid_t
+{
+    std::string name;
+    bool has_nanovdb = false;
+    nanovdb_grid_t nanovdb;
+    node2_grid_t node2;
+    pnanovdb_coord_t bbox_min;
+    pnanovdb_coord_t bbox_max;
+};
+
+struct benchmark_result_t
+{
+    std::string grid;
+    std::string format;
+    std::string benchmark;
+    pnanovdb_uint32_t thread_count;
+    pnanovdb_uint64_t query_count;
+    double seconds;
+    double checksum;
+};
+
+static double now_seconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ----------------------------- grid setup ------------------------------
+
+static void node2_gather_leaves(node2_grid_t& grid)
+{
+    grid.leaves.clear();
+    pnanovdb_uint32_t root_fanout = pnanovdb_node2_fanout_1d[PNANOVDB_NODE2_TYPE_ROOT];
+    for (pnanovdb_uint32_t root_n = 0u; root_n < root_fanout; root_n++)
+    {
+        pnanovdb_node2_handle_t upper = pnanovdb_node2_get_child(grid.buf, grid.root, PNANOVDB_NODE2_TYPE_ROOT, root_n);
+        if (upper.idx64 == 0u)
+        {
+            continue;
+        }
+        pnanovdb_uint32_t upper_fanout = pnanovdb_node2_fanout_1d[PNANOVDB_NODE2_TYPE_UPPER];
+        for (pnanovdb_uint32_t upper_n = 0u; upper_n < upper_fanout; upper_n++)
+        {
+            pnanovdb_node2_handle_t lower = pnanovdb_node2_get_child(grid.buf, upper, PNANOVDB_NODE2_TYPE_UPPER, upper_n);
+            if (lower.idx64 == 0u)
+            {
+                continue;
+            }
+            pnanovdb_uint32_t lower_fanout = pnanovdb_node2_fanout_1d[PNANOVDB_NODE2_TYPE_LOWER];
+            for (pnanovdb_uint32_t lower_n = 0u; lower_n < lower_fanout; lower_n++)
+            {
+                pnanovdb_node2_handle_t leaf =
+                    pnanovdb_node2_get_child(grid.buf, lower, PNANOVDB_NODE2_TYPE_LOWER, lower_n);
+                if (leaf.idx64 != 0u)
+                {
+                    grid.leaves.push_back(leaf);
+                }
+            }
+        }
+    }
+}
+
+static void node2_finalize(node2_grid_t& grid, pnanovdb_coord_t& bbox_min, pnanovdb_coord_t& bbox_max)
+{
+    grid.buf = pnanovdb_make_buf(grid.data.data(), grid.data.size());
+    pnanovdb_grid_handle_t grid_handle = {};
+    pnanovdb_tree_handle_t tree = pnanovdb_grid_get_tree(grid.buf, grid_handle);
+    grid.root.idx64 = pnanovdb_uint32_t(pnanovdb_tree_get_root(grid.buf, tree).address.byte_offset >> 3u);
+
+    pnanovdb_address_t bboxes = pnanovdb_grid_get_gridblindmetadata_value_address(grid.buf, grid_handle, 0u);
+    bbox_min = pnanovdb_read_coord(grid.buf, pnanovdb_address_offset(bboxes, 0u));
+    bbox_max = pnanovdb_read_coord(grid.buf, pnanovdb_address_offset(bboxes, 12u));
+
+    // converted grids carry inactive value tables, generated spheres only carry bbox and values
+    grid.values = pnanovdb_grid_get_gridblindmetadata_value_address(grid.buf, grid_handle, 1u);
+    grid.is_levelset = pnanovdb_grid_get_blind_metadata_count(grid.buf, grid_handle) >= 4u;
+    grid.node_inactive_idxs = pnanovdb_address_null();
+    grid.inactive_value_idxs = pnanovdb_address_null();
+    if (grid.is_levelset)
+    {
+        grid.node_inactive_idxs = pnanovdb_grid_get_gridblindmetadata_value_address(grid.buf, grid_handle, 2u);
+        grid.inactive_value_idxs = pnanovdb_grid_get_gridblindmetadata_value_address(grid.buf, grid_handle, 3u);
+    }
+
+    node2_gather_leaves(grid);
+}
+
+static void node2_shrink(node2_grid_t& grid)
+{
+    pnanovdb_buf_t buf = pnanovdb_make_buf(grid.data.data(), grid.data.size());
+    pnanovdb_grid_handle_t grid_handle = {};
+    pnanovdb_uint64_t grid_size = pnanovdb_grid_get_grid_size(buf, grid_handle);
+    grid.data.resize((grid_size + 3u) / 4u);
+    grid.data.shrink_to_fit();
+}
+
+static bool setup_nanovdb(benchmark_grid_t& grid, const nanovdb::GridHandle<nanovdb::HostBuffer>& handle, int capacity_mb)
+{
+    pnanovdb_uint64_t size = handle.bufferSize();
+    grid.nanovdb.data.resize((size + 3u) / 4u);
+    memcpy(grid.nanovdb.data.data(), handle.data(), size);
+
+    nanovdb_grid_t& src = grid.nanovdb;
+    src.buf = pnanovdb_make_buf(src.data.data(), src.data.size());
+    pnanovdb_grid_handle_t grid_handle = {};
+    src.grid_type = pnanovdb_grid_get_grid_type(src.buf, grid_handle);
+    if (src.grid_type != PNANOVDB_GRID_TYPE_FLOAT)
+    {
+        printf("Skipping '%s', grid_type(%d) is not float\n", grid.name.c_str(), src.grid_type);
+        return false;
+    }
+    pnanovdb_tree_handle_t tree = pnanovdb_grid_get_tree(src.buf, grid_handle);
+    src.root = pnanovdb_tree_get_root(src.buf, tree);
+
+    pnanovdb_uint32_t leaf_count = pnanovdb_tree_get_node_count_leaf(src.buf, tree);
+    pnanovdb_uint32_t leaf_size = PNANOVDB_GRID_TYPE_GET(src.grid_type, leaf_size);
+    pnanovdb_address_t leaf_addr = pnanovdb_address_offset64(tree.address, pnanovdb_tree_get_node_offset_leaf(src.buf, tree));
+    src.leaves.resize(leaf_count);
+    for (pnanovdb_uint32_t leaf_idx = 0u; leaf_idx < leaf_count; leaf_idx++)
+    {
+        src.leaves[leaf_idx].address = pnanovdb_address_offset_product(leaf_addr, leaf_idx, leaf_size);
+    }
+    grid.has_nanovdb = true;
+
+    grid.node2.data.resize(pnanovdb_uint64_t(capacity_mb) * 1024u * 1024u / 4u);
+    pnanovdb_buf_t dst_buf = pnanovdb_make_buf(grid.node2.data.data(), grid.node2.data.size());
+    pnanovdb_address_t dst_addr_max = { pnanovdb_uint64_t(grid.node2.data.size()) * 4u };
+    pnanovdb_convert_to_node2(dst_buf, dst_addr_max, src.buf, grid_handle);
+    node2_shrink(grid.node2);
+
+    pnanovdb_coord_t node2_bbox_min, node2_bbox_max;
+    node2_finalize(grid.node2, node2_bbox_min, node2_bbox_max);
+
+    grid.bbox_min = pnanovdb_root_get_bbox_min(src.buf, src.root);
+    grid.bbox_max = pnanovdb_root_get_bbox_max(src.buf, src.root);
+
+    printf("Grid '%s' nanovdb_size(%llu) node2_size(%llu) leaf_count(%u) node2_leaf_count(%zu)\n", grid.name.c_str(),
+           (unsigned long long int)size, (unsigned long long int)grid.node2.data.size() * 4u, leaf_count,
+           grid.node2.leaves.size());
+    return true;
+}
+
+static bool setup_node2_sphere(benchmark_grid_t& grid, float voxel_size, float radius, int capacity_mb)
+{
+    grid.node2.data.resize(pnanovdb_uint64_t(capacity_mb) * 1024u * 1024u / 4u);
+    pnanovdb_buf_t dst_buf = pnanovdb_make_buf(grid.node2.data.data(), grid.node2.data.size());
+    pnanovdb_address_t dst_addr_max = { pnanovdb_uint64_t(grid.node2.data.size()) * 4u };
+    pnanovdb_node2_generate_sphere(dst_buf, dst_addr_max, voxel_size, radius);
+    node2_shrink(grid.node2);
+    node2_finalize(grid.node2, grid.bbox_min, grid.bbox_max);
+
+    printf("Grid '%s' node2_size(%llu) node2_leaf_count(%zu)\n", grid.name.c_str(),
+           (unsigned long long int)grid.node2.data.size() * 4u, grid.node2.leaves.size());
+    return true;
+}
+
+// ----------------------------- value access ------------------------------
+
+PNANOVDB_FORCE_INLINE float nanovdb_read_value(const nanovdb_grid_t& grid, pnanovdb_coord_t ijk)
+{
+    pnanovdb_address_t addr = pnanovdb_root_get_value_address(grid.grid_type, grid.buf, grid.root, PNANOVDB_REF(ijk));
+    return pnanovdb_read_float(grid.buf, addr);
+}
+
+PNANOVDB_FORCE_INLINE float nanovdb_read_value_cached(const nanovdb_grid_t& grid,
+                                                      pnanovdb_readaccessor_t* acc,
+                                                      pnanovdb_coord_t ijk)
+{
+    pnanovdb_address_t addr = pnanovdb_readaccessor_get_value_address(grid.grid_type, grid.buf, acc, PNANOVDB_REF(ijk));
+    return pnanovdb_read_float(grid.buf, addr);
+}
+
+// inactive level set lookups resolve to the sign bit index, matching the shader path
+PNANOVDB_FORCE_INLINE float node2_read_node_value(const node2_grid_t& grid,
+                                                  pnanovdb_node2_handle_t node,
+                                                  pnanovdb_uint32_t node_type,
+                                                  pnanovdb_uint32_t node_n)
+{
+    pnanovdb_uint64_t value_idx = pnanovdb_node2_get_value_index(
+        grid.buf, node, node_type, node_n, grid.is_levelset, grid.node_inactive_idxs, grid.inactive_value_idxs);
+    return pnanovdb_read_float(grid.buf, pnanovdb_address_offset64_product(grid.values, value_idx, 4u));
+}
+
+PNANOVDB_FORCE_INLINE float node2_read_value(const node2_grid_t& grid, pnanovdb_coord_t ijk)
+{
+    pnanovdb_node2_handle_t node;
+    pnanovdb_uint32_t node_type = 0u;
+    pnanovdb_uint32_t node_n = 0u;
+    pnanovdb_uint32_t level = 0u;
+    pnanovdb_node2_find_node(
+        grid.buf, grid.root, PNANOVDB_REF(node), PNANOVDB_REF(node_type), PNANOVDB_REF(node_n), PNANOVDB_REF(level), ijk);
+    return node2_read_node_value(grid, node, node_type, node_n);
+}
+
+PNANOVDB_FORCE_INLINE float node2_read_value_cached(const node2_grid_t& grid,
+                                                    pnanovdb_node2_accessor_t* acc,
+                                                    pnanovdb_coord_t ijk)
+{
+    pnanovdb_node2_handle_t node;
+    pnanovdb_uint32_t node_type = 0u;
+    pnanovdb_uint32_t node_n = 0u;
+    pnanovdb_uint32_t level = 0u;
+    pnanovdb_node2_accessor_find_node(
+        grid.buf, acc, PNANOVDB_REF(node), PNANOVDB_REF(node_type), PNANOVDB_REF(node_n), PNANOVDB_REF(level), ijk);
+    return node2_read_node_value(grid, node, node_type, node_n);
+}
+
+template <typename ReadFunc>
+PNANOVDB_FORCE_INLINE float sample_trilinear(ReadFunc read, const float* xyz)
+{
+    float fx = floorf(xyz[0]);
+    float fy = floorf(xyz[1]);
+    float fz = floorf(xyz[2]);
+    pnanovdb_coord_t base = { int(fx), int(fy), int(fz) };
+    float u = xyz[0] - fx;
+    float v = xyz[1] - fy;
+    float w = xyz[2] - fz;
+
+    float stencil[8];
+    for (pnanovdb_uint32_t idx = 0u; idx < 8u; idx++)
+    {
+        pnanovdb_coord_t ijk = { base.x + int((idx >> 2u) & 1u), base.y + int((idx >> 1u) & 1u), base.z + int(idx & 1u) };
+        stencil[idx] = read(ijk);
+    }
+    float z00 = stencil[0] + w * (stencil[1] - stencil[0]);
+    float z01 = stencil[2] + w * (stencil[3] - stencil[2]);
+    float z10 = stencil[4] + w * (stencil[5] - stencil[4]);
+    float z11 = stencil[6] + w * (stencil[7] - stencil[6]);
+    float y0 = z00 + v * (z01 - z00);
+    float y1 = z10 + v * (z11 - z10);
+    return y0 + u * (y1 - y0);
+}
+
+// ----------------------------- query generation ------------------------------
+
+static std::vector<pnanovdb_coord_t> make_random_coords(const benchmark_grid_t& grid, pnanovdb_uint64_t count)
+{
+    std::mt19937 rng(1337u);
+    std::uniform_int_distribution<int> dist_x(grid.bbox_min.x, grid.bbox_max.x);
+    std::uniform_int_distribution<int> dist_y(grid.bbox_min.y, grid.bbox_max.y);
+    std::uniform_int_distribution<int> dist_z(grid.bbox_min.z, grid.bbox_max.z);
+    std::vector<pnanovdb_coord_t> coords(count);
+    for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+    {
+        coords[idx] = { dist_x(rng), dist_y(rng), dist_z(rng) };
+    }
+    return coords;
+}
+
+// scanline order with z fastest, the box is centered in the grid bbox and clamped to max_count voxels
+static std::vector<pnanovdb_coord_t> make_coherent_coords(const benchmark_grid_t& grid, pnanovdb_uint64_t max_count)
+{
+    pnanovdb_int64_t dim[3] = { pnanovdb_int64_t(grid.bbox_max.x) - grid.bbox_min.x + 1,
+                                pnanovdb_int64_t(grid.bbox_max.y) - grid.bbox_min.y + 1,
+                                pnanovdb_int64_t(grid.bbox_max.z) - grid.bbox_min.z + 1 };
+    while (dim[0] * dim[1] * dim[2] > pnanovdb_int64_t(max_count))
+    {
+        pnanovdb_uint32_t axis = dim[0] >= dim[1] ? (dim[0] >= dim[2] ? 0u : 2u) : (dim[1] >= dim[2] ? 1u : 2u);
+        dim[axis] = std::max(pnanovdb_int64_t(1), dim[axis] / 2);
+    }
+    pnanovdb_coord_t center = { int((pnanovdb_int64_t(grid.bbox_min.x) + grid.bbox_max.x) / 2),
+                                int((pnanovdb_int64_t(grid.bbox_min.y) + grid.bbox_max.y) / 2),
+                                int((pnanovdb_int64_t(grid.bbox_min.z) + grid.bbox_max.z) / 2) };
+    pnanovdb_coord_t origin = { center.x - int(dim[0] / 2), center.y - int(dim[1] / 2), center.z - int(dim[2] / 2) };
+
+    std::vector<pnanovdb_coord_t> coords;
+    coords.reserve(dim[0] * dim[1] * dim[2]);
+    for (pnanovdb_int64_t i = 0; i < dim[0]; i++)
+    {
+        for (pnanovdb_int64_t j = 0; j < dim[1]; j++)
+        {
+            for (pnanovdb_int64_t k = 0; k < dim[2]; k++)
+            {
+                coords.push_back({ origin.x + int(i), origin.y + int(j), origin.z + int(k) });
+            }
+        }
+    }
+    return coords;
+}
+
+// sample positions in index space, sorted along a random walk so neighbouring queries share leaves
+static std::vector<float> make_stencil_positions(const benchmark_grid_t& grid, pnanovdb_uint64_t count)
+{
+    std::mt19937 rng(4242u);
+    std::uniform_real_distribution<float> dist_step(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> dist_x(float(grid.bbox_min.x), float(grid.bbox_max.x));
+    std::uniform_real_distribution<float> dist_y(float(grid.bbox_min.y), float(grid.bbox_max.y));
+    std::uniform_real_distribution<float> dist_z(float(grid.bbox_min.z), float(grid.bbox_max.z));
+    std::vector<float> positions(3u * count);
+    float pos[3] = { dist_x(rng), dist_y(rng), dist_z(rng) };
+    for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+    {
+        // restart the walk every 256 samples, roughly one ray
+        if ((idx & 255u) == 0u)
+        {
+            pos[0] = dist_x(rng);
+            pos[1] = dist_y(rng);
+            pos[2] = dist_z(rng);
+        }
+        pos[0] += dist_step(rng);
+        pos[1] += dist_step(rng);
+        pos[2] += dist_step(rng);
+        positions[3u * idx + 0u] = pos[0];
+        positions[3u * idx + 1u] = pos[1];
+        positions[3u * idx + 2u] = pos[2];
+    }
+    return positions;
+}
+
+// ----------------------------- runner ------------------------------
+
+// Splits [0, count) into one contiguous range per thread, func(begin, end) returns a partial checksum.
+template <typename Func>
+static benchmark_result_t run_benchmark(pnanovdb_util::ThreadPool& pool,
+                                        pnanovdb_uint32_t thread_count,
+                                        pnanovdb_uint64_t count,
+                                        int repeat,
+                                        Func func)
+{
+    benchmark_result_t result = {};
+    result.thread_count = thread_count;
+    result.query_count = count;
+    result.seconds = 1e30;
+    for (int rep = 0; rep < repeat; rep++)
+    {
+        std::vector<std::future<double>> futures;
+        futures.reserve(thread_count);
+        double time_begin = now_seconds();
+        for (pnanovdb_uint32_t thread_idx = 0u; thread_idx < thread_count; thread_idx++)
+        {
+            pnanovdb_uint64_t begin = (count * thread_idx) / thread_count;
+            pnanovdb_uint64_t end = (count * (thread_idx + 1u)) / thread_count;
+            futures.push_back(pool.enqueue(func, begin, end));
+        }
+        double checksum = 0.0;
+        for (auto& future : futures)
+        {
+            checksum += future.get();
+        }
+        double time_end = now_seconds();
+        result.seconds = std::min(result.seconds, time_end - time_begin);
+        result.checksum = checksum;
+    }
+    return result;
+}
+
+static void run_grid(const benchmark_grid_t& grid,
+                     const Node2BenchmarkArgs& args,
+                     const std::vector<pnanovdb_uint32_t>& thread_counts,
+                     std::vector<benchmark_result_t>& results)
+{
+    const nanovdb_grid_t& src = grid.nanovdb;
+    const node2_grid_t& dst = grid.node2;
+
+    std::vector<pnanovdb_coord_t> random_coords = make_random_coords(grid, pnanovdb_uint64_t(args.query_count));
+    std::vector<pnanovdb_coord_t> coherent_coords = make_coherent_coords(grid, pnanovdb_uint64_t(args.coherent_count));
+    std::vector<float> stencil_positions = make_stencil_positions(grid, pnanovdb_uint64_t(args.query_count));
+
+    auto record = [&](benchmark_result_t result, const char* format, const char* benchmark)
+    {
+        result.grid = grid.name;
+        result.format = format;
+        result.benchmark = benchmark;
+        printf("%-24s %-8s %-14s threads(%2u) queries(%10llu) %10.3f ms %8.2f ns/query %10.2f Mq/s checksum(%g)\n",
+               result.grid.c_str(), format, benchmark, result.thread_count, (unsigned long long int)result.query_count,
+               result.seconds * 1000.0, 1e9 * result.seconds / double(std::max(result.query_count, pnanovdb_uint64_t(1))),
+               double(result.query_count) / (result.seconds * 1e6), result.checksum);
+        results.push_back(result);
+    };
+
+    for (pnanovdb_uint32_t thread_count : thread_counts)
+    {
+        pnanovdb_util::ThreadPool pool(thread_count);
+
+        // random access, no caching
+        if (grid.has_nanovdb)
+        {
+            record(run_benchmark(pool, thread_count, random_coords.size(), args.repeat,
+                                 [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                                 {
+                                     double sum = 0.0;
+                                     for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                     {
+                                         sum += nanovdb_read_value(src, random_coords[idx]);
+                                     }
+                                     return sum;
+                                 }),
+                   "nanovdb", "random");
+        }
+        record(run_benchmark(pool, thread_count, random_coords.size(), args.repeat,
+                             [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                             {
+                                 double sum = 0.0;
+                                 for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                 {
+                                     sum += node2_read_value(dst, random_coords[idx]);
+                                 }
+                                 return sum;
+                             }),
+               "node2", "random");
+
+        // coherent access, no caching
+        if (grid.has_nanovdb)
+        {
+            record(run_benchmark(pool, thread_count, coherent_coords.size(), args.repeat,
+                                 [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                                 {
+                                     double sum = 0.0;
+                                     for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                     {
+                                         sum += nanovdb_read_value(src, coherent_coords[idx]);
+                                     }
+                                     return sum;
+                                 }),
+                   "nanovdb", "coherent");
+        }
+        record(run_benchmark(pool, thread_count, coherent_coords.size(), args.repeat,
+                             [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                             {
+                                 double sum = 0.0;
+                                 for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                 {
+                                     sum += node2_read_value(dst, coherent_coords[idx]);
+                                 }
+                                 return sum;
+                             }),
+               "node2", "coherent");
+
+        // coherent access through accessors
+        if (grid.has_nanovdb)
+        {
+            record(run_benchmark(pool, thread_count, coherent_coords.size(), args.repeat,
+                                 [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                                 {
+                                     pnanovdb_readaccessor_t acc;
+                                     pnanovdb_readaccessor_init(PNANOVDB_REF(acc), src.root);
+                                     double sum = 0.0;
+                                     for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                     {
+                                         sum += nanovdb_read_value_cached(src, &acc, coherent_coords[idx]);
+                                     }
+                                     return sum;
+                                 }),
+                   "nanovdb", "accessor");
+        }
+        record(run_benchmark(pool, thread_count, coherent_coords.size(), args.repeat,
+                             [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                             {
+                                 pnanovdb_node2_accessor_t acc;
+                                 pnanovdb_node2_accessor_init(PNANOVDB_REF(acc), dst.root);
+                                 double sum = 0.0;
+                                 for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                 {
+                                     sum += node2_read_value_cached(dst, &acc, coherent_coords[idx]);
+                                 }
+                                 return sum;
+                             }),
+               "node2", "accessor");
+
+        // leaf iteration over active voxels, queries are leaves
+        if (grid.has_nanovdb)
+        {
+            record(run_benchmark(pool, thread_count, src.leaves.size(), args.repeat,
+                                 [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                                 {
+                                     double sum = 0.0;
+                                     for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                     {
+                                         pnanovdb_leaf_handle_t leaf = src.leaves[idx];
+                                         for (pnanovdb_uint32_t n = 0u; n < 512u; n++)
+                                         {
+                                             if (pnanovdb_leaf_get_value_mask(src.buf, leaf, n))
+                                             {
+                                                 sum += pnanovdb_read_float(
+                                                     src.buf,
+                                                     pnanovdb_leaf_get_table_address(src.grid_type, src.buf, leaf, n));
+                                             }
+                                         }
+                                     }
+                                     return sum;
+                                 }),
+                   "nanovdb", "leaf_iterate");
+        }
+        record(run_benchmark(pool, thread_count, dst.leaves.size(), args.repeat,
+                             [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                             {
+                                 double sum = 0.0;
+                                 for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                 {
+                                     pnanovdb_node2_handle_t leaf = dst.leaves[idx];
+                                     for (pnanovdb_uint32_t n = 0u; n < 512u; n++)
+                                     {
+                                         if (pnanovdb_node2_get_value_mask_bit(dst.buf, leaf, PNANOVDB_NODE2_TYPE_LEAF, n))
+                                         {
+                                             sum += node2_read_node_value(dst, leaf, PNANOVDB_NODE2_TYPE_LEAF, n);
+                                         }
+                                     }
+                                 }
+                                 return sum;
+                             }),
+               "node2", "leaf_iterate");
+
+        // trilinear stencil through accessors
+        pnanovdb_uint64_t stencil_count = stencil_positions.size() / 3u;
+        if (grid.has_nanovdb)
+        {
+            record(run_benchmark(pool, thread_count, stencil_count, args.repeat,
+                                 [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                                 {
+                                     pnanovdb_readaccessor_t acc;
+                                     pnanovdb_readaccessor_init(PNANOVDB_REF(acc), src.root);
+                                     auto read = [&](pnanovdb_coord_t ijk)
+                                     { return nanovdb_read_value_cached(src, &acc, ijk); };
+                                     double sum = 0.0;
+                                     for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                     {
+                                         sum += sample_trilinear(read, &stencil_positions[3u * idx]);
+                                     }
+                                     return sum;
+                                 }),
+                   "nanovdb", "trilinear");
+        }
+        record(run_benchmark(pool, thread_count, stencil_count, args.repeat,
+                             [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                             {
+                                 pnanovdb_node2_accessor_t acc;
+                                 pnanovdb_node2_accessor_init(PNANOVDB_REF(acc), dst.root);
+                                 auto read = [&](pnanovdb_coord_t ijk) { return node2_read_value_cached(dst, &acc, ijk); };
+                                 double sum = 0.0;
+                                 for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                                 {
+                                     sum += sample_trilinear(read, &stencil_positions[3u * idx]);
+                                 }
+                                 return sum;
+                             }),
+               "node2", "trilinear");
+    }
+}
+
+static bool write_json(const char* path, const std::vector<benchmark_result_t>& results)
+{
+    nlohmann::json root;
+    root["benchmark"] = "node2";
+    root["hardware_concurrency"] = std::thread::hardware_concurrency();
+    nlohmann::json& entries = root["results"];
+    entries = nlohmann::json::array();
+    for (const benchmark_result_t& result : results)
+    {
+        double query_count = double(std::max(result.query_count, pnanovdb_uint64_t(1)));
+        entries.push_back({ { "grid", result.grid },
+                            { "format", result.format },
+                            { "benchmark", result.benchmark },
+                            { "threads", result.thread_count },
+                            { "queries", result.query_count },
+                            { "seconds", result.seconds },
+                            { "ns_per_query", 1e9 * result.seconds / query_count },
+                            { "mqueries_per_second", query_count / (result.seconds * 1e6) },
+                            { "checksum", result.checksum } });
+    }
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        printf("Error: failed to open '%s' for writing\n", path);
+        return false;
+    }
+    file << root.dump(4) << std::endl;
+    return true;
+}
+
+} // namespace pnanovdb_benchmark
+
+int main(int argc, char* argv[])
+{
+    using namespace pnanovdb_benchmark;
+
+    auto args = argparse::parse<Node2BenchmarkArgs>(argc, argv);
+
+    std::vector<benchmark_grid_t> grids;
+    for (const std::string& path : args.input_files)
+    {
+        benchmark_grid_t grid;
+        grid.name = path.substr(path.find_last_of("/\\") + 1u);
+        nanovdb::GridHandle<nanovdb::HostBuffer> handle = nanovdb::io::readGrid(path, 0);
+        if (setup_nanovdb(grid, handle, args.node2_capacity_mb))
+        {
+            grids.push_back(std::move(grid));
+        }
+    }
+    if (args.sphere)
+    {
+        benchmark_grid_t grid;
+        grid.name = "sphere_ls";
+        nanovdb::GridHandle<nanovdb::HostBuffer> handle = nanovdb::tools::createLevelSetSphere<float>(
+            args.sphere_radius, nanovdb::Vec3d(0.0), args.sphere_voxel_size);
+        if (setup_nanovdb(grid, handle, args.node2_capacity_mb))
+        {
+            grids.push_back(std::move(grid));
+        }
+    }
+    if (args.node2_sphere)
+    {
+        benchmark_grid_t grid;
+        grid.name = "node2_sphere";
+        if (setup_node2_sphere(grid, args.sphere_voxel_size, args.sphere_radius, args.node2_capacity_mb))
+        {
+            grids.push_back(std::move(grid));
+        }
+    }
+    if (grids.empty())
+    {
+        printf("No grids to benchmark, pass --input, --sphere or --node2-sphere\n");
+        return 1;
+    }
+
+    pnanovdb_uint32_t max_threads = args.max_threads > 0 ? pnanovdb_uint32_t(args.max_threads) :
+                                                           std::max(1u, std::thread::hardware_concurrency());
+    std::vector<pnanovdb_uint32_t> thread_counts;
+    for (pnanovdb_uint32_t thread_count = 1u; thread_count < max_threads; thread_count *= 2u)
+    {
+        thread_counts.push_back(thread_count);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::vector<benchmark_result_t> results;
+    for (const benchmark_grid_t& grid : grids)
+    {
+        run_grid(grid, args, thread_counts, results);
+    }
+
+    if (!args.json_path.empty() && !write_json(args.json_path.c_str(), results))
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,484 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/benchmark/RadixSortBenchmark.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  GPU keys per second of the parallel primitives radix sorts, multi pass against onesweep.
+
+            Sorts random 32-bit keys with radix_sort and 64-bit keys with radix_sort_key64, from 1M to 256M keys.
+            Each timed frame restores the unsorted keys before every sort, the restore copies are timed on their own
+            and subtracted. The last sort of every run is read back and checked against the input.
+*/
+
+#include "nanovdb_editor/putil/Compiler.h"
+#include "nanovdb_editor/putil/Compute.h"
+#include "nanovdb_editor/putil/ParallelPrimitives.h"
+
+#include <nlohmann/json.hpp>
+#include <argparse/argparse.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct RadixSortBenchmarkArgs : public argparse::Args
+{
+    int& min_log2_keys = kwarg("min-log2-keys", "Smallest key count as a power of two").set_default(20);
+    int& max_log2_keys = kwarg("max-log2-keys", "Largest key count as a power of two").set_default(28);
+    int& log2_step = kwarg("log2-step", "Power of two step between key counts").set_default(2);
+    int& iterations = kwarg("i,iterations", "Timed sorts per key count and mode").set_default(8);
+    int& range_bits = kwarg("range-bits", "Random low bits per key, 0 for all, fewer leave high digits constant")
+                          .set_default(0);
+    bool& skip_key32 = flag("skip-key32", "Skip the 32-bit key sorts").set_default(false);
+    bool& skip_key64 = flag("skip-key64", "Skip the 64-bit key sorts").set_default(false);
+    int& seed = kwarg("seed", "Random seed of the keys").set_default(7);
+    std::string& json_path = kwarg("j,json", "Write results as JSON to this path").set_default("");
+};
+
+namespace pnanovdb_benchmark
+{
+
+struct gpu_t
+{
+    pnanovdb_compiler_t compiler = {};
+    pnanovdb_compute_t compute = {};
+    pnanovdb_compute_device_manager_t* device_manager = nullptr;
+    pnanovdb_compute_device_t* device = nullptr;
+    pnanovdb_compute_queue_t* queue = nullptr;
+    pnanovdb_compute_interface_t* compute_interface = nullptr;
+    pnanovdb_compute_context_t* context = nullptr;
+    pnanovdb_parallel_primitives_t parallel_primitives = {};
+    pnanovdb_parallel_primitives_context_t* parallel_primitives_ctx = nullptr;
+};
+
+struct sort_mode_t
+{
+    pnanovdb_uint32_t mode;
+    const char* name;
+};
+
+static const sort_mode_t k_sort_modes[] = {
+    { PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_MULTI_PASS, "multi_pass" },
+    { PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP, "onesweep" },
+};
+
+struct benchmark_result_t
+{
+    pnanovdb_uint32_t key_bits = 0u;
+    std::string mode;
+    pnanovdb_uint64_t key_count = 0u;
+    double seconds_per_sort = 0.0;
+    double keys_per_second = 0.0;
+    bool sorted = false;
+};
+
+// device buffers of one key count, src keeps the unsorted keys, work is sorted in place
+struct sort_buffers_t
+{
+    pnanovdb_compute_buffer_t* key_src = nullptr;
+    pnanovdb_compute_buffer_t* val_src = nullptr;
+    pnanovdb_compute_buffer_t* key_work = nullptr;
+    pnanovdb_compute_buffer_t* val_work = nullptr;
+};
+
+static double now_seconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool gpu_init(gpu_t& gpu)
+{
+    pnanovdb_compiler_load(&gpu.compiler);
+    if (!gpu.compiler.module)
+    {
+        printf("Error: compiler module not available\n");
+        return false;
+    }
+    pnanovdb_compute_load(&gpu.compute, &gpu.compiler);
+    if (!gpu.compute.module)
+    {
+        printf("Error: compute module not available\n");
+        return false;
+    }
+
+    pnanovdb_compute_device_desc_t device_desc = {};
+    gpu.device_manager = gpu.compute.device_interface.create_device_manager(PNANOVDB_FALSE);
+    gpu.device = gpu.device_manager ? gpu.compute.device_interface.create_device(gpu.device_manager, &device_desc) :
+                                      nullptr;
+    if (!gpu.device)
+    {
+        printf("Error: no Vulkan device available\n");
+        return false;
+    }
+    gpu.queue = gpu.compute.device_interface.get_compute_queue(gpu.device);
+    gpu.compute_interface = gpu.compute.device_interface.get_compute_interface(gpu.queue);
+    gpu.context = gpu.compute.device_interface.get_compute_context(gpu.queue);
+
+    pnanovdb_parallel_primitives_load(&gpu.parallel_primitives, &gpu.compute);
+    if (!gpu.parallel_primitives.create_context)
+    {
+        return false;
+    }
+    gpu.parallel_primitives_ctx = gpu.parallel_primitives.create_context(&gpu.compute, gpu.queue);
+    if (!gpu.parallel_primitives_ctx)
+    {
+        printf("Error: failed to compile the parallel primitives shaders\n");
+        return false;
+    }
+    return true;
+}
+
+static void gpu_destroy(gpu_t& gpu)
+{
+    if (gpu.parallel_primitives_ctx)
+    {
+        gpu.parallel_primitives.destroy_context(&gpu.compute, gpu.queue, gpu.parallel_primitives_ctx);
+    }
+    pnanovdb_parallel_primitives_free(&gpu.parallel_primitives);
+    if (gpu.device)
+    {
+        gpu.compute.device_interface.destroy_device(gpu.device_manager, gpu.device);
+    }
+    if (gpu.device_manager)
+    {
+        gpu.compute.device_interface.destroy_device_manager(gpu.device_manager);
+    }
+    if (gpu.compute.module)
+    {
+        pnanovdb_compute_free(&gpu.compute);
+    }
+    if (gpu.compiler.module)
+    {
+        pnanovdb_compiler_free(&gpu.compiler);
+    }
+}
+
+static void gpu_flush_wait(gpu_t& gpu)
+{
+    pnanovdb_uint64_t flushed_frame = 0llu;
+    gpu.compute.device_interface.flush(gpu.queue, &flushed_frame, nullptr, nullptr);
+    gpu.compute.device_interface.wait_idle(gpu.queue);
+}
+
+static pnanovdb_compute_buffer_t* create_buffer(gpu_t& gpu,
+                                                pnanovdb_compute_memory_type_t memory_type,
+                                                pnanovdb_compute_buffer_usage_t usage,
+                                                pnanovdb_uint32_t structure_stride,
+                                                pnanovdb_uint64_t size_in_bytes)
+{
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+    buf_desc.usage = usage;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = structure_stride;
+    buf_desc.size_in_bytes = size_in_bytes;
+    return gpu.compute_interface->create_buffer(gpu.context, memory_type, &buf_desc);
+}
+
+static void copy_buffer(gpu_t& gpu,
+                        pnanovdb_compute_buffer_t* src,
+                        pnanovdb_compute_buffer_t* dst,
+                        pnanovdb_uint64_t num_bytes,
+                        const char* label)
+{
+    pnanovdb_compute_copy_buffer_params_t copy_params = {};
+    copy_params.num_bytes = num_bytes;
+    copy_params.src = gpu.compute_interface->register_buffer_as_transient(gpu.context, src);
+    copy_params.dst = gpu.compute_interface->register_buffer_as_transient(gpu.context, dst);
+    copy_params.debug_label = label;
+    gpu.compute_interface->copy_buffer(gpu.context, &copy_params);
+}
+
+static void sort_work(gpu_t& gpu, const sort_buffers_t& buffers, pnanovdb_uint64_t key_count, bool key64)
+{
+    if (key64)
+    {
+        gpu.parallel_primitives.radix_sort_key64(&gpu.compute, gpu.queue, gpu.parallel_primitives_ctx,
+                                                 buffers.key_work, buffers.val_work, key_count, key_count, 64u);
+    }
+    else
+    {
+        gpu.parallel_primitives.radix_sort(&gpu.compute, gpu.queue, gpu.parallel_primitives_ctx, buffers.key_work,
+                                           buffers.val_work, key_count, key_count, 32u);
+    }
+}
+
+// restores the unsorted keys, then sorts them when requested, returns seconds per iteration
+static double time_frame(gpu_t& gpu,
+                         const sort_buffers_t& buffers,
+                         pnanovdb_uint64_t key_count,
+                         bool key64,
+                         pnanovdb_uint32_t iterations,
+                         bool sort)
+{
+    pnanovdb_uint64_t key_bytes = key_count * (key64 ? 8u : 4u);
+    double begin = now_seconds();
+    for (pnanovdb_uint32_t iteration = 0u; iteration < iterations; iteration++)
+    {
+        copy_buffer(gpu, buffers.key_src, buffers.key_work, key_bytes, "radix_sort_benchmark_restore_key");
+        copy_buffer(gpu, buffers.val_src, buffers.val_work, key_count * 4u, "radix_sort_benchmark_restore_val");
+        if (sort)
+        {
+            sort_work(gpu, buffers, key_count, key64);
+        }
+    }
+    gpu_flush_wait(gpu);
+    return (now_seconds() - begin) / double(iterations);
+}
+
+// sorted order with equal keys in input order, every output key matches the input key its value points at
+static bool verify_sorted(gpu_t& gpu,
+                          const sort_buffers_t& buffers,
+                          const std::vector<pnanovdb_uint64_t>& keys,
+                          bool key64)
+{
+    pnanovdb_uint64_t key_count = keys.size();
+    pnanovdb_uint64_t key_bytes = key_count * (key64 ? 8u : 4u);
+    pnanovdb_compute_buffer_t* key_readback = create_buffer(
+        gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST, 0u, key_bytes);
+    pnanovdb_compute_buffer_t* val_readback = create_buffer(
+        gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST, 0u, key_count * 4u);
+
+    copy_buffer(gpu, buffers.key_work, key_readback, key_bytes, "radix_sort_benchmark_readback_key");
+    copy_buffer(gpu, buffers.val_work, val_readback, key_count * 4u, "radix_sort_benchmark_readback_val");
+    gpu_flush_wait(gpu);
+
+    const void* mapped_keys = gpu.compute_interface->map_buffer(gpu.context, key_readback);
+    const pnanovdb_uint32_t* mapped_vals =
+        (const pnanovdb_uint32_t*)gpu.compute_interface->map_buffer(gpu.context, val_readback);
+
+    bool sorted = mapped_keys && mapped_vals;
+    for (pnanovdb_uint64_t idx = 0u; sorted && idx < key_count; idx++)
+    {
+        pnanovdb_uint64_t key =
+            key64 ? ((const pnanovdb_uint64_t*)mapped_keys)[idx] : ((const pnanovdb_uint32_t*)mapped_keys)[idx];
+        pnanovdb_uint32_t val = mapped_vals[idx];
+        if (val >= key_count || keys[val] != key)
+        {
+            sorted = false;
+        }
+        else if (idx > 0u)
+        {
+            pnanovdb_uint64_t prev_key = key64 ? ((const pnanovdb_uint64_t*)mapped_keys)[idx - 1u] :
+                                                 ((const pnanovdb_uint32_t*)mapped_keys)[idx - 1u];
+            pnanovdb_uint32_t prev_val = mapped_vals[idx - 1u];
+            sorted = prev_key < key || (prev_key == key && prev_val < val);
+        }
+    }
+
+    gpu.compute_interface->unmap_buffer(gpu.context, key_readback);
+    gpu.compute_interface->unmap_buffer(gpu.context, val_readback);
+    gpu.compute_interface->destroy_buffer(gpu.context, key_readback);
+    gpu.compute_interface->destroy_buffer(gpu.context, val_readback);
+    return sorted;
+}
+
+static bool upload_keys(gpu_t& gpu,
+                        const sort_buffers_t& buffers,
+                        const std::vector<pnanovdb_uint64_t>& keys,
+                        bool key64)
+{
+    pnanovdb_uint64_t key_count = keys.size();
+    pnanovdb_uint64_t key_bytes = key_count * (key64 ? 8u : 4u);
+    pnanovdb_compute_buffer_t* key_upload =
+        create_buffer(gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC, 0u, key_bytes);
+    pnanovdb_compute_buffer_t* val_upload = create_buffer(
+        gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC, 0u, key_count * 4u);
+    if (!key_upload || !val_upload)
+    {
+        if (key_upload)
+        {
+            gpu.compute_interface->destroy_buffer(gpu.context, key_upload);
+        }
+        if (val_upload)
+        {
+            gpu.compute_interface->destroy_buffer(gpu.context, val_upload);
+        }
+        return false;
+    }
+
+    void* mapped_keys = gpu.compute_interface->map_buffer(gpu.context, key_upload);
+    pnanovdb_uint32_t* mapped_vals = (pnanovdb_uint32_t*)gpu.compute_interface->map_buffer(gpu.context, val_upload);
+    for (pnanovdb_uint64_t idx = 0u; idx < key_count; idx++)
+    {
+        if (key64)
+        {
+            ((pnanovdb_uint64_t*)mapped_keys)[idx] = keys[idx];
+        }
+        else
+        {
+            ((pnanovdb_uint32_t*)mapped_keys)[idx] = pnanovdb_uint32_t(keys[idx]);
+        }
+        mapped_vals[idx] = pnanovdb_uint32_t(idx);
+    }
+    gpu.compute_interface->unmap_buffer(gpu.context, key_upload);
+    gpu.compute_interface->unmap_buffer(gpu.context, val_upload);
+
+    copy_buffer(gpu, key_upload, buffers.key_src, key_bytes, "radix_sort_benchmark_upload_key");
+    copy_buffer(gpu, val_upload, buffers.val_src, key_count * 4u, "radix_sort_benchmark_upload_val");
+    gpu_flush_wait(gpu);
+
+    gpu.compute_interface->destroy_buffer(gpu.context, key_upload);
+    gpu.compute_interface->destroy_buffer(gpu.context, val_upload);
+    return true;
+}
+
+static void run_key_count(gpu_t& gpu,
+                          const RadixSortBenchmarkArgs& args,
+                          pnanovdb_uint64_t key_count,
+                          bool key64,
+                          std::vector<benchmark_result_t>& results)
+{
+    pnanovdb_uint32_t key_bits = key64 ? 64u : 32u;
+    pnanovdb_uint32_t range_bits = args.range_bits > 0 ? std::min(pnanovdb_uint32_t(args.range_bits), key_bits) :
+                                                         key_bits;
+    pnanovdb_uint64_t range_mask = range_bits >= 64u ? ~0llu : ((1llu << range_bits) - 1u);
+
+    std::mt19937_64 rng(pnanovdb_uint64_t(args.seed) + key_count + key_bits);
+    std::vector<pnanovdb_uint64_t> keys(key_count);
+    for (pnanovdb_uint64_t& key : keys)
+    {
+        key = rng() & range_mask;
+    }
+
+    pnanovdb_compute_buffer_usage_t usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED |
+                                            PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
+                                            PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC |
+                                            PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+    pnanovdb_uint32_t key_size = key64 ? 8u : 4u;
+    sort_buffers_t buffers;
+    buffers.key_src = create_buffer(gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, usage, key_size, key_count * key_size);
+    buffers.val_src = create_buffer(gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, usage, 4u, key_count * 4u);
+    buffers.key_work = create_buffer(gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, usage, key_size, key_count * key_size);
+    buffers.val_work = create_buffer(gpu, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, usage, 4u, key_count * 4u);
+
+    bool allocated = buffers.key_src && buffers.val_src && buffers.key_work && buffers.val_work;
+    if (allocated && upload_keys(gpu, buffers, keys, key64))
+    {
+        pnanovdb_uint32_t iterations = pnanovdb_uint32_t(std::max(args.iterations, 1));
+
+        // the restore copies alone, subtracted from every sort
+        time_frame(gpu, buffers, key_count, key64, 1u, false);
+        double restore_seconds = time_frame(gpu, buffers, key_count, key64, iterations, false);
+
+        for (const sort_mode_t& sort_mode : k_sort_modes)
+        {
+            gpu.parallel_primitives.set_radix_sort_mode(gpu.parallel_primitives_ctx, sort_mode.mode);
+
+            // warm up pipelines and the buffer pool
+            time_frame(gpu, buffers, key_count, key64, 1u, true);
+
+            benchmark_result_t result;
+            result.key_bits = key_bits;
+            result.mode = sort_mode.name;
+            result.key_count = key_count;
+            result.seconds_per_sort =
+                std::max(time_frame(gpu, buffers, key_count, key64, iterations, true) - restore_seconds, 1e-9);
+            result.keys_per_second = double(key_count) / result.seconds_per_sort;
+            result.sorted = verify_sorted(gpu, buffers, keys, key64);
+
+            printf("key%-2u %-10s %10llu keys %9.3f ms %8.3f Gkeys/s %s\n", key_bits, result.mode.c_str(),
+                   (unsigned long long)key_count, 1e3 * result.seconds_per_sort, 1e-9 * result.keys_per_second,
+                   result.sorted ? "sorted" : "NOT SORTED");
+            results.push_back(result);
+        }
+        gpu.parallel_primitives.set_radix_sort_mode(
+            gpu.parallel_primitives_ctx, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_AUTO);
+    }
+    else
+    {
+        printf("key%-2u %10llu keys skipped, buffers did not fit in device memory\n", key_bits,
+               (unsigned long long)key_count);
+    }
+
+    pnanovdb_compute_buffer_t* device_buffers[4u] = { buffers.key_src, buffers.val_src, buffers.key_work,
+                                                      buffers.val_work };
+    for (pnanovdb_compute_buffer_t* buffer : device_buffers)
+    {
+        if (buffer)
+        {
+            gpu.compute_interface->destroy_buffer(gpu.context, buffer);
+        }
+    }
+    gpu_flush_wait(gpu);
+}
+
+static bool write_json(const char* path,
+                       const RadixSortBenchmarkArgs& args,
+                       const std::vector<benchmark_result_t>& results)
+{
+    nlohmann::json root;
+    root["benchmark"] = "radix_sort";
+    root["range_bits"] = args.range_bits;
+    nlohmann::json& entries = root["results"];
+    entries = nlohmann::json::array();
+    for (const benchmark_result_t& result : results)
+    {
+        entries.push_back({ { "key_bits", result.key_bits },
+                            { "mode", result.mode },
+                            { "key_count", result.key_count },
+                            { "ms_per_sort", 1e3 * result.seconds_per_sort },
+                            { "keys_per_second", result.keys_per_second },
+                            { "sorted", result.sorted } });
+    }
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        printf("Error: failed to open '%s' for writing\n", path);
+        return false;
+    }
+    file << root.dump(4) << std::endl;
+    return true;
+}
+
+} // namespace pnanovdb_benchmark
+
+int main(int argc, char* argv[])
+{
+    using namespace pnanovdb_benchmark;
+
+    auto args = argparse::parse<RadixSortBenchmarkArgs>(argc, argv);
+    if (args.min_log2_keys < 0 || args.max_log2_keys > 29 || args.min_log2_keys > args.max_log2_keys ||
+        args.log2_step <= 0)
+    {
+        printf("Error: key counts must lie in [2^0, 2^29] with a positive step\n");
+        return 1;
+    }
+
+    gpu_t gpu;
+    if (!gpu_init(gpu))
+    {
+        gpu_destroy(gpu);
+        return 1;
+    }
+
+    std::vector<benchmark_result_t> results;
+    for (int key64 = 0; key64 < 2; key64++)
+    {
+        if ((key64 == 0 && args.skip_key32) || (key64 != 0 && args.skip_key64))
+        {
+            continue;
+        }
+        for (int log2_keys = args.min_log2_keys; log2_keys <= args.max_log2_keys; log2_keys += args.log2_step)
+        {
+            run_key_count(gpu, args, 1llu << log2_keys, key64 != 0, results);
+        }
+    }
+
+    gpu_destroy(gpu);
+
+    bool all_sorted = std::all_of(
+        results.begin(), results.end(), [](const benchmark_result_t& result) { return result.sorted; });
+    if (!args.json_path.empty() && !write_json(args.json_path.c_str(), args, results))
+    {
+        return 1;
+    }
+    return all_sorted ? 0 : 1;
+}
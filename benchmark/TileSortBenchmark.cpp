@@ -0,0 +1,633 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/benchmark/TileSortBenchmark.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  CPU model of the tile sort of raster_gaussian_2d over camera paths, full against coherent sort.
+
+            The full sort radix sorts every tile intersection by depth and then by tile, as radix_sort_dual_key does.
+            The coherent sort compacts the visible gaussians in the previous frame's depth order, fixes them up with
+            the windowed passes of CoherentSort.h and only sorts the tile id, falling back to the full sort when keys
+            remain out of order. Both produce the same keys, frames where they differ are reported as mismatches.
+*/
+
+#define PNANOVDB_C
+#define PNANOVDB_CMATH
+
+#include "nanovdb_editor/putil/Camera.h"
+
+#include "raster/CoherentSort.h"
+
+#include <nlohmann/json.hpp>
+#include <argparse/argparse.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct TileSortBenchmarkArgs : public argparse::Args
+{
+    int& point_count = kwarg("n,points", "Gaussians in the synthetic cloud").set_default(1 << 20);
+    int& frame_count = kwarg("f,frames", "Frames per built-in camera path").set_default(240);
+    int& width = kwarg("width", "Image width").set_default(1920);
+    int& height = kwarg("height", "Image height").set_default(1080);
+    int& tile_size = kwarg("tile-size", "Tile size in pixels").set_default(16);
+    std::vector<std::string>& paths = kwarg("p,path", "Recorded camera paths, JSON arrays of camera states")
+                                          .multi_argument()
+                                          .set_default(std::vector<std::string>{});
+    bool& skip_builtin = flag("skip-builtin", "Only run the recorded camera paths").set_default(false);
+    int& seed = kwarg("seed", "Random seed of the cloud and the jitter path").set_default(7);
+    std::string& json_path = kwarg("j,json", "Write results as JSON to this path").set_default("");
+};
+
+namespace pnanovdb_benchmark
+{
+
+static constexpr float k_cloud_radius = 10.f;
+
+struct camera_path_t
+{
+    std::string name;
+    std::vector<pnanovdb_camera_state_t> states;
+};
+
+struct gaussian_cloud_t
+{
+    std::vector<float> means;
+    std::vector<float> scales;
+};
+
+// per frame projection shared by both sorts, as the GPU projection pass is
+struct frame_projection_t
+{
+    std::vector<pnanovdb_uint32_t> tile_rect; // min x, min y, max x, max y, max exclusive
+    std::vector<pnanovdb_uint32_t> depth_key;
+    std::vector<pnanovdb_uint32_t> visible;
+};
+
+struct sort_state_t
+{
+    std::vector<pnanovdb_uint32_t> depth_order;
+    bool has_view = false;
+    pnanovdb_camera_mat_t view = {};
+};
+
+struct tile_sort_buffers_t
+{
+    std::vector<pnanovdb_uint32_t> keys_low;
+    std::vector<pnanovdb_uint32_t> keys_high;
+    std::vector<pnanovdb_uint32_t> vals;
+    std::vector<pnanovdb_uint32_t> scratch_keys;
+    std::vector<pnanovdb_uint32_t> scratch_vals;
+    std::vector<pnanovdb_uint32_t> order_keys;
+    std::vector<pnanovdb_uint32_t> order_vals;
+};
+
+struct benchmark_result_t
+{
+    std::string path;
+    std::string mode;
+    pnanovdb_uint32_t frame_count;
+    pnanovdb_uint32_t coherent_count;
+    pnanovdb_uint32_t fallback_count;
+    pnanovdb_uint32_t mismatch_count;
+    double intersections_per_frame;
+    double seconds;
+};
+
+static double now_seconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static pnanovdb_uint32_t float_key(float v)
+{
+    pnanovdb_uint32_t key;
+    memcpy(&key, &v, sizeof(key));
+    return key;
+}
+
+// ----------------------------- scene ------------------------------
+
+// clustered cloud like a captured scene, many small splats around a few surfaces
+static gaussian_cloud_t make_cloud(pnanovdb_uint32_t point_count, pnanovdb_uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(-1.f, 1.f);
+    std::normal_distribution<float> spread(0.f, 0.6f);
+    std::uniform_real_distribution<float> scale_dist(0.01f, 0.06f);
+
+    const pnanovdb_uint32_t cluster_count = 64u;
+    std::vector<float> centers(3u * cluster_count);
+    for (float& c : centers)
+    {
+        c = 0.8f * k_cloud_radius * unit(rng);
+    }
+
+    gaussian_cloud_t cloud;
+    cloud.means.resize(3u * point_count);
+    cloud.scales.resize(point_count);
+    for (pnanovdb_uint32_t idx = 0u; idx < point_count; idx++)
+    {
+        const float* center = &centers[3u * (rng() % cluster_count)];
+        for (pnanovdb_uint32_t axis = 0u; axis < 3u; axis++)
+        {
+            cloud.means[3u * idx + axis] = center[axis] + spread(rng);
+        }
+        cloud.scales[idx] = scale_dist(rng);
+    }
+    return cloud;
+}
+
+static pnanovdb_camera_state_t orbit_state(float angle, float elevation, float distance)
+{
+    pnanovdb_camera_state_t state = {};
+    state.eye_direction = { -cosf(elevation) * sinf(angle), -sinf(elevation), -cosf(elevation) * cosf(angle) };
+    state.eye_up = { 0.f, 1.f, 0.f };
+    state.eye_distance_from_position = distance;
+    state.orthographic_scale = 1.f;
+    return state;
+}
+
+static std::vector<camera_path_t> make_builtin_paths(pnanovdb_uint32_t frame_count, pnanovdb_uint32_t seed)
+{
+    const float pi = 3.14159265f;
+    const float distance = 2.5f * k_cloud_radius;
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.f, 0.002f);
+
+    std::vector<camera_path_t> paths(5u);
+    paths[0u].name = "orbit";
+    paths[1u].name = "dolly";
+    paths[2u].name = "pan";
+    paths[3u].name = "jitter";
+    paths[4u].name = "cuts";
+    for (pnanovdb_uint32_t frame = 0u; frame < frame_count; frame++)
+    {
+        float t = float(frame) / float(std::max(frame_count, 2u) - 1u);
+
+        // a full turn over the path
+        paths[0u].states.push_back(orbit_state(2.f * pi * t, 0.3f, distance));
+
+        // flies in from far to inside the cloud
+        paths[1u].states.push_back(orbit_state(0.5f, 0.2f, distance * (1.2f - t)));
+
+        pnanovdb_camera_state_t pan = orbit_state(0.f, 0.f, distance);
+        pan.position = { k_cloud_radius * (2.f * t - 1.f), 0.f, 0.f };
+        paths[2u].states.push_back(pan);
+
+        // a handheld camera holding still
+        paths[3u].states.push_back(orbit_state(0.4f + noise(rng), 0.2f + noise(rng), distance));
+
+        // a slow orbit cutting to another side every 30 frames
+        paths[4u].states.push_back(orbit_state(0.5f * pi * float(frame / 30u) + 0.2f * t, 0.3f, distance));
+    }
+    return paths;
+}
+
+static bool read_vec3(const nlohmann::json& value, pnanovdb_vec3_t* dst)
+{
+    if (!value.is_array() || value.size() != 3u)
+    {
+        return false;
+    }
+    *dst = { value[0].get<float>(), value[1].get<float>(), value[2].get<float>() };
+    return true;
+}
+
+// fields as saved by the editor camera states
+static bool load_camera_path(const std::string& path, camera_path_t* dst)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        printf("Error: failed to open camera path '%s'\n", path.c_str());
+        return false;
+    }
+    nlohmann::json root = nlohmann::json::parse(file, nullptr, false);
+    if (!root.is_array())
+    {
+        printf("Error: camera path '%s' is not a JSON array of camera states\n", path.c_str());
+        return false;
+    }
+    dst->name = path.substr(path.find_last_of("/\\") + 1u);
+    for (const nlohmann::json& entry : root)
+    {
+        pnanovdb_camera_state_t state = {};
+        state.orthographic_scale = 1.f;
+        if (!entry.is_object() || !read_vec3(entry.value("position", nlohmann::json()), &state.position) ||
+            !read_vec3(entry.value("eye_direction", nlohmann::json()), &state.eye_direction) ||
+            !read_vec3(entry.value("eye_up", nlohmann::json()), &state.eye_up) ||
+            !entry.contains("eye_distance_from_position"))
+        {
+            printf("Error: camera path '%s' has an invalid camera state\n", path.c_str());
+            return false;
+        }
+        state.eye_distance_from_position = entry["eye_distance_from_position"].get<float>();
+        dst->states.push_back(state);
+    }
+    return !dst->states.empty();
+}
+
+// ----------------------------- projection ------------------------------
+
+static void project_frame(const gaussian_cloud_t& cloud,
+                          const pnanovdb_camera_mat_t& view,
+                          const pnanovdb_camera_mat_t& projection,
+                          const TileSortBenchmarkArgs& args,
+                          frame_projection_t& frame)
+{
+    const pnanovdb_uint32_t point_count = pnanovdb_uint32_t(cloud.scales.size());
+    const pnanovdb_uint32_t num_tiles_w = (args.width + args.tile_size - 1) / args.tile_size;
+    const pnanovdb_uint32_t num_tiles_h = (args.height + args.tile_size - 1) / args.tile_size;
+    const float fx = 0.5f * float(args.width) * projection.x.x;
+    const float fy = 0.5f * float(args.height) * projection.y.y;
+    const float near_plane = 0.1f;
+
+    frame.tile_rect.assign(4u * point_count, 0u);
+    frame.depth_key.assign(point_count, 0u);
+    frame.visible.assign(point_count, 0u);
+    for (pnanovdb_uint32_t idx = 0u; idx < point_count; idx++)
+    {
+        const float* mean = &cloud.means[3u * idx];
+        float x = mean[0] * view.x.x + mean[1] * view.y.x + mean[2] * view.z.x + view.w.x;
+        float y = mean[0] * view.x.y + mean[1] * view.y.y + mean[2] * view.z.y + view.w.y;
+        // right handed view, the camera looks down -z
+        float depth = -(mean[0] * view.x.z + mean[1] * view.y.z + mean[2] * view.z.z + view.w.z);
+        if (depth < near_plane)
+        {
+            continue;
+        }
+        float radius = ceilf(3.f * cloud.scales[idx] * fx / depth);
+        float tile_u = (fx * x / depth + 0.5f * float(args.width)) / float(args.tile_size);
+        float tile_v = (-fy * y / depth + 0.5f * float(args.height)) / float(args.tile_size);
+        float tile_radius = radius / float(args.tile_size);
+
+        pnanovdb_uint32_t* rect = &frame.tile_rect[4u * idx];
+        rect[0] = pnanovdb_uint32_t(std::min(std::max(0.f, floorf(tile_u - tile_radius)), float(num_tiles_w)));
+        rect[1] = pnanovdb_uint32_t(std::min(std::max(0.f, floorf(tile_v - tile_radius)), float(num_tiles_h)));
+        rect[2] = pnanovdb_uint32_t(std::min(std::max(0.f, ceilf(tile_u + tile_radius)), float(num_tiles_w)));
+        rect[3] = pnanovdb_uint32_t(std::min(std::max(0.f, ceilf(tile_v + tile_radius)), float(num_tiles_h)));
+        if (rect[0] < rect[2] && rect[1] < rect[3])
+        {
+            frame.depth_key[idx] = float_key(depth);
+            frame.visible[idx] = 1u;
+        }
+    }
+}
+
+// ----------------------------- sorts ------------------------------
+
+// stable LSD radix sort of the low key_bit_count bits, 8 bits per pass
+static void radix_sort(std::vector<pnanovdb_uint32_t>& keys,
+                       std::vector<pnanovdb_uint32_t>& vals,
+                       std::vector<pnanovdb_uint32_t>& scratch_keys,
+                       std::vector<pnanovdb_uint32_t>& scratch_vals,
+                       pnanovdb_uint64_t count,
+                       pnanovdb_uint32_t key_bit_count)
+{
+    scratch_keys.resize(keys.size());
+    scratch_vals.resize(vals.size());
+    for (pnanovdb_uint32_t shift = 0u; shift < key_bit_count; shift += 8u)
+    {
+        pnanovdb_uint64_t offsets[256u] = {};
+        for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+        {
+            offsets[(keys[idx] >> shift) & 0xFFu]++;
+        }
+        pnanovdb_uint64_t sum = 0u;
+        for (pnanovdb_uint64_t& offset : offsets)
+        {
+            pnanovdb_uint64_t bucket = offset;
+            offset = sum;
+            sum += bucket;
+        }
+        for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+        {
+            pnanovdb_uint64_t dst = offsets[(keys[idx] >> shift) & 0xFFu]++;
+            scratch_keys[dst] = keys[idx];
+            scratch_vals[dst] = vals[idx];
+        }
+        keys.swap(scratch_keys);
+        vals.swap(scratch_vals);
+    }
+}
+
+static pnanovdb_uint32_t tile_id_bits(const TileSortBenchmarkArgs& args)
+{
+    pnanovdb_uint32_t num_tiles = ((args.width + args.tile_size - 1) / args.tile_size) *
+                                  ((args.height + args.tile_size - 1) / args.tile_size);
+    pnanovdb_uint32_t bits = 0u;
+    while ((1u << bits) < num_tiles)
+    {
+        bits++;
+    }
+    return bits;
+}
+
+// mirrors gaussian_tile_intersections.slang, one key pair per covered tile in the order of the visible list
+static void emit_intersections(const frame_projection_t& frame,
+                               const std::vector<pnanovdb_uint32_t>& visible_list,
+                               pnanovdb_uint64_t visible_count,
+                               pnanovdb_uint32_t num_tiles_w,
+                               tile_sort_buffers_t& buffers)
+{
+    buffers.keys_low.clear();
+    buffers.keys_high.clear();
+    buffers.vals.clear();
+    for (pnanovdb_uint64_t idx = 0u; idx < visible_count; idx++)
+    {
+        pnanovdb_uint32_t prim_idx = visible_list[idx];
+        const pnanovdb_uint32_t* rect = &frame.tile_rect[4u * prim_idx];
+        for (pnanovdb_uint32_t tile_y = rect[1]; tile_y < rect[3]; tile_y++)
+        {
+            for (pnanovdb_uint32_t tile_x = rect[0]; tile_x < rect[2]; tile_x++)
+            {
+                buffers.keys_low.push_back(frame.depth_key[prim_idx]);
+                buffers.keys_high.push_back(tile_y * num_tiles_w + tile_x);
+                buffers.vals.push_back(prim_idx);
+            }
+        }
+    }
+}
+
+static void full_sort(tile_sort_buffers_t& buffers, pnanovdb_uint32_t num_tile_id_bits)
+{
+    pnanovdb_uint64_t count = buffers.vals.size();
+    // depth first, then a stable sort by tile carrying the high keys along
+    std::vector<pnanovdb_uint32_t> order(count);
+    for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+    {
+        order[idx] = pnanovdb_uint32_t(idx);
+    }
+    radix_sort(buffers.keys_low, order, buffers.scratch_keys, buffers.scratch_vals, count, 32u);
+    std::vector<pnanovdb_uint32_t> keys_high(count);
+    std::vector<pnanovdb_uint32_t> vals(count);
+    for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+    {
+        keys_high[idx] = buffers.keys_high[order[idx]];
+        vals[idx] = buffers.vals[order[idx]];
+    }
+    radix_sort(keys_high, vals, buffers.scratch_keys, buffers.scratch_vals, count, num_tile_id_bits);
+    buffers.keys_high.swap(keys_high);
+    buffers.vals.swap(vals);
+}
+
+static void run_full(const frame_projection_t& frame,
+                     const TileSortBenchmarkArgs& args,
+                     tile_sort_buffers_t& buffers)
+{
+    std::vector<pnanovdb_uint32_t> visible_list;
+    for (pnanovdb_uint32_t idx = 0u; idx < pnanovdb_uint32_t(frame.visible.size()); idx++)
+    {
+        if (frame.visible[idx])
+        {
+            visible_list.push_back(idx);
+        }
+    }
+    pnanovdb_uint32_t num_tiles_w = (args.width + args.tile_size - 1) / args.tile_size;
+    emit_intersections(frame, visible_list, visible_list.size(), num_tiles_w, buffers);
+    full_sort(buffers, tile_id_bits(args));
+}
+
+// returns true when the fixup left keys out of order and the full sort ran
+static bool run_coherent(const frame_projection_t& frame,
+                         const TileSortBenchmarkArgs& args,
+                         sort_state_t& state,
+                         tile_sort_buffers_t& buffers)
+{
+    const pnanovdb_uint32_t point_count = pnanovdb_uint32_t(frame.visible.size());
+    if (state.depth_order.size() != point_count)
+    {
+        state.depth_order.resize(point_count);
+        for (pnanovdb_uint32_t idx = 0u; idx < point_count; idx++)
+        {
+            state.depth_order[idx] = idx;
+        }
+    }
+
+    // visible gaussians in the previous order, as gaussian_sort_scatter.slang
+    std::vector<pnanovdb_uint32_t>& order = buffers.order_vals;
+    order.clear();
+    for (pnanovdb_uint32_t prim_idx : state.depth_order)
+    {
+        if (frame.visible[prim_idx])
+        {
+            order.push_back(prim_idx);
+        }
+    }
+    pnanovdb_uint64_t visible_count = order.size();
+
+    std::vector<pnanovdb_uint32_t>& keys = buffers.order_keys;
+    keys.resize(visible_count);
+    for (pnanovdb_uint64_t idx = 0u; idx < visible_count; idx++)
+    {
+        keys[idx] = frame.depth_key[order[idx]];
+    }
+    pnanovdb_raster::coherent_sort_fixup(keys.data(), order.data(), visible_count,
+                                         pnanovdb_raster::k_coherent_sort_fixup_passes);
+    bool fallback = pnanovdb_raster::count_sort_inversions(keys.data(), visible_count) != 0u;
+
+    pnanovdb_uint32_t num_tiles_w = (args.width + args.tile_size - 1) / args.tile_size;
+    emit_intersections(frame, order, visible_count, num_tiles_w, buffers);
+    if (fallback)
+    {
+        full_sort(buffers, tile_id_bits(args));
+        radix_sort(keys, order, buffers.scratch_keys, buffers.scratch_vals, visible_count, 32u);
+    }
+    else
+    {
+        radix_sort(buffers.keys_high, buffers.vals, buffers.scratch_keys, buffers.scratch_vals,
+                   buffers.vals.size(), tile_id_bits(args));
+    }
+
+    // back into the visible slots, as gaussian_sort_merge.slang
+    pnanovdb_uint64_t visible_idx = 0u;
+    for (pnanovdb_uint32_t& prim_idx : state.depth_order)
+    {
+        if (frame.visible[prim_idx])
+        {
+            prim_idx = order[visible_idx++];
+        }
+    }
+    return fallback;
+}
+
+// ----------------------------- driver ------------------------------
+
+static void run_path(const camera_path_t& path,
+                     const gaussian_cloud_t& cloud,
+                     const TileSortBenchmarkArgs& args,
+                     std::vector<benchmark_result_t>& results)
+{
+    const char* mode_names[3] = { "full", "coherent", "auto" };
+    const pnanovdb_uint32_t modes[3] = { PNANOVDB_RASTER_TILE_SORT_FULL, PNANOVDB_RASTER_TILE_SORT_COHERENT,
+                                         PNANOVDB_RASTER_TILE_SORT_AUTO };
+    const pnanovdb_vec3_t scene_center = { 0.f, 0.f, 0.f };
+
+    pnanovdb_camera_t camera;
+    pnanovdb_camera_init(&camera);
+    camera.config.far_plane = 1000.f;
+
+    // projections are shared by every mode, only the sort is timed
+    std::vector<frame_projection_t> frames(path.states.size());
+    std::vector<pnanovdb_camera_mat_t> views(path.states.size());
+    for (size_t frame_idx = 0u; frame_idx < path.states.size(); frame_idx++)
+    {
+        camera.state = path.states[frame_idx];
+        pnanovdb_camera_mat_t projection;
+        pnanovdb_camera_get_view(&camera, &views[frame_idx]);
+        pnanovdb_camera_get_projection(&camera, &projection, float(args.width), float(args.height));
+        project_frame(cloud, views[frame_idx], projection, args, frames[frame_idx]);
+    }
+
+    std::vector<tile_sort_buffers_t> reference(path.states.size());
+    for (pnanovdb_uint32_t mode_idx = 0u; mode_idx < 3u; mode_idx++)
+    {
+        benchmark_result_t result = {};
+        result.path = path.name;
+        result.mode = mode_names[mode_idx];
+        result.frame_count = pnanovdb_uint32_t(path.states.size());
+
+        sort_state_t state;
+        tile_sort_buffers_t buffers;
+        double intersection_count = 0.0;
+        for (size_t frame_idx = 0u; frame_idx < frames.size(); frame_idx++)
+        {
+            pnanovdb_raster::camera_delta_t delta = {};
+            if (state.has_view)
+            {
+                delta = pnanovdb_raster::compute_camera_delta(state.view, views[frame_idx], scene_center);
+            }
+            bool coherent = pnanovdb_raster::use_coherent_sort(modes[mode_idx], state.has_view, delta);
+            state.view = views[frame_idx];
+            state.has_view = true;
+
+            double begin = now_seconds();
+            if (coherent)
+            {
+                result.fallback_count += run_coherent(frames[frame_idx], args, state, buffers) ? 1u : 0u;
+                result.coherent_count++;
+            }
+            else
+            {
+                run_full(frames[frame_idx], args, buffers);
+            }
+            result.seconds += now_seconds() - begin;
+            intersection_count += double(buffers.vals.size());
+
+            if (mode_idx == 0u)
+            {
+                reference[frame_idx].keys_high = buffers.keys_high;
+                reference[frame_idx].vals = buffers.vals;
+            }
+            else
+            {
+                // gaussians of equal depth may swap, compare their keys instead of the order of the values
+                const tile_sort_buffers_t& ref = reference[frame_idx];
+                bool match = ref.keys_high == buffers.keys_high && ref.vals.size() == buffers.vals.size();
+                const std::vector<pnanovdb_uint32_t>& depth_key = frames[frame_idx].depth_key;
+                for (size_t idx = 0u; match && idx < ref.vals.size(); idx++)
+                {
+                    match = depth_key[ref.vals[idx]] == depth_key[buffers.vals[idx]];
+                }
+                result.mismatch_count += match ? 0u : 1u;
+            }
+        }
+        result.intersections_per_frame = intersection_count / double(std::max(result.frame_count, 1u));
+
+        double ms_per_frame = 1e3 * result.seconds / double(std::max(result.frame_count, 1u));
+        printf("%-12s %-9s %8.3f ms/frame %10.0f isects/frame coherent %4u fallback %4u mismatch %u\n",
+               result.path.c_str(), result.mode.c_str(), ms_per_frame, result.intersections_per_frame,
+               result.coherent_count, result.fallback_count, result.mismatch_count);
+        results.push_back(result);
+    }
+}
+
+static bool write_json(const char* path, const std::vector<benchmark_result_t>& results)
+{
+    nlohmann::json root;
+    root["benchmark"] = "tile_sort";
+    nlohmann::json& entries = root["results"];
+    entries = nlohmann::json::array();
+    for (const benchmark_result_t& result : results)
+    {
+        double frame_count = double(std::max(result.frame_count, 1u));
+        entries.push_back({ { "path", result.path },
+                            { "mode", result.mode },
+                            { "frames", result.frame_count },
+                            { "seconds", result.seconds },
+                            { "ms_per_frame", 1e3 * result.seconds / frame_count },
+                            { "intersections_per_frame", result.intersections_per_frame },
+                            { "coherent_frames", result.coherent_count },
+                            { "fallback_frames", result.fallback_count },
+                            { "fallback_rate", result.coherent_count ?
+                                                   double(result.fallback_count) / double(result.coherent_count) :
+                                                   0.0 },
+                            { "mismatch_frames", result.mismatch_count } });
+    }
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        printf("Error: failed to open '%s' for writing\n", path);
+        return false;
+    }
+    file << root.dump(4) << std::endl;
+    return true;
+}
+
+} // namespace pnanovdb_benchmark
+
+int main(int argc, char* argv[])
+{
+    using namespace pnanovdb_benchmark;
+
+    auto args = argparse::parse<TileSortBenchmarkArgs>(argc, argv);
+    if (args.point_count <= 0 || args.frame_count <= 0 || args.width <= 0 || args.height <= 0 || args.tile_size <= 0)
+    {
+        printf("Error: points, frames, width, height and tile size must be positive\n");
+        return 1;
+    }
+
+    std::vector<camera_path_t> paths;
+    if (!args.skip_builtin)
+    {
+        paths = make_builtin_paths(pnanovdb_uint32_t(args.frame_count), pnanovdb_uint32_t(args.seed));
+    }
+    for (const std::string& file : args.paths)
+    {
+        camera_path_t path;
+        if (load_camera_path(file, &path))
+        {
+            paths.push_back(std::move(path));
+        }
+    }
+    if (paths.empty())
+    {
+        printf("No camera paths to benchmark, pass --path or drop --skip-builtin\n");
+        return 1;
+    }
+
+    gaussian_cloud_t cloud = make_cloud(pnanovdb_uint32_t(args.point_count), pnanovdb_uint32_t(args.seed));
+
+    std::vector<benchmark_result_t> results;
+    for (const camera_path_t& path : paths)
+    {
+        run_path(path, cloud, args, results);
+    }
+
+    if (!args.json_path.empty() && !write_json(args.json_path.c_str(), results))
+    {
+        return 1;
+    }
+    return 0;
+}
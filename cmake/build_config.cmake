@@ -27,6 +27,7 @@ else()
 endif()
 
 option(NANOVDB_EDITOR_BUILD_TESTS "Configure CMake to build gtests for NanoVDB Editor" ON)
+option(NANOVDB_EDITOR_BUILD_BENCHMARKS "Build benchmark executables for NanoVDB Editor" OFF)
 
 # Select optional vcpkg manifest features before project() enables the toolchain
 if(NANOVDB_EDITOR_USE_VCPKG AND NANOVDB_EDITOR_E57_FORMAT)
@@ -157,3 +158,4 @@ message(STATUS "  Slang Debug Output: ${NANOVDB_EDITOR_SLANG_DEBUG_OUTPUT}")
 message(STATUS "  Use GLFW: ${NANOVDB_EDITOR_USE_GLFW}")
 message(STATUS "  H264 Support: ${NANOVDB_EDITOR_USE_H264}")
 message(STATUS "  Build Tests: ${NANOVDB_EDITOR_BUILD_TESTS}")
+message(STATUS "  Build Benchmarks: ${NANOVDB_EDITOR_BUILD_BENCHMARKS}")
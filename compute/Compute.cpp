@@ -143,8 +143,8 @@ static void compute_profiler_report(void* userdata,
     printf("'%s' profiler results capture_id(%llu):\n", name, (unsigned long long int)capture_id);
     for (pnanovdb_uint32_t idx = 0u; idx < num_entries; idx++)
     {
-        printf("[%d] name(%s) cpu_ms(%f) gpu_ms(%f)\n", idx, entries[idx].label, 1000.f * entries[idx].cpu_delta_time,
-               1000.f * entries[idx].gpu_delta_time);
+        printf("[%d] name(%s) cpu_ms(%f) gpu_ms(%f) barriers(%u)\n", idx, entries[idx].label,
+               1000.f * entries[idx].cpu_delta_time, 1000.f * entries[idx].gpu_delta_time, entries[idx].barrier_count);
     }
 }
 
@@ -347,6 +347,31 @@ void dispatch_shader(pnanovdb_compute_interface_t* contextInterface,
     contextInterface->dispatch(computeContext, &dispatch_params);
 }
 
+void dispatch_shader_indirect(pnanovdb_compute_interface_t* contextInterface,
+                              pnanovdb_compute_context_t* computeContext,
+                              const pnanovdb_shader_context_t* shaderContext,
+                              pnanovdb_compute_resource_t* resources,
+                              pnanovdb_compute_buffer_transient_t* indirect_buffer,
+                              pnanovdb_uint64_t indirect_offset,
+                              const char* debug_label)
+{
+    auto shader = cast(shaderContext);
+
+    pnanovdb_compute_dispatch_params_t dispatch_params = {};
+    dispatch_params.pipeline = shader->pipeline;
+
+    dispatch_params.descriptor_writes = shader->shader_build->descriptor_writes;
+    dispatch_params.resources = resources;
+    dispatch_params.descriptor_write_count = shader->shader_build->descriptor_write_count;
+
+    dispatch_params.debug_label = debug_label ? debug_label : shader->shader_build->debug_label;
+
+    dispatch_params.indirect_buffer = indirect_buffer;
+    dispatch_params.indirect_offset = indirect_offset;
+
+    contextInterface->dispatch(computeContext, &dispatch_params);
+}
+
 pnanovdb_bool_t dispatch_shader_on_nanovdb_array(const pnanovdb_compute_t* compute,
                                                  const pnanovdb_compute_device_t* device,
                                                  const pnanovdb_shader_context_t* shader_context,
@@ -462,18 +487,28 @@ pnanovdb_bool_t dispatch_shader_on_nanovdb_array(const pnanovdb_compute_t* compu
     return PNANOVDB_TRUE;
 }
 
-pnanovdb_bool_t dispatch_shader_on_array(const pnanovdb_compute_t* compute,
-                                         const pnanovdb_compute_device_t* device,
-                                         const char* shader_path,
-                                         pnanovdb_uint32_t grid_dim_x,
-                                         pnanovdb_uint32_t grid_dim_y,
-                                         pnanovdb_uint32_t grid_dim_z,
-                                         pnanovdb_compute_array_t* data_in,
-                                         pnanovdb_compute_array_t* constants,
-                                         pnanovdb_compute_array_t* data_out,
-                                         pnanovdb_uint32_t dispatch_count,
-                                         pnanovdb_uint64_t scratch_size,
-                                         pnanovdb_uint64_t scratch_clear_size)
+pnanovdb_uint64_t enqueue_readback(const pnanovdb_compute_t* compute,
+                                   pnanovdb_compute_queue_t* queue,
+                                   pnanovdb_compute_readback_queue_t* readback_queue,
+                                   pnanovdb_compute_buffer_transient_t* src,
+                                   pnanovdb_uint64_t num_bytes);
+bool readback_queue_is_full(pnanovdb_compute_readback_queue_t* readback_queue);
+
+// without a readback queue data_out is filled before returning, else data_out only sizes the queued result
+static pnanovdb_bool_t dispatch_shader_on_array_impl(const pnanovdb_compute_t* compute,
+                                                     const pnanovdb_compute_device_t* device,
+                                                     const char* shader_path,
+                                                     pnanovdb_uint32_t grid_dim_x,
+                                                     pnanovdb_uint32_t grid_dim_y,
+                                                     pnanovdb_uint32_t grid_dim_z,
+                                                     pnanovdb_compute_array_t* data_in,
+                                                     pnanovdb_compute_array_t* constants,
+                                                     pnanovdb_compute_array_t* data_out,
+                                                     pnanovdb_uint32_t dispatch_count,
+                                                     pnanovdb_uint64_t scratch_size,
+                                                     pnanovdb_uint64_t scratch_clear_size,
+                                                     pnanovdb_compute_readback_queue_t* readback_queue,
+                                                     pnanovdb_uint64_t* dst_ticket)
 {
     if (!compute || !device)
     {
@@ -518,8 +553,11 @@ pnanovdb_bool_t dispatch_shader_on_array(const pnanovdb_compute_t* compute,
     auto* shader = cast(shader_context);
     auto* clear_shader = cast(clear_shader_context);
 
-    compute->device_interface.enable_profiler(
-        compute_context, (void*)"dispatch_shader_on_array", compute_profiler_report);
+    if (!readback_queue)
+    {
+        compute->device_interface.enable_profiler(
+            compute_context, (void*)"dispatch_shader_on_array", compute_profiler_report);
+    }
 
     pnanovdb_compute_buffer_desc_t buf_desc = {};
 
@@ -551,12 +589,17 @@ pnanovdb_bool_t dispatch_shader_on_array(const pnanovdb_compute_t* compute,
     buf_desc.size_in_bytes = data_out->element_count == 0u ? 65536u : data_out->element_count * data_out->element_size;
     pnanovdb_compute_buffer_t* data_out_device =
         compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
-    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
-    buf_desc.structure_stride = 0u;
-    buf_desc.size_in_bytes = data_out->element_count == 0u ? 65536u : data_out->element_count * data_out->element_size;
-    pnanovdb_compute_buffer_t* data_out_readback =
-        compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+    pnanovdb_compute_buffer_t* data_out_readback = nullptr;
+    if (!readback_queue)
+    {
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+        buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+        buf_desc.structure_stride = 0u;
+        buf_desc.size_in_bytes =
+            data_out->element_count == 0u ? 65536u : data_out->element_count * data_out->element_size;
+        data_out_readback =
+            compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+    }
 
     // scratch buffer
     buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
@@ -635,34 +678,57 @@ pnanovdb_bool_t dispatch_shader_on_array(const pnanovdb_compute_t* compute,
         compute_interface->dispatch(compute_context, &dispatch_params);
     }
 
-    // readback data_out
-    copy_params.num_bytes = data_out->element_count * data_out->element_size;
-    copy_params.src = compute_interface->register_buffer_as_transient(compute_context, data_out_device);
-    copy_params.dst = compute_interface->register_buffer_as_transient(compute_context, data_out_readback);
-    copy_params.debug_label = "dispatch_shader_on_array_readback";
-    compute_interface->copy_buffer(compute_context, &copy_params);
-
+    pnanovdb_bool_t result = PNANOVDB_TRUE;
     pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+    if (readback_queue)
+    {
+        // buffers and pipelines below are released after the frame completes, no need to wait here
+        pnanovdb_uint64_t ticket =
+            enqueue_readback(compute, queue, readback_queue,
+                             compute_interface->register_buffer_as_transient(compute_context, data_out_device),
+                             data_out->element_count * data_out->element_size);
+        if (dst_ticket)
+        {
+            *dst_ticket = ticket;
+        }
+        result = ticket != 0u ? PNANOVDB_TRUE : PNANOVDB_FALSE;
+
+        compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+    }
+    else
+    {
+        // readback data_out
+        copy_params.num_bytes = data_out->element_count * data_out->element_size;
+        copy_params.src = compute_interface->register_buffer_as_transient(compute_context, data_out_device);
+        copy_params.dst = compute_interface->register_buffer_as_transient(compute_context, data_out_readback);
+        copy_params.debug_label = "dispatch_shader_on_array_readback";
+        compute_interface->copy_buffer(compute_context, &copy_params);
+
+        compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
 
-    compute->device_interface.wait_idle(queue);
+        compute->device_interface.wait_idle(queue);
 
-    // to flush profile
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+        // to flush profile
+        compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
 
-    // copy data_out
-    void* mapped_data_out = compute_interface->map_buffer(compute_context, data_out_readback);
-    memcpy(data_out->data, mapped_data_out, data_out->element_count * data_out->element_size);
-    compute_interface->unmap_buffer(compute_context, data_out_readback);
+        // copy data_out
+        void* mapped_data_out = compute_interface->map_buffer(compute_context, data_out_readback);
+        memcpy(data_out->data, mapped_data_out, data_out->element_count * data_out->element_size);
+        compute_interface->unmap_buffer(compute_context, data_out_readback);
+
+        compute_interface->destroy_buffer(compute_context, data_out_readback);
+    }
 
     compute_interface->destroy_buffer(compute_context, data_in_upload);
     compute_interface->destroy_buffer(compute_context, data_in_device);
     compute_interface->destroy_buffer(compute_context, constant_buffer);
     compute_interface->destroy_buffer(compute_context, data_out_device);
-    compute_interface->destroy_buffer(compute_context, data_out_readback);
     compute_interface->destroy_buffer(compute_context, scratch_device);
 
-    compute->device_interface.disable_profiler(compute_context);
+    if (!readback_queue)
+    {
+        compute->device_interface.disable_profiler(compute_context);
+    }
 
     compute->destroy_shader(compute_interface, &compute->shader_interface, compute_context, shader_context);
     compute->destroy_shader(compute_interface, &compute->shader_interface, compute_context, clear_shader_context);
@@ -670,7 +736,54 @@ pnanovdb_bool_t dispatch_shader_on_array(const pnanovdb_compute_t* compute,
     compute->destroy_shader_context(compute, queue, shader_context);
     compute->destroy_shader_context(compute, queue, clear_shader_context);
 
-    return PNANOVDB_TRUE;
+    return result;
+}
+
+pnanovdb_bool_t dispatch_shader_on_array(const pnanovdb_compute_t* compute,
+                                         const pnanovdb_compute_device_t* device,
+                                         const char* shader_path,
+                                         pnanovdb_uint32_t grid_dim_x,
+                                         pnanovdb_uint32_t grid_dim_y,
+                                         pnanovdb_uint32_t grid_dim_z,
+                                         pnanovdb_compute_array_t* data_in,
+                                         pnanovdb_compute_array_t* constants,
+                                         pnanovdb_compute_array_t* data_out,
+                                         pnanovdb_uint32_t dispatch_count,
+                                         pnanovdb_uint64_t scratch_size,
+                                         pnanovdb_uint64_t scratch_clear_size)
+{
+    return dispatch_shader_on_array_impl(compute, device, shader_path, grid_dim_x, grid_dim_y, grid_dim_z, data_in,
+                                         constants, data_out, dispatch_count, scratch_size, scratch_clear_size,
+                                         nullptr, nullptr);
+}
+
+pnanovdb_uint64_t dispatch_shader_on_array_async(const pnanovdb_compute_t* compute,
+                                                 const pnanovdb_compute_device_t* device,
+                                                 const char* shader_path,
+                                                 pnanovdb_uint32_t grid_dim_x,
+                                                 pnanovdb_uint32_t grid_dim_y,
+                                                 pnanovdb_uint32_t grid_dim_z,
+                                                 pnanovdb_compute_array_t* data_in,
+                                                 pnanovdb_compute_array_t* constants,
+                                                 pnanovdb_compute_array_t* data_out,
+                                                 pnanovdb_uint32_t dispatch_count,
+                                                 pnanovdb_uint64_t scratch_size,
+                                                 pnanovdb_uint64_t scratch_clear_size,
+                                                 pnanovdb_compute_readback_queue_t* readback_queue)
+{
+    if (!readback_queue || !data_out)
+    {
+        printf("Error: async shader dispatch failed, null readback queue or data_out\n");
+        return 0u;
+    }
+    if (readback_queue_is_full(readback_queue))
+    {
+        return 0u;
+    }
+    pnanovdb_uint64_t ticket = 0u;
+    dispatch_shader_on_array_impl(compute, device, shader_path, grid_dim_x, grid_dim_y, grid_dim_z, data_in, constants,
+                                  data_out, dispatch_count, scratch_size, scratch_clear_size, readback_queue, &ticket);
+    return ticket;
 }
 
 // #define LEAK_TRACKER
@@ -732,6 +845,8 @@ pnanovdb_compute_array_t* create_array(size_t element_size, pnanovdb_uint64_t el
     return array;
 }
 
+void forget_array_dirty(pnanovdb_compute_array_t* array);
+
 pnanovdb_compute_array_t* duplicate_array(pnanovdb_compute_array_t* array)
 {
     return create_array(array->element_size, array->element_count, array->data);
@@ -754,6 +869,8 @@ void destroy_array(pnanovdb_compute_array_t* array)
     g_leak_tracker.set(array, false);
 #endif
 
+    forget_array_dirty(array);
+
     delete[] (char*)array->data;
     array->data = nullptr;
     delete array;
@@ -947,6 +1064,64 @@ pnanovdb_compute_array_t* nanovdb_from_image_rgba8(pnanovdb_compute_array_t* ima
     return nvdb_array;
 }
 
+pnanovdb_compute_array_t* create_nanovdb_lod(pnanovdb_compute_array_t* nanovdb_array, pnanovdb_uint32_t level_count);
+pnanovdb_compute_paged_nanovdb_t* create_paged_nanovdb(const char* filepath,
+                                                       pnanovdb_uint32_t grid_idx,
+                                                       pnanovdb_compute_array_t* nanovdb_array,
+                                                       pnanovdb_uint64_t pool_size_in_bytes);
+void destroy_paged_nanovdb(const pnanovdb_compute_t* compute,
+                           pnanovdb_compute_queue_t* queue,
+                           pnanovdb_compute_paged_nanovdb_t* paged);
+void prefetch_paged_nanovdb(pnanovdb_compute_paged_nanovdb_t* paged,
+                            const pnanovdb_camera_mat_t* view,
+                            const pnanovdb_camera_mat_t* projection,
+                            pnanovdb_bool_t auto_center);
+pnanovdb_bool_t dispatch_shader_on_paged_nanovdb(const pnanovdb_compute_t* compute,
+                                                 const pnanovdb_compute_device_t* device,
+                                                 const pnanovdb_shader_context_t* shader_context,
+                                                 pnanovdb_compute_paged_nanovdb_t* paged,
+                                                 pnanovdb_int32_t image_width,
+                                                 pnanovdb_int32_t image_height,
+                                                 pnanovdb_compute_texture_t* background_image,
+                                                 pnanovdb_compute_buffer_transient_t* upload_buffer,
+                                                 pnanovdb_compute_buffer_transient_t* user_upload_buffer);
+void get_paged_nanovdb_stats(pnanovdb_compute_paged_nanovdb_t* paged,
+                             pnanovdb_compute_paged_nanovdb_stats_t* dst_stats);
+pnanovdb_uint32_t read_nanovdb_grid_info(const char* filepath,
+                                         pnanovdb_compute_grid_info_t* dst_infos,
+                                         pnanovdb_uint32_t dst_capacity);
+pnanovdb_compute_nanovdb_file_t* open_nanovdb_file(const char* filepath);
+void close_nanovdb_file(pnanovdb_compute_nanovdb_file_t* file);
+pnanovdb_uint32_t get_nanovdb_file_grid_count(pnanovdb_compute_nanovdb_file_t* file);
+pnanovdb_bool_t get_nanovdb_file_grid_info(pnanovdb_compute_nanovdb_file_t* file,
+                                           pnanovdb_uint32_t grid_idx,
+                                           pnanovdb_compute_grid_info_t* dst_info);
+pnanovdb_compute_array_t* request_nanovdb_file_grid(pnanovdb_compute_nanovdb_file_t* file, pnanovdb_uint32_t grid_idx);
+pnanovdb_compute_array_t* get_nanovdb_file_grid(pnanovdb_compute_nanovdb_file_t* file, pnanovdb_uint32_t grid_idx);
+void mark_array_dirty(pnanovdb_compute_array_t* array, pnanovdb_uint64_t byte_offset, pnanovdb_uint64_t num_bytes);
+pnanovdb_compute_nanovdb_upload_t* create_nanovdb_upload(pnanovdb_uint64_t staging_size_in_bytes);
+void destroy_nanovdb_upload(const pnanovdb_compute_t* compute,
+                            pnanovdb_compute_queue_t* queue,
+                            pnanovdb_compute_nanovdb_upload_t* upload);
+pnanovdb_compute_buffer_t* update_nanovdb_upload(const pnanovdb_compute_t* compute,
+                                                 pnanovdb_compute_queue_t* queue,
+                                                 pnanovdb_compute_nanovdb_upload_t* upload,
+                                                 pnanovdb_compute_array_t* array);
+void get_nanovdb_upload_stats(pnanovdb_compute_nanovdb_upload_t* upload,
+                              pnanovdb_compute_nanovdb_upload_stats_t* dst_stats);
+pnanovdb_compute_readback_queue_t* create_readback_queue(pnanovdb_uint32_t depth);
+void destroy_readback_queue(const pnanovdb_compute_t* compute,
+                            pnanovdb_compute_queue_t* queue,
+                            pnanovdb_compute_readback_queue_t* readback_queue);
+const void* map_readback(const pnanovdb_compute_t* compute,
+                         pnanovdb_compute_queue_t* queue,
+                         pnanovdb_compute_readback_queue_t* readback_queue,
+                         pnanovdb_uint64_t* dst_ticket,
+                         pnanovdb_uint64_t* dst_num_bytes);
+void unmap_readback(const pnanovdb_compute_t* compute,
+                    pnanovdb_compute_queue_t* queue,
+                    pnanovdb_compute_readback_queue_t* readback_queue);
+
 PNANOVDB_API pnanovdb_compute_t* pnanovdb_get_compute()
 {
     static pnanovdb_compute_t compute = { PNANOVDB_REFLECT_INTERFACE_INIT(pnanovdb_compute_t) };
@@ -967,6 +1142,31 @@ PNANOVDB_API pnanovdb_compute_t* pnanovdb_get_compute()
     compute.unmap_array = unmap_array;
     compute.compute_array_print_range = compute_array_print_range;
     compute.nanovdb_from_image_rgba8 = nanovdb_from_image_rgba8;
+    compute.create_nanovdb_lod = create_nanovdb_lod;
+    compute.create_paged_nanovdb = create_paged_nanovdb;
+    compute.destroy_paged_nanovdb = destroy_paged_nanovdb;
+    compute.prefetch_paged_nanovdb = prefetch_paged_nanovdb;
+    compute.dispatch_shader_on_paged_nanovdb = dispatch_shader_on_paged_nanovdb;
+    compute.get_paged_nanovdb_stats = get_paged_nanovdb_stats;
+    compute.read_nanovdb_grid_info = read_nanovdb_grid_info;
+    compute.open_nanovdb_file = open_nanovdb_file;
+    compute.close_nanovdb_file = close_nanovdb_file;
+    compute.get_nanovdb_file_grid_count = get_nanovdb_file_grid_count;
+    compute.get_nanovdb_file_grid_info = get_nanovdb_file_grid_info;
+    compute.request_nanovdb_file_grid = request_nanovdb_file_grid;
+    compute.get_nanovdb_file_grid = get_nanovdb_file_grid;
+    compute.mark_array_dirty = mark_array_dirty;
+    compute.create_nanovdb_upload = create_nanovdb_upload;
+    compute.destroy_nanovdb_upload = destroy_nanovdb_upload;
+    compute.update_nanovdb_upload = update_nanovdb_upload;
+    compute.get_nanovdb_upload_stats = get_nanovdb_upload_stats;
+    compute.create_readback_queue = create_readback_queue;
+    compute.destroy_readback_queue = destroy_readback_queue;
+    compute.enqueue_readback = enqueue_readback;
+    compute.map_readback = map_readback;
+    compute.unmap_readback = unmap_readback;
+    compute.dispatch_shader_on_array_async = dispatch_shader_on_array_async;
+    compute.dispatch_shader_indirect = dispatch_shader_indirect;
 
     return &compute;
 }
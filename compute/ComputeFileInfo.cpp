@@ -0,0 +1,335 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/compute/ComputeFileInfo.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  Header-only inspection of the grids stored in a .nvdb file and lazy per-grid loading.
+*/
+
+#include "Compute.h"
+
+#include <nanovdb/io/IO.h>
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace pnanovdb_compute
+{
+pnanovdb_compute_array_t* create_array(size_t element_size, pnanovdb_uint64_t element_count, const void* data);
+void destroy_array(pnanovdb_compute_array_t* array);
+
+static void file_info_set_name(pnanovdb_compute_grid_info_t* info, const char* name)
+{
+    strncpy(info->grid_name, name, PNANOVDB_COMPUTE_GRID_NAME_MAX - 1u);
+    info->grid_name[PNANOVDB_COMPUTE_GRID_NAME_MAX - 1u] = '\0';
+}
+
+static void file_info_set_bbox(pnanovdb_compute_grid_info_t* info,
+                               const nanovdb::CoordBBox& index_bbox,
+                               const nanovdb::Vec3dBBox& world_bbox,
+                               const nanovdb::Vec3d& voxel_size)
+{
+    info->index_bbox_min = { index_bbox[0][0], index_bbox[0][1], index_bbox[0][2] };
+    info->index_bbox_max = { index_bbox[1][0], index_bbox[1][1], index_bbox[1][2] };
+    for (pnanovdb_uint32_t axis = 0u; axis < 3u; axis++)
+    {
+        info->world_bbox_min[axis] = world_bbox[0][axis];
+        info->world_bbox_max[axis] = world_bbox[1][axis];
+        info->voxel_size[axis] = voxel_size[axis];
+    }
+}
+
+// Raw grid buffers, as written by GridHandle::write, are walked via GridData, TreeData and the root bbox
+static bool file_info_read_raw(std::istream& is, std::vector<pnanovdb_compute_grid_info_t>& infos)
+{
+    pnanovdb_uint64_t grid_offset = 0u;
+    nanovdb::GridData grid_data;
+    while (is.read((char*)&grid_data, sizeof(nanovdb::GridData)))
+    {
+        if (!grid_data.isValid())
+        {
+            return !infos.empty();
+        }
+        nanovdb::TreeData tree_data;
+        is.read((char*)&tree_data, sizeof(nanovdb::TreeData));
+        nanovdb::CoordBBox index_bbox;
+        is.seekg(grid_offset + sizeof(nanovdb::GridData) + tree_data.mNodeOffset[3], std::ios::beg);
+        is.read((char*)&index_bbox, sizeof(nanovdb::CoordBBox));
+        if (!is)
+        {
+            return false;
+        }
+
+        pnanovdb_compute_grid_info_t info = {};
+        file_info_set_name(&info, grid_data.mGridName);
+        info.segment_index = 0u;
+        info.grid_index = grid_data.mGridIndex;
+        info.grid_type = pnanovdb_uint32_t(grid_data.mGridType);
+        info.grid_class = pnanovdb_uint32_t(grid_data.mGridClass);
+        info.codec = pnanovdb_uint32_t(nanovdb::io::Codec::NONE);
+        info.version = grid_data.mVersion.id();
+        info.grid_size = grid_data.mGridSize;
+        info.file_size = grid_data.mGridSize;
+        info.file_offset = grid_offset;
+        info.active_voxel_count = tree_data.mVoxelCount;
+        info.node_count[0] = tree_data.mNodeCount[0];
+        info.node_count[1] = tree_data.mNodeCount[1];
+        info.node_count[2] = tree_data.mNodeCount[2];
+        file_info_set_bbox(&info, index_bbox, grid_data.mWorldBBox, grid_data.mVoxelSize);
+        infos.push_back(info);
+
+        grid_offset += grid_data.mGridSize;
+        is.seekg(grid_offset, std::ios::beg);
+    }
+    return !infos.empty();
+}
+
+// Segmented files carry a FileMetaData record per grid, grid payloads are skipped without decompression
+static bool file_info_read_segments(std::istream& is, std::vector<pnanovdb_compute_grid_info_t>& infos)
+{
+    nanovdb::io::Segment seg;
+    pnanovdb_uint32_t segment_index = 0u;
+    while (seg.read(is))
+    {
+        pnanovdb_uint64_t file_offset = (pnanovdb_uint64_t)is.tellg();
+        for (pnanovdb_uint32_t grid_idx = 0u; grid_idx < seg.meta.size(); grid_idx++)
+        {
+            const nanovdb::io::FileGridMetaData& meta = seg.meta[grid_idx];
+
+            pnanovdb_compute_grid_info_t info = {};
+            file_info_set_name(&info, meta.gridName.c_str());
+            info.segment_index = segment_index;
+            info.grid_index = grid_idx;
+            info.grid_type = pnanovdb_uint32_t(meta.gridType);
+            info.grid_class = pnanovdb_uint32_t(meta.gridClass);
+            info.codec = pnanovdb_uint32_t(meta.codec);
+            info.version = meta.version.id();
+            info.grid_size = meta.gridSize;
+            info.file_size = meta.fileSize;
+            info.file_offset = file_offset;
+            info.active_voxel_count = meta.voxelCount;
+            info.node_count[0] = meta.nodeCount[0];
+            info.node_count[1] = meta.nodeCount[1];
+            info.node_count[2] = meta.nodeCount[2];
+            file_info_set_bbox(&info, meta.indexBBox, meta.worldBBox, meta.voxelSize);
+            infos.push_back(info);
+
+            file_offset += meta.fileSize;
+        }
+        is.seekg(file_offset, std::ios::beg);
+        segment_index++;
+    }
+    return !infos.empty();
+}
+
+static bool file_info_read(const char* filepath, std::vector<pnanovdb_compute_grid_info_t>& infos)
+{
+    std::ifstream is(filepath, std::ios::in | std::ios::binary);
+    if (!is.is_open())
+    {
+        printf("Error: Could not open nanovdb '%s'\n", filepath);
+        return false;
+    }
+    try
+    {
+        if (!file_info_read_raw(is, infos))
+        {
+            infos.clear();
+            is.clear();
+            is.seekg(0, std::ios::beg);
+            file_info_read_segments(is, infos);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        printf("Error: Could not read nanovdb headers '%s' (%s)\n", filepath, e.what());
+        infos.clear();
+        return false;
+    }
+    return true;
+}
+
+pnanovdb_uint32_t read_nanovdb_grid_info(const char* filepath,
+                                         pnanovdb_compute_grid_info_t* dst_infos,
+                                         pnanovdb_uint32_t dst_capacity)
+{
+    if (!filepath)
+    {
+        return 0u;
+    }
+    std::vector<pnanovdb_compute_grid_info_t> infos;
+    if (!file_info_read(filepath, infos))
+    {
+        return 0u;
+    }
+
+    pnanovdb_uint32_t grid_count = pnanovdb_uint32_t(infos.size());
+    if (dst_infos)
+    {
+        pnanovdb_uint32_t copy_count = grid_count < dst_capacity ? grid_count : dst_capacity;
+        for (pnanovdb_uint32_t idx = 0u; idx < copy_count; idx++)
+        {
+            dst_infos[idx] = infos[idx];
+        }
+    }
+    return grid_count;
+}
+
+struct nanovdb_file_grid_t
+{
+    pnanovdb_compute_grid_info_t info;
+    std::shared_future<pnanovdb_compute_array_t*> array;
+    bool requested = false;
+};
+
+struct nanovdb_file_t
+{
+    std::string filepath;
+    std::vector<nanovdb_file_grid_t> grids;
+    std::mutex mutex;
+};
+
+PNANOVDB_CAST_PAIR(pnanovdb_compute_nanovdb_file_t, nanovdb_file_t)
+
+// Each load opens its own stream so independent grids read and decompress concurrently
+static pnanovdb_compute_array_t* nanovdb_file_load_grid(const nanovdb_file_t* ptr, pnanovdb_compute_grid_info_t info)
+{
+    std::ifstream is(ptr->filepath, std::ios::in | std::ios::binary);
+    if (!is.is_open())
+    {
+        printf("Error: Could not open nanovdb '%s'\n", ptr->filepath.c_str());
+        return nullptr;
+    }
+    nanovdb::HostBuffer buffer(info.grid_size);
+    try
+    {
+        is.seekg(info.file_offset, std::ios::beg);
+        nanovdb::io::Internal::read(is, (char*)buffer.data(), info.grid_size, nanovdb::io::Codec(info.codec));
+    }
+    catch (const std::exception& e)
+    {
+        printf("Error: Could not read grid '%s' from '%s' (%s)\n", info.grid_name, ptr->filepath.c_str(), e.what());
+        return nullptr;
+    }
+    if (!is)
+    {
+        printf("Error: Could not read grid '%s' from '%s'\n", info.grid_name, ptr->filepath.c_str());
+        return nullptr;
+    }
+    // every materialized grid is a standalone single grid buffer
+    nanovdb::tools::updateGridCount((nanovdb::GridData*)buffer.data(), 0u, 1u);
+
+    pnanovdb_compute_array_t* array =
+        create_array(sizeof(pnanovdb_uint32_t), info.grid_size / sizeof(pnanovdb_uint32_t), buffer.data());
+    array->filepath = ptr->filepath.c_str();
+    return array;
+}
+
+pnanovdb_compute_nanovdb_file_t* open_nanovdb_file(const char* filepath)
+{
+    if (!filepath)
+    {
+        return nullptr;
+    }
+    std::vector<pnanovdb_compute_grid_info_t> infos;
+    if (!file_info_read(filepath, infos) || infos.empty())
+    {
+        return nullptr;
+    }
+    nanovdb_file_t* ptr = new nanovdb_file_t();
+    ptr->filepath = filepath;
+    ptr->grids.resize(infos.size());
+    for (size_t idx = 0u; idx < infos.size(); idx++)
+    {
+        ptr->grids[idx].info = infos[idx];
+    }
+    return cast(ptr);
+}
+
+void close_nanovdb_file(pnanovdb_compute_nanovdb_file_t* file)
+{
+    nanovdb_file_t* ptr = cast(file);
+    if (!ptr)
+    {
+        return;
+    }
+    for (nanovdb_file_grid_t& grid : ptr->grids)
+    {
+        if (grid.requested)
+        {
+            pnanovdb_compute_array_t* array = grid.array.get();
+            if (array)
+            {
+                destroy_array(array);
+            }
+        }
+    }
+    delete ptr;
+}
+
+pnanovdb_uint32_t get_nanovdb_file_grid_count(pnanovdb_compute_nanovdb_file_t* file)
+{
+    nanovdb_file_t* ptr = cast(file);
+    return ptr ? pnanovdb_uint32_t(ptr->grids.size()) : 0u;
+}
+
+pnanovdb_bool_t get_nanovdb_file_grid_info(pnanovdb_compute_nanovdb_file_t* file,
+                                           pnanovdb_uint32_t grid_idx,
+                                           pnanovdb_compute_grid_info_t* dst_info)
+{
+    nanovdb_file_t* ptr = cast(file);
+    if (!ptr || grid_idx >= ptr->grids.size() || !dst_info)
+    {
+        return PNANOVDB_FALSE;
+    }
+    *dst_info = ptr->grids[grid_idx].info;
+    return PNANOVDB_TRUE;
+}
+
+static std::shared_future<pnanovdb_compute_array_t*> nanovdb_file_start_load(nanovdb_file_t* ptr,
+                                                                             pnanovdb_uint32_t grid_idx)
+{
+    std::lock_guard<std::mutex> lock(ptr->mutex);
+    nanovdb_file_grid_t& grid = ptr->grids[grid_idx];
+    if (!grid.requested)
+    {
+        grid.array = std::async(std::launch::async, nanovdb_file_load_grid, ptr, grid.info).share();
+        grid.requested = true;
+    }
+    return grid.array;
+}
+
+pnanovdb_compute_array_t* request_nanovdb_file_grid(pnanovdb_compute_nanovdb_file_t* file, pnanovdb_uint32_t grid_idx)
+{
+    nanovdb_file_t* ptr = cast(file);
+    if (!ptr || grid_idx >= ptr->grids.size())
+    {
+        return nullptr;
+    }
+    std::shared_future<pnanovdb_compute_array_t*> array = nanovdb_file_start_load(ptr, grid_idx);
+    if (array.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return nullptr;
+    }
+    return array.get();
+}
+
+pnanovdb_compute_array_t* get_nanovdb_file_grid(pnanovdb_compute_nanovdb_file_t* file, pnanovdb_uint32_t grid_idx)
+{
+    nanovdb_file_t* ptr = cast(file);
+    if (!ptr || grid_idx >= ptr->grids.size())
+    {
+        return nullptr;
+    }
+    return nanovdb_file_start_load(ptr, grid_idx).get();
+}
+}
@@ -0,0 +1,215 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/compute/ComputeLod.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  CPU builder for volume LOD pyramids stored as extra grids in a NanoVDB array.
+*/
+
+#include "Compute.h"
+
+#include <nanovdb/GridHandle.h>
+#include <nanovdb/tools/CreateNanoGrid.h>
+#include <nanovdb/tools/GridBuilder.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+namespace pnanovdb_compute
+{
+pnanovdb_compute_array_t* create_array(size_t element_size, pnanovdb_uint64_t element_count, const void* data);
+
+static const pnanovdb_uint32_t s_lod_max_levels = 8u;
+
+struct lod_cell_t
+{
+    float sum;
+    pnanovdb_uint32_t count;
+};
+
+// 21 bits per axis is enough for any coarse coordinate NanoVDB can address after a 2x reduction
+static pnanovdb_uint64_t lod_pack_coord(const nanovdb::Coord& ijk)
+{
+    const pnanovdb_uint64_t mask = (1llu << 21u) - 1u;
+    return (pnanovdb_uint64_t(ijk[0] + (1 << 20)) & mask) | ((pnanovdb_uint64_t(ijk[1] + (1 << 20)) & mask) << 21u) |
+           ((pnanovdb_uint64_t(ijk[2] + (1 << 20)) & mask) << 42u);
+}
+
+static nanovdb::Coord lod_unpack_coord(pnanovdb_uint64_t key)
+{
+    const pnanovdb_uint64_t mask = (1llu << 21u) - 1u;
+    return nanovdb::Coord(int(key & mask) - (1 << 20), int((key >> 21u) & mask) - (1 << 20),
+                          int((key >> 42u) & mask) - (1 << 20));
+}
+
+// A fine tile halves into a region one node level down, so it is emitted as coarse tiles of that level, or as
+// voxels below a lower node. Tiles cover whole 2x2x2 blocks, every coarse value under one is the tile value unmixed.
+template <pnanovdb_uint32_t coarse_level, typename BuildGridT, typename AccT>
+static void lod_add_coarse_tile(
+    BuildGridT& build_grid, AccT& acc, const nanovdb::Coord& fine_origin, pnanovdb_uint32_t fine_dim, float value)
+{
+    const int step = coarse_level == 0u ? 1 :
+                     coarse_level == 1u ? int(nanovdb::NanoLeaf<float>::DIM) :
+                                          int(nanovdb::NanoLower<float>::DIM);
+    const int coarse_dim = int(fine_dim >> 1u);
+    const nanovdb::Coord coarse_origin(fine_origin[0] >> 1, fine_origin[1] >> 1, fine_origin[2] >> 1);
+    for (int i = 0; i < coarse_dim; i += step)
+    {
+        for (int j = 0; j < coarse_dim; j += step)
+        {
+            for (int k = 0; k < coarse_dim; k += step)
+            {
+                if constexpr (coarse_level == 0u)
+                {
+                    acc.setValue(coarse_origin.offsetBy(i, j, k), value);
+                }
+                else
+                {
+                    build_grid.root().template addTile<coarse_level>(coarse_origin.offsetBy(i, j, k), value, true);
+                }
+            }
+        }
+    }
+}
+
+template <typename NodeT, typename BuildGridT, typename AccT>
+static void lod_downsample_tiles(const NodeT* nodes, pnanovdb_uint32_t node_count, BuildGridT& build_grid, AccT& acc)
+{
+    for (pnanovdb_uint32_t node_idx = 0u; node_idx < node_count; node_idx++)
+    {
+        const NodeT& node = nodes[node_idx];
+        for (pnanovdb_uint32_t n = 0u; n < NodeT::SIZE; n++)
+        {
+            if (node.childMask().isOn(n) || !node.valueMask().isOn(n))
+            {
+                continue;
+            }
+            lod_add_coarse_tile<NodeT::LEVEL - 1u>(
+                build_grid, acc, node.offsetToGlobalCoord(n), NodeT::ChildNodeType::DIM, node.data()->getValue(n));
+        }
+    }
+}
+
+template <typename BuildGridT, typename AccT>
+static void lod_downsample_root_tiles(const nanovdb::NanoRoot<float>& root, BuildGridT& build_grid, AccT& acc)
+{
+    const auto* root_data = root.data();
+    for (pnanovdb_uint32_t tile_idx = 0u; tile_idx < root_data->mTableSize; tile_idx++)
+    {
+        const auto* tile = root_data->tile(tile_idx);
+        if (tile->isChild() || !tile->isActive())
+        {
+            continue;
+        }
+        lod_add_coarse_tile<2u>(build_grid, acc, tile->origin(), nanovdb::NanoUpper<float>::DIM, tile->value);
+    }
+}
+
+// Averages each 2x2x2 block of active voxels into one coarse voxel, inactive children contribute the background
+static nanovdb::GridHandle<nanovdb::HostBuffer> lod_downsample(const nanovdb::NanoGrid<float>* grid)
+{
+    const auto& tree = grid->tree();
+    const float background = tree.background();
+
+    const nanovdb::NanoLeaf<float>* leaves = tree.getFirstNode<0>();
+    const pnanovdb_uint32_t leaf_count = tree.nodeCount(0);
+
+    // a leaf reduces to at most 4^3 coarse voxels, activeVoxelCount would also count tile voxels
+    std::unordered_map<pnanovdb_uint64_t, lod_cell_t> cells;
+    cells.reserve(size_t(leaf_count) * 64u);
+    for (pnanovdb_uint32_t leaf_idx = 0u; leaf_idx < leaf_count; leaf_idx++)
+    {
+        const nanovdb::NanoLeaf<float>& leaf = leaves[leaf_idx];
+        for (pnanovdb_uint32_t n = 0u; n < 512u; n++)
+        {
+            if (!leaf.isActive(n))
+            {
+                continue;
+            }
+            nanovdb::Coord ijk = leaf.offsetToGlobalCoord(n);
+            nanovdb::Coord coarse_ijk(ijk[0] >> 1, ijk[1] >> 1, ijk[2] >> 1);
+            lod_cell_t& cell = cells[lod_pack_coord(coarse_ijk)];
+            cell.sum += leaf.getValue(n);
+            cell.count++;
+        }
+    }
+
+    // tile regions never overlap leaves, so coarse tiles never replace nodes the accessor has cached
+    nanovdb::tools::build::Grid<float> build_grid(background, grid->gridName(), grid->gridClass());
+    auto acc = build_grid.getAccessor();
+    lod_downsample_root_tiles(tree.root(), build_grid, acc);
+    lod_downsample_tiles(tree.getFirstNode<2>(), tree.nodeCount(2), build_grid, acc);
+    lod_downsample_tiles(tree.getFirstNode<1>(), tree.nodeCount(1), build_grid, acc);
+    for (const auto& it : cells)
+    {
+        float value = (it.second.sum + float(8u - it.second.count) * background) * 0.125f;
+        acc.setValue(lod_unpack_coord(it.first), value);
+    }
+
+    // coarse voxel i covers fine voxels [2i, 2i + 2), so the translation is unchanged
+    const nanovdb::Vec3d translation = grid->map().applyMap(nanovdb::Vec3d(0.0));
+    build_grid.setTransform(2.0 * grid->voxelSize()[0], translation);
+
+    return nanovdb::tools::createNanoGrid(build_grid);
+}
+
+pnanovdb_compute_array_t* create_nanovdb_lod(pnanovdb_compute_array_t* nanovdb_array, pnanovdb_uint32_t level_count)
+{
+    if (!nanovdb_array || !nanovdb_array->data ||
+        nanovdb_array->element_count * nanovdb_array->element_size < sizeof(nanovdb::GridData))
+    {
+        printf("Error: create_nanovdb_lod failed, invalid array\n");
+        return nullptr;
+    }
+    const nanovdb::GridData* grid_data = (const nanovdb::GridData*)nanovdb_array->data;
+    if (!grid_data->isValid())
+    {
+        printf("Error: create_nanovdb_lod failed, array does not contain a NanoVDB grid\n");
+        return nullptr;
+    }
+    // levels are addressed by grid index in the shader, so the base grid must be the only one
+    if (grid_data->mGridCount != 1u)
+    {
+        printf("Error: create_nanovdb_lod failed, array contains %u grids, expected 1\n", grid_data->mGridCount);
+        return nullptr;
+    }
+    if (grid_data->mGridType != nanovdb::GridType::Float)
+    {
+        printf("Error: create_nanovdb_lod failed, only float grids are supported\n");
+        return nullptr;
+    }
+    if (level_count > s_lod_max_levels)
+    {
+        level_count = s_lod_max_levels;
+    }
+
+    std::vector<nanovdb::GridHandle<nanovdb::HostBuffer>> handles;
+    {
+        nanovdb::HostBuffer buffer(grid_data->mGridSize);
+        memcpy(buffer.data(), grid_data, grid_data->mGridSize);
+        handles.push_back(nanovdb::GridHandle<nanovdb::HostBuffer>(std::move(buffer)));
+    }
+    for (pnanovdb_uint32_t level = 1u; level <= level_count; level++)
+    {
+        const nanovdb::NanoGrid<float>* fine_grid = handles.back().grid<float>();
+        if (!fine_grid || fine_grid->activeVoxelCount() <= 1u)
+        {
+            break;
+        }
+        handles.push_back(lod_downsample(fine_grid));
+    }
+
+    nanovdb::GridHandle<nanovdb::HostBuffer> merged = nanovdb::mergeGrids(handles);
+
+    pnanovdb_compute_array_t* array =
+        create_array(sizeof(pnanovdb_uint32_t), merged.bufferSize() / sizeof(pnanovdb_uint32_t), merged.data());
+    array->filepath = nanovdb_array->filepath;
+
+    return array;
+}
+}
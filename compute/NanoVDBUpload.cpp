@@ -0,0 +1,323 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/compute/NanoVDBUpload.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  Persistent device copies of NanoVDB arrays with incremental updates.
+
+    Host edits are recorded per array as dirty byte ranges. Each upload keeps its device buffer while the array
+    fits and copies only the ranges marked since its last update, staged through a persistent upload ring that is
+    recycled once the frame that copied from it completes.
+*/
+
+#include "Compute.h"
+#include "NanoVDBUpload.h"
+
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+
+namespace pnanovdb_compute
+{
+static const pnanovdb_uint64_t s_upload_default_staging_size = 64u * 1024u * 1024u;
+static const pnanovdb_uint64_t s_upload_min_device_size = 65536u;
+static const pnanovdb_uint64_t s_upload_range_alignment = 16u;
+// small gaps are cheaper to copy than to issue as separate copies
+static const pnanovdb_uint64_t s_upload_merge_gap = 4096u;
+
+struct array_dirty_entry_t
+{
+    pnanovdb_uint64_t id = 0u;
+    DirtyRangeLog log;
+};
+
+struct array_dirty_registry_t
+{
+    std::mutex mutex;
+    std::unordered_map<const pnanovdb_compute_array_t*, array_dirty_entry_t> entries;
+    pnanovdb_uint64_t next_id = 1u;
+
+    // a reused array address gets a new id, so uploads never mistake it for the destroyed array
+    array_dirty_entry_t& get(const pnanovdb_compute_array_t* array)
+    {
+        array_dirty_entry_t& entry = entries[array];
+        if (entry.id == 0u)
+        {
+            entry.id = next_id++;
+        }
+        return entry;
+    }
+};
+
+static array_dirty_registry_t& array_dirty_registry()
+{
+    static array_dirty_registry_t registry;
+    return registry;
+}
+
+struct nanovdb_upload_t
+{
+    pnanovdb_compute_buffer_t* device_buffer = nullptr;
+    pnanovdb_uint64_t device_size = 0u;
+    pnanovdb_uint32_t device_stride = 0u;
+
+    // array and dirty log version currently in the device buffer
+    const pnanovdb_compute_array_t* array = nullptr;
+    pnanovdb_uint64_t array_id = 0u;
+    pnanovdb_uint64_t array_version = 0u;
+
+    pnanovdb_compute_buffer_t* staging_buffer = nullptr;
+    StagingRing staging;
+
+    std::vector<dirty_range_t> ranges;
+    pnanovdb_compute_nanovdb_upload_stats_t stats = {};
+};
+
+PNANOVDB_CAST_PAIR(pnanovdb_compute_nanovdb_upload_t, nanovdb_upload_t)
+
+void mark_array_dirty(pnanovdb_compute_array_t* array, pnanovdb_uint64_t byte_offset, pnanovdb_uint64_t num_bytes)
+{
+    if (!array)
+    {
+        printf("Error: mark_array_dirty failed, null array\n");
+        return;
+    }
+    const pnanovdb_uint64_t size_in_bytes = array->element_count * array->element_size;
+    if (byte_offset >= size_in_bytes || num_bytes == 0u)
+    {
+        return;
+    }
+    const pnanovdb_uint64_t end = num_bytes > size_in_bytes - byte_offset ? size_in_bytes : byte_offset + num_bytes;
+
+    array_dirty_registry_t& registry = array_dirty_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.get(array).log.mark(byte_offset, end);
+}
+
+void forget_array_dirty(pnanovdb_compute_array_t* array)
+{
+    array_dirty_registry_t& registry = array_dirty_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.entries.erase(array);
+}
+
+pnanovdb_compute_nanovdb_upload_t* create_nanovdb_upload(pnanovdb_uint64_t staging_size_in_bytes)
+{
+    nanovdb_upload_t* ptr = new nanovdb_upload_t();
+    ptr->staging = StagingRing(staging_size_in_bytes ? staging_size_in_bytes : s_upload_default_staging_size);
+    ptr->stats.staging_size_in_bytes = ptr->staging.capacity();
+    return cast(ptr);
+}
+
+void destroy_nanovdb_upload(const pnanovdb_compute_t* compute,
+                            pnanovdb_compute_queue_t* queue,
+                            pnanovdb_compute_nanovdb_upload_t* upload)
+{
+    nanovdb_upload_t* ptr = cast(upload);
+    if (!ptr)
+    {
+        return;
+    }
+    if (compute && queue)
+    {
+        pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+        if (ptr->device_buffer)
+        {
+            compute_interface->destroy_buffer(context, ptr->device_buffer);
+        }
+        if (ptr->staging_buffer)
+        {
+            compute_interface->destroy_buffer(context, ptr->staging_buffer);
+        }
+    }
+    delete ptr;
+}
+
+// Stages through the ring when it has room, larger or overflowing copies use a one off upload buffer
+static void nanovdb_upload_copy(nanovdb_upload_t* ptr,
+                                pnanovdb_compute_interface_t* compute_interface,
+                                pnanovdb_compute_context_t* context,
+                                pnanovdb_uint64_t frame,
+                                const pnanovdb_uint8_t* src,
+                                pnanovdb_uint64_t dst_offset,
+                                pnanovdb_uint64_t num_bytes)
+{
+    pnanovdb_uint64_t staging_offset = ptr->staging.alloc(num_bytes, frame);
+    if (staging_offset != StagingRing::k_invalid && !ptr->staging_buffer)
+    {
+        pnanovdb_compute_buffer_desc_t buf_desc = {};
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+        buf_desc.size_in_bytes = ptr->staging.capacity();
+        ptr->staging_buffer =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+        if (!ptr->staging_buffer)
+        {
+            // fall back to one off buffers from now on
+            ptr->staging = StagingRing();
+            ptr->stats.staging_size_in_bytes = 0u;
+            staging_offset = StagingRing::k_invalid;
+        }
+    }
+
+    pnanovdb_compute_buffer_t* upload_buffer = ptr->staging_buffer;
+    if (staging_offset == StagingRing::k_invalid)
+    {
+        pnanovdb_compute_buffer_desc_t buf_desc = {};
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+        buf_desc.size_in_bytes = num_bytes;
+        upload_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+        if (!upload_buffer)
+        {
+            printf("Error: nanovdb upload failed to create upload buffer of %llu bytes\n",
+                   (unsigned long long int)num_bytes);
+            return;
+        }
+        staging_offset = 0u;
+    }
+
+    pnanovdb_uint8_t* mapped = (pnanovdb_uint8_t*)compute_interface->map_buffer(context, upload_buffer);
+    memcpy(mapped + staging_offset, src, num_bytes);
+    compute_interface->unmap_buffer(context, upload_buffer);
+
+    pnanovdb_compute_copy_buffer_params_t copy_params = {};
+    copy_params.src_offset = staging_offset;
+    copy_params.dst_offset = dst_offset;
+    copy_params.num_bytes = num_bytes;
+    copy_params.src = compute_interface->register_buffer_as_transient(context, upload_buffer);
+    copy_params.dst = compute_interface->register_buffer_as_transient(context, ptr->device_buffer);
+    copy_params.debug_label = "nanovdb_upload";
+    compute_interface->copy_buffer(context, &copy_params);
+
+    if (upload_buffer != ptr->staging_buffer)
+    {
+        compute_interface->destroy_buffer(context, upload_buffer);
+    }
+}
+
+pnanovdb_compute_buffer_t* update_nanovdb_upload(const pnanovdb_compute_t* compute,
+                                                 pnanovdb_compute_queue_t* queue,
+                                                 pnanovdb_compute_nanovdb_upload_t* upload,
+                                                 pnanovdb_compute_array_t* array)
+{
+    nanovdb_upload_t* ptr = cast(upload);
+    if (!ptr || !compute || !queue || !array || !array->data)
+    {
+        return nullptr;
+    }
+    const pnanovdb_uint64_t size_in_bytes = array->element_count * array->element_size;
+    if (size_in_bytes == 0u)
+    {
+        return nullptr;
+    }
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+    if (!compute_interface || !context)
+    {
+        return nullptr;
+    }
+
+    pnanovdb_compute_frame_info_t frame_info = {};
+    compute_interface->get_frame_info(context, &frame_info);
+    ptr->staging.retire(frame_info.frame_local_completed);
+
+    ptr->ranges.clear();
+    bool full_upload = !ptr->device_buffer || array != ptr->array;
+    pnanovdb_uint64_t array_id = 0u;
+    pnanovdb_uint64_t array_version = 0u;
+    {
+        array_dirty_registry_t& registry = array_dirty_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        array_dirty_entry_t& entry = registry.get(array);
+        array_id = entry.id;
+        array_version = entry.log.version();
+        if (!full_upload && (array_id != ptr->array_id || !entry.log.collect(ptr->array_version, ptr->ranges)))
+        {
+            full_upload = true;
+        }
+    }
+
+    // the device buffer is kept while the array fits and does not leave most of it unused
+    const pnanovdb_uint32_t stride = pnanovdb_uint32_t(array->element_size);
+    if (!ptr->device_buffer || size_in_bytes > ptr->device_size || size_in_bytes < ptr->device_size / 4u ||
+        stride != ptr->device_stride)
+    {
+        if (ptr->device_buffer)
+        {
+            compute_interface->destroy_buffer(context, ptr->device_buffer);
+            ptr->device_buffer = nullptr;
+        }
+        pnanovdb_compute_buffer_desc_t buf_desc = {};
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+        buf_desc.structure_stride = stride;
+        buf_desc.size_in_bytes = size_in_bytes + size_in_bytes / 8u;
+        if (buf_desc.size_in_bytes < s_upload_min_device_size)
+        {
+            buf_desc.size_in_bytes = s_upload_min_device_size;
+        }
+        ptr->device_buffer =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+        ptr->device_size = ptr->device_buffer ? buf_desc.size_in_bytes : 0u;
+        ptr->device_stride = stride;
+        if (!ptr->device_buffer)
+        {
+            printf("Error: update_nanovdb_upload failed to create device buffer of %llu bytes\n",
+                   (unsigned long long int)buf_desc.size_in_bytes);
+            ptr->array = nullptr;
+            ptr->array_id = 0u;
+            ptr->stats.device_size_in_bytes = 0u;
+            return nullptr;
+        }
+        full_upload = true;
+    }
+
+    pnanovdb_uint64_t upload_bytes = size_in_bytes;
+    if (full_upload)
+    {
+        ptr->ranges.clear();
+        ptr->ranges.push_back({ 0u, size_in_bytes });
+    }
+    else
+    {
+        upload_bytes = merge_dirty_ranges(ptr->ranges, s_upload_range_alignment, size_in_bytes, s_upload_merge_gap);
+    }
+    for (const dirty_range_t& range : ptr->ranges)
+    {
+        nanovdb_upload_copy(ptr, compute_interface, context, frame_info.frame_local_current,
+                            (const pnanovdb_uint8_t*)array->data + range.begin, range.begin, range.end - range.begin);
+    }
+
+    ptr->array = array;
+    ptr->array_id = array_id;
+    ptr->array_version = array_version;
+
+    ptr->stats.device_size_in_bytes = ptr->device_size;
+    ptr->stats.last_upload_bytes = upload_bytes;
+    ptr->stats.total_upload_bytes += upload_bytes;
+    if (full_upload)
+    {
+        ptr->stats.full_upload_count++;
+    }
+    else if (upload_bytes > 0u)
+    {
+        ptr->stats.partial_upload_count++;
+    }
+
+    return ptr->device_buffer;
+}
+
+void get_nanovdb_upload_stats(pnanovdb_compute_nanovdb_upload_t* upload,
+                              pnanovdb_compute_nanovdb_upload_stats_t* dst_stats)
+{
+    nanovdb_upload_t* ptr = cast(upload);
+    if (!ptr || !dst_stats)
+    {
+        return;
+    }
+    *dst_stats = ptr->stats;
+}
+} // namespace pnanovdb_compute
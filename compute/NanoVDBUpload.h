@@ -0,0 +1,210 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/compute/NanoVDBUpload.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Dirty range bookkeeping and staging ring allocation for incremental NanoVDB uploads
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Compute.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace pnanovdb_compute
+{
+struct dirty_range_t
+{
+    pnanovdb_uint64_t begin;
+    pnanovdb_uint64_t end;
+};
+
+// Ranges marked per version, every consumer remembers the version it uploaded last
+class DirtyRangeLog
+{
+public:
+    static constexpr size_t k_max_ranges = 1024u;
+
+    pnanovdb_uint64_t version() const
+    {
+        return m_version;
+    }
+
+    void mark(pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+    {
+        if (end <= begin)
+        {
+            return;
+        }
+        m_version++;
+        if (m_ranges.size() >= k_max_ranges)
+        {
+            // consumers behind the dropped half fall back to a full upload
+            m_ranges.erase(m_ranges.begin(), m_ranges.begin() + k_max_ranges / 2u);
+            m_oldest_version = m_ranges.front().version;
+        }
+        m_ranges.push_back({ m_version, { begin, end } });
+    }
+
+    // false when ranges after since_version were dropped and the whole array has to be uploaded
+    bool collect(pnanovdb_uint64_t since_version, std::vector<dirty_range_t>& ranges) const
+    {
+        if (since_version + 1u < m_oldest_version)
+        {
+            return false;
+        }
+        for (const entry_t& entry : m_ranges)
+        {
+            if (entry.version > since_version)
+            {
+                ranges.push_back(entry.range);
+            }
+        }
+        return true;
+    }
+
+private:
+    struct entry_t
+    {
+        pnanovdb_uint64_t version;
+        dirty_range_t range;
+    };
+
+    std::vector<entry_t> m_ranges;
+    pnanovdb_uint64_t m_version = 0u;
+    pnanovdb_uint64_t m_oldest_version = 1u;
+};
+
+// Sorts, aligns and clamps ranges to size, ranges closer than merge_gap are joined, returns the bytes covered
+static inline pnanovdb_uint64_t merge_dirty_ranges(std::vector<dirty_range_t>& ranges,
+                                                   pnanovdb_uint64_t alignment,
+                                                   pnanovdb_uint64_t size,
+                                                   pnanovdb_uint64_t merge_gap)
+{
+    for (dirty_range_t& range : ranges)
+    {
+        range.begin = std::min(range.begin - range.begin % alignment, size);
+        range.end = std::min(((range.end + alignment - 1u) / alignment) * alignment, size);
+    }
+    std::sort(ranges.begin(), ranges.end(),
+              [](const dirty_range_t& a, const dirty_range_t& b) { return a.begin < b.begin; });
+
+    size_t count = 0u;
+    for (const dirty_range_t& range : ranges)
+    {
+        if (range.end <= range.begin)
+        {
+            continue;
+        }
+        if (count > 0u && range.begin <= ranges[count - 1u].end + merge_gap)
+        {
+            ranges[count - 1u].end = std::max(ranges[count - 1u].end, range.end);
+            continue;
+        }
+        ranges[count++] = range;
+    }
+    ranges.resize(count);
+
+    pnanovdb_uint64_t num_bytes = 0u;
+    for (const dirty_range_t& range : ranges)
+    {
+        num_bytes += range.end - range.begin;
+    }
+    return num_bytes;
+}
+
+// Linear allocator over one persistent upload buffer, space is reused once the frame that copied from it completes
+class StagingRing
+{
+public:
+    static constexpr pnanovdb_uint64_t k_invalid = ~0llu;
+    static constexpr pnanovdb_uint64_t k_alignment = 256u;
+
+    explicit StagingRing(pnanovdb_uint64_t capacity = 0u) : m_capacity(capacity)
+    {
+    }
+
+    pnanovdb_uint64_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    bool empty() const
+    {
+        return m_fences.empty();
+    }
+
+    void retire(pnanovdb_uint64_t completed_frame)
+    {
+        while (!m_fences.empty() && m_fences.front().frame <= completed_frame)
+        {
+            m_fences.pop_front();
+        }
+        if (m_fences.empty())
+        {
+            m_head = 0u;
+            m_tail = 0u;
+        }
+        else
+        {
+            m_tail = m_fences.front().begin;
+        }
+    }
+
+    // returns the offset of num_bytes held until frame completes, k_invalid when the ring has no room
+    pnanovdb_uint64_t alloc(pnanovdb_uint64_t num_bytes, pnanovdb_uint64_t frame)
+    {
+        num_bytes = ((num_bytes + k_alignment - 1u) / k_alignment) * k_alignment;
+        if (num_bytes == 0u || num_bytes > m_capacity)
+        {
+            return k_invalid;
+        }
+        pnanovdb_uint64_t offset = k_invalid;
+        if (m_fences.empty())
+        {
+            offset = 0u;
+        }
+        else if (m_head > m_tail)
+        {
+            // in use [tail, head), otherwise in use [tail, capacity) and [0, head)
+            if (m_head + num_bytes <= m_capacity)
+            {
+                offset = m_head;
+            }
+            else if (num_bytes <= m_tail)
+            {
+                offset = 0u;
+            }
+        }
+        else if (m_head + num_bytes <= m_tail)
+        {
+            offset = m_head;
+        }
+        if (offset == k_invalid)
+        {
+            return k_invalid;
+        }
+        m_head = offset + num_bytes;
+        m_fences.push_back({ frame, offset });
+        return offset;
+    }
+
+private:
+    struct fence_t
+    {
+        pnanovdb_uint64_t frame;
+        pnanovdb_uint64_t begin;
+    };
+
+    std::deque<fence_t> m_fences;
+    pnanovdb_uint64_t m_capacity;
+    pnanovdb_uint64_t m_head = 0u;
+    pnanovdb_uint64_t m_tail = 0u;
+};
+} // namespace pnanovdb_compute
@@ -0,0 +1,889 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/compute/PagedNanoVDB.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  Out-of-core leaf residency for NanoVDB grids larger than device memory.
+
+    The grid skeleton (grid, tree, root, upper and lower nodes) stays resident in one device buffer. Leaf nodes are
+    grouped into fixed size pages that are streamed into a device page pool on demand. The shader translates leaf
+    addresses through a page table, marks every page it touches in a feedback bitmask and falls back to the lower
+    node average while a page is missing. Feedback is read back a few frames later and drives both loading and
+    eviction, pages are copied out of host memory or a memory mapped file on a loader thread.
+*/
+
+#include "Compute.h"
+#include "NanoVDBUpload.h"
+#include "PagedResidency.h"
+
+#include <nanovdb/io/IO.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <math.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace pnanovdb_compute
+{
+static const pnanovdb_uint32_t s_paged_leaves_per_page = 64u;
+static const pnanovdb_uint32_t s_paged_readback_count = 3u;
+static const pnanovdb_uint32_t s_paged_max_uploads_per_frame = 64u;
+static const pnanovdb_uint32_t s_paged_max_prefetch_per_frame = 256u;
+static const pnanovdb_uint32_t s_paged_staging_frame_count = 2u;
+
+struct paged_file_t
+{
+    const pnanovdb_uint8_t* data = nullptr;
+    pnanovdb_uint64_t size = 0u;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+static bool paged_file_map(paged_file_t* file, const char* filepath)
+{
+#if defined(_WIN32)
+    file->file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+    if (file->file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size = {};
+    GetFileSizeEx(file->file, &size);
+    file->size = (pnanovdb_uint64_t)size.QuadPart;
+    file->mapping = CreateFileMappingA(file->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!file->mapping)
+    {
+        return false;
+    }
+    file->data = (const pnanovdb_uint8_t*)MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    file->fd = open(filepath, O_RDONLY);
+    if (file->fd < 0)
+    {
+        return false;
+    }
+    struct stat st = {};
+    fstat(file->fd, &st);
+    file->size = (pnanovdb_uint64_t)st.st_size;
+    void* data = mmap(nullptr, file->size, PROT_READ, MAP_SHARED, file->fd, 0);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    file->data = (const pnanovdb_uint8_t*)data;
+#endif
+    return file->data != nullptr;
+}
+
+static void paged_file_unmap(paged_file_t* file)
+{
+#if defined(_WIN32)
+    if (file->data)
+    {
+        UnmapViewOfFile(file->data);
+    }
+    if (file->mapping)
+    {
+        CloseHandle(file->mapping);
+    }
+    if (file->file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file->file);
+    }
+    file->mapping = nullptr;
+    file->file = INVALID_HANDLE_VALUE;
+#else
+    if (file->data)
+    {
+        munmap((void*)file->data, file->size);
+    }
+    if (file->fd >= 0)
+    {
+        close(file->fd);
+    }
+    file->fd = -1;
+#endif
+    file->data = nullptr;
+    file->size = 0u;
+}
+
+pnanovdb_uint32_t read_nanovdb_grid_info(const char* filepath,
+                                         pnanovdb_compute_grid_info_t* dst_infos,
+                                         pnanovdb_uint32_t dst_capacity);
+
+// Finds the stored bytes of one grid from the file headers, only uncompressed grids can be mapped
+static bool paged_file_find_grid(const char* filepath, pnanovdb_uint32_t grid_idx, pnanovdb_compute_grid_info_t* info)
+{
+    pnanovdb_uint32_t grid_count = read_nanovdb_grid_info(filepath, nullptr, 0u);
+    if (grid_idx >= grid_count)
+    {
+        return false;
+    }
+    std::vector<pnanovdb_compute_grid_info_t> infos(grid_count);
+    read_nanovdb_grid_info(filepath, infos.data(), grid_count);
+    *info = infos[grid_idx];
+    if (info->codec != pnanovdb_uint32_t(nanovdb::io::Codec::NONE))
+    {
+        printf("Error: paged NanoVDB requires an uncompressed grid in '%s'\n", filepath);
+        return false;
+    }
+    return true;
+}
+
+struct paged_load_t
+{
+    pnanovdb_uint32_t page;
+    std::vector<pnanovdb_uint8_t> data;
+};
+
+struct paged_lower_t
+{
+    pnanovdb_coord_t bbox_min;
+    pnanovdb_coord_t bbox_max;
+    pnanovdb_uint32_t page_begin;
+    pnanovdb_uint32_t page_end;
+};
+
+struct paged_readback_t
+{
+    pnanovdb_compute_buffer_t* buffer = nullptr;
+    pnanovdb_uint64_t frame = 0u;
+    bool pending = false;
+};
+
+struct paged_nanovdb_t
+{
+    paged_file_t file;
+    const pnanovdb_uint8_t* grid_data = nullptr;
+    pnanovdb_uint64_t grid_size = 0u;
+
+    pnanovdb_uint64_t leaf_offset = 0u;
+    pnanovdb_uint64_t leaf_size = 0u;
+    pnanovdb_uint64_t leaf_count = 0u;
+    pnanovdb_uint64_t page_size = 0u;
+    pnanovdb_uint32_t page_count = 0u;
+    pnanovdb_uint32_t pool_page_count = 0u;
+
+    std::vector<paged_lower_t> lowers;
+
+    // host residency state, only touched from the dispatch thread
+    PageResidency residency;
+    std::deque<paged_load_t> ready_loads; // loaded pages waiting for a slot or staging space
+    pnanovdb_uint64_t frame = 0u;
+
+    // loader thread
+    std::thread loader;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<pnanovdb_uint32_t> load_requests;
+    std::vector<paged_load_t> load_results;
+    bool running = true;
+
+    // device state
+    pnanovdb_compute_buffer_t* skeleton_buffer = nullptr;
+    pnanovdb_compute_buffer_t* pool_buffer = nullptr;
+    pnanovdb_compute_buffer_t* page_table_buffer = nullptr;
+    pnanovdb_compute_buffer_t* feedback_buffer = nullptr;
+    pnanovdb_compute_buffer_t* feedback_clear_buffer = nullptr;
+    pnanovdb_compute_buffer_t* params_buffer = nullptr;
+    pnanovdb_compute_buffer_t* staging_buffer = nullptr;
+    StagingRing staging;
+    paged_readback_t readbacks[s_paged_readback_count];
+    pnanovdb_uint32_t readback_idx = 0u;
+};
+
+PNANOVDB_CAST_PAIR(pnanovdb_compute_paged_nanovdb_t, paged_nanovdb_t)
+
+struct paged_params_t
+{
+    pnanovdb_uint32_t leaf_offset_lo;
+    pnanovdb_uint32_t leaf_offset_hi;
+    pnanovdb_uint32_t leaf_size;
+    pnanovdb_uint32_t leaves_per_page;
+
+    pnanovdb_uint32_t page_count;
+    pnanovdb_uint32_t page_size;
+    pnanovdb_uint32_t pad0;
+    pnanovdb_uint32_t pad1;
+};
+
+static void paged_loader_thread(paged_nanovdb_t* ptr)
+{
+    std::vector<pnanovdb_uint32_t> requests;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(ptr->mutex);
+            ptr->condition.wait(lock, [ptr]() { return !ptr->running || !ptr->load_requests.empty(); });
+            if (!ptr->running)
+            {
+                return;
+            }
+            requests.swap(ptr->load_requests);
+        }
+        for (pnanovdb_uint32_t page : requests)
+        {
+            // touching the mapped range here keeps page faults off the render thread
+            paged_load_t load;
+            load.page = page;
+            load.data.resize(ptr->page_size);
+            pnanovdb_uint64_t leaf_begin = pnanovdb_uint64_t(page) * s_paged_leaves_per_page;
+            pnanovdb_uint64_t leaf_end = std::min(leaf_begin + s_paged_leaves_per_page, ptr->leaf_count);
+            pnanovdb_uint64_t num_bytes = (leaf_end - leaf_begin) * ptr->leaf_size;
+            memcpy(load.data.data(), ptr->grid_data + ptr->leaf_offset + leaf_begin * ptr->leaf_size, num_bytes);
+
+            std::lock_guard<std::mutex> lock(ptr->mutex);
+            ptr->load_results.push_back(std::move(load));
+        }
+        requests.clear();
+    }
+}
+
+pnanovdb_compute_paged_nanovdb_t* create_paged_nanovdb(const char* filepath,
+                                                       pnanovdb_uint32_t grid_idx,
+                                                       pnanovdb_compute_array_t* nanovdb_array,
+                                                       pnanovdb_uint64_t pool_size_in_bytes)
+{
+    paged_nanovdb_t* ptr = new paged_nanovdb_t();
+
+    pnanovdb_uint64_t available_size = 0u;
+    if (nanovdb_array && nanovdb_array->data)
+    {
+        ptr->grid_data = (const pnanovdb_uint8_t*)nanovdb_array->data;
+        available_size = nanovdb_array->element_count * nanovdb_array->element_size;
+    }
+    else if (filepath)
+    {
+        pnanovdb_compute_grid_info_t info = {};
+        if (!paged_file_find_grid(filepath, grid_idx, &info) || !paged_file_map(&ptr->file, filepath) ||
+            info.file_offset + info.grid_size > ptr->file.size)
+        {
+            printf("Error: Could not map nanovdb '%s'\n", filepath);
+            paged_file_unmap(&ptr->file);
+            delete ptr;
+            return nullptr;
+        }
+        ptr->grid_data = ptr->file.data + info.file_offset;
+        available_size = info.grid_size;
+    }
+    if (!ptr->grid_data || available_size < PNANOVDB_GRID_SIZE + PNANOVDB_TREE_SIZE)
+    {
+        printf("Error: create_paged_nanovdb failed, no grid data\n");
+        paged_file_unmap(&ptr->file);
+        delete ptr;
+        return nullptr;
+    }
+
+    pnanovdb_buf_t buf = pnanovdb_make_buf((pnanovdb_uint32_t*)ptr->grid_data, available_size / 4u);
+    pnanovdb_grid_handle_t grid = { pnanovdb_address_null() };
+    pnanovdb_grid_type_t grid_type = pnanovdb_grid_get_grid_type(buf, grid);
+    if (pnanovdb_grid_get_magic(buf, grid) != PNANOVDB_MAGIC_GRID || grid_type != PNANOVDB_GRID_TYPE_FLOAT)
+    {
+        printf("Error: create_paged_nanovdb failed, only float grids are supported\n");
+        paged_file_unmap(&ptr->file);
+        delete ptr;
+        return nullptr;
+    }
+    pnanovdb_tree_handle_t tree = pnanovdb_grid_get_tree(buf, grid);
+
+    ptr->grid_size = pnanovdb_grid_get_grid_size(buf, grid);
+    ptr->leaf_offset =
+        pnanovdb_address_offset64(tree.address, pnanovdb_tree_get_node_offset_leaf(buf, tree)).byte_offset;
+    ptr->leaf_size = PNANOVDB_GRID_TYPE_GET(grid_type, leaf_size);
+    ptr->leaf_count = pnanovdb_tree_get_node_count_leaf(buf, tree);
+    ptr->page_size = ptr->leaf_size * s_paged_leaves_per_page;
+    ptr->page_count = pnanovdb_uint32_t((ptr->leaf_count + s_paged_leaves_per_page - 1u) / s_paged_leaves_per_page);
+    ptr->pool_page_count = pnanovdb_uint32_t(std::max(pool_size_in_bytes / ptr->page_size, pnanovdb_uint64_t(1u)));
+    ptr->pool_page_count = std::min(ptr->pool_page_count, std::max(ptr->page_count, 1u));
+
+    // page ranges per lower node for frustum prefetch, leaves are laid out in lower node order
+    pnanovdb_uint32_t lower_count = pnanovdb_tree_get_node_count_lower(buf, tree);
+    pnanovdb_address_t lower_address =
+        pnanovdb_address_offset64(tree.address, pnanovdb_tree_get_node_offset_lower(buf, tree));
+    ptr->lowers.reserve(lower_count);
+    for (pnanovdb_uint32_t lower_idx = 0u; lower_idx < lower_count; lower_idx++)
+    {
+        pnanovdb_lower_handle_t lower = { pnanovdb_address_offset_product(
+            lower_address, lower_idx, PNANOVDB_GRID_TYPE_GET(grid_type, lower_size)) };
+        paged_lower_t range = {};
+        range.bbox_min = pnanovdb_lower_get_bbox_min(buf, lower);
+        range.bbox_max = pnanovdb_lower_get_bbox_max(buf, lower);
+        range.page_begin = ptr->page_count;
+        range.page_end = 0u;
+        for (pnanovdb_uint32_t n = 0u; n < PNANOVDB_LOWER_TABLE_COUNT; n++)
+        {
+            if (!pnanovdb_lower_get_child_mask(buf, lower, n))
+            {
+                continue;
+            }
+            pnanovdb_leaf_handle_t leaf = pnanovdb_lower_get_child(grid_type, buf, lower, n);
+            pnanovdb_uint32_t page =
+                pnanovdb_uint32_t((leaf.address.byte_offset - ptr->leaf_offset) / ptr->page_size);
+            range.page_begin = std::min(range.page_begin, page);
+            range.page_end = std::max(range.page_end, page + 1u);
+        }
+        if (range.page_begin < range.page_end)
+        {
+            ptr->lowers.push_back(range);
+        }
+    }
+
+    // pages stay resident for as long as feedback about them may still be in flight
+    ptr->residency = PageResidency(ptr->page_count, ptr->pool_page_count, s_paged_readback_count);
+
+    ptr->loader = std::thread(paged_loader_thread, ptr);
+
+    return cast(ptr);
+}
+
+void destroy_paged_nanovdb(const pnanovdb_compute_t* compute,
+                           pnanovdb_compute_queue_t* queue,
+                           pnanovdb_compute_paged_nanovdb_t* paged)
+{
+    paged_nanovdb_t* ptr = cast(paged);
+    if (!ptr)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(ptr->mutex);
+        ptr->running = false;
+    }
+    ptr->condition.notify_one();
+    if (ptr->loader.joinable())
+    {
+        ptr->loader.join();
+    }
+
+    if (compute && queue)
+    {
+        pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+        pnanovdb_compute_buffer_t* buffers[] = { ptr->skeleton_buffer,   ptr->pool_buffer,
+                                                 ptr->page_table_buffer, ptr->feedback_buffer,
+                                                 ptr->feedback_clear_buffer, ptr->params_buffer,
+                                                 ptr->staging_buffer };
+        for (pnanovdb_compute_buffer_t* buffer : buffers)
+        {
+            if (buffer)
+            {
+                compute_interface->destroy_buffer(context, buffer);
+            }
+        }
+        for (pnanovdb_uint32_t idx = 0u; idx < s_paged_readback_count; idx++)
+        {
+            if (ptr->readbacks[idx].buffer)
+            {
+                compute_interface->destroy_buffer(context, ptr->readbacks[idx].buffer);
+            }
+        }
+    }
+
+    paged_file_unmap(&ptr->file);
+    delete ptr;
+}
+
+static void paged_request_page(paged_nanovdb_t* ptr, pnanovdb_uint32_t page, std::vector<pnanovdb_uint32_t>& requests)
+{
+    if (ptr->residency.touch(page, ptr->frame))
+    {
+        requests.push_back(page);
+    }
+}
+
+static void paged_submit_requests(paged_nanovdb_t* ptr, std::vector<pnanovdb_uint32_t>& requests)
+{
+    if (requests.empty())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(ptr->mutex);
+        ptr->load_requests.insert(ptr->load_requests.end(), requests.begin(), requests.end());
+    }
+    ptr->condition.notify_one();
+    requests.clear();
+}
+
+void prefetch_paged_nanovdb(pnanovdb_compute_paged_nanovdb_t* paged,
+                            const pnanovdb_camera_mat_t* view,
+                            const pnanovdb_camera_mat_t* projection,
+                            pnanovdb_bool_t auto_center)
+{
+    paged_nanovdb_t* ptr = cast(paged);
+    if (!ptr || !view || !projection)
+    {
+        return;
+    }
+    // prefetch only fills free slots, visible pages reported by the shader take priority for eviction
+    if (ptr->residency.free_slot_count() <= ptr->residency.pending_page_count())
+    {
+        return;
+    }
+    pnanovdb_uint32_t budget = ptr->residency.free_slot_count() - ptr->residency.pending_page_count();
+    budget = std::min(budget, s_paged_max_prefetch_per_frame);
+
+    pnanovdb_buf_t buf = pnanovdb_make_buf((pnanovdb_uint32_t*)ptr->grid_data, ptr->leaf_offset / 4u);
+    pnanovdb_grid_handle_t grid = { pnanovdb_address_null() };
+    pnanovdb_tree_handle_t tree = pnanovdb_grid_get_tree(buf, grid);
+    pnanovdb_root_handle_t root = pnanovdb_tree_get_root(buf, tree);
+
+    // mirror the shader auto centering so prefetch matches what is on screen
+    pnanovdb_vec3_t center_offset = { 0.f, 0.f, 0.f };
+    if (auto_center)
+    {
+        pnanovdb_coord_t bbox_min = pnanovdb_root_get_bbox_min(buf, root);
+        pnanovdb_coord_t bbox_max = pnanovdb_root_get_bbox_max(buf, root);
+        center_offset.x = -float((bbox_max.x + bbox_min.x) >> 1);
+        center_offset.y = -float((bbox_max.y + bbox_min.y) >> 1);
+        center_offset.z = -float((bbox_max.z + bbox_min.z) >> 1);
+    }
+
+    pnanovdb_camera_mat_t view_proj = pnanovdb_camera_mat_mul(*view, *projection);
+
+    struct candidate_t
+    {
+        float depth;
+        pnanovdb_uint32_t lower_idx;
+    };
+    std::vector<candidate_t> candidates;
+    for (pnanovdb_uint32_t lower_idx = 0u; lower_idx < ptr->lowers.size(); lower_idx++)
+    {
+        const paged_lower_t& lower = ptr->lowers[lower_idx];
+        pnanovdb_uint32_t outside_mask = 0x3F;
+        float min_w = INFINITY;
+        for (pnanovdb_uint32_t corner = 0u; corner < 8u; corner++)
+        {
+            pnanovdb_vec3_t ijk = { float((corner & 1u) ? lower.bbox_max.x + 1 : lower.bbox_min.x),
+                                    float((corner & 2u) ? lower.bbox_max.y + 1 : lower.bbox_min.y),
+                                    float((corner & 4u) ? lower.bbox_max.z + 1 : lower.bbox_min.z) };
+            ijk = pnanovdb_vec3_add(ijk, center_offset);
+            pnanovdb_vec3_t world = pnanovdb_grid_index_to_worldf(buf, grid, PNANOVDB_REF(ijk));
+            pnanovdb_vec4_t pos = { world.x, world.y, world.z, 1.f };
+            pnanovdb_vec4_t clip = pnanovdb_camera_mat_mul_row(view_proj, pos);
+            pnanovdb_uint32_t corner_mask = 0u;
+            corner_mask |= (clip.x < -clip.w) ? 0x01 : 0u;
+            corner_mask |= (clip.x > clip.w) ? 0x02 : 0u;
+            corner_mask |= (clip.y < -clip.w) ? 0x04 : 0u;
+            corner_mask |= (clip.y > clip.w) ? 0x08 : 0u;
+            corner_mask |= (clip.w <= 0.f) ? 0x10 : 0u;
+            outside_mask &= corner_mask;
+            min_w = fminf(min_w, clip.w);
+        }
+        if (outside_mask == 0u)
+        {
+            candidates.push_back({ min_w, lower_idx });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const candidate_t& a, const candidate_t& b) { return a.depth < b.depth; });
+
+    std::vector<pnanovdb_uint32_t> requests;
+    for (const candidate_t& candidate : candidates)
+    {
+        const paged_lower_t& lower = ptr->lowers[candidate.lower_idx];
+        for (pnanovdb_uint32_t page = lower.page_begin; page < lower.page_end && requests.size() < budget; page++)
+        {
+            paged_request_page(ptr, page, requests);
+        }
+        if (requests.size() >= budget)
+        {
+            break;
+        }
+    }
+    paged_submit_requests(ptr, requests);
+}
+
+static pnanovdb_compute_buffer_t* paged_create_buffer(pnanovdb_compute_interface_t* compute_interface,
+                                                      pnanovdb_compute_context_t* context,
+                                                      pnanovdb_compute_memory_type_t memory_type,
+                                                      pnanovdb_compute_buffer_usage_t usage,
+                                                      pnanovdb_uint64_t size_in_bytes,
+                                                      pnanovdb_uint32_t structure_stride)
+{
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+    buf_desc.usage = usage;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = structure_stride;
+    buf_desc.size_in_bytes = std::max(size_in_bytes, pnanovdb_uint64_t(65536u));
+    return compute_interface->create_buffer(context, memory_type, &buf_desc);
+}
+
+static void paged_copy(pnanovdb_compute_interface_t* compute_interface,
+                       pnanovdb_compute_context_t* context,
+                       pnanovdb_compute_buffer_t* src,
+                       pnanovdb_uint64_t src_offset,
+                       pnanovdb_compute_buffer_t* dst,
+                       pnanovdb_uint64_t dst_offset,
+                       pnanovdb_uint64_t num_bytes,
+                       const char* debug_label)
+{
+    pnanovdb_compute_copy_buffer_params_t copy_params = {};
+    copy_params.src_offset = src_offset;
+    copy_params.dst_offset = dst_offset;
+    copy_params.num_bytes = num_bytes;
+    copy_params.src = compute_interface->register_buffer_as_transient(context, src);
+    copy_params.dst = compute_interface->register_buffer_as_transient(context, dst);
+    copy_params.debug_label = debug_label;
+    compute_interface->copy_buffer(context, &copy_params);
+}
+
+// One off upload for the skeleton, it is copied once and would only pin staging space
+static void paged_upload_once(pnanovdb_compute_interface_t* compute_interface,
+                              pnanovdb_compute_context_t* context,
+                              pnanovdb_compute_buffer_t* dst,
+                              const void* data,
+                              pnanovdb_uint64_t num_bytes,
+                              const char* debug_label)
+{
+    pnanovdb_compute_buffer_t* upload_buffer =
+        paged_create_buffer(compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD,
+                            PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC, num_bytes, 0u);
+    void* mapped = compute_interface->map_buffer(context, upload_buffer);
+    memcpy(mapped, data, num_bytes);
+    compute_interface->unmap_buffer(context, upload_buffer);
+
+    paged_copy(compute_interface, context, upload_buffer, 0u, dst, 0u, num_bytes, debug_label);
+
+    compute_interface->destroy_buffer(context, upload_buffer);
+}
+
+// Copies through space already allocated from the persistent staging ring
+static void paged_upload(paged_nanovdb_t* ptr,
+                         pnanovdb_compute_interface_t* compute_interface,
+                         pnanovdb_compute_context_t* context,
+                         pnanovdb_uint64_t staging_offset,
+                         pnanovdb_compute_buffer_t* dst,
+                         pnanovdb_uint64_t dst_offset,
+                         const void* data,
+                         pnanovdb_uint64_t num_bytes,
+                         const char* debug_label)
+{
+    pnanovdb_uint8_t* mapped = (pnanovdb_uint8_t*)compute_interface->map_buffer(context, ptr->staging_buffer);
+    memcpy(mapped + staging_offset, data, num_bytes);
+    compute_interface->unmap_buffer(context, ptr->staging_buffer);
+
+    paged_copy(compute_interface, context, ptr->staging_buffer, staging_offset, dst, dst_offset, num_bytes,
+               debug_label);
+}
+
+static bool paged_init_device(paged_nanovdb_t* ptr,
+                              pnanovdb_compute_interface_t* compute_interface,
+                              pnanovdb_compute_context_t* context)
+{
+    const pnanovdb_uint64_t feedback_size = ((ptr->page_count + 31u) / 32u) * 4u;
+
+    ptr->skeleton_buffer =
+        paged_create_buffer(compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE,
+                            PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST,
+                            ptr->leaf_offset, 8u);
+    ptr->pool_buffer = paged_create_buffer(
+        compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE,
+        PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST,
+        pnanovdb_uint64_t(ptr->pool_page_count) * ptr->page_size, 8u);
+    ptr->page_table_buffer =
+        paged_create_buffer(compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE,
+                            PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST,
+                            pnanovdb_uint64_t(ptr->page_count) * 4u, 4u);
+    ptr->feedback_buffer = paged_create_buffer(
+        compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE,
+        PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC |
+            PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST,
+        feedback_size, 4u);
+    ptr->feedback_clear_buffer =
+        paged_create_buffer(compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD,
+                            PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC, feedback_size, 0u);
+    ptr->params_buffer = paged_create_buffer(compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD,
+                                             PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT, sizeof(paged_params_t), 0u);
+
+    // room for a full frame of page uploads plus the page table, for a few frames in flight
+    const pnanovdb_uint64_t staging_frame_size =
+        pnanovdb_uint64_t(s_paged_max_uploads_per_frame) * ptr->page_size + pnanovdb_uint64_t(ptr->page_count) * 4u +
+        2u * StagingRing::k_alignment;
+    ptr->staging = StagingRing(staging_frame_size * s_paged_staging_frame_count);
+    ptr->staging_buffer =
+        paged_create_buffer(compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD,
+                            PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC, ptr->staging.capacity(), 0u);
+    for (pnanovdb_uint32_t idx = 0u; idx < s_paged_readback_count; idx++)
+    {
+        ptr->readbacks[idx].buffer =
+            paged_create_buffer(compute_interface, context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK,
+                                PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST, feedback_size, 0u);
+        if (!ptr->readbacks[idx].buffer)
+        {
+            return false;
+        }
+    }
+    if (!ptr->skeleton_buffer || !ptr->pool_buffer || !ptr->page_table_buffer || !ptr->feedback_buffer ||
+        !ptr->feedback_clear_buffer || !ptr->params_buffer || !ptr->staging_buffer)
+    {
+        return false;
+    }
+
+    void* mapped_clear = compute_interface->map_buffer(context, ptr->feedback_clear_buffer);
+    memset(mapped_clear, 0, feedback_size);
+    compute_interface->unmap_buffer(context, ptr->feedback_clear_buffer);
+
+    paged_params_t params = {};
+    params.leaf_offset_lo = pnanovdb_uint32_t(ptr->leaf_offset & 0xFFFFFFFF);
+    params.leaf_offset_hi = pnanovdb_uint32_t(ptr->leaf_offset >> 32u);
+    params.leaf_size = pnanovdb_uint32_t(ptr->leaf_size);
+    params.leaves_per_page = s_paged_leaves_per_page;
+    params.page_count = ptr->page_count;
+    params.page_size = pnanovdb_uint32_t(ptr->page_size);
+    void* mapped_params = compute_interface->map_buffer(context, ptr->params_buffer);
+    memcpy(mapped_params, &params, sizeof(paged_params_t));
+    compute_interface->unmap_buffer(context, ptr->params_buffer);
+
+    paged_upload_once(compute_interface, context, ptr->skeleton_buffer, ptr->grid_data, ptr->leaf_offset,
+                      "paged_nanovdb_skeleton_upload");
+
+    pnanovdb_compute_copy_buffer_params_t clear_params = {};
+    clear_params.num_bytes = feedback_size;
+    clear_params.src = compute_interface->register_buffer_as_transient(context, ptr->feedback_clear_buffer);
+    clear_params.dst = compute_interface->register_buffer_as_transient(context, ptr->feedback_buffer);
+    clear_params.debug_label = "paged_nanovdb_feedback_clear";
+    compute_interface->copy_buffer(context, &clear_params);
+
+    return true;
+}
+
+// Consumes feedback that finished on the GPU, pages used this frame are refreshed or requested
+static void paged_process_feedback(paged_nanovdb_t* ptr,
+                                   pnanovdb_compute_interface_t* compute_interface,
+                                   pnanovdb_compute_context_t* context)
+{
+    pnanovdb_compute_frame_info_t frame_info = {};
+    compute_interface->get_frame_info(context, &frame_info);
+
+    std::vector<pnanovdb_uint32_t> requests;
+    const pnanovdb_uint32_t word_count = (ptr->page_count + 31u) / 32u;
+    for (pnanovdb_uint32_t idx = 0u; idx < s_paged_readback_count; idx++)
+    {
+        paged_readback_t& readback = ptr->readbacks[idx];
+        if (!readback.pending || readback.frame > frame_info.frame_global_completed)
+        {
+            continue;
+        }
+        const pnanovdb_uint32_t* mapped =
+            (const pnanovdb_uint32_t*)compute_interface->map_buffer(context, readback.buffer);
+        for (pnanovdb_uint32_t word_idx = 0u; word_idx < word_count; word_idx++)
+        {
+            pnanovdb_uint32_t bits = mapped[word_idx];
+            while (bits)
+            {
+                pnanovdb_uint32_t bit = 0u;
+                while (((bits >> bit) & 1u) == 0u)
+                {
+                    bit++;
+                }
+                bits &= ~(1u << bit);
+                paged_request_page(ptr, word_idx * 32u + bit, requests);
+            }
+        }
+        compute_interface->unmap_buffer(context, readback.buffer);
+        readback.pending = false;
+    }
+    paged_submit_requests(ptr, requests);
+}
+
+// Loaded pages wait in order until both a slot and staging space are available, dropping them would only have the
+// shader request them again
+static void paged_upload_loaded(paged_nanovdb_t* ptr,
+                                pnanovdb_compute_interface_t* compute_interface,
+                                pnanovdb_compute_context_t* context)
+{
+    pnanovdb_compute_frame_info_t frame_info = {};
+    compute_interface->get_frame_info(context, &frame_info);
+    ptr->staging.retire(frame_info.frame_local_completed);
+
+    {
+        std::lock_guard<std::mutex> lock(ptr->mutex);
+        ptr->ready_loads.insert(ptr->ready_loads.end(), std::make_move_iterator(ptr->load_results.begin()),
+                                std::make_move_iterator(ptr->load_results.end()));
+        ptr->load_results.clear();
+    }
+    if (ptr->ready_loads.empty() && !ptr->residency.dirty())
+    {
+        return;
+    }
+
+    // the page table is staged before the first page write, a slot must never be overwritten without publishing
+    // its eviction in the same frame
+    const pnanovdb_uint64_t page_table_size = pnanovdb_uint64_t(ptr->page_count) * 4u;
+    pnanovdb_uint64_t page_table_offset = StagingRing::k_invalid;
+
+    pnanovdb_uint32_t upload_count = 0u;
+    while (!ptr->ready_loads.empty() && upload_count < s_paged_max_uploads_per_frame)
+    {
+        pnanovdb_uint32_t slot = ptr->residency.alloc_slot(ptr->frame);
+        if (slot == PageResidency::k_invalid)
+        {
+            // pool is saturated by visible pages, retry once a slot ages out
+            break;
+        }
+        if (page_table_offset == StagingRing::k_invalid)
+        {
+            page_table_offset = ptr->staging.alloc(page_table_size, frame_info.frame_local_current);
+        }
+        pnanovdb_uint64_t staging_offset = StagingRing::k_invalid;
+        if (page_table_offset != StagingRing::k_invalid)
+        {
+            staging_offset = ptr->staging.alloc(ptr->page_size, frame_info.frame_local_current);
+        }
+        if (staging_offset == StagingRing::k_invalid)
+        {
+            // the slot keeps its old contents, only the CPU side dropped its page
+            ptr->residency.free_slot(slot);
+            break;
+        }
+        paged_load_t& load = ptr->ready_loads.front();
+        paged_upload(ptr, compute_interface, context, staging_offset, ptr->pool_buffer,
+                     pnanovdb_uint64_t(slot) * ptr->page_size, load.data.data(), ptr->page_size,
+                     "paged_nanovdb_page_upload");
+        ptr->residency.make_resident(load.page, slot, ptr->frame);
+        ptr->ready_loads.pop_front();
+        upload_count++;
+    }
+    if (!ptr->residency.dirty())
+    {
+        return;
+    }
+    if (page_table_offset == StagingRing::k_invalid)
+    {
+        page_table_offset = ptr->staging.alloc(page_table_size, frame_info.frame_local_current);
+        if (page_table_offset == StagingRing::k_invalid)
+        {
+            // stays dirty, no slot was overwritten so the published table is still valid
+            return;
+        }
+    }
+    paged_upload(ptr, compute_interface, context, page_table_offset, ptr->page_table_buffer, 0u,
+                 ptr->residency.page_table().data(), page_table_size, "paged_nanovdb_page_table_upload");
+    ptr->residency.clear_dirty();
+}
+
+pnanovdb_bool_t dispatch_shader_on_paged_nanovdb(const pnanovdb_compute_t* compute,
+                                                 const pnanovdb_compute_device_t* device,
+                                                 const pnanovdb_shader_context_t* shader_context,
+                                                 pnanovdb_compute_paged_nanovdb_t* paged,
+                                                 pnanovdb_int32_t image_width,
+                                                 pnanovdb_int32_t image_height,
+                                                 pnanovdb_compute_texture_t* background_image,
+                                                 pnanovdb_compute_buffer_transient_t* upload_buffer,
+                                                 pnanovdb_compute_buffer_transient_t* user_upload_buffer)
+{
+    paged_nanovdb_t* ptr = cast(paged);
+    if (!compute || !device || !shader_context || !ptr)
+    {
+        return PNANOVDB_FALSE;
+    }
+    if (image_width <= 0 || image_height <= 0 || !background_image)
+    {
+        return PNANOVDB_FALSE;
+    }
+
+    pnanovdb_compute_queue_t* queue = compute->device_interface.get_device_queue(device);
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+    if (!queue || !compute_interface || !context)
+    {
+        return PNANOVDB_FALSE;
+    }
+
+    if (!ptr->skeleton_buffer && !paged_init_device(ptr, compute_interface, context))
+    {
+        printf("Error: paged NanoVDB device buffer allocation failed\n");
+        return PNANOVDB_FALSE;
+    }
+
+    ptr->frame++;
+    paged_process_feedback(ptr, compute_interface, context);
+    paged_upload_loaded(ptr, compute_interface, context);
+
+    pnanovdb_compute_buffer_transient_t* feedback_transient =
+        compute_interface->register_buffer_as_transient(context, ptr->feedback_buffer);
+
+    pnanovdb_compute_resource_t resources[8u] = {};
+    resources[0u].buffer_transient = compute_interface->register_buffer_as_transient(context, ptr->skeleton_buffer);
+    resources[1u].buffer_transient = compute_interface->register_buffer_as_transient(context, ptr->pool_buffer);
+    resources[2u].buffer_transient = compute_interface->register_buffer_as_transient(context, ptr->page_table_buffer);
+    resources[3u].buffer_transient = feedback_transient;
+    resources[4u].texture_transient = compute_interface->register_texture_as_transient(context, background_image);
+    resources[5u].buffer_transient = upload_buffer;
+    resources[6u].buffer_transient = user_upload_buffer;
+    resources[7u].buffer_transient = compute_interface->register_buffer_as_transient(context, ptr->params_buffer);
+
+    compute->dispatch_shader(compute_interface, context, shader_context, resources, (image_width + 15u) / 16u,
+                             (image_height + 7u) / 8u, 1u, "dispatch_shader_on_paged_nanovdb");
+
+    // feedback is consumed once the frame completes, a busy ring slot just skips this frame's feedback
+    paged_readback_t& readback = ptr->readbacks[ptr->readback_idx];
+    const pnanovdb_uint64_t feedback_size = ((ptr->page_count + 31u) / 32u) * 4u;
+    if (!readback.pending)
+    {
+        pnanovdb_compute_frame_info_t frame_info = {};
+        compute_interface->get_frame_info(context, &frame_info);
+
+        pnanovdb_compute_copy_buffer_params_t copy_params = {};
+        copy_params.num_bytes = feedback_size;
+        copy_params.src = feedback_transient;
+        copy_params.dst = compute_interface->register_buffer_as_transient(context, readback.buffer);
+        copy_params.debug_label = "paged_nanovdb_feedback_readback";
+        compute_interface->copy_buffer(context, &copy_params);
+
+        readback.frame = frame_info.frame_global_current;
+        readback.pending = true;
+        ptr->readback_idx = (ptr->readback_idx + 1u) % s_paged_readback_count;
+    }
+
+    pnanovdb_compute_copy_buffer_params_t clear_params = {};
+    clear_params.num_bytes = feedback_size;
+    clear_params.src = compute_interface->register_buffer_as_transient(context, ptr->feedback_clear_buffer);
+    clear_params.dst = feedback_transient;
+    clear_params.debug_label = "paged_nanovdb_feedback_clear";
+    compute_interface->copy_buffer(context, &clear_params);
+
+    return PNANOVDB_TRUE;
+}
+
+void get_paged_nanovdb_stats(pnanovdb_compute_paged_nanovdb_t* paged,
+                             pnanovdb_compute_paged_nanovdb_stats_t* dst_stats)
+{
+    paged_nanovdb_t* ptr = cast(paged);
+    if (!ptr || !dst_stats)
+    {
+        return;
+    }
+    dst_stats->skeleton_size_in_bytes = ptr->leaf_offset;
+    dst_stats->page_size_in_bytes = ptr->page_size;
+    dst_stats->page_count = ptr->page_count;
+    dst_stats->pool_page_count = ptr->pool_page_count;
+    dst_stats->resident_page_count = ptr->residency.resident_page_count();
+    dst_stats->pending_page_count = ptr->residency.pending_page_count();
+}
+}
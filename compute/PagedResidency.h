@@ -0,0 +1,171 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/compute/PagedResidency.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Page table and slot eviction bookkeeping for out-of-core NanoVDB leaf pages
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Compute.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace pnanovdb_compute
+{
+// Maps pages to slots of a fixed size pool, slots of pages unused for keep_frames are reused in clock order
+class PageResidency
+{
+public:
+    static constexpr pnanovdb_uint32_t k_invalid = 0xFFFFFFFF;
+
+    PageResidency() = default;
+
+    PageResidency(pnanovdb_uint32_t page_count, pnanovdb_uint32_t slot_count, pnanovdb_uint32_t keep_frames)
+        : m_page_table(page_count, k_invalid),
+          m_page_last_used(page_count, 0u),
+          m_page_requested(page_count, false),
+          m_slot_page(slot_count, k_invalid),
+          m_slot_last_used(slot_count, 0u),
+          m_keep_frames(keep_frames)
+    {
+        m_free_slots.reserve(slot_count);
+        for (pnanovdb_uint32_t slot = slot_count; slot > 0u; slot--)
+        {
+            m_free_slots.push_back(slot - 1u);
+        }
+    }
+
+    pnanovdb_uint32_t page_count() const
+    {
+        return pnanovdb_uint32_t(m_page_table.size());
+    }
+
+    pnanovdb_uint32_t slot_count() const
+    {
+        return pnanovdb_uint32_t(m_slot_page.size());
+    }
+
+    pnanovdb_uint32_t free_slot_count() const
+    {
+        return pnanovdb_uint32_t(m_free_slots.size());
+    }
+
+    pnanovdb_uint32_t resident_page_count() const
+    {
+        return m_resident_page_count;
+    }
+
+    pnanovdb_uint32_t pending_page_count() const
+    {
+        return m_pending_page_count;
+    }
+
+    pnanovdb_uint32_t slot(pnanovdb_uint32_t page) const
+    {
+        return m_page_table[page];
+    }
+
+    const std::vector<pnanovdb_uint32_t>& page_table() const
+    {
+        return m_page_table;
+    }
+
+    // set whenever a page gains or loses its slot, cleared once the page table is uploaded
+    bool dirty() const
+    {
+        return m_dirty;
+    }
+
+    void clear_dirty()
+    {
+        m_dirty = false;
+    }
+
+    // marks page used in frame, returns true when it is neither resident nor already requested
+    bool touch(pnanovdb_uint32_t page, pnanovdb_uint64_t frame)
+    {
+        m_page_last_used[page] = frame;
+        if (m_page_table[page] != k_invalid)
+        {
+            m_slot_last_used[m_page_table[page]] = frame;
+            return false;
+        }
+        if (m_page_requested[page])
+        {
+            return false;
+        }
+        m_page_requested[page] = true;
+        m_pending_page_count++;
+        return true;
+    }
+
+    // a free slot or the slot of a page evicted by the clock sweep, k_invalid while every page is still in use
+    pnanovdb_uint32_t alloc_slot(pnanovdb_uint64_t frame)
+    {
+        if (!m_free_slots.empty())
+        {
+            pnanovdb_uint32_t slot = m_free_slots.back();
+            m_free_slots.pop_back();
+            return slot;
+        }
+        const pnanovdb_uint32_t slot_count = this->slot_count();
+        for (pnanovdb_uint32_t attempt = 0u; attempt < slot_count; attempt++)
+        {
+            pnanovdb_uint32_t slot = m_clock_hand;
+            m_clock_hand = (m_clock_hand + 1u) % slot_count;
+            if (m_slot_last_used[slot] + m_keep_frames < frame)
+            {
+                pnanovdb_uint32_t old_page = m_slot_page[slot];
+                if (old_page != k_invalid)
+                {
+                    m_page_table[old_page] = k_invalid;
+                    m_resident_page_count--;
+                    m_dirty = true;
+                }
+                m_slot_page[slot] = k_invalid;
+                return slot;
+            }
+        }
+        return k_invalid;
+    }
+
+    // returns a slot from alloc_slot that ended up unused
+    void free_slot(pnanovdb_uint32_t slot)
+    {
+        m_free_slots.push_back(slot);
+    }
+
+    void make_resident(pnanovdb_uint32_t page, pnanovdb_uint32_t slot, pnanovdb_uint64_t frame)
+    {
+        if (m_page_requested[page])
+        {
+            m_page_requested[page] = false;
+            m_pending_page_count--;
+        }
+        m_page_table[page] = slot;
+        m_slot_page[slot] = page;
+        m_slot_last_used[slot] = std::max(m_page_last_used[page], frame);
+        m_resident_page_count++;
+        m_dirty = true;
+    }
+
+private:
+    std::vector<pnanovdb_uint32_t> m_page_table;
+    std::vector<pnanovdb_uint64_t> m_page_last_used;
+    std::vector<bool> m_page_requested;
+    std::vector<pnanovdb_uint32_t> m_slot_page;
+    std::vector<pnanovdb_uint64_t> m_slot_last_used;
+    std::vector<pnanovdb_uint32_t> m_free_slots;
+    pnanovdb_uint32_t m_keep_frames = 0u;
+    pnanovdb_uint32_t m_clock_hand = 0u;
+    pnanovdb_uint32_t m_resident_page_count = 0u;
+    pnanovdb_uint32_t m_pending_page_count = 0u;
+    bool m_dirty = true;
+};
+} // namespace pnanovdb_compute
@@ -0,0 +1,193 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/compute/ReadbackQueue.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  Ring of readback buffers tagged with the frame that filled them.
+
+    Results are mapped in submission order once the queue reports their frame as completed, the host never waits on
+    the GPU. A full ring rejects new copies instead of stalling, so callers drop a frame rather than the frame rate.
+*/
+
+#include "Compute.h"
+
+#include <stdio.h>
+#include <vector>
+
+namespace pnanovdb_compute
+{
+static const pnanovdb_uint32_t s_readback_default_depth = 3u;
+static const pnanovdb_uint64_t s_readback_min_buffer_size = 65536u;
+
+struct readback_slot_t
+{
+    pnanovdb_compute_buffer_t* buffer = nullptr;
+    pnanovdb_uint64_t capacity = 0u;
+    pnanovdb_uint64_t num_bytes = 0u;
+    pnanovdb_uint64_t ticket = 0u;
+    pnanovdb_uint64_t frame = 0u;
+};
+
+struct readback_queue_t
+{
+    std::vector<readback_slot_t> slots;
+    pnanovdb_uint32_t read_idx = 0u;
+    pnanovdb_uint32_t pending_count = 0u;
+    pnanovdb_uint64_t next_ticket = 1u;
+    bool mapped = false;
+};
+
+PNANOVDB_CAST_PAIR(pnanovdb_compute_readback_queue_t, readback_queue_t)
+
+pnanovdb_compute_readback_queue_t* create_readback_queue(pnanovdb_uint32_t depth)
+{
+    readback_queue_t* ptr = new readback_queue_t();
+    ptr->slots.resize(depth ? depth : s_readback_default_depth);
+    return cast(ptr);
+}
+
+void destroy_readback_queue(const pnanovdb_compute_t* compute,
+                            pnanovdb_compute_queue_t* queue,
+                            pnanovdb_compute_readback_queue_t* readback_queue)
+{
+    readback_queue_t* ptr = cast(readback_queue);
+    if (!ptr)
+    {
+        return;
+    }
+    if (compute && queue)
+    {
+        pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+        for (readback_slot_t& slot : ptr->slots)
+        {
+            if (slot.buffer)
+            {
+                compute_interface->destroy_buffer(context, slot.buffer);
+            }
+        }
+    }
+    delete ptr;
+}
+
+bool readback_queue_is_full(pnanovdb_compute_readback_queue_t* readback_queue)
+{
+    readback_queue_t* ptr = cast(readback_queue);
+    return !ptr || ptr->pending_count == pnanovdb_uint32_t(ptr->slots.size());
+}
+
+pnanovdb_uint64_t enqueue_readback(const pnanovdb_compute_t* compute,
+                                   pnanovdb_compute_queue_t* queue,
+                                   pnanovdb_compute_readback_queue_t* readback_queue,
+                                   pnanovdb_compute_buffer_transient_t* src,
+                                   pnanovdb_uint64_t num_bytes)
+{
+    readback_queue_t* ptr = cast(readback_queue);
+    if (!ptr || !compute || !queue || !src || num_bytes == 0u)
+    {
+        return 0u;
+    }
+    const pnanovdb_uint32_t depth = pnanovdb_uint32_t(ptr->slots.size());
+    if (ptr->pending_count == depth)
+    {
+        return 0u;
+    }
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+    readback_slot_t& slot = ptr->slots[(ptr->read_idx + ptr->pending_count) % depth];
+    if (slot.buffer && slot.capacity < num_bytes)
+    {
+        compute_interface->destroy_buffer(context, slot.buffer);
+        slot.buffer = nullptr;
+    }
+    if (!slot.buffer)
+    {
+        pnanovdb_compute_buffer_desc_t buf_desc = {};
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+        buf_desc.size_in_bytes = s_readback_min_buffer_size;
+        while (buf_desc.size_in_bytes < num_bytes)
+        {
+            buf_desc.size_in_bytes *= 2u;
+        }
+        slot.buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+        slot.capacity = slot.buffer ? buf_desc.size_in_bytes : 0u;
+        if (!slot.buffer)
+        {
+            printf("Error: enqueue_readback failed to create readback buffer of %llu bytes\n",
+                   (unsigned long long int)buf_desc.size_in_bytes);
+            return 0u;
+        }
+    }
+
+    pnanovdb_compute_copy_buffer_params_t copy_params = {};
+    copy_params.num_bytes = num_bytes;
+    copy_params.src = src;
+    copy_params.dst = compute_interface->register_buffer_as_transient(context, slot.buffer);
+    copy_params.debug_label = "readback_queue";
+    compute_interface->copy_buffer(context, &copy_params);
+
+    pnanovdb_compute_frame_info_t frame_info = {};
+    compute_interface->get_frame_info(context, &frame_info);
+
+    slot.num_bytes = num_bytes;
+    slot.ticket = ptr->next_ticket++;
+    slot.frame = frame_info.frame_global_current;
+    ptr->pending_count++;
+    return slot.ticket;
+}
+
+const void* map_readback(const pnanovdb_compute_t* compute,
+                         pnanovdb_compute_queue_t* queue,
+                         pnanovdb_compute_readback_queue_t* readback_queue,
+                         pnanovdb_uint64_t* dst_ticket,
+                         pnanovdb_uint64_t* dst_num_bytes)
+{
+    readback_queue_t* ptr = cast(readback_queue);
+    if (!ptr || !compute || !queue || ptr->pending_count == 0u)
+    {
+        return nullptr;
+    }
+    readback_slot_t& slot = ptr->slots[ptr->read_idx];
+    // fences are polled without blocking when the cached completed frame is behind
+    if (!ptr->mapped && compute->device_interface.get_frame_global_completed(queue) < slot.frame &&
+        !compute->device_interface.is_frame_completed(queue, slot.frame))
+    {
+        return nullptr;
+    }
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+    ptr->mapped = true;
+    if (dst_ticket)
+    {
+        *dst_ticket = slot.ticket;
+    }
+    if (dst_num_bytes)
+    {
+        *dst_num_bytes = slot.num_bytes;
+    }
+    return compute_interface->map_buffer(context, slot.buffer);
+}
+
+void unmap_readback(const pnanovdb_compute_t* compute,
+                    pnanovdb_compute_queue_t* queue,
+                    pnanovdb_compute_readback_queue_t* readback_queue)
+{
+    readback_queue_t* ptr = cast(readback_queue);
+    if (!ptr || !compute || !queue || !ptr->mapped)
+    {
+        return;
+    }
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+    compute_interface->unmap_buffer(context, ptr->slots[ptr->read_idx].buffer);
+    ptr->mapped = false;
+    ptr->read_idx = (ptr->read_idx + 1u) % pnanovdb_uint32_t(ptr->slots.size());
+    ptr->pending_count--;
+}
+} // namespace pnanovdb_compute
@@ -619,6 +619,8 @@ void show(pnanovdb_editor_t* editor, pnanovdb_compute_device_t* device, pnanovdb
     renderer_config.compute_queue = compute_queue;
     renderer_config.raster = editor->impl->raster;
     renderer_config.raster_ctx = editor->impl->raster_ctx;
+    renderer_config.residency_budget_in_bytes = pnanovdb_uint64_t(config->residency_budget_mb) << 20u;
+    renderer_config.gpu_memory_budget_in_bytes = pnanovdb_uint64_t(config->gpu_memory_budget_mb) << 20u;
     editor->impl->renderer->init(renderer_config);
 
     // Initialize the rasterization in Pipeline with the same config
@@ -678,6 +680,11 @@ void show(pnanovdb_editor_t* editor, pnanovdb_compute_device_t* device, pnanovdb
         if (imgui_user_instance && imgui_user_instance->pending.update_memory_stats)
         {
             editor->impl->compute->device_interface.get_memory_stats(device, Profiler::getInstance().getMemoryStats());
+            if (editor->impl->raster && editor->impl->raster_ctx)
+            {
+                editor->impl->raster->get_gaussian_cull_stats(
+                    editor->impl->raster_ctx, Profiler::getInstance().getGaussianCullStats());
+            }
             imgui_user_instance->pending.update_memory_stats = false;
         }
 
@@ -734,6 +741,8 @@ void show(pnanovdb_editor_t* editor, pnanovdb_compute_device_t* device, pnanovdb
                 pnanovdb_editor_token_t* scene_token = nullptr;
                 pnanovdb_editor_token_t* name_token = nullptr;
                 std::string shader_name;
+                std::string paged_filepath; // set when the grid is paged straight from its file
+                pnanovdb_uint32_t paged_grid_idx = 0u;
             };
             std::vector<OrderedRenderable> renderables;
             std::vector<pnanovdb_editor_token_t*> ordered_views =
@@ -759,11 +768,33 @@ void show(pnanovdb_editor_t* editor, pnanovdb_compute_device_t* device, pnanovdb
                         {
                             pnanovdb_compute_array_t* array =
                                 obj->nanovdb_array() ? obj->nanovdb_array() : obj->converted_nanovdb();
+                            const char* shader = pnanovdb_editor::pipeline_get_shader(obj);
+                            if (!array && obj->resources.nanovdb_file)
+                            {
+                                // grids above the residency budget are mapped by the renderer, never loaded whole
+                                pnanovdb_compute_grid_info_t info = {};
+                                editor->impl->compute->get_nanovdb_file_grid_info(
+                                    obj->resources.nanovdb_file.get(), obj->resources.nanovdb_grid_index, &info);
+                                if (editor->impl->editor_scene->is_paged_nanovdb_file_grid(info))
+                                {
+                                    OrderedRenderable paged;
+                                    paged.render_method = render_method;
+                                    paged.scene_token = obj->scene_token;
+                                    paged.name_token = obj->name_token;
+                                    paged.shader_name = (shader && shader[0] != '\0') ? shader : "";
+                                    paged.paged_filepath = obj->resources.source_filepath;
+                                    paged.paged_grid_idx = obj->resources.nanovdb_grid_index;
+                                    renderables.push_back(paged);
+                                    return;
+                                }
+                                // non-blocking, the object is skipped until its grid finished loading
+                                array = editor->impl->compute->request_nanovdb_file_grid(
+                                    obj->resources.nanovdb_file.get(), obj->resources.nanovdb_grid_index);
+                            }
                             if (!array)
                             {
                                 return;
                             }
-                            const char* shader = pnanovdb_editor::pipeline_get_shader(obj);
                             renderables.push_back({ render_method, array, nullptr, obj->scene_token, obj->name_token,
                                                     (shader && shader[0] != '\0') ? shader : "" });
                         }
@@ -782,10 +813,21 @@ void show(pnanovdb_editor_t* editor, pnanovdb_compute_device_t* device, pnanovdb
                     const char* shader_name =
                         item.shader_name.empty() ? editor->impl->shader_name.c_str() : item.shader_name.c_str();
                     uint32_t composite = rendered ? 1u : 0u;
-                    auto result = editor->impl->renderer->dispatch_nanovdb_shader(
-                        item.nanovdb_array, shader_name, background_image, view, projection, image_width, image_height,
-                        imgui_user_instance, editor->impl->editor_scene, editor->impl->scene_manager, composite,
-                        item.scene_token, item.name_token);
+                    ShaderDispatchResult result = ShaderDispatchResult::NoData;
+                    if (!item.paged_filepath.empty())
+                    {
+                        result = editor->impl->renderer->dispatch_paged_nanovdb_file(
+                            item.paged_filepath.c_str(), item.paged_grid_idx, shader_name, background_image, view,
+                            projection, image_width, image_height, imgui_user_instance, editor->impl->scene_manager,
+                            composite);
+                    }
+                    else
+                    {
+                        result = editor->impl->renderer->dispatch_nanovdb_shader(
+                            item.nanovdb_array, shader_name, background_image, view, projection, image_width,
+                            image_height, imgui_user_instance, editor->impl->editor_scene, editor->impl->scene_manager,
+                            composite, item.scene_token, item.name_token);
+                    }
                     if (result == ShaderDispatchResult::CompilationFailed)
                     {
                         cleanup_background();
@@ -819,6 +861,8 @@ void show(pnanovdb_editor_t* editor, pnanovdb_compute_device_t* device, pnanovdb
             cleanup_background();
         }
 
+        editor->impl->renderer->update_residency(editor->impl->scene_manager);
+
         // 3-frame destruction pipeline for gaussian data:
         {
             // This prevents GPU from accessing freed memory by deferring destruction for 3 frames
@@ -2344,6 +2388,55 @@ pnanovdb_compute_array_t* get_named_array(pnanovdb_editor_t* editor,
     return result;
 }
 
+pnanovdb_bool_t update_nanovdb_range(pnanovdb_editor_t* editor,
+                                     pnanovdb_editor_token_t* scene,
+                                     pnanovdb_editor_token_t* name,
+                                     const void* data,
+                                     pnanovdb_uint64_t byte_offset,
+                                     pnanovdb_uint64_t num_bytes)
+{
+    if (!editor || !editor->impl || !scene || !name || !data || num_bytes == 0u)
+    {
+        return PNANOVDB_FALSE;
+    }
+
+    const pnanovdb_compute_t* compute = editor->impl->compute;
+    pnanovdb_bool_t result = PNANOVDB_FALSE;
+    editor->impl->scene_manager->with_object(
+        scene, name,
+        [&](SceneObject* obj)
+        {
+            if (!obj)
+            {
+                return;
+            }
+            // same array the renderer picks for the object
+            pnanovdb_compute_array_t* array = obj->resolve_nanovdb_array(editor->impl->compute);
+            if (!array || !array->data)
+            {
+                return;
+            }
+            const pnanovdb_uint64_t size_in_bytes = array->element_count * array->element_size;
+            if (byte_offset > size_in_bytes || num_bytes > size_in_bytes - byte_offset)
+            {
+                return;
+            }
+            std::memcpy(static_cast<pnanovdb_uint8_t*>(array->data) + byte_offset, data, num_bytes);
+            // the device copy refreshes only this range on the next render
+            compute->mark_array_dirty(array, byte_offset, num_bytes);
+            result = PNANOVDB_TRUE;
+        });
+
+    if (!result)
+    {
+        Console::getInstance().addLog(Console::LogLevel::Error,
+                                      "update_nanovdb_range: no NanoVDB holding bytes [%llu, %llu) for '%s'",
+                                      (unsigned long long)byte_offset, (unsigned long long)(byte_offset + num_bytes),
+                                      token_to_string_log(name));
+    }
+    return result;
+}
+
 PNANOVDB_API pnanovdb_editor_t* pnanovdb_get_editor()
 {
     static pnanovdb_editor_t editor = { PNANOVDB_REFLECT_INTERFACE_INIT(pnanovdb_editor_t) };
@@ -2388,6 +2481,7 @@ PNANOVDB_API pnanovdb_editor_t* pnanovdb_get_editor()
     editor.unmap_pipeline_params = unmap_pipeline_params;
     editor.set_custom_scene_params = set_custom_scene_params;
     editor.get_custom_scene_params_data_type = get_custom_scene_params_data_type;
+    editor.update_nanovdb_range = update_nanovdb_range;
 
     return &editor;
 }
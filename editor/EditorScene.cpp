@@ -19,6 +19,7 @@
 #include "ShaderCompileUtils.h"
 #include "Console.h"
 #include "Pipeline.h"
+#include "Renderer.h"
 
 #include "raster/Raster.h"
 
@@ -286,8 +287,7 @@ void EditorScene::load_view_into_editor_and_ui(SceneObject* scene_obj)
     if (render_method == pnanovdb_pipeline_render_method_nanovdb)
     {
         // NanoVDB rendering - use nanovdb_array or converted_nanovdb (Raster3D stores in both; fallback for robustness)
-        pnanovdb_compute_array_t* array =
-            scene_obj->nanovdb_array() ? scene_obj->nanovdb_array() : scene_obj->converted_nanovdb();
+        pnanovdb_compute_array_t* array = scene_obj->resolve_nanovdb_array(m_compute, false);
         m_editor->impl->nanovdb_array = array;
         m_editor->impl->shader_params = obj_shader_params;
         m_editor->impl->shader_params_data_type = nullptr;
@@ -1060,6 +1060,80 @@ void EditorScene::handle_nanovdb_data_load(pnanovdb_editor_token_t* scene,
         scene_token, name_token, nanovdb_array, params_array ? params_array->data : nullptr);
 }
 
+void EditorScene::handle_nanovdb_file_load(pnanovdb_editor_token_t* scene,
+                                           std::shared_ptr<pnanovdb_compute_nanovdb_file_t> nanovdb_file,
+                                           const char* filename,
+                                           pnanovdb_pipeline_type_t render_pipeline)
+{
+    if (!scene || !filename || !nanovdb_file)
+    {
+        return;
+    }
+
+    std::filesystem::path fsPath(filename);
+    std::string stem = fsPath.stem().string();
+
+    const char* pipeline_shader = pnanovdb_pipeline_get_shader_name(render_pipeline);
+    const char* shader_name =
+        (pipeline_shader && pipeline_shader[0] != '\0') ? pipeline_shader : m_nanovdb_params.shader_name.c_str();
+    pnanovdb_editor_token_t* shader_name_token = EditorToken::getInstance().getToken(shader_name);
+
+    pnanovdb_editor_token_t* first_name_token = nullptr;
+    pnanovdb_uint32_t grid_count = m_compute->get_nanovdb_file_grid_count(nanovdb_file.get());
+    for (pnanovdb_uint32_t grid_idx = 0u; grid_idx < grid_count; grid_idx++)
+    {
+        pnanovdb_compute_grid_info_t info = {};
+        m_compute->get_nanovdb_file_grid_info(nanovdb_file.get(), grid_idx, &info);
+        std::string view_name = stem + "." + (info.grid_name[0] != '\0' ? std::string(info.grid_name) :
+                                                                         "grid" + std::to_string(grid_idx));
+        pnanovdb_editor_token_t* name_token = EditorToken::getInstance().getToken(view_name.c_str());
+
+        // no array yet, the renderer requests the grid from the shared file when the object becomes visible
+        m_scene_manager.add_nanovdb(scene, name_token, nullptr, nullptr, m_compute, shader_name_token,
+                                    pnanovdb_pipeline_type_noop, render_pipeline);
+
+        std::string filepath_copy = filename;
+        const bool visible = (grid_idx == 0u);
+        m_scene_manager.with_object(scene, name_token,
+                                    [&nanovdb_file, filepath_copy, grid_idx, visible](SceneObject* obj)
+                                    {
+                                        if (!obj)
+                                            return;
+                                        obj->resources.source_filepath = filepath_copy;
+                                        obj->resources.nanovdb_file = nanovdb_file;
+                                        obj->resources.nanovdb_grid_index = grid_idx;
+                                        obj->visible = visible;
+                                    });
+
+        add_nanovdb_placeholder(scene, name_token);
+        if (!first_name_token)
+        {
+            first_name_token = name_token;
+        }
+    }
+
+    if (first_name_token)
+    {
+        pnanovdb_compute_grid_info_t info = {};
+        m_compute->get_nanovdb_file_grid_info(nanovdb_file.get(), 0u, &info);
+        if (!is_paged_nanovdb_file_grid(info))
+        {
+            m_compute->request_nanovdb_file_grid(nanovdb_file.get(), 0u);
+        }
+        select_render_view(scene, first_name_token);
+    }
+}
+
+bool EditorScene::is_paged_nanovdb_file_grid(const pnanovdb_compute_grid_info_t& info) const
+{
+    if (!m_editor || !m_editor->impl || !m_editor->impl->renderer)
+    {
+        return false;
+    }
+    return info.codec == pnanovdb_uint32_t(nanovdb::io::Codec::NONE) &&
+           m_editor->impl->renderer->is_paged_nanovdb(info.grid_size);
+}
+
 void EditorScene::handle_mesh_data_load(pnanovdb_editor_token_t* scene,
                                         pnanovdb_compute_array_t* indices,
                                         pnanovdb_compute_array_t* positions,
@@ -1939,7 +2013,7 @@ bool EditorScene::save_nanovdb_file(pnanovdb_editor_token_t* scene, pnanovdb_edi
                                     if (obj)
                                     {
                                         // Accept both native NanoVDB objects and GaussianData converted via Raster3D
-                                        array = obj->nanovdb_array() ? obj->nanovdb_array() : obj->converted_nanovdb();
+                                        array = obj->resolve_nanovdb_array(m_compute);
                                     }
                                 });
 
@@ -222,6 +222,15 @@ public:
                                   const char* filename,
                                   pnanovdb_pipeline_type_t render_pipeline = pnanovdb_pipeline_type_nanovdb_render);
 
+    //! Adds one object per grid of a file, the first grid is visible and requested unless it is paged
+    void handle_nanovdb_file_load(pnanovdb_editor_token_t* scene,
+                                  std::shared_ptr<pnanovdb_compute_nanovdb_file_t> nanovdb_file,
+                                  const char* filename,
+                                  pnanovdb_pipeline_type_t render_pipeline = pnanovdb_pipeline_type_nanovdb_render);
+
+    //! True for uncompressed grids above the residency budget, the renderer maps these from the file
+    bool is_paged_nanovdb_file_grid(const pnanovdb_compute_grid_info_t& info) const;
+
     void handle_gaussian_data_load(pnanovdb_editor_token_t* scene,
                                    pnanovdb_raster_gaussian_data_t* gaussian_data,
                                    pnanovdb_raster_shader_params_t* raster_params,
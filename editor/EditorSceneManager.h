@@ -67,6 +67,10 @@ struct SceneObjectResources
     // Source file path (for re-conversion from file with different parameters)
     std::string source_filepath;
 
+    // Multi-grid source shared by every object created from the file, the grid loads on first render
+    std::shared_ptr<pnanovdb_compute_nanovdb_file_t> nanovdb_file;
+    pnanovdb_uint32_t nanovdb_grid_index = 0u;
+
     // Ownership handles for automatic cleanup
     std::shared_ptr<pnanovdb_compute_array_t> nanovdb_array_owner;
     std::shared_ptr<pnanovdb_raster_gaussian_data_t> gaussian_data_owner;
@@ -310,6 +314,26 @@ struct SceneObject
         return resources.converted_nanovdb;
     }
 
+    // NanoVDB bytes of the object, a grid of a multi-grid file is owned by the file and loaded on first access.
+    // Without wait it stays null until the load finished.
+    pnanovdb_compute_array_t* resolve_nanovdb_array(const pnanovdb_compute_t* compute, bool wait = true)
+    {
+        if (resources.nanovdb_array)
+        {
+            return resources.nanovdb_array;
+        }
+        if (resources.converted_nanovdb)
+        {
+            return resources.converted_nanovdb;
+        }
+        if (!resources.nanovdb_file || !compute)
+        {
+            return nullptr;
+        }
+        return wait ? compute->get_nanovdb_file_grid(resources.nanovdb_file.get(), resources.nanovdb_grid_index) :
+                      compute->request_nanovdb_file_grid(resources.nanovdb_file.get(), resources.nanovdb_grid_index);
+    }
+
     // Params
     void*& shader_params()
     {
@@ -934,6 +934,19 @@ void showFileHeaderWindow(imgui_instance_user::Instance* ptr)
                     }
                 }
             });
+        // objects of a multi-grid file have no view array, their grid is shown once it finished loading
+        if (!current_array && selection.scene_token && selection.name_token)
+        {
+            ptr->editor_scene->get_scene_manager()->with_object(
+                selection.scene_token, selection.name_token,
+                [&](SceneObject* obj)
+                {
+                    if (obj && obj->type == SceneObjectType::NanoVDB)
+                    {
+                        current_array = obj->resolve_nanovdb_array(ptr->compute, false);
+                    }
+                });
+        }
         pnanovdb_editor::FileHeaderInfo::getInstance().render(current_array);
     }
     ImGui::End();
@@ -1041,6 +1054,20 @@ static bool gaussianImportSidePane(const char* /*vFilter*/, IGFDUserDatas vUserD
     return true;
 }
 
+// Side pane for the NanoVDB open dialog, previews the selected file from its headers
+static bool nanovdbPreviewSidePane(const char* /*vFilter*/, IGFDUserDatas vUserDatas, bool* /*cantContinue*/)
+{
+    auto* ptr = static_cast<imgui_instance_user::Instance*>(vUserDatas);
+    if (!ptr)
+        return false;
+
+    ImGui::Text("Preview:");
+    ImGui::Separator();
+
+    std::string filepath = ImGuiFileDialog::Instance()->GetFilePathName();
+    return pnanovdb_editor::FileHeaderInfo::getInstance().renderFileGrids(ptr->compute, filepath.c_str());
+}
+
 static bool meshImportSidePane(const char* /*vFilter*/, IGFDUserDatas vUserDatas, bool* /*cantContinue*/)
 {
     auto* ptr = static_cast<imgui_instance_user::Instance*>(vUserDatas);
@@ -1063,6 +1090,10 @@ void showFileDialogs(imgui_instance_user::Instance* ptr)
 
         IGFD::FileDialogConfig config;
         config.path = ".";
+        config.sidePane = nanovdbPreviewSidePane;
+        config.sidePaneWidth = 300.0f * getDialogDpiScale();
+        config.flags = ImGuiFileDialogFlags_None;
+        config.userDatas = ptr;
 
         ImGuiFileDialog::Instance()->OpenDialog(
             "OpenNvdbFileDlgKey", "Open NanoVDB File", "NanoVDB Files (*.nvdb){.nvdb}", config);
@@ -405,4 +405,58 @@ bool FileHeaderInfo::render(pnanovdb_compute_array_t* array)
     return true;
 }
 
+bool FileHeaderInfo::renderFileGrids(const pnanovdb_compute_t* compute, const char* filepath)
+{
+    if (!compute || !compute->read_nanovdb_grid_info || !filepath || filepath[0] == '\0')
+    {
+        ImGui::TextDisabled("No file selected");
+        return true;
+    }
+
+    if (m_cached_filepath != filepath)
+    {
+        m_cached_filepath = filepath;
+        m_cached_grids.clear();
+        pnanovdb_uint32_t grid_count = compute->read_nanovdb_grid_info(filepath, nullptr, 0u);
+        m_cached_grids.resize(grid_count);
+        if (grid_count > 0u)
+        {
+            compute->read_nanovdb_grid_info(filepath, m_cached_grids.data(), grid_count);
+        }
+    }
+
+    if (m_cached_grids.empty())
+    {
+        ImGui::TextDisabled("No NanoVDB grids found");
+        return true;
+    }
+
+    ImGui::Text("Grids: %zu", m_cached_grids.size());
+    ImGui::Separator();
+    for (size_t i = 0; i < m_cached_grids.size(); ++i)
+    {
+        const pnanovdb_compute_grid_info_t& info = m_cached_grids[i];
+        ImGui::PushID((int)i);
+        if (ImGui::TreeNodeEx("##grid", ImGuiTreeNodeFlags_DefaultOpen, "[%u:%u] \"%s\"", info.segment_index,
+                              info.grid_index, info.grid_name))
+        {
+            ImGui::Text("Type: %s", getGridTypeName(info.grid_type));
+            ImGui::Text("Class: %s", getGridClassName(info.grid_class));
+            ImGui::Text("Version: %s", getVersionString(info.version).c_str());
+            ImGui::Text("Active Voxels: %llu", (unsigned long long)info.active_voxel_count);
+            ImGui::Text("Leaf/Lower/Upper: %u/%u/%u", info.node_count[0], info.node_count[1], info.node_count[2]);
+            ImGui::Text("Size: %.2f MB", (double)info.grid_size / (1024.0 * 1024.0));
+            if (info.file_size != info.grid_size)
+            {
+                ImGui::Text("Stored: %.2f MB", (double)info.file_size / (1024.0 * 1024.0));
+            }
+            ImGui::Text("Index BBox: (%d, %d, %d) - (%d, %d, %d)", info.index_bbox_min.x, info.index_bbox_min.y,
+                        info.index_bbox_min.z, info.index_bbox_max.x, info.index_bbox_max.y, info.index_bbox_max.z);
+            ImGui::Text("Voxel Size: (%.6f, %.6f, %.6f)", info.voxel_size[0], info.voxel_size[1], info.voxel_size[2]);
+            ImGui::TreePop();
+        }
+        ImGui::PopID();
+    }
+    return true;
+}
 } // namespace pnanovdb_editor
@@ -15,6 +15,9 @@
 
 #include "ImguiInstance.h"
 
+#include <string>
+#include <vector>
+
 namespace pnanovdb_editor
 {
 class FileHeaderInfo
@@ -28,6 +31,9 @@ public:
 
     bool render(pnanovdb_compute_array_t* array);
 
+    // Lists the grids of a file from its headers only, results are cached per filepath
+    bool renderFileGrids(const pnanovdb_compute_t* compute, const char* filepath);
+
 private:
     FileHeaderInfo() = default;
     ~FileHeaderInfo() = default;
@@ -36,5 +42,8 @@ private:
     FileHeaderInfo& operator=(const FileHeaderInfo&) = delete;
     FileHeaderInfo(FileHeaderInfo&&) = delete;
     FileHeaderInfo& operator=(FileHeaderInfo&&) = delete;
+
+    std::string m_cached_filepath;
+    std::vector<pnanovdb_compute_grid_info_t> m_cached_grids;
 };
 }
@@ -20,6 +20,8 @@
 #include <nanovdb/PNanoVDB.h>
 #undef PNANOVDB_C
 
+#include <memory>
+
 namespace pnanovdb_editor
 {
 namespace nanovdb_import
@@ -126,6 +128,44 @@ bool nanovdb(EditorScene& editor_scene,
         return false;
     }
 
+    // multi-grid files become one object per grid sharing a lazily loaded file, a grid above the residency budget
+    // also goes through the file so it is mapped by the renderer instead of loaded whole
+    pnanovdb_compute_nanovdb_file_t* file = compute->open_nanovdb_file(filepath);
+    bool is_paged = false;
+    if (file && compute->get_nanovdb_file_grid_count(file) == 1u)
+    {
+        pnanovdb_compute_grid_info_t info = {};
+        compute->get_nanovdb_file_grid_info(file, 0u, &info);
+        is_paged = editor_scene.is_paged_nanovdb_file_grid(info);
+    }
+    if (file && (compute->get_nanovdb_file_grid_count(file) > 1u || is_paged))
+    {
+        if (required_blind_metadata_count(render_pipeline) > 0u)
+        {
+            Console::getInstance().addLog(Console::LogLevel::Warning, "'%s' %s; using standard NanoVDB render",
+                                          filepath,
+                                          is_paged ? "exceeds the residency budget" : "contains multiple grids");
+            render_pipeline = pnanovdb_pipeline_type_nanovdb_render;
+        }
+        const pnanovdb_uint32_t grid_count = compute->get_nanovdb_file_grid_count(file);
+        std::shared_ptr<pnanovdb_compute_nanovdb_file_t> file_owner(
+            file, [compute](pnanovdb_compute_nanovdb_file_t* f) { compute->close_nanovdb_file(f); });
+        editor_scene.handle_nanovdb_file_load(scene, file_owner, filepath, render_pipeline);
+        if (is_paged)
+        {
+            Console::getInstance().addLog("Opened '%s', leaves are streamed from the file", filepath);
+        }
+        else
+        {
+            Console::getInstance().addLog("Opened %u grids from '%s'", grid_count, filepath);
+        }
+        return true;
+    }
+    if (file)
+    {
+        compute->close_nanovdb_file(file);
+    }
+
     pnanovdb_compute_array_t* array = compute->load_nanovdb(filepath);
     if (!array)
     {
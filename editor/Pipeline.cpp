@@ -19,6 +19,7 @@
 #include "Console.h"
 #include "Profiler.h"
 #include "nanovdb_editor/putil/Reflect.h"
+#include "nanovdb_editor/putil/Trace.hpp"
 #include "nanovdb_editor/putil/WorkerThread.hpp"
 #include "raster/Raster.h"
 
@@ -632,6 +633,8 @@ pnanovdb_pipeline_result_t pipeline_execute_process(SceneObject* obj, const Pipe
         ctx.compute,    ctx.device,   ctx.queue,        ctx.compute_queue,  ctx.raster,
         ctx.raster_ctx, ctx.voxelbvh, ctx.voxelbvh_ctx, cast(ctx.renderer), cast(ctx.scene_manager)
     };
+    const auto* desc = pnanovdb_pipeline_get_descriptor(obj->process_pipeline());
+    pnanovdb_util::TraceScope trace_scope(ctx.compute, "pipeline", desc && desc->name ? desc->name : "process");
     return pnanovdb_pipeline_execute(obj->process_pipeline(), cast(obj), &pipeline_ctx);
 }
 
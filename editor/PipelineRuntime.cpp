@@ -18,6 +18,7 @@
 #include "raster/Raster.h"
 
 #include "nanovdb_editor/putil/FileFormat.h"
+#include "nanovdb_editor/putil/Trace.hpp"
 
 #include <cstdlib>
 #include <cstring>
@@ -275,6 +276,7 @@ bool GaussianVoxelizeWorker::start(SceneObject* scene_obj,
                          pnanovdb_compute_array_t** shader_arrays_arg,
                          pnanovdb_raster_shader_params_t* raster_params) -> bool
         {
+            pnanovdb_util::TraceScope trace_scope(compute, "worker", "gaussian_voxelize");
             return raster->raster_file(raster, compute, queue, filepath, voxel_sz, out_nanovdb,
                                        nullptr, // gaussian_data
                                        nullptr, // raster_context
@@ -455,6 +457,7 @@ bool VoxelBVHWorker::start(SceneObject* scene_obj,
     m_task_id = m_worker->enqueue(
         [this]() -> bool
         {
+            pnanovdb_util::TraceScope trace_scope(m_pending_compute, "worker", "voxelbvh_build");
             if (!m_worker_ctx && m_iface && m_iface->create_context && m_worker_queue)
             {
                 m_worker_ctx = m_iface->create_context(m_iface->compute, m_worker_queue);
@@ -695,6 +698,7 @@ bool GaussianLoadWorker::start(const char* raster_filepath,
                pnanovdb_compute_array_t** shader_params_arrays, pnanovdb_raster_shader_params_t* raster_params,
                pnanovdb_profiler_report_t profiler) -> bool
         {
+            pnanovdb_util::TraceScope trace_scope(compute, "worker", "gaussian_load");
             return raster->raster_file(raster, compute, queue, filepath, voxel_size_arg, nanovdb_array, gaussian_data,
                                        raster_context, shader_params_arrays, raster_params, profiler,
                                        (void*)m_worker.get());
@@ -867,6 +871,7 @@ bool MeshLoadWorker::start(const char* mesh_filepath,
     m_task_id = m_worker->enqueue(
         [this]() -> bool
         {
+            pnanovdb_util::TraceScope trace_scope(m_compute, "worker", "mesh_load");
             pnanovdb_fileformat_t fileformat = {};
             pnanovdb_fileformat_load(&fileformat, m_compute);
             if (!fileformat.load_file)
@@ -35,6 +35,7 @@ bool Profiler::render(bool* update_memory_stats, float delta_time)
     }
 
     pnanovdb_compute_device_memory_stats_t stats;
+    pnanovdb_raster_gaussian_cull_stats_t cull_stats;
     bool show_avg = false;
     uint32_t history_depth = 0u;
     std::vector<std::string> profiler_names;
@@ -43,6 +44,7 @@ bool Profiler::render(bool* update_memory_stats, float delta_time)
     {
         std::lock_guard<std::mutex> lock(mutex_);
         stats = memory_stats_;
+        cull_stats = gaussian_cull_stats_;
         show_avg = show_averages_;
         history_depth = history_depth_;
 
@@ -98,6 +100,175 @@ bool Profiler::render(bool* update_memory_stats, float delta_time)
 
                 ImGui::EndTable();
             }
+
+            if (ImGui::BeginTable("MemoryHeapTable", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Heap", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthFixed, 100.0f);
+                ImGui::TableHeadersRow();
+
+                // fragmentation is the share of free block memory not usable by the largest request
+                pnanovdb_uint64_t heap_free_bytes = stats.heap_block_bytes - stats.heap_used_bytes;
+                float fragmentation =
+                    heap_free_bytes > 0u ? 1.f - float(stats.heap_largest_free_bytes) / float(heap_free_bytes) : 0.f;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Blocks");
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)stats.heap_block_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Used / Reserved (MB)");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f / %.1f", stats.heap_used_bytes / (1024.0f * 1024.0f),
+                            stats.heap_block_bytes / (1024.0f * 1024.0f));
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Fragmentation (%)");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", fragmentation * 100.f);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Sub-allocations");
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)stats.suballocation_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Dedicated allocations");
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)stats.dedicated_allocation_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Dedicated heap blocks");
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)stats.dedicated_block_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Transient aliased (MB)");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f / %.1f", stats.transient_arena_bytes / (1024.0f * 1024.0f),
+                            stats.transient_requested_bytes / (1024.0f * 1024.0f));
+
+                if (stats.device_local_budget_bytes > 0u)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted("Driver usage / budget (MB)");
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f / %.1f", stats.device_local_usage_bytes / (1024.0f * 1024.0f),
+                                stats.device_local_budget_bytes / (1024.0f * 1024.0f));
+                }
+
+                ImGui::EndTable();
+            }
+        }
+
+        if (cull_stats.raster_count > 0u && ImGui::CollapsingHeader("Gaussian Culling"))
+        {
+            if (ImGui::BeginTable("GaussianCullTable", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Per raster", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthFixed, 140.0f);
+                ImGui::TableHeadersRow();
+
+                // averaged over the rasters since the last memory stats update
+                double raster_count = double(cull_stats.raster_count);
+                double culled = cull_stats.point_count > 0u ?
+                                    1.0 - double(cull_stats.visible_point_count) / double(cull_stats.point_count) :
+                                    0.0;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Gaussians visible / total");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f / %.0f", cull_stats.visible_point_count / raster_count,
+                            cull_stats.point_count / raster_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Chunks visible / total");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f / %.0f", cull_stats.visible_chunk_count / raster_count,
+                            cull_stats.chunk_count / raster_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Culled (%)");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", culled * 100.0);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("SH refreshed chunks (%)");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", cull_stats.visible_chunk_count > 0u ?
+                                        100.0 * double(cull_stats.sh_refresh_chunk_count) /
+                                            double(cull_stats.visible_chunk_count) :
+                                        0.0);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Tile intersections");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", cull_stats.intersection_count / raster_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Coherent sorts / fallbacks");
+                ImGui::TableNextColumn();
+                ImGui::Text("%u / %u", cull_stats.coherent_sort_count, cull_stats.coherent_fallback_count);
+
+                ImGui::EndTable();
+            }
+        }
+
+        if (cull_stats.tile_stats_count > 0u && ImGui::CollapsingHeader("Tile Load"))
+        {
+            double stats_count = double(cull_stats.tile_stats_count);
+            if (ImGui::BeginTable("TileLoadTable", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Per raster", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthFixed, 140.0f);
+                ImGui::TableHeadersRow();
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Tiles split / total");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f / %.0f", cull_stats.split_tile_count / stats_count,
+                            cull_stats.tile_count / stats_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Work items");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", cull_stats.tile_work_item_count / stats_count);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Max tile intersections");
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", cull_stats.max_tile_intersections);
+
+                ImGui::EndTable();
+            }
+
+            // tiles per power of two intersection count, bin 0 holds the empty tiles
+            float histogram[PNANOVDB_RASTER_TILE_HISTOGRAM_BINS] = {};
+            for (uint32_t bin = 0u; bin < PNANOVDB_RASTER_TILE_HISTOGRAM_BINS; bin++)
+            {
+                histogram[bin] = float(cull_stats.tile_histogram[bin] / stats_count);
+            }
+            ImGui::PlotHistogram("##TileHistogram", histogram, PNANOVDB_RASTER_TILE_HISTOGRAM_BINS, 0, nullptr, 0.0f,
+                                 FLT_MAX, ImVec2(-1.0f, 80.0f));
+            ImGui::TextUnformatted("Tiles by intersections: 0, 1, 2-3, ... 16384+");
         }
 
         ImGui::Separator();
@@ -239,6 +410,7 @@ void Profiler::render_profiler_table(pnanovdb_uint64_t capture_id,
     float global_total_gpu_time = 0.0f;
     float total_cpu_time = 0.0f;
     float total_gpu_time = 0.0f;
+    pnanovdb_uint32_t total_barrier_count = 0u;
 
     for (uint64_t capture_id_offset = 0llu; capture_id_offset < history_depth; capture_id_offset++)
     {
@@ -280,15 +452,17 @@ void Profiler::render_profiler_table(pnanovdb_uint64_t capture_id,
             continue;
         }
 
-        if (ImGui::BeginTable("ProfilerTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        if (ImGui::BeginTable("ProfilerTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
         {
             ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthStretch);
             ImGui::TableSetupColumn("CPU (ms)", ImGuiTableColumnFlags_WidthFixed, 80.0f);
             ImGui::TableSetupColumn("GPU (ms)", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+            ImGui::TableSetupColumn("Barriers", ImGuiTableColumnFlags_WidthFixed, 80.0f);
             ImGui::TableHeadersRow();
 
             total_cpu_time = 0.0f;
             total_gpu_time = 0.0f;
+            total_barrier_count = 0u;
 
             for (const auto& pair : entries)
             {
@@ -297,12 +471,14 @@ void Profiler::render_profiler_table(pnanovdb_uint64_t capture_id,
 
                 float cpu_ms = 0.f;
                 float gpu_ms = 0.f;
+                pnanovdb_uint32_t barrier_count = 0u;
                 for (size_t idx = entry.entries.size() - 1u; idx < entry.entries.size(); idx--)
                 {
                     if (entry.entries[idx].capture_id == cmp_capture_id)
                     {
                         cpu_ms += entry.entries[idx].entry.cpu_delta_time * 1000.0f;
                         gpu_ms += entry.entries[idx].entry.gpu_delta_time * 1000.0f;
+                        barrier_count += entry.entries[idx].entry.barrier_count;
                     }
                 }
                 if (cpu_ms == 0.f && gpu_ms == 0.f)
@@ -312,6 +488,7 @@ void Profiler::render_profiler_table(pnanovdb_uint64_t capture_id,
 
                 total_cpu_time += cpu_ms;
                 total_gpu_time += gpu_ms;
+                total_barrier_count += barrier_count;
 
                 ImGui::TableNextRow();
                 ImGui::TableNextColumn();
@@ -320,6 +497,8 @@ void Profiler::render_profiler_table(pnanovdb_uint64_t capture_id,
                 ImGui::Text("%.3f", cpu_ms);
                 ImGui::TableNextColumn();
                 ImGui::Text("%.3f", gpu_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", barrier_count);
             }
 
             if (!show_avg) // summing up average is misleading
@@ -331,6 +510,8 @@ void Profiler::render_profiler_table(pnanovdb_uint64_t capture_id,
                 ImGui::Text("%.3f", total_cpu_time);
                 ImGui::TableNextColumn();
                 ImGui::Text("%.3f", total_gpu_time);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", total_barrier_count);
             }
 
             global_total_cpu_time += total_cpu_time;
@@ -13,6 +13,8 @@
 
 #include "ImguiInstance.h"
 
+#include "nanovdb_editor/putil/Raster.h"
+
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -57,6 +59,12 @@ public:
         return &memory_stats_;
     }
 
+    pnanovdb_raster_gaussian_cull_stats_t* getGaussianCullStats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return &gaussian_cull_stats_;
+    }
+
     bool render(bool* update_memory_stats, float delta_time);
 
     static void report_callback(void* userdata,
@@ -84,6 +92,7 @@ private:
 
     pnanovdb_compute_device_memory_stats_t memory_stats_ = {};
     float memory_stats_timer_ = 0.f;
+    pnanovdb_raster_gaussian_cull_stats_t gaussian_cull_stats_ = {};
 
     std::atomic<bool> profiler_paused_ = true;
     bool show_averages_ = false;
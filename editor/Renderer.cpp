@@ -14,13 +14,23 @@
 #include "EditorSceneManager.h"
 #include "ImguiInstance.h"
 #include "Console.h"
+#include "PipelineRegistry.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace pnanovdb_editor
 {
+static const char* s_paged_shader_name = "editor/editor_paged.slang";
+
+// Frames between driver memory budget queries, evictions in between are accounted by the residency manager
+static const pnanovdb_uint64_t s_memory_budget_query_interval = 16u;
+
 void Renderer::init(const RendererConfig& config)
 {
     m_config = config;
     m_initialized = (config.compute != nullptr && config.device != nullptr && config.device_queue != nullptr);
+    m_residency.set_budget(config.gpu_memory_budget_in_bytes);
 
     // Initialize upload buffers
     pnanovdb_compute_interface_t* compute_interface =
@@ -61,19 +71,36 @@ void Renderer::cleanup()
             m_active_shader_name.clear();
         }
 
+        if (m_paged_shader_context)
+        {
+            m_config.compute->destroy_shader(
+                compute_interface, &m_config.compute->shader_interface, compute_context, m_paged_shader_context);
+            m_paged_shader_context = nullptr;
+        }
+        for (auto& pair : m_paged_nanovdbs)
+        {
+            if (pair.second)
+            {
+                m_config.compute->destroy_paged_nanovdb(m_config.compute, m_config.device_queue, pair.second);
+            }
+        }
+
         // Destroy upload buffers
         pnanovdb_compute_upload_buffer_destroy(compute_context, &m_compute_upload_buffer);
         pnanovdb_compute_upload_buffer_destroy(compute_context, &m_shader_params_upload_buffer);
 
-        // Destroy NanoVDB buffer
-        if (m_nanovdb_buffer)
+        // Destroy NanoVDB device copy
+        if (m_nanovdb_upload)
         {
-            compute_interface->destroy_buffer(compute_context, m_nanovdb_buffer);
-            m_nanovdb_buffer = nullptr;
+            m_config.compute->destroy_nanovdb_upload(m_config.compute, m_config.device_queue, m_nanovdb_upload);
+            m_nanovdb_upload = nullptr;
         }
     }
 
     m_uploaded_nanovdb_array = nullptr;
+    m_paged_nanovdbs.clear();
+    m_paged_replaced_shader_name.clear();
+    m_paged_shader_failed = false;
     m_initialized = false;
 }
 
@@ -85,9 +112,7 @@ bool Renderer::render_nanovdb(pnanovdb_compute_array_t* nanovdb_array,
                               uint32_t image_width,
                               uint32_t image_height,
                               pnanovdb_compute_buffer_transient_t* editor_params_buffer,
-                              pnanovdb_compute_buffer_transient_t* shader_params_buffer,
-                              pnanovdb_compute_buffer_t** nanovdb_buffer,
-                              pnanovdb_compute_array_t** uploaded_nanovdb_array)
+                              pnanovdb_compute_buffer_transient_t* shader_params_buffer)
 {
     if (!m_initialized || !nanovdb_array || !shader_context || !background_image)
     {
@@ -104,29 +129,141 @@ bool Renderer::render_nanovdb(pnanovdb_compute_array_t* nanovdb_array,
         return false;
     }
 
-    // Check if we need to update the NanoVDB buffer
-    if (nanovdb_array != *uploaded_nanovdb_array && *nanovdb_buffer)
+    // Device buffer is reused across arrays, only ranges marked dirty are copied for the same array
+    if (!m_nanovdb_upload)
     {
-        compute_interface->destroy_buffer(compute_context, *nanovdb_buffer);
-        *nanovdb_buffer = nullptr;
+        m_nanovdb_upload = m_config.compute->create_nanovdb_upload(0u);
+    }
+    pnanovdb_compute_buffer_t* nanovdb_buffer = m_config.compute->update_nanovdb_upload(
+        m_config.compute, m_config.device_queue, m_nanovdb_upload, nanovdb_array);
+    if (!nanovdb_buffer)
+    {
+        m_uploaded_nanovdb_array = nullptr;
+        return false;
     }
+    m_uploaded_nanovdb_array = nanovdb_array;
 
     // Dispatch shader
     pnanovdb_compute_buffer_transient_t* readback_transient = nullptr;
     pnanovdb_bool_t dispatched = m_config.compute->dispatch_shader_on_nanovdb_array(
         m_config.compute, m_config.device, shader_context, nanovdb_array, image_width, image_height, background_image,
-        editor_params_buffer, shader_params_buffer, nanovdb_buffer, &readback_transient);
-    if (dispatched == PNANOVDB_FALSE)
+        editor_params_buffer, shader_params_buffer, &nanovdb_buffer, &readback_transient);
+
+    return dispatched != PNANOVDB_FALSE;
+}
+
+ShaderDispatchResult Renderer::render_paged_nanovdb(pnanovdb_compute_array_t* nanovdb_array,
+                                                    const char* filepath,
+                                                    pnanovdb_uint32_t grid_idx,
+                                                    const char* shader_name,
+                                                    pnanovdb_compute_texture_t* background_image,
+                                                    const pnanovdb_camera_mat_t& view,
+                                                    const pnanovdb_camera_mat_t& projection,
+                                                    uint32_t image_width,
+                                                    uint32_t image_height,
+                                                    pnanovdb_compute_buffer_transient_t* editor_params_buffer,
+                                                    imgui_instance_user::Instance* imgui_instance,
+                                                    EditorSceneManager* scene_manager)
+{
+    if (!m_paged_shader_context && !m_paged_shader_failed)
     {
-        return false;
+        std::lock_guard<std::mutex> lock(imgui_instance->compiler_settings_mutex);
+
+        m_paged_shader_context = m_config.compute->create_shader_context(s_paged_shader_name);
+        if (m_config.compute->init_shader(m_config.compute, m_config.device_queue, m_paged_shader_context,
+                                          &imgui_instance->compiler_settings) == PNANOVDB_FALSE)
+        {
+            Console::getInstance().addLog(
+                Console::LogLevel::Error, "Failed to compile paged NanoVDB shader '%s'", s_paged_shader_name);
+            m_config.compute->destroy_shader_context(m_config.compute, m_config.device_queue, m_paged_shader_context);
+            m_paged_shader_context = nullptr;
+            m_paged_shader_failed = true;
+        }
+        else if (scene_manager)
+        {
+            capture_shader_default_params(*scene_manager, m_config.compute, s_paged_shader_name,
+                                          sizeof(PagedShaderParams), &m_paged_shader_params);
+        }
+    }
+    if (!m_paged_shader_context)
+    {
+        return ShaderDispatchResult::Skipped;
     }
 
-    if (*nanovdb_buffer)
+    // the page table translation only exists in editor_paged.slang, other shaders cannot draw a paged grid
+    const char* default_shader_name = pnanovdb_pipeline_get_shader_name(pnanovdb_pipeline_type_nanovdb_render);
+    if (strcmp(shader_name, default_shader_name) != 0 && m_paged_replaced_shader_name != shader_name)
     {
-        *uploaded_nanovdb_array = nanovdb_array;
+        Console::getInstance().addLog(Console::LogLevel::Warning,
+                                      "Shader '%s' cannot draw grids above the residency budget, using '%s'",
+                                      shader_name, s_paged_shader_name);
+        m_paged_replaced_shader_name = shader_name;
     }
 
-    return true;
+    const PagedSourceKey key(nanovdb_array, filepath ? filepath : "", grid_idx);
+    auto paged_it = m_paged_nanovdbs.find(key);
+    if (paged_it == m_paged_nanovdbs.end())
+    {
+        pnanovdb_compute_paged_nanovdb_t* created = m_config.compute->create_paged_nanovdb(
+            filepath, grid_idx, nanovdb_array, m_config.residency_budget_in_bytes);
+        if (created)
+        {
+            pnanovdb_compute_paged_nanovdb_stats_t stats = {};
+            m_config.compute->get_paged_nanovdb_stats(created, &stats);
+            Console::getInstance().addLog("Paging NanoVDB leaves: %u pages of %llu bytes, pool holds %u pages",
+                                          stats.page_count, (unsigned long long)stats.page_size_in_bytes,
+                                          stats.pool_page_count);
+        }
+        // a failed source is remembered as null so it is not reopened every frame
+        paged_it = m_paged_nanovdbs.emplace(key, created).first;
+    }
+    pnanovdb_compute_paged_nanovdb_t* paged_nanovdb = paged_it->second;
+    if (!paged_nanovdb)
+    {
+        return ShaderDispatchResult::Skipped;
+    }
+    m_residency.mark_rendered(paged_nanovdb);
+
+    pnanovdb_compute_context_t* compute_context =
+        m_config.compute->device_interface.get_compute_context(m_config.device_queue);
+    PagedShaderParams* mapped = (PagedShaderParams*)pnanovdb_compute_upload_buffer_map(
+        compute_context, &m_shader_params_upload_buffer, sizeof(PagedShaderParams));
+    *mapped = m_paged_shader_params;
+    auto* shader_params_buffer = pnanovdb_compute_upload_buffer_unmap(compute_context, &m_shader_params_upload_buffer);
+
+    m_config.compute->prefetch_paged_nanovdb(
+        paged_nanovdb, &view, &projection, m_paged_shader_params.auto_center != 0u ? PNANOVDB_TRUE : PNANOVDB_FALSE);
+
+    pnanovdb_bool_t dispatched = m_config.compute->dispatch_shader_on_paged_nanovdb(
+        m_config.compute, m_config.device, m_paged_shader_context, paged_nanovdb, image_width, image_height,
+        background_image, editor_params_buffer, shader_params_buffer);
+
+    return dispatched != PNANOVDB_FALSE ? ShaderDispatchResult::Success : ShaderDispatchResult::Skipped;
+}
+
+pnanovdb_compute_buffer_transient_t* Renderer::upload_editor_params(pnanovdb_compute_context_t* compute_context,
+                                                                    const pnanovdb_camera_mat_t& view,
+                                                                    const pnanovdb_camera_mat_t& projection,
+                                                                    uint32_t image_width,
+                                                                    uint32_t image_height,
+                                                                    uint32_t composite)
+{
+    pnanovdb_camera_mat_t view_inv = pnanovdb_camera_mat_inverse(view);
+    pnanovdb_camera_mat_t projection_inv = pnanovdb_camera_mat_inverse(projection);
+
+    EditorParams editor_params = {};
+    editor_params.view_inv = pnanovdb_camera_mat_transpose(view_inv);
+    editor_params.projection_inv = pnanovdb_camera_mat_transpose(projection_inv);
+    editor_params.view = pnanovdb_camera_mat_transpose(view);
+    editor_params.projection = pnanovdb_camera_mat_transpose(projection);
+    editor_params.width = image_width;
+    editor_params.height = image_height;
+    editor_params.composite = composite;
+
+    EditorParams* mapped = (EditorParams*)pnanovdb_compute_upload_buffer_map(
+        compute_context, &m_compute_upload_buffer, sizeof(EditorParams));
+    *mapped = editor_params;
+    return pnanovdb_compute_upload_buffer_unmap(compute_context, &m_compute_upload_buffer);
 }
 
 bool Renderer::render_gaussian(pnanovdb_raster_gaussian_data_t* gaussian_data,
@@ -146,10 +283,162 @@ bool Renderer::render_gaussian(pnanovdb_raster_gaussian_data_t* gaussian_data,
     m_config.raster->raster_gaussian_2d(m_config.raster->compute, m_config.device_queue, m_config.raster_ctx,
                                         gaussian_data, background_image, image_width, image_height, &view, &projection,
                                         raster_params, composite);
+    m_residency.mark_rendered(gaussian_data);
 
     return true;
 }
 
+void Renderer::update_residency(EditorSceneManager* scene_manager)
+{
+    if (!m_initialized || !scene_manager)
+    {
+        return;
+    }
+
+    const bool can_evict_gaussians = m_config.raster && m_config.raster->evict_gaussian_data &&
+                                     m_config.raster->get_gaussian_data_resident_bytes;
+    if (can_evict_gaussians)
+    {
+        scene_manager->for_each_object(
+            [&](SceneObject* obj)
+            {
+                if (obj->gaussian_data())
+                {
+                    m_residency.track(
+                        obj->gaussian_data(), m_config.raster->get_gaussian_data_resident_bytes(obj->gaussian_data()));
+                }
+                return true;
+            });
+    }
+    if (m_nanovdb_upload && m_uploaded_nanovdb_array)
+    {
+        pnanovdb_compute_nanovdb_upload_stats_t upload_stats = {};
+        m_config.compute->get_nanovdb_upload_stats(m_nanovdb_upload, &upload_stats);
+        m_residency.track(m_uploaded_nanovdb_array, upload_stats.device_size_in_bytes);
+    }
+    for (auto it = m_paged_nanovdbs.begin(); it != m_paged_nanovdbs.end();)
+    {
+        // an array removed from the scene may be freed and its address reused by another array
+        const pnanovdb_compute_array_t* source_array = std::get<0>(it->first);
+        bool source_alive = !source_array;
+        if (source_array)
+        {
+            scene_manager->for_each_object(
+                [&](SceneObject* obj)
+                {
+                    source_alive = obj->nanovdb_array() == source_array || obj->converted_nanovdb() == source_array;
+                    return !source_alive;
+                });
+        }
+        if (!source_alive)
+        {
+            if (it->second)
+            {
+                m_config.compute->destroy_paged_nanovdb(m_config.compute, m_config.device_queue, it->second);
+            }
+            it = m_paged_nanovdbs.erase(it);
+            continue;
+        }
+        ++it;
+    }
+    for (auto& pair : m_paged_nanovdbs)
+    {
+        if (pair.second)
+        {
+            pnanovdb_compute_paged_nanovdb_stats_t stats = {};
+            m_config.compute->get_paged_nanovdb_stats(pair.second, &stats);
+            m_residency.track(pair.second, stats.skeleton_size_in_bytes +
+                                               pnanovdb_uint64_t(stats.pool_page_count) * stats.page_size_in_bytes);
+        }
+    }
+
+    if (m_residency.get_frame() % s_memory_budget_query_interval == 1u)
+    {
+        m_config.compute->device_interface.get_memory_stats(m_config.device, &m_memory_stats);
+    }
+
+    std::vector<const void*> evicted =
+        m_residency.end_frame(m_memory_stats.device_local_budget_bytes, m_memory_stats.device_local_usage_bytes);
+    if (evicted.empty())
+    {
+        return;
+    }
+
+    for (auto it = evicted.begin(); it != evicted.end(); ++it)
+    {
+        if (*it == m_uploaded_nanovdb_array)
+        {
+            m_config.compute->destroy_nanovdb_upload(m_config.compute, m_config.device_queue, m_nanovdb_upload);
+            m_nanovdb_upload = nullptr;
+            m_uploaded_nanovdb_array = nullptr;
+            Console::getInstance().addLog(Console::LogLevel::Debug, "Evicted NanoVDB buffer from device memory");
+            evicted.erase(it);
+            break;
+        }
+    }
+    for (auto it = m_paged_nanovdbs.begin(); it != m_paged_nanovdbs.end() && !evicted.empty();)
+    {
+        auto evicted_it = std::find(evicted.begin(), evicted.end(), it->second);
+        if (it->second && evicted_it != evicted.end())
+        {
+            // the next dispatch of this source reopens it with an empty pool
+            m_config.compute->destroy_paged_nanovdb(m_config.compute, m_config.device_queue, it->second);
+            Console::getInstance().addLog(Console::LogLevel::Debug, "Evicted paged NanoVDB pool from device memory");
+            evicted.erase(evicted_it);
+            it = m_paged_nanovdbs.erase(it);
+            continue;
+        }
+        ++it;
+    }
+    if (evicted.empty() || !can_evict_gaussians)
+    {
+        return;
+    }
+
+    scene_manager->for_each_object(
+        [&](SceneObject* obj)
+        {
+            pnanovdb_raster_gaussian_data_t* data = obj->gaussian_data();
+            if (data && std::find(evicted.begin(), evicted.end(), data) != evicted.end())
+            {
+                m_config.raster->evict_gaussian_data(m_config.raster->compute, m_config.device_queue, data);
+                Console::getInstance().addLog(Console::LogLevel::Debug, "Evicted '%s' from device memory",
+                                              obj->name_token ? obj->name_token->str : "");
+            }
+            return true;
+        });
+}
+
+ShaderDispatchResult Renderer::dispatch_paged_nanovdb_file(const char* filepath,
+                                                           pnanovdb_uint32_t grid_idx,
+                                                           const char* shader_name,
+                                                           pnanovdb_compute_texture_t* background_image,
+                                                           const pnanovdb_camera_mat_t& view,
+                                                           const pnanovdb_camera_mat_t& projection,
+                                                           uint32_t image_width,
+                                                           uint32_t image_height,
+                                                           imgui_instance_user::Instance* imgui_instance,
+                                                           EditorSceneManager* scene_manager,
+                                                           uint32_t composite)
+{
+    if (!m_initialized || !filepath || !background_image || !shader_name)
+    {
+        return ShaderDispatchResult::NoData;
+    }
+
+    pnanovdb_compute_context_t* compute_context =
+        m_config.compute->device_interface.get_compute_context(m_config.device_queue);
+    if (!compute_context)
+    {
+        return ShaderDispatchResult::NoData;
+    }
+
+    auto* upload_transient =
+        upload_editor_params(compute_context, view, projection, image_width, image_height, composite);
+    return render_paged_nanovdb(nullptr, filepath, grid_idx, shader_name, background_image, view, projection,
+                                image_width, image_height, upload_transient, imgui_instance, scene_manager);
+}
+
 ShaderDispatchResult Renderer::dispatch_nanovdb_shader(pnanovdb_compute_array_t* nanovdb_array,
                                                        const char* shader_name,
                                                        pnanovdb_compute_texture_t* background_image,
@@ -179,6 +468,15 @@ ShaderDispatchResult Renderer::dispatch_nanovdb_shader(pnanovdb_compute_array_t*
         return ShaderDispatchResult::NoData;
     }
 
+    // grids above the residency budget are paged, this does not depend on the object's shader
+    if (is_paged_nanovdb(nanovdb_array->element_count * nanovdb_array->element_size))
+    {
+        auto* upload_transient =
+            upload_editor_params(compute_context, view, projection, image_width, image_height, composite);
+        return render_paged_nanovdb(nanovdb_array, nullptr, 0u, shader_name, background_image, view, projection,
+                                    image_width, image_height, upload_transient, imgui_instance, scene_manager);
+    }
+
     // Handle shader updates/compilation, also (re)compile when the requested per-object shader changes
     const bool shader_changed = (m_active_shader_name != shader_name);
     const bool needs_shader_compile = imgui_instance->pending.update_shader || shader_changed || !m_shader_context;
@@ -232,24 +530,9 @@ ShaderDispatchResult Renderer::dispatch_nanovdb_shader(pnanovdb_compute_array_t*
         return ShaderDispatchResult::Skipped;
     }
 
-    // Setup editor/camera parameters
-    pnanovdb_camera_mat_t view_inv = pnanovdb_camera_mat_inverse(view);
-    pnanovdb_camera_mat_t projection_inv = pnanovdb_camera_mat_inverse(projection);
-
-    EditorParams editor_params = {};
-    editor_params.view_inv = pnanovdb_camera_mat_transpose(view_inv);
-    editor_params.projection_inv = pnanovdb_camera_mat_transpose(projection_inv);
-    editor_params.view = pnanovdb_camera_mat_transpose(view);
-    editor_params.projection = pnanovdb_camera_mat_transpose(projection);
-    editor_params.width = image_width;
-    editor_params.height = image_height;
-    editor_params.composite = composite;
-
     // Upload editor parameters
-    EditorParams* mapped = (EditorParams*)pnanovdb_compute_upload_buffer_map(
-        compute_context, &m_compute_upload_buffer, sizeof(EditorParams));
-    *mapped = editor_params;
-    auto* upload_transient = pnanovdb_compute_upload_buffer_unmap(compute_context, &m_compute_upload_buffer);
+    auto* upload_transient =
+        upload_editor_params(compute_context, view, projection, image_width, image_height, composite);
 
     // Upload shader parameters (per-object when compositing multiple visible NanoVDBs)
     void* shader_params_data = pnanovdb_compute_upload_buffer_map(
@@ -267,7 +550,11 @@ ShaderDispatchResult Renderer::dispatch_nanovdb_shader(pnanovdb_compute_array_t*
     // Render NanoVDB
     bool success =
         render_nanovdb(nanovdb_array, m_shader_context, background_image, view, projection, image_width, image_height,
-                       upload_transient, shader_upload_transient, &m_nanovdb_buffer, &m_uploaded_nanovdb_array);
+                       upload_transient, shader_upload_transient);
+    if (success)
+    {
+        m_residency.mark_rendered(nanovdb_array);
+    }
 
     return success ? ShaderDispatchResult::Success : ShaderDispatchResult::Skipped;
 }
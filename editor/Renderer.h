@@ -16,9 +16,12 @@
 #include "nanovdb_editor/putil/Raster.h"
 #include "nanovdb_editor/putil/Compute.h"
 #include "../imgui/UploadBuffer.h"
+#include "ResidencyManager.h"
 
 #include <string>
+#include <map>
 #include <mutex>
+#include <tuple>
 
 namespace imgui_instance_user
 {
@@ -52,6 +55,8 @@ struct RendererConfig
     pnanovdb_compute_queue_t* compute_queue = nullptr; // For NanoVDB rasterization
     pnanovdb_raster_t* raster = nullptr;
     pnanovdb_raster_context_t* raster_ctx = nullptr;
+    pnanovdb_uint64_t residency_budget_in_bytes = 0u; // NanoVDB arrays above this stream leaves on demand
+    pnanovdb_uint64_t gpu_memory_budget_in_bytes = 0u; // Evict unrendered objects above this, 0 uses driver budget
 };
 
 /*!
@@ -82,8 +87,6 @@ public:
         \param image_height Viewport height
         \param editor_params_buffer Constant buffer with camera parameters
         \param shader_params_buffer Constant buffer with shader parameters
-        \param nanovdb_buffer Cached NanoVDB buffer (in/out)
-        \param uploaded_nanovdb_array Track which array is uploaded (in/out)
         \return true if rendering succeeded
     */
     bool render_nanovdb(pnanovdb_compute_array_t* nanovdb_array,
@@ -94,9 +97,7 @@ public:
                         uint32_t image_width,
                         uint32_t image_height,
                         pnanovdb_compute_buffer_transient_t* editor_params_buffer,
-                        pnanovdb_compute_buffer_transient_t* shader_params_buffer,
-                        pnanovdb_compute_buffer_t** nanovdb_buffer,
-                        pnanovdb_compute_array_t** uploaded_nanovdb_array);
+                        pnanovdb_compute_buffer_transient_t* shader_params_buffer);
 
     /*!
         \brief Render Gaussian splatting data
@@ -119,6 +120,16 @@ public:
                          const pnanovdb_raster_shader_params_t* raster_params,
                          uint32_t composite = 0);
 
+    /*!
+        \brief Evict device copies of scene objects that were not rendered this frame when over budget
+
+        Called once per frame after rendering. Evicted gaussian data keeps its host arrays and is uploaded
+        again by the next raster call, the shared NanoVDB buffer is uploaded again by the next dispatch.
+
+        \param scene_manager Scene manager holding the objects to track
+    */
+    void update_residency(EditorSceneManager* scene_manager);
+
     /*!
         \brief Check if renderer is initialized
 
@@ -171,7 +182,68 @@ public:
                                                  pnanovdb_editor_token_t* params_scene_token = nullptr,
                                                  pnanovdb_editor_token_t* params_name_token = nullptr);
 
+    /*!
+        \brief Check if a NanoVDB grid is paged instead of uploaded whole
+
+        \param grid_size_in_bytes Uncompressed size of the grid
+        \return true if the grid exceeds the residency budget
+    */
+    bool is_paged_nanovdb(pnanovdb_uint64_t grid_size_in_bytes) const
+    {
+        return m_config.residency_budget_in_bytes > 0u && grid_size_in_bytes > m_config.residency_budget_in_bytes;
+    }
+
+    /*!
+        \brief Dispatch paged NanoVDB rendering straight from a file
+
+        The grid is memory mapped and never loaded whole, leaves are copied from the mapping as views need them.
+
+        \param filepath File holding the grid, the grid must be uncompressed
+        \param grid_idx Index of the grid across all segments of the file
+        \param shader_name Shader of the object, paged grids are always drawn with editor_paged.slang
+        \return Result of shader dispatch operation
+    */
+    ShaderDispatchResult dispatch_paged_nanovdb_file(const char* filepath,
+                                                     pnanovdb_uint32_t grid_idx,
+                                                     const char* shader_name,
+                                                     pnanovdb_compute_texture_t* background_image,
+                                                     const pnanovdb_camera_mat_t& view,
+                                                     const pnanovdb_camera_mat_t& projection,
+                                                     uint32_t image_width,
+                                                     uint32_t image_height,
+                                                     imgui_instance_user::Instance* imgui_instance,
+                                                     EditorSceneManager* scene_manager,
+                                                     uint32_t composite = 0);
+
 private:
+    /*!
+        \brief Render a NanoVDB volume that does not fit the residency budget
+
+        Leaves are streamed into a fixed size page pool from nanovdb_array if set, else from a mapping of filepath.
+        The grid is drawn with editor_paged.slang and its own params.
+
+        \return Result of shader dispatch operation
+    */
+    ShaderDispatchResult render_paged_nanovdb(pnanovdb_compute_array_t* nanovdb_array,
+                                              const char* filepath,
+                                              pnanovdb_uint32_t grid_idx,
+                                              const char* shader_name,
+                                              pnanovdb_compute_texture_t* background_image,
+                                              const pnanovdb_camera_mat_t& view,
+                                              const pnanovdb_camera_mat_t& projection,
+                                              uint32_t image_width,
+                                              uint32_t image_height,
+                                              pnanovdb_compute_buffer_transient_t* editor_params_buffer,
+                                              imgui_instance_user::Instance* imgui_instance,
+                                              EditorSceneManager* scene_manager);
+
+    pnanovdb_compute_buffer_transient_t* upload_editor_params(pnanovdb_compute_context_t* compute_context,
+                                                              const pnanovdb_camera_mat_t& view,
+                                                              const pnanovdb_camera_mat_t& projection,
+                                                              uint32_t image_width,
+                                                              uint32_t image_height,
+                                                              uint32_t composite);
+
     // Internal structure for camera/editor parameters (mirrored from shader)
     struct EditorParams
     {
@@ -185,17 +257,41 @@ private:
         uint32_t pad2;
     };
 
+    // Mirrors shader_params_t in editor_paged.slang, defaults match editor_paged.slang.json
+    struct PagedShaderParams
+    {
+        float alpha_scale = 0.1f;
+        uint32_t narrow_band_only = 1u;
+        uint32_t highlight_bbox = 0u;
+        float slice_plane_thickness = 0.f;
+        float slice_plane[4] = { 1.f, 0.f, 0.f, 0.f };
+        uint32_t auto_center = 1u;
+    };
+
     bool m_initialized = false;
     RendererConfig m_config;
 
     // Shader state
     pnanovdb_shader_context_t* m_shader_context = nullptr;
     std::string m_active_shader_name;
-    pnanovdb_compute_buffer_t* m_nanovdb_buffer = nullptr;
+    pnanovdb_compute_nanovdb_upload_t* m_nanovdb_upload = nullptr;
     pnanovdb_compute_array_t* m_uploaded_nanovdb_array = nullptr;
     pnanovdb_compute_upload_buffer_t m_compute_upload_buffer;
     pnanovdb_compute_upload_buffer_t m_shader_params_upload_buffer;
     bool m_dispatch_shader = true;
+
+    // Paged rendering state for arrays above the residency budget
+    pnanovdb_shader_context_t* m_paged_shader_context = nullptr;
+    // one entry per paged source so several visible grids keep their pools, keyed by array, filepath and grid
+    using PagedSourceKey = std::tuple<const pnanovdb_compute_array_t*, std::string, pnanovdb_uint32_t>;
+    std::map<PagedSourceKey, pnanovdb_compute_paged_nanovdb_t*> m_paged_nanovdbs;
+    PagedShaderParams m_paged_shader_params;
+    std::string m_paged_replaced_shader_name;
+    bool m_paged_shader_failed = false;
+
+    // Device residency of scene objects, keyed by gaussian data, the uploaded NanoVDB array or the paged state
+    ResidencyManager m_residency;
+    pnanovdb_compute_device_memory_stats_t m_memory_stats = {};
 };
 
 } // namespace pnanovdb_editor
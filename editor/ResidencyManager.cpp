@@ -0,0 +1,120 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   editor/ResidencyManager.cpp
+
+    \author Petra Hapalova
+
+    \brief  Implementation of ResidencyManager class
+*/
+
+#include "ResidencyManager.h"
+
+#include <algorithm>
+
+namespace pnanovdb_editor
+{
+
+void ResidencyManager::mark_rendered(const void* key)
+{
+    if (!key)
+    {
+        return;
+    }
+    Entry& entry = m_entries[key];
+    entry.last_rendered_frame = m_frame;
+    entry.last_tracked_frame = m_frame;
+}
+
+void ResidencyManager::track(const void* key, pnanovdb_uint64_t resident_bytes)
+{
+    if (!key)
+    {
+        return;
+    }
+    Entry& entry = m_entries[key];
+    entry.resident_bytes = resident_bytes;
+    entry.last_tracked_frame = m_frame;
+}
+
+std::vector<const void*> ResidencyManager::end_frame(pnanovdb_uint64_t driver_budget_bytes,
+                                                     pnanovdb_uint64_t driver_usage_bytes)
+{
+    std::vector<const void*> evicted;
+
+    // objects removed from the scene are no longer reported
+    m_tracked_bytes = 0u;
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.last_tracked_frame != m_frame)
+        {
+            it = m_entries.erase(it);
+            continue;
+        }
+        m_tracked_bytes += it->second.resident_bytes;
+        ++it;
+    }
+
+    pnanovdb_uint64_t excess_bytes = 0u;
+    if (m_budget_in_bytes > 0u && m_tracked_bytes > m_budget_in_bytes)
+    {
+        excess_bytes = m_tracked_bytes - m_budget_in_bytes;
+    }
+    // evicted buffers are freed after the resource min lifetime, until then the driver still counts them
+    pnanovdb_uint64_t releasing_bytes = 0u;
+    for (auto it = m_releasing.begin(); it != m_releasing.end();)
+    {
+        if (m_frame - it->first > k_release_latency_frames)
+        {
+            it = m_releasing.erase(it);
+            continue;
+        }
+        releasing_bytes += it->second;
+        ++it;
+    }
+    driver_usage_bytes = driver_usage_bytes > releasing_bytes ? driver_usage_bytes - releasing_bytes : 0u;
+
+    if (driver_budget_bytes > 0u)
+    {
+        pnanovdb_uint64_t driver_limit = pnanovdb_uint64_t(double(driver_budget_bytes) * k_driver_budget_headroom);
+        if (driver_usage_bytes > driver_limit)
+        {
+            excess_bytes = std::max(excess_bytes, driver_usage_bytes - driver_limit);
+        }
+    }
+
+    if (excess_bytes > 0u)
+    {
+        std::vector<std::pair<const void*, Entry*>> candidates;
+        for (auto& pair : m_entries)
+        {
+            if (pair.second.resident_bytes > 0u && pair.second.last_rendered_frame != m_frame)
+            {
+                candidates.push_back({ pair.first, &pair.second });
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const std::pair<const void*, Entry*>& a, const std::pair<const void*, Entry*>& b)
+                  { return a.second->last_rendered_frame < b.second->last_rendered_frame; });
+
+        pnanovdb_uint64_t freed_bytes = 0u;
+        for (auto& candidate : candidates)
+        {
+            if (freed_bytes >= excess_bytes)
+            {
+                break;
+            }
+            freed_bytes += candidate.second->resident_bytes;
+            m_tracked_bytes -= candidate.second->resident_bytes;
+            candidate.second->resident_bytes = 0u;
+            evicted.push_back(candidate.first);
+        }
+        m_releasing.push_back({ m_frame, freed_bytes });
+    }
+
+    m_frame++;
+    return evicted;
+}
+
+} // namespace pnanovdb_editor
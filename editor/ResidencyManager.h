@@ -0,0 +1,87 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   editor/ResidencyManager.h
+
+    \author Petra Hapalova
+
+    \brief  Tracks device bytes per scene object and picks least recently rendered objects to evict
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Compute.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pnanovdb_editor
+{
+
+class ResidencyManager
+{
+public:
+    // Driver reported usage above this share of the driver budget triggers eviction
+    static constexpr double k_driver_budget_headroom = 0.9;
+
+    // Frames until an evicted buffer is released, covers the default resource min lifetime
+    static constexpr pnanovdb_uint64_t k_release_latency_frames = 64u;
+
+    // 0 disables the configured limit, the driver budget still applies when reported
+    void set_budget(pnanovdb_uint64_t budget_in_bytes)
+    {
+        m_budget_in_bytes = budget_in_bytes;
+    }
+
+    pnanovdb_uint64_t get_budget() const
+    {
+        return m_budget_in_bytes;
+    }
+
+    // The object was drawn in the current frame and must stay resident
+    void mark_rendered(const void* key);
+
+    // Reports the device bytes currently held by an object, objects not reported in a frame are forgotten
+    void track(const void* key, pnanovdb_uint64_t resident_bytes);
+
+    /*!
+        \brief Select objects to evict and advance to the next frame
+
+        Only objects not rendered in the current frame are candidates, least recently rendered first.
+        Selected objects are recorded as evicted, the caller frees their device copies.
+
+        \param driver_budget_bytes Device local budget from VK_EXT_memory_budget, 0 when unknown
+        \param driver_usage_bytes Device local usage from VK_EXT_memory_budget
+        \return Keys to evict
+    */
+    std::vector<const void*> end_frame(pnanovdb_uint64_t driver_budget_bytes = 0u,
+                                       pnanovdb_uint64_t driver_usage_bytes = 0u);
+
+    pnanovdb_uint64_t get_tracked_bytes() const
+    {
+        return m_tracked_bytes;
+    }
+
+    pnanovdb_uint64_t get_frame() const
+    {
+        return m_frame;
+    }
+
+private:
+    struct Entry
+    {
+        pnanovdb_uint64_t resident_bytes = 0u;
+        pnanovdb_uint64_t last_rendered_frame = 0u;
+        pnanovdb_uint64_t last_tracked_frame = 0u;
+    };
+
+    std::unordered_map<const void*, Entry> m_entries;
+    std::vector<std::pair<pnanovdb_uint64_t, pnanovdb_uint64_t>> m_releasing; // frame, evicted bytes
+    pnanovdb_uint64_t m_budget_in_bytes = 0u;
+    pnanovdb_uint64_t m_tracked_bytes = 0u;
+    pnanovdb_uint64_t m_frame = 1u;
+};
+
+} // namespace pnanovdb_editor
@@ -0,0 +1,104 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/CoherentSort.h"
+
+#include <math.h>
+#include <vector>
+
+using pnanovdb_raster::camera_delta_t;
+
+// row vector view of a camera at pos rotated by angle around the y axis
+static pnanovdb_camera_mat_t make_view(float angle, float pos_x, float pos_y, float pos_z)
+{
+    float c = cosf(angle);
+    float s = sinf(angle);
+    pnanovdb_camera_mat_t view = {};
+    view.x = { c, 0.f, -s, 0.f };
+    view.y = { 0.f, 1.f, 0.f, 0.f };
+    view.z = { s, 0.f, c, 0.f };
+    view.w.x = -(pos_x * view.x.x + pos_y * view.y.x + pos_z * view.z.x);
+    view.w.y = -(pos_x * view.x.y + pos_y * view.y.y + pos_z * view.z.y);
+    view.w.z = -(pos_x * view.x.z + pos_y * view.y.z + pos_z * view.z.z);
+    view.w.w = 1.f;
+    return view;
+}
+
+TEST(NanoVDBEditor, CoherentSortCameraDelta)
+{
+    const pnanovdb_vec3_t center = { 0.f, 0.f, 10.f };
+    pnanovdb_camera_mat_t view = make_view(0.3f, 1.f, 2.f, 3.f);
+
+    pnanovdb_vec3_t pos = pnanovdb_raster::view_camera_position(view);
+    EXPECT_NEAR(pos.x, 1.f, 1e-5f);
+    EXPECT_NEAR(pos.y, 2.f, 1e-5f);
+    EXPECT_NEAR(pos.z, 3.f, 1e-5f);
+
+    camera_delta_t delta = pnanovdb_raster::compute_camera_delta(make_view(0.f, 0.f, 0.f, 0.f),
+                                                                 make_view(0.01f, 0.f, 0.f, 0.1f), center);
+    EXPECT_NEAR(delta.angle, 0.01f, 1e-3f);
+    EXPECT_NEAR(delta.translation, 0.01f, 1e-5f);
+}
+
+TEST(NanoVDBEditor, CoherentSortModeSelection)
+{
+    const camera_delta_t still = { 0.f, 0.f };
+    const camera_delta_t turn = { 0.5f, 0.f };
+    const camera_delta_t dolly = { 0.f, 0.5f };
+
+    EXPECT_TRUE(pnanovdb_raster::use_coherent_sort(PNANOVDB_RASTER_TILE_SORT_AUTO, true, still));
+    EXPECT_FALSE(pnanovdb_raster::use_coherent_sort(PNANOVDB_RASTER_TILE_SORT_AUTO, false, still));
+    EXPECT_FALSE(pnanovdb_raster::use_coherent_sort(PNANOVDB_RASTER_TILE_SORT_AUTO, true, turn));
+    EXPECT_FALSE(pnanovdb_raster::use_coherent_sort(PNANOVDB_RASTER_TILE_SORT_AUTO, true, dolly));
+    EXPECT_FALSE(pnanovdb_raster::use_coherent_sort(PNANOVDB_RASTER_TILE_SORT_FULL, true, still));
+    EXPECT_TRUE(pnanovdb_raster::use_coherent_sort(PNANOVDB_RASTER_TILE_SORT_COHERENT, false, turn));
+}
+
+TEST(NanoVDBEditor, CoherentSortFixupNearlySorted)
+{
+    // sorted keys with swaps shorter than the window, including across window boundaries
+    const pnanovdb_uint32_t count = 4000u;
+    std::vector<pnanovdb_uint32_t> keys(count);
+    std::vector<pnanovdb_uint32_t> vals(count);
+    for (pnanovdb_uint32_t idx = 0u; idx < count; idx++)
+    {
+        keys[idx] = 2u * idx;
+        vals[idx] = idx;
+    }
+    for (pnanovdb_uint32_t idx = 0u; idx + 100u < count; idx += 97u)
+    {
+        std::swap(keys[idx], keys[idx + 100u]);
+        std::swap(vals[idx], vals[idx + 100u]);
+    }
+    EXPECT_NE(pnanovdb_raster::count_sort_inversions(keys.data(), count), 0u);
+
+    pnanovdb_raster::coherent_sort_fixup(
+        keys.data(), vals.data(), count, pnanovdb_raster::k_coherent_sort_fixup_passes);
+
+    EXPECT_EQ(pnanovdb_raster::count_sort_inversions(keys.data(), count), 0u);
+    for (pnanovdb_uint32_t idx = 0u; idx < count; idx++)
+    {
+        EXPECT_EQ(keys[idx], 2u * vals[idx]);
+    }
+}
+
+TEST(NanoVDBEditor, CoherentSortFixupLeavesLargeMoves)
+{
+    // the last key belongs in front, further than the passes reach
+    const pnanovdb_uint32_t count = 8u * pnanovdb_raster::k_coherent_sort_window;
+    std::vector<pnanovdb_uint32_t> keys(count);
+    std::vector<pnanovdb_uint32_t> vals(count);
+    for (pnanovdb_uint32_t idx = 0u; idx < count; idx++)
+    {
+        keys[idx] = idx + 1u;
+        vals[idx] = idx;
+    }
+    keys[count - 1u] = 0u;
+
+    pnanovdb_raster::coherent_sort_fixup(
+        keys.data(), vals.data(), count, pnanovdb_raster::k_coherent_sort_fixup_passes);
+
+    EXPECT_EQ(pnanovdb_raster::count_sort_inversions(keys.data(), count), 1u);
+}
@@ -144,3 +144,83 @@ TEST(NanoVDBEditor, ComputeDispatchShaderAddsNumbers)
     pnanovdb_compiler_free(&compiler);
     pnanovdb_compute_free(&compute);
 }
+
+TEST(NanoVDBEditor, ComputeDispatchShaderAsyncReadback)
+{
+    const std::filesystem::path shader = std::filesystem::path(__FILE__).parent_path() / "shaders" / "test.slang";
+    const std::string shader_path = shader.string();
+
+    pnanovdb_compiler_t compiler = {};
+    pnanovdb_compiler_load(&compiler);
+    ASSERT_NE(compiler.module, nullptr) << "Compiler module not available";
+
+    pnanovdb_compute_t compute = {};
+    pnanovdb_compute_load(&compute, &compiler);
+    ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+
+    pnanovdb_compute_device_desc_t device_desc = {};
+    device_desc.log_print = test_log_print;
+
+    pnanovdb_compute_device_manager_t* device_manager = compute.device_interface.create_device_manager(PNANOVDB_FALSE);
+    ASSERT_NE(device_manager, nullptr);
+
+    pnanovdb_compute_physical_device_desc_t phys_desc = {};
+    if (!compute.device_interface.enumerate_devices(device_manager, 0u, &phys_desc))
+    {
+        GTEST_SKIP() << "No Vulkan-compatible device available on this machine";
+    }
+
+    pnanovdb_compute_device_t* device = compute.device_interface.create_device(device_manager, &device_desc);
+    ASSERT_NE(device, nullptr);
+    pnanovdb_compute_queue_t* queue = compute.device_interface.get_device_queue(device);
+
+    constants_t params = { 4 };
+    std::vector<int> input = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    const pnanovdb_uint64_t count = static_cast<pnanovdb_uint64_t>(input.size());
+
+    pnanovdb_compute_array_t* data_in = compute.create_array(sizeof(int), count, input.data());
+    pnanovdb_compute_array_t* constants = compute.create_array(sizeof(constants_t), 1u, &params);
+    pnanovdb_compute_array_t* data_out = compute.create_array(sizeof(int), count, nullptr);
+
+    // two dispatches in flight before the first result is read
+    pnanovdb_compute_readback_queue_t* readback_queue = compute.create_readback_queue(2u);
+    pnanovdb_uint64_t tickets[2] = {};
+    for (pnanovdb_uint64_t& ticket : tickets)
+    {
+        ticket = compute.dispatch_shader_on_array_async(&compute, device, shader_path.c_str(), 8u, 1u, 1u, data_in,
+                                                        constants, data_out, 1u, 0llu, 0llu, readback_queue);
+        ASSERT_NE(ticket, 0u);
+    }
+    EXPECT_EQ(compute.dispatch_shader_on_array_async(&compute, device, shader_path.c_str(), 8u, 1u, 1u, data_in,
+                                                     constants, data_out, 1u, 0llu, 0llu, readback_queue),
+              0u);
+
+    compute.device_interface.wait_idle(queue);
+    for (pnanovdb_uint64_t expected_ticket : tickets)
+    {
+        pnanovdb_uint64_t ticket = 0u;
+        pnanovdb_uint64_t num_bytes = 0u;
+        const int* mapped = static_cast<const int*>(
+            compute.map_readback(&compute, queue, readback_queue, &ticket, &num_bytes));
+        ASSERT_NE(mapped, nullptr);
+        EXPECT_EQ(ticket, expected_ticket);
+        ASSERT_EQ(num_bytes, count * sizeof(int));
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            EXPECT_EQ(mapped[i], input[i] + params.magic_number);
+        }
+        compute.unmap_readback(&compute, queue, readback_queue);
+    }
+    EXPECT_EQ(compute.map_readback(&compute, queue, readback_queue, nullptr, nullptr), nullptr);
+
+    compute.destroy_readback_queue(&compute, queue, readback_queue);
+    compute.destroy_array(data_in);
+    compute.destroy_array(constants);
+    compute.destroy_array(data_out);
+
+    compute.device_interface.destroy_device(device_manager, device);
+    compute.device_interface.destroy_device_manager(device_manager);
+
+    pnanovdb_compiler_free(&compiler);
+    pnanovdb_compute_free(&compute);
+}
@@ -0,0 +1,313 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/CpuParallelPrimitives.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using pnanovdb_util::WorkStealingPool;
+
+// block boundaries of one and several threads, and a count with many blocks per thread
+static const pnanovdb_uint64_t k_counts[] = { 0u, 1u, 4095u, 4096u, 4097u, 300001u };
+static const size_t k_thread_counts[] = { 1u, 3u, 8u };
+
+// stable sort of the indices by the masked key
+template <typename key_t>
+static std::vector<pnanovdb_uint32_t> reference_order(const std::vector<key_t>& keys, pnanovdb_uint64_t key_mask)
+{
+    std::vector<pnanovdb_uint32_t> order(keys.size());
+    for (size_t idx = 0u; idx < keys.size(); idx++)
+    {
+        order[idx] = pnanovdb_uint32_t(idx);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](pnanovdb_uint32_t a, pnanovdb_uint32_t b)
+                     { return (keys[a] & key_mask) < (keys[b] & key_mask); });
+    return order;
+}
+
+static std::vector<pnanovdb_uint32_t> random_head_flags(std::mt19937& rng, size_t count, pnanovdb_uint32_t max_length)
+{
+    std::vector<pnanovdb_uint32_t> flags(count, 0u);
+    for (size_t idx = 0u; idx < count; idx += 1u + rng() % max_length)
+    {
+        flags[idx] = 1u;
+    }
+    return flags;
+}
+
+TEST(NanoVDBEditor, CpuScanMatchesSerial)
+{
+    std::mt19937 rng(31u);
+    for (size_t thread_count : k_thread_counts)
+    {
+        WorkStealingPool pool(thread_count);
+        for (pnanovdb_uint64_t count : k_counts)
+        {
+            std::vector<pnanovdb_uint32_t> vals(count);
+            std::vector<pnanovdb_uint64_t> vals64(count);
+            for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+            {
+                vals[idx] = rng();
+                vals64[idx] = (pnanovdb_uint64_t(rng()) << 32u) | rng();
+            }
+
+            // sums wrap as on the device
+            std::vector<pnanovdb_uint32_t> expected(count);
+            std::vector<pnanovdb_uint32_t> expected_max(count);
+            std::vector<pnanovdb_uint64_t> expected64(count);
+            pnanovdb_uint32_t sum = 0u;
+            pnanovdb_uint32_t max = 0u;
+            pnanovdb_uint64_t sum64 = 0u;
+            for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+            {
+                sum += vals[idx];
+                max = std::max(max, vals[idx]);
+                sum64 += vals64[idx];
+                expected[idx] = sum;
+                expected_max[idx] = max;
+                expected64[idx] = sum64;
+            }
+
+            std::vector<pnanovdb_uint32_t> scan(count);
+            pnanovdb_raster::cpu_global_scan(pool, vals.data(), scan.data(), count);
+            EXPECT_EQ(scan, expected) << count << " values, " << thread_count << " threads";
+
+            pnanovdb_raster::cpu_global_scan_max(pool, vals.data(), scan.data(), count);
+            EXPECT_EQ(scan, expected_max) << count << " values, " << thread_count << " threads";
+
+            // in place
+            pnanovdb_raster::cpu_global_scan_uint64(pool, vals64.data(), vals64.data(), count);
+            EXPECT_EQ(vals64, expected64) << count << " values, " << thread_count << " threads";
+        }
+    }
+}
+
+TEST(NanoVDBEditor, CpuRadixSortMatchesStableSort)
+{
+    std::mt19937 rng(37u);
+    for (size_t thread_count : k_thread_counts)
+    {
+        WorkStealingPool pool(thread_count);
+        for (pnanovdb_uint64_t count : k_counts)
+        {
+            // full keys, bits above key_bit_count kept in the output, and a single varying digit
+            for (pnanovdb_uint32_t variant = 0u; variant < 3u; variant++)
+            {
+                const pnanovdb_uint32_t key_bit_count = variant == 1u ? 12u : 32u;
+                std::vector<pnanovdb_uint32_t> keys(count);
+                std::vector<pnanovdb_uint32_t> vals(count);
+                for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+                {
+                    keys[idx] = variant == 2u ? (0xAB120000u | (rng() & 0xFF00u)) : rng();
+                    vals[idx] = pnanovdb_uint32_t(idx);
+                }
+                std::vector<pnanovdb_uint32_t> order =
+                    reference_order(keys, pnanovdb_raster::cpu_key_mask(key_bit_count));
+                std::vector<pnanovdb_uint32_t> expected_keys(count);
+                for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+                {
+                    expected_keys[idx] = keys[order[idx]];
+                }
+
+                pnanovdb_raster::cpu_radix_sort(pool, keys.data(), vals.data(), count, key_bit_count);
+                EXPECT_EQ(keys, expected_keys) << count << " keys, variant " << variant;
+                EXPECT_EQ(vals, order) << count << " keys, variant " << variant;
+            }
+        }
+    }
+}
+
+TEST(NanoVDBEditor, CpuRadixSortKey64AndDualKey)
+{
+    std::mt19937_64 rng(41u);
+    WorkStealingPool pool(4u);
+    for (pnanovdb_uint64_t count : k_counts)
+    {
+        for (pnanovdb_uint32_t key_bit_count : { 64u, 40u })
+        {
+            std::vector<pnanovdb_uint64_t> keys(count);
+            std::vector<pnanovdb_uint32_t> vals(count);
+            for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+            {
+                keys[idx] = rng();
+                vals[idx] = pnanovdb_uint32_t(idx);
+            }
+            std::vector<pnanovdb_uint32_t> order = reference_order(keys, pnanovdb_raster::cpu_key_mask(key_bit_count));
+
+            pnanovdb_raster::cpu_radix_sort(pool, keys.data(), vals.data(), count, key_bit_count);
+            EXPECT_EQ(vals, order) << count << " keys, " << key_bit_count << " bits";
+        }
+
+        // the high key decides first, the low key breaks ties, masked bits are ignored
+        std::vector<pnanovdb_uint32_t> key_low(count);
+        std::vector<pnanovdb_uint32_t> key_high(count);
+        std::vector<pnanovdb_uint32_t> vals(count);
+        std::vector<pnanovdb_uint64_t> combined(count);
+        for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+        {
+            key_low[idx] = pnanovdb_uint32_t(rng());
+            key_high[idx] = pnanovdb_uint32_t(rng());
+            vals[idx] = pnanovdb_uint32_t(idx);
+            combined[idx] = (pnanovdb_uint64_t(key_high[idx] & 0x7u) << 32u) | (key_low[idx] & 0xFFFFFu);
+        }
+        std::vector<pnanovdb_uint32_t> order = reference_order(combined, ~0llu);
+        std::vector<pnanovdb_uint32_t> expected_low(count);
+        for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+        {
+            expected_low[idx] = key_low[order[idx]];
+        }
+
+        pnanovdb_raster::cpu_radix_sort_dual_key(pool, key_low.data(), key_high.data(), vals.data(), count, 20u, 3u);
+        EXPECT_EQ(vals, order) << count << " keys";
+        EXPECT_EQ(key_low, expected_low) << count << " keys";
+    }
+}
+
+TEST(NanoVDBEditor, CpuSegmentedPrimitivesMatchSerial)
+{
+    std::mt19937 rng(43u);
+    for (size_t thread_count : k_thread_counts)
+    {
+        WorkStealingPool pool(thread_count);
+        for (pnanovdb_uint64_t count : k_counts)
+        {
+            // segments shorter and longer than a block
+            for (pnanovdb_uint32_t max_length : { 5u, 20000u })
+            {
+                std::vector<pnanovdb_uint32_t> vals(count);
+                for (pnanovdb_uint32_t& val : vals)
+                {
+                    val = rng();
+                }
+                std::vector<pnanovdb_uint32_t> flags = random_head_flags(rng, count, max_length);
+
+                std::vector<pnanovdb_uint32_t> expected(count);
+                pnanovdb_uint32_t sum = 0u;
+                for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+                {
+                    sum = flags[idx] != 0u ? vals[idx] : sum + vals[idx];
+                    expected[idx] = sum;
+                }
+                std::vector<pnanovdb_uint32_t> scan(count);
+                pnanovdb_raster::cpu_segmented_scan(pool, vals.data(), flags.data(), scan.data(), count);
+                EXPECT_EQ(scan, expected) << count << " values, segments up to " << max_length;
+
+                // each segment sorted on its own by the low 8 bits
+                std::vector<pnanovdb_uint32_t> keys = vals;
+                std::vector<pnanovdb_uint32_t> expected_keys = vals;
+                for (pnanovdb_uint64_t begin = 0u; begin < count;)
+                {
+                    pnanovdb_uint64_t end = begin + 1u;
+                    while (end < count && flags[end] == 0u)
+                    {
+                        end++;
+                    }
+                    std::stable_sort(expected_keys.begin() + begin, expected_keys.begin() + end,
+                                     [](pnanovdb_uint32_t a, pnanovdb_uint32_t b)
+                                     { return (a & 0xFFu) < (b & 0xFFu); });
+                    begin = end;
+                }
+                std::vector<pnanovdb_uint32_t> order(count);
+                pnanovdb_raster::cpu_segmented_radix_sort(pool, keys.data(), order.data(), flags.data(), count, 8u);
+                EXPECT_EQ(keys, expected_keys) << count << " keys, segments up to " << max_length;
+            }
+        }
+    }
+}
+
+TEST(NanoVDBEditor, CpuSelectAndPartitionMatchSerial)
+{
+    std::mt19937 rng(47u);
+    for (size_t thread_count : k_thread_counts)
+    {
+        WorkStealingPool pool(thread_count);
+        for (pnanovdb_uint64_t count : k_counts)
+        {
+            std::vector<pnanovdb_uint32_t> vals(count);
+            std::vector<pnanovdb_uint32_t> flags(count);
+            std::vector<pnanovdb_uint32_t> selected;
+            std::vector<pnanovdb_uint32_t> rejected;
+            for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+            {
+                vals[idx] = rng();
+                flags[idx] = (rng() % 3u == 0u) ? (rng() | 1u) : 0u;
+                (flags[idx] != 0u ? selected : rejected).push_back(vals[idx]);
+            }
+
+            // select_if leaves the tail alone
+            std::vector<pnanovdb_uint32_t> out(count, 7u);
+            std::vector<pnanovdb_uint32_t> expected = selected;
+            expected.resize(count, 7u);
+            EXPECT_EQ(pnanovdb_raster::cpu_select(pool, vals.data(), flags.data(), out.data(), count, false),
+                      selected.size());
+            EXPECT_EQ(out, expected) << count << " values, " << thread_count << " threads";
+
+            expected = selected;
+            expected.insert(expected.end(), rejected.begin(), rejected.end());
+            EXPECT_EQ(pnanovdb_raster::cpu_select(pool, vals.data(), flags.data(), out.data(), count, true),
+                      selected.size());
+            EXPECT_EQ(out, expected) << count << " values, " << thread_count << " threads";
+        }
+    }
+}
+
+TEST(NanoVDBEditor, CpuRunLengthEncodeMatchesSerial)
+{
+    std::mt19937_64 rng(53u);
+    for (size_t thread_count : k_thread_counts)
+    {
+        WorkStealingPool pool(thread_count);
+        for (pnanovdb_uint64_t count : k_counts)
+        {
+            // runs shorter and longer than a block
+            std::vector<pnanovdb_uint64_t> keys(count);
+            pnanovdb_uint64_t key = 0u;
+            for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+            {
+                key += (rng() % (idx < count / 2u ? 3u : 9000u) == 0u) ? (rng() | 1u) : 0u;
+                keys[idx] = key;
+            }
+
+            std::vector<pnanovdb_uint32_t> expected(2u * count, 0u);
+            pnanovdb_uint64_t run_count = 0u;
+            for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+            {
+                if (idx == 0u || keys[idx] != keys[idx - 1u])
+                {
+                    expected[2u * run_count] = pnanovdb_uint32_t(idx);
+                    run_count++;
+                }
+                expected[2u * run_count - 1u] = pnanovdb_uint32_t(idx + 1u);
+            }
+
+            // pairs past the run count are cleared
+            std::vector<pnanovdb_uint32_t> range(2u * count, ~0u);
+            EXPECT_EQ(pnanovdb_raster::cpu_run_length_encode(pool, keys.data(), range.data(), count), run_count);
+            EXPECT_EQ(range, expected) << count << " keys, " << thread_count << " threads";
+        }
+    }
+}
+
+TEST(NanoVDBEditor, CpuPoolBackToBackCallsCoverEveryIndexOnce)
+{
+    // short calls in a row let workers wake late for a generation that already finished
+    WorkStealingPool pool(8u);
+    for (pnanovdb_uint32_t call_idx = 0u; call_idx < 2000u; call_idx++)
+    {
+        const pnanovdb_uint64_t count = 16u + call_idx % 61u;
+        std::vector<pnanovdb_uint32_t> hits(count, 0u);
+        pool.parallel_for(count, 1u,
+                          [&hits, call_idx](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                          {
+                              for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                              {
+                                  hits[idx] += call_idx + 1u;
+                              }
+                          });
+        ASSERT_EQ(hits, std::vector<pnanovdb_uint32_t>(count, call_idx + 1u)) << "call " << call_idx;
+    }
+}
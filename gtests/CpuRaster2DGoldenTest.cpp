@@ -0,0 +1,154 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   gtests/CpuRaster2DGoldenTest.cpp
+
+    \brief
+*/
+
+#include <gtest/gtest.h>
+
+#include "raster/CpuRaster2D.h"
+
+#include "GpuTestSupport.h"
+#include "RasterTestSupport.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using pnanovdb_editor_test::RasterTestRuntime;
+using pnanovdb_editor_test::RasterTestScene;
+
+namespace
+{
+
+const uint32_t k_width = 320u;
+const uint32_t k_height = 240u;
+
+void make_camera(pnanovdb_camera_mat_t* view, pnanovdb_camera_mat_t* projection)
+{
+    pnanovdb_editor_test::raster_test_camera(view, projection, k_width, k_height, 0.4f, 0.6f * float(k_height));
+}
+
+std::vector<float> raster_cpu(RasterTestRuntime& rt, pnanovdb_raster_gaussian_data_t* data)
+{
+    pnanovdb_camera_mat_t view;
+    pnanovdb_camera_mat_t projection;
+    make_camera(&view, &projection);
+    return pnanovdb_editor_test::raster_test_cpu(rt.raster, rt.compute, data, k_width, k_height, view, projection,
+                                                 pnanovdb_editor_test::raster_test_shader_params());
+}
+
+std::vector<float> raster_gpu(RasterTestRuntime& rt, pnanovdb_raster_gaussian_data_t* data)
+{
+    pnanovdb_camera_mat_t view;
+    pnanovdb_camera_mat_t projection;
+    make_camera(&view, &projection);
+    return rt.raster_gpu(
+        data, k_width, k_height, view, projection, pnanovdb_editor_test::raster_test_shader_params());
+}
+
+} // namespace
+
+class CpuRaster2DGoldenTest : public ::testing::Test
+{
+protected:
+    static RasterTestRuntime* s_rt;
+    static bool s_device_unavailable;
+    static bool s_software_renderer;
+    static std::string s_software_renderer_name;
+
+    static void SetUpTestSuite()
+    {
+        s_rt = new RasterTestRuntime();
+        if (!s_rt->init())
+        {
+            s_device_unavailable = (!s_rt->device_manager || !s_rt->device);
+            s_software_renderer = s_rt->software_renderer;
+            if (s_software_renderer)
+            {
+                s_software_renderer_name = s_rt->device_name;
+            }
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        delete s_rt;
+        s_rt = nullptr;
+    }
+
+    void SetUp() override
+    {
+        if (s_software_renderer)
+        {
+            GTEST_SKIP() << pnanovdb_editor_test::software_renderer_skip_reason(
+                s_software_renderer_name.c_str(), "CPU raster golden image tests");
+        }
+        if (s_device_unavailable)
+        {
+            GTEST_SKIP() << "No Vulkan-compatible device available on this machine";
+        }
+        ASSERT_NE(s_rt, nullptr) << "RasterTestRuntime failed to initialize";
+        ASSERT_NE(s_rt->raster_ctx, nullptr) << "RasterTestRuntime failed to initialize";
+    }
+
+    RasterTestRuntime& rt()
+    {
+        return *s_rt;
+    }
+};
+
+RasterTestRuntime* CpuRaster2DGoldenTest::s_rt = nullptr;
+bool CpuRaster2DGoldenTest::s_device_unavailable = false;
+bool CpuRaster2DGoldenTest::s_software_renderer = false;
+std::string CpuRaster2DGoldenTest::s_software_renderer_name;
+
+TEST_F(CpuRaster2DGoldenTest, MatchesGpuImage)
+{
+    RasterTestScene scene(20000u);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    ASSERT_NE(data, nullptr);
+
+    std::vector<float> golden = raster_gpu(rt(), data);
+    ASSERT_EQ(golden.size(), 4u * k_width * k_height);
+    std::vector<float> image = raster_cpu(rt(), data);
+
+    // exp, sqrt and FMA differ between device and host, a gaussian near the alpha or radius cutoff may flip
+    const uint64_t texel_count = uint64_t(k_width) * k_height;
+    pnanovdb_raster::cpu_raster_image_diff_t diff =
+        pnanovdb_raster::cpu_raster_image_diff(golden.data(), image.data(), texel_count, 0.02f);
+    EXPECT_GT(diff.psnr, 40.0) << "max abs error " << diff.max_abs_error;
+    EXPECT_LT(diff.mean_abs_error, 2e-3);
+    EXPECT_LT(diff.texels_over_threshold, texel_count / 100u);
+
+    // the scene covers most of the view, an empty image would match a failed GPU raster too
+    uint64_t covered = 0u;
+    for (uint64_t texel = 0u; texel < texel_count; texel++)
+    {
+        covered += golden[4u * texel + 3u] < 0.5f ? 1u : 0u;
+    }
+    EXPECT_GT(covered, texel_count / 4u);
+
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
+
+TEST_F(CpuRaster2DGoldenTest, DeviceFreeDataMatches)
+{
+    RasterTestScene scene(2000u);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    pnanovdb_raster_gaussian_data_t* host_data = scene.create(rt().compute, rt().raster, nullptr, nullptr);
+    ASSERT_NE(data, nullptr);
+    ASSERT_NE(host_data, nullptr);
+
+    // render farm nodes create the data without a queue
+    std::vector<float> image = raster_cpu(rt(), data);
+    std::vector<float> host_image = raster_cpu(rt(), host_data);
+    EXPECT_EQ(memcmp(image.data(), host_image.data(), image.size() * sizeof(float)), 0);
+
+    rt().raster.destroy_gaussian_data(&rt().compute, nullptr, host_data);
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
@@ -0,0 +1,297 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/CpuRaster2D.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using pnanovdb_raster::cpu_raster_camera_t;
+using pnanovdb_raster::cpu_raster_gaussians_t;
+using pnanovdb_raster::cpu_raster_params_t;
+using pnanovdb_raster::cpu_raster_splats_t;
+using pnanovdb_util::WorkStealingPool;
+
+static const pnanovdb_uint32_t k_width = 64u;
+static const pnanovdb_uint32_t k_height = 64u;
+static const float k_sh_c0 = 0.2820947917738781f;
+
+static pnanovdb_camera_mat_t make_identity()
+{
+    pnanovdb_camera_mat_t mat = {};
+    mat.x.x = 1.f;
+    mat.y.y = 1.f;
+    mat.z.z = 1.f;
+    mat.w.w = 1.f;
+    return mat;
+}
+
+static pnanovdb_camera_mat_t make_perspective(float near_plane, float far_plane)
+{
+    pnanovdb_camera_mat_t mat = {};
+    mat.x.x = 1.f;
+    mat.y.y = 1.f;
+    mat.z.z = far_plane / (far_plane - near_plane);
+    mat.z.w = 1.f;
+    mat.w.z = -near_plane * far_plane / (far_plane - near_plane);
+    return mat;
+}
+
+// gaussians of the host arrays, chunked as create_gaussian_data does
+struct scene_t
+{
+    std::vector<float> means;
+    std::vector<float> quaternions;
+    std::vector<float> scales;
+    std::vector<float> opacities;
+    std::vector<float> sh_0;
+    std::vector<pnanovdb_uint32_t> chunk_indices;
+    std::vector<pnanovdb_raster::gaussian_chunk_bounds_t> chunk_bounds;
+
+    void add(float x, float y, float z, float scale, float opacity, float r, float g, float b)
+    {
+        means.insert(means.end(), { x, y, z });
+        quaternions.insert(quaternions.end(), { 1.f, 0.f, 0.f, 0.f });
+        scales.insert(scales.end(), { scale, scale, scale });
+        opacities.push_back(opacity);
+        // SH degree 0 adds 0.5 to the basis times the coefficient
+        sh_0.insert(sh_0.end(), { (r - 0.5f) / k_sh_c0, (g - 0.5f) / k_sh_c0, (b - 0.5f) / k_sh_c0 });
+    }
+
+    cpu_raster_gaussians_t gaussians()
+    {
+        pnanovdb_uint64_t point_count = opacities.size();
+        pnanovdb_uint64_t chunk_count =
+            (point_count + pnanovdb_raster::k_gaussian_chunk_size - 1u) / pnanovdb_raster::k_gaussian_chunk_size;
+        chunk_indices.resize(point_count);
+        chunk_bounds.resize(chunk_count);
+        pnanovdb_raster::sort_gaussians_morton(means.data(), point_count, chunk_indices.data());
+        pnanovdb_raster::compute_gaussian_chunk_bounds(
+            means.data(), scales.data(), chunk_indices.data(), point_count, chunk_bounds.data());
+
+        cpu_raster_gaussians_t result = {};
+        result.point_count = point_count;
+        result.means = means.data();
+        result.quaternions = quaternions.data();
+        result.scales = scales.data();
+        result.opacities = opacities.data();
+        result.sh_0 = sh_0.data();
+        result.chunk_count = chunk_count;
+        result.chunk_indices = chunk_indices.data();
+        result.chunk_bounds = chunk_bounds.data();
+        return result;
+    }
+};
+
+static cpu_raster_params_t make_params(pnanovdb_uint32_t composite)
+{
+    cpu_raster_params_t params = {};
+    params.eps2d = 0.3f;
+    params.tile_width = 16u;
+    params.tile_height = 16u;
+    params.composite = composite;
+    return params;
+}
+
+static std::vector<float> render(WorkStealingPool& pool, scene_t& scene, pnanovdb_uint32_t composite, float fill)
+{
+    cpu_raster_camera_t camera =
+        pnanovdb_raster::cpu_raster_camera(make_identity(), make_perspective(1.f, 100.f), k_width, k_height);
+    cpu_raster_splats_t splats;
+    std::vector<float> image(4u * k_width * k_height, fill);
+    pnanovdb_raster::cpu_raster_gaussian_2d(
+        pool, scene.gaussians(), camera, make_params(composite), splats, image.data());
+    return image;
+}
+
+static const float* texel(const std::vector<float>& image, pnanovdb_uint32_t row, pnanovdb_uint32_t column)
+{
+    return image.data() + 4u * (row * k_width + column);
+}
+
+TEST(NanoVDBEditor, WorkStealingPoolCoversRange)
+{
+    WorkStealingPool pool(4u);
+    EXPECT_EQ(pool.thread_count(), 4u);
+
+    for (pnanovdb_uint64_t count : { 1u, 7u, 1000u, 100003u })
+    {
+        std::vector<std::atomic<pnanovdb_uint32_t>> visits(count);
+        for (auto& visit : visits)
+        {
+            visit.store(0u);
+        }
+        pool.parallel_for(count, 16u,
+                          [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                          {
+                              EXPECT_LT(begin, end);
+                              for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                              {
+                                  // uneven work per index so threads steal
+                                  if (idx % 97u == 0u)
+                                  {
+                                      std::this_thread::yield();
+                                  }
+                                  visits[idx].fetch_add(1u);
+                              }
+                          });
+        for (pnanovdb_uint64_t idx = 0u; idx < count; idx++)
+        {
+            ASSERT_EQ(visits[idx].load(), 1u) << "index " << idx << " of " << count;
+        }
+    }
+}
+
+TEST(NanoVDBEditor, CpuRasterSingleGaussian)
+{
+    WorkStealingPool pool(2u);
+    scene_t scene;
+    scene.add(0.f, 0.f, 5.f, 0.5f, 0.8f, 0.25f, 0.5f, 0.75f);
+    std::vector<float> image = render(pool, scene, 0u, -1.f);
+
+    // the mean projects onto the corner shared by the four center pixels
+    const float* center = texel(image, k_height / 2u, k_width / 2u);
+    for (pnanovdb_uint32_t row : { k_height / 2u - 1u, k_height / 2u })
+    {
+        for (pnanovdb_uint32_t column : { k_width / 2u - 1u, k_width / 2u })
+        {
+            for (pnanovdb_uint32_t channel = 0u; channel < 4u; channel++)
+            {
+                EXPECT_FLOAT_EQ(texel(image, row, column)[channel], center[channel]);
+            }
+        }
+    }
+    float alpha = 1.f - center[3];
+    EXPECT_GT(alpha, 0.7f);
+    EXPECT_LE(alpha, 0.8f);
+    EXPECT_NEAR(center[0] / alpha, 0.25f, 1e-5f);
+    EXPECT_NEAR(center[1] / alpha, 0.5f, 1e-5f);
+    EXPECT_NEAR(center[2] / alpha, 0.75f, 1e-5f);
+
+    // every texel is written, far from the gaussian with the black background
+    const float* corner = texel(image, 0u, 0u);
+    EXPECT_EQ(corner[0], 0.f);
+    EXPECT_EQ(corner[3], 1.f);
+}
+
+TEST(NanoVDBEditor, CpuRasterRowsFromTop)
+{
+    WorkStealingPool pool(2u);
+    scene_t scene;
+    scene.add(0.f, 1.5f, 5.f, 0.2f, 0.9f, 1.f, 1.f, 1.f);
+    std::vector<float> image = render(pool, scene, 0u, 0.f);
+
+    // camera space up is pixel row i up, which the texture stores in the upper half
+    pnanovdb_uint32_t brightest_row = 0u;
+    float brightest = -1.f;
+    for (pnanovdb_uint32_t row = 0u; row < k_height; row++)
+    {
+        if (texel(image, row, k_width / 2u)[0] > brightest)
+        {
+            brightest = texel(image, row, k_width / 2u)[0];
+            brightest_row = row;
+        }
+    }
+    EXPECT_GT(brightest, 0.5f);
+    EXPECT_LT(brightest_row, k_height / 2u);
+}
+
+TEST(NanoVDBEditor, CpuRasterThreadCountDeterminism)
+{
+    std::mt19937 rng(7u);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    scene_t scene;
+    for (pnanovdb_uint32_t idx = 0u; idx < 5000u; idx++)
+    {
+        scene.add(8.f * unit(rng) - 4.f, 8.f * unit(rng) - 4.f, 3.f + 10.f * unit(rng), 0.02f + 0.2f * unit(rng),
+                  unit(rng), unit(rng), unit(rng), unit(rng));
+    }
+
+    WorkStealingPool serial_pool(1u);
+    WorkStealingPool parallel_pool(4u);
+    std::vector<float> serial = render(serial_pool, scene, 0u, 0.f);
+    std::vector<float> parallel = render(parallel_pool, scene, 0u, 0.f);
+    std::vector<float> repeated = render(parallel_pool, scene, 0u, 0.f);
+
+    EXPECT_EQ(memcmp(serial.data(), parallel.data(), serial.size() * sizeof(float)), 0);
+    EXPECT_EQ(memcmp(parallel.data(), repeated.data(), parallel.size() * sizeof(float)), 0);
+
+    pnanovdb_uint64_t covered = 0u;
+    for (pnanovdb_uint64_t texel_idx = 0u; texel_idx < k_width * k_height; texel_idx++)
+    {
+        covered += serial[4u * texel_idx + 3u] < 0.5f ? 1u : 0u;
+    }
+    EXPECT_GT(covered, k_width * k_height / 2u);
+}
+
+TEST(NanoVDBEditor, CpuRasterComposite)
+{
+    WorkStealingPool pool(2u);
+    scene_t scene;
+    scene.add(0.f, 0.f, 5.f, 0.5f, 0.8f, 0.25f, 0.5f, 0.75f);
+    std::vector<float> plain = render(pool, scene, 0u, 0.f);
+    std::vector<float> composited = render(pool, scene, 1u, 0.5f);
+
+    // uncovered texels keep the background
+    const float* corner = texel(composited, 0u, 0u);
+    for (pnanovdb_uint32_t channel = 0u; channel < 4u; channel++)
+    {
+        EXPECT_EQ(corner[channel], 0.5f);
+    }
+    const float* center = texel(plain, k_height / 2u, k_width / 2u);
+    const float* center_composited = texel(composited, k_height / 2u, k_width / 2u);
+    float transmittance = center[3];
+    EXPECT_FLOAT_EQ(center_composited[0], center[0] + 0.5f * transmittance);
+    EXPECT_FLOAT_EQ(center_composited[2], center[2] + 0.5f * transmittance);
+    EXPECT_FLOAT_EQ(center_composited[3], 0.5f * transmittance);
+}
+
+TEST(NanoVDBEditor, CpuRasterShBasisBands)
+{
+    // the squares of a band sum to (2l + 1) / 4pi in any direction
+    float basis[pnanovdb_raster::k_cpu_raster_sh_basis_count];
+    pnanovdb_raster::cpu_raster_sh_basis(4u, { 0.3f, -0.5f, 0.8f }, basis);
+    for (pnanovdb_uint32_t band = 0u; band <= 4u; band++)
+    {
+        float sum = 0.f;
+        for (pnanovdb_uint32_t idx = band * band; idx < (band + 1u) * (band + 1u); idx++)
+        {
+            sum += basis[idx] * basis[idx];
+        }
+        EXPECT_NEAR(sum, float(2u * band + 1u) / (4.f * 3.14159265f), 1e-5f) << "band " << band;
+    }
+
+    pnanovdb_raster::cpu_raster_sh_basis(1u, { 0.f, 0.f, 1.f }, basis);
+    EXPECT_EQ(basis[4], 0.f);
+
+    EXPECT_EQ(pnanovdb_raster::cpu_raster_sh_degree(-1, 15u), 3u);
+    EXPECT_EQ(pnanovdb_raster::cpu_raster_sh_degree(-1, 0u), 0u);
+    EXPECT_EQ(pnanovdb_raster::cpu_raster_sh_degree(2, 15u), 2u);
+    EXPECT_EQ(pnanovdb_raster::cpu_raster_sh_degree(7, 24u), 4u);
+}
+
+TEST(NanoVDBEditor, CpuRasterImageDiff)
+{
+    std::vector<float> a(4u * 100u, 0.5f);
+    std::vector<float> b = a;
+    pnanovdb_raster::cpu_raster_image_diff_t same =
+        pnanovdb_raster::cpu_raster_image_diff(a.data(), b.data(), 100u, 0.f);
+    EXPECT_EQ(same.max_abs_error, 0.f);
+    EXPECT_EQ(same.texels_over_threshold, 0u);
+    EXPECT_TRUE(std::isinf(same.psnr));
+
+    // alpha is not compared
+    b[3] = 0.f;
+    b[4u * 10u + 1u] = 0.6f;
+    pnanovdb_raster::cpu_raster_image_diff_t diff =
+        pnanovdb_raster::cpu_raster_image_diff(a.data(), b.data(), 100u, 0.05f);
+    EXPECT_NEAR(diff.max_abs_error, 0.1f, 1e-6f);
+    EXPECT_NEAR(diff.mean_abs_error, 0.1 / 300.0, 1e-7);
+    EXPECT_NEAR(diff.psnr, 10.0 * log10(300.0 / 0.01), 1e-3);
+    EXPECT_EQ(diff.texels_over_threshold, 1u);
+}
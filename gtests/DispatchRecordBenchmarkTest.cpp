@@ -0,0 +1,237 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+// CPU cost of recording small dispatches for each descriptor update mode, reports timings and checks the output
+
+#include "GpuTestSupport.h"
+
+#include <gtest/gtest.h>
+
+#include <nanovdb_editor/putil/Compiler.h>
+#include <nanovdb_editor/putil/Compute.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr pnanovdb_uint32_t k_dispatches_per_frame = 2048u;
+constexpr pnanovdb_uint32_t k_frame_count = 8u;
+// one workgroup of test.slang
+constexpr pnanovdb_uint32_t k_threads_per_dispatch = 8u;
+constexpr int k_magic_number = 12345;
+
+struct record_timing_t
+{
+    double record_us_per_dispatch = 0.0;
+    double flush_us_per_frame = 0.0;
+    pnanovdb_uint32_t wrong_output_count = 0u;
+};
+
+bool run_record_benchmark(pnanovdb_compute_t* compute,
+                          pnanovdb_compute_device_manager_t* device_manager,
+                          pnanovdb_compute_descriptor_update_mode_t mode,
+                          const std::string& shader_path,
+                          record_timing_t* timing)
+{
+    pnanovdb_compute_device_desc_t device_desc = {};
+    device_desc.log_print = pnanovdb_editor_test::stderr_log_print;
+    device_desc.descriptor_update_mode = mode;
+
+    pnanovdb_compute_device_t* device = compute->device_interface.create_device(device_manager, &device_desc);
+    if (!device)
+    {
+        return false;
+    }
+
+    pnanovdb_compute_queue_t* queue = compute->device_interface.get_device_queue(device);
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* compute_context = compute->device_interface.get_compute_context(queue);
+
+    pnanovdb_compiler_settings_t compile_settings = {};
+    pnanovdb_compiler_settings_init(&compile_settings);
+
+    pnanovdb_shader_context_t* shader_context = compute->create_shader_context(shader_path.c_str());
+    if (compute->init_shader(compute, queue, shader_context, &compile_settings) == PNANOVDB_FALSE)
+    {
+        compute->destroy_shader_context(compute, queue, shader_context);
+        compute->device_interface.destroy_device(device_manager, device);
+        return false;
+    }
+
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
+                     PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 4u;
+    buf_desc.size_in_bytes = 65536u;
+    pnanovdb_compute_buffer_t* data_in =
+        compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* data_out =
+        compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* scratch =
+        compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
+    buf_desc.structure_stride = 0u;
+    buf_desc.size_in_bytes = 16u;
+    pnanovdb_compute_buffer_t* constants =
+        compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+    int constants_data[4] = { k_magic_number, 0, 0, 0 };
+    void* mapped_constants = compute_interface->map_buffer(compute_context, constants);
+    memcpy(mapped_constants, constants_data, sizeof(constants_data));
+    compute_interface->unmap_buffer(compute_context, constants);
+
+    std::vector<int> input(k_threads_per_dispatch);
+    for (pnanovdb_uint32_t idx = 0u; idx < k_threads_per_dispatch; idx++)
+    {
+        input[idx] = int(3u * idx + 1u);
+    }
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+    buf_desc.size_in_bytes = input.size() * sizeof(int);
+    pnanovdb_compute_buffer_t* data_upload =
+        compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+    void* mapped_input = compute_interface->map_buffer(compute_context, data_upload);
+    memcpy(mapped_input, input.data(), input.size() * sizeof(int));
+    compute_interface->unmap_buffer(compute_context, data_upload);
+
+    pnanovdb_compute_copy_buffer_params_t copy_params = {};
+    copy_params.num_bytes = input.size() * sizeof(int);
+    copy_params.src = compute_interface->register_buffer_as_transient(compute_context, data_upload);
+    copy_params.dst = compute_interface->register_buffer_as_transient(compute_context, data_in);
+    copy_params.debug_label = "record_benchmark_upload";
+    compute_interface->copy_buffer(compute_context, &copy_params);
+
+    using clock = std::chrono::steady_clock;
+    double record_us = 0.0;
+    double flush_us = 0.0;
+    pnanovdb_uint32_t timed_frames = 0u;
+
+    // frame 0 warms up descriptor pools and command buffers and is not timed
+    for (pnanovdb_uint32_t frame_idx = 0u; frame_idx <= k_frame_count; frame_idx++)
+    {
+        pnanovdb_compute_resource_t resources[4u] = {};
+        resources[0u].buffer_transient = compute_interface->register_buffer_as_transient(compute_context, data_in);
+        resources[1u].buffer_transient = compute_interface->register_buffer_as_transient(compute_context, constants);
+        resources[2u].buffer_transient = compute_interface->register_buffer_as_transient(compute_context, data_out);
+        resources[3u].buffer_transient = compute_interface->register_buffer_as_transient(compute_context, scratch);
+
+        auto record_begin = clock::now();
+        for (pnanovdb_uint32_t dispatch_idx = 0u; dispatch_idx < k_dispatches_per_frame; dispatch_idx++)
+        {
+            compute->dispatch_shader(
+                compute_interface, compute_context, shader_context, resources, 1u, 1u, 1u, "record_benchmark");
+        }
+        auto flush_begin = clock::now();
+        pnanovdb_uint64_t flushed_frame = 0llu;
+        compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+        auto flush_end = clock::now();
+
+        compute->device_interface.wait_for_frame(queue, flushed_frame);
+
+        if (frame_idx > 0u)
+        {
+            record_us += std::chrono::duration<double, std::micro>(flush_begin - record_begin).count();
+            flush_us += std::chrono::duration<double, std::micro>(flush_end - flush_begin).count();
+            timed_frames++;
+        }
+    }
+
+    // every dispatch writes the same outputs, so any mode that drops or misbinds descriptors shows up here
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+    pnanovdb_compute_buffer_t* data_readback =
+        compute_interface->create_buffer(compute_context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+    copy_params.src = compute_interface->register_buffer_as_transient(compute_context, data_out);
+    copy_params.dst = compute_interface->register_buffer_as_transient(compute_context, data_readback);
+    copy_params.debug_label = "record_benchmark_readback";
+    compute_interface->copy_buffer(compute_context, &copy_params);
+
+    pnanovdb_uint64_t flushed_frame = 0llu;
+    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+    compute->device_interface.wait_idle(queue);
+
+    const int* output = static_cast<const int*>(compute_interface->map_buffer(compute_context, data_readback));
+    for (pnanovdb_uint32_t idx = 0u; idx < k_threads_per_dispatch; idx++)
+    {
+        if (output[idx] != input[idx] + k_magic_number)
+        {
+            timing->wrong_output_count++;
+        }
+    }
+    compute_interface->unmap_buffer(compute_context, data_readback);
+
+    timing->record_us_per_dispatch = record_us / double(timed_frames * k_dispatches_per_frame);
+    timing->flush_us_per_frame = flush_us / double(timed_frames);
+
+    compute_interface->destroy_buffer(compute_context, data_in);
+    compute_interface->destroy_buffer(compute_context, data_out);
+    compute_interface->destroy_buffer(compute_context, scratch);
+    compute_interface->destroy_buffer(compute_context, constants);
+    compute_interface->destroy_buffer(compute_context, data_upload);
+    compute_interface->destroy_buffer(compute_context, data_readback);
+
+    compute->destroy_shader(compute_interface, &compute->shader_interface, compute_context, shader_context);
+    compute->destroy_shader_context(compute, queue, shader_context);
+
+    compute->device_interface.destroy_device(device_manager, device);
+    return true;
+}
+} // namespace
+
+TEST(NanoVDBEditor, DispatchRecordBenchmark)
+{
+    const std::filesystem::path shader = std::filesystem::path(__FILE__).parent_path() / "shaders" / "test.slang";
+    const std::string shader_path = shader.string();
+
+    pnanovdb_compiler_t compiler = {};
+    pnanovdb_compiler_load(&compiler);
+    ASSERT_NE(compiler.module, nullptr) << "Compiler module not available";
+
+    pnanovdb_compute_t compute = {};
+    pnanovdb_compute_load(&compute, &compiler);
+    ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+
+    pnanovdb_compute_device_manager_t* device_manager = compute.device_interface.create_device_manager(PNANOVDB_FALSE);
+    ASSERT_NE(device_manager, nullptr);
+
+    pnanovdb_compute_physical_device_desc_t phys_desc = {};
+    if (!compute.device_interface.enumerate_devices(device_manager, 0u, &phys_desc))
+    {
+        compute.device_interface.destroy_device_manager(device_manager);
+        pnanovdb_compiler_free(&compiler);
+        pnanovdb_compute_free(&compute);
+        GTEST_SKIP() << "No Vulkan-compatible device available on this machine";
+    }
+
+    struct mode_entry_t
+    {
+        pnanovdb_compute_descriptor_update_mode_t mode;
+        const char* name;
+    };
+    const mode_entry_t modes[] = {
+        { PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_WRITES, "writes" },
+        { PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_TEMPLATE, "template" },
+        { PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_PUSH, "push" },
+    };
+
+    // a mode the device lacks falls back at device creation, so every entry still runs
+    for (const mode_entry_t& entry : modes)
+    {
+        record_timing_t timing = {};
+        ASSERT_TRUE(run_record_benchmark(&compute, device_manager, entry.mode, shader_path, &timing))
+            << "Benchmark failed for descriptor update mode " << entry.name;
+        EXPECT_EQ(timing.wrong_output_count, 0u) << "data_out != data_in + magic for mode " << entry.name;
+        printf("[DispatchRecordBenchmark] %-8s %8.3f us/dispatch record, %10.1f us/frame flush (%u dispatches)\n",
+               entry.name, timing.record_us_per_dispatch, timing.flush_us_per_frame, k_dispatches_per_frame);
+    }
+
+    compute.device_interface.destroy_device_manager(device_manager);
+
+    pnanovdb_compiler_free(&compiler);
+    pnanovdb_compute_free(&compute);
+}
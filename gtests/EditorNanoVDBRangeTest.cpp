@@ -0,0 +1,129 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <gtest/gtest.h>
+
+#include <nanovdb_editor/putil/Compiler.h>
+#include <nanovdb_editor/putil/Compute.h>
+#include <nanovdb_editor/putil/Editor.h>
+
+#include "EditorTestSupport.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+
+class EditorNanoVDBRangeTest : public ::testing::Test
+{
+protected:
+    pnanovdb_compiler_t compiler{};
+    pnanovdb_compute_t compute{};
+    pnanovdb_editor_t editor{};
+
+    pnanovdb_editor_token_t* scene_token = nullptr;
+    pnanovdb_editor_token_t* name_token = nullptr;
+    pnanovdb_compute_array_t* source_array = nullptr;
+
+    static constexpr size_t k_array_size = 256u;
+
+    void SetUp() override
+    {
+        pnanovdb_compiler_load(&compiler);
+        ASSERT_NE(compiler.module, nullptr) << "Compiler module not available";
+
+        pnanovdb_compute_load(&compute, &compiler);
+        ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+
+        pnanovdb_editor_load(&editor, &compute, &compiler);
+        ASSERT_NE(editor.module, nullptr) << "Editor module failed to load";
+        ASSERT_NE(editor.impl, nullptr) << "Editor impl not initialized by init()";
+        ASSERT_NE(editor.update_nanovdb_range, nullptr) << "update_nanovdb_range not bound";
+
+        scene_token = editor.get_token("range_test_scene");
+        name_token = editor.get_token("range_test_object");
+        ASSERT_NE(scene_token, nullptr);
+        ASSERT_NE(name_token, nullptr);
+
+        // add_nanovdb_2 duplicates the array, edits must land in the editor's copy
+        std::array<uint8_t, k_array_size> bytes{};
+        source_array = compute.create_array(sizeof(uint8_t), bytes.size(), bytes.data());
+        ASSERT_NE(source_array, nullptr);
+
+        editor.add_nanovdb_2(&editor, scene_token, name_token, source_array);
+    }
+
+    void TearDown() override
+    {
+        if (editor.impl)
+        {
+            editor.remove(&editor, scene_token, name_token);
+            pnanovdb_editor_free(&editor);
+        }
+        if (source_array)
+        {
+            compute.destroy_array(source_array);
+        }
+        pnanovdb_compute_free(&compute);
+        pnanovdb_compiler_free(&compiler);
+    }
+
+    pnanovdb_compute_array_t* object_array()
+    {
+        return pnanovdb_editor_test::get_object_nanovdb_array(&editor, scene_token, name_token);
+    }
+};
+
+} // namespace
+
+TEST_F(EditorNanoVDBRangeTest, WritesRangeInPlace)
+{
+    pnanovdb_compute_array_t* array = object_array();
+    ASSERT_NE(array, nullptr);
+    ASSERT_NE(array, source_array);
+
+    std::array<uint8_t, 16> edit{};
+    for (size_t idx = 0u; idx < edit.size(); idx++)
+    {
+        edit[idx] = uint8_t(idx + 1u);
+    }
+    EXPECT_EQ(editor.update_nanovdb_range(&editor, scene_token, name_token, edit.data(), 32u, edit.size()),
+              PNANOVDB_TRUE);
+
+    // same array as before, only the range changed
+    ASSERT_EQ(object_array(), array);
+    const uint8_t* data = static_cast<const uint8_t*>(array->data);
+    EXPECT_EQ(std::memcmp(data + 32u, edit.data(), edit.size()), 0);
+    for (size_t idx = 0u; idx < k_array_size; idx++)
+    {
+        if (idx < 32u || idx >= 32u + edit.size())
+        {
+            EXPECT_EQ(data[idx], 0u) << "byte " << idx << " outside the range was changed";
+        }
+    }
+    EXPECT_EQ(std::memcmp(source_array->data, std::array<uint8_t, k_array_size>{}.data(), k_array_size), 0)
+        << "the caller's array must not be touched";
+}
+
+TEST_F(EditorNanoVDBRangeTest, RejectsRangesOutsideTheArray)
+{
+    std::array<uint8_t, 16> edit{};
+    edit.fill(0xFFu);
+
+    EXPECT_EQ(
+        editor.update_nanovdb_range(&editor, scene_token, name_token, edit.data(), k_array_size - 8u, edit.size()),
+        PNANOVDB_FALSE);
+    EXPECT_EQ(editor.update_nanovdb_range(&editor, scene_token, name_token, edit.data(), ~0llu, edit.size()),
+              PNANOVDB_FALSE);
+    EXPECT_EQ(editor.update_nanovdb_range(&editor, scene_token, editor.get_token("range_test_missing"), edit.data(),
+                                          0u, edit.size()),
+              PNANOVDB_FALSE);
+
+    pnanovdb_compute_array_t* array = object_array();
+    ASSERT_NE(array, nullptr);
+    EXPECT_EQ(std::memcmp(array->data, std::array<uint8_t, k_array_size>{}.data(), k_array_size), 0)
+        << "a rejected edit must not write anything";
+}
@@ -88,6 +88,27 @@ pnanovdb_bool_t get_object_process_dirty(pnanovdb_editor_t* editor,
     return dirty ? PNANOVDB_TRUE : PNANOVDB_FALSE;
 }
 
+pnanovdb_compute_array_t* get_object_nanovdb_array(pnanovdb_editor_t* editor,
+                                                   pnanovdb_editor_token_t* scene,
+                                                   pnanovdb_editor_token_t* name)
+{
+    if (!editor || !editor->impl || !editor->impl->scene_manager || !scene || !name)
+    {
+        return nullptr;
+    }
+    pnanovdb_compute_array_t* array = nullptr;
+    editor->impl->scene_manager->with_object(scene, name,
+                                             [&](pnanovdb_editor::SceneObject* obj)
+                                             {
+                                                 if (obj)
+                                                 {
+                                                     array = obj->nanovdb_array() ? obj->nanovdb_array() :
+                                                                                    obj->converted_nanovdb();
+                                                 }
+                                             });
+    return array;
+}
+
 size_t get_object_pipeline_params_size(pnanovdb_editor_t* editor,
                                        pnanovdb_editor_token_t* scene,
                                        pnanovdb_editor_token_t* name,
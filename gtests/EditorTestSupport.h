@@ -50,6 +50,11 @@ pnanovdb_bool_t get_object_process_dirty(pnanovdb_editor_t* editor,
                                          pnanovdb_editor_token_t* scene,
                                          pnanovdb_editor_token_t* name);
 
+// host array the renderer draws for the object, owned by the scene manager
+pnanovdb_compute_array_t* get_object_nanovdb_array(pnanovdb_editor_t* editor,
+                                                   pnanovdb_editor_token_t* scene,
+                                                   pnanovdb_editor_token_t* name);
+
 size_t get_object_pipeline_params_size(pnanovdb_editor_t* editor,
                                        pnanovdb_editor_token_t* scene,
                                        pnanovdb_editor_token_t* name,
@@ -5,8 +5,84 @@
 
 #include <nanovdb_editor/putil/Compute.h>
 #include <nanovdb_editor/putil/FileFormat.h>
+
+#include <nanovdb/GridHandle.h>
+#include <nanovdb/io/IO.h>
+#include <nanovdb/tools/CreateNanoGrid.h>
+#include <nanovdb/tools/GridBuilder.h>
+
+#include <chrono>
 #include <filesystem>
 #include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// a dense block of extent^3 voxels, value and offset make every grid distinct
+nanovdb::GridHandle<nanovdb::HostBuffer> make_test_grid(const char* name, float value, int extent)
+{
+    nanovdb::tools::build::Grid<float> grid(0.f, name);
+    auto acc = grid.getAccessor();
+    for (int i = 0; i < extent; i++)
+    {
+        for (int j = 0; j < extent; j++)
+        {
+            for (int k = 0; k < extent; k++)
+            {
+                acc.setValue(nanovdb::Coord(i + int(value), j, k), value + float(i));
+            }
+        }
+    }
+    grid.setTransform(0.25 * double(value), nanovdb::Vec3d(double(value), 0.0, -1.0));
+    return nanovdb::tools::createNanoGrid(grid);
+}
+
+enum class test_file_layout_t
+{
+    raw, // GridHandle::write, grid buffers without file headers
+    one_segment, // every grid in one segment
+    two_segments, // two grids in the first segment, one in the second
+    two_segments_blosc,
+};
+
+// writes three float grids, returns the path
+std::string write_test_file(test_file_layout_t layout)
+{
+    const char* names[] = { "raw", "one_segment", "two_segments", "two_segments_blosc" };
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / ("pnanovdb_file_test_" + std::string(names[int(layout)]) + ".nvdb");
+
+    std::vector<nanovdb::GridHandle<nanovdb::HostBuffer>> first;
+    first.push_back(make_test_grid("density", 1.f, 20));
+    first.push_back(make_test_grid("temperature", 2.f, 12));
+    nanovdb::GridHandle<nanovdb::HostBuffer> third = make_test_grid("", 3.f, 9);
+    if (layout == test_file_layout_t::raw || layout == test_file_layout_t::one_segment)
+    {
+        first.push_back(std::move(third));
+        nanovdb::GridHandle<nanovdb::HostBuffer> merged = nanovdb::mergeGrids(first);
+        if (layout == test_file_layout_t::raw)
+        {
+            merged.write(path.string());
+        }
+        else
+        {
+            nanovdb::io::writeGrid(path.string(), merged);
+        }
+        return path.string();
+    }
+    std::vector<nanovdb::GridHandle<nanovdb::HostBuffer>> segments;
+    segments.push_back(nanovdb::mergeGrids(first));
+    segments.push_back(std::move(third));
+    nanovdb::io::writeGrids(path.string(), segments,
+                            layout == test_file_layout_t::two_segments_blosc ? nanovdb::io::Codec::BLOSC :
+                                                                               nanovdb::io::Codec::NONE);
+    return path.string();
+}
+
+} // namespace
 
 TEST(NanoVDBEditor, FileFormatLoadsIngpFile)
 {
@@ -181,3 +257,251 @@ TEST(NanoVDBEditor, FileFormatHandlesMissingFile)
     pnanovdb_fileformat_free(&fileformat);
     pnanovdb_compute_free(&compute);
 }
+
+TEST(NanoVDBEditor, FileFormatMultiGridFileLoadsMatchReadGrid)
+{
+    pnanovdb_compute_t compute = {};
+    pnanovdb_compute_load(&compute, nullptr);
+    ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+
+    for (test_file_layout_t layout : { test_file_layout_t::one_segment, test_file_layout_t::two_segments,
+                                       test_file_layout_t::two_segments_blosc })
+    {
+        const std::string path = write_test_file(layout);
+        SCOPED_TRACE(path);
+
+        pnanovdb_compute_nanovdb_file_t* file = compute.open_nanovdb_file(path.c_str());
+        ASSERT_NE(file, nullptr);
+        ASSERT_EQ(compute.get_nanovdb_file_grid_count(file), 3u);
+
+        pnanovdb_compute_grid_info_t info = {};
+        EXPECT_EQ(compute.get_nanovdb_file_grid_info(file, 3u, &info), PNANOVDB_FALSE);
+        EXPECT_EQ(compute.request_nanovdb_file_grid(file, 3u), nullptr);
+        EXPECT_EQ(compute.get_nanovdb_file_grid(file, 3u), nullptr);
+
+        for (pnanovdb_uint32_t grid_idx = 0u; grid_idx < 3u; grid_idx++)
+        {
+            // request is non-blocking, poll it until the background load finished
+            pnanovdb_compute_array_t* requested = nullptr;
+            for (int attempt = 0; attempt < 1000 && !requested; attempt++)
+            {
+                requested = compute.request_nanovdb_file_grid(file, grid_idx);
+                if (!requested)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+            ASSERT_NE(requested, nullptr) << "grid " << grid_idx;
+            pnanovdb_compute_array_t* array = compute.get_nanovdb_file_grid(file, grid_idx);
+            EXPECT_EQ(array, requested) << "grid " << grid_idx << " was loaded twice";
+
+            nanovdb::GridHandle<nanovdb::HostBuffer> expected = nanovdb::io::readGrid(path, int(grid_idx));
+            const nanovdb::GridData* expected_data = expected.gridData(0u);
+            ASSERT_NE(expected_data, nullptr);
+            const nanovdb::GridData* loaded_data = (const nanovdb::GridData*)array->data;
+            const pnanovdb_uint64_t grid_size = expected_data->mGridSize;
+
+            // a loaded grid is a standalone buffer, only its grid index and count differ from the file
+            ASSERT_EQ(array->element_count * array->element_size, grid_size);
+            EXPECT_EQ(loaded_data->mGridCount, 1u);
+            EXPECT_EQ(loaded_data->mGridIndex, 0u);
+            EXPECT_STREQ(loaded_data->mGridName, expected_data->mGridName);
+            EXPECT_EQ(std::memcmp((const char*)array->data + sizeof(nanovdb::GridData),
+                                  (const char*)expected_data + sizeof(nanovdb::GridData),
+                                  grid_size - sizeof(nanovdb::GridData)),
+                      0)
+                << "grid " << grid_idx;
+        }
+        compute.close_nanovdb_file(file);
+        std::filesystem::remove(path);
+    }
+
+    pnanovdb_compute_free(&compute);
+}
+
+TEST(NanoVDBEditor, FileFormatMultiGridFileClosesWhileLoading)
+{
+    pnanovdb_compute_t compute = {};
+    pnanovdb_compute_load(&compute, nullptr);
+    ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+
+    const std::string path = write_test_file(test_file_layout_t::two_segments_blosc);
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        pnanovdb_compute_nanovdb_file_t* file = compute.open_nanovdb_file(path.c_str());
+        ASSERT_NE(file, nullptr);
+        for (pnanovdb_uint32_t grid_idx = 0u; grid_idx < 3u; grid_idx++)
+        {
+            compute.request_nanovdb_file_grid(file, grid_idx);
+        }
+        // close waits for the pending loads and frees their arrays
+        compute.close_nanovdb_file(file);
+    }
+    std::filesystem::remove(path);
+
+    pnanovdb_compute_free(&compute);
+}
+
+static void expect_grid_info_matches(const pnanovdb_compute_grid_info_t& info,
+                                     const nanovdb::io::FileGridMetaData& meta)
+{
+    EXPECT_STREQ(info.grid_name, meta.gridName.c_str());
+    EXPECT_EQ(info.grid_type, pnanovdb_uint32_t(meta.gridType));
+    EXPECT_EQ(info.grid_class, pnanovdb_uint32_t(meta.gridClass));
+    EXPECT_EQ(info.version, meta.version.id());
+    EXPECT_EQ(info.grid_size, meta.gridSize);
+    EXPECT_EQ(info.active_voxel_count, meta.voxelCount);
+    for (int level = 0; level < 3; level++)
+    {
+        EXPECT_EQ(info.node_count[level], meta.nodeCount[level]) << "level " << level;
+    }
+    EXPECT_EQ(info.index_bbox_min.x, meta.indexBBox[0][0]);
+    EXPECT_EQ(info.index_bbox_min.y, meta.indexBBox[0][1]);
+    EXPECT_EQ(info.index_bbox_min.z, meta.indexBBox[0][2]);
+    EXPECT_EQ(info.index_bbox_max.x, meta.indexBBox[1][0]);
+    EXPECT_EQ(info.index_bbox_max.y, meta.indexBBox[1][1]);
+    EXPECT_EQ(info.index_bbox_max.z, meta.indexBBox[1][2]);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        EXPECT_DOUBLE_EQ(info.world_bbox_min[axis], meta.worldBBox[0][axis]);
+        EXPECT_DOUBLE_EQ(info.world_bbox_max[axis], meta.worldBBox[1][axis]);
+        EXPECT_DOUBLE_EQ(info.voxel_size[axis], meta.voxelSize[axis]);
+    }
+}
+
+static std::vector<pnanovdb_compute_grid_info_t> read_grid_infos(const pnanovdb_compute_t& compute,
+                                                                 const std::string& path)
+{
+    std::vector<pnanovdb_compute_grid_info_t> infos(compute.read_nanovdb_grid_info(path.c_str(), nullptr, 0u));
+    if (!infos.empty())
+    {
+        EXPECT_EQ(compute.read_nanovdb_grid_info(path.c_str(), infos.data(), pnanovdb_uint32_t(infos.size())),
+                  pnanovdb_uint32_t(infos.size()));
+    }
+    return infos;
+}
+
+TEST(NanoVDBEditor, FileFormatGridInfoMatchesReadGridMetaData)
+{
+    pnanovdb_compute_t compute = {};
+    pnanovdb_compute_load(&compute, nullptr);
+    ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+
+    // segment headers as NanoVDB io reads them
+    for (test_file_layout_t layout : { test_file_layout_t::one_segment, test_file_layout_t::two_segments,
+                                       test_file_layout_t::two_segments_blosc })
+    {
+        const std::string path = write_test_file(layout);
+        SCOPED_TRACE(path);
+        const std::vector<nanovdb::io::FileGridMetaData> metas = nanovdb::io::readGridMetaData(path);
+        const std::vector<pnanovdb_compute_grid_info_t> infos = read_grid_infos(compute, path);
+        ASSERT_EQ(infos.size(), metas.size());
+        ASSERT_EQ(infos.size(), 3u);
+
+        const bool two_segments = layout != test_file_layout_t::one_segment;
+        const pnanovdb_uint32_t expected_segments[] = { 0u, 0u, two_segments ? 1u : 0u };
+        const pnanovdb_uint32_t expected_grid_indices[] = { 0u, 1u, two_segments ? 0u : 2u };
+        for (size_t idx = 0u; idx < infos.size(); idx++)
+        {
+            SCOPED_TRACE("grid " + std::to_string(idx));
+            expect_grid_info_matches(infos[idx], metas[idx]);
+            EXPECT_EQ(infos[idx].codec, pnanovdb_uint32_t(metas[idx].codec));
+            EXPECT_EQ(infos[idx].file_size, metas[idx].fileSize);
+            EXPECT_EQ(infos[idx].segment_index, expected_segments[idx]);
+            EXPECT_EQ(infos[idx].grid_index, expected_grid_indices[idx]);
+            EXPECT_LE(infos[idx].file_offset + infos[idx].file_size, std::filesystem::file_size(path));
+            if (idx > 0u)
+            {
+                EXPECT_GE(infos[idx].file_offset, infos[idx - 1u].file_offset + infos[idx - 1u].file_size);
+            }
+        }
+        if (layout == test_file_layout_t::two_segments_blosc)
+        {
+            EXPECT_EQ(infos[0].codec, pnanovdb_uint32_t(nanovdb::io::Codec::BLOSC));
+            EXPECT_LT(infos[0].file_size, infos[0].grid_size);
+        }
+
+        // a short destination gets the leading grids and the full count
+        pnanovdb_compute_grid_info_t first_info = {};
+        EXPECT_EQ(compute.read_nanovdb_grid_info(path.c_str(), &first_info, 1u), 3u);
+        EXPECT_STREQ(first_info.grid_name, infos[0].grid_name);
+        std::filesystem::remove(path);
+    }
+
+    // raw buffers hold the same grids as the single segment file, laid out back to back
+    const std::string segment_path = write_test_file(test_file_layout_t::one_segment);
+    const std::string raw_path = write_test_file(test_file_layout_t::raw);
+    const std::vector<nanovdb::io::FileGridMetaData> metas = nanovdb::io::readGridMetaData(segment_path);
+    const std::vector<pnanovdb_compute_grid_info_t> infos = read_grid_infos(compute, raw_path);
+    ASSERT_EQ(infos.size(), metas.size());
+    pnanovdb_uint64_t expected_offset = 0u;
+    for (size_t idx = 0u; idx < infos.size(); idx++)
+    {
+        SCOPED_TRACE("raw grid " + std::to_string(idx));
+        expect_grid_info_matches(infos[idx], metas[idx]);
+        EXPECT_EQ(infos[idx].codec, pnanovdb_uint32_t(nanovdb::io::Codec::NONE));
+        EXPECT_EQ(infos[idx].segment_index, 0u);
+        EXPECT_EQ(infos[idx].grid_index, pnanovdb_uint32_t(idx));
+        EXPECT_EQ(infos[idx].file_offset, expected_offset);
+        EXPECT_EQ(infos[idx].file_size, infos[idx].grid_size);
+        expected_offset += infos[idx].grid_size;
+    }
+    EXPECT_EQ(expected_offset, std::filesystem::file_size(raw_path));
+    std::filesystem::remove(segment_path);
+    std::filesystem::remove(raw_path);
+
+    pnanovdb_compute_free(&compute);
+}
+
+TEST(NanoVDBEditor, FileFormatGridInfoHandlesTruncatedFiles)
+{
+    pnanovdb_compute_t compute = {};
+    pnanovdb_compute_load(&compute, nullptr);
+    ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+
+    const std::string segment_path = write_test_file(test_file_layout_t::two_segments);
+    const std::string raw_path = write_test_file(test_file_layout_t::raw);
+    const std::vector<pnanovdb_compute_grid_info_t> segment_infos = read_grid_infos(compute, segment_path);
+    const std::vector<pnanovdb_compute_grid_info_t> raw_infos = read_grid_infos(compute, raw_path);
+    ASSERT_EQ(segment_infos.size(), 3u);
+    ASSERT_EQ(raw_infos.size(), 3u);
+
+    const std::filesystem::path truncated_path =
+        std::filesystem::temp_directory_path() / "pnanovdb_file_truncated.nvdb";
+    auto truncated_copy = [&](const std::string& src, pnanovdb_uint64_t size)
+    {
+        std::filesystem::copy_file(src, truncated_path, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(truncated_path, size);
+        return truncated_path.string();
+    };
+
+    // cut inside the first file header, nothing can be read
+    EXPECT_EQ(compute.read_nanovdb_grid_info(truncated_copy(segment_path, 10u).c_str(), nullptr, 0u), 0u);
+    EXPECT_EQ(compute.open_nanovdb_file(truncated_path.string().c_str()), nullptr);
+
+    // cut inside the header of the second segment, the complete first segment is still listed
+    const pnanovdb_uint64_t first_segment_end = segment_infos[1].file_offset + segment_infos[1].file_size;
+    const std::string cut_second_header = truncated_copy(segment_path, first_segment_end + 10u);
+    EXPECT_EQ(compute.read_nanovdb_grid_info(cut_second_header.c_str(), nullptr, 0u), 2u);
+
+    // cut inside the last grid payload, headers are intact but loading the grid fails
+    const pnanovdb_uint64_t last_payload_cut = segment_infos[2].file_offset + segment_infos[2].file_size / 2u;
+    const std::string cut_payload = truncated_copy(segment_path, last_payload_cut);
+    pnanovdb_compute_nanovdb_file_t* file = compute.open_nanovdb_file(cut_payload.c_str());
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(compute.get_nanovdb_file_grid_count(file), 3u);
+    EXPECT_NE(compute.get_nanovdb_file_grid(file, 0u), nullptr);
+    EXPECT_EQ(compute.get_nanovdb_file_grid(file, 2u), nullptr);
+    compute.close_nanovdb_file(file);
+
+    // cut inside the header of the last raw grid, the grids before it are still listed
+    const std::string cut_raw_header = truncated_copy(raw_path, raw_infos[2].file_offset + 100u);
+    EXPECT_EQ(compute.read_nanovdb_grid_info(cut_raw_header.c_str(), nullptr, 0u), 2u);
+
+    EXPECT_EQ(compute.read_nanovdb_grid_info("pnanovdb_file_missing.nvdb", nullptr, 0u), 0u);
+
+    std::filesystem::remove(truncated_path);
+    std::filesystem::remove(segment_path);
+    std::filesystem::remove(raw_path);
+    pnanovdb_compute_free(&compute);
+}
@@ -0,0 +1,318 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   gtests/FrameCompletionTest.cpp
+
+    \brief
+*/
+
+#include <gtest/gtest.h>
+
+#include <nanovdb_editor/putil/Compiler.h>
+#include <nanovdb_editor/putil/Compute.h>
+
+#include "GpuTestSupport.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+struct fired_callback_t
+{
+    uint32_t tag;
+    uint64_t frame;
+};
+
+struct callback_log_t
+{
+    std::vector<fired_callback_t> fired;
+};
+
+// userdata is the tag, log is shared through s_callback_log
+callback_log_t* s_callback_log = nullptr;
+
+void PNANOVDB_ABI record_frame_callback(void* userdata, pnanovdb_uint64_t frame)
+{
+    s_callback_log->fired.push_back({ uint32_t(reinterpret_cast<uintptr_t>(userdata)), frame });
+}
+
+// Compiler / compute / device fixture. init() returns false
+// when no Vulkan device is available so the caller can GTEST_SKIP.
+struct FrameCompletionRuntime
+{
+    pnanovdb_compiler_t compiler{};
+    pnanovdb_compute_t compute{};
+    pnanovdb_compute_device_manager_t* device_manager = nullptr;
+    pnanovdb_compute_device_t* device = nullptr;
+    pnanovdb_compute_queue_t* queue = nullptr;
+    pnanovdb_compute_buffer_t* src_buffer = nullptr;
+    pnanovdb_compute_buffer_t* dst_buffer = nullptr;
+    bool software_renderer = false;
+    std::string device_name;
+
+    bool init()
+    {
+        pnanovdb_compiler_load(&compiler);
+        if (!compiler.module)
+        {
+            ADD_FAILURE() << "Compiler module not available";
+            return false;
+        }
+        pnanovdb_compute_load(&compute, &compiler);
+        if (!compute.module)
+        {
+            ADD_FAILURE() << "Compute module not available";
+            return false;
+        }
+        device_manager = compute.device_interface.create_device_manager(PNANOVDB_FALSE);
+        if (!device_manager)
+        {
+            ADD_FAILURE() << "Failed to create device manager";
+            return false;
+        }
+        pnanovdb_compute_physical_device_desc_t phys_desc{};
+        if (!compute.device_interface.enumerate_devices(device_manager, 0u, &phys_desc))
+        {
+            return false;
+        }
+        device_name = phys_desc.device_name;
+        if (pnanovdb_editor_test::should_skip_on_software_renderer(phys_desc.device_name))
+        {
+            software_renderer = true;
+            return false;
+        }
+        pnanovdb_compute_device_desc_t device_desc{};
+        device_desc.log_print = pnanovdb_editor_test::stderr_log_print;
+        device = compute.device_interface.create_device(device_manager, &device_desc);
+        if (!device)
+        {
+            ADD_FAILURE() << "Failed to create compute device";
+            return false;
+        }
+        queue = compute.device_interface.get_compute_queue(device);
+        if (!queue)
+        {
+            ADD_FAILURE() << "Failed to acquire compute queue";
+            return false;
+        }
+        if (!compute.device_interface.is_frame_completed || !compute.device_interface.add_frame_callback)
+        {
+            ADD_FAILURE() << "frame completion interface not loaded";
+            return false;
+        }
+
+        pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+        pnanovdb_compute_buffer_desc_t buf_desc = {};
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+        buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+        buf_desc.structure_stride = 0u;
+        buf_desc.size_in_bytes = 4096u;
+        src_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+        dst_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+        return src_buffer && dst_buffer;
+    }
+
+    // records a small copy so every frame carries GPU work, returns the frame flush hands out as completion token
+    pnanovdb_uint64_t submit_frame()
+    {
+        pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+        pnanovdb_compute_copy_buffer_params_t copy_params = {};
+        copy_params.num_bytes = 4096u;
+        copy_params.src = compute_interface->register_buffer_as_transient(context, src_buffer);
+        copy_params.dst = compute_interface->register_buffer_as_transient(context, dst_buffer);
+        copy_params.debug_label = "frame_completion_copy";
+        compute_interface->copy_buffer(context, &copy_params);
+
+        pnanovdb_uint64_t flushed_frame = 0llu;
+        compute.device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+        return flushed_frame;
+    }
+
+    ~FrameCompletionRuntime()
+    {
+        if (queue)
+        {
+            compute.device_interface.wait_idle(queue);
+            pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+            pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+            if (src_buffer)
+                compute_interface->destroy_buffer(context, src_buffer);
+            if (dst_buffer)
+                compute_interface->destroy_buffer(context, dst_buffer);
+        }
+        if (device)
+            compute.device_interface.destroy_device(device_manager, device);
+        if (device_manager)
+            compute.device_interface.destroy_device_manager(device_manager);
+        if (compute.module)
+            pnanovdb_compute_free(&compute);
+        if (compiler.module)
+            pnanovdb_compiler_free(&compiler);
+    }
+};
+
+} // namespace
+
+class FrameCompletionTest : public ::testing::Test
+{
+protected:
+    static FrameCompletionRuntime* s_rt;
+    static bool s_device_unavailable;
+    static bool s_software_renderer;
+    static std::string s_software_renderer_name;
+
+    static void SetUpTestSuite()
+    {
+        s_rt = new FrameCompletionRuntime();
+        if (!s_rt->init())
+        {
+            s_device_unavailable = (!s_rt->device_manager || !s_rt->device);
+            s_software_renderer = s_rt->software_renderer;
+            if (s_software_renderer)
+            {
+                s_software_renderer_name = s_rt->device_name;
+            }
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        delete s_rt;
+        s_rt = nullptr;
+    }
+
+    void SetUp() override
+    {
+        if (s_software_renderer)
+        {
+            GTEST_SKIP() << pnanovdb_editor_test::software_renderer_skip_reason(
+                s_software_renderer_name.c_str(), "frame completion tests");
+        }
+        if (s_device_unavailable)
+        {
+            GTEST_SKIP() << "No Vulkan-compatible device available on this machine";
+        }
+        ASSERT_NE(s_rt, nullptr) << "FrameCompletionRuntime failed to initialize";
+        ASSERT_NE(s_rt->src_buffer, nullptr) << "FrameCompletionRuntime failed to initialize";
+        m_log.fired.clear();
+        s_callback_log = &m_log;
+    }
+
+    void TearDown() override
+    {
+        if (s_rt && s_rt->queue)
+        {
+            // drain callbacks still pending so they never see the log of another test
+            s_rt->compute.device_interface.wait_idle(s_rt->queue);
+        }
+        s_callback_log = nullptr;
+    }
+
+    FrameCompletionRuntime& rt()
+    {
+        return *s_rt;
+    }
+
+    void add_callback(pnanovdb_uint64_t frame, uint32_t tag)
+    {
+        rt().compute.device_interface.add_frame_callback(
+            rt().queue, frame, record_frame_callback, reinterpret_cast<void*>(uintptr_t(tag)));
+    }
+
+    callback_log_t m_log;
+};
+
+FrameCompletionRuntime* FrameCompletionTest::s_rt = nullptr;
+bool FrameCompletionTest::s_device_unavailable = false;
+bool FrameCompletionTest::s_software_renderer = false;
+std::string FrameCompletionTest::s_software_renderer_name;
+
+TEST_F(FrameCompletionTest, FlushedFramesCompleteInOrder)
+{
+    const pnanovdb_uint64_t frame_a = rt().submit_frame();
+    const pnanovdb_uint64_t frame_b = rt().submit_frame();
+    EXPECT_LT(frame_a, frame_b);
+
+    // a frame that was never flushed can not complete, polling must not block on it
+    EXPECT_FALSE(rt().compute.device_interface.is_frame_completed(rt().queue, frame_b + 1000u));
+
+    rt().compute.device_interface.wait_for_frame(rt().queue, frame_b);
+    EXPECT_TRUE(rt().compute.device_interface.is_frame_completed(rt().queue, frame_a));
+    EXPECT_TRUE(rt().compute.device_interface.is_frame_completed(rt().queue, frame_b));
+}
+
+TEST_F(FrameCompletionTest, PollingEventuallyCompletes)
+{
+    const pnanovdb_uint64_t frame = rt().submit_frame();
+    add_callback(frame, 0u);
+
+    // polling both advances the fence values and fires the callback of the frame
+    bool completed = false;
+    for (uint32_t attempt = 0u; attempt < 1000000u && !completed; attempt++)
+    {
+        completed = rt().compute.device_interface.is_frame_completed(rt().queue, frame) == PNANOVDB_TRUE;
+    }
+    ASSERT_TRUE(completed);
+    ASSERT_EQ(m_log.fired.size(), 1u);
+    EXPECT_EQ(m_log.fired[0].frame, frame);
+}
+
+TEST_F(FrameCompletionTest, CallbacksFireInFrameOrder)
+{
+    const pnanovdb_uint64_t frame_a = rt().submit_frame();
+    const pnanovdb_uint64_t frame_b = rt().submit_frame();
+    const pnanovdb_uint64_t frame_c = rt().submit_frame();
+
+    // added out of frame order, frame_a twice to check callbacks of one frame keep the order they were added in
+    const std::pair<pnanovdb_uint64_t, uint32_t> added[] = {
+        { frame_c, 0u },
+        { frame_a, 1u },
+        { frame_b, 2u },
+        { frame_a, 3u },
+    };
+    for (const auto& entry : added)
+    {
+        add_callback(entry.first, entry.second);
+    }
+    // callbacks of frames known to be complete fire inside add_frame_callback, the rest are pending
+    const size_t fired_on_add = m_log.fired.size();
+
+    rt().compute.device_interface.wait_idle(rt().queue);
+
+    ASSERT_EQ(m_log.fired.size(), 4u) << "every callback fires exactly once";
+    for (size_t idx = 0u; idx < m_log.fired.size(); idx++)
+    {
+        EXPECT_EQ(m_log.fired[idx].frame, added[m_log.fired[idx].tag].first) << "callback got the wrong frame";
+    }
+    for (size_t idx = fired_on_add + 1u; idx < m_log.fired.size(); idx++)
+    {
+        const fired_callback_t& prev = m_log.fired[idx - 1u];
+        const fired_callback_t& cur = m_log.fired[idx];
+        EXPECT_LE(prev.frame, cur.frame) << "pending callbacks fired out of frame order";
+        if (prev.frame == cur.frame)
+        {
+            EXPECT_LT(prev.tag, cur.tag) << "callbacks of one frame fired out of the order they were added";
+        }
+    }
+}
+
+TEST_F(FrameCompletionTest, CallbackOnCompletedFrameFiresImmediately)
+{
+    const pnanovdb_uint64_t frame = rt().submit_frame();
+    rt().compute.device_interface.wait_for_frame(rt().queue, frame);
+
+    add_callback(frame, 7u);
+    ASSERT_EQ(m_log.fired.size(), 1u);
+    EXPECT_EQ(m_log.fired[0].tag, 7u);
+    EXPECT_EQ(m_log.fired[0].frame, frame);
+}
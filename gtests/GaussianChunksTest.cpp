@@ -0,0 +1,104 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/GaussianChunks.h"
+
+#include <vector>
+
+using pnanovdb_raster::gaussian_chunk_bounds_t;
+using pnanovdb_raster::k_gaussian_chunk_size;
+
+static pnanovdb_camera_mat_t make_perspective(float near_plane, float far_plane)
+{
+    pnanovdb_camera_mat_t mat = {};
+    mat.x.x = 1.f;
+    mat.y.y = 1.f;
+    mat.z.z = far_plane / (far_plane - near_plane);
+    mat.z.w = 1.f;
+    mat.w.z = -near_plane * far_plane / (far_plane - near_plane);
+    return mat;
+}
+
+TEST(NanoVDBEditor, GaussianMortonSortGroupsNearbyMeans)
+{
+    // two clusters interleaved in load order
+    std::vector<float> means;
+    for (pnanovdb_uint32_t idx = 0u; idx < 8u; idx++)
+    {
+        float offset = (idx & 1u) ? 100.f : 0.f;
+        means.push_back(offset + 0.1f * float(idx));
+        means.push_back(offset);
+        means.push_back(offset);
+    }
+    std::vector<pnanovdb_uint32_t> indices(8u);
+    pnanovdb_raster::sort_gaussians_morton(means.data(), 8u, indices.data());
+
+    for (pnanovdb_uint32_t idx = 0u; idx < 8u; idx++)
+    {
+        EXPECT_EQ(indices[idx] & 1u, idx < 4u ? 0u : 1u);
+    }
+}
+
+TEST(NanoVDBEditor, GaussianChunkBoundsCoverScales)
+{
+    const pnanovdb_uint64_t point_count = k_gaussian_chunk_size + 2u;
+    std::vector<float> means(3u * point_count, 0.f);
+    std::vector<float> scales(3u * point_count, 0.1f);
+    std::vector<pnanovdb_uint32_t> indices(point_count);
+    for (pnanovdb_uint32_t idx = 0u; idx < point_count; idx++)
+    {
+        indices[idx] = idx;
+    }
+    means[0u] = -1.f;
+    means[3u] = 1.f;
+    scales[3u * (point_count - 1u) + 2u] = -2.f;
+    means[3u * (point_count - 1u) + 1u] = 5.f;
+    means[3u * (point_count - 2u) + 1u] = 3.f;
+
+    gaussian_chunk_bounds_t bounds[2u] = {};
+    pnanovdb_raster::compute_gaussian_chunk_bounds(means.data(), scales.data(), indices.data(), point_count, bounds);
+
+    EXPECT_FLOAT_EQ(bounds[0u].x, 0.f);
+    EXPECT_FLOAT_EQ(bounds[0u].radius, 1.3f);
+    EXPECT_FLOAT_EQ(bounds[1u].y, 4.f);
+    EXPECT_FLOAT_EQ(bounds[1u].radius, 7.f);
+}
+
+TEST(NanoVDBEditor, GaussianChunkFrustumCulling)
+{
+    pnanovdb_camera_mat_t view_proj = make_perspective(1.f, 10.f);
+    pnanovdb_vec4_t planes[6];
+    pnanovdb_raster::extract_frustum_planes(view_proj, planes);
+    const pnanovdb_vec4_t depth_row = { view_proj.x.w, view_proj.y.w, view_proj.z.w, view_proj.w.w };
+
+    auto visible = [&](float x, float y, float z, float radius)
+    { return pnanovdb_raster::gaussian_chunk_visible({ x, y, z, radius }, planes, depth_row, 100.f, 0.f); };
+
+    EXPECT_TRUE(visible(0.f, 0.f, 5.f, 0.1f));
+    EXPECT_FALSE(visible(0.f, 0.f, -5.f, 1.f));
+    EXPECT_FALSE(visible(0.f, 0.f, 20.f, 1.f));
+    EXPECT_FALSE(visible(10.f, 0.f, 5.f, 1.f));
+    // overlaps the side plane
+    EXPECT_TRUE(visible(5.5f, 0.f, 5.f, 1.f));
+    EXPECT_TRUE(visible(0.f, 0.f, 0.5f, 1.f));
+}
+
+TEST(NanoVDBEditor, GaussianChunkScreenSizeCulling)
+{
+    pnanovdb_camera_mat_t view_proj = make_perspective(0.1f, 1000.f);
+    pnanovdb_vec4_t planes[6];
+    pnanovdb_raster::extract_frustum_planes(view_proj, planes);
+    const pnanovdb_vec4_t depth_row = { view_proj.x.w, view_proj.y.w, view_proj.z.w, view_proj.w.w };
+
+    // radius 0.1 at depth 10 with fx 100 projects to one pixel
+    const gaussian_chunk_bounds_t chunk = { 0.f, 0.f, 10.f, 0.1f };
+    EXPECT_TRUE(pnanovdb_raster::gaussian_chunk_visible(chunk, planes, depth_row, 100.f, 0.f));
+    EXPECT_TRUE(pnanovdb_raster::gaussian_chunk_visible(chunk, planes, depth_row, 100.f, 0.5f));
+    EXPECT_FALSE(pnanovdb_raster::gaussian_chunk_visible(chunk, planes, depth_row, 100.f, 2.f));
+
+    // the camera inside the chunk
+    const gaussian_chunk_bounds_t around = { 0.f, 0.f, 0.5f, 1.f };
+    EXPECT_TRUE(pnanovdb_raster::gaussian_chunk_visible(around, planes, depth_row, 100.f, 2.f));
+}
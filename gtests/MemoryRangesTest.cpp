@@ -0,0 +1,171 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "vulkan/MemoryRangesVulkan.h"
+
+#include <vector>
+
+using namespace pnanovdb_vulkan;
+
+namespace
+{
+constexpr pnanovdb_uint64_t k_mb = 1024u * 1024u;
+
+void expect_ranges(const std::vector<MemoryRange>& ranges, const std::vector<MemoryRange>& expected)
+{
+    ASSERT_EQ(ranges.size(), expected.size());
+    for (size_t idx = 0u; idx < ranges.size(); idx++)
+    {
+        EXPECT_EQ(ranges[idx].offset, expected[idx].offset) << "range " << idx;
+        EXPECT_EQ(ranges[idx].sizeInBytes, expected[idx].sizeInBytes) << "range " << idx;
+    }
+}
+} // namespace
+
+TEST(NanoVDBEditor, MemorySizeClassRoundsUpInQuarterSteps)
+{
+    EXPECT_EQ(memoryHeap_getSizeClass(1u), kMemoryMinSizeClass);
+    EXPECT_EQ(memoryHeap_getSizeClass(kMemoryMinSizeClass), kMemoryMinSizeClass);
+    EXPECT_EQ(memoryHeap_getSizeClass(257u), 320u);
+    EXPECT_EQ(memoryHeap_getSizeClass(1000u), 1024u);
+    EXPECT_EQ(memoryHeap_getSizeClass(1025u), 1280u);
+    EXPECT_EQ(memoryHeap_getSizeClass(1280u), 1280u);
+    EXPECT_EQ(memoryHeap_getSizeClass(3u * k_mb + 1u), 3u * k_mb + 512u * 1024u);
+
+    pnanovdb_uint64_t prevSizeClass = 0u;
+    for (pnanovdb_uint64_t size = kMemoryMinSizeClass; size < 64u * 1024u; size += 7u)
+    {
+        pnanovdb_uint64_t sizeClass = memoryHeap_getSizeClass(size);
+        EXPECT_GE(sizeClass, size);
+        EXPECT_LT(4u * (sizeClass - size), size) << "more than 25% waste for " << size;
+        EXPECT_GE(sizeClass, prevSizeClass);
+        EXPECT_EQ(memoryHeap_getSizeClass(sizeClass), sizeClass);
+        prevSizeClass = sizeClass;
+    }
+}
+
+TEST(NanoVDBEditor, MemoryDedicatedBlocksAboveHalfABlock)
+{
+    EXPECT_FALSE(memoryHeap_needsDedicatedBlock(PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, kMemoryBlockSizeDevice / 2u));
+    EXPECT_TRUE(memoryHeap_needsDedicatedBlock(PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, kMemoryBlockSizeDevice / 2u + 1u));
+    EXPECT_FALSE(memoryHeap_needsDedicatedBlock(PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, kMemoryBlockSizeHost / 2u));
+    EXPECT_TRUE(memoryHeap_needsDedicatedBlock(PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, kMemoryBlockSizeHost / 2u + 1u));
+    EXPECT_TRUE(memoryHeap_needsDedicatedBlock(PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, 12u * k_mb));
+    EXPECT_FALSE(memoryHeap_needsDedicatedBlock(PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, 12u * k_mb));
+}
+
+TEST(NanoVDBEditor, MemoryRangesFindBestFit)
+{
+    std::vector<MemoryRange> ranges = { { 0u, 1000u }, { 2000u, 300u }, { 4000u, 500u } };
+    pnanovdb_uint64_t waste = 0u;
+
+    EXPECT_EQ(memoryRanges_find(ranges, 256u, 1u, &waste), 1u);
+    EXPECT_EQ(waste, 44u);
+
+    // aligned to 256 the range at 2000 starts at 2048 and no longer fits
+    EXPECT_EQ(memoryRanges_find(ranges, 256u, 256u, &waste), 2u);
+    EXPECT_EQ(waste, 244u);
+
+    EXPECT_EQ(memoryRanges_find(ranges, 1001u, 1u, &waste), ~0llu);
+    EXPECT_EQ(memoryRanges_find({}, 1u, 1u, &waste), ~0llu);
+}
+
+TEST(NanoVDBEditor, MemoryRangesAllocateKeepsPaddingAndTail)
+{
+    std::vector<MemoryRange> ranges = { { 100u, 1000u } };
+    EXPECT_EQ(memoryRanges_allocate(ranges, 0u, 256u, 256u), 256u);
+    expect_ranges(ranges, { { 100u, 156u }, { 512u, 588u } });
+
+    // an exact fit leaves nothing behind
+    EXPECT_EQ(memoryRanges_allocate(ranges, 1u, 588u, 4u), 512u);
+    expect_ranges(ranges, { { 100u, 156u } });
+}
+
+TEST(NanoVDBEditor, MemoryRangesFreeCoalesces)
+{
+    std::vector<MemoryRange> ranges = { { 0u, 1024u } };
+    pnanovdb_uint64_t offsets[4] = {};
+    for (pnanovdb_uint64_t& offset : offsets)
+    {
+        pnanovdb_uint64_t waste = 0u;
+        pnanovdb_uint64_t rangeIdx = memoryRanges_find(ranges, 256u, 256u, &waste);
+        ASSERT_NE(rangeIdx, ~0llu);
+        offset = memoryRanges_allocate(ranges, rangeIdx, 256u, 256u);
+    }
+    EXPECT_EQ(offsets[0], 0u);
+    EXPECT_EQ(offsets[3], 768u);
+    EXPECT_TRUE(ranges.empty());
+
+    memoryRanges_free(ranges, offsets[1], 256u);
+    memoryRanges_free(ranges, offsets[3], 256u);
+    expect_ranges(ranges, { { 256u, 256u }, { 768u, 256u } });
+
+    // merges with the next range
+    memoryRanges_free(ranges, offsets[0], 256u);
+    expect_ranges(ranges, { { 0u, 512u }, { 768u, 256u } });
+
+    // merges with both neighbours
+    memoryRanges_free(ranges, offsets[2], 256u);
+    expect_ranges(ranges, { { 0u, 1024u } });
+}
+
+TEST(NanoVDBEditor, AliasedRangesShareMemoryOnlyAcrossDisjointLifetimes)
+{
+    std::vector<AliasedRange> ranges = {
+        { 0, 2, 1000u, 256u, 0u }, // first half of the flush
+        { 3, 5, 800u, 256u, 0u }, // second half, can reuse the memory of the first
+        { 1, 4, 500u, 256u, 0u }, // overlaps both
+    };
+    pnanovdb_uint64_t arenaSize = aliasedRanges_place(ranges);
+    EXPECT_EQ(ranges[0].offset, 0u);
+    EXPECT_EQ(ranges[1].offset, 0u);
+    EXPECT_EQ(ranges[2].offset, 1024u);
+    EXPECT_EQ(arenaSize, 1524u);
+
+    // all alive at once, nothing is shared
+    std::vector<AliasedRange> concurrent = {
+        { 0, 3, 100u, 64u, 0u },
+        { 0, 3, 300u, 64u, 0u },
+        { 2, 2, 200u, 64u, 0u },
+    };
+    EXPECT_EQ(aliasedRanges_place(concurrent), 676u);
+    EXPECT_EQ(concurrent[1].offset, 0u);
+    EXPECT_EQ(concurrent[2].offset, 320u);
+    EXPECT_EQ(concurrent[0].offset, 576u);
+}
+
+TEST(NanoVDBEditor, AliasedRangesNeverOverlapWhileAlive)
+{
+    std::vector<AliasedRange> ranges;
+    pnanovdb_uint32_t state = 1u;
+    for (int idx = 0; idx < 64; idx++)
+    {
+        state = state * 1664525u + 1013904223u;
+        int nodeBegin = int((state >> 8u) % 32u);
+        int nodeEnd = nodeBegin + int((state >> 16u) % 8u);
+        pnanovdb_uint64_t sizeInBytes = 1u + (state >> 4u) % 4096u;
+        pnanovdb_uint64_t alignment = 1llu << ((state >> 24u) % 9u);
+        ranges.push_back(AliasedRange{ nodeBegin, nodeEnd, sizeInBytes, alignment, 0u });
+    }
+    pnanovdb_uint64_t arenaSize = aliasedRanges_place(ranges);
+
+    pnanovdb_uint64_t requestedSize = 0u;
+    for (size_t idx = 0u; idx < ranges.size(); idx++)
+    {
+        const AliasedRange& range = ranges[idx];
+        requestedSize += range.sizeInBytes;
+        EXPECT_EQ(range.offset % range.alignment, 0u) << "range " << idx;
+        EXPECT_LE(range.offset + range.sizeInBytes, arenaSize) << "range " << idx;
+        for (size_t otherIdx = 0u; otherIdx < idx; otherIdx++)
+        {
+            const AliasedRange& other = ranges[otherIdx];
+            bool lifetimeOverlap = range.nodeBegin <= other.nodeEnd && other.nodeBegin <= range.nodeEnd;
+            bool rangeOverlap =
+                range.offset < other.offset + other.sizeInBytes && other.offset < range.offset + range.sizeInBytes;
+            EXPECT_FALSE(lifetimeOverlap && rangeOverlap) << "ranges " << otherIdx << " and " << idx;
+        }
+    }
+    EXPECT_LT(arenaSize, requestedSize) << "disjoint lifetimes should share memory";
+}
@@ -0,0 +1,54 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/MultiView.h"
+
+using pnanovdb_raster::k_multi_view_instance_bytes;
+using pnanovdb_raster::k_multi_view_max_bytes;
+using pnanovdb_raster::multi_view_batch_size;
+
+TEST(NanoVDBEditor, MultiViewBatchSize)
+{
+    // small scenes take all views at once
+    EXPECT_EQ(multi_view_batch_size(1000u, 256u), 256u);
+    EXPECT_EQ(multi_view_batch_size(0u, 64u), 64u);
+
+    // large scenes are bounded by the per instance buffers
+    pnanovdb_uint64_t prim_count = 4000000u;
+    pnanovdb_uint32_t batch_size = multi_view_batch_size(prim_count, 256u);
+    EXPECT_GE(batch_size, 1u);
+    EXPECT_LE(batch_size * k_multi_view_instance_bytes * prim_count, k_multi_view_max_bytes);
+    EXPECT_GT((batch_size + 1u) * k_multi_view_instance_bytes * prim_count, k_multi_view_max_bytes);
+
+    // a scene larger than the budget still renders one view at a time
+    EXPECT_EQ(multi_view_batch_size(100000000u, 16u), 1u);
+
+    // instance indices stay below 2^31
+    EXPECT_LE(pnanovdb_uint64_t(multi_view_batch_size(1u << 20u, 4096u)) << 20u, 1llu << 31u);
+}
+
+TEST(NanoVDBEditor, MultiViewAtlasLayout)
+{
+    EXPECT_EQ(pnanovdb_raster::multi_view_atlas_rows(64u, 8u), 8u);
+    EXPECT_EQ(pnanovdb_raster::multi_view_atlas_rows(65u, 8u), 9u);
+
+    // views fill rows from the top, the first pixel row of a view is its bottom texel row
+    pnanovdb_uint32_t x = 0u;
+    pnanovdb_uint32_t y = 0u;
+    pnanovdb_raster::multi_view_atlas_pixel(0u, 4u, 640u, 480u, 0u, 0u, &x, &y);
+    EXPECT_EQ(x, 0u);
+    EXPECT_EQ(y, 479u);
+    pnanovdb_raster::multi_view_atlas_pixel(5u, 4u, 640u, 480u, 479u, 639u, &x, &y);
+    EXPECT_EQ(x, 1279u);
+    EXPECT_EQ(y, 480u);
+
+    // cells do not overlap
+    pnanovdb_raster::multi_view_atlas_pixel(3u, 4u, 640u, 480u, 0u, 639u, &x, &y);
+    EXPECT_EQ(x, 2559u);
+    EXPECT_EQ(y, 479u);
+    pnanovdb_raster::multi_view_atlas_pixel(4u, 4u, 640u, 480u, 479u, 0u, &x, &y);
+    EXPECT_EQ(x, 0u);
+    EXPECT_EQ(y, 480u);
+}
@@ -0,0 +1,177 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <nanovdb_editor/putil/Compute.h>
+
+#include <nanovdb/GridHandle.h>
+#include <nanovdb/tools/CreateNanoGrid.h>
+#include <nanovdb/tools/GridBuilder.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+class NanoVDBLodTest : public ::testing::Test
+{
+protected:
+    pnanovdb_compute_t compute{};
+
+    void SetUp() override
+    {
+        pnanovdb_compute_load(&compute, nullptr); // the LOD builder runs on the host
+        ASSERT_NE(compute.module, nullptr) << "Failed to load compute module";
+        ASSERT_NE(compute.create_nanovdb_lod, nullptr);
+    }
+
+    void TearDown() override
+    {
+        pnanovdb_compute_free(&compute);
+    }
+
+    pnanovdb_compute_array_t* to_array(const nanovdb::GridHandle<nanovdb::HostBuffer>& handle)
+    {
+        return compute.create_array(
+            sizeof(pnanovdb_uint32_t), handle.bufferSize() / sizeof(pnanovdb_uint32_t), handle.data());
+    }
+
+    static nanovdb::GridHandle<nanovdb::HostBuffer> to_handle(const pnanovdb_compute_array_t* array)
+    {
+        nanovdb::HostBuffer buffer(array->element_count * array->element_size);
+        std::memcpy(buffer.data(), array->data, buffer.size());
+        return nanovdb::GridHandle<nanovdb::HostBuffer>(std::move(buffer));
+    }
+
+    // builds one LOD level of grid, returns the handle holding the base grid and the level
+    nanovdb::GridHandle<nanovdb::HostBuffer> build_lod(nanovdb::tools::build::Grid<float>& grid)
+    {
+        pnanovdb_compute_array_t* base = to_array(nanovdb::tools::createNanoGrid(grid));
+        pnanovdb_compute_array_t* lod = compute.create_nanovdb_lod(base, 1u);
+        compute.destroy_array(base);
+        if (!lod)
+        {
+            return nanovdb::GridHandle<nanovdb::HostBuffer>();
+        }
+        nanovdb::GridHandle<nanovdb::HostBuffer> handle = to_handle(lod);
+        compute.destroy_array(lod);
+        return handle;
+    }
+};
+
+} // namespace
+
+TEST_F(NanoVDBLodTest, AveragesBlocksWithBackgroundFill)
+{
+    const float background = 1.f;
+    nanovdb::tools::build::Grid<float> grid(background, "density");
+    auto acc = grid.getAccessor();
+    // full block, values 1 to 8
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            for (int k = 0; k < 2; k++)
+            {
+                acc.setValue(nanovdb::Coord(i, j, k), float(1 + i + 2 * j + 4 * k));
+            }
+        }
+    }
+    // partial blocks, the missing voxels count as background
+    acc.setValue(nanovdb::Coord(4, 4, 4), 5.f);
+    acc.setValue(nanovdb::Coord(5, 4, 4), 5.f);
+    acc.setValue(nanovdb::Coord(4, 5, 5), 5.f);
+    acc.setValue(nanovdb::Coord(-1, -1, -1), 9.f);
+    grid.setTransform(0.5, nanovdb::Vec3d(1.0, 2.0, 3.0));
+
+    nanovdb::GridHandle<nanovdb::HostBuffer> handle = build_lod(grid);
+    ASSERT_EQ(handle.gridCount(), 2u);
+    const nanovdb::NanoGrid<float>* fine = handle.grid<float>(0u);
+    const nanovdb::NanoGrid<float>* coarse = handle.grid<float>(1u);
+    ASSERT_NE(fine, nullptr);
+    ASSERT_NE(coarse, nullptr);
+    EXPECT_EQ(fine->activeVoxelCount(), 12u);
+
+    const auto& tree = coarse->tree();
+    EXPECT_EQ(coarse->activeVoxelCount(), 3u);
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(0, 0, 0)), 4.5f);
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(2, 2, 2)), (15.f + 5.f * background) / 8.f);
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(-1, -1, -1)), (9.f + 7.f * background) / 8.f);
+    EXPECT_TRUE(tree.isActive(nanovdb::Coord(-1, -1, -1)));
+    EXPECT_FALSE(tree.isActive(nanovdb::Coord(1, 1, 1)));
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(1, 1, 1)), background);
+
+    // coarse voxel i covers fine voxels [2i, 2i + 2), the index origin keeps its world position
+    EXPECT_DOUBLE_EQ(coarse->voxelSize()[0], 2.0 * fine->voxelSize()[0]);
+    const nanovdb::Vec3d fine_origin = fine->map().applyMap(nanovdb::Vec3d(0.0));
+    const nanovdb::Vec3d coarse_origin = coarse->map().applyMap(nanovdb::Vec3d(0.0));
+    for (int axis = 0; axis < 3; axis++)
+    {
+        EXPECT_DOUBLE_EQ(coarse_origin[axis], fine_origin[axis]);
+    }
+}
+
+TEST_F(NanoVDBLodTest, CarriesTilesToTheNextNodeLevel)
+{
+    nanovdb::tools::build::Grid<float> grid(0.f, "density");
+    grid.root().addTile<1>(nanovdb::Coord(16, 0, 0), 3.f, true); // 8^3 lower node tile
+    grid.root().addTile<2>(nanovdb::Coord(256, 0, 0), 5.f, true); // 128^3 upper node tile
+    grid.root().addTile<3>(nanovdb::Coord(8192, 0, 0), 7.f, true); // 4096^3 root tile
+
+    nanovdb::GridHandle<nanovdb::HostBuffer> handle = build_lod(grid);
+    ASSERT_EQ(handle.gridCount(), 2u);
+    const nanovdb::NanoGrid<float>* coarse = handle.grid<float>(1u);
+    ASSERT_NE(coarse, nullptr);
+    const auto& tree = coarse->tree();
+
+    const pnanovdb_uint64_t expected_voxels = 4u * 4u * 4u + 64u * 64u * 64u + 2048llu * 2048llu * 2048llu;
+    EXPECT_EQ(coarse->activeVoxelCount(), expected_voxels);
+
+    // the lower tile halves to voxels of one leaf, the others stay tiles one level down
+    EXPECT_EQ(tree.nodeCount(0), 1u);
+    EXPECT_EQ(tree.nodeCount(1), 2u);
+    EXPECT_EQ(tree.nodeCount(2), 2u);
+
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(8, 0, 0)), 3.f);
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(11, 3, 3)), 3.f);
+    EXPECT_FALSE(tree.isActive(nanovdb::Coord(12, 0, 0)));
+
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(128, 0, 0)), 5.f);
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(191, 63, 63)), 5.f);
+    EXPECT_FALSE(tree.isActive(nanovdb::Coord(192, 0, 0)));
+
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(4096, 0, 0)), 7.f);
+    EXPECT_FLOAT_EQ(tree.getValue(nanovdb::Coord(6143, 2047, 2047)), 7.f);
+    EXPECT_TRUE(tree.isActive(nanovdb::Coord(6143, 2047, 2047)));
+    EXPECT_FALSE(tree.isActive(nanovdb::Coord(6144, 0, 0)));
+}
+
+TEST_F(NanoVDBLodTest, RejectsArraysOtherThanOneFloatGrid)
+{
+    EXPECT_EQ(compute.create_nanovdb_lod(nullptr, 1u), nullptr);
+
+    // large enough for a grid header, but no magic
+    std::vector<pnanovdb_uint32_t> zeros(1024u, 0u);
+    pnanovdb_compute_array_t* zero_array = compute.create_array(sizeof(pnanovdb_uint32_t), zeros.size(), zeros.data());
+    EXPECT_EQ(compute.create_nanovdb_lod(zero_array, 1u), nullptr);
+    compute.destroy_array(zero_array);
+
+    nanovdb::tools::build::Grid<float> grid_a(0.f, "a");
+    nanovdb::tools::build::Grid<float> grid_b(0.f, "b");
+    grid_a.getAccessor().setValue(nanovdb::Coord(0), 1.f);
+    grid_b.getAccessor().setValue(nanovdb::Coord(0), 2.f);
+    std::vector<nanovdb::GridHandle<nanovdb::HostBuffer>> handles;
+    handles.push_back(nanovdb::tools::createNanoGrid(grid_a));
+    handles.push_back(nanovdb::tools::createNanoGrid(grid_b));
+    pnanovdb_compute_array_t* two_grids = to_array(nanovdb::mergeGrids(handles));
+    EXPECT_EQ(compute.create_nanovdb_lod(two_grids, 1u), nullptr);
+    compute.destroy_array(two_grids);
+
+    nanovdb::tools::build::Grid<double> double_grid(0.0, "double");
+    double_grid.getAccessor().setValue(nanovdb::Coord(0), 1.0);
+    pnanovdb_compute_array_t* double_array = to_array(nanovdb::tools::createNanoGrid(double_grid));
+    EXPECT_EQ(compute.create_nanovdb_lod(double_array, 1u), nullptr);
+    compute.destroy_array(double_array);
+}
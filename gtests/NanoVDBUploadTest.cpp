@@ -0,0 +1,82 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "compute/NanoVDBUpload.h"
+
+#include <vector>
+
+using pnanovdb_compute::DirtyRangeLog;
+using pnanovdb_compute::StagingRing;
+using pnanovdb_compute::dirty_range_t;
+
+TEST(NanoVDBEditor, DirtyRangeLogCollectsRangesSinceVersion)
+{
+    DirtyRangeLog log;
+    log.mark(0u, 16u);
+    const pnanovdb_uint64_t uploaded_version = log.version();
+    log.mark(64u, 128u);
+    log.mark(256u, 272u);
+
+    std::vector<dirty_range_t> ranges;
+    ASSERT_TRUE(log.collect(uploaded_version, ranges));
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[0].begin, 64u);
+    EXPECT_EQ(ranges[1].end, 272u);
+
+    ranges.clear();
+    ASSERT_TRUE(log.collect(log.version(), ranges));
+    EXPECT_TRUE(ranges.empty());
+}
+
+TEST(NanoVDBEditor, DirtyRangeLogRequestsFullUploadAfterOverflow)
+{
+    DirtyRangeLog log;
+    for (size_t idx = 0u; idx <= DirtyRangeLog::k_max_ranges; idx++)
+    {
+        log.mark(idx * 32u, idx * 32u + 4u);
+    }
+
+    std::vector<dirty_range_t> ranges;
+    EXPECT_FALSE(log.collect(0u, ranges));
+    ranges.clear();
+    EXPECT_TRUE(log.collect(log.version() - 1u, ranges));
+    EXPECT_EQ(ranges.size(), 1u);
+}
+
+TEST(NanoVDBEditor, MergeDirtyRangesAlignsJoinsAndClamps)
+{
+    std::vector<dirty_range_t> ranges = { { 4100u, 4101u }, { 3u, 10u }, { 20u, 30u }, { 9000u, 20000u } };
+    pnanovdb_uint64_t num_bytes = pnanovdb_compute::merge_dirty_ranges(ranges, 16u, 10000u, 64u);
+
+    ASSERT_EQ(ranges.size(), 3u);
+    EXPECT_EQ(ranges[0].begin, 0u);
+    EXPECT_EQ(ranges[0].end, 32u);
+    EXPECT_EQ(ranges[1].begin, 4096u);
+    EXPECT_EQ(ranges[1].end, 4112u);
+    EXPECT_EQ(ranges[2].begin, 8992u);
+    EXPECT_EQ(ranges[2].end, 10000u);
+    EXPECT_EQ(num_bytes, 32u + 16u + 1008u);
+}
+
+TEST(NanoVDBEditor, StagingRingReusesSpaceOfCompletedFrames)
+{
+    StagingRing ring(4096u);
+
+    EXPECT_EQ(ring.alloc(1024u, 1u), 0u);
+    EXPECT_EQ(ring.alloc(2048u, 1u), 1024u);
+    EXPECT_EQ(ring.alloc(1000u, 2u), 3072u);
+    // full until frame 1 completes
+    EXPECT_EQ(ring.alloc(512u, 2u), StagingRing::k_invalid);
+
+    ring.retire(1u);
+    EXPECT_EQ(ring.alloc(2048u, 3u), 0u);
+    EXPECT_EQ(ring.alloc(1024u, 3u), 2048u);
+    EXPECT_EQ(ring.alloc(256u, 3u), StagingRing::k_invalid);
+
+    ring.retire(3u);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.alloc(4096u, 4u), 0u);
+    EXPECT_EQ(ring.alloc(8192u, 4u), StagingRing::k_invalid);
+}
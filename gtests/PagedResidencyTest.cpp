@@ -0,0 +1,73 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "compute/PagedResidency.h"
+
+using pnanovdb_compute::PageResidency;
+
+TEST(NanoVDBEditor, PageResidencyRequestsMissingPagesOnce)
+{
+    PageResidency residency(8u, 2u, 3u);
+    EXPECT_TRUE(residency.touch(5u, 1u));
+    EXPECT_FALSE(residency.touch(5u, 2u));
+    EXPECT_EQ(residency.pending_page_count(), 1u);
+
+    pnanovdb_uint32_t slot = residency.alloc_slot(2u);
+    ASSERT_NE(slot, PageResidency::k_invalid);
+    residency.make_resident(5u, slot, 2u);
+    EXPECT_EQ(residency.slot(5u), slot);
+    EXPECT_EQ(residency.page_table()[5u], slot);
+    EXPECT_EQ(residency.pending_page_count(), 0u);
+    EXPECT_EQ(residency.resident_page_count(), 1u);
+    EXPECT_TRUE(residency.dirty());
+
+    residency.clear_dirty();
+    EXPECT_FALSE(residency.touch(5u, 3u));
+    EXPECT_FALSE(residency.dirty());
+}
+
+TEST(NanoVDBEditor, PageResidencyEvictsOnlyPagesUnusedForKeepFrames)
+{
+    PageResidency residency(8u, 2u, 3u);
+    for (pnanovdb_uint32_t page = 0u; page < 2u; page++)
+    {
+        residency.touch(page, 1u);
+        residency.make_resident(page, residency.alloc_slot(1u), 1u);
+    }
+    EXPECT_EQ(residency.free_slot_count(), 0u);
+
+    // both pages were used recently, a full pool keeps the load waiting
+    residency.touch(0u, 4u);
+    residency.touch(2u, 4u);
+    EXPECT_EQ(residency.alloc_slot(4u), PageResidency::k_invalid);
+
+    // page 1 was last used in frame 1, it ages out before page 0
+    pnanovdb_uint32_t slot_1 = residency.slot(1u);
+    residency.clear_dirty();
+    pnanovdb_uint32_t slot = residency.alloc_slot(5u);
+    EXPECT_EQ(slot, slot_1);
+    EXPECT_EQ(residency.slot(1u), PageResidency::k_invalid);
+    EXPECT_NE(residency.slot(0u), PageResidency::k_invalid);
+    EXPECT_EQ(residency.resident_page_count(), 1u);
+    EXPECT_TRUE(residency.dirty());
+
+    residency.make_resident(2u, slot, 5u);
+    EXPECT_EQ(residency.slot(2u), slot_1);
+    EXPECT_EQ(residency.pending_page_count(), 0u);
+
+    // an evicted page is requested again the next time it is touched
+    EXPECT_TRUE(residency.touch(1u, 6u));
+}
+
+TEST(NanoVDBEditor, PageResidencyReturnsUnusedSlots)
+{
+    PageResidency residency(4u, 1u, 3u);
+    pnanovdb_uint32_t slot = residency.alloc_slot(1u);
+    ASSERT_NE(slot, PageResidency::k_invalid);
+    EXPECT_EQ(residency.free_slot_count(), 0u);
+    residency.free_slot(slot);
+    EXPECT_EQ(residency.free_slot_count(), 1u);
+    EXPECT_EQ(residency.alloc_slot(1u), slot);
+}
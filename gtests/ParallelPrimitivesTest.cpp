@@ -0,0 +1,599 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   gtests/ParallelPrimitivesTest.cpp
+
+    \brief
+*/
+
+#include <gtest/gtest.h>
+
+#include <nanovdb_editor/putil/Compiler.h>
+#include <nanovdb_editor/putil/Compute.h>
+#include <nanovdb_editor/putil/ParallelPrimitives.h>
+
+#include "raster/CpuParallelPrimitives.h"
+
+#include "GpuTestSupport.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// words of a device buffer, uploaded before the dispatch and read back after it
+struct words_t
+{
+    std::vector<uint32_t> words;
+    uint32_t structure_stride = 4u;
+};
+
+typedef std::function<void(pnanovdb_compute_buffer_t* const* buffers)> dispatch_t;
+
+typedef std::function<void(pnanovdb_compute_queue_t* queue,
+                           pnanovdb_parallel_primitives_context_t* context,
+                           pnanovdb_compute_array_t* const* arrays)>
+    array_entry_t;
+
+pnanovdb_util::WorkStealingPool& host_pool()
+{
+    static pnanovdb_util::WorkStealingPool pool;
+    return pool;
+}
+
+// Compiler / compute / device / parallel primitives fixture. init() returns false
+// when no Vulkan device is available so the caller can GTEST_SKIP.
+struct ParallelPrimitivesRuntime
+{
+    pnanovdb_compiler_t compiler{};
+    pnanovdb_compute_t compute{};
+    pnanovdb_compute_device_manager_t* device_manager = nullptr;
+    pnanovdb_compute_device_t* device = nullptr;
+    pnanovdb_compute_queue_t* queue = nullptr;
+    pnanovdb_parallel_primitives_t parallel_primitives{};
+    pnanovdb_parallel_primitives_context_t* parallel_primitives_ctx = nullptr;
+    pnanovdb_parallel_primitives_context_t* host_ctx = nullptr;
+    bool software_renderer = false;
+    std::string device_name;
+
+    bool init()
+    {
+        pnanovdb_compiler_load(&compiler);
+        if (!compiler.module)
+        {
+            ADD_FAILURE() << "Compiler module not available";
+            return false;
+        }
+        pnanovdb_compute_load(&compute, &compiler);
+        if (!compute.module)
+        {
+            ADD_FAILURE() << "Compute module not available";
+            return false;
+        }
+        device_manager = compute.device_interface.create_device_manager(PNANOVDB_FALSE);
+        if (!device_manager)
+        {
+            ADD_FAILURE() << "Failed to create device manager";
+            return false;
+        }
+        pnanovdb_compute_physical_device_desc_t phys_desc{};
+        if (!compute.device_interface.enumerate_devices(device_manager, 0u, &phys_desc))
+        {
+            return false;
+        }
+        device_name = phys_desc.device_name;
+        if (pnanovdb_editor_test::should_skip_on_software_renderer(phys_desc.device_name))
+        {
+            software_renderer = true;
+            return false;
+        }
+        pnanovdb_compute_device_desc_t device_desc{};
+        device_desc.log_print = pnanovdb_editor_test::stderr_log_print;
+        device = compute.device_interface.create_device(device_manager, &device_desc);
+        if (!device)
+        {
+            ADD_FAILURE() << "Failed to create compute device";
+            return false;
+        }
+        queue = compute.device_interface.get_compute_queue(device);
+        if (!queue)
+        {
+            ADD_FAILURE() << "Failed to acquire compute queue";
+            return false;
+        }
+        pnanovdb_parallel_primitives_load(&parallel_primitives, &compute);
+        if (!parallel_primitives.create_context || !parallel_primitives.run_length_encode_key64)
+        {
+            ADD_FAILURE() << "parallel primitives interface not loaded";
+            return false;
+        }
+        parallel_primitives_ctx = parallel_primitives.create_context(&compute, queue);
+        if (!parallel_primitives_ctx)
+        {
+            ADD_FAILURE() << "Failed to create parallel primitives context";
+            return false;
+        }
+        host_ctx = parallel_primitives.create_context(&compute, nullptr);
+        if (!host_ctx)
+        {
+            ADD_FAILURE() << "Failed to create host parallel primitives context";
+            return false;
+        }
+        return true;
+    }
+
+    // uploads every buffer, runs the dispatch on the device copies and reads all of them back in place
+    void run(std::vector<words_t>& buffers, const dispatch_t& dispatch)
+    {
+        pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+        std::vector<pnanovdb_compute_buffer_t*> upload_buffers(buffers.size());
+        std::vector<pnanovdb_compute_buffer_t*> device_buffers(buffers.size());
+        std::vector<pnanovdb_compute_buffer_t*> readback_buffers(buffers.size());
+        for (size_t buffer_idx = 0u; buffer_idx < buffers.size(); buffer_idx++)
+        {
+            // never create an empty buffer, an empty input still gets a count
+            std::vector<uint32_t>& words = buffers[buffer_idx].words;
+            const uint64_t size_in_bytes = 4u * (words.empty() ? 2u : words.size());
+
+            pnanovdb_compute_buffer_desc_t buf_desc = {};
+            buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+            buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+            buf_desc.size_in_bytes = size_in_bytes;
+            upload_buffers[buffer_idx] =
+                compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+            buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
+                             PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+            buf_desc.structure_stride = buffers[buffer_idx].structure_stride;
+            device_buffers[buffer_idx] =
+                compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+            buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+            buf_desc.structure_stride = 0u;
+            readback_buffers[buffer_idx] =
+                compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+
+            uint32_t* mapped = (uint32_t*)compute_interface->map_buffer(context, upload_buffers[buffer_idx]);
+            memset(mapped, 0, size_in_bytes);
+            memcpy(mapped, words.data(), 4u * words.size());
+            compute_interface->unmap_buffer(context, upload_buffers[buffer_idx]);
+
+            pnanovdb_compute_copy_buffer_params_t copy_params = {};
+            copy_params.num_bytes = size_in_bytes;
+            copy_params.src = compute_interface->register_buffer_as_transient(context, upload_buffers[buffer_idx]);
+            copy_params.dst = compute_interface->register_buffer_as_transient(context, device_buffers[buffer_idx]);
+            copy_params.debug_label = "parallel_primitives_test_upload";
+            compute_interface->copy_buffer(context, &copy_params);
+        }
+
+        dispatch(device_buffers.data());
+
+        for (size_t buffer_idx = 0u; buffer_idx < buffers.size(); buffer_idx++)
+        {
+            pnanovdb_compute_copy_buffer_params_t copy_params = {};
+            copy_params.num_bytes = 4u * (buffers[buffer_idx].words.empty() ? 2u : buffers[buffer_idx].words.size());
+            copy_params.src = compute_interface->register_buffer_as_transient(context, device_buffers[buffer_idx]);
+            copy_params.dst = compute_interface->register_buffer_as_transient(context, readback_buffers[buffer_idx]);
+            copy_params.debug_label = "parallel_primitives_test_readback";
+            compute_interface->copy_buffer(context, &copy_params);
+        }
+
+        pnanovdb_uint64_t flushed_frame = 0llu;
+        compute.device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+        compute.device_interface.wait_idle(queue);
+
+        for (size_t buffer_idx = 0u; buffer_idx < buffers.size(); buffer_idx++)
+        {
+            std::vector<uint32_t>& words = buffers[buffer_idx].words;
+            uint32_t* mapped = (uint32_t*)compute_interface->map_buffer(context, readback_buffers[buffer_idx]);
+            memcpy(words.data(), mapped, 4u * words.size());
+            compute_interface->unmap_buffer(context, readback_buffers[buffer_idx]);
+
+            compute_interface->destroy_buffer(context, upload_buffers[buffer_idx]);
+            compute_interface->destroy_buffer(context, device_buffers[buffer_idx]);
+            compute_interface->destroy_buffer(context, readback_buffers[buffer_idx]);
+        }
+    }
+
+    // copies words into host arrays, runs the array entry point on the device context or on the host context and
+    // returns the contents of all arrays
+    std::vector<std::vector<uint32_t>> run_arrays(const std::vector<std::vector<uint32_t>>& words,
+                                                  bool on_device,
+                                                  const array_entry_t& entry)
+    {
+        std::vector<pnanovdb_compute_array_t*> arrays(words.size());
+        for (size_t array_idx = 0u; array_idx < words.size(); array_idx++)
+        {
+            arrays[array_idx] = compute.create_array(4u, words[array_idx].size(), words[array_idx].data());
+        }
+
+        entry(on_device ? queue : nullptr, on_device ? parallel_primitives_ctx : host_ctx, arrays.data());
+
+        std::vector<std::vector<uint32_t>> results(words.size());
+        for (size_t array_idx = 0u; array_idx < words.size(); array_idx++)
+        {
+            const uint32_t* mapped = (const uint32_t*)compute.map_array(arrays[array_idx]);
+            results[array_idx].assign(mapped, mapped + words[array_idx].size());
+            compute.unmap_array(arrays[array_idx]);
+            compute.destroy_array(arrays[array_idx]);
+        }
+        return results;
+    }
+
+    ~ParallelPrimitivesRuntime()
+    {
+        if (host_ctx)
+            parallel_primitives.destroy_context(&compute, nullptr, host_ctx);
+        if (parallel_primitives_ctx)
+            parallel_primitives.destroy_context(&compute, queue, parallel_primitives_ctx);
+        if (device)
+            compute.device_interface.destroy_device(device_manager, device);
+        if (device_manager)
+            compute.device_interface.destroy_device_manager(device_manager);
+        if (compute.module)
+            pnanovdb_compute_free(&compute);
+        if (compiler.module)
+            pnanovdb_compiler_free(&compiler);
+    }
+};
+
+// head flags with segments of random length up to max_segment_length
+std::vector<uint32_t> random_head_flags(std::mt19937& rng, size_t count, uint32_t max_segment_length)
+{
+    std::vector<uint32_t> flags(count, 0u);
+    size_t idx = 0u;
+    while (idx < count)
+    {
+        flags[idx] = 1u;
+        idx += 1u + rng() % max_segment_length;
+    }
+    return flags;
+}
+
+} // namespace
+
+class ParallelPrimitivesTest : public ::testing::Test
+{
+protected:
+    static ParallelPrimitivesRuntime* s_rt;
+    static bool s_device_unavailable;
+    static bool s_software_renderer;
+    static std::string s_software_renderer_name;
+
+    static void SetUpTestSuite()
+    {
+        s_rt = new ParallelPrimitivesRuntime();
+        if (!s_rt->init())
+        {
+            s_device_unavailable = (!s_rt->device_manager || !s_rt->device);
+            s_software_renderer = s_rt->software_renderer;
+            if (s_software_renderer)
+            {
+                s_software_renderer_name = s_rt->device_name;
+            }
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        delete s_rt;
+        s_rt = nullptr;
+    }
+
+    void SetUp() override
+    {
+        if (s_software_renderer)
+        {
+            GTEST_SKIP() << pnanovdb_editor_test::software_renderer_skip_reason(
+                s_software_renderer_name.c_str(), "parallel primitives tests");
+        }
+        if (s_device_unavailable)
+        {
+            GTEST_SKIP() << "No Vulkan-compatible device available on this machine";
+        }
+        ASSERT_NE(s_rt, nullptr) << "ParallelPrimitivesRuntime failed to initialize";
+        ASSERT_NE(s_rt->parallel_primitives_ctx, nullptr) << "ParallelPrimitivesRuntime failed to initialize";
+    }
+
+    ParallelPrimitivesRuntime& rt()
+    {
+        return *s_rt;
+    }
+
+    // the host backend has to reproduce every word the device writes
+    void expect_host_matches_device(const char* name,
+                                    const std::vector<std::vector<uint32_t>>& words,
+                                    const array_entry_t& entry)
+    {
+        std::vector<std::vector<uint32_t>> device_results = rt().run_arrays(words, true, entry);
+        std::vector<std::vector<uint32_t>> host_results = rt().run_arrays(words, false, entry);
+        for (size_t array_idx = 0u; array_idx < words.size(); array_idx++)
+        {
+            EXPECT_EQ(host_results[array_idx], device_results[array_idx]) << name << " array " << array_idx;
+        }
+    }
+};
+
+ParallelPrimitivesRuntime* ParallelPrimitivesTest::s_rt = nullptr;
+bool ParallelPrimitivesTest::s_device_unavailable = false;
+bool ParallelPrimitivesTest::s_software_renderer = false;
+std::string ParallelPrimitivesTest::s_software_renderer_name;
+
+TEST_F(ParallelPrimitivesTest, SegmentedScanMatchesHost)
+{
+    // workgroup and scan2 pass boundaries, and segments that span workgroups
+    std::mt19937 rng(17u);
+    for (uint32_t val_count : { 1u, 1023u, 1024u, 1025u, 1048577u })
+    {
+        for (uint32_t max_segment_length : { 3u, 5000u })
+        {
+            std::vector<words_t> buffers(3u);
+            buffers[0u].words.resize(val_count);
+            for (uint32_t& val : buffers[0u].words)
+            {
+                val = rng() & 0xFFFFu;
+            }
+            buffers[1u].words = random_head_flags(rng, val_count, max_segment_length);
+            buffers[2u].words.resize(val_count);
+
+            std::vector<uint32_t> expected(val_count);
+            pnanovdb_raster::cpu_segmented_scan(
+                host_pool(), buffers[0u].words.data(), buffers[1u].words.data(), expected.data(), val_count);
+
+            rt().run(buffers,
+                     [&](pnanovdb_compute_buffer_t* const* device_buffers)
+                     {
+                         rt().parallel_primitives.segmented_scan(&rt().compute, rt().queue,
+                                                                 rt().parallel_primitives_ctx, device_buffers[0u],
+                                                                 device_buffers[1u], device_buffers[2u], val_count);
+                     });
+            EXPECT_EQ(buffers[2u].words, expected) << val_count << " values, segments up to " << max_segment_length;
+        }
+    }
+}
+
+TEST_F(ParallelPrimitivesTest, SegmentedRadixSortMatchesHost)
+{
+    std::mt19937 rng(19u);
+    for (uint32_t key_count : { 1u, 4099u, 70001u })
+    {
+        for (uint32_t key_bit_count : { 8u, 32u })
+        {
+            std::vector<words_t> buffers(3u);
+            buffers[0u].words.resize(key_count);
+            buffers[1u].words.resize(key_count);
+            for (uint32_t idx = 0u; idx < key_count; idx++)
+            {
+                buffers[0u].words[idx] = rng();
+                buffers[1u].words[idx] = idx;
+            }
+            buffers[2u].words = random_head_flags(rng, key_count, 300u);
+
+            std::vector<uint32_t> expected_keys = buffers[0u].words;
+            std::vector<uint32_t> expected_vals = buffers[1u].words;
+            pnanovdb_raster::cpu_segmented_radix_sort(host_pool(), expected_keys.data(), expected_vals.data(),
+                                                      buffers[2u].words.data(), key_count, key_bit_count);
+
+            rt().run(buffers,
+                     [&](pnanovdb_compute_buffer_t* const* device_buffers)
+                     {
+                         rt().parallel_primitives.segmented_radix_sort(
+                             &rt().compute, rt().queue, rt().parallel_primitives_ctx, device_buffers[0u],
+                             device_buffers[1u], device_buffers[2u], key_count, key_count, key_bit_count);
+                     });
+            EXPECT_EQ(buffers[0u].words, expected_keys) << key_count << " keys, " << key_bit_count << " bits";
+            EXPECT_EQ(buffers[1u].words, expected_vals) << key_count << " keys, " << key_bit_count << " bits";
+        }
+    }
+}
+
+TEST_F(ParallelPrimitivesTest, SelectAndPartitionMatchHost)
+{
+    std::mt19937 rng(23u);
+    for (uint32_t val_count : { 0u, 1u, 1024u, 1025u, 300007u })
+    {
+        for (bool partition : { false, true })
+        {
+            std::vector<words_t> buffers(4u);
+            buffers[0u].words.resize(val_count);
+            buffers[1u].words.resize(val_count);
+            for (uint32_t idx = 0u; idx < val_count; idx++)
+            {
+                buffers[0u].words[idx] = rng();
+                buffers[1u].words[idx] = (rng() % 3u == 0u) ? (rng() | 1u) : 0u;
+            }
+            buffers[2u].words.resize(val_count);
+            buffers[3u].words.assign(1u, ~0u);
+
+            std::vector<uint32_t> expected(val_count);
+            uint64_t selected_count = pnanovdb_raster::cpu_select(host_pool(), buffers[0u].words.data(),
+                                                                  buffers[1u].words.data(), expected.data(), val_count,
+                                                                  partition);
+
+            rt().run(buffers,
+                     [&](pnanovdb_compute_buffer_t* const* device_buffers)
+                     {
+                         auto select = partition ? rt().parallel_primitives.partition :
+                                                   rt().parallel_primitives.select_if;
+                         select(&rt().compute, rt().queue, rt().parallel_primitives_ctx, device_buffers[0u],
+                                device_buffers[1u], device_buffers[2u], device_buffers[3u], val_count);
+                     });
+
+            // select_if leaves the tail of val_out untouched
+            if (!partition)
+            {
+                buffers[2u].words.resize(selected_count);
+                expected.resize(selected_count);
+            }
+            EXPECT_EQ(buffers[3u].words[0u], selected_count) << val_count << " values";
+            EXPECT_EQ(buffers[2u].words, expected) << val_count << " values, partition " << partition;
+        }
+    }
+}
+
+TEST_F(ParallelPrimitivesTest, RunLengthEncodeMatchesHost)
+{
+    std::mt19937 rng(29u);
+    for (uint32_t key_count : { 0u, 1u, 1024u, 1025u, 250003u })
+    {
+        // sorted keys with runs of random length, the range buffer starts dirty to check the clearing
+        std::vector<uint64_t> keys(key_count);
+        uint64_t key = 0x100000000llu;
+        for (uint64_t& run_key : keys)
+        {
+            key += (rng() % 7u == 0u) ? (1llu << (rng() % 40u)) : 0u;
+            run_key = key;
+        }
+
+        std::vector<uint32_t> expected(2u * key_count);
+        uint64_t run_count =
+            pnanovdb_raster::cpu_run_length_encode(host_pool(), keys.data(), expected.data(), key_count);
+        std::vector<uint32_t> expected32(2u * key_count);
+        std::vector<uint32_t> keys32(key_count);
+        for (uint32_t idx = 0u; idx < key_count; idx++)
+        {
+            keys32[idx] = uint32_t(keys[idx] >> 8u);
+        }
+        uint64_t run_count32 =
+            pnanovdb_raster::cpu_run_length_encode(host_pool(), keys32.data(), expected32.data(), key_count);
+
+        for (bool key64 : { false, true })
+        {
+            std::vector<words_t> buffers(3u);
+            if (key64)
+            {
+                buffers[0u].words.resize(2u * key_count);
+                memcpy(buffers[0u].words.data(), keys.data(), 8u * key_count);
+                buffers[0u].structure_stride = 8u;
+            }
+            else
+            {
+                buffers[0u].words = keys32;
+            }
+            buffers[1u].words.assign(2u * key_count, ~0u);
+            buffers[2u].words.assign(1u, ~0u);
+
+            rt().run(buffers,
+                     [&](pnanovdb_compute_buffer_t* const* device_buffers)
+                     {
+                         auto encode = key64 ? rt().parallel_primitives.run_length_encode_key64 :
+                                               rt().parallel_primitives.run_length_encode;
+                         encode(&rt().compute, rt().queue, rt().parallel_primitives_ctx, device_buffers[0u],
+                                device_buffers[1u], device_buffers[2u], key_count);
+                     });
+            EXPECT_EQ(buffers[2u].words[0u], key64 ? run_count : run_count32) << key_count << " keys";
+            EXPECT_EQ(buffers[1u].words, key64 ? expected : expected32) << key_count << " keys, key64 " << key64;
+        }
+    }
+}
+
+TEST_F(ParallelPrimitivesTest, HostContextMatchesDeviceBitExact)
+{
+    const uint32_t count = 100003u;
+    std::mt19937 rng(31u);
+    auto random_words = [&](size_t word_count, uint32_t mask)
+    {
+        std::vector<uint32_t> words(word_count);
+        for (uint32_t& word : words)
+        {
+            word = rng() & mask;
+        }
+        return words;
+    };
+    std::vector<uint32_t> vals = random_words(count, ~0u);
+    std::vector<uint32_t> vals64 = random_words(2u * count, ~0u);
+    std::vector<uint32_t> flags = random_head_flags(rng, count, 700u);
+    std::vector<uint32_t> select_flags = random_words(count, 0x10001u);
+    std::vector<uint32_t> zeros(count, 0u);
+    std::vector<uint32_t> count_word(1u, 0u);
+
+    // sorted keys with runs, for run length encoding
+    std::vector<uint32_t> run_keys = random_words(count, 0xFFFu);
+    std::sort(run_keys.begin(), run_keys.end());
+    std::vector<uint32_t> run_keys64(2u * count);
+    for (uint32_t idx = 0u; idx < count; idx++)
+    {
+        run_keys64[2u * idx + 0u] = run_keys[idx] * 0x9E3779B9u;
+        run_keys64[2u * idx + 1u] = run_keys[idx] >> 4u;
+    }
+    std::vector<uint32_t> range_words(2u * count, ~0u);
+    std::vector<uint32_t> indices(count);
+    for (uint32_t idx = 0u; idx < count; idx++)
+    {
+        indices[idx] = idx;
+    }
+
+    pnanovdb_parallel_primitives_t& pp = rt().parallel_primitives;
+    const pnanovdb_compute_t* compute = &rt().compute;
+
+    expect_host_matches_device("global_scan", { vals, zeros },
+                               [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+                                   pnanovdb_compute_array_t* const* arrays)
+                               { pp.global_scan_array(compute, queue, ctx, arrays[0u], arrays[1u], count); });
+    expect_host_matches_device("global_scan_uint64", { vals64, std::vector<uint32_t>(2u * count, 0u) },
+                               [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+                                   pnanovdb_compute_array_t* const* arrays)
+                               { pp.global_scan_uint64_array(compute, queue, ctx, arrays[0u], arrays[1u], count); });
+    expect_host_matches_device("global_scan_max", { vals, zeros },
+                               [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+                                   pnanovdb_compute_array_t* const* arrays)
+                               { pp.global_scan_max_array(compute, queue, ctx, arrays[0u], arrays[1u], count); });
+    for (uint32_t key_bit_count : { 32u, 12u })
+    {
+        expect_host_matches_device(
+            "radix_sort", { vals, indices },
+            [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+                pnanovdb_compute_array_t* const* arrays)
+            { pp.radix_sort_array(compute, queue, ctx, arrays[0u], arrays[1u], count, key_bit_count); });
+    }
+    expect_host_matches_device(
+        "radix_sort_key64", { vals64, indices },
+        [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+            pnanovdb_compute_array_t* const* arrays)
+        { pp.radix_sort_key64_array(compute, queue, ctx, arrays[0u], arrays[1u], count, 64u); });
+    expect_host_matches_device(
+        "radix_sort_dual_key", { vals, random_words(count, ~0u), indices },
+        [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+            pnanovdb_compute_array_t* const* arrays)
+        { pp.radix_sort_dual_key_array(compute, queue, ctx, arrays[0u], arrays[1u], arrays[2u], count, 20u, 3u); });
+    expect_host_matches_device(
+        "segmented_scan", { vals, flags, zeros },
+        [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+            pnanovdb_compute_array_t* const* arrays)
+        { pp.segmented_scan_array(compute, queue, ctx, arrays[0u], arrays[1u], arrays[2u], count); });
+    expect_host_matches_device(
+        "segmented_radix_sort", { vals, indices, flags },
+        [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+            pnanovdb_compute_array_t* const* arrays)
+        { pp.segmented_radix_sort_array(compute, queue, ctx, arrays[0u], arrays[1u], arrays[2u], count, 16u); });
+    for (bool partition : { false, true })
+    {
+        expect_host_matches_device(partition ? "partition" : "select_if", { vals, select_flags, zeros, count_word },
+                                   [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+                                       pnanovdb_compute_array_t* const* arrays)
+                                   {
+                                       auto select = partition ? pp.partition_array : pp.select_if_array;
+                                       select(compute, queue, ctx, arrays[0u], arrays[1u], arrays[2u], arrays[3u],
+                                              count);
+                                   });
+    }
+    expect_host_matches_device(
+        "run_length_encode", { run_keys, range_words, count_word },
+        [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+            pnanovdb_compute_array_t* const* arrays)
+        { pp.run_length_encode_array(compute, queue, ctx, arrays[0u], arrays[1u], arrays[2u], count); });
+    expect_host_matches_device(
+        "run_length_encode_key64", { run_keys64, range_words, count_word },
+        [&](pnanovdb_compute_queue_t* queue, pnanovdb_parallel_primitives_context_t* ctx,
+            pnanovdb_compute_array_t* const* arrays)
+        { pp.run_length_encode_key64_array(compute, queue, ctx, arrays[0u], arrays[1u], arrays[2u], count); });
+}
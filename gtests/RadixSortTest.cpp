@@ -0,0 +1,402 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   gtests/RadixSortTest.cpp
+
+    \brief
+*/
+
+#include <gtest/gtest.h>
+
+#include <nanovdb_editor/putil/Compiler.h>
+#include <nanovdb_editor/putil/Compute.h>
+#include <nanovdb_editor/putil/ParallelPrimitives.h>
+
+#include "GpuTestSupport.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct sorted_t
+{
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> vals;
+};
+
+// stable sort by the key bits below key_bit_count, values are the input indices
+sorted_t reference_sort(const std::vector<uint64_t>& keys, uint32_t key_bit_count)
+{
+    const uint64_t key_mask = key_bit_count >= 64u ? ~0llu : ((1llu << key_bit_count) - 1u);
+    sorted_t sorted;
+    sorted.vals.resize(keys.size());
+    for (uint32_t idx = 0u; idx < keys.size(); idx++)
+    {
+        sorted.vals[idx] = idx;
+    }
+    std::stable_sort(sorted.vals.begin(), sorted.vals.end(),
+                     [&](uint32_t a, uint32_t b) { return (keys[a] & key_mask) < (keys[b] & key_mask); });
+    sorted.keys.resize(keys.size());
+    for (size_t idx = 0u; idx < keys.size(); idx++)
+    {
+        sorted.keys[idx] = keys[sorted.vals[idx]];
+    }
+    return sorted;
+}
+
+// Compiler / compute / device / parallel primitives fixture. init() returns false
+// when no Vulkan device is available so the caller can GTEST_SKIP.
+struct RadixSortRuntime
+{
+    pnanovdb_compiler_t compiler{};
+    pnanovdb_compute_t compute{};
+    pnanovdb_compute_device_manager_t* device_manager = nullptr;
+    pnanovdb_compute_device_t* device = nullptr;
+    pnanovdb_compute_queue_t* queue = nullptr;
+    pnanovdb_parallel_primitives_t parallel_primitives{};
+    pnanovdb_parallel_primitives_context_t* parallel_primitives_ctx = nullptr;
+    bool software_renderer = false;
+    std::string device_name;
+
+    bool init()
+    {
+        pnanovdb_compiler_load(&compiler);
+        if (!compiler.module)
+        {
+            ADD_FAILURE() << "Compiler module not available";
+            return false;
+        }
+        pnanovdb_compute_load(&compute, &compiler);
+        if (!compute.module)
+        {
+            ADD_FAILURE() << "Compute module not available";
+            return false;
+        }
+        device_manager = compute.device_interface.create_device_manager(PNANOVDB_FALSE);
+        if (!device_manager)
+        {
+            ADD_FAILURE() << "Failed to create device manager";
+            return false;
+        }
+        pnanovdb_compute_physical_device_desc_t phys_desc{};
+        if (!compute.device_interface.enumerate_devices(device_manager, 0u, &phys_desc))
+        {
+            return false;
+        }
+        device_name = phys_desc.device_name;
+        if (pnanovdb_editor_test::should_skip_on_software_renderer(phys_desc.device_name))
+        {
+            software_renderer = true;
+            return false;
+        }
+        pnanovdb_compute_device_desc_t device_desc{};
+        device_desc.log_print = pnanovdb_editor_test::stderr_log_print;
+        device = compute.device_interface.create_device(device_manager, &device_desc);
+        if (!device)
+        {
+            ADD_FAILURE() << "Failed to create compute device";
+            return false;
+        }
+        queue = compute.device_interface.get_compute_queue(device);
+        if (!queue)
+        {
+            ADD_FAILURE() << "Failed to acquire compute queue";
+            return false;
+        }
+        pnanovdb_parallel_primitives_load(&parallel_primitives, &compute);
+        if (!parallel_primitives.create_context || !parallel_primitives.set_radix_sort_mode)
+        {
+            ADD_FAILURE() << "parallel primitives interface not loaded";
+            return false;
+        }
+        parallel_primitives_ctx = parallel_primitives.create_context(&compute, queue);
+        if (!parallel_primitives_ctx)
+        {
+            ADD_FAILURE() << "Failed to create parallel primitives context";
+            return false;
+        }
+        return true;
+    }
+
+    // uploads keys with their indices as values, sorts on the GPU and reads both back
+    sorted_t sort(const std::vector<uint64_t>& keys, bool key64, uint32_t key_bit_count, pnanovdb_uint32_t mode)
+    {
+        pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+        const uint64_t key_count = keys.size();
+        const uint32_t key_size = key64 ? 8u : 4u;
+        const uint64_t key_bytes = key_size * key_count;
+        const uint64_t val_bytes = 4u * key_count;
+
+        pnanovdb_compute_buffer_desc_t buf_desc = {};
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+        buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+        buf_desc.size_in_bytes = key_bytes;
+        pnanovdb_compute_buffer_t* key_upload =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+        buf_desc.size_in_bytes = val_bytes;
+        pnanovdb_compute_buffer_t* val_upload =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
+                         PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+        buf_desc.structure_stride = key_size;
+        buf_desc.size_in_bytes = key_bytes;
+        pnanovdb_compute_buffer_t* key_device =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+        buf_desc.structure_stride = 4u;
+        buf_desc.size_in_bytes = val_bytes;
+        pnanovdb_compute_buffer_t* val_device =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+        buf_desc.structure_stride = 0u;
+        buf_desc.size_in_bytes = key_bytes;
+        pnanovdb_compute_buffer_t* key_readback =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+        buf_desc.size_in_bytes = val_bytes;
+        pnanovdb_compute_buffer_t* val_readback =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+
+        uint8_t* mapped_keys = (uint8_t*)compute_interface->map_buffer(context, key_upload);
+        uint32_t* mapped_vals = (uint32_t*)compute_interface->map_buffer(context, val_upload);
+        for (uint64_t idx = 0u; idx < key_count; idx++)
+        {
+            uint32_t key32 = uint32_t(keys[idx]);
+            memcpy(mapped_keys + key_size * idx, key64 ? (const void*)&keys[idx] : (const void*)&key32, key_size);
+            mapped_vals[idx] = uint32_t(idx);
+        }
+        compute_interface->unmap_buffer(context, key_upload);
+        compute_interface->unmap_buffer(context, val_upload);
+
+        pnanovdb_compute_copy_buffer_params_t copy_params = {};
+        copy_params.num_bytes = key_bytes;
+        copy_params.src = compute_interface->register_buffer_as_transient(context, key_upload);
+        copy_params.dst = compute_interface->register_buffer_as_transient(context, key_device);
+        copy_params.debug_label = "radix_sort_test_upload_key";
+        compute_interface->copy_buffer(context, &copy_params);
+        copy_params.num_bytes = val_bytes;
+        copy_params.src = compute_interface->register_buffer_as_transient(context, val_upload);
+        copy_params.dst = compute_interface->register_buffer_as_transient(context, val_device);
+        copy_params.debug_label = "radix_sort_test_upload_val";
+        compute_interface->copy_buffer(context, &copy_params);
+
+        parallel_primitives.set_radix_sort_mode(parallel_primitives_ctx, mode);
+        if (key64)
+        {
+            parallel_primitives.radix_sort_key64(&compute, queue, parallel_primitives_ctx, key_device, val_device,
+                                                 key_count, key_count, key_bit_count);
+        }
+        else
+        {
+            parallel_primitives.radix_sort(
+                &compute, queue, parallel_primitives_ctx, key_device, val_device, key_count, key_count, key_bit_count);
+        }
+        parallel_primitives.set_radix_sort_mode(parallel_primitives_ctx,
+                                                PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_AUTO);
+
+        copy_params.num_bytes = key_bytes;
+        copy_params.src = compute_interface->register_buffer_as_transient(context, key_device);
+        copy_params.dst = compute_interface->register_buffer_as_transient(context, key_readback);
+        copy_params.debug_label = "radix_sort_test_readback_key";
+        compute_interface->copy_buffer(context, &copy_params);
+        copy_params.num_bytes = val_bytes;
+        copy_params.src = compute_interface->register_buffer_as_transient(context, val_device);
+        copy_params.dst = compute_interface->register_buffer_as_transient(context, val_readback);
+        copy_params.debug_label = "radix_sort_test_readback_val";
+        compute_interface->copy_buffer(context, &copy_params);
+
+        pnanovdb_uint64_t flushed_frame = 0llu;
+        compute.device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+        compute.device_interface.wait_idle(queue);
+
+        sorted_t sorted;
+        sorted.keys.resize(key_count);
+        sorted.vals.resize(key_count);
+        mapped_keys = (uint8_t*)compute_interface->map_buffer(context, key_readback);
+        for (uint64_t idx = 0u; idx < key_count; idx++)
+        {
+            uint64_t key64_val = 0u;
+            uint32_t key32_val = 0u;
+            memcpy(key64 ? (void*)&key64_val : (void*)&key32_val, mapped_keys + key_size * idx, key_size);
+            sorted.keys[idx] = key64 ? key64_val : key32_val;
+        }
+        compute_interface->unmap_buffer(context, key_readback);
+        mapped_vals = (uint32_t*)compute_interface->map_buffer(context, val_readback);
+        memcpy(sorted.vals.data(), mapped_vals, val_bytes);
+        compute_interface->unmap_buffer(context, val_readback);
+
+        compute_interface->destroy_buffer(context, key_upload);
+        compute_interface->destroy_buffer(context, val_upload);
+        compute_interface->destroy_buffer(context, key_device);
+        compute_interface->destroy_buffer(context, val_device);
+        compute_interface->destroy_buffer(context, key_readback);
+        compute_interface->destroy_buffer(context, val_readback);
+        return sorted;
+    }
+
+    ~RadixSortRuntime()
+    {
+        if (parallel_primitives_ctx)
+            parallel_primitives.destroy_context(&compute, queue, parallel_primitives_ctx);
+        if (device)
+            compute.device_interface.destroy_device(device_manager, device);
+        if (device_manager)
+            compute.device_interface.destroy_device_manager(device_manager);
+        if (compute.module)
+            pnanovdb_compute_free(&compute);
+        if (compiler.module)
+            pnanovdb_compiler_free(&compiler);
+    }
+};
+
+} // namespace
+
+class RadixSortTest : public ::testing::Test
+{
+protected:
+    static RadixSortRuntime* s_rt;
+    static bool s_device_unavailable;
+    static bool s_software_renderer;
+    static std::string s_software_renderer_name;
+
+    static void SetUpTestSuite()
+    {
+        s_rt = new RadixSortRuntime();
+        if (!s_rt->init())
+        {
+            s_device_unavailable = (!s_rt->device_manager || !s_rt->device);
+            s_software_renderer = s_rt->software_renderer;
+            if (s_software_renderer)
+            {
+                s_software_renderer_name = s_rt->device_name;
+            }
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        delete s_rt;
+        s_rt = nullptr;
+    }
+
+    void SetUp() override
+    {
+        if (s_software_renderer)
+        {
+            GTEST_SKIP() << pnanovdb_editor_test::software_renderer_skip_reason(
+                s_software_renderer_name.c_str(), "radix sort tests");
+        }
+        if (s_device_unavailable)
+        {
+            GTEST_SKIP() << "No Vulkan-compatible device available on this machine";
+        }
+        ASSERT_NE(s_rt, nullptr) << "RadixSortRuntime failed to initialize";
+        ASSERT_NE(s_rt->parallel_primitives_ctx, nullptr) << "RadixSortRuntime failed to initialize";
+    }
+
+    RadixSortRuntime& rt()
+    {
+        return *s_rt;
+    }
+
+    void expect_sorted(const std::vector<uint64_t>& keys, bool key64, uint32_t key_bit_count, pnanovdb_uint32_t mode)
+    {
+        sorted_t expected = reference_sort(keys, key_bit_count);
+        sorted_t sorted = rt().sort(keys, key64, key_bit_count, mode);
+        EXPECT_EQ(sorted.keys, expected.keys) << keys.size() << " keys, " << key_bit_count << " bits, mode " << mode;
+        EXPECT_EQ(sorted.vals, expected.vals) << keys.size() << " keys, " << key_bit_count << " bits, mode " << mode;
+    }
+};
+
+RadixSortRuntime* RadixSortTest::s_rt = nullptr;
+bool RadixSortTest::s_device_unavailable = false;
+bool RadixSortTest::s_software_renderer = false;
+std::string RadixSortTest::s_software_renderer_name;
+
+TEST_F(RadixSortTest, OnesweepMatchesStableSort)
+{
+    // partition boundaries and a partial last partition
+    std::mt19937 rng(3u);
+    for (uint32_t key_count : { 1u, 2047u, 2048u, 2049u, 100037u })
+    {
+        std::vector<uint64_t> keys(key_count);
+        for (uint64_t& key : keys)
+        {
+            key = rng();
+        }
+        expect_sorted(keys, false, 32u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+    }
+}
+
+TEST_F(RadixSortTest, OnesweepMatchesMultiPass)
+{
+    std::mt19937 rng(5u);
+    std::vector<uint64_t> keys(70000u);
+    for (uint64_t& key : keys)
+    {
+        key = rng() & 0xFFFFFu;
+    }
+    sorted_t multi_pass = rt().sort(keys, false, 20u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_MULTI_PASS);
+    sorted_t onesweep = rt().sort(keys, false, 20u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+    EXPECT_EQ(onesweep.keys, multi_pass.keys);
+    EXPECT_EQ(onesweep.vals, multi_pass.vals);
+}
+
+TEST_F(RadixSortTest, OnesweepTrimsConstantDigits)
+{
+    std::mt19937 rng(9u);
+    std::vector<uint64_t> keys(50000u);
+
+    // only the low digit varies, one pass leaves the result in the tmp buffers
+    for (uint64_t& key : keys)
+    {
+        key = 0xAB120000u | (rng() & 0xFFu);
+    }
+    expect_sorted(keys, false, 32u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+
+    // constant middle digits and a single varying bit in the high digit
+    for (uint64_t& key : keys)
+    {
+        key = 0x00345600u | (rng() & 0x0Fu) | ((rng() & 1u) << 30u);
+    }
+    expect_sorted(keys, false, 32u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+
+    // bits above key_bit_count are ignored, but kept in the output keys
+    for (uint64_t& key : keys)
+    {
+        key = rng();
+    }
+    expect_sorted(keys, false, 12u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+
+    // no varying digit, no pass runs
+    std::fill(keys.begin(), keys.end(), 0x12345678u);
+    expect_sorted(keys, false, 32u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+}
+
+TEST_F(RadixSortTest, OnesweepKey64)
+{
+    std::mt19937_64 rng(13u);
+    std::vector<uint64_t> keys(90001u);
+    for (uint64_t& key : keys)
+    {
+        key = rng();
+    }
+    expect_sorted(keys, true, 64u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+    expect_sorted(keys, true, 40u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+
+    // many duplicates in the high word only
+    for (uint64_t& key : keys)
+    {
+        key = (rng() & 0x7u) << 48u;
+    }
+    expect_sorted(keys, true, 64u, PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP);
+}
@@ -0,0 +1,307 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   gtests/Raster2DEquivalenceTest.cpp
+
+    \brief  Images of the 2D gaussian rasterizer fast paths against the paths they replace
+*/
+
+#include <gtest/gtest.h>
+
+#include "raster/CpuRaster2D.h"
+
+#include "GpuTestSupport.h"
+#include "RasterTestSupport.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using pnanovdb_editor_test::RasterTestRuntime;
+using pnanovdb_editor_test::RasterTestScene;
+using pnanovdb_editor_test::raster_test_camera;
+using pnanovdb_editor_test::raster_test_crop;
+using pnanovdb_editor_test::raster_test_shader_params;
+
+namespace
+{
+
+const uint32_t k_width = 320u;
+const uint32_t k_height = 240u;
+const uint64_t k_texel_count = uint64_t(k_width) * k_height;
+const float k_focal = 0.6f * float(k_height);
+
+// both images come from the device, only the order of float operations may differ
+void expect_images_match(const std::vector<float>& reference, const std::vector<float>& image, const char* label)
+{
+    ASSERT_EQ(reference.size(), 4u * k_texel_count) << label;
+    ASSERT_EQ(image.size(), 4u * k_texel_count) << label;
+    pnanovdb_raster::cpu_raster_image_diff_t diff =
+        pnanovdb_raster::cpu_raster_image_diff(reference.data(), image.data(), k_texel_count, 0.02f);
+    EXPECT_GT(diff.psnr, 50.0) << label << " max abs error " << diff.max_abs_error;
+    EXPECT_LT(diff.mean_abs_error, 5e-4) << label;
+    EXPECT_LT(diff.texels_over_threshold, k_texel_count / 1000u) << label;
+}
+
+// an empty image would match a failed raster too
+uint64_t covered_texels(const std::vector<float>& image)
+{
+    uint64_t covered = 0u;
+    for (uint64_t texel = 0u; 4u * texel + 3u < image.size(); texel++)
+    {
+        covered += image[4u * texel + 3u] < 0.5f ? 1u : 0u;
+    }
+    return covered;
+}
+
+pnanovdb_raster_gaussian_cull_stats_t take_cull_stats(RasterTestRuntime& rt)
+{
+    pnanovdb_raster_gaussian_cull_stats_t stats = {};
+    rt.raster.get_gaussian_cull_stats(rt.raster_ctx, &stats);
+    return stats;
+}
+
+} // namespace
+
+class Raster2DEquivalenceTest : public ::testing::Test
+{
+protected:
+    static RasterTestRuntime* s_rt;
+    static bool s_device_unavailable;
+    static bool s_software_renderer;
+    static std::string s_software_renderer_name;
+
+    static void SetUpTestSuite()
+    {
+        s_rt = new RasterTestRuntime();
+        if (!s_rt->init())
+        {
+            s_device_unavailable = (!s_rt->device_manager || !s_rt->device);
+            s_software_renderer = s_rt->software_renderer;
+            if (s_software_renderer)
+            {
+                s_software_renderer_name = s_rt->device_name;
+            }
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        delete s_rt;
+        s_rt = nullptr;
+    }
+
+    void SetUp() override
+    {
+        if (s_software_renderer)
+        {
+            GTEST_SKIP() << pnanovdb_editor_test::software_renderer_skip_reason(
+                s_software_renderer_name.c_str(), "raster image equivalence tests");
+        }
+        if (s_device_unavailable)
+        {
+            GTEST_SKIP() << "No Vulkan-compatible device available on this machine";
+        }
+        ASSERT_NE(s_rt, nullptr) << "RasterTestRuntime failed to initialize";
+        ASSERT_NE(s_rt->raster_ctx, nullptr) << "RasterTestRuntime failed to initialize";
+    }
+
+    RasterTestRuntime& rt()
+    {
+        return *s_rt;
+    }
+};
+
+RasterTestRuntime* Raster2DEquivalenceTest::s_rt = nullptr;
+bool Raster2DEquivalenceTest::s_device_unavailable = false;
+bool Raster2DEquivalenceTest::s_software_renderer = false;
+std::string Raster2DEquivalenceTest::s_software_renderer_name;
+
+TEST_F(Raster2DEquivalenceTest, ChunkCullingMatchesUnculled)
+{
+    RasterTestScene scene(20000u);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    ASSERT_NE(data, nullptr);
+    const pnanovdb_raster_shader_params_t params = raster_test_shader_params();
+
+    // zoomed in so the frustum cuts through the scene
+    const float focal = 3.f * k_focal;
+    pnanovdb_camera_mat_t view;
+    pnanovdb_camera_mat_t projection;
+    raster_test_camera(&view, &projection, k_width, k_height, 0.4f, focal);
+    take_cull_stats(rt());
+    std::vector<float> culled = rt().raster_gpu(data, k_width, k_height, view, projection, params);
+    pnanovdb_raster_gaussian_cull_stats_t stats = take_cull_stats(rt());
+    EXPECT_LT(stats.visible_chunk_count, stats.chunk_count);
+
+    // the same focal length over a margin wide enough to hold every chunk, cropped back to the narrow view
+    const uint32_t margin = 192u;
+    pnanovdb_camera_mat_t wide_view;
+    pnanovdb_camera_mat_t wide_projection;
+    raster_test_camera(&wide_view, &wide_projection, k_width + 2u * margin, k_height + 2u * margin, 0.4f, focal);
+    std::vector<float> wide =
+        rt().raster_gpu(data, k_width + 2u * margin, k_height + 2u * margin, wide_view, wide_projection, params);
+    stats = take_cull_stats(rt());
+    EXPECT_EQ(stats.visible_chunk_count, stats.chunk_count);
+    ASSERT_EQ(wide.size(), 4u * uint64_t(k_width + 2u * margin) * (k_height + 2u * margin));
+
+    std::vector<float> unculled = raster_test_crop(wide, k_width + 2u * margin, margin, margin, k_width, k_height);
+    expect_images_match(unculled, culled, "culled");
+    EXPECT_GT(covered_texels(unculled), k_texel_count / 4u);
+
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
+
+TEST_F(Raster2DEquivalenceTest, CoherentSortMatchesFullSort)
+{
+    RasterTestScene scene(20000u);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    ASSERT_NE(data, nullptr);
+    pnanovdb_raster_shader_params_t coherent_params = raster_test_shader_params();
+    coherent_params.tile_sort_mode = PNANOVDB_RASTER_TILE_SORT_COHERENT;
+
+    // the first frame seeds the depth order, the second starts from it after a small orbit
+    pnanovdb_camera_mat_t view;
+    pnanovdb_camera_mat_t projection;
+    raster_test_camera(&view, &projection, k_width, k_height, 0.4f, k_focal);
+    rt().raster_gpu(data, k_width, k_height, view, projection, coherent_params);
+    raster_test_camera(&view, &projection, k_width, k_height, 0.41f, k_focal);
+    take_cull_stats(rt());
+    std::vector<float> coherent = rt().raster_gpu(data, k_width, k_height, view, projection, coherent_params);
+    pnanovdb_raster_gaussian_cull_stats_t stats = take_cull_stats(rt());
+    EXPECT_EQ(stats.coherent_sort_count, 1u);
+
+    std::vector<float> full = rt().raster_gpu(data, k_width, k_height, view, projection, raster_test_shader_params());
+    expect_images_match(full, coherent, "coherent sort");
+    EXPECT_GT(covered_texels(full), k_texel_count / 4u);
+
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
+
+TEST_F(Raster2DEquivalenceTest, TileSizesMatch16x16)
+{
+    RasterTestScene scene(20000u);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    ASSERT_NE(data, nullptr);
+
+    pnanovdb_camera_mat_t view;
+    pnanovdb_camera_mat_t projection;
+    raster_test_camera(&view, &projection, k_width, k_height, 0.4f, k_focal);
+    std::vector<float> reference =
+        rt().raster_gpu(data, k_width, k_height, view, projection, raster_test_shader_params());
+    EXPECT_GT(covered_texels(reference), k_texel_count / 4u);
+
+    for (uint32_t tile_size : { 8u, 32u })
+    {
+        pnanovdb_raster_shader_params_t params = raster_test_shader_params();
+        params.tile_size = tile_size;
+        std::vector<float> image = rt().raster_gpu(data, k_width, k_height, view, projection, params);
+        expect_images_match(reference, image, tile_size == 8u ? "tile size 8" : "tile size 32");
+    }
+
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
+
+TEST_F(Raster2DEquivalenceTest, SplitTilesMatchUnsplit)
+{
+    // packed into a few tiles, each far above the split threshold
+    RasterTestScene scene(20000u, 0.05f);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    ASSERT_NE(data, nullptr);
+    const pnanovdb_raster_shader_params_t params = raster_test_shader_params();
+
+    pnanovdb_camera_mat_t view;
+    pnanovdb_camera_mat_t projection;
+    raster_test_camera(&view, &projection, k_width, k_height, 0.4f, k_focal);
+    take_cull_stats(rt());
+    std::vector<float> split = rt().raster_gpu(data, k_width, k_height, view, projection, params);
+    ASSERT_EQ(split.size(), 4u * k_texel_count);
+
+    // tile loads are read back late, the next raster collects those of the first
+    rt().raster_gpu(data, k_width, k_height, view, projection, params);
+    pnanovdb_raster_gaussian_cull_stats_t stats = take_cull_stats(rt());
+    EXPECT_GT(stats.max_tile_intersections, 4096u);
+    if (stats.tile_stats_count > 0u)
+    {
+        EXPECT_GT(stats.split_tile_count, 0u);
+    }
+
+    // the host rasterizer blends every tile in one pass, tolerances match the CPU golden test
+    std::vector<float> unsplit =
+        pnanovdb_editor_test::raster_test_cpu(rt().raster, rt().compute, data, k_width, k_height, view, projection,
+                                              params);
+    pnanovdb_raster::cpu_raster_image_diff_t diff =
+        pnanovdb_raster::cpu_raster_image_diff(unsplit.data(), split.data(), k_texel_count, 0.02f);
+    EXPECT_GT(diff.psnr, 40.0) << "max abs error " << diff.max_abs_error;
+    EXPECT_LT(diff.mean_abs_error, 2e-3);
+    EXPECT_LT(diff.texels_over_threshold, k_texel_count / 100u);
+    EXPECT_GT(covered_texels(unsplit), 0u);
+
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
+
+TEST_F(Raster2DEquivalenceTest, ShCacheMatchesUncached)
+{
+    RasterTestScene scene(20000u);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    pnanovdb_raster_gaussian_data_t* uncached_data =
+        scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    ASSERT_NE(data, nullptr);
+    ASSERT_NE(uncached_data, nullptr);
+    pnanovdb_raster_shader_params_t cached_params = raster_test_shader_params();
+    cached_params.sh_cache_angle = 0.5f;
+
+    // the second view turns 0.2 degrees, inside the tolerance, so every chunk keeps its colors
+    pnanovdb_camera_mat_t view;
+    pnanovdb_camera_mat_t projection;
+    raster_test_camera(&view, &projection, k_width, k_height, 0.4f, k_focal);
+    rt().raster_gpu(data, k_width, k_height, view, projection, cached_params);
+    raster_test_camera(&view, &projection, k_width, k_height, 0.4f + 0.2f * 3.14159265f / 180.f, k_focal);
+    take_cull_stats(rt());
+    std::vector<float> cached = rt().raster_gpu(data, k_width, k_height, view, projection, cached_params);
+    pnanovdb_raster_gaussian_cull_stats_t stats = take_cull_stats(rt());
+    EXPECT_GT(stats.visible_chunk_count, 0u);
+    EXPECT_EQ(stats.sh_refresh_chunk_count, 0u);
+
+    std::vector<float> uncached =
+        rt().raster_gpu(uncached_data, k_width, k_height, view, projection, raster_test_shader_params());
+    expect_images_match(uncached, cached, "SH cache");
+    EXPECT_GT(covered_texels(uncached), k_texel_count / 4u);
+
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, uncached_data);
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
+
+TEST_F(Raster2DEquivalenceTest, MultiViewMatchesSingleViews)
+{
+    RasterTestScene scene(20000u);
+    pnanovdb_raster_gaussian_data_t* data = scene.create(rt().compute, rt().raster, rt().queue, rt().raster_ctx);
+    ASSERT_NE(data, nullptr);
+    const pnanovdb_raster_shader_params_t params = raster_test_shader_params();
+
+    const uint32_t view_count = 4u;
+    const uint32_t atlas_columns = 2u;
+    pnanovdb_camera_mat_t views[view_count];
+    pnanovdb_camera_mat_t projections[view_count];
+    for (uint32_t view_idx = 0u; view_idx < view_count; view_idx++)
+    {
+        raster_test_camera(
+            &views[view_idx], &projections[view_idx], k_width, k_height, 0.2f + 0.2f * float(view_idx), k_focal);
+    }
+    std::vector<float> atlas =
+        rt().raster_gpu_views(data, k_width, k_height, views, projections, view_count, atlas_columns, params);
+    ASSERT_EQ(atlas.size(), 4u * k_texel_count * view_count);
+
+    for (uint32_t view_idx = 0u; view_idx < view_count; view_idx++)
+    {
+        std::vector<float> single =
+            rt().raster_gpu(data, k_width, k_height, views[view_idx], projections[view_idx], params);
+        std::vector<float> cell = raster_test_crop(atlas, atlas_columns * k_width, (view_idx % atlas_columns) * k_width,
+                                                   (view_idx / atlas_columns) * k_height, k_width, k_height);
+        expect_images_match(single, cell, ("view " + std::to_string(view_idx)).c_str());
+        EXPECT_GT(covered_texels(single), k_texel_count / 4u);
+    }
+
+    rt().raster.destroy_gaussian_data(&rt().compute, rt().queue, data);
+}
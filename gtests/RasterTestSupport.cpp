@@ -0,0 +1,330 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include "RasterTestSupport.h"
+
+#include "GpuTestSupport.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+namespace pnanovdb_editor_test
+{
+
+RasterTestScene::RasterTestScene(uint32_t point_count, float spread)
+{
+    std::mt19937 rng(11u);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::uniform_real_distribution<float> signed_unit(-1.f, 1.f);
+    for (uint32_t idx = 0u; idx < point_count; idx++)
+    {
+        means.insert(means.end(), { spread * 6.f * signed_unit(rng), spread * 4.f * signed_unit(rng),
+                                    spread * 4.f * signed_unit(rng) });
+        quaternions.insert(
+            quaternions.end(), { 1.f + unit(rng), signed_unit(rng), signed_unit(rng), signed_unit(rng) });
+        scales.insert(
+            scales.end(), { 0.01f + 0.1f * unit(rng), 0.01f + 0.1f * unit(rng), 0.01f + 0.05f * unit(rng) });
+        colors.insert(colors.end(), { 1.f, 1.f, 1.f });
+        sh_0.insert(sh_0.end(), { signed_unit(rng), signed_unit(rng), signed_unit(rng) });
+        for (uint32_t coeff = 0u; coeff < 9u; coeff++)
+        {
+            sh_n.push_back(0.3f * signed_unit(rng));
+        }
+        opacities.push_back(0.2f + 0.8f * unit(rng));
+    }
+}
+
+pnanovdb_raster_gaussian_data_t* RasterTestScene::create(const pnanovdb_compute_t& compute,
+                                                         pnanovdb_raster_t& raster,
+                                                         pnanovdb_compute_queue_t* queue,
+                                                         pnanovdb_raster_context_t* raster_ctx) const
+{
+    pnanovdb_compute_array_t* arrays[7] = {
+        compute.create_array(sizeof(float), means.size(), means.data()),
+        compute.create_array(sizeof(float), quaternions.size(), quaternions.data()),
+        compute.create_array(sizeof(float), scales.size(), scales.data()),
+        compute.create_array(sizeof(float), colors.size(), colors.data()),
+        compute.create_array(sizeof(float), sh_0.size(), sh_0.data()),
+        compute.create_array(sizeof(float), sh_n.size(), sh_n.data()),
+        compute.create_array(sizeof(float), opacities.size(), opacities.data()),
+    };
+    pnanovdb_raster_shader_params_t raster_params = raster_test_shader_params();
+    pnanovdb_raster_gaussian_data_t* data =
+        raster.create_gaussian_data(&compute, queue, raster_ctx, arrays[0], arrays[1], arrays[2], arrays[3], arrays[4],
+                                    arrays[5], arrays[6], nullptr, &raster_params);
+    for (pnanovdb_compute_array_t* array : arrays)
+    {
+        compute.destroy_array(array);
+    }
+    return data;
+}
+
+pnanovdb_raster_shader_params_t raster_test_shader_params()
+{
+    pnanovdb_raster_shader_params_t params = default_shader_params;
+    params.tile_size = 16u;
+    params.tile_sort_mode = PNANOVDB_RASTER_TILE_SORT_FULL;
+    params.sh_cache_angle = 0.f;
+    return params;
+}
+
+void raster_test_camera(pnanovdb_camera_mat_t* view,
+                        pnanovdb_camera_mat_t* projection,
+                        uint32_t width,
+                        uint32_t height,
+                        float angle,
+                        float focal_pixels)
+{
+    const float near_plane = 0.5f;
+    const float far_plane = 100.f;
+    *view = {};
+    view->x.x = cosf(angle);
+    view->x.z = sinf(angle);
+    view->y.y = 1.f;
+    view->z.x = -sinf(angle);
+    view->z.z = cosf(angle);
+    view->w.z = 12.f;
+    view->w.w = 1.f;
+
+    *projection = {};
+    projection->x.x = 2.f * focal_pixels / float(width);
+    projection->y.y = 2.f * focal_pixels / float(height);
+    projection->z.z = far_plane / (far_plane - near_plane);
+    projection->z.w = 1.f;
+    projection->w.z = -near_plane * far_plane / (far_plane - near_plane);
+}
+
+std::vector<float> raster_test_cpu(pnanovdb_raster_t& raster,
+                                   const pnanovdb_compute_t& compute,
+                                   pnanovdb_raster_gaussian_data_t* data,
+                                   uint32_t width,
+                                   uint32_t height,
+                                   const pnanovdb_camera_mat_t& view,
+                                   const pnanovdb_camera_mat_t& projection,
+                                   const pnanovdb_raster_shader_params_t& params)
+{
+    pnanovdb_compute_array_t* color_2d = compute.create_array(4u * sizeof(float), width * height, nullptr);
+    raster.raster_gaussian_2d_cpu(&compute, data, color_2d, width, height, &view, &projection, &params, 0u);
+    std::vector<float> image((const float*)color_2d->data, (const float*)color_2d->data + 4u * width * height);
+    compute.destroy_array(color_2d);
+    return image;
+}
+
+std::vector<float> raster_test_crop(
+    const std::vector<float>& image, uint32_t image_width, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    std::vector<float> crop(4u * width * height);
+    for (uint32_t row = 0u; row < height; row++)
+    {
+        memcpy(crop.data() + 4u * row * width, image.data() + 4u * ((y + row) * image_width + x),
+               4u * width * sizeof(float));
+    }
+    return crop;
+}
+
+bool RasterTestRuntime::init()
+{
+    pnanovdb_compiler_load(&compiler);
+    if (!compiler.module)
+    {
+        ADD_FAILURE() << "Compiler module not available";
+        return false;
+    }
+    pnanovdb_compute_load(&compute, &compiler);
+    if (!compute.module)
+    {
+        ADD_FAILURE() << "Compute module not available";
+        return false;
+    }
+    device_manager = compute.device_interface.create_device_manager(PNANOVDB_FALSE);
+    if (!device_manager)
+    {
+        ADD_FAILURE() << "Failed to create device manager";
+        return false;
+    }
+    pnanovdb_compute_physical_device_desc_t phys_desc{};
+    if (!compute.device_interface.enumerate_devices(device_manager, 0u, &phys_desc))
+    {
+        return false;
+    }
+    device_name = phys_desc.device_name;
+    if (should_skip_on_software_renderer(phys_desc.device_name))
+    {
+        software_renderer = true;
+        return false;
+    }
+    pnanovdb_compute_device_desc_t device_desc{};
+    device_desc.log_print = stderr_log_print;
+    device = compute.device_interface.create_device(device_manager, &device_desc);
+    if (!device)
+    {
+        ADD_FAILURE() << "Failed to create compute device";
+        return false;
+    }
+    queue = compute.device_interface.get_compute_queue(device);
+    if (!queue)
+    {
+        ADD_FAILURE() << "Failed to acquire compute queue";
+        return false;
+    }
+    pnanovdb_raster_load(&raster, &compute);
+    if (!raster.create_context || !raster.raster_gaussian_2d || !raster.raster_gaussian_2d_views ||
+        !raster.raster_gaussian_2d_cpu)
+    {
+        ADD_FAILURE() << "raster interface not loaded";
+        return false;
+    }
+    raster_ctx = raster.create_context(&compute, queue);
+    if (!raster_ctx)
+    {
+        ADD_FAILURE() << "Failed to create raster context";
+        return false;
+    }
+    return true;
+}
+
+pnanovdb_compute_texture_t* RasterTestRuntime::create_color_texture(uint32_t width, uint32_t height)
+{
+    pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+    pnanovdb_compute_texture_desc_t tex_desc = {};
+    tex_desc.texture_type = PNANOVDB_COMPUTE_TEXTURE_TYPE_2D;
+    tex_desc.usage = PNANOVDB_COMPUTE_TEXTURE_USAGE_TEXTURE | PNANOVDB_COMPUTE_TEXTURE_USAGE_RW_TEXTURE;
+    tex_desc.format = PNANOVDB_COMPUTE_FORMAT_R32G32B32A32_FLOAT;
+    tex_desc.width = width;
+    tex_desc.height = height;
+    tex_desc.depth = 1u;
+    tex_desc.mip_levels = 1u;
+    return compute_interface->create_texture(context, &tex_desc);
+}
+
+std::vector<float> RasterTestRuntime::read_texture(pnanovdb_compute_texture_t* texture, uint32_t width, uint32_t height)
+{
+    pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+    const std::filesystem::path shader =
+        std::filesystem::path(__FILE__).parent_path() / "shaders" / "texture_to_buffer.slang";
+    const std::string shader_path = shader.string();
+    pnanovdb_compiler_settings_t compile_settings = {};
+    pnanovdb_compiler_settings_init(&compile_settings);
+    pnanovdb_shader_context_t* shader_context = compute.create_shader_context(shader_path.c_str());
+    std::vector<float> image;
+    if (compute.init_shader(&compute, queue, shader_context, &compile_settings) == PNANOVDB_FALSE)
+    {
+        ADD_FAILURE() << "Failed to compile " << shader_path;
+        compute.destroy_shader_context(&compute, queue, shader_context);
+        return image;
+    }
+
+    const uint64_t image_bytes = 4u * sizeof(float) * uint64_t(width) * height;
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.size_in_bytes = 4u * sizeof(uint32_t);
+    pnanovdb_compute_buffer_t* constant_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+    buf_desc.structure_stride = 4u * sizeof(float);
+    buf_desc.size_in_bytes = image_bytes;
+    pnanovdb_compute_buffer_t* color_device =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+    buf_desc.structure_stride = 0u;
+    pnanovdb_compute_buffer_t* color_readback =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
+
+    uint32_t constants[4] = { width, height, 0u, 0u };
+    void* mapped_constants = compute_interface->map_buffer(context, constant_buffer);
+    memcpy(mapped_constants, constants, sizeof(constants));
+    compute_interface->unmap_buffer(context, constant_buffer);
+
+    pnanovdb_compute_resource_t resources[3u] = {};
+    resources[0u].buffer_transient = compute_interface->register_buffer_as_transient(context, constant_buffer);
+    resources[1u].texture_transient = compute_interface->register_texture_as_transient(context, texture);
+    resources[2u].buffer_transient = compute_interface->register_buffer_as_transient(context, color_device);
+    compute.dispatch_shader(compute_interface, context, shader_context, resources, (width + 7u) / 8u,
+                            (height + 7u) / 8u, 1u, "raster_test_readback");
+
+    pnanovdb_compute_copy_buffer_params_t copy_params = {};
+    copy_params.num_bytes = image_bytes;
+    copy_params.src = compute_interface->register_buffer_as_transient(context, color_device);
+    copy_params.dst = compute_interface->register_buffer_as_transient(context, color_readback);
+    copy_params.debug_label = "raster_test_readback_copy";
+    compute_interface->copy_buffer(context, &copy_params);
+
+    pnanovdb_uint64_t flushed_frame = 0llu;
+    compute.device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+    compute.device_interface.wait_idle(queue);
+
+    image.resize(4u * uint64_t(width) * height);
+    void* mapped_image = compute_interface->map_buffer(context, color_readback);
+    memcpy(image.data(), mapped_image, image_bytes);
+    compute_interface->unmap_buffer(context, color_readback);
+
+    compute_interface->destroy_buffer(context, constant_buffer);
+    compute_interface->destroy_buffer(context, color_device);
+    compute_interface->destroy_buffer(context, color_readback);
+    compute.destroy_shader_context(&compute, queue, shader_context);
+    return image;
+}
+
+std::vector<float> RasterTestRuntime::raster_gpu(pnanovdb_raster_gaussian_data_t* data,
+                                                 uint32_t width,
+                                                 uint32_t height,
+                                                 const pnanovdb_camera_mat_t& view,
+                                                 const pnanovdb_camera_mat_t& projection,
+                                                 const pnanovdb_raster_shader_params_t& params)
+{
+    pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+    pnanovdb_compute_texture_t* color_2d = create_color_texture(width, height);
+    raster.raster_gaussian_2d(
+        &compute, queue, raster_ctx, data, color_2d, width, height, &view, &projection, &params, 0u);
+    std::vector<float> image = read_texture(color_2d, width, height);
+    compute_interface->destroy_texture(context, color_2d);
+    return image;
+}
+
+std::vector<float> RasterTestRuntime::raster_gpu_views(pnanovdb_raster_gaussian_data_t* data,
+                                                       uint32_t width,
+                                                       uint32_t height,
+                                                       const pnanovdb_camera_mat_t* views,
+                                                       const pnanovdb_camera_mat_t* projections,
+                                                       uint32_t view_count,
+                                                       uint32_t atlas_columns,
+                                                       const pnanovdb_raster_shader_params_t& params)
+{
+    pnanovdb_compute_interface_t* compute_interface = compute.device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute.device_interface.get_compute_context(queue);
+
+    const uint32_t atlas_rows = (view_count + atlas_columns - 1u) / atlas_columns;
+    pnanovdb_compute_texture_t* color_2d = create_color_texture(atlas_columns * width, atlas_rows * height);
+    raster.raster_gaussian_2d_views(&compute, queue, raster_ctx, data, color_2d, width, height, views, projections,
+                                    view_count, atlas_columns, &params, 0u);
+    std::vector<float> image = read_texture(color_2d, atlas_columns * width, atlas_rows * height);
+    compute_interface->destroy_texture(context, color_2d);
+    return image;
+}
+
+RasterTestRuntime::~RasterTestRuntime()
+{
+    if (raster_ctx)
+        raster.destroy_context(&compute, queue, raster_ctx);
+    if (device)
+        compute.device_interface.destroy_device(device_manager, device);
+    if (device_manager)
+        compute.device_interface.destroy_device_manager(device_manager);
+    if (compute.module)
+        pnanovdb_compute_free(&compute);
+    if (compiler.module)
+        pnanovdb_compiler_free(&compiler);
+}
+
+} // namespace pnanovdb_editor_test
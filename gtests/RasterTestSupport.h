@@ -0,0 +1,106 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef NANOVDB_EDITOR_GTESTS_RASTER_TEST_SUPPORT_H_HAS_BEEN_INCLUDED
+#define NANOVDB_EDITOR_GTESTS_RASTER_TEST_SUPPORT_H_HAS_BEEN_INCLUDED
+
+#include <nanovdb_editor/putil/Compiler.h>
+#include <nanovdb_editor/putil/Compute.h>
+#include <nanovdb_editor/putil/Raster.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pnanovdb_editor_test
+{
+
+// Host arrays of a random splat scene with SH degree 1, packed rrr...ggg...bbb,
+// spread scales the means so the scene can be packed into a few tiles
+struct RasterTestScene
+{
+    std::vector<float> means;
+    std::vector<float> quaternions;
+    std::vector<float> scales;
+    std::vector<float> colors;
+    std::vector<float> sh_0;
+    std::vector<float> sh_n;
+    std::vector<float> opacities;
+
+    explicit RasterTestScene(uint32_t point_count, float spread = 1.f);
+
+    pnanovdb_raster_gaussian_data_t* create(const pnanovdb_compute_t& compute,
+                                            pnanovdb_raster_t& raster,
+                                            pnanovdb_compute_queue_t* queue,
+                                            pnanovdb_raster_context_t* raster_ctx) const;
+};
+
+// the image depends on the tile size, the SH cache would keep colors of another view
+pnanovdb_raster_shader_params_t raster_test_shader_params();
+
+// looks down +z from 12 units behind the scene, turned by angle radians about y so the SH see an oblique view
+// direction, focal_pixels is the focal length in pixels about the image center
+void raster_test_camera(pnanovdb_camera_mat_t* view,
+                        pnanovdb_camera_mat_t* projection,
+                        uint32_t width,
+                        uint32_t height,
+                        float angle,
+                        float focal_pixels);
+
+std::vector<float> raster_test_cpu(pnanovdb_raster_t& raster,
+                                   const pnanovdb_compute_t& compute,
+                                   pnanovdb_raster_gaussian_data_t* data,
+                                   uint32_t width,
+                                   uint32_t height,
+                                   const pnanovdb_camera_mat_t& view,
+                                   const pnanovdb_camera_mat_t& projection,
+                                   const pnanovdb_raster_shader_params_t& params);
+
+// float RGBA texels of rows [y, y + height) and columns [x, x + width) of an image image_width texels wide
+std::vector<float> raster_test_crop(
+    const std::vector<float>& image, uint32_t image_width, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+// Compiler / compute / device / raster fixture. init() returns false
+// when no Vulkan device is available so the caller can GTEST_SKIP.
+struct RasterTestRuntime
+{
+    pnanovdb_compiler_t compiler{};
+    pnanovdb_compute_t compute{};
+    pnanovdb_compute_device_manager_t* device_manager = nullptr;
+    pnanovdb_compute_device_t* device = nullptr;
+    pnanovdb_compute_queue_t* queue = nullptr;
+    pnanovdb_raster_t raster{};
+    pnanovdb_raster_context_t* raster_ctx = nullptr;
+    bool software_renderer = false;
+    std::string device_name;
+
+    bool init();
+
+    pnanovdb_compute_texture_t* create_color_texture(uint32_t width, uint32_t height);
+
+    // copies the texture to a buffer to read it back, empty on failure
+    std::vector<float> read_texture(pnanovdb_compute_texture_t* texture, uint32_t width, uint32_t height);
+
+    std::vector<float> raster_gpu(pnanovdb_raster_gaussian_data_t* data,
+                                  uint32_t width,
+                                  uint32_t height,
+                                  const pnanovdb_camera_mat_t& view,
+                                  const pnanovdb_camera_mat_t& projection,
+                                  const pnanovdb_raster_shader_params_t& params);
+
+    // atlas of raster_gaussian_2d_views, atlas_columns * width by rows * height texels
+    std::vector<float> raster_gpu_views(pnanovdb_raster_gaussian_data_t* data,
+                                        uint32_t width,
+                                        uint32_t height,
+                                        const pnanovdb_camera_mat_t* views,
+                                        const pnanovdb_camera_mat_t* projections,
+                                        uint32_t view_count,
+                                        uint32_t atlas_columns,
+                                        const pnanovdb_raster_shader_params_t& params);
+
+    ~RasterTestRuntime();
+};
+
+} // namespace pnanovdb_editor_test
+
+#endif
@@ -0,0 +1,114 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "editor/ResidencyManager.h"
+
+#include <vector>
+
+using pnanovdb_editor::ResidencyManager;
+
+namespace
+{
+constexpr pnanovdb_uint64_t k_mb = 1024u * 1024u;
+}
+
+TEST(NanoVDBEditor, ResidencyManagerKeepsObjectsWithinBudget)
+{
+    int objects[3] = {};
+    ResidencyManager residency;
+    residency.set_budget(100u * k_mb);
+
+    for (int& object : objects)
+    {
+        residency.track(&object, 30u * k_mb);
+    }
+    EXPECT_TRUE(residency.end_frame().empty());
+    EXPECT_EQ(residency.get_tracked_bytes(), 90u * k_mb);
+}
+
+TEST(NanoVDBEditor, ResidencyManagerEvictsLeastRecentlyRendered)
+{
+    int objects[3] = {};
+    ResidencyManager residency;
+    residency.set_budget(100u * k_mb);
+
+    // frame 1 draws object 0, frame 2 draws object 1, frame 3 draws object 2 only
+    for (int frame = 0; frame < 3; frame++)
+    {
+        residency.mark_rendered(&objects[frame]);
+        for (int& object : objects)
+        {
+            residency.track(&object, 30u * k_mb);
+        }
+        EXPECT_TRUE(residency.end_frame().empty());
+    }
+
+    // a fourth object pushes the total to 120 MB, object 0 was rendered longest ago
+    int loaded = 0;
+    residency.mark_rendered(&loaded);
+    residency.mark_rendered(&objects[2]);
+    for (int& object : objects)
+    {
+        residency.track(&object, 30u * k_mb);
+    }
+    residency.track(&loaded, 30u * k_mb);
+
+    std::vector<const void*> evicted = residency.end_frame();
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0], &objects[0]);
+    EXPECT_EQ(residency.get_tracked_bytes(), 90u * k_mb);
+}
+
+TEST(NanoVDBEditor, ResidencyManagerNeverEvictsRenderedObjects)
+{
+    int objects[2] = {};
+    ResidencyManager residency;
+    residency.set_budget(10u * k_mb);
+
+    for (int& object : objects)
+    {
+        residency.mark_rendered(&object);
+        residency.track(&object, 40u * k_mb);
+    }
+    EXPECT_TRUE(residency.end_frame().empty());
+    EXPECT_EQ(residency.get_tracked_bytes(), 80u * k_mb);
+}
+
+TEST(NanoVDBEditor, ResidencyManagerForgetsRemovedObjects)
+{
+    int objects[2] = {};
+    ResidencyManager residency;
+    residency.set_budget(50u * k_mb);
+
+    residency.track(&objects[0], 40u * k_mb);
+    residency.track(&objects[1], 40u * k_mb);
+    EXPECT_EQ(residency.end_frame().size(), 1u);
+
+    // object 1 was removed from the scene and is not reported any more
+    residency.track(&objects[0], 40u * k_mb);
+    EXPECT_TRUE(residency.end_frame().empty());
+    EXPECT_EQ(residency.get_tracked_bytes(), 40u * k_mb);
+}
+
+TEST(NanoVDBEditor, ResidencyManagerHonorsDriverBudget)
+{
+    int objects[2] = {};
+    ResidencyManager residency;
+
+    const pnanovdb_uint64_t driver_budget = 1000u * k_mb;
+    const pnanovdb_uint64_t driver_usage = 950u * k_mb;
+
+    residency.mark_rendered(&objects[1]);
+    residency.track(&objects[0], 100u * k_mb);
+    residency.track(&objects[1], 100u * k_mb);
+    std::vector<const void*> evicted = residency.end_frame(driver_budget, driver_usage);
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0], &objects[0]);
+
+    // the driver keeps counting the evicted buffers until they are released, that must not evict again
+    residency.track(&objects[0], 0u);
+    residency.track(&objects[1], 100u * k_mb);
+    EXPECT_TRUE(residency.end_frame(driver_budget, driver_usage).empty());
+}
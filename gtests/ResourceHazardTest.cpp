@@ -0,0 +1,293 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "vulkan/ResourceHazardVulkan.h"
+
+#include <vector>
+
+using namespace pnanovdb_vulkan;
+
+namespace
+{
+struct test_resource_t
+{
+    ResourceHazard hazard;
+    pnanovdb_bool_t memoryAliased = PNANOVDB_FALSE;
+    bool isTexture = false;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+struct test_descriptor_t
+{
+    pnanovdb_uint32_t resource;
+    pnanovdb_compute_descriptor_type_t type;
+};
+
+struct test_node_t
+{
+    NodeBarrierMasks barrier;
+    pnanovdb_uint32_t resourceBarrierCount = 0u;
+    VkAccessFlags resourceSrcAccessMask = 0u;
+};
+
+// derives the barriers of one flush of passes the way context_flushNodes does
+std::vector<test_node_t> record_flush(std::vector<test_resource_t>& resources,
+                                      const std::vector<std::vector<test_descriptor_t>>& passes,
+                                      DeviceQueue* deviceQueue,
+                                      pnanovdb_uint64_t flushIdx)
+{
+    struct access_t
+    {
+        pnanovdb_uint32_t resource;
+        VkPipelineStageFlags stageMask;
+        VkAccessFlags accessMask;
+        VkImageLayout layout;
+    };
+
+    std::vector<test_node_t> nodes(passes.size());
+    for (size_t nodeIdx = 0u; nodeIdx < passes.size(); nodeIdx++)
+    {
+        std::vector<access_t> accesses;
+        for (const test_descriptor_t& descriptor : passes[nodeIdx])
+        {
+            access_t access = { descriptor.resource, 0u, 0u, VK_IMAGE_LAYOUT_UNDEFINED };
+            context_getDescriptorAccess(descriptor.type, &access.stageMask, &access.accessMask, &access.layout);
+            bool merged = false;
+            for (access_t& other : accesses)
+            {
+                if (other.resource == access.resource)
+                {
+                    context_mergeDescriptorAccess(&other.stageMask, &other.accessMask, &other.layout,
+                                                  access.stageMask, access.accessMask, access.layout);
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged)
+            {
+                accesses.push_back(access);
+            }
+        }
+
+        test_node_t& node = nodes[nodeIdx];
+        for (const access_t& access : accesses)
+        {
+            test_resource_t& resource = resources[access.resource];
+            pnanovdb_bool_t layoutTransition = resource.isTexture && resource.layout != access.layout;
+            VkAccessFlags srcAccessMask = 0u;
+            if (resourceHazard_addNodeAccess(&resource.hazard, deviceQueue, flushIdx, resource.memoryAliased,
+                                             access.stageMask, access.accessMask, layoutTransition, &node.barrier,
+                                             &srcAccessMask))
+            {
+                node.resourceBarrierCount++;
+                node.resourceSrcAccessMask |= srcAccessMask;
+            }
+            if (resource.isTexture)
+            {
+                resource.layout = access.layout;
+            }
+        }
+    }
+    return nodes;
+}
+
+void expect_no_barrier(const test_node_t& node)
+{
+    EXPECT_EQ(node.barrier.srcStageMask, 0u);
+    EXPECT_EQ(node.barrier.dstStageMask, 0u);
+    EXPECT_EQ(node.barrier.memorySrcAccessMask, 0u);
+    EXPECT_EQ(node.barrier.memoryDstAccessMask, 0u);
+    EXPECT_EQ(node.resourceBarrierCount, 0u);
+}
+
+// only compared, never dereferenced
+int s_queue_objects[2] = {};
+DeviceQueue* const s_queue_a = reinterpret_cast<DeviceQueue*>(&s_queue_objects[0]);
+DeviceQueue* const s_queue_b = reinterpret_cast<DeviceQueue*>(&s_queue_objects[1]);
+
+constexpr VkPipelineStageFlags k_compute = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+constexpr VkPipelineStageFlags k_transfer = VK_PIPELINE_STAGE_TRANSFER_BIT;
+constexpr VkPipelineStageFlags k_indirect = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+} // namespace
+
+TEST(NanoVDBEditor, ResourceHazardReadAfterReadNeedsNothing)
+{
+    std::vector<test_resource_t> resources(1u);
+    std::vector<test_node_t> nodes = record_flush(resources,
+                                                  {
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_CONSTANT_BUFFER } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_SRC } },
+                                                  },
+                                                  s_queue_a, 1u);
+    for (const test_node_t& node : nodes)
+    {
+        expect_no_barrier(node);
+    }
+}
+
+TEST(NanoVDBEditor, ResourceHazardWriteAfterReadIsExecutionOnly)
+{
+    std::vector<test_resource_t> resources(1u);
+    std::vector<test_node_t> nodes = record_flush(resources,
+                                                  {
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_DST } },
+                                                  },
+                                                  s_queue_a, 1u);
+    expect_no_barrier(nodes[0]);
+    EXPECT_EQ(nodes[1].barrier.srcStageMask, k_compute);
+    EXPECT_EQ(nodes[1].barrier.dstStageMask, k_transfer);
+    EXPECT_EQ(nodes[1].barrier.memorySrcAccessMask, 0u);
+    EXPECT_EQ(nodes[1].resourceBarrierCount, 0u) << "write after read needs no buffer barrier";
+}
+
+TEST(NanoVDBEditor, ResourceHazardReadAfterWriteOncePerConsumerStage)
+{
+    std::vector<test_resource_t> resources(1u);
+    std::vector<test_node_t> nodes = record_flush(resources,
+                                                  {
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_INDIRECT_BUFFER } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_SRC } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_SRC } },
+                                                  },
+                                                  s_queue_a, 1u);
+    expect_no_barrier(nodes[0]);
+
+    const VkPipelineStageFlags consumerStages[] = { k_compute, 0u, k_indirect, k_transfer, 0u };
+    for (size_t idx = 0u; idx < 5u; idx++)
+    {
+        const test_node_t& node = nodes[idx + 1u];
+        if (consumerStages[idx] == 0u)
+        {
+            expect_no_barrier(node);
+            continue;
+        }
+        EXPECT_EQ(node.barrier.srcStageMask, k_compute) << "node " << idx + 1u;
+        EXPECT_EQ(node.barrier.dstStageMask, consumerStages[idx]) << "node " << idx + 1u;
+        EXPECT_EQ(node.resourceBarrierCount, 1u) << "node " << idx + 1u;
+        EXPECT_EQ(node.resourceSrcAccessMask, VkAccessFlags(VK_ACCESS_SHADER_WRITE_BIT)) << "node " << idx + 1u;
+    }
+}
+
+TEST(NanoVDBEditor, ResourceHazardMergesDescriptorsOfOneResource)
+{
+    std::vector<test_resource_t> resources(2u);
+    std::vector<test_node_t> nodes = record_flush(resources,
+                                                  {
+                                                      // read and write binding of one buffer, the node must not
+                                                      // wait on itself
+                                                      {
+                                                          { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER },
+                                                          { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER },
+                                                      },
+                                                      // copy within one buffer after the write, a single barrier
+                                                      {
+                                                          { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_SRC },
+                                                          { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_DST },
+                                                          { 1u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER },
+                                                      },
+                                                  },
+                                                  s_queue_a, 1u);
+    expect_no_barrier(nodes[0]);
+    EXPECT_EQ(nodes[1].barrier.srcStageMask, k_compute);
+    EXPECT_EQ(nodes[1].barrier.dstStageMask, k_transfer);
+    EXPECT_EQ(nodes[1].resourceBarrierCount, 1u);
+    EXPECT_EQ(nodes[1].resourceSrcAccessMask, VkAccessFlags(VK_ACCESS_SHADER_WRITE_BIT));
+
+    VkPipelineStageFlags stageMask = k_compute;
+    VkAccessFlags accessMask = VK_ACCESS_SHADER_READ_BIT;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    context_mergeDescriptorAccess(&stageMask, &accessMask, &layout, k_compute,
+                                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL);
+    EXPECT_EQ(accessMask, VkAccessFlags(VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+    EXPECT_EQ(layout, VK_IMAGE_LAYOUT_GENERAL) << "differing layouts fall back to general";
+}
+
+TEST(NanoVDBEditor, ResourceHazardAliasedFirstUseWaitsOnEarlierOccupants)
+{
+    std::vector<test_resource_t> resources(2u);
+    resources[0].memoryAliased = PNANOVDB_TRUE;
+    resources[1].memoryAliased = PNANOVDB_TRUE;
+    std::vector<test_node_t> nodes = record_flush(resources,
+                                                  {
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } },
+                                                      { { 1u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER } },
+                                                      { { 1u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } },
+                                                  },
+                                                  s_queue_a, 1u);
+
+    // first uses go through a global barrier, the earlier occupants were other VkBuffers
+    const VkAccessFlags occupantWrites = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    EXPECT_EQ(nodes[0].barrier.srcStageMask, k_compute | k_transfer);
+    EXPECT_EQ(nodes[0].barrier.dstStageMask, k_compute);
+    EXPECT_EQ(nodes[0].barrier.memorySrcAccessMask, occupantWrites);
+    EXPECT_EQ(nodes[0].barrier.memoryDstAccessMask, VkAccessFlags(VK_ACCESS_SHADER_READ_BIT));
+    EXPECT_EQ(nodes[0].resourceBarrierCount, 0u);
+
+    EXPECT_EQ(nodes[1].barrier.srcStageMask, k_compute | k_transfer | k_indirect);
+    EXPECT_EQ(nodes[1].barrier.memorySrcAccessMask, occupantWrites);
+    EXPECT_EQ(nodes[1].barrier.memoryDstAccessMask,
+              VkAccessFlags(VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+    EXPECT_EQ(nodes[1].resourceBarrierCount, 0u);
+
+    // later uses in the flush are tracked per buffer again
+    EXPECT_EQ(nodes[2].barrier.memorySrcAccessMask, 0u);
+    EXPECT_EQ(nodes[2].resourceBarrierCount, 1u);
+    EXPECT_EQ(nodes[2].resourceSrcAccessMask, VkAccessFlags(VK_ACCESS_SHADER_WRITE_BIT));
+}
+
+TEST(NanoVDBEditor, ResourceHazardWritesOfTheOtherQueueNeedVisibility)
+{
+    std::vector<test_resource_t> resources(1u);
+    record_flush(resources, { { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER } } }, s_queue_b, 1u);
+
+    // the next flush of the same queue starts after a global barrier
+    std::vector<test_node_t> sameQueue =
+        record_flush(resources, { { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } } }, s_queue_b, 2u);
+    expect_no_barrier(sameQueue[0]);
+
+    record_flush(resources, { { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER } } }, s_queue_b, 3u);
+    std::vector<test_node_t> otherQueue =
+        record_flush(resources, { { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } } }, s_queue_a, 4u);
+    EXPECT_EQ(otherQueue[0].barrier.srcStageMask, k_compute | k_transfer);
+    EXPECT_EQ(otherQueue[0].barrier.dstStageMask, k_compute);
+    EXPECT_EQ(otherQueue[0].resourceBarrierCount, 1u);
+    EXPECT_EQ(otherQueue[0].resourceSrcAccessMask,
+              VkAccessFlags(VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT));
+
+    // once visible, later flushes of that queue need nothing
+    std::vector<test_node_t> again =
+        record_flush(resources, { { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER } } }, s_queue_a, 5u);
+    expect_no_barrier(again[0]);
+}
+
+TEST(NanoVDBEditor, ResourceHazardTextureLayoutTransitions)
+{
+    std::vector<test_resource_t> resources(1u);
+    resources[0].isTexture = true;
+    std::vector<test_node_t> nodes = record_flush(resources,
+                                                  {
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_TEXTURE } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE } },
+                                                      { { 0u, PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE } },
+                                                  },
+                                                  s_queue_a, 1u);
+
+    // first use transition has nothing to wait on
+    EXPECT_EQ(nodes[0].barrier.srcStageMask, 0u);
+    EXPECT_EQ(nodes[0].barrier.dstStageMask, k_compute);
+    EXPECT_EQ(nodes[0].resourceBarrierCount, 1u);
+    EXPECT_EQ(nodes[0].resourceSrcAccessMask, 0u);
+
+    EXPECT_EQ(nodes[1].barrier.srcStageMask, k_compute);
+    EXPECT_EQ(nodes[1].resourceBarrierCount, 1u);
+    EXPECT_EQ(nodes[1].resourceSrcAccessMask, VkAccessFlags(VK_ACCESS_SHADER_WRITE_BIT));
+
+    expect_no_barrier(nodes[2]);
+}
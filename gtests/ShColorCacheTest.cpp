@@ -0,0 +1,67 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/ShColorCache.h"
+
+#include <math.h>
+
+using pnanovdb_raster::sh_chunk_dir_t;
+
+TEST(NanoVDBEditor, ShColorCacheRefreshTolerance)
+{
+    const float cos_tolerance = pnanovdb_raster::sh_cache_cos_tolerance(1.f);
+    const sh_chunk_dir_t cached = { 0.f, 0.f, 1.f, 1.f };
+
+    // half a degree stays cached, two degrees refresh
+    float small = 0.5f * 3.14159265f / 180.f;
+    float large = 2.f * 3.14159265f / 180.f;
+    pnanovdb_vec3_t near_dir = { sinf(small), 0.f, cosf(small) };
+    pnanovdb_vec3_t far_dir = { 0.f, sinf(large), cosf(large) };
+    EXPECT_FALSE(pnanovdb_raster::sh_chunk_needs_refresh(cached, near_dir, cos_tolerance, false));
+    EXPECT_TRUE(pnanovdb_raster::sh_chunk_needs_refresh(cached, far_dir, cos_tolerance, false));
+
+    // stale chunks and resets always refresh
+    const sh_chunk_dir_t stale = { 0.f, 0.f, 1.f, 0.f };
+    EXPECT_TRUE(pnanovdb_raster::sh_chunk_needs_refresh(stale, near_dir, cos_tolerance, false));
+    EXPECT_TRUE(pnanovdb_raster::sh_chunk_needs_refresh(cached, near_dir, cos_tolerance, true));
+
+    // an angle of 0 disables the cache
+    pnanovdb_vec3_t same_dir = { 0.f, 0.f, 1.f };
+    EXPECT_TRUE(
+        pnanovdb_raster::sh_chunk_needs_refresh(cached, same_dir, pnanovdb_raster::sh_cache_cos_tolerance(0.f), false));
+}
+
+TEST(NanoVDBEditor, ShColorCacheInvalidation)
+{
+    pnanovdb_raster_shader_params_t params = default_shader_params;
+    params.sh_degree_override = 3;
+    params.sh_stride_rgbrgbrgb_override = 0u;
+
+    EXPECT_TRUE(pnanovdb_raster::sh_cache_matches(true, 3, 0u, params));
+    EXPECT_FALSE(pnanovdb_raster::sh_cache_matches(false, 3, 0u, params));
+    EXPECT_FALSE(pnanovdb_raster::sh_cache_matches(true, 2, 0u, params));
+    EXPECT_FALSE(pnanovdb_raster::sh_cache_matches(true, 3, 1u, params));
+}
+
+TEST(NanoVDBEditor, ShColorCacheSlowOrbit)
+{
+    // a camera orbiting at 0.1 degrees per frame refreshes a chunk every few frames
+    const float cos_tolerance = pnanovdb_raster::sh_cache_cos_tolerance(default_shader_params.sh_cache_angle);
+    sh_chunk_dir_t cached = {};
+    pnanovdb_uint32_t refresh_count = 0u;
+    const pnanovdb_uint32_t frame_count = 360u;
+    for (pnanovdb_uint32_t frame = 0u; frame < frame_count; frame++)
+    {
+        float angle = 0.1f * float(frame) * 3.14159265f / 180.f;
+        pnanovdb_vec3_t view_dir = { sinf(angle), 0.f, cosf(angle) };
+        if (pnanovdb_raster::sh_chunk_needs_refresh(cached, view_dir, cos_tolerance, false))
+        {
+            cached = { view_dir.x, view_dir.y, view_dir.z, 1.f };
+            refresh_count++;
+        }
+    }
+    EXPECT_GE(refresh_count, frame_count / 6u);
+    EXPECT_LE(refresh_count, frame_count / 4u);
+}
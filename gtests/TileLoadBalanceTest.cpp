@@ -0,0 +1,100 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/TileLoadBalance.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+using pnanovdb_raster::tile_partial_t;
+
+TEST(NanoVDBEditor, TileLoadHistogramBins)
+{
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(0u), 0u);
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(1u), 1u);
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(2u), 2u);
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(3u), 2u);
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(4096u), 13u);
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(16383u), 14u);
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(16384u), PNANOVDB_RASTER_TILE_HISTOGRAM_BINS - 1u);
+    EXPECT_EQ(pnanovdb_raster::tile_histogram_bin(~0u), PNANOVDB_RASTER_TILE_HISTOGRAM_BINS - 1u);
+}
+
+TEST(NanoVDBEditor, TileLoadSplitCapacity)
+{
+    // a few heavy tiles among many light ones, the split items must fit the capacity from the total alone
+    srand(7u);
+    for (pnanovdb_uint32_t trial = 0u; trial < 64u; trial++)
+    {
+        std::vector<pnanovdb_uint32_t> tile_counts(8160u);
+        pnanovdb_uint64_t n_isects = 0u;
+        for (pnanovdb_uint32_t& count : tile_counts)
+        {
+            count = (rand() % 100 == 0) ? pnanovdb_raster::k_tile_split_threshold + rand() % 100000 : rand() % 600;
+            n_isects += count;
+        }
+        pnanovdb_uint64_t split_items = 0u;
+        for (pnanovdb_uint32_t count : tile_counts)
+        {
+            pnanovdb_uint32_t segments = pnanovdb_raster::tile_split_segments(count);
+            split_items += segments > 1u ? segments : 0u;
+        }
+        pnanovdb_uint64_t capacity = (n_isects + pnanovdb_raster::k_tile_split_size - 1u) /
+                                         pnanovdb_raster::k_tile_split_size +
+                                     (n_isects + pnanovdb_raster::k_tile_split_threshold - 1u) /
+                                         pnanovdb_raster::k_tile_split_threshold;
+        EXPECT_LE(split_items, capacity);
+    }
+
+    EXPECT_EQ(pnanovdb_raster::tile_split_segments(pnanovdb_raster::k_tile_split_threshold), 1u);
+    EXPECT_EQ(pnanovdb_raster::tile_split_segments(pnanovdb_raster::k_tile_split_threshold + 1u), 3u);
+    EXPECT_EQ(pnanovdb_raster::tile_split_capacity(pnanovdb_raster::k_tile_split_threshold, 256u), 0u);
+    // partial memory stays bounded for huge intersection counts
+    EXPECT_EQ(pnanovdb_raster::tile_split_capacity(1llu << 32u, 256u),
+              pnanovdb_raster::k_tile_partials_max_bytes / (16u * 256u));
+    EXPECT_EQ(pnanovdb_raster::tile_persistent_groups(100u, 0u, 256u), 100u);
+    EXPECT_EQ(pnanovdb_raster::tile_persistent_groups(8160u, 64u, 256u),
+              pnanovdb_raster::k_tile_persistent_threads / 256u);
+}
+
+TEST(NanoVDBEditor, TileLoadMergeMatchesSinglePass)
+{
+    // front to back blending of one pixel, whole and as segments merged in order
+    srand(11u);
+    const pnanovdb_uint32_t count = 10000u;
+    std::vector<float> alphas(count);
+    std::vector<float> colors(count);
+    for (pnanovdb_uint32_t idx = 0u; idx < count; idx++)
+    {
+        alphas[idx] = 0.0005f * float(rand() % 1000) / 1000.f;
+        colors[idx] = float(rand() % 1000) / 1000.f;
+    }
+    auto blend = [&](pnanovdb_uint32_t begin, pnanovdb_uint32_t end)
+    {
+        tile_partial_t partial = { 0.f, 0.f, 0.f, 1.f };
+        for (pnanovdb_uint32_t idx = begin; idx < end; idx++)
+        {
+            float vis = alphas[idx] * partial.transmittance;
+            partial.r += colors[idx] * vis;
+            partial.g += 0.5f * colors[idx] * vis;
+            partial.b += 0.25f * colors[idx] * vis;
+            partial.transmittance *= 1.f - alphas[idx];
+        }
+        return partial;
+    };
+
+    tile_partial_t whole = blend(0u, count);
+    tile_partial_t merged = { 0.f, 0.f, 0.f, 1.f };
+    for (pnanovdb_uint32_t begin = 0u; begin < count; begin += pnanovdb_raster::k_tile_split_size)
+    {
+        pnanovdb_uint32_t end = std::min(begin + pnanovdb_raster::k_tile_split_size, count);
+        merged = pnanovdb_raster::merge_tile_partial(merged, blend(begin, end));
+    }
+    EXPECT_NEAR(merged.r, whole.r, 1e-4f);
+    EXPECT_NEAR(merged.g, whole.g, 1e-4f);
+    EXPECT_NEAR(merged.b, whole.b, 1e-4f);
+    EXPECT_NEAR(merged.transmittance, whole.transmittance, 1e-5f);
+}
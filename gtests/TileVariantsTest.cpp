@@ -0,0 +1,42 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "raster/TileVariants.h"
+
+using pnanovdb_raster::k_tile_variants;
+using pnanovdb_raster::select_tile_variant;
+
+TEST(NanoVDBEditor, TileVariantSplatRadiusRoundTrip)
+{
+    for (pnanovdb_uint32_t idx = 0u; idx < pnanovdb_raster::k_tile_variant_count; idx++)
+    {
+        for (float radius : { 0.5f, 3.f, 20.f, 150.f })
+        {
+            float isects = pnanovdb_raster::tile_variant_isects_per_splat(k_tile_variants[idx], radius);
+            float estimate = pnanovdb_raster::tile_variant_splat_radius(k_tile_variants[idx], isects);
+            EXPECT_NEAR(estimate, radius, 1e-3f * radius);
+        }
+    }
+    EXPECT_EQ(pnanovdb_raster::tile_variant_splat_radius(k_tile_variants[0u], 0.5f), 0.f);
+}
+
+TEST(NanoVDBEditor, TileVariantExplicitSize)
+{
+    EXPECT_EQ(k_tile_variants[select_tile_variant(8u, 1920u, 1080u, 2.f)].width, 8u);
+    EXPECT_EQ(k_tile_variants[select_tile_variant(16u, 1920u, 1080u, 2.f)].width, 16u);
+    EXPECT_EQ(k_tile_variants[select_tile_variant(32u, 1920u, 1080u, 2.f)].width, 32u);
+    EXPECT_EQ(k_tile_variants[select_tile_variant(64u, 1920u, 1080u, 2.f)].width, 32u);
+}
+
+TEST(NanoVDBEditor, TileVariantAutoSelection)
+{
+    // small splats and thumbnails prefer small tiles, large splats amortize intersections over larger tiles
+    EXPECT_EQ(k_tile_variants[select_tile_variant(0u, 1920u, 1080u, 2.f)].width, 8u);
+    EXPECT_EQ(k_tile_variants[select_tile_variant(0u, 256u, 256u, 20.f)].width, 8u);
+    EXPECT_EQ(k_tile_variants[select_tile_variant(0u, 1920u, 1080u, 20.f)].width, 16u);
+    EXPECT_EQ(k_tile_variants[select_tile_variant(0u, 7680u, 4320u, 60.f)].width, 16u);
+    // unknown radius keeps the 16x16 tiles at common resolutions
+    EXPECT_EQ(k_tile_variants[select_tile_variant(0u, 1920u, 1080u, 0.f)].width, 16u);
+}
@@ -0,0 +1,231 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "nanovdb_editor/putil/Trace.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using pnanovdb_util::TraceRing;
+
+namespace
+{
+// puts slots in the states a concurrent writer leaves them in
+class TraceRingProbe : public TraceRing
+{
+public:
+    using TraceRing::TraceRing;
+
+    // writer between its sequence store and its completing store
+    void markInFlight(uint64_t index)
+    {
+        m_events[index % m_capacity].sequence.store(2u * index + 1u);
+    }
+
+    // writer that took an index but has not touched the slot yet
+    void claimIndex()
+    {
+        m_writeIndex.fetch_add(1u);
+    }
+};
+
+nlohmann::json parse_trace(const TraceRing& ring)
+{
+    nlohmann::json json = nlohmann::json::parse(ring.exportChromeJson());
+    EXPECT_EQ(json["displayTimeUnit"], "ms");
+    return json;
+}
+
+std::vector<nlohmann::json> events_of_phase(const nlohmann::json& json, const char* phase)
+{
+    std::vector<nlohmann::json> events;
+    for (const nlohmann::json& event : json["traceEvents"])
+    {
+        if (event["ph"] == phase)
+        {
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+std::vector<std::string> event_names(const nlohmann::json& json)
+{
+    std::vector<std::string> names;
+    for (const nlohmann::json& event : events_of_phase(json, "X"))
+    {
+        names.push_back(event["name"].get<std::string>());
+    }
+    return names;
+}
+} // namespace
+
+TEST(NanoVDBEditor, TraceRingRecordsNothingWhileDisabled)
+{
+    TraceRing ring(4u);
+    ring.record("cpu", "ignored", 0u, 10u, 1u);
+    nlohmann::json json = parse_trace(ring);
+    EXPECT_TRUE(events_of_phase(json, "X").empty());
+    ASSERT_EQ(events_of_phase(json, "M").size(), 1u);
+    EXPECT_EQ(events_of_phase(json, "M")[0]["args"]["name"], "nanovdb_editor");
+
+    ring.setEnabled(true);
+    ring.record("cpu", "kept", 0u, 10u, 1u);
+    ring.setEnabled(false);
+    ring.record("cpu", "ignored", 20u, 30u, 1u);
+    EXPECT_EQ(event_names(parse_trace(ring)), std::vector<std::string>{ "kept" });
+}
+
+TEST(NanoVDBEditor, TraceRingWrapsAroundKeepingTheNewestEvents)
+{
+    TraceRing ring(4u);
+    ring.setEnabled(true);
+    for (uint64_t idx = 0u; idx < 10u; idx++)
+    {
+        ring.record("cpu", ("e" + std::to_string(idx)).c_str(), 1000u * idx, 1000u * idx + 500u, 7u);
+    }
+    nlohmann::json json = parse_trace(ring);
+    EXPECT_EQ(event_names(json), (std::vector<std::string>{ "e6", "e7", "e8", "e9" }));
+
+    // timestamps in microseconds relative to the oldest exported event
+    std::vector<nlohmann::json> events = events_of_phase(json, "X");
+    for (size_t idx = 0u; idx < events.size(); idx++)
+    {
+        EXPECT_DOUBLE_EQ(events[idx]["ts"].get<double>(), double(idx));
+        EXPECT_DOUBLE_EQ(events[idx]["dur"].get<double>(), 0.5);
+        EXPECT_EQ(events[idx]["tid"], 7u);
+        EXPECT_EQ(events[idx]["pid"], 1);
+        EXPECT_EQ(events[idx]["cat"], "cpu");
+    }
+
+    // an end before the begin is clamped to an empty scope
+    ring.record("cpu", "backwards", 20000u, 10000u, 7u);
+    EXPECT_DOUBLE_EQ(events_of_phase(parse_trace(ring), "X").back()["dur"].get<double>(), 0.0);
+}
+
+TEST(NanoVDBEditor, TraceRingSkipsSlotsBeingWritten)
+{
+    TraceRingProbe ring(8u);
+    ring.setEnabled(true);
+    ring.record("cpu", "e0", 0u, 1u, 1u);
+    ring.record("cpu", "e1", 1u, 2u, 1u);
+    ring.record("cpu", "e2", 2u, 3u, 1u);
+
+    ring.markInFlight(1u);
+    EXPECT_EQ(event_names(parse_trace(ring)), (std::vector<std::string>{ "e0", "e2" }));
+}
+
+TEST(NanoVDBEditor, TraceRingSkipsSlotsClaimedButNotWritten)
+{
+    TraceRingProbe ring(2u);
+    ring.setEnabled(true);
+    ring.record("cpu", "e0", 0u, 1u, 1u);
+    ring.record("cpu", "e1", 1u, 2u, 1u);
+
+    // index 2 maps to the slot of e0, which still holds e0 and must not be exported as index 2
+    ring.claimIndex();
+    EXPECT_EQ(event_names(parse_trace(ring)), std::vector<std::string>{ "e1" });
+
+    // the next writer lands on the slot of e1
+    ring.record("cpu", "e3", 3u, 4u, 1u);
+    EXPECT_EQ(event_names(parse_trace(ring)), std::vector<std::string>{ "e3" });
+}
+
+TEST(NanoVDBEditor, TraceRingEscapesAndTruncatesLabels)
+{
+    TraceRing ring(8u);
+    ring.setEnabled(true);
+    ring.record("q\"uote", "back\\slash \"quoted\"\ttab\nline", 0u, 1u, 1u);
+    ring.record(nullptr, nullptr, 1u, 2u, 1u);
+    const std::string longName(100u, 'n');
+    const std::string longCategory(40u, 'c');
+    ring.record(longCategory.c_str(), longName.c_str(), 2u, 3u, 1u);
+
+    std::vector<nlohmann::json> events = events_of_phase(parse_trace(ring), "X");
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0]["cat"], "q\"uote");
+    EXPECT_EQ(events[0]["name"], "back\\slash \"quoted\" tab line") << "control characters become spaces";
+    EXPECT_EQ(events[1]["cat"], "");
+    EXPECT_EQ(events[1]["name"], "");
+    EXPECT_EQ(events[2]["cat"], std::string(15u, 'c'));
+    EXPECT_EQ(events[2]["name"], std::string(63u, 'n'));
+}
+
+TEST(NanoVDBEditor, TraceRingExportsTrackNames)
+{
+    TraceRing ring(8u);
+    ring.setEnabled(true);
+    uint32_t gpuTrack = ring.registerTrack("gpu \"graphics\"");
+    uint32_t unnamedTrack = ring.registerTrack(nullptr);
+    EXPECT_EQ(gpuTrack, TraceRing::kTrackIdBase);
+    EXPECT_EQ(unnamedTrack, TraceRing::kTrackIdBase + 1u);
+    EXPECT_LT(TraceRing::currentThreadId(), TraceRing::kTrackIdBase);
+
+    ring.record("gpu", "dispatch", 0u, 1000u, gpuTrack);
+    ring.record("cpu", "scope", 0u, 1000u);
+
+    nlohmann::json json = parse_trace(ring);
+    std::vector<nlohmann::json> metadata = events_of_phase(json, "M");
+    ASSERT_EQ(metadata.size(), 3u);
+    EXPECT_EQ(metadata[0]["name"], "process_name");
+    EXPECT_EQ(metadata[1]["name"], "thread_name");
+    EXPECT_EQ(metadata[1]["tid"], gpuTrack);
+    EXPECT_EQ(metadata[1]["args"]["name"], "gpu \"graphics\"");
+    EXPECT_EQ(metadata[2]["tid"], unnamedTrack);
+    EXPECT_EQ(metadata[2]["args"]["name"], "");
+
+    std::vector<nlohmann::json> events = events_of_phase(json, "X");
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0]["tid"], gpuTrack);
+    EXPECT_EQ(events[1]["tid"], TraceRing::currentThreadId());
+}
+
+TEST(NanoVDBEditor, TraceRingExportsWholeEventsUnderConcurrentWrites)
+{
+    TraceRing ring(256u);
+    ring.setEnabled(true);
+
+    // every field of an event encodes the same value, a torn copy would not match
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> writers;
+    for (uint32_t writerIdx = 0u; writerIdx < 4u; writerIdx++)
+    {
+        writers.emplace_back(
+            [&ring, &stop, writerIdx]()
+            {
+                for (uint64_t value = 1u; !stop.load(std::memory_order_relaxed); value++)
+                {
+                    std::string label = std::to_string(value);
+                    ring.record(label.c_str(), label.c_str(), 0u, value * 1000u, writerIdx + 1u);
+                }
+            });
+    }
+    // only exports racing the writers count, writers are joined before any assertion can return
+    size_t tornCount = 0u;
+    for (uint32_t exportCount = 0u; exportCount < 50u && tornCount == 0u;)
+    {
+        nlohmann::json json = nlohmann::json::parse(ring.exportChromeJson());
+        std::vector<nlohmann::json> events = events_of_phase(json, "X");
+        for (const nlohmann::json& event : events)
+        {
+            const std::string name = event["name"].get<std::string>();
+            if (event["cat"] != name || event["dur"].get<double>() != std::stod(name))
+            {
+                tornCount++;
+            }
+        }
+        exportCount += events.empty() ? 0u : 1u;
+    }
+    stop.store(true);
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+    EXPECT_EQ(tornCount, 0u);
+}
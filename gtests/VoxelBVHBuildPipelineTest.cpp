@@ -18,6 +18,7 @@
 
 #include "GpuTestSupport.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
@@ -526,3 +527,175 @@ TEST_F(VoxelBVHBuildPipelineTest, LinesFromEdgePly)
     std::error_code ec;
     std::filesystem::remove(edge_ply_path, ec);
 }
+
+namespace
+{
+
+// same two stacked squares as LinesSynthetic
+void build_square_lines(const pnanovdb_compute_t& compute,
+                        pnanovdb_compute_array_t** out_indices,
+                        pnanovdb_compute_array_t** out_positions)
+{
+    const float p[] = {
+        0.f, 0.f, 0.f,  100.f, 0.f, 0.f,  100.f, 100.f, 0.f,  0.f, 100.f, 0.f,
+        0.f, 0.f, 50.f, 100.f, 0.f, 50.f, 100.f, 100.f, 50.f, 0.f, 100.f, 50.f,
+    };
+    const uint32_t segs[] = {
+        0u, 1u, 1u, 2u, 2u, 3u, 3u, 0u, 4u, 5u, 5u, 6u, 6u, 7u, 7u, 4u,
+    };
+    *out_positions = compute.create_array(sizeof(float), sizeof(p) / sizeof(float), p);
+    *out_indices = compute.create_array(sizeof(uint32_t), sizeof(segs) / sizeof(uint32_t), segs);
+}
+
+std::vector<uint64_t> sorted_ijkl(pnanovdb_compute_array_t* ijkl_array)
+{
+    const uint64_t* ijkl = static_cast<const uint64_t*>(ijkl_array->data);
+    std::vector<uint64_t> keys(ijkl, ijkl + ijkl_array->element_count);
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+} // namespace
+
+TEST_F(VoxelBVHBuildPipelineTest, AsyncLinesFutureMatchesSync)
+{
+    ASSERT_NE(rt().voxelbvh.ijkl_from_lines_array_async, nullptr) << "ijkl_from_lines_array_async not bound";
+
+    pnanovdb_compute_array_t* indices = nullptr;
+    pnanovdb_compute_array_t* positions = nullptr;
+    build_square_lines(rt().compute, &indices, &positions);
+    ASSERT_NE(indices, nullptr);
+    ASSERT_NE(positions, nullptr);
+
+    const pnanovdb_uint32_t resolution = 128u;
+    const float inflation_radius = 1.0f;
+
+    pnanovdb_compute_array_t* sync_results[4] = {};
+    rt().voxelbvh.ijkl_from_lines_array(&rt().compute, rt().queue, rt().voxelbvh_ctx, indices, positions,
+                                        inflation_radius, &sync_results[0], &sync_results[1], &sync_results[2],
+                                        &sync_results[3], resolution);
+
+    pnanovdb_voxelbvh_future_t* future = rt().voxelbvh.ijkl_from_lines_array_async(
+        &rt().compute, rt().queue, rt().voxelbvh_ctx, indices, positions, inflation_radius, resolution);
+    ASSERT_NE(future, nullptr);
+
+    const pnanovdb_uint64_t frame = rt().voxelbvh.future_get_frame(future);
+    EXPECT_GT(frame, 0u) << "future should carry the frame returned by flush";
+    if (!rt().voxelbvh.future_is_completed(future))
+    {
+        EXPECT_EQ(rt().voxelbvh.future_take_result(future, 0u), nullptr)
+            << "results are not available before completion";
+    }
+
+    rt().voxelbvh.future_wait(future);
+    EXPECT_TRUE(rt().voxelbvh.future_is_completed(future));
+    EXPECT_TRUE(rt().compute.device_interface.is_frame_completed(rt().queue, frame));
+
+    pnanovdb_compute_array_t* async_results[4] = {};
+    for (pnanovdb_uint32_t idx = 0u; idx < 4u; idx++)
+    {
+        async_results[idx] = rt().voxelbvh.future_take_result(future, idx);
+        ASSERT_NE(async_results[idx], nullptr) << "result " << idx << " missing";
+        ASSERT_NE(sync_results[idx], nullptr) << "sync result " << idx << " missing";
+        EXPECT_EQ(async_results[idx]->element_size, sync_results[idx]->element_size);
+        EXPECT_EQ(async_results[idx]->element_count, sync_results[idx]->element_count);
+    }
+    EXPECT_EQ(rt().voxelbvh.future_take_result(future, 0u), nullptr) << "a result is handed out only once";
+    EXPECT_EQ(rt().voxelbvh.future_take_result(future, 4u), nullptr) << "lines futures hold 4 results";
+    rt().voxelbvh.future_destroy(future);
+
+    EXPECT_EQ(sorted_ijkl(async_results[0]), sorted_ijkl(sync_results[0]));
+    EXPECT_EQ(std::memcmp(async_results[3]->data, sync_results[3]->data, 6u * sizeof(float)), 0)
+        << "world bbox differs between sync and async";
+
+    for (pnanovdb_uint32_t idx = 0u; idx < 4u; idx++)
+    {
+        rt().compute.destroy_array(async_results[idx]);
+        rt().compute.destroy_array(sync_results[idx]);
+    }
+    rt().compute.destroy_array(positions);
+    rt().compute.destroy_array(indices);
+}
+
+TEST_F(VoxelBVHBuildPipelineTest, AsyncFutureDestroyedBeforeCompletion)
+{
+    pnanovdb_compute_array_t* indices = nullptr;
+    pnanovdb_compute_array_t* positions = nullptr;
+    pnanovdb_compute_array_t* colors = nullptr;
+    ASSERT_TRUE(build_heightfield_mesh(rt().compute, 8u, 8u, &indices, &positions, &colors));
+
+    // dropping a pending future releases its buffers once its frame completes and leaves the queue usable
+    pnanovdb_voxelbvh_future_t* future = rt().voxelbvh.ijkl_from_triangles_array_async(
+        &rt().compute, rt().queue, rt().voxelbvh_ctx, indices, positions, 0.f, 64u);
+    ASSERT_NE(future, nullptr);
+    rt().voxelbvh.future_destroy(future);
+
+    pnanovdb_compute_array_t* nanovdb_array = rt().voxelbvh.nanovdb_from_triangles_array(
+        &rt().compute, rt().queue, rt().voxelbvh_ctx, indices, positions, colors, 0.f, 64u);
+    expect_nanovdb_populated(nanovdb_array, /*min_bytes=*/4096u);
+
+    rt().compute.destroy_array(nanovdb_array);
+    rt().compute.destroy_array(colors);
+    rt().compute.destroy_array(positions);
+    rt().compute.destroy_array(indices);
+}
+
+TEST_F(VoxelBVHBuildPipelineTest, AsyncGaussiansFuture)
+{
+    ASSERT_NE(rt().voxelbvh.ijkl_from_gaussians_array_async, nullptr) << "ijkl_from_gaussians_array_async not bound";
+
+    // gaussians on a line along x with identity rotation and small log scales
+    const uint32_t gaussian_count = 16u;
+    std::vector<float> means(3u * gaussian_count, 0.f);
+    std::vector<float> opacities(gaussian_count, 2.f);
+    std::vector<float> quaternions(4u * gaussian_count, 0.f);
+    std::vector<float> scales(3u * gaussian_count, -2.f);
+    std::vector<float> sh_0(3u * gaussian_count, 0.5f);
+    std::vector<float> sh_n(45u * gaussian_count, 0.f);
+    for (uint32_t idx = 0u; idx < gaussian_count; idx++)
+    {
+        means[3u * idx + 0u] = float(idx);
+        quaternions[4u * idx + 0u] = 1.f;
+    }
+    pnanovdb_compute_array_t* gaussian_arrays[6] = {
+        rt().compute.create_array(sizeof(float), means.size(), means.data()),
+        rt().compute.create_array(sizeof(float), opacities.size(), opacities.data()),
+        rt().compute.create_array(sizeof(float), quaternions.size(), quaternions.data()),
+        rt().compute.create_array(sizeof(float), scales.size(), scales.data()),
+        rt().compute.create_array(sizeof(float), sh_0.size(), sh_0.data()),
+        rt().compute.create_array(sizeof(float), sh_n.size(), sh_n.data()),
+    };
+
+    EXPECT_EQ(rt().voxelbvh.ijkl_from_gaussians_array_async(
+                  &rt().compute, rt().queue, rt().voxelbvh_ctx, gaussian_arrays, 5u, 64u),
+              nullptr)
+        << "gaussian futures need all 6 arrays";
+
+    pnanovdb_voxelbvh_future_t* future = rt().voxelbvh.ijkl_from_gaussians_array_async(
+        &rt().compute, rt().queue, rt().voxelbvh_ctx, gaussian_arrays, 6u, 64u);
+    ASSERT_NE(future, nullptr);
+    rt().voxelbvh.future_wait(future);
+
+    pnanovdb_compute_array_t* ijkl_array = rt().voxelbvh.future_take_result(future, 0u);
+    pnanovdb_compute_array_t* world_bbox_array = rt().voxelbvh.future_take_result(future, 3u);
+    // results 1 and 2 are left for future_destroy
+    rt().voxelbvh.future_destroy(future);
+
+    ASSERT_NE(ijkl_array, nullptr);
+    ASSERT_NE(world_bbox_array, nullptr);
+    EXPECT_EQ(ijkl_array->element_count, 8u * gaussian_count);
+    const float* world_bbox = static_cast<const float*>(world_bbox_array->data);
+    for (uint32_t axis = 0u; axis < 3u; axis++)
+    {
+        EXPECT_LE(world_bbox[axis], world_bbox[axis + 3u]) << "empty world bbox on axis " << axis;
+    }
+    EXPECT_LE(world_bbox[0], means[0]);
+    EXPECT_GE(world_bbox[3], means[3u * (gaussian_count - 1u)]);
+
+    rt().compute.destroy_array(ijkl_array);
+    rt().compute.destroy_array(world_bbox_array);
+    for (pnanovdb_compute_array_t* gaussian_array : gaussian_arrays)
+    {
+        rt().compute.destroy_array(gaussian_array);
+    }
+}
@@ -19,6 +19,7 @@
 
 #include "Socket.h"
 #include "nanovdb_editor/putil/Compute.h"
+#include "nanovdb_editor/putil/Trace.hpp"
 #include <server/Server.h>
 
 #include <stdlib.h>
@@ -91,6 +92,12 @@ struct Window
     pnanovdb_int32_t encoder_width = 0;
     pnanovdb_int32_t encoder_height = 0;
 
+    // screenshots are pushed once their frame completes instead of waiting on the device
+    pnanovdb_compute_readback_queue_t* screenshot_readback = nullptr;
+    pnanovdb_uint32_t screenshot_width = 0u;
+    pnanovdb_uint32_t screenshot_height = 0u;
+    bool screenshot_in_flight = false;
+
     std::vector<ImguiInstance> imgui_instances;
     bool enable_default_imgui = false;
 
@@ -273,6 +280,12 @@ void destroy(const pnanovdb_compute_t* compute,
         inst.renderer = nullptr;
     }
 
+    if (ptr->screenshot_readback)
+    {
+        compute->destroy_readback_queue(compute, queue, ptr->screenshot_readback);
+        ptr->screenshot_readback = nullptr;
+    }
+
     if (ptr->encoder)
     {
         ptr->device_interface.destroy_encoder(ptr->encoder);
@@ -475,6 +488,7 @@ pnanovdb_bool_t update(const pnanovdb_compute_t* compute,
                 ptr->encoder = nullptr;
                 return PNANOVDB_FALSE;
             }
+            pnanovdb_get_server()->set_trace_scope(ptr->server, ptr->device_interface.trace_scope);
             if (log_print)
             {
                 log_print(PNANOVDB_COMPUTE_LOG_LEVEL_INFO, "Running on server %s:%d", user_settings->server_address,
@@ -591,56 +605,53 @@ pnanovdb_bool_t update(const pnanovdb_compute_t* compute,
     // encode frame
     if (ptr->encoder)
     {
-        pnanovdb_compute_buffer_t* screenshot_buf = nullptr;
-        if (ptr->server)
+        if (ptr->server && !ptr->screenshot_in_flight && ptr->imgui_instances.size() != 0u)
         {
             if (pnanovdb_get_server()->screenshot_requested(ptr->server))
             {
-                if (ptr->imgui_instances.size() != 0u)
+                if (!ptr->screenshot_readback)
+                {
+                    ptr->screenshot_readback = compute->create_readback_queue(0u);
+                }
+
+                pnanovdb_compute_buffer_desc_t buf_desc = {};
+                buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+                buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+                buf_desc.structure_stride = 4u;
+                buf_desc.size_in_bytes = 4u * ptr->width * ptr->height;
+
+                pnanovdb_compute_buffer_transient_t* screenshot_gpu_transient =
+                    ptr->compute_interface.get_buffer_transient(context, &buf_desc);
+
+                auto& inst = ptr->imgui_instances[0u];
+                inst.renderer_interface.copy_texture_to_buffer(
+                    compute, context, inst.renderer, ptr->width, ptr->height, front_texture, screenshot_gpu_transient);
+
+                if (compute->enqueue_readback(compute, compute_queue, ptr->screenshot_readback,
+                                              screenshot_gpu_transient, buf_desc.size_in_bytes) != 0u)
                 {
-                    pnanovdb_compute_buffer_desc_t buf_desc = {};
-                    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
-                    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
-                    buf_desc.structure_stride = 4u;
-                    buf_desc.size_in_bytes = 4u * ptr->width * ptr->height;
-
-                    pnanovdb_compute_buffer_t* screenshot_gpu =
-                        ptr->compute_interface.create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-
-                    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
-                    screenshot_buf =
-                        ptr->compute_interface.create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
-
-                    pnanovdb_compute_buffer_transient_t* screenshot_gpu_transient =
-                        ptr->compute_interface.register_buffer_as_transient(context, screenshot_gpu);
-                    pnanovdb_compute_buffer_transient_t* screenshot_buf_transient =
-                        ptr->compute_interface.register_buffer_as_transient(context, screenshot_buf);
-
-                    auto& inst = ptr->imgui_instances[0u];
-                    inst.renderer_interface.copy_texture_to_buffer(compute, context, inst.renderer, ptr->width,
-                                                                   ptr->height, front_texture, screenshot_gpu_transient);
-
-                    pnanovdb_compute_copy_buffer_params_t copy_params = {};
-                    copy_params.num_bytes = buf_desc.size_in_bytes;
-                    copy_params.src = screenshot_gpu_transient;
-                    copy_params.dst = screenshot_buf_transient;
-                    ptr->compute_interface.copy_buffer(context, &copy_params);
-
-                    ptr->compute_interface.destroy_buffer(context, screenshot_gpu);
+                    ptr->screenshot_width = ptr->width;
+                    ptr->screenshot_height = ptr->height;
+                    ptr->screenshot_in_flight = true;
                 }
             }
         }
 
         pnanovdb_uint64_t encoder_flushed_frame = 0llu;
-        ptr->device_interface.present_encoder(ptr->encoder, &encoder_flushed_frame);
         pnanovdb_uint64_t encoder_data_size = 0llu;
-        void* encoder_data = ptr->device_interface.map_encoder_data(ptr->encoder, &encoder_data_size);
+        void* encoder_data = nullptr;
+        {
+            pnanovdb_util::TraceScope trace_scope(&ptr->device_interface, "encoder", "present_encoder");
+            ptr->device_interface.present_encoder(ptr->encoder, &encoder_flushed_frame);
+            encoder_data = ptr->device_interface.map_encoder_data(ptr->encoder, &encoder_data_size);
+        }
         if (ptr->socket)
         {
             pnanovdb_socket_send(ptr->socket, encoder_data, encoder_data_size);
         }
         if (ptr->server)
         {
+            pnanovdb_util::TraceScope trace_scope(&ptr->device_interface, "server", "push_h264");
             pnanovdb_get_server()->push_h264(
                 ptr->server, encoder_data, encoder_data_size, ptr->encoder_width, ptr->encoder_height);
         }
@@ -650,16 +661,29 @@ pnanovdb_bool_t update(const pnanovdb_compute_t* compute,
         }
         ptr->device_interface.unmap_encoder_data(ptr->encoder);
 
-        // host-device sync happened in map_encoder_data, safe now to read screenshot readback
-        if (screenshot_buf)
+        // a later frame picks the screenshot up once the device is done with it
+        if (ptr->screenshot_in_flight)
         {
-            void* mapped = ptr->compute_interface.map_buffer(context, screenshot_buf);
-
-            pnanovdb_get_server()->push_screenshot(
-                ptr->server, mapped, 4u * ptr->width * ptr->height, ptr->width, ptr->height);
+            pnanovdb_uint64_t screenshot_size = 0llu;
+            const void* mapped =
+                compute->map_readback(compute, compute_queue, ptr->screenshot_readback, nullptr, &screenshot_size);
+            if (mapped)
+            {
+                pnanovdb_get_server()->push_screenshot(
+                    ptr->server, mapped, screenshot_size, ptr->screenshot_width, ptr->screenshot_height);
+                compute->unmap_readback(compute, compute_queue, ptr->screenshot_readback);
+                ptr->screenshot_in_flight = false;
+            }
+        }
 
-            ptr->compute_interface.unmap_buffer(context, screenshot_buf);
-            ptr->compute_interface.destroy_buffer(context, screenshot_buf);
+        // the first request starts recording, later requests return everything captured since
+        if (ptr->server && pnanovdb_get_server()->trace_requested(ptr->server))
+        {
+            ptr->device_interface.enable_trace(PNANOVDB_TRUE);
+            pnanovdb_uint64_t json_size = ptr->device_interface.export_trace(nullptr, 0llu);
+            std::vector<char> json(json_size + 1u);
+            ptr->device_interface.export_trace(json.data(), json.size());
+            pnanovdb_get_server()->push_trace(ptr->server, json.data(), json_size);
         }
     }
 
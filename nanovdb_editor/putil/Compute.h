@@ -12,6 +12,7 @@
 #ifndef NANOVDB_PUTILS_COMPUTE_H_HAS_BEEN_INCLUDED
 #define NANOVDB_PUTILS_COMPUTE_H_HAS_BEEN_INCLUDED
 
+#include "nanovdb_editor/putil/Camera.h"
 #include "nanovdb_editor/putil/Compiler.h"
 #include "nanovdb_editor/putil/Reflect.h"
 
@@ -272,6 +273,10 @@ typedef struct pnanovdb_compute_dispatch_params_t
     pnanovdb_uint32_t descriptor_write_count;
 
     const char* debug_label;
+
+    // when set, the grid dims are read as three uints at indirect_offset and grid_dim_x/y/z are ignored
+    pnanovdb_compute_buffer_transient_t* indirect_buffer;
+    pnanovdb_uint64_t indirect_offset;
 } pnanovdb_compute_dispatch_params_t;
 
 typedef struct pnanovdb_compute_copy_buffer_params_t
@@ -500,11 +505,18 @@ typedef struct pnanovdb_compute_physical_device_desc_t
     pnanovdb_bool_t device_luid_valid;
 } pnanovdb_compute_physical_device_desc_t;
 
+typedef pnanovdb_uint32_t pnanovdb_compute_descriptor_update_mode_t;
+#define PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_AUTO 0 // push descriptors if supported, else update templates
+#define PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_WRITES 1 // pooled sets filled by per write updates
+#define PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_TEMPLATE 2
+#define PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_PUSH 3
+
 typedef struct pnanovdb_compute_device_desc_t
 {
     pnanovdb_uint32_t device_index;
     pnanovdb_bool_t enable_external_usage;
     pnanovdb_compute_log_print_t log_print;
+    pnanovdb_compute_descriptor_update_mode_t descriptor_update_mode;
 } pnanovdb_compute_device_desc_t;
 
 struct pnanovdb_compute_swapchain_desc_t;
@@ -548,6 +560,7 @@ typedef struct pnanovdb_compute_profiler_entry_t
     const char* label;
     float cpu_delta_time;
     float gpu_delta_time;
+    pnanovdb_uint32_t barrier_count; // pipeline barriers recorded ahead of this entry
 } pnanovdb_compute_profiler_entry_t;
 
 typedef struct pnanovdb_compute_device_memory_stats_t
@@ -556,6 +569,17 @@ typedef struct pnanovdb_compute_device_memory_stats_t
     pnanovdb_uint64_t upload_memory_bytes;
     pnanovdb_uint64_t readback_memory_bytes;
     pnanovdb_uint64_t other_memory_bytes;
+    pnanovdb_uint64_t heap_block_count;
+    pnanovdb_uint64_t heap_block_bytes;
+    pnanovdb_uint64_t heap_used_bytes;
+    pnanovdb_uint64_t heap_largest_free_bytes;
+    pnanovdb_uint64_t suballocation_count;
+    pnanovdb_uint64_t dedicated_allocation_count; // buffers with their own vkAllocateMemory outside the heap
+    pnanovdb_uint64_t transient_requested_bytes;
+    pnanovdb_uint64_t transient_arena_bytes;
+    pnanovdb_uint64_t device_local_budget_bytes; // from VK_EXT_memory_budget, 0 when the driver does not report it
+    pnanovdb_uint64_t device_local_usage_bytes; // process wide usage of device local heaps, includes other APIs
+    pnanovdb_uint64_t dedicated_block_count; // heap blocks holding a single dedicated allocation
 } pnanovdb_compute_device_memory_stats_t;
 
 typedef void(PNANOVDB_ABI* pnanovdb_profiler_report_t)(void* userdata,
@@ -563,6 +587,15 @@ typedef void(PNANOVDB_ABI* pnanovdb_profiler_report_t)(void* userdata,
                                                        pnanovdb_uint32_t num_entries,
                                                        pnanovdb_compute_profiler_entry_t* entries);
 
+// invoked on the thread that observes completion of frame, from flush, wait or poll on the owning queue
+typedef void(PNANOVDB_ABI* pnanovdb_compute_frame_callback_t)(void* userdata, pnanovdb_uint64_t frame);
+
+// trace timestamps are steady clock nanoseconds, name and category are copied
+typedef void(PNANOVDB_ABI* pnanovdb_compute_trace_scope_t)(const char* category,
+                                                           const char* name,
+                                                           pnanovdb_uint64_t begin_ns,
+                                                           pnanovdb_uint64_t end_ns);
+
 typedef struct pnanovdb_compute_device_interface_t
 {
     PNANOVDB_REFLECT_INTERFACE();
@@ -658,6 +691,30 @@ typedef struct pnanovdb_compute_device_interface_t
 
     pnanovdb_uint32_t(PNANOVDB_ABI* get_device_index)(const pnanovdb_compute_device_t* device);
 
+    // frame returned by flush is the completion token, polling does not block
+    pnanovdb_bool_t(PNANOVDB_ABI* is_frame_completed)(pnanovdb_compute_queue_t* queue, pnanovdb_uint64_t frame);
+
+    // callback fires once frame completes, immediately if it already has, callbacks fire in frame order
+    void(PNANOVDB_ABI* add_frame_callback)(pnanovdb_compute_queue_t* queue,
+                                           pnanovdb_uint64_t frame,
+                                           pnanovdb_compute_frame_callback_t callback,
+                                           void* userdata);
+
+    // process wide trace ring, cpu scopes from any thread plus gpu passes and queue submits while enabled
+    void(PNANOVDB_ABI* enable_trace)(pnanovdb_bool_t enabled);
+
+    pnanovdb_uint64_t(PNANOVDB_ABI* trace_timestamp)();
+
+    void(PNANOVDB_ABI* trace_scope)(const char* category,
+                                    const char* name,
+                                    pnanovdb_uint64_t begin_ns,
+                                    pnanovdb_uint64_t end_ns);
+
+    // writes chrome trace json, returns the full size so a null dst can query it
+    pnanovdb_uint64_t(PNANOVDB_ABI* export_trace)(char* dst, pnanovdb_uint64_t dst_size);
+
+    pnanovdb_bool_t(PNANOVDB_ABI* save_trace)(const char* path);
+
 } pnanovdb_compute_device_interface_t;
 
 #define PNANOVDB_REFLECT_TYPE pnanovdb_compute_device_interface_t
@@ -695,6 +752,13 @@ PNANOVDB_REFLECT_FUNCTION_POINTER(enable_profiler, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(disable_profiler, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(set_resource_min_lifetime, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(get_device_index, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(is_frame_completed, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(add_frame_callback, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(enable_trace, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(trace_timestamp, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(trace_scope, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(export_trace, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(save_trace, 0, 0)
 PNANOVDB_REFLECT_END(0)
 PNANOVDB_REFLECT_INTERFACE_IMPL()
 #undef PNANOVDB_REFLECT_TYPE
@@ -779,6 +843,62 @@ PNANOVDB_REFLECT_POINTER(char, filepath, 0, 0)
 PNANOVDB_REFLECT_END(0)
 #undef PNANOVDB_REFLECT_TYPE
 
+struct pnanovdb_compute_paged_nanovdb_t;
+typedef struct pnanovdb_compute_paged_nanovdb_t pnanovdb_compute_paged_nanovdb_t;
+
+typedef struct pnanovdb_compute_paged_nanovdb_stats_t
+{
+    pnanovdb_uint64_t skeleton_size_in_bytes;
+    pnanovdb_uint64_t page_size_in_bytes;
+    pnanovdb_uint32_t page_count;
+    pnanovdb_uint32_t pool_page_count;
+    pnanovdb_uint32_t resident_page_count;
+    pnanovdb_uint32_t pending_page_count;
+} pnanovdb_compute_paged_nanovdb_stats_t;
+
+struct pnanovdb_compute_nanovdb_upload_t;
+typedef struct pnanovdb_compute_nanovdb_upload_t pnanovdb_compute_nanovdb_upload_t;
+
+typedef struct pnanovdb_compute_nanovdb_upload_stats_t
+{
+    pnanovdb_uint64_t device_size_in_bytes; // capacity of the device buffer, may exceed the array size
+    pnanovdb_uint64_t staging_size_in_bytes;
+    pnanovdb_uint64_t last_upload_bytes; // bytes copied by the latest update
+    pnanovdb_uint64_t total_upload_bytes;
+    pnanovdb_uint32_t full_upload_count;
+    pnanovdb_uint32_t partial_upload_count;
+} pnanovdb_compute_nanovdb_upload_stats_t;
+
+struct pnanovdb_compute_readback_queue_t;
+typedef struct pnanovdb_compute_readback_queue_t pnanovdb_compute_readback_queue_t;
+
+#define PNANOVDB_COMPUTE_GRID_NAME_MAX 256
+
+typedef struct pnanovdb_compute_grid_info_t
+{
+    char grid_name[PNANOVDB_COMPUTE_GRID_NAME_MAX];
+    pnanovdb_uint32_t segment_index;
+    pnanovdb_uint32_t grid_index; // index within the segment
+    pnanovdb_uint32_t grid_type;
+    pnanovdb_uint32_t grid_class;
+    pnanovdb_uint32_t codec; // 0 none, 1 zip, 2 blosc
+    pnanovdb_uint32_t version;
+    pnanovdb_uint64_t grid_size; // uncompressed size in bytes
+    pnanovdb_uint64_t file_size; // size in bytes as stored in the file
+    pnanovdb_uint64_t file_offset; // byte offset of the stored grid in the file
+    pnanovdb_uint64_t active_voxel_count;
+    pnanovdb_uint32_t node_count[3]; // leaf, lower, upper
+    pnanovdb_uint32_t pad;
+    pnanovdb_coord_t index_bbox_min;
+    pnanovdb_coord_t index_bbox_max;
+    double world_bbox_min[3];
+    double world_bbox_max[3];
+    double voxel_size[3];
+} pnanovdb_compute_grid_info_t;
+
+struct pnanovdb_compute_nanovdb_file_t;
+typedef struct pnanovdb_compute_nanovdb_file_t pnanovdb_compute_nanovdb_file_t;
+
 typedef pnanovdb_uint32_t pnanovdb_compiler_api_t;
 
 typedef struct pnanovdb_compute_t
@@ -850,6 +970,109 @@ typedef struct pnanovdb_compute_t
                                                                       pnanovdb_uint32_t width,
                                                                       pnanovdb_uint32_t height);
     pnanovdb_compute_array_t*(PNANOVDB_ABI* duplicate_array)(pnanovdb_compute_array_t* array);
+    // returns a new array holding the float grid followed by level_count 2x downsampled grids
+    pnanovdb_compute_array_t*(PNANOVDB_ABI* create_nanovdb_lod)(pnanovdb_compute_array_t* nanovdb_array,
+                                                                pnanovdb_uint32_t level_count);
+    // leaf nodes are paged into a fixed size device pool, from nanovdb_array if set, else grid grid_idx of filepath
+    // is memory mapped and never loaded whole, mapped grids must be uncompressed
+    pnanovdb_compute_paged_nanovdb_t*(PNANOVDB_ABI* create_paged_nanovdb)(const char* filepath,
+                                                                          pnanovdb_uint32_t grid_idx,
+                                                                          pnanovdb_compute_array_t* nanovdb_array,
+                                                                          pnanovdb_uint64_t pool_size_in_bytes);
+    void(PNANOVDB_ABI* destroy_paged_nanovdb)(const pnanovdb_compute_t* compute,
+                                              pnanovdb_compute_queue_t* queue,
+                                              pnanovdb_compute_paged_nanovdb_t* paged);
+    void(PNANOVDB_ABI* prefetch_paged_nanovdb)(pnanovdb_compute_paged_nanovdb_t* paged,
+                                               const pnanovdb_camera_mat_t* view,
+                                               const pnanovdb_camera_mat_t* projection,
+                                               pnanovdb_bool_t auto_center);
+    pnanovdb_bool_t(PNANOVDB_ABI* dispatch_shader_on_paged_nanovdb)(const pnanovdb_compute_t* compute,
+                                                                    const pnanovdb_compute_device_t* device,
+                                                                    const pnanovdb_shader_context_t* shader_context,
+                                                                    pnanovdb_compute_paged_nanovdb_t* paged,
+                                                                    pnanovdb_int32_t image_width,
+                                                                    pnanovdb_int32_t image_height,
+                                                                    pnanovdb_compute_texture_t* background_image,
+                                                                    pnanovdb_compute_buffer_transient_t* upload_buffer,
+                                                                    pnanovdb_compute_buffer_transient_t* user_upload_buffer);
+    void(PNANOVDB_ABI* get_paged_nanovdb_stats)(pnanovdb_compute_paged_nanovdb_t* paged,
+                                                pnanovdb_compute_paged_nanovdb_stats_t* dst_stats);
+    // reads only file headers, fills up to dst_capacity entries and returns the total grid count, 0 on failure
+    pnanovdb_uint32_t(PNANOVDB_ABI* read_nanovdb_grid_info)(const char* filepath,
+                                                            pnanovdb_compute_grid_info_t* dst_infos,
+                                                            pnanovdb_uint32_t dst_capacity);
+    // enumerates all grids of all segments, grid bytes are only read on first request
+    pnanovdb_compute_nanovdb_file_t*(PNANOVDB_ABI* open_nanovdb_file)(const char* filepath);
+    // waits for pending loads and destroys every array returned for this file
+    void(PNANOVDB_ABI* close_nanovdb_file)(pnanovdb_compute_nanovdb_file_t* file);
+    pnanovdb_uint32_t(PNANOVDB_ABI* get_nanovdb_file_grid_count)(pnanovdb_compute_nanovdb_file_t* file);
+    pnanovdb_bool_t(PNANOVDB_ABI* get_nanovdb_file_grid_info)(pnanovdb_compute_nanovdb_file_t* file,
+                                                              pnanovdb_uint32_t grid_idx,
+                                                              pnanovdb_compute_grid_info_t* dst_info);
+    // starts a background load if needed, returns the grid once resident, nullptr while loading
+    pnanovdb_compute_array_t*(PNANOVDB_ABI* request_nanovdb_file_grid)(pnanovdb_compute_nanovdb_file_t* file,
+                                                                       pnanovdb_uint32_t grid_idx);
+    // blocking variant of request_nanovdb_file_grid, the returned array is owned by the file
+    pnanovdb_compute_array_t*(PNANOVDB_ABI* get_nanovdb_file_grid)(pnanovdb_compute_nanovdb_file_t* file,
+                                                                   pnanovdb_uint32_t grid_idx);
+    // host bytes changed in place, device copies kept by nanovdb uploads refresh only the marked ranges
+    void(PNANOVDB_ABI* mark_array_dirty)(pnanovdb_compute_array_t* array,
+                                         pnanovdb_uint64_t byte_offset,
+                                         pnanovdb_uint64_t num_bytes);
+    // persistent device copy of a nanovdb array fed through a staging ring, 0 selects the default ring size
+    pnanovdb_compute_nanovdb_upload_t*(PNANOVDB_ABI* create_nanovdb_upload)(pnanovdb_uint64_t staging_size_in_bytes);
+    void(PNANOVDB_ABI* destroy_nanovdb_upload)(const pnanovdb_compute_t* compute,
+                                               pnanovdb_compute_queue_t* queue,
+                                               pnanovdb_compute_nanovdb_upload_t* upload);
+    // copies the array or only its dirty ranges, returns the device buffer or nullptr on failure
+    pnanovdb_compute_buffer_t*(PNANOVDB_ABI* update_nanovdb_upload)(const pnanovdb_compute_t* compute,
+                                                                    pnanovdb_compute_queue_t* queue,
+                                                                    pnanovdb_compute_nanovdb_upload_t* upload,
+                                                                    pnanovdb_compute_array_t* array);
+    void(PNANOVDB_ABI* get_nanovdb_upload_stats)(pnanovdb_compute_nanovdb_upload_t* upload,
+                                                 pnanovdb_compute_nanovdb_upload_stats_t* dst_stats);
+    // depth readback buffers in flight, results are mapped in order once their frame completes, 0 selects 3
+    pnanovdb_compute_readback_queue_t*(PNANOVDB_ABI* create_readback_queue)(pnanovdb_uint32_t depth);
+    void(PNANOVDB_ABI* destroy_readback_queue)(const pnanovdb_compute_t* compute,
+                                               pnanovdb_compute_queue_t* queue,
+                                               pnanovdb_compute_readback_queue_t* readback_queue);
+    // records a copy into the next free buffer, returns its ticket or 0 when all buffers are still in flight
+    pnanovdb_uint64_t(PNANOVDB_ABI* enqueue_readback)(const pnanovdb_compute_t* compute,
+                                                      pnanovdb_compute_queue_t* queue,
+                                                      pnanovdb_compute_readback_queue_t* readback_queue,
+                                                      pnanovdb_compute_buffer_transient_t* src,
+                                                      pnanovdb_uint64_t num_bytes);
+    // never blocks, returns nullptr until the oldest result is complete, unmap_readback releases it
+    const void*(PNANOVDB_ABI* map_readback)(const pnanovdb_compute_t* compute,
+                                            pnanovdb_compute_queue_t* queue,
+                                            pnanovdb_compute_readback_queue_t* readback_queue,
+                                            pnanovdb_uint64_t* dst_ticket,
+                                            pnanovdb_uint64_t* dst_num_bytes);
+    void(PNANOVDB_ABI* unmap_readback)(const pnanovdb_compute_t* compute,
+                                       pnanovdb_compute_queue_t* queue,
+                                       pnanovdb_compute_readback_queue_t* readback_queue);
+    // dispatch_shader_on_array without waiting, data_out sizes the result that arrives through the readback queue
+    pnanovdb_uint64_t(PNANOVDB_ABI* dispatch_shader_on_array_async)(const pnanovdb_compute_t* compute,
+                                                                    const pnanovdb_compute_device_t* device,
+                                                                    const char* shader_path,
+                                                                    pnanovdb_uint32_t grid_dim_x,
+                                                                    pnanovdb_uint32_t grid_dim_y,
+                                                                    pnanovdb_uint32_t grid_dim_z,
+                                                                    pnanovdb_compute_array_t* data_in,
+                                                                    pnanovdb_compute_array_t* constants,
+                                                                    pnanovdb_compute_array_t* data_out,
+                                                                    pnanovdb_uint32_t dispatch_count,
+                                                                    pnanovdb_uint64_t scratch_size,
+                                                                    pnanovdb_uint64_t scratch_clear_size,
+                                                                    pnanovdb_compute_readback_queue_t* readback_queue);
+    // dispatch_shader with the grid dims written by an earlier pass, the buffer needs INDIRECT usage
+    void(PNANOVDB_ABI* dispatch_shader_indirect)(pnanovdb_compute_interface_t* contextInterface,
+                                                 pnanovdb_compute_context_t* computeContext,
+                                                 const pnanovdb_shader_context_t* shaderContext,
+                                                 pnanovdb_compute_resource_t* resources,
+                                                 pnanovdb_compute_buffer_transient_t* indirect_buffer,
+                                                 pnanovdb_uint64_t indirect_offset,
+                                                 const char* debug_label);
 } pnanovdb_compute_t;
 
 #define PNANOVDB_REFLECT_TYPE pnanovdb_compute_t
@@ -874,6 +1097,31 @@ PNANOVDB_REFLECT_FUNCTION_POINTER(unmap_array, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(compute_array_print_range, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_from_image_rgba8, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(duplicate_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(create_nanovdb_lod, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(create_paged_nanovdb, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(destroy_paged_nanovdb, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(prefetch_paged_nanovdb, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(dispatch_shader_on_paged_nanovdb, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(get_paged_nanovdb_stats, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(read_nanovdb_grid_info, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(open_nanovdb_file, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(close_nanovdb_file, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(get_nanovdb_file_grid_count, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(get_nanovdb_file_grid_info, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(request_nanovdb_file_grid, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(get_nanovdb_file_grid, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(mark_array_dirty, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(create_nanovdb_upload, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(destroy_nanovdb_upload, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(update_nanovdb_upload, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(get_nanovdb_upload_stats, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(create_readback_queue, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(destroy_readback_queue, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(enqueue_readback, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(map_readback, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(unmap_readback, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(dispatch_shader_on_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(dispatch_shader_indirect, 0, 0)
 PNANOVDB_REFLECT_END(0)
 PNANOVDB_REFLECT_INTERFACE_IMPL()
 #undef PNANOVDB_REFLECT_TYPE
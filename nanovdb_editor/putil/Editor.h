@@ -66,6 +66,8 @@ typedef struct pnanovdb_editor_config_t
     pnanovdb_bool_t streaming;
     pnanovdb_bool_t stream_to_file;
     const char* ui_profile_name;
+    pnanovdb_uint32_t residency_budget_mb; // NanoVDB grids larger than this are paged, 0 keeps them fully resident
+    pnanovdb_uint32_t gpu_memory_budget_mb; // unrendered scene objects are evicted above this, 0 uses the driver budget
 } pnanovdb_editor_config_t;
 
 #define PNANOVDB_EDITOR_RESOLVED_PORT_UNRESOLVED -1
@@ -246,6 +248,15 @@ typedef struct pnanovdb_editor_t
                                                            pnanovdb_uint64_t error_buf_size);
     const pnanovdb_reflect_data_type_t*(PNANOVDB_ABI* get_custom_scene_params_data_type)(pnanovdb_editor_t* editor,
                                                                                          pnanovdb_editor_token_t* scene);
+
+    // Overwrites num_bytes of the object's NanoVDB at byte_offset in place. Only the edited range is copied to the
+    // device on the next render instead of the whole grid. Returns PNANOVDB_FALSE if the range does not fit.
+    pnanovdb_bool_t(PNANOVDB_ABI* update_nanovdb_range)(pnanovdb_editor_t* editor,
+                                                        pnanovdb_editor_token_t* scene,
+                                                        pnanovdb_editor_token_t* name,
+                                                        const void* data,
+                                                        pnanovdb_uint64_t byte_offset,
+                                                        pnanovdb_uint64_t num_bytes);
 } pnanovdb_editor_t;
 
 #define PNANOVDB_REFLECT_TYPE pnanovdb_editor_t
@@ -290,6 +301,7 @@ PNANOVDB_REFLECT_FUNCTION_POINTER(map_pipeline_params, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(unmap_pipeline_params, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(set_custom_scene_params, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(get_custom_scene_params_data_type, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(update_nanovdb_range, 0, 0)
 PNANOVDB_REFLECT_END(0)
 PNANOVDB_REFLECT_INTERFACE_IMPL()
 #undef PNANOVDB_REFLECT_TYPE
@@ -19,6 +19,10 @@
 struct pnanovdb_parallel_primitives_context_t;
 typedef struct pnanovdb_parallel_primitives_context_t pnanovdb_parallel_primitives_context_t;
 
+#define PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_AUTO 0 // onesweep when the key count fits its status words
+#define PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_MULTI_PASS 1 // count, scan and scatter per 4-bit digit
+#define PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_ONESWEEP 2 // one pass per 8-bit digit with decoupled lookback
+
 typedef struct pnanovdb_parallel_primitives_t
 {
     PNANOVDB_REFLECT_INTERFACE();
@@ -83,6 +87,168 @@ typedef struct pnanovdb_parallel_primitives_t
                                          pnanovdb_uint64_t buffer_key_count,
                                          pnanovdb_uint32_t key_bit_count);
 
+    // selects the radix sort used by radix_sort, radix_sort_dual_key and radix_sort_key64
+    void(PNANOVDB_ABI* set_radix_sort_mode)(pnanovdb_parallel_primitives_context_t* context,
+                                            pnanovdb_uint32_t radix_sort_mode);
+
+    // inclusive sum that restarts at every value with a nonzero flag
+    void(PNANOVDB_ABI* segmented_scan)(const pnanovdb_compute_t* compute,
+                                       pnanovdb_compute_queue_t* queue,
+                                       pnanovdb_parallel_primitives_context_t* context,
+                                       pnanovdb_compute_buffer_t* val_in,
+                                       pnanovdb_compute_buffer_t* flag_in,
+                                       pnanovdb_compute_buffer_t* val_out,
+                                       pnanovdb_uint64_t val_count);
+
+    // stable sort within segments, flag_in is 1 at the first key of each segment and 0 elsewhere
+    void(PNANOVDB_ABI* segmented_radix_sort)(const pnanovdb_compute_t* compute,
+                                             pnanovdb_compute_queue_t* queue,
+                                             pnanovdb_parallel_primitives_context_t* context_in,
+                                             pnanovdb_compute_buffer_t* key_inout,
+                                             pnanovdb_compute_buffer_t* val_inout,
+                                             pnanovdb_compute_buffer_t* flag_in,
+                                             pnanovdb_uint64_t key_count,
+                                             pnanovdb_uint64_t buffer_key_count,
+                                             pnanovdb_uint32_t key_bit_count);
+
+    // stable compaction of the values with a nonzero flag, count_out[0] receives the selected count if not null
+    void(PNANOVDB_ABI* select_if)(const pnanovdb_compute_t* compute,
+                                  pnanovdb_compute_queue_t* queue,
+                                  pnanovdb_parallel_primitives_context_t* context,
+                                  pnanovdb_compute_buffer_t* val_in,
+                                  pnanovdb_compute_buffer_t* flag_in,
+                                  pnanovdb_compute_buffer_t* val_out,
+                                  pnanovdb_compute_buffer_t* count_out,
+                                  pnanovdb_uint64_t val_count);
+
+    // select_if followed by the rejected values in their original order
+    void(PNANOVDB_ABI* partition)(const pnanovdb_compute_t* compute,
+                                  pnanovdb_compute_queue_t* queue,
+                                  pnanovdb_parallel_primitives_context_t* context,
+                                  pnanovdb_compute_buffer_t* val_in,
+                                  pnanovdb_compute_buffer_t* flag_in,
+                                  pnanovdb_compute_buffer_t* val_out,
+                                  pnanovdb_compute_buffer_t* count_out,
+                                  pnanovdb_uint64_t val_count);
+
+    // begin and end index pairs of the runs of equal keys, pairs from the run count up to key_count are zeroed,
+    // count_out[0] receives the run count if not null
+    void(PNANOVDB_ABI* run_length_encode)(const pnanovdb_compute_t* compute,
+                                          pnanovdb_compute_queue_t* queue,
+                                          pnanovdb_parallel_primitives_context_t* context,
+                                          pnanovdb_compute_buffer_t* key_in,
+                                          pnanovdb_compute_buffer_t* range_out,
+                                          pnanovdb_compute_buffer_t* count_out,
+                                          pnanovdb_uint64_t key_count);
+
+    void(PNANOVDB_ABI* run_length_encode_key64)(const pnanovdb_compute_t* compute,
+                                                pnanovdb_compute_queue_t* queue,
+                                                pnanovdb_parallel_primitives_context_t* context,
+                                                pnanovdb_compute_buffer_t* key_in,
+                                                pnanovdb_compute_buffer_t* range_out,
+                                                pnanovdb_compute_buffer_t* count_out,
+                                                pnanovdb_uint64_t key_count);
+
+    // host array versions of the entry points above, with the same results. A context created with a null queue
+    // runs them on host threads for machines without a device, otherwise the arrays round trip through the device.
+    void(PNANOVDB_ABI* global_scan_array)(const pnanovdb_compute_t* compute,
+                                          pnanovdb_compute_queue_t* queue,
+                                          pnanovdb_parallel_primitives_context_t* context,
+                                          pnanovdb_compute_array_t* val_in,
+                                          pnanovdb_compute_array_t* val_out,
+                                          pnanovdb_uint64_t val_count);
+
+    void(PNANOVDB_ABI* global_scan_uint64_array)(const pnanovdb_compute_t* compute,
+                                                 pnanovdb_compute_queue_t* queue,
+                                                 pnanovdb_parallel_primitives_context_t* context,
+                                                 pnanovdb_compute_array_t* val_in,
+                                                 pnanovdb_compute_array_t* val_out,
+                                                 pnanovdb_uint64_t val_count);
+
+    void(PNANOVDB_ABI* global_scan_max_array)(const pnanovdb_compute_t* compute,
+                                              pnanovdb_compute_queue_t* queue,
+                                              pnanovdb_parallel_primitives_context_t* context,
+                                              pnanovdb_compute_array_t* val_in,
+                                              pnanovdb_compute_array_t* val_out,
+                                              pnanovdb_uint64_t val_count);
+
+    void(PNANOVDB_ABI* radix_sort_array)(const pnanovdb_compute_t* compute,
+                                         pnanovdb_compute_queue_t* queue,
+                                         pnanovdb_parallel_primitives_context_t* context,
+                                         pnanovdb_compute_array_t* key_inout,
+                                         pnanovdb_compute_array_t* val_inout,
+                                         pnanovdb_uint64_t key_count,
+                                         pnanovdb_uint32_t key_bit_count);
+
+    void(PNANOVDB_ABI* radix_sort_dual_key_array)(const pnanovdb_compute_t* compute,
+                                                  pnanovdb_compute_queue_t* queue,
+                                                  pnanovdb_parallel_primitives_context_t* context,
+                                                  pnanovdb_compute_array_t* key_low_inout,
+                                                  pnanovdb_compute_array_t* key_high_inout,
+                                                  pnanovdb_compute_array_t* val_inout,
+                                                  pnanovdb_uint64_t key_count,
+                                                  pnanovdb_uint32_t key_low_bit_count,
+                                                  pnanovdb_uint32_t key_high_bit_count);
+
+    void(PNANOVDB_ABI* radix_sort_key64_array)(const pnanovdb_compute_t* compute,
+                                               pnanovdb_compute_queue_t* queue,
+                                               pnanovdb_parallel_primitives_context_t* context,
+                                               pnanovdb_compute_array_t* key_inout,
+                                               pnanovdb_compute_array_t* val_inout,
+                                               pnanovdb_uint64_t key_count,
+                                               pnanovdb_uint32_t key_bit_count);
+
+    void(PNANOVDB_ABI* segmented_scan_array)(const pnanovdb_compute_t* compute,
+                                             pnanovdb_compute_queue_t* queue,
+                                             pnanovdb_parallel_primitives_context_t* context,
+                                             pnanovdb_compute_array_t* val_in,
+                                             pnanovdb_compute_array_t* flag_in,
+                                             pnanovdb_compute_array_t* val_out,
+                                             pnanovdb_uint64_t val_count);
+
+    void(PNANOVDB_ABI* segmented_radix_sort_array)(const pnanovdb_compute_t* compute,
+                                                   pnanovdb_compute_queue_t* queue,
+                                                   pnanovdb_parallel_primitives_context_t* context,
+                                                   pnanovdb_compute_array_t* key_inout,
+                                                   pnanovdb_compute_array_t* val_inout,
+                                                   pnanovdb_compute_array_t* flag_in,
+                                                   pnanovdb_uint64_t key_count,
+                                                   pnanovdb_uint32_t key_bit_count);
+
+    void(PNANOVDB_ABI* select_if_array)(const pnanovdb_compute_t* compute,
+                                        pnanovdb_compute_queue_t* queue,
+                                        pnanovdb_parallel_primitives_context_t* context,
+                                        pnanovdb_compute_array_t* val_in,
+                                        pnanovdb_compute_array_t* flag_in,
+                                        pnanovdb_compute_array_t* val_out,
+                                        pnanovdb_compute_array_t* count_out,
+                                        pnanovdb_uint64_t val_count);
+
+    void(PNANOVDB_ABI* partition_array)(const pnanovdb_compute_t* compute,
+                                        pnanovdb_compute_queue_t* queue,
+                                        pnanovdb_parallel_primitives_context_t* context,
+                                        pnanovdb_compute_array_t* val_in,
+                                        pnanovdb_compute_array_t* flag_in,
+                                        pnanovdb_compute_array_t* val_out,
+                                        pnanovdb_compute_array_t* count_out,
+                                        pnanovdb_uint64_t val_count);
+
+    void(PNANOVDB_ABI* run_length_encode_array)(const pnanovdb_compute_t* compute,
+                                                pnanovdb_compute_queue_t* queue,
+                                                pnanovdb_parallel_primitives_context_t* context,
+                                                pnanovdb_compute_array_t* key_in,
+                                                pnanovdb_compute_array_t* range_out,
+                                                pnanovdb_compute_array_t* count_out,
+                                                pnanovdb_uint64_t key_count);
+
+    void(PNANOVDB_ABI* run_length_encode_key64_array)(const pnanovdb_compute_t* compute,
+                                                      pnanovdb_compute_queue_t* queue,
+                                                      pnanovdb_parallel_primitives_context_t* context,
+                                                      pnanovdb_compute_array_t* key_in,
+                                                      pnanovdb_compute_array_t* range_out,
+                                                      pnanovdb_compute_array_t* count_out,
+                                                      pnanovdb_uint64_t key_count);
+
     const pnanovdb_compute_t* compute;
 
 } pnanovdb_parallel_primitives_t;
@@ -97,6 +263,25 @@ PNANOVDB_REFLECT_FUNCTION_POINTER(global_scan_max, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(radix_sort, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(radix_sort_dual_key, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(radix_sort_key64, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(set_radix_sort_mode, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(segmented_scan, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(segmented_radix_sort, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(select_if, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(partition, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(run_length_encode, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(run_length_encode_key64, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(global_scan_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(global_scan_uint64_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(global_scan_max_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(radix_sort_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(radix_sort_dual_key_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(radix_sort_key64_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(segmented_scan_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(segmented_radix_sort_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(select_if_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(partition_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(run_length_encode_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(run_length_encode_key64_array, 0, 0)
 PNANOVDB_REFLECT_POINTER(pnanovdb_compute_t, compute, 0, 0)
 PNANOVDB_REFLECT_END(0)
 PNANOVDB_REFLECT_INTERFACE_IMPL()
@@ -23,6 +23,11 @@ typedef struct pnanovdb_raster_context_t pnanovdb_raster_context_t;
 struct pnanovdb_raster_gaussian_data_t;
 typedef struct pnanovdb_raster_gaussian_data_t pnanovdb_raster_gaussian_data_t;
 
+// tile sort of raster_gaussian_2d, auto sorts coherently while the camera moves little between frames
+#define PNANOVDB_RASTER_TILE_SORT_AUTO 0
+#define PNANOVDB_RASTER_TILE_SORT_FULL 1
+#define PNANOVDB_RASTER_TILE_SORT_COHERENT 2
+
 typedef struct pnanovdb_raster_shader_params_t
 {
     float eps2d;
@@ -30,6 +35,9 @@ typedef struct pnanovdb_raster_shader_params_t
     pnanovdb_uint32_t tile_size;
     pnanovdb_int32_t sh_degree_override;
     pnanovdb_uint32_t sh_stride_rgbrgbrgb_override;
+    float cull_radius_2d;
+    pnanovdb_uint32_t tile_sort_mode;
+    float sh_cache_angle;
 
     const pnanovdb_reflect_data_type_t* data_type;
     const char* name; // displayed in UI
@@ -38,9 +46,12 @@ typedef struct pnanovdb_raster_shader_params_t
 static const pnanovdb_raster_shader_params_t default_shader_params = {
     0.3f, // eps2d
     0.f, // min_radius_2d
-    16u, // tile_size
+    0u, // tile_size, 8, 16 or 32 picks the rasterizer tile of that width, 0 picks from image and splat size
     -1, // sh_degree override, <0 means loaded SH degree
     0, // sh_stride_rgbrgbrgb override, 0 means SH are packed rrr...ggg...bbb
+    0.f, // cull_radius_2d, chunks projecting to a smaller radius in pixels are skipped, 0 disables
+    PNANOVDB_RASTER_TILE_SORT_AUTO, // tile_sort_mode
+    0.5f, // sh_cache_angle, degrees the view turns before a chunk evaluates its SH again, 0 evaluates every frame
     NULL, // data_type
     NULL // name
 };
@@ -52,9 +63,36 @@ PNANOVDB_REFLECT_VALUE(float, min_radius_2d, 0, 0)
 PNANOVDB_REFLECT_VALUE(pnanovdb_uint32_t, tile_size, 0, 0)
 PNANOVDB_REFLECT_VALUE(pnanovdb_int32_t, sh_degree_override, 0, 0)
 PNANOVDB_REFLECT_VALUE(pnanovdb_uint32_t, sh_stride_rgbrgbrgb_override, 0, 0)
+PNANOVDB_REFLECT_VALUE(float, cull_radius_2d, 0, 0)
+PNANOVDB_REFLECT_VALUE(pnanovdb_uint32_t, tile_sort_mode, 0, 0)
+PNANOVDB_REFLECT_VALUE(float, sh_cache_angle, 0, 0)
 PNANOVDB_REFLECT_END(&default_shader_params)
 #undef PNANOVDB_REFLECT_TYPE
 
+// bins of the tile intersection histogram, bin 0 counts empty tiles, bin b counts [2^(b-1), 2^b) intersections
+#define PNANOVDB_RASTER_TILE_HISTOGRAM_BINS 16
+
+// gaussian counts of raster_gaussian_2d, summed over the calls since the last query
+typedef struct pnanovdb_raster_gaussian_cull_stats_t
+{
+    pnanovdb_uint64_t point_count;
+    pnanovdb_uint64_t visible_point_count;
+    pnanovdb_uint64_t chunk_count;
+    pnanovdb_uint64_t visible_chunk_count;
+    pnanovdb_uint64_t intersection_count;
+    pnanovdb_uint32_t raster_count;
+    pnanovdb_uint32_t coherent_sort_count; // rasters that reused the previous depth order
+    pnanovdb_uint32_t coherent_fallback_count; // coherent rasters that still needed the full sort
+    pnanovdb_uint64_t sh_refresh_chunk_count; // visible chunks that evaluated their SH, the rest kept cached colors
+    // tile load of the rasterizer, read back a few frames late so summed over tile_stats_count rasters
+    pnanovdb_uint32_t tile_stats_count;
+    pnanovdb_uint32_t max_tile_intersections;
+    pnanovdb_uint64_t tile_count;
+    pnanovdb_uint64_t split_tile_count; // tiles rasterized as several work items
+    pnanovdb_uint64_t tile_work_item_count;
+    pnanovdb_uint64_t tile_histogram[PNANOVDB_RASTER_TILE_HISTOGRAM_BINS];
+} pnanovdb_raster_gaussian_cull_stats_t;
+
 typedef struct pnanovdb_raster_t
 {
     PNANOVDB_REFLECT_INTERFACE();
@@ -171,6 +209,46 @@ typedef struct pnanovdb_raster_t
                                                                   pnanovdb_raster_gaussian_data_t** gaussian_data,
                                                                   pnanovdb_raster_shader_params_t* raster_params,
                                                                   pnanovdb_raster_context_t** raster_context);
+
+    // frees the device copy and keeps the host arrays, the next raster call uploads again
+    void(PNANOVDB_ABI* evict_gaussian_data)(const pnanovdb_compute_t* compute,
+                                            pnanovdb_compute_queue_t* queue,
+                                            pnanovdb_raster_gaussian_data_t* data);
+
+    pnanovdb_uint64_t(PNANOVDB_ABI* get_gaussian_data_resident_bytes)(pnanovdb_raster_gaussian_data_t* data);
+
+    // copies and resets the counts accumulated by raster_gaussian_2d
+    void(PNANOVDB_ABI* get_gaussian_cull_stats)(pnanovdb_raster_context_t* context,
+                                                pnanovdb_raster_gaussian_cull_stats_t* dst_stats);
+
+    // rasterizes view_count views of image_width x image_height into the cells of color_2d_atlas in batches that
+    // share culling, projection and sorting, view v goes to column v % atlas_columns, row v / atlas_columns from
+    // the top, atlas_columns 0 puts all views in one row
+    void(PNANOVDB_ABI* raster_gaussian_2d_views)(const pnanovdb_compute_t* compute,
+                                                 pnanovdb_compute_queue_t* queue,
+                                                 pnanovdb_raster_context_t* context,
+                                                 pnanovdb_raster_gaussian_data_t* data,
+                                                 pnanovdb_compute_texture_t* color_2d_atlas,
+                                                 pnanovdb_uint32_t image_width,
+                                                 pnanovdb_uint32_t image_height,
+                                                 const pnanovdb_camera_mat_t* views,
+                                                 const pnanovdb_camera_mat_t* projections,
+                                                 pnanovdb_uint32_t view_count,
+                                                 pnanovdb_uint32_t atlas_columns,
+                                                 const pnanovdb_raster_shader_params_t* shader_params,
+                                                 pnanovdb_uint32_t composite);
+
+    // rasterizes on the host threads into color_2d, image_width * image_height float RGBA with the first row on top,
+    // the same image as raster_gaussian_2d, data may be created without a queue on machines without a device
+    void(PNANOVDB_ABI* raster_gaussian_2d_cpu)(const pnanovdb_compute_t* compute,
+                                               pnanovdb_raster_gaussian_data_t* data,
+                                               pnanovdb_compute_array_t* color_2d,
+                                               pnanovdb_uint32_t image_width,
+                                               pnanovdb_uint32_t image_height,
+                                               const pnanovdb_camera_mat_t* view,
+                                               const pnanovdb_camera_mat_t* projection,
+                                               const pnanovdb_raster_shader_params_t* shader_params,
+                                               pnanovdb_uint32_t composite);
 } pnanovdb_raster_t;
 
 #define PNANOVDB_REFLECT_TYPE pnanovdb_raster_t
@@ -187,6 +265,11 @@ PNANOVDB_REFLECT_FUNCTION_POINTER(raster_file, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(raster_to_nanovdb_from_arrays, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(create_gaussian_data_from_arrays, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(create_gaussian_data_from_desc, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(evict_gaussian_data, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(get_gaussian_data_resident_bytes, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(get_gaussian_cull_stats, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(raster_gaussian_2d_views, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(raster_gaussian_2d_cpu, 0, 0)
 PNANOVDB_REFLECT_POINTER(pnanovdb_compute_t, compute, 0, 0)
 PNANOVDB_REFLECT_END(0)
 PNANOVDB_REFLECT_INTERFACE_IMPL()
@@ -227,12 +310,26 @@ enum shader
 
     // raster 2d shaders
     gaussian_count_tiles_slang,
+    gaussian_cull_args_slang,
+    gaussian_cull_chunks_slang,
+    gaussian_cull_finalize_slang,
     gaussian_projection_slang,
     gaussian_rasterize_2d_slang,
+    gaussian_rasterize_2d_32x8_slang,
+    gaussian_rasterize_2d_8x8_slang,
     gaussian_rasterize_2d_null_slang,
+    gaussian_rasterize_2d_null_32x8_slang,
+    gaussian_rasterize_2d_null_8x8_slang,
+    gaussian_sort_check_slang,
+    gaussian_sort_fixup_slang,
+    gaussian_sort_mark_slang,
+    gaussian_sort_merge_slang,
+    gaussian_sort_scatter_slang,
     gaussian_spherical_harmonics_slang,
     gaussian_tile_intersections_slang,
+    gaussian_tile_merge_slang,
     gaussian_tile_offsets_slang,
+    gaussian_tile_work_slang,
 
     shader_count
 };
@@ -0,0 +1,259 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/putil/Trace.hpp
+
+    \author Andrew Reidmeyer
+
+    \brief  Lock free trace event ring with Chrome trace JSON export, and a scope helper over the device interface
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Compute.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pnanovdb_util
+{
+struct TraceEventData
+{
+    uint64_t begin_ns = 0llu;
+    uint64_t end_ns = 0llu;
+    uint32_t tid = 0u;
+    char category[16] = {};
+    char name[64] = {};
+};
+
+struct TraceEvent
+{
+    // 2 * index + 1 while the slot is written, 2 * index + 2 once complete
+    std::atomic<uint64_t> sequence{ 0llu };
+    TraceEventData data;
+};
+
+// Fixed capacity multi producer ring, writers never block and overwrite the oldest events
+class TraceRing
+{
+public:
+    static constexpr uint32_t kTrackIdBase = 1u << 20u;
+
+    explicit TraceRing(size_t capacity = 65536u) : m_capacity(capacity)
+    {
+    }
+
+    static uint64_t now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // small stable id per recording thread, tracks registered below use ids above kTrackIdBase
+    static uint32_t currentThreadId()
+    {
+        static std::atomic<uint32_t> s_nextThreadId{ 1u };
+        thread_local uint32_t t_threadId = s_nextThreadId.fetch_add(1u);
+        return t_threadId;
+    }
+
+    bool isEnabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void setEnabled(bool enabled)
+    {
+        if (enabled)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_events)
+            {
+                m_events.reset(new TraceEvent[m_capacity]);
+            }
+        }
+        m_enabled.store(enabled, std::memory_order_release);
+    }
+
+    // named timeline that is not a cpu thread, for example a gpu queue
+    uint32_t registerTrack(const char* name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_trackNames.push_back(name ? name : "");
+        return kTrackIdBase + (uint32_t)(m_trackNames.size() - 1u);
+    }
+
+    void record(const char* category, const char* name, uint64_t begin_ns, uint64_t end_ns, uint32_t tid)
+    {
+        if (!m_enabled.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        uint64_t index = m_writeIndex.fetch_add(1u, std::memory_order_relaxed);
+        TraceEvent& event = m_events[index % m_capacity];
+
+        event.sequence.store(2u * index + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        event.data.begin_ns = begin_ns;
+        event.data.end_ns = end_ns < begin_ns ? begin_ns : end_ns;
+        event.data.tid = tid;
+        copyLabel(event.data.category, sizeof(event.data.category), category);
+        copyLabel(event.data.name, sizeof(event.data.name), name);
+
+        event.sequence.store(2u * index + 2u, std::memory_order_release);
+    }
+
+    void record(const char* category, const char* name, uint64_t begin_ns, uint64_t end_ns)
+    {
+        record(category, name, begin_ns, end_ns, currentThreadId());
+    }
+
+    // events still being written or already overwritten are skipped
+    std::string exportChromeJson() const
+    {
+        std::vector<TraceEventData> events;
+        std::vector<std::string> trackNames;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            trackNames = m_trackNames;
+            if (m_events)
+            {
+                uint64_t end = m_writeIndex.load(std::memory_order_acquire);
+                uint64_t begin = end > m_capacity ? end - m_capacity : 0u;
+                events.reserve(size_t(end - begin));
+                for (uint64_t index = begin; index < end; index++)
+                {
+                    const TraceEvent& src = m_events[index % m_capacity];
+                    uint64_t sequence = src.sequence.load(std::memory_order_acquire);
+                    if (sequence != 2u * index + 2u)
+                    {
+                        continue;
+                    }
+                    events.push_back(src.data);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (src.sequence.load(std::memory_order_relaxed) != sequence)
+                    {
+                        events.pop_back();
+                    }
+                }
+            }
+        }
+
+        uint64_t origin_ns = ~0llu;
+        for (const TraceEventData& event : events)
+        {
+            origin_ns = event.begin_ns < origin_ns ? event.begin_ns : origin_ns;
+        }
+
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        json += "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"nanovdb_editor\"}}";
+        for (size_t idx = 0u; idx < trackNames.size(); idx++)
+        {
+            json += ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(kTrackIdBase + idx) +
+                    ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+            appendEscaped(json, trackNames[idx].c_str());
+            json += "\"}}";
+        }
+        char buf[96u];
+        for (const TraceEventData& event : events)
+        {
+            json += ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(event.tid) + ",\"cat\":\"";
+            appendEscaped(json, event.category);
+            json += "\",\"name\":\"";
+            appendEscaped(json, event.name);
+            snprintf(buf, sizeof(buf), "\",\"ts\":%.3f,\"dur\":%.3f}", double(event.begin_ns - origin_ns) * 1.0e-3,
+                     double(event.end_ns - event.begin_ns) * 1.0e-3);
+            json += buf;
+        }
+        json += "\n]}\n";
+        return json;
+    }
+
+private:
+    static void copyLabel(char* dst, size_t dstSize, const char* src)
+    {
+        size_t len = src ? strnlen(src, dstSize - 1u) : 0u;
+        if (len > 0u)
+        {
+            memcpy(dst, src, len);
+        }
+        dst[len] = '\0';
+    }
+
+    static void appendEscaped(std::string& json, const char* str)
+    {
+        for (const char* c = str; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                json += '\\';
+                json += *c;
+            }
+            else if ((unsigned char)*c < 0x20)
+            {
+                json += ' ';
+            }
+            else
+            {
+                json += *c;
+            }
+        }
+    }
+
+protected:
+    size_t m_capacity;
+    std::unique_ptr<TraceEvent[]> m_events;
+    std::atomic<uint64_t> m_writeIndex{ 0llu };
+    std::atomic<bool> m_enabled{ false };
+
+    mutable std::mutex m_mutex;
+    std::vector<std::string> m_trackNames;
+};
+
+// Records one cpu scope through the device interface on destruction
+class TraceScope
+{
+public:
+    TraceScope(const pnanovdb_compute_device_interface_t* deviceInterface, const char* category, const char* name)
+        : m_deviceInterface(deviceInterface && deviceInterface->trace_scope ? deviceInterface : nullptr),
+          m_category(category),
+          m_name(name)
+    {
+        if (m_deviceInterface)
+        {
+            m_begin_ns = m_deviceInterface->trace_timestamp();
+        }
+    }
+
+    TraceScope(const pnanovdb_compute_t* compute, const char* category, const char* name)
+        : TraceScope(compute ? &compute->device_interface : nullptr, category, name)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_deviceInterface)
+        {
+            m_deviceInterface->trace_scope(m_category, m_name, m_begin_ns, m_deviceInterface->trace_timestamp());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const pnanovdb_compute_device_interface_t* m_deviceInterface;
+    const char* m_category;
+    const char* m_name;
+    pnanovdb_uint64_t m_begin_ns = 0llu;
+};
+} // namespace pnanovdb_util
@@ -20,6 +20,10 @@
 struct pnanovdb_voxelbvh_context_t;
 typedef struct pnanovdb_voxelbvh_context_t pnanovdb_voxelbvh_context_t;
 
+// pending result of an _async call, poll or wait on the thread that owns queue
+struct pnanovdb_voxelbvh_future_t;
+typedef struct pnanovdb_voxelbvh_future_t pnanovdb_voxelbvh_future_t;
+
 typedef struct pnanovdb_voxelbvh_t
 {
     PNANOVDB_REFLECT_INTERFACE();
@@ -239,6 +243,81 @@ typedef struct pnanovdb_voxelbvh_t
                                                           pnanovdb_compute_array_t* src_nanovdb_in,
                                                           pnanovdb_vec3_t index_space_ray_direction);
 
+    // async variants flush without waiting, results are taken in the order of the synchronous out params
+    pnanovdb_voxelbvh_future_t*(PNANOVDB_ABI* nanovdb_generate_node_mask_array_async)(
+        const pnanovdb_compute_t* compute,
+        pnanovdb_compute_queue_t* queue,
+        pnanovdb_voxelbvh_context_t* context,
+        pnanovdb_compute_array_t* nanovdb_array);
+
+    pnanovdb_voxelbvh_future_t*(PNANOVDB_ABI* nanovdb_add_nodes_from_ijkl_array_async)(
+        const pnanovdb_compute_t* compute,
+        pnanovdb_compute_queue_t* queue,
+        pnanovdb_voxelbvh_context_t* context,
+        pnanovdb_compute_array_t* ijkl_in,
+        pnanovdb_compute_array_t* range_in,
+        pnanovdb_compute_array_t* world_bbox_in,
+        pnanovdb_uint32_t resolution,
+        const float* transform_floats,
+        pnanovdb_uint32_t transform_float_count);
+
+    pnanovdb_voxelbvh_future_t*(PNANOVDB_ABI* ijkl_from_lines_array_async)(const pnanovdb_compute_t* compute,
+                                                                           pnanovdb_compute_queue_t* queue,
+                                                                           pnanovdb_voxelbvh_context_t* context,
+                                                                           pnanovdb_compute_array_t* indices_array,
+                                                                           pnanovdb_compute_array_t* positions_array,
+                                                                           float inflation_radius,
+                                                                           pnanovdb_uint32_t resolution);
+
+    pnanovdb_voxelbvh_future_t*(PNANOVDB_ABI* ijkl_from_triangles_array_async)(
+        const pnanovdb_compute_t* compute,
+        pnanovdb_compute_queue_t* queue,
+        pnanovdb_voxelbvh_context_t* context,
+        pnanovdb_compute_array_t* indices_array,
+        pnanovdb_compute_array_t* positions_array,
+        float inflation_radius,
+        pnanovdb_uint32_t resolution);
+
+    pnanovdb_voxelbvh_future_t*(PNANOVDB_ABI* nanovdb_duplicate_topology_array_async)(
+        const pnanovdb_compute_t* compute,
+        pnanovdb_compute_queue_t* queue,
+        pnanovdb_voxelbvh_context_t* context,
+        pnanovdb_compute_array_t* src_nanovdb_in,
+        pnanovdb_uint32_t dst_grid_type,
+        pnanovdb_uint32_t upsample_factor);
+
+    pnanovdb_voxelbvh_future_t*(PNANOVDB_ABI* nanovdb_rgba8_from_voxelbvh_array_async)(
+        const pnanovdb_compute_t* compute,
+        pnanovdb_compute_queue_t* queue,
+        pnanovdb_voxelbvh_context_t* context,
+        pnanovdb_compute_array_t* dst_nanovdb_inout,
+        pnanovdb_compute_array_t* src_nanovdb_in,
+        pnanovdb_vec3_t index_space_ray_direction);
+
+    // GPU stage of nanovdb_from_gaussians_array, the NanoVDB and metadata are then assembled on the host from the
+    // results with nanovdb_add_nodes_from_ijkl_array and nanovdb_append_metadata
+    pnanovdb_voxelbvh_future_t*(PNANOVDB_ABI* ijkl_from_gaussians_array_async)(
+        const pnanovdb_compute_t* compute,
+        pnanovdb_compute_queue_t* queue,
+        pnanovdb_voxelbvh_context_t* context,
+        pnanovdb_compute_array_t** gaussian_arrays, // [means, opacities, quaternions, scales, sh_0, sh_n]
+        pnanovdb_uint32_t gaussian_array_count, // must be 6
+        pnanovdb_uint32_t resolution);
+
+    // frame to pass to the device interface, for example to chain a frame callback
+    pnanovdb_uint64_t(PNANOVDB_ABI* future_get_frame)(pnanovdb_voxelbvh_future_t* future);
+
+    pnanovdb_bool_t(PNANOVDB_ABI* future_is_completed)(pnanovdb_voxelbvh_future_t* future);
+
+    void(PNANOVDB_ABI* future_wait)(pnanovdb_voxelbvh_future_t* future);
+
+    // transfers ownership to the caller, nullptr until completed
+    pnanovdb_compute_array_t*(PNANOVDB_ABI* future_take_result)(pnanovdb_voxelbvh_future_t* future,
+                                                                pnanovdb_uint32_t result_idx);
+
+    // safe before completion, results not taken are destroyed
+    void(PNANOVDB_ABI* future_destroy)(pnanovdb_voxelbvh_future_t* future);
+
 } pnanovdb_voxelbvh_t;
 
 #define PNANOVDB_REFLECT_TYPE pnanovdb_voxelbvh_t
@@ -267,6 +346,18 @@ PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_duplicate_topology, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_duplicate_topology_array, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_rgba8_from_voxelbvh, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_rgba8_from_voxelbvh_array, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_generate_node_mask_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_add_nodes_from_ijkl_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(ijkl_from_lines_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(ijkl_from_triangles_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_duplicate_topology_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(nanovdb_rgba8_from_voxelbvh_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(ijkl_from_gaussians_array_async, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(future_get_frame, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(future_is_completed, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(future_wait, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(future_take_result, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(future_destroy, 0, 0)
 PNANOVDB_REFLECT_END(0)
 PNANOVDB_REFLECT_INTERFACE_IMPL()
 #undef PNANOVDB_REFLECT_TYPE
@@ -0,0 +1,254 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/putil/WorkStealingPool.hpp
+
+    \author Andrew Reidmeyer
+
+    \brief  Work stealing parallel for over index ranges.
+
+    Each thread owns a deque of ranges, the calling thread included. A parallel_for hands every thread one contiguous
+    part of the index space. Threads take grain sized pieces from the back of their own deque, an idle thread steals
+    half of the front range of another deque, so uneven work such as dense image tiles spreads over all threads.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pnanovdb_util
+{
+class WorkStealingPool
+{
+public:
+    WorkStealingPool(size_t requested_threads = 0) : job_generation(0u), active_workers(0u), stop(false)
+    {
+        size_t num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0)
+        {
+            num_threads = 2; // minimum fallback
+        }
+        if (requested_threads > 0)
+        {
+            num_threads = requested_threads;
+        }
+
+        for (size_t i = 0; i < num_threads; ++i)
+        {
+            queues.emplace_back(new range_queue_t());
+        }
+        // queue 0 belongs to the thread calling parallel_for
+        for (size_t i = 1; i < num_threads; ++i)
+        {
+            workers.emplace_back([this, i] { worker_main(i); });
+        }
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(job_mutex);
+            stop = true;
+        }
+        job_condition.notify_all();
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    size_t thread_count() const
+    {
+        return queues.size();
+    }
+
+    // func(begin, end) runs for disjoint ranges covering [0, count), returns once all of them completed
+    template <typename F>
+    void parallel_for(uint64_t count, uint64_t grain, F&& func)
+    {
+        if (count == 0u)
+        {
+            return;
+        }
+        if (grain == 0u)
+        {
+            grain = 1u;
+        }
+        if (queues.size() == 1u || count <= grain)
+        {
+            func(uint64_t(0u), count);
+            return;
+        }
+
+        std::unique_lock<std::mutex> call_lock(call_mutex);
+
+        // a worker may still be waking for the previous generation and enters run_ranges without waiting, so job,
+        // grain and ranges are published under job_mutex and job_remaining is stored last to release them
+        {
+            std::unique_lock<std::mutex> lock(job_mutex);
+            job = std::function<void(uint64_t, uint64_t)>(std::forward<F>(func));
+            job_grain = grain;
+            uint64_t thread_count = queues.size();
+            for (uint64_t idx = 0u; idx < thread_count; idx++)
+            {
+                uint64_t begin = (count * idx) / thread_count;
+                uint64_t end = (count * (idx + 1u)) / thread_count;
+                if (begin < end)
+                {
+                    std::unique_lock<std::mutex> queue_lock(queues[idx]->mutex);
+                    queues[idx]->ranges.push_back(range_t{ begin, end });
+                }
+            }
+            job_remaining.store(count, std::memory_order_release);
+            job_generation++;
+        }
+        job_condition.notify_all();
+
+        run_ranges(0u);
+
+        // workers still inside run_ranges hold a reference to job
+        std::unique_lock<std::mutex> lock(job_mutex);
+        done_condition.wait(lock, [this] { return active_workers == 0u; });
+        job = nullptr;
+    }
+
+private:
+    struct range_t
+    {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    struct range_queue_t
+    {
+        std::mutex mutex;
+        std::deque<range_t> ranges;
+    };
+
+    // up to grain indices from the back of the own deque
+    bool pop_range(size_t queue_idx, range_t& dst)
+    {
+        range_queue_t& queue = *queues[queue_idx];
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        if (queue.ranges.empty())
+        {
+            return false;
+        }
+        range_t& back = queue.ranges.back();
+        if (back.end - back.begin > job_grain)
+        {
+            dst = range_t{ back.end - job_grain, back.end };
+            back.end -= job_grain;
+        }
+        else
+        {
+            dst = back;
+            queue.ranges.pop_back();
+        }
+        return true;
+    }
+
+    // half of the front range of another deque, the victim keeps working from its back
+    bool steal_range(size_t queue_idx)
+    {
+        for (size_t offset = 1u; offset < queues.size(); offset++)
+        {
+            range_queue_t& victim = *queues[(queue_idx + offset) % queues.size()];
+            range_t stolen = {};
+            {
+                std::unique_lock<std::mutex> lock(victim.mutex);
+                if (victim.ranges.empty())
+                {
+                    continue;
+                }
+                range_t& front = victim.ranges.front();
+                uint64_t size = front.end - front.begin;
+                if (size > job_grain)
+                {
+                    uint64_t half = (size / 2u + job_grain - 1u) / job_grain * job_grain;
+                    stolen = range_t{ front.begin, front.begin + half };
+                    front.begin += half;
+                }
+                else
+                {
+                    stolen = front;
+                    victim.ranges.pop_front();
+                }
+            }
+            range_queue_t& queue = *queues[queue_idx];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.ranges.push_back(stolen);
+            return true;
+        }
+        return false;
+    }
+
+    void run_ranges(size_t queue_idx)
+    {
+        // acquire pairs with the store in parallel_for, job and job_grain are visible once work remains
+        while (job_remaining.load(std::memory_order_acquire) != 0u)
+        {
+            range_t range = {};
+            if (pop_range(queue_idx, range))
+            {
+                job(range.begin, range.end);
+                job_remaining.fetch_sub(range.end - range.begin);
+            }
+            else if (!steal_range(queue_idx))
+            {
+                // the last ranges are running on other threads
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void worker_main(size_t queue_idx)
+    {
+        uint64_t seen_generation = 0u;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(job_mutex);
+                job_condition.wait(lock, [this, seen_generation] { return stop || job_generation != seen_generation; });
+                if (stop)
+                {
+                    return;
+                }
+                seen_generation = job_generation;
+                active_workers++;
+            }
+            run_ranges(queue_idx);
+            {
+                std::unique_lock<std::mutex> lock(job_mutex);
+                active_workers--;
+            }
+            done_condition.notify_all();
+        }
+    }
+
+    std::vector<std::unique_ptr<range_queue_t>> queues;
+    std::vector<std::thread> workers;
+
+    std::function<void(uint64_t, uint64_t)> job;
+    uint64_t job_grain = 1u;
+    std::atomic<uint64_t> job_remaining{ 0u };
+
+    std::mutex call_mutex;
+    std::mutex job_mutex;
+    std::condition_variable job_condition;
+    std::condition_variable done_condition;
+    uint64_t job_generation;
+    uint64_t active_workers;
+    bool stop;
+};
+
+} // namespace pnanovdb_util
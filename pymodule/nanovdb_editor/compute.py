@@ -50,6 +50,31 @@ class pnanovdb_ComputeArray(Structure):
         self.filepath = filepath.encode("utf-8") if isinstance(filepath, str) else filepath
 
 
+class pnanovdb_ComputeGridInfo(Structure):
+    """Definition equivalent to pnanovdb_compute_grid_info_t."""
+
+    _fields_ = [
+        ("grid_name", c_char * 256),
+        ("segment_index", c_uint32),
+        ("grid_index", c_uint32),
+        ("grid_type", c_uint32),
+        ("grid_class", c_uint32),
+        ("codec", c_uint32),
+        ("version", c_uint32),
+        ("grid_size", c_uint64),
+        ("file_size", c_uint64),
+        ("file_offset", c_uint64),
+        ("active_voxel_count", c_uint64),
+        ("node_count", c_uint32 * 3),
+        ("pad", c_uint32),
+        ("index_bbox_min", c_int32 * 3),
+        ("index_bbox_max", c_int32 * 3),
+        ("world_bbox_min", c_double * 3),
+        ("world_bbox_max", c_double * 3),
+        ("voxel_size", c_double * 3),
+    ]
+
+
 class pnanovdb_Compute(Structure):
     """Definition equivalent to pnanovdb_compute_t."""
 
@@ -157,6 +182,105 @@ class pnanovdb_Compute(Structure):
             ),
         ),
         ("duplicate_array", CFUNCTYPE(POINTER(pnanovdb_ComputeArray), POINTER(pnanovdb_ComputeArray))),
+        ("create_nanovdb_lod", CFUNCTYPE(POINTER(pnanovdb_ComputeArray), POINTER(pnanovdb_ComputeArray), c_uint32)),
+        (
+            "create_paged_nanovdb",
+            CFUNCTYPE(
+                c_void_p,
+                c_char_p,  # filepath
+                c_uint32,  # grid_idx
+                POINTER(pnanovdb_ComputeArray),
+                c_uint64,
+            ),
+        ),  # pool_size_in_bytes
+        ("destroy_paged_nanovdb", CFUNCTYPE(None, c_void_p, c_void_p, c_void_p)),
+        (
+            "prefetch_paged_nanovdb",
+            CFUNCTYPE(
+                None,
+                c_void_p,  # pnanovdb_compute_paged_nanovdb_t*
+                c_void_p,  # const pnanovdb_camera_mat_t* view
+                c_void_p,  # const pnanovdb_camera_mat_t* projection
+                pnanovdb_bool_t,
+            ),
+        ),  # auto_center
+        (
+            "dispatch_shader_on_paged_nanovdb",
+            CFUNCTYPE(
+                pnanovdb_bool_t,
+                c_void_p,  # POINTER(pnanovdb_Compute)
+                c_void_p,  # const pnanovdb_compute_device_t*
+                c_void_p,  # const pnanovdb_shader_context_t*
+                c_void_p,  # pnanovdb_compute_paged_nanovdb_t*
+                c_int32,  # image_width
+                c_int32,  # image_height
+                c_void_p,  # background_image
+                c_void_p,  # upload_buffer
+                c_void_p,
+            ),
+        ),  # user_upload_buffer
+        ("get_paged_nanovdb_stats", CFUNCTYPE(None, c_void_p, c_void_p)),
+        (
+            "read_nanovdb_grid_info",
+            CFUNCTYPE(c_uint32, c_char_p, POINTER(pnanovdb_ComputeGridInfo), c_uint32),  # dst_capacity
+        ),
+        ("open_nanovdb_file", CFUNCTYPE(c_void_p, c_char_p)),
+        ("close_nanovdb_file", CFUNCTYPE(None, c_void_p)),
+        ("get_nanovdb_file_grid_count", CFUNCTYPE(c_uint32, c_void_p)),
+        (
+            "get_nanovdb_file_grid_info",
+            CFUNCTYPE(pnanovdb_bool_t, c_void_p, c_uint32, POINTER(pnanovdb_ComputeGridInfo)),
+        ),
+        ("request_nanovdb_file_grid", CFUNCTYPE(POINTER(pnanovdb_ComputeArray), c_void_p, c_uint32)),
+        ("get_nanovdb_file_grid", CFUNCTYPE(POINTER(pnanovdb_ComputeArray), c_void_p, c_uint32)),
+        ("mark_array_dirty", CFUNCTYPE(None, POINTER(pnanovdb_ComputeArray), c_uint64, c_uint64)),
+        ("create_nanovdb_upload", CFUNCTYPE(c_void_p, c_uint64)),
+        ("destroy_nanovdb_upload", CFUNCTYPE(None, c_void_p, c_void_p, c_void_p)),
+        (
+            "update_nanovdb_upload",
+            CFUNCTYPE(c_void_p, c_void_p, c_void_p, c_void_p, POINTER(pnanovdb_ComputeArray)),
+        ),
+        ("get_nanovdb_upload_stats", CFUNCTYPE(None, c_void_p, c_void_p)),
+        ("create_readback_queue", CFUNCTYPE(c_void_p, c_uint32)),
+        ("destroy_readback_queue", CFUNCTYPE(None, c_void_p, c_void_p, c_void_p)),
+        ("enqueue_readback", CFUNCTYPE(c_uint64, c_void_p, c_void_p, c_void_p, c_void_p, c_uint64)),
+        (
+            "map_readback",
+            CFUNCTYPE(c_void_p, c_void_p, c_void_p, c_void_p, POINTER(c_uint64), POINTER(c_uint64)),
+        ),
+        ("unmap_readback", CFUNCTYPE(None, c_void_p, c_void_p, c_void_p)),
+        (
+            "dispatch_shader_on_array_async",
+            CFUNCTYPE(
+                c_uint64,
+                POINTER(pnanovdb_Compute),
+                POINTER(pnanovdb_Device),
+                c_char_p,
+                c_uint32,
+                c_uint32,
+                c_uint32,
+                POINTER(pnanovdb_ComputeArray),
+                POINTER(pnanovdb_ComputeArray),
+                POINTER(pnanovdb_ComputeArray),
+                c_uint32,
+                c_uint64,
+                c_uint64,
+                c_void_p,  # pnanovdb_compute_readback_queue_t*
+            ),
+        ),
+        (
+            "dispatch_shader_indirect",
+            CFUNCTYPE(
+                None,
+                c_void_p,  # pnanovdb_compute_interface_t*
+                c_void_p,  # pnanovdb_compute_context_t*
+                c_void_p,  # const pnanovdb_shader_context_t*
+                c_void_p,  # pnanovdb_compute_resource_t*
+                c_void_p,  # pnanovdb_compute_buffer_transient_t*
+                c_uint64,  # indirect_offset
+                c_char_p,
+            ),
+        ),  # debug_label
     ]
 
 
@@ -264,6 +388,68 @@ class Compute:
 
         return result == PNANOVDB_TRUE
 
+    def _device_queue(self):
+        device = self._device_interface.get_device()
+        return cast(self._device_interface.get_device_interface().contents.get_device_queue(device), c_void_p)
+
+    def create_readback_queue(self, depth: int = 3) -> c_void_p:
+        """Ring of depth results in flight, polled without waiting on the device."""
+        readback_queue = self._compute.contents.create_readback_queue(c_uint32(depth))
+        if not readback_queue:
+            raise RuntimeError("Failed to create readback queue")
+        return readback_queue
+
+    def destroy_readback_queue(self, readback_queue: c_void_p) -> None:
+        self._compute.contents.destroy_readback_queue(self._compute, self._device_queue(), readback_queue)
+
+    def dispatch_shader_on_array_async(
+        self,
+        shader_path: str,
+        grid_dims: Tuple[int, int, int],
+        data_in: pnanovdb_ComputeArray,
+        constants: pnanovdb_ComputeArray,
+        data_out: pnanovdb_ComputeArray,
+        readback_queue: c_void_p,
+        dispatch_count: int = 1,
+        scratch_size: int = 0,
+        scratch_clear_size: int = 0,
+    ) -> int:
+        """Like dispatch_shader_on_array but returns a ticket at once, 0 when the readback queue is full."""
+        if not data_in or not constants or not data_out:
+            raise ValueError("ComputeArray parameters cannot be None")
+
+        dispatch_func = self._compute.contents.dispatch_shader_on_array_async
+        return dispatch_func(
+            self._compute,
+            self._device_interface.get_device(),
+            shader_path.encode("utf-8"),
+            c_uint32(grid_dims[0]),
+            c_uint32(grid_dims[1]),
+            c_uint32(grid_dims[2]),
+            pointer(data_in),
+            pointer(constants),
+            pointer(data_out),
+            c_uint32(dispatch_count),
+            c_uint64(scratch_size),
+            c_uint64(scratch_clear_size),
+            readback_queue,
+        )
+
+    def poll_readback(self, readback_queue: c_void_p, np_dtype: np.dtype = np.dtype(np.uint8)):
+        """Returns (ticket, copy of the oldest completed result) or None while the device is still working."""
+        queue = self._device_queue()
+        ticket = c_uint64(0)
+        num_bytes = c_uint64(0)
+        data_ptr = self._compute.contents.map_readback(
+            self._compute, queue, readback_queue, byref(ticket), byref(num_bytes)
+        )
+        if not data_ptr:
+            return None
+        buffer = (c_byte * num_bytes.value).from_address(data_ptr)
+        result = np.frombuffer(buffer, dtype=np_dtype).copy()
+        self._compute.contents.unmap_readback(self._compute, queue, readback_queue)
+        return ticket.value, result
+
     def map_array(self, array: pnanovdb_ComputeArray, np_dtype: np.dtype) -> np.ndarray:
         if array.element_size != np_dtype.itemsize:
             raise ValueError("Array element size mismatches the provided dtype")
@@ -290,6 +476,66 @@ class Compute:
             raise RuntimeError("Failed to convert image to NanoVDB format")
         return array.contents
 
+    def create_nanovdb_lod(self, array: pnanovdb_ComputeArray, level_count: int = 2) -> pnanovdb_ComputeArray:
+        """Append 2x downsampled LOD grids to a float NanoVDB grid for distant ray marching."""
+        lod_func = self._compute.contents.create_nanovdb_lod
+        lod_array = lod_func(pointer(array), c_uint32(level_count))
+        if not lod_array:
+            raise RuntimeError("Failed to create NanoVDB LOD levels")
+        return lod_array.contents
+
+    def read_nanovdb_grid_info(self, filepath: str) -> list:
+        """List the grids of a .nvdb file from its headers without loading voxel data."""
+        info_func = self._compute.contents.read_nanovdb_grid_info
+        path = filepath.encode("utf-8")
+        grid_count = info_func(path, None, 0)
+        infos = (pnanovdb_ComputeGridInfo * grid_count)()
+        if grid_count > 0:
+            info_func(path, infos, grid_count)
+        return [
+            {
+                "name": info.grid_name.decode("utf-8", errors="replace"),
+                "segment_index": info.segment_index,
+                "grid_index": info.grid_index,
+                "grid_type": info.grid_type,
+                "grid_class": info.grid_class,
+                "codec": info.codec,
+                "grid_size": info.grid_size,
+                "file_size": info.file_size,
+                "active_voxel_count": info.active_voxel_count,
+                "node_count": tuple(info.node_count),
+                "index_bbox": (tuple(info.index_bbox_min), tuple(info.index_bbox_max)),
+                "world_bbox": (tuple(info.world_bbox_min), tuple(info.world_bbox_max)),
+                "voxel_size": tuple(info.voxel_size),
+            }
+            for info in infos
+        ]
+
+    def open_nanovdb_file(self, filepath: str) -> c_void_p:
+        """Enumerate every grid of a .nvdb file, grids are only read when requested."""
+        file = self._compute.contents.open_nanovdb_file(filepath.encode("utf-8"))
+        if not file:
+            raise RuntimeError(f"Failed to open NanoVDB file: {filepath}")
+        return file
+
+    def close_nanovdb_file(self, file: c_void_p) -> None:
+        """Release the file and every grid array it returned."""
+        self._compute.contents.close_nanovdb_file(file)
+
+    def get_nanovdb_file_grid_count(self, file: c_void_p) -> int:
+        return self._compute.contents.get_nanovdb_file_grid_count(file)
+
+    def get_nanovdb_file_grid(self, file: c_void_p, grid_index: int) -> pnanovdb_ComputeArray:
+        """Load the grid on first use, the array stays owned by the file."""
+        array = self._compute.contents.get_nanovdb_file_grid(file, c_uint32(grid_index))
+        if not array:
+            raise RuntimeError(f"Failed to load grid {grid_index}")
+        return array.contents
+
+    def mark_array_dirty(self, array: pnanovdb_ComputeArray, byte_offset: int, num_bytes: int) -> None:
+        """Report an in place edit, device copies then upload only the marked bytes."""
+        self._compute.contents.mark_array_dirty(pointer(array), c_uint64(byte_offset), c_uint64(num_bytes))
+
     def array_exists(self, array: pnanovdb_ComputeArray) -> bool:
         return array and array.data is not None
 
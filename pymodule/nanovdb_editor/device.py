@@ -35,7 +35,12 @@ def pnanovdb_compute_log_print(level, format_str):
 class pnanovdb_DeviceDesc(Structure):
     """Definition equivalent to pnanovdb_compute_device_desc_t."""
 
-    _fields_ = [("device_index", c_uint32), ("enable_external_usage", pnanovdb_bool_t), ("log_print", LOG_FUNC)]
+    _fields_ = [
+        ("device_index", c_uint32),
+        ("enable_external_usage", pnanovdb_bool_t),
+        ("log_print", LOG_FUNC),
+        ("descriptor_update_mode", c_uint32),
+    ]
 
 
 class pnanovdb_Device(Structure):
@@ -99,6 +104,22 @@ class pnanovdb_DeviceInterface(Structure):
         ("disable_profiler", CFUNCTYPE(None, POINTER(pnanovdb_Device))),
         ("set_resource_min_lifetime", CFUNCTYPE(None, POINTER(pnanovdb_Device), c_uint64)),
         ("get_device_index", CFUNCTYPE(c_uint32, POINTER(pnanovdb_Device))),
+        ("is_frame_completed", CFUNCTYPE(pnanovdb_bool_t, POINTER(pnanovdb_Device), c_uint64)),
+        (
+            "add_frame_callback",
+            CFUNCTYPE(
+                None,
+                POINTER(pnanovdb_Device),
+                c_uint64,
+                CFUNCTYPE(None, c_void_p, c_uint64),
+                c_void_p,
+            ),
+        ),
+        ("enable_trace", CFUNCTYPE(None, pnanovdb_bool_t)),
+        ("trace_timestamp", CFUNCTYPE(c_uint64)),
+        ("trace_scope", CFUNCTYPE(None, c_char_p, c_char_p, c_uint64, c_uint64)),
+        ("export_trace", CFUNCTYPE(c_uint64, c_char_p, c_uint64)),
+        ("save_trace", CFUNCTYPE(pnanovdb_bool_t, c_char_p)),
     ]
 
 
@@ -159,6 +180,13 @@ class DeviceInterface:
         get_compute_queue = self._device_interface.contents.get_compute_queue
         return get_compute_queue(device)
 
+    def enable_trace(self, enabled=True) -> None:
+        self._device_interface.contents.enable_trace(enabled)
+
+    def save_trace(self, path: str) -> bool:
+        save_func = self._device_interface.contents.save_trace
+        return bool(save_func(path.encode("utf-8")))
+
     def __del__(self):
         # Avoid any native calls during GC/finalization
         try:
@@ -47,6 +47,8 @@ class EditorConfig(Structure):
         ("streaming", c_int32),  # pnanovdb_bool_t is int32_t in C
         ("stream_to_file", c_int32),  # pnanovdb_bool_t is int32_t in C
         ("ui_profile_name", c_char_p),
+        ("residency_budget_mb", c_uint32),
+        ("gpu_memory_budget_mb", c_uint32),
     ]
 
 
@@ -358,6 +360,8 @@ class Editor:
         cfg.streaming = 0
         cfg.stream_to_file = 0
         cfg.ui_profile_name = None
+        cfg.residency_budget_mb = 0
+        cfg.gpu_memory_budget_mb = 0
         return cfg
 
     def _ensure_device(self, _config: EditorConfig) -> None:
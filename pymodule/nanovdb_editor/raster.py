@@ -164,6 +164,31 @@ class pnanovdb_Raster(Structure):
                 POINTER(c_void_p),  # raster_context
             ),
         ),
+        (
+            "create_gaussian_data_from_desc",
+            CFUNCTYPE(
+                c_int32,  # pnanovdb_bool_t
+                c_void_p,  # pnanovdb_raster_t*
+                POINTER(pnanovdb_Compute),
+                POINTER(pnanovdb_ComputeQueue),
+                c_void_p,  # desc
+                c_char_p,  # name
+                POINTER(c_void_p),  # gaussian_data
+                c_void_p,  # raster_params
+                POINTER(c_void_p),  # raster_context
+            ),
+        ),
+        (
+            "evict_gaussian_data",
+            CFUNCTYPE(
+                None,
+                POINTER(pnanovdb_Compute),
+                POINTER(pnanovdb_ComputeQueue),
+                c_void_p,  # data
+            ),
+        ),
+        ("get_gaussian_data_resident_bytes", CFUNCTYPE(c_uint64, c_void_p)),
+        ("get_gaussian_cull_stats", CFUNCTYPE(None, c_void_p, c_void_p)),
     ]
 
 
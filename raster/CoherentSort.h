@@ -0,0 +1,148 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/CoherentSort.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Mode selection and host reference of the temporally coherent tile sort of the 2D gaussian rasterizer.
+
+    The coherent sort keeps the depth order of the gaussians from the previous frame. Visible gaussians are compacted
+    in that order and fixed up by sorting overlapping windows, so intersections are emitted depth sorted and only the
+    tile id remains to be radix sorted. When keys are still out of order after the fixup, the full dual key sort runs
+    instead and the visible order is sorted exactly. The sorted visible order is merged back into the slots it was
+    compacted from, so culled gaussians keep their place for when they return to the view.
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Raster.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+namespace pnanovdb_raster
+{
+// views closer than this to the previous frame use the coherent sort in auto mode
+static constexpr float k_coherent_sort_max_angle = 0.035f; // radians, about two degrees
+static constexpr float k_coherent_sort_max_translation = 0.02f; // relative to the distance to the scene
+
+// one workgroup of gaussian_sort_fixup.slang sorts a window, odd passes shift the windows by half
+static constexpr pnanovdb_uint32_t k_coherent_sort_window = 512u;
+static constexpr pnanovdb_uint32_t k_coherent_sort_fixup_passes = 4u;
+
+// constants of gaussian_sort_fixup.slang, the raster context keeps one buffer per window offset
+struct coherent_sort_fixup_params_t
+{
+    pnanovdb_uint32_t window_offset;
+    pnanovdb_uint32_t pad0;
+    pnanovdb_uint32_t pad1;
+    pnanovdb_uint32_t pad2;
+};
+
+// key of gaussians without tiles, sorted behind every depth and ahead of the window padding
+static constexpr pnanovdb_uint32_t k_coherent_sort_key_culled = 0xFFFFFFFEu;
+static constexpr pnanovdb_uint32_t k_coherent_sort_key_padding = 0xFFFFFFFFu;
+
+struct camera_delta_t
+{
+    float angle;
+    float translation;
+};
+
+// camera position of a row vector view matrix, the inverse rotation applied to the negated translation
+static inline pnanovdb_vec3_t view_camera_position(const pnanovdb_camera_mat_t& view)
+{
+    pnanovdb_vec3_t pos;
+    pos.x = -(view.w.x * view.x.x + view.w.y * view.x.y + view.w.z * view.x.z);
+    pos.y = -(view.w.x * view.y.x + view.w.y * view.y.y + view.w.z * view.y.z);
+    pos.z = -(view.w.x * view.z.x + view.w.y * view.z.y + view.w.z * view.z.z);
+    return pos;
+}
+
+// Rotation angle between two views and camera translation relative to the distance from scene_center
+static inline camera_delta_t compute_camera_delta(const pnanovdb_camera_mat_t& prev_view,
+                                                  const pnanovdb_camera_mat_t& view,
+                                                  const pnanovdb_vec3_t& scene_center)
+{
+    // trace(prev_rot^T * rot) of the upper 3x3, both rotations are orthonormal
+    float trace = prev_view.x.x * view.x.x + prev_view.x.y * view.x.y + prev_view.x.z * view.x.z +
+                  prev_view.y.x * view.y.x + prev_view.y.y * view.y.y + prev_view.y.z * view.y.z +
+                  prev_view.z.x * view.z.x + prev_view.z.y * view.z.y + prev_view.z.z * view.z.z;
+    float cos_angle = std::min(1.f, std::max(-1.f, 0.5f * (trace - 1.f)));
+
+    pnanovdb_vec3_t prev_pos = view_camera_position(prev_view);
+    pnanovdb_vec3_t pos = view_camera_position(view);
+    float dx = pos.x - prev_pos.x;
+    float dy = pos.y - prev_pos.y;
+    float dz = pos.z - prev_pos.z;
+    float cx = scene_center.x - prev_pos.x;
+    float cy = scene_center.y - prev_pos.y;
+    float cz = scene_center.z - prev_pos.z;
+    float dist = sqrtf(cx * cx + cy * cy + cz * cz);
+    float move = sqrtf(dx * dx + dy * dy + dz * dz);
+
+    camera_delta_t delta;
+    delta.angle = acosf(cos_angle);
+    delta.translation = dist > 0.f ? move / dist : (move > 0.f ? INFINITY : 0.f);
+    return delta;
+}
+
+static inline bool use_coherent_sort(pnanovdb_uint32_t tile_sort_mode, bool has_prev_view, const camera_delta_t& delta)
+{
+    if (tile_sort_mode == PNANOVDB_RASTER_TILE_SORT_FULL)
+    {
+        return false;
+    }
+    if (tile_sort_mode == PNANOVDB_RASTER_TILE_SORT_COHERENT)
+    {
+        return true;
+    }
+    return has_prev_view && delta.angle <= k_coherent_sort_max_angle &&
+           delta.translation <= k_coherent_sort_max_translation;
+}
+
+// Host mirror of the gaussian_sort_fixup.slang passes, keys and vals are reordered together
+static inline void coherent_sort_fixup(pnanovdb_uint32_t* keys,
+                                       pnanovdb_uint32_t* vals,
+                                       pnanovdb_uint64_t count,
+                                       pnanovdb_uint32_t pass_count)
+{
+    std::vector<std::pair<pnanovdb_uint32_t, pnanovdb_uint32_t>> window;
+    window.reserve(k_coherent_sort_window);
+    for (pnanovdb_uint32_t pass_idx = 0u; pass_idx < pass_count; pass_idx++)
+    {
+        pnanovdb_uint64_t offset = (pass_idx & 1u) ? k_coherent_sort_window / 2u : 0u;
+        for (pnanovdb_uint64_t begin = offset; begin < count; begin += k_coherent_sort_window)
+        {
+            pnanovdb_uint64_t end = std::min(begin + k_coherent_sort_window, count);
+            window.clear();
+            for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+            {
+                window.push_back({ keys[idx], vals[idx] });
+            }
+            std::sort(window.begin(), window.end(),
+                      [](const std::pair<pnanovdb_uint32_t, pnanovdb_uint32_t>& a,
+                         const std::pair<pnanovdb_uint32_t, pnanovdb_uint32_t>& b) { return a.first < b.first; });
+            for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+            {
+                keys[idx] = window[idx - begin].first;
+                vals[idx] = window[idx - begin].second;
+            }
+        }
+    }
+}
+
+// Adjacent pairs out of order, zero when the fixup fully sorted the keys, mirrors gaussian_sort_check.slang
+static inline pnanovdb_uint64_t count_sort_inversions(const pnanovdb_uint32_t* keys, pnanovdb_uint64_t count)
+{
+    pnanovdb_uint64_t inversions = 0u;
+    for (pnanovdb_uint64_t idx = 1u; idx < count; idx++)
+    {
+        inversions += keys[idx - 1u] > keys[idx] ? 1u : 0u;
+    }
+    return inversions;
+}
+} // namespace pnanovdb_raster
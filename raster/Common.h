@@ -65,9 +65,13 @@ static compute_gpu_array_t* gpu_array_create()
     return ptr;
 }
 
-static void gpu_array_destroy(const pnanovdb_compute_t* compute, pnanovdb_compute_queue_t* queue, compute_gpu_array_t* ptr)
+// frees the buffers but keeps the array, the next upload allocates them again
+static void gpu_array_release(const pnanovdb_compute_t* compute,
+                              pnanovdb_compute_queue_t* queue,
+                              compute_gpu_array_t* ptr)
 {
-    if (!ptr)
+    // arrays of host only data never had buffers
+    if (!ptr || !queue)
     {
         return;
     }
@@ -90,9 +94,33 @@ static void gpu_array_destroy(const pnanovdb_compute_t* compute, pnanovdb_comput
         compute_interface->destroy_buffer(context, ptr->readback_buffer);
         ptr->readback_buffer = nullptr;
     }
+}
+
+static void gpu_array_destroy(const pnanovdb_compute_t* compute, pnanovdb_compute_queue_t* queue, compute_gpu_array_t* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    gpu_array_release(compute, queue, ptr);
     delete ptr;
 }
 
+// bytes held by the device and upload buffers, sized as in gpu_array_upload
+static pnanovdb_uint64_t gpu_array_resident_bytes(const compute_gpu_array_t* ptr, const pnanovdb_compute_array_t* arr)
+{
+    if (!ptr || !arr)
+    {
+        return 0u;
+    }
+    pnanovdb_uint64_t size_in_bytes = arr->element_count * arr->element_size;
+    if (size_in_bytes < 65536u)
+    {
+        size_in_bytes = 65536u;
+    }
+    return (ptr->device_buffer ? size_in_bytes : 0u) + (ptr->upload_buffer ? size_in_bytes : 0u);
+}
+
 static void gpu_array_alloc_device(const pnanovdb_compute_t* compute,
                                    pnanovdb_compute_queue_t* queue,
                                    compute_gpu_array_t* ptr,
@@ -0,0 +1,435 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/CpuParallelPrimitives.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Host versions of the parallel primitives, run on a work stealing pool for machines without a device.
+
+    Each function produces what the matching pnanovdb_parallel_primitives_t entry leaves in its output buffers, so
+    the device results can be checked against them exactly. Flags follow the device convention, a segment starts at
+    every nonzero head flag and a value is selected by a nonzero flag.
+
+    Every primitive splits its input into a few blocks per thread. Scans and compactions reduce the blocks in
+    parallel, scan the block totals serially and then process each block again with its carry. The radix sort is a
+    stable LSD sort by 8-bit digits with one digit histogram per block.
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/ParallelPrimitives.h"
+#include "nanovdb_editor/putil/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace pnanovdb_raster
+{
+static inline pnanovdb_uint64_t cpu_key_mask(pnanovdb_uint32_t key_bit_count)
+{
+    return key_bit_count >= 64u ? ~0llu : ((1llu << key_bit_count) - 1u);
+}
+
+// blocks of at least 4096 values, a few per thread so that stealing evens out the load
+static inline pnanovdb_uint64_t cpu_block_count(pnanovdb_util::WorkStealingPool& pool, pnanovdb_uint64_t count)
+{
+    pnanovdb_uint64_t block_count = std::min<pnanovdb_uint64_t>(4u * pool.thread_count(), (count + 4095u) / 4096u);
+    return std::max<pnanovdb_uint64_t>(block_count, 1u);
+}
+
+static inline pnanovdb_uint64_t cpu_block_begin(pnanovdb_uint64_t count,
+                                                pnanovdb_uint64_t block_count,
+                                                pnanovdb_uint64_t block_idx)
+{
+    return (count * block_idx) / block_count;
+}
+
+// func(block_idx, begin, end) for every block, in parallel
+template <typename F>
+static inline void cpu_for_each_block(pnanovdb_util::WorkStealingPool& pool,
+                                      pnanovdb_uint64_t count,
+                                      pnanovdb_uint64_t block_count,
+                                      F&& func)
+{
+    pool.parallel_for(block_count, 1u,
+                      [&](pnanovdb_uint64_t block_begin, pnanovdb_uint64_t block_end)
+                      {
+                          for (pnanovdb_uint64_t block_idx = block_begin; block_idx < block_end; block_idx++)
+                          {
+                              func(block_idx, cpu_block_begin(count, block_count, block_idx),
+                                   cpu_block_begin(count, block_count, block_idx + 1u));
+                          }
+                      });
+}
+
+// replaces each block total with the combination of all totals before it, returns the combination of all of them
+template <typename val_t, typename op_t>
+static inline val_t cpu_block_exclusive_scan(std::vector<val_t>& block_totals, op_t op)
+{
+    val_t carry = val_t(0u);
+    for (val_t& block_total : block_totals)
+    {
+        val_t total = block_total;
+        block_total = carry;
+        carry = op(carry, total);
+    }
+    return carry;
+}
+
+// two level inclusive scan, val_in may equal val_out
+template <typename val_t, typename op_t>
+static inline void cpu_scan(pnanovdb_util::WorkStealingPool& pool,
+                            const val_t* val_in,
+                            val_t* val_out,
+                            pnanovdb_uint64_t val_count,
+                            op_t op)
+{
+    if (val_count == 0u)
+    {
+        return;
+    }
+    const pnanovdb_uint64_t block_count = cpu_block_count(pool, val_count);
+    std::vector<val_t> block_totals(block_count);
+    cpu_for_each_block(pool, val_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           val_t total = val_t(0u);
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               total = op(total, val_in[idx]);
+                           }
+                           block_totals[block_idx] = total;
+                       });
+    cpu_block_exclusive_scan(block_totals, op);
+    cpu_for_each_block(pool, val_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           val_t sum = block_totals[block_idx];
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               sum = op(sum, val_in[idx]);
+                               val_out[idx] = sum;
+                           }
+                       });
+}
+
+// matches global_scan, an inclusive sum
+static inline void cpu_global_scan(pnanovdb_util::WorkStealingPool& pool,
+                                   const pnanovdb_uint32_t* val_in,
+                                   pnanovdb_uint32_t* val_out,
+                                   pnanovdb_uint64_t val_count)
+{
+    cpu_scan(pool, val_in, val_out, val_count, [](pnanovdb_uint32_t a, pnanovdb_uint32_t b) { return a + b; });
+}
+
+// matches global_scan_uint64
+static inline void cpu_global_scan_uint64(pnanovdb_util::WorkStealingPool& pool,
+                                          const pnanovdb_uint64_t* val_in,
+                                          pnanovdb_uint64_t* val_out,
+                                          pnanovdb_uint64_t val_count)
+{
+    cpu_scan(pool, val_in, val_out, val_count, [](pnanovdb_uint64_t a, pnanovdb_uint64_t b) { return a + b; });
+}
+
+// matches global_scan_max, an inclusive maximum
+static inline void cpu_global_scan_max(pnanovdb_util::WorkStealingPool& pool,
+                                       const pnanovdb_uint32_t* val_in,
+                                       pnanovdb_uint32_t* val_out,
+                                       pnanovdb_uint64_t val_count)
+{
+    cpu_scan(
+        pool, val_in, val_out, val_count, [](pnanovdb_uint32_t a, pnanovdb_uint32_t b) { return std::max(a, b); });
+}
+
+// matches radix_sort and radix_sort_key64, stable by the low key_bit_count bits, digits that are equal for all keys
+// are skipped as in the onesweep sort
+template <typename key_t>
+static inline void cpu_radix_sort(pnanovdb_util::WorkStealingPool& pool,
+                                  key_t* key_inout,
+                                  pnanovdb_uint32_t* val_inout,
+                                  pnanovdb_uint64_t key_count,
+                                  pnanovdb_uint32_t key_bit_count)
+{
+    if (key_count == 0u)
+    {
+        return;
+    }
+    const pnanovdb_uint32_t bit_count = std::min(key_bit_count, pnanovdb_uint32_t(8u * sizeof(key_t)));
+    const pnanovdb_uint64_t block_count = cpu_block_count(pool, key_count);
+
+    std::vector<key_t> key_tmp(key_count);
+    std::vector<pnanovdb_uint32_t> val_tmp(key_count);
+    key_t* key_src = key_inout;
+    key_t* key_dst = key_tmp.data();
+    pnanovdb_uint32_t* val_src = val_inout;
+    pnanovdb_uint32_t* val_dst = val_tmp.data();
+
+    // digit counts of each block, then the output offset of each digit in each block
+    std::vector<pnanovdb_uint64_t> block_offsets(256u * block_count);
+    for (pnanovdb_uint32_t pass_start = 0u; pass_start < bit_count; pass_start += 8u)
+    {
+        const key_t digit_mask = key_t(cpu_key_mask(std::min(8u, bit_count - pass_start)));
+        cpu_for_each_block(pool, key_count, block_count,
+                           [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                           {
+                               pnanovdb_uint64_t* histogram = block_offsets.data() + 256u * block_idx;
+                               std::fill(histogram, histogram + 256u, 0u);
+                               for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                               {
+                                   histogram[(key_src[idx] >> pass_start) & digit_mask]++;
+                               }
+                           });
+
+        // digit major order keeps the sort stable
+        bool constant_digit = false;
+        pnanovdb_uint64_t offset = 0u;
+        for (pnanovdb_uint32_t digit = 0u; digit < 256u; digit++)
+        {
+            pnanovdb_uint64_t digit_count = 0u;
+            for (pnanovdb_uint64_t block_idx = 0u; block_idx < block_count; block_idx++)
+            {
+                pnanovdb_uint64_t count = block_offsets[256u * block_idx + digit];
+                block_offsets[256u * block_idx + digit] = offset;
+                offset += count;
+                digit_count += count;
+            }
+            constant_digit = constant_digit || digit_count == key_count;
+        }
+        if (constant_digit)
+        {
+            continue;
+        }
+
+        cpu_for_each_block(pool, key_count, block_count,
+                           [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                           {
+                               pnanovdb_uint64_t* offsets = block_offsets.data() + 256u * block_idx;
+                               for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                               {
+                                   pnanovdb_uint64_t dst_idx = offsets[(key_src[idx] >> pass_start) & digit_mask]++;
+                                   key_dst[dst_idx] = key_src[idx];
+                                   val_dst[dst_idx] = val_src[idx];
+                               }
+                           });
+        std::swap(key_src, key_dst);
+        std::swap(val_src, val_dst);
+    }
+
+    // an odd number of passes leaves the result in the tmp arrays
+    if (key_src != key_inout)
+    {
+        pool.parallel_for(key_count, 65536u,
+                          [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                          {
+                              std::copy(key_src + begin, key_src + end, key_inout + begin);
+                              std::copy(val_src + begin, val_src + end, val_inout + begin);
+                          });
+    }
+}
+
+// matches radix_sort_dual_key, stable by the high key bits and then the low key bits
+static inline void cpu_radix_sort_dual_key(pnanovdb_util::WorkStealingPool& pool,
+                                           pnanovdb_uint32_t* key_low_inout,
+                                           pnanovdb_uint32_t* key_high_inout,
+                                           pnanovdb_uint32_t* val_inout,
+                                           pnanovdb_uint64_t key_count,
+                                           pnanovdb_uint32_t key_low_bit_count,
+                                           pnanovdb_uint32_t key_high_bit_count)
+{
+    const pnanovdb_uint64_t key_low_mask = cpu_key_mask(std::min(key_low_bit_count, 32u));
+    const pnanovdb_uint64_t key_high_mask = cpu_key_mask(std::min(key_high_bit_count, 32u));
+
+    // one 64-bit sort of the combined keys, the masked out bits in between are skipped as constant digits
+    std::vector<pnanovdb_uint64_t> keys(key_count);
+    std::vector<pnanovdb_uint32_t> order(key_count);
+    pool.parallel_for(key_count, 65536u,
+                      [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                      {
+                          for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                          {
+                              keys[idx] = ((key_high_inout[idx] & key_high_mask) << 32u) |
+                                          (key_low_inout[idx] & key_low_mask);
+                              order[idx] = pnanovdb_uint32_t(idx);
+                          }
+                      });
+    cpu_radix_sort(pool, keys.data(), order.data(), key_count, 32u + std::min(key_high_bit_count, 32u));
+
+    std::vector<pnanovdb_uint32_t> key_low(key_low_inout, key_low_inout + key_count);
+    std::vector<pnanovdb_uint32_t> key_high(key_high_inout, key_high_inout + key_count);
+    std::vector<pnanovdb_uint32_t> vals(val_inout, val_inout + key_count);
+    pool.parallel_for(key_count, 65536u,
+                      [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                      {
+                          for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                          {
+                              key_low_inout[idx] = key_low[order[idx]];
+                              key_high_inout[idx] = key_high[order[idx]];
+                              val_inout[idx] = vals[order[idx]];
+                          }
+                      });
+}
+
+// matches segmented_scan, an inclusive sum that restarts at every nonzero flag
+static inline void cpu_segmented_scan(pnanovdb_util::WorkStealingPool& pool,
+                                      const pnanovdb_uint32_t* val_in,
+                                      const pnanovdb_uint32_t* flag_in,
+                                      pnanovdb_uint32_t* val_out,
+                                      pnanovdb_uint64_t val_count)
+{
+    if (val_count == 0u)
+    {
+        return;
+    }
+    const pnanovdb_uint64_t block_count = cpu_block_count(pool, val_count);
+    std::vector<pnanovdb_uint32_t> block_sums(block_count);
+    std::vector<pnanovdb_uint32_t> block_flags(block_count);
+    cpu_for_each_block(pool, val_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           pnanovdb_uint32_t sum = 0u;
+                           pnanovdb_uint32_t flag = 0u;
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               sum = flag_in[idx] != 0u ? val_in[idx] : sum + val_in[idx];
+                               flag |= flag_in[idx];
+                           }
+                           block_sums[block_idx] = sum;
+                           block_flags[block_idx] = flag;
+                       });
+
+    // the carry into a block only reaches its values ahead of the first flag
+    pnanovdb_uint32_t carry = 0u;
+    for (pnanovdb_uint64_t block_idx = 0u; block_idx < block_count; block_idx++)
+    {
+        pnanovdb_uint32_t sum = block_sums[block_idx];
+        block_sums[block_idx] = carry;
+        carry = block_flags[block_idx] != 0u ? sum : carry + sum;
+    }
+
+    cpu_for_each_block(pool, val_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           pnanovdb_uint32_t sum = block_sums[block_idx];
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               sum = flag_in[idx] != 0u ? val_in[idx] : sum + val_in[idx];
+                               val_out[idx] = sum;
+                           }
+                       });
+}
+
+// matches segmented_radix_sort, flags are 1 at the first key of each segment and 0 elsewhere
+static inline void cpu_segmented_radix_sort(pnanovdb_util::WorkStealingPool& pool,
+                                            pnanovdb_uint32_t* key_inout,
+                                            pnanovdb_uint32_t* val_inout,
+                                            const pnanovdb_uint32_t* flag_in,
+                                            pnanovdb_uint64_t key_count,
+                                            pnanovdb_uint32_t key_bit_count)
+{
+    // segment ids as the high key, as on the device
+    std::vector<pnanovdb_uint32_t> segment_ids(key_count);
+    cpu_global_scan(pool, flag_in, segment_ids.data(), key_count);
+    cpu_radix_sort_dual_key(pool, key_inout, segment_ids.data(), val_inout, key_count, key_bit_count, 32u);
+}
+
+// matches select_if and partition, returns the selected count
+static inline pnanovdb_uint64_t cpu_select(pnanovdb_util::WorkStealingPool& pool,
+                                           const pnanovdb_uint32_t* val_in,
+                                           const pnanovdb_uint32_t* flag_in,
+                                           pnanovdb_uint32_t* val_out,
+                                           pnanovdb_uint64_t val_count,
+                                           bool partition)
+{
+    if (val_count == 0u)
+    {
+        return 0u;
+    }
+    const pnanovdb_uint64_t block_count = cpu_block_count(pool, val_count);
+    std::vector<pnanovdb_uint64_t> block_selected(block_count);
+    cpu_for_each_block(pool, val_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           pnanovdb_uint64_t selected = 0u;
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               selected += flag_in[idx] != 0u ? 1u : 0u;
+                           }
+                           block_selected[block_idx] = selected;
+                       });
+    const pnanovdb_uint64_t selected_count =
+        cpu_block_exclusive_scan(block_selected, [](pnanovdb_uint64_t a, pnanovdb_uint64_t b) { return a + b; });
+
+    // rejected values follow the selected ones, after the rejected values of earlier blocks
+    cpu_for_each_block(pool, val_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           pnanovdb_uint64_t selected_idx = block_selected[block_idx];
+                           pnanovdb_uint64_t rejected_idx = selected_count + begin - block_selected[block_idx];
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               if (flag_in[idx] != 0u)
+                               {
+                                   val_out[selected_idx++] = val_in[idx];
+                               }
+                               else if (partition)
+                               {
+                                   val_out[rejected_idx++] = val_in[idx];
+                               }
+                           }
+                       });
+    return selected_count;
+}
+
+// matches run_length_encode and run_length_encode_key64, returns the run count
+template <typename key_t>
+static inline pnanovdb_uint64_t cpu_run_length_encode(pnanovdb_util::WorkStealingPool& pool,
+                                                      const key_t* key_in,
+                                                      pnanovdb_uint32_t* range_out,
+                                                      pnanovdb_uint64_t key_count)
+{
+    if (key_count == 0u)
+    {
+        return 0u;
+    }
+    auto is_first = [&](pnanovdb_uint64_t idx) { return idx == 0u || key_in[idx] != key_in[idx - 1u]; };
+
+    const pnanovdb_uint64_t block_count = cpu_block_count(pool, key_count);
+    std::vector<pnanovdb_uint64_t> block_runs(block_count);
+    cpu_for_each_block(pool, key_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           pnanovdb_uint64_t runs = 0u;
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               runs += is_first(idx) ? 1u : 0u;
+                           }
+                           block_runs[block_idx] = runs;
+                       });
+    const pnanovdb_uint64_t run_count =
+        cpu_block_exclusive_scan(block_runs, [](pnanovdb_uint64_t a, pnanovdb_uint64_t b) { return a + b; });
+
+    // every run gets both its begin and end, only the pairs past the run count need clearing
+    cpu_for_each_block(pool, key_count, block_count,
+                       [&](pnanovdb_uint64_t block_idx, pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                       {
+                           pnanovdb_uint64_t run_idx = block_runs[block_idx];
+                           for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                           {
+                               if (is_first(idx))
+                               {
+                                   range_out[2u * run_idx + 0u] = pnanovdb_uint32_t(idx);
+                                   run_idx++;
+                               }
+                               if (idx + 1u == key_count || is_first(idx + 1u))
+                               {
+                                   range_out[2u * (run_idx - 1u) + 1u] = pnanovdb_uint32_t(idx + 1u);
+                               }
+                           }
+                       });
+    std::fill(range_out + 2u * run_count, range_out + 2u * key_count, 0u);
+    return run_count;
+}
+} // namespace pnanovdb_raster
@@ -0,0 +1,695 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/CpuRaster2D.h
+
+    \author Andrew Reidmeyer
+
+    \brief  CPU gaussian rasterizer, host mirror of the raster_gaussian_2d shaders for machines without a device.
+
+    Chunks are culled and projected as in gaussian_cull_chunks.slang and gaussian_projection.slang, colors are the SH
+    of gaussian_spherical_harmonics.slang at the view direction. Each thread projects k_gaussian_chunk_size gaussians
+    at a time in structure of arrays lanes without branches. Intersections are binned per tile and sorted by depth
+    and gaussian index, so the image does not depend on the thread count. A tile blends front to back with the
+    pixels in the inner loop, with the alpha threshold and early termination of gaussian_rasterize_2d_common.slang.
+*/
+
+#pragma once
+
+#include "GaussianChunks.h"
+
+#include "nanovdb_editor/putil/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+namespace pnanovdb_raster
+{
+// SH coefficients of degree 4
+static constexpr pnanovdb_uint32_t k_cpu_raster_sh_basis_count = 25u;
+// pixels of the largest tile variant
+static constexpr pnanovdb_uint32_t k_cpu_raster_max_tile_pixels = 256u;
+// gaussians blended between checks whether all pixels of a tile terminated
+static constexpr pnanovdb_uint32_t k_cpu_raster_done_check = 32u;
+
+// host arrays of gaussian_data_t, chunk arrays may be null to project every gaussian
+struct cpu_raster_gaussians_t
+{
+    pnanovdb_uint64_t point_count;
+    const float* means;
+    const float* quaternions;
+    const float* scales;
+    const float* opacities;
+    const float* sh_0;
+    const float* sh_n;
+    pnanovdb_uint32_t sh_stride;
+
+    pnanovdb_uint64_t chunk_count;
+    const pnanovdb_uint32_t* chunk_indices;
+    const gaussian_chunk_bounds_t* chunk_bounds;
+};
+
+// view_t of raster2d_common.slang and the image constants
+struct cpu_raster_camera_t
+{
+    pnanovdb_camera_mat_t view;
+    pnanovdb_vec4_t frustum_planes[6];
+    pnanovdb_vec4_t depth_row;
+    pnanovdb_vec3_t view_dir;
+    pnanovdb_uint32_t is_orthographic;
+    float near_plane;
+    float far_plane;
+    float fx;
+    float fy;
+    float cx;
+    float cy;
+    pnanovdb_uint32_t image_width;
+    pnanovdb_uint32_t image_height;
+};
+
+struct cpu_raster_params_t
+{
+    float eps2d;
+    float radius_clip;
+    float cull_radius_2d;
+    pnanovdb_uint32_t sh_degree;
+    pnanovdb_uint32_t sh_stride_rgbrgbrgb;
+    pnanovdb_uint32_t tile_width;
+    pnanovdb_uint32_t tile_height;
+    pnanovdb_uint32_t composite;
+};
+
+// projected gaussians, radius 0 marks a culled one
+struct cpu_raster_splats_t
+{
+    std::vector<pnanovdb_int32_t> radius;
+    std::vector<float> mean2d_x;
+    std::vector<float> mean2d_y;
+    std::vector<float> depth;
+    std::vector<float> conic_a;
+    std::vector<float> conic_b;
+    std::vector<float> conic_c;
+    std::vector<float> color_r;
+    std::vector<float> color_g;
+    std::vector<float> color_b;
+
+    void resize(pnanovdb_uint64_t count)
+    {
+        radius.resize(count);
+        mean2d_x.resize(count);
+        mean2d_y.resize(count);
+        depth.resize(count);
+        conic_a.resize(count);
+        conic_b.resize(count);
+        conic_c.resize(count);
+        color_r.resize(count);
+        color_g.resize(count);
+        color_b.resize(count);
+    }
+};
+
+// matches the view constants of raster_gaussian_2d_batch
+static inline cpu_raster_camera_t cpu_raster_camera(const pnanovdb_camera_mat_t& view,
+                                                    const pnanovdb_camera_mat_t& projection,
+                                                    pnanovdb_uint32_t image_width,
+                                                    pnanovdb_uint32_t image_height)
+{
+    cpu_raster_camera_t camera = {};
+    extract_camera_info(view, projection, &camera.view_dir, &camera.near_plane, &camera.far_plane);
+    camera.view = view;
+    camera.fx = (float)image_width * 0.5f * projection.x.x;
+    camera.fy = (float)image_height * 0.5f * projection.y.y;
+    camera.cx = (float)image_width * 0.5f;
+    camera.cy = (float)image_height * 0.5f;
+    camera.is_orthographic = projection.z.w == 0.f ? 1u : 0u;
+    camera.image_width = image_width;
+    camera.image_height = image_height;
+
+    pnanovdb_camera_mat_t view_proj = pnanovdb_camera_mat_mul(view, projection);
+    extract_frustum_planes(view_proj, camera.frustum_planes);
+    camera.depth_row = { view_proj.x.w, view_proj.y.w, view_proj.z.w, view_proj.w.w };
+    return camera;
+}
+
+// matches gaussian_spherical_harmonics.slang, the degree the SH stride holds coefficients for
+static inline pnanovdb_uint32_t cpu_raster_sh_degree(pnanovdb_int32_t sh_degree, pnanovdb_uint32_t sh_stride)
+{
+    pnanovdb_uint32_t degree = sh_degree < 0 ? 3u : (pnanovdb_uint32_t)sh_degree;
+    if (sh_stride < 3u)
+    {
+        degree = 0u;
+    }
+    else if (sh_stride < 8u)
+    {
+        degree = degree > 1u ? 1u : degree;
+    }
+    else if (sh_stride < 15u)
+    {
+        degree = degree > 2u ? 2u : degree;
+    }
+    else if (sh_stride < 24u)
+    {
+        degree = degree > 3u ? 3u : degree;
+    }
+    // eval_sh_function stops at degree 4
+    return degree > 4u ? 4u : degree;
+}
+
+// SH bases of eval_sh_function, all gaussians of a view share the direction, coefficients past degree are 0
+static inline void cpu_raster_sh_basis(pnanovdb_uint32_t degree,
+                                       const pnanovdb_vec3_t& dir,
+                                       float basis[k_cpu_raster_sh_basis_count])
+{
+    for (pnanovdb_uint32_t idx = 0u; idx < k_cpu_raster_sh_basis_count; idx++)
+    {
+        basis[idx] = 0.f;
+    }
+    basis[0] = 0.2820947917738781f;
+    if (degree < 1u)
+    {
+        return;
+    }
+    float inorm = 1.f / sqrtf(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+    float x = dir.x * inorm;
+    float y = dir.y * inorm;
+    float z = dir.z * inorm;
+
+    basis[1] = -0.48860251190292f * y;
+    basis[2] = 0.48860251190292f * z;
+    basis[3] = -0.48860251190292f * x;
+    if (degree < 2u)
+    {
+        return;
+    }
+    float z2 = z * z;
+    float fTmp0B = -1.092548430592079f * z;
+    float fC1 = x * x - y * y;
+    float fS1 = 2.f * x * y;
+    basis[4] = 0.5462742152960395f * fS1;
+    basis[5] = fTmp0B * y;
+    basis[6] = 0.9461746957575601f * z2 - 0.3153915652525201f;
+    basis[7] = fTmp0B * x;
+    basis[8] = 0.5462742152960395f * fC1;
+    if (degree < 3u)
+    {
+        return;
+    }
+    float fTmp0C = -2.285228997322329f * z2 + 0.4570457994644658f;
+    float fTmp1B = 1.445305721320277f * z;
+    float fC2 = x * fC1 - y * fS1;
+    float fS2 = x * fS1 + y * fC1;
+    basis[9] = -0.5900435899266435f * fS2;
+    basis[10] = fTmp1B * fS1;
+    basis[11] = fTmp0C * y;
+    basis[12] = z * (1.865881662950577f * z2 - 1.119528997770346f);
+    basis[13] = fTmp0C * x;
+    basis[14] = fTmp1B * fC1;
+    basis[15] = -0.5900435899266435f * fC2;
+    if (degree < 4u)
+    {
+        return;
+    }
+    float fTmp0D = z * (-4.683325804901025f * z2 + 2.007139630671868f);
+    float fTmp1C = 3.31161143515146f * z2 - 0.47308734787878f;
+    float fTmp2B = -1.770130769779931f * z;
+    float fC3 = x * fC2 - y * fS2;
+    float fS3 = x * fS2 + y * fC2;
+    basis[16] = 0.6258357354491763f * fS3;
+    basis[17] = fTmp2B * fS2;
+    basis[18] = fTmp1C * fS1;
+    basis[19] = fTmp0D * y;
+    basis[20] = 1.984313483298443f * z * basis[12] - 1.006230589874905f * basis[6];
+    basis[21] = fTmp0D * x;
+    basis[22] = fTmp1C * fC1;
+    basis[23] = fTmp2B * fC2;
+    basis[24] = 0.6258357354491763f * fC3;
+}
+
+// Projects and colors the lane_count gaussians of indices, mirrors gaussian_projection.slang per lane
+static inline void cpu_raster_project(const cpu_raster_gaussians_t& gaussians,
+                                      const cpu_raster_camera_t& camera,
+                                      const cpu_raster_params_t& params,
+                                      const float sh_basis[k_cpu_raster_sh_basis_count],
+                                      const pnanovdb_uint32_t* indices,
+                                      pnanovdb_uint32_t lane_count,
+                                      cpu_raster_splats_t& splats)
+{
+    constexpr pnanovdb_uint32_t lanes = k_gaussian_chunk_size;
+    float mx[lanes], my[lanes], mz[lanes];
+    float qx[lanes], qy[lanes], qz[lanes], qw[lanes];
+    float sx[lanes], sy[lanes], sz[lanes];
+    for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+    {
+        pnanovdb_uint64_t idx = indices[lane];
+        mx[lane] = gaussians.means[3u * idx + 0u];
+        my[lane] = gaussians.means[3u * idx + 1u];
+        mz[lane] = gaussians.means[3u * idx + 2u];
+        qw[lane] = gaussians.quaternions[4u * idx + 0u];
+        qx[lane] = gaussians.quaternions[4u * idx + 1u];
+        qy[lane] = gaussians.quaternions[4u * idx + 2u];
+        qz[lane] = gaussians.quaternions[4u * idx + 3u];
+        sx[lane] = gaussians.scales[3u * idx + 0u];
+        sy[lane] = gaussians.scales[3u * idx + 1u];
+        sz[lane] = gaussians.scales[3u * idx + 2u];
+    }
+
+    const pnanovdb_camera_mat_t& v = camera.view;
+    const float width = (float)camera.image_width;
+    const float height = (float)camera.image_height;
+    const float z_sign = camera.near_plane < 0.f ? -1.f : 1.f;
+    const float tan_fovx = 0.5f * width / camera.fx;
+    const float tan_fovy = 0.5f * height / camera.fy;
+    const float lim_x_pos = (width - camera.cx) / camera.fx + 0.3f * tan_fovx;
+    const float lim_x_neg = camera.cx / camera.fx + 0.3f * tan_fovx;
+    const float lim_y_pos = (height - camera.cy) / camera.fy + 0.3f * tan_fovy;
+    const float lim_y_neg = camera.cy / camera.fy + 0.3f * tan_fovy;
+    const bool ortho = camera.is_orthographic != 0u;
+
+    pnanovdb_int32_t radius_out[lanes];
+    float mean2d_x[lanes], mean2d_y[lanes], depth[lanes], conic_a[lanes], conic_b[lanes], conic_c[lanes];
+    for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+    {
+        // mean * view, view is row major with the translation in w
+        float cxv = mx[lane] * v.x.x + my[lane] * v.y.x + mz[lane] * v.z.x + v.w.x;
+        float cyv = mx[lane] * v.x.y + my[lane] * v.y.y + mz[lane] * v.z.y + v.w.y;
+        float czv = mx[lane] * v.x.z + my[lane] * v.y.z + mz[lane] * v.z.z + v.w.z;
+        bool in_depth = camera.near_plane > 0.f ? !(czv < camera.near_plane || czv > camera.far_plane) :
+                                                  !(-czv < -camera.near_plane || -czv > -camera.far_plane);
+
+        // R * S * S^T * R^T, the quaternion is used as stored
+        float x = qx[lane], y = qy[lane], z = qz[lane], w = qw[lane];
+        float r00 = 1.f - 2.f * (y * y + z * z), r01 = 2.f * (x * y - z * w), r02 = 2.f * (x * z + y * w);
+        float r10 = 2.f * (x * y + z * w), r11 = 1.f - 2.f * (x * x + z * z), r12 = 2.f * (y * z - x * w);
+        float r20 = 2.f * (x * z - y * w), r21 = 2.f * (y * z + x * w), r22 = 1.f - 2.f * (x * x + y * y);
+        float m00 = r00 * sx[lane], m01 = r01 * sy[lane], m02 = r02 * sz[lane];
+        float m10 = r10 * sx[lane], m11 = r11 * sy[lane], m12 = r12 * sz[lane];
+        float m20 = r20 * sx[lane], m21 = r21 * sy[lane], m22 = r22 * sz[lane];
+        float c00 = m00 * m00 + m01 * m01 + m02 * m02;
+        float c01 = m00 * m10 + m01 * m11 + m02 * m12;
+        float c02 = m00 * m20 + m01 * m21 + m02 * m22;
+        float c11 = m10 * m10 + m11 * m11 + m12 * m12;
+        float c12 = m10 * m20 + m11 * m21 + m12 * m22;
+        float c22 = m20 * m20 + m21 * m21 + m22 * m22;
+
+        // view_rot * covar * view_rot^T, row i of view_rot is column i of the view matrix
+        float a00 = v.x.x * c00 + v.y.x * c01 + v.z.x * c02;
+        float a01 = v.x.x * c01 + v.y.x * c11 + v.z.x * c12;
+        float a02 = v.x.x * c02 + v.y.x * c12 + v.z.x * c22;
+        float a10 = v.x.y * c00 + v.y.y * c01 + v.z.y * c02;
+        float a11 = v.x.y * c01 + v.y.y * c11 + v.z.y * c12;
+        float a12 = v.x.y * c02 + v.y.y * c12 + v.z.y * c22;
+        float a20 = v.x.z * c00 + v.y.z * c01 + v.z.z * c02;
+        float a21 = v.x.z * c01 + v.y.z * c11 + v.z.z * c12;
+        float a22 = v.x.z * c02 + v.y.z * c12 + v.z.z * c22;
+        float k00 = a00 * v.x.x + a01 * v.y.x + a02 * v.z.x;
+        float k01 = a00 * v.x.y + a01 * v.y.y + a02 * v.z.y;
+        float k02 = a00 * v.x.z + a01 * v.y.z + a02 * v.z.z;
+        float k11 = a10 * v.x.y + a11 * v.y.y + a12 * v.z.y;
+        float k12 = a10 * v.x.z + a11 * v.y.z + a12 * v.z.z;
+        float k22 = a20 * v.x.z + a21 * v.y.z + a22 * v.z.z;
+
+        // persp_proj and ortho_proj, J = [j00 0 j02; 0 j11 j12]
+        float pz = z_sign * czv;
+        float rz = 1.f / pz;
+        float rz2 = rz * rz;
+        float tx = pz * fminf(lim_x_pos, fmaxf(-lim_x_neg, cxv * rz));
+        float ty = pz * fminf(lim_y_pos, fmaxf(-lim_y_neg, cyv * rz));
+        float j00 = ortho ? camera.fx : camera.fx * rz;
+        float j11 = ortho ? camera.fy : camera.fy * rz;
+        float j02 = ortho ? 0.f : -z_sign * camera.fx * tx * rz2;
+        float j12 = ortho ? 0.f : -z_sign * camera.fy * ty * rz2;
+        float u = ortho ? camera.fx * cxv + camera.cx : camera.fx * cxv * rz + camera.cx;
+        float vv = ortho ? camera.fy * cyv + camera.cy : camera.fy * cyv * rz + camera.cy;
+
+        float cov00 = j00 * j00 * k00 + 2.f * j00 * j02 * k02 + j02 * j02 * k22;
+        float cov01 = j00 * (j11 * k01 + j12 * k02) + j02 * (j11 * k12 + j12 * k22);
+        float cov11 = j11 * j11 * k11 + 2.f * j11 * j12 * k12 + j12 * j12 * k22;
+
+        // add_blur and inverse
+        cov00 += params.eps2d;
+        cov11 += params.eps2d;
+        float det = cov00 * cov11 - cov01 * cov01;
+        float inv_det = det > 0.f ? 1.f / det : 0.f;
+
+        float b = 0.5f * (cov00 + cov11);
+        float v1 = b + sqrtf(fmaxf(0.01f, b * b - det));
+        float radius = ceilf(3.f * sqrtf(v1));
+
+        bool on_screen = !(u + radius <= 0.f || u - radius >= width || vv + radius <= 0.f || vv - radius >= height);
+        bool visible = in_depth && det > 0.f && radius > params.radius_clip && on_screen;
+
+        radius_out[lane] = visible ? (pnanovdb_int32_t)radius : 0;
+        mean2d_x[lane] = u;
+        mean2d_y[lane] = vv;
+        depth[lane] = czv;
+        conic_a[lane] = cov11 * inv_det;
+        conic_b[lane] = -cov01 * inv_det;
+        conic_c[lane] = cov00 * inv_det;
+    }
+
+    for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+    {
+        pnanovdb_uint64_t idx = indices[lane];
+        splats.radius[idx] = radius_out[lane];
+        splats.mean2d_x[idx] = mean2d_x[lane];
+        splats.mean2d_y[idx] = mean2d_y[lane];
+        splats.depth[idx] = depth[lane];
+        splats.conic_a[idx] = conic_a[lane];
+        splats.conic_b[idx] = conic_b[lane];
+        splats.conic_c[idx] = conic_c[lane];
+    }
+
+    // eval_sh_function, one basis for all lanes, coefficient k of degree > 0 is sh_n entry k - 1
+    pnanovdb_uint32_t basis_count = (params.sh_degree + 1u) * (params.sh_degree + 1u);
+    float red[lanes], green[lanes], blue[lanes];
+    for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+    {
+        pnanovdb_uint64_t idx = indices[lane];
+        red[lane] = 0.5f + sh_basis[0] * gaussians.sh_0[3u * idx + 0u];
+        green[lane] = 0.5f + sh_basis[0] * gaussians.sh_0[3u * idx + 1u];
+        blue[lane] = 0.5f + sh_basis[0] * gaussians.sh_0[3u * idx + 2u];
+    }
+    pnanovdb_uint64_t sh_stride = gaussians.sh_stride;
+    pnanovdb_uint64_t coeff_step = params.sh_stride_rgbrgbrgb != 0u ? 3u : 1u;
+    pnanovdb_uint64_t channel_step = params.sh_stride_rgbrgbrgb != 0u ? 1u : sh_stride;
+    for (pnanovdb_uint32_t k = 1u; k < basis_count; k++)
+    {
+        float basis = sh_basis[k];
+        for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+        {
+            const float* coeff = gaussians.sh_n + 3u * sh_stride * indices[lane] + coeff_step * (k - 1u);
+            red[lane] += basis * coeff[0u];
+            green[lane] += basis * coeff[channel_step];
+            blue[lane] += basis * coeff[2u * channel_step];
+        }
+    }
+    for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+    {
+        pnanovdb_uint64_t idx = indices[lane];
+        splats.color_r[idx] = red[lane];
+        splats.color_g[idx] = green[lane];
+        splats.color_b[idx] = blue[lane];
+    }
+}
+
+// matches gaussian_tile_intersections.slang, min is inclusive, max is exclusive
+static inline void cpu_raster_tile_rect(const cpu_raster_splats_t& splats,
+                                        pnanovdb_uint64_t idx,
+                                        const cpu_raster_params_t& params,
+                                        pnanovdb_uint32_t num_tiles_w,
+                                        pnanovdb_uint32_t num_tiles_h,
+                                        pnanovdb_uint32_t tile_min[2],
+                                        pnanovdb_uint32_t tile_max[2])
+{
+    float radius = (float)splats.radius[idx];
+    float tile_radius_u = radius / (float)params.tile_width;
+    float tile_radius_v = radius / (float)params.tile_height;
+    float tile_mean_u = splats.mean2d_x[idx] / (float)params.tile_width;
+    float tile_mean_v = splats.mean2d_y[idx] / (float)params.tile_height;
+
+    float bounds[4] = { floorf(tile_mean_u - tile_radius_u), floorf(tile_mean_v - tile_radius_v),
+                        ceilf(tile_mean_u + tile_radius_u), ceilf(tile_mean_v + tile_radius_v) };
+    pnanovdb_uint32_t limits[4] = { num_tiles_w, num_tiles_h, num_tiles_w, num_tiles_h };
+    pnanovdb_uint32_t tiles[4];
+    for (pnanovdb_uint32_t bound_idx = 0u; bound_idx < 4u; bound_idx++)
+    {
+        float bound = fminf(fmaxf(bounds[bound_idx], 0.f), (float)limits[bound_idx]);
+        tiles[bound_idx] = (pnanovdb_uint32_t)bound;
+    }
+    tile_min[0] = tiles[0];
+    tile_min[1] = tiles[1];
+    tile_max[0] = tiles[2];
+    tile_max[1] = tiles[3];
+}
+
+// Blends the intersections of one tile front to back, keys hold the depth bits above the gaussian index
+static inline void cpu_raster_blend_tile(const cpu_raster_splats_t& splats,
+                                         const float* opacities,
+                                         const pnanovdb_uint64_t* keys,
+                                         pnanovdb_uint64_t key_count,
+                                         pnanovdb_uint32_t tile_i,
+                                         pnanovdb_uint32_t tile_j,
+                                         const cpu_raster_params_t& params,
+                                         pnanovdb_uint32_t image_width,
+                                         pnanovdb_uint32_t image_height,
+                                         float* color_2d)
+{
+    constexpr pnanovdb_uint32_t max_pixels = k_cpu_raster_max_tile_pixels;
+    const pnanovdb_uint32_t tile_pixels = params.tile_width * params.tile_height;
+
+    float px[max_pixels], py[max_pixels];
+    float transmittance[max_pixels], red[max_pixels], green[max_pixels], blue[max_pixels];
+    pnanovdb_uint32_t done[max_pixels];
+    pnanovdb_uint32_t live_count = 0u;
+    for (pnanovdb_uint32_t p = 0u; p < tile_pixels; p++)
+    {
+        pnanovdb_uint32_t i = tile_i * params.tile_height + p / params.tile_width;
+        pnanovdb_uint32_t j = tile_j * params.tile_width + p % params.tile_width;
+        px[p] = (float)j + 0.5f;
+        py[p] = (float)i + 0.5f;
+        transmittance[p] = 1.f;
+        red[p] = 0.f;
+        green[p] = 0.f;
+        blue[p] = 0.f;
+        // pixels past the image edge start out done
+        done[p] = (i < image_height && j < image_width) ? 0u : 1u;
+        live_count += 1u - done[p];
+    }
+
+    for (pnanovdb_uint64_t key_idx = 0u; key_idx < key_count && live_count != 0u; key_idx++)
+    {
+        pnanovdb_uint64_t g = keys[key_idx] & 0xFFFFFFFFu;
+        const float x = splats.mean2d_x[g];
+        const float y = splats.mean2d_y[g];
+        const float conic_a = splats.conic_a[g];
+        const float conic_b = splats.conic_b[g];
+        const float conic_c = splats.conic_c[g];
+        const float opac = opacities[g];
+        const float r = splats.color_r[g];
+        const float gr = splats.color_g[g];
+        const float b = splats.color_b[g];
+        for (pnanovdb_uint32_t p = 0u; p < tile_pixels; p++)
+        {
+            float dx = x - px[p];
+            float dy = y - py[p];
+            float sigma = 0.5f * (conic_a * dx * dx + conic_c * dy * dy) + conic_b * dx * dy;
+            float alpha = fminf(0.999f, opac * expf(-sigma));
+            bool live = done[p] == 0u && !(sigma < 0.f || alpha < 1.f / 255.f);
+            float next_transmittance = transmittance[p] * (1.f - alpha);
+            // the gaussian that would take the pixel below the threshold is not blended
+            bool finish = live && next_transmittance <= 1e-4f;
+            bool blend = live && !finish;
+            float vis = blend ? alpha * transmittance[p] : 0.f;
+            red[p] += r * vis;
+            green[p] += gr * vis;
+            blue[p] += b * vis;
+            transmittance[p] = blend ? next_transmittance : transmittance[p];
+            done[p] |= finish ? 1u : 0u;
+        }
+        if ((key_idx + 1u) % k_cpu_raster_done_check == 0u)
+        {
+            live_count = 0u;
+            for (pnanovdb_uint32_t p = 0u; p < tile_pixels; p++)
+            {
+                live_count += 1u - done[p];
+            }
+        }
+    }
+
+    for (pnanovdb_uint32_t p = 0u; p < tile_pixels; p++)
+    {
+        pnanovdb_uint32_t i = tile_i * params.tile_height + p / params.tile_width;
+        pnanovdb_uint32_t j = tile_j * params.tile_width + p % params.tile_width;
+        if (i >= image_height || j >= image_width)
+        {
+            continue;
+        }
+        // rows are flipped as in view_atlas_pixel
+        float* dst = color_2d + 4u * ((pnanovdb_uint64_t)(image_height - 1u - i) * image_width + j);
+        float background[4] = { 0.f, 0.f, 0.f, 1.f };
+        if (params.composite != 0u)
+        {
+            memcpy(background, dst, sizeof(background));
+        }
+        dst[0] = red[p] + transmittance[p] * background[0];
+        dst[1] = green[p] + transmittance[p] * background[1];
+        dst[2] = blue[p] + transmittance[p] * background[2];
+        dst[3] = transmittance[p] * background[3];
+    }
+}
+
+// Rasterizes into color_2d, image_width * image_height float RGBA texels with row 0 at the top
+static inline void cpu_raster_gaussian_2d(pnanovdb_util::WorkStealingPool& pool,
+                                          const cpu_raster_gaussians_t& gaussians,
+                                          const cpu_raster_camera_t& camera,
+                                          const cpu_raster_params_t& params,
+                                          cpu_raster_splats_t& splats,
+                                          float* color_2d)
+{
+    const pnanovdb_uint32_t image_width = camera.image_width;
+    const pnanovdb_uint32_t image_height = camera.image_height;
+    const pnanovdb_uint32_t tile_pixels = params.tile_width * params.tile_height;
+    if (image_width == 0u || image_height == 0u || tile_pixels > k_cpu_raster_max_tile_pixels)
+    {
+        return;
+    }
+    splats.resize(gaussians.point_count);
+
+    float sh_basis[k_cpu_raster_sh_basis_count];
+    cpu_raster_sh_basis(params.sh_degree, camera.view_dir, sh_basis);
+
+    // cull and project a chunk per range item, without chunks the gaussians go in index order
+    bool has_chunks = gaussians.chunk_indices != nullptr && gaussians.chunk_bounds != nullptr;
+    pnanovdb_uint64_t chunk_count = (gaussians.point_count + k_gaussian_chunk_size - 1u) / k_gaussian_chunk_size;
+    pool.parallel_for(
+        chunk_count, 4u,
+        [&](pnanovdb_uint64_t chunk_begin, pnanovdb_uint64_t chunk_end)
+        {
+            pnanovdb_uint32_t indices[k_gaussian_chunk_size];
+            for (pnanovdb_uint64_t chunk_idx = chunk_begin; chunk_idx < chunk_end; chunk_idx++)
+            {
+                pnanovdb_uint64_t begin = chunk_idx * k_gaussian_chunk_size;
+                pnanovdb_uint64_t remaining = gaussians.point_count - begin;
+                pnanovdb_uint32_t lane_count =
+                    (pnanovdb_uint32_t)std::min<pnanovdb_uint64_t>(k_gaussian_chunk_size, remaining);
+                for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+                {
+                    indices[lane] =
+                        has_chunks ? gaussians.chunk_indices[begin + lane] : (pnanovdb_uint32_t)(begin + lane);
+                }
+                if (has_chunks && chunk_idx < gaussians.chunk_count &&
+                    !gaussian_chunk_visible(gaussians.chunk_bounds[chunk_idx], camera.frustum_planes, camera.depth_row,
+                                            camera.fx, params.cull_radius_2d))
+                {
+                    for (pnanovdb_uint32_t lane = 0u; lane < lane_count; lane++)
+                    {
+                        splats.radius[indices[lane]] = 0;
+                    }
+                    continue;
+                }
+                cpu_raster_project(gaussians, camera, params, sh_basis, indices, lane_count, splats);
+            }
+        });
+
+    // intersections per tile, then a slot range per tile
+    const pnanovdb_uint32_t num_tiles_w = (image_width + params.tile_width - 1u) / params.tile_width;
+    const pnanovdb_uint32_t num_tiles_h = (image_height + params.tile_height - 1u) / params.tile_height;
+    const pnanovdb_uint64_t num_tiles = (pnanovdb_uint64_t)num_tiles_w * num_tiles_h;
+    std::unique_ptr<std::atomic<pnanovdb_uint64_t>[]> tile_cursors(new std::atomic<pnanovdb_uint64_t>[num_tiles]);
+    for (pnanovdb_uint64_t tile_idx = 0u; tile_idx < num_tiles; tile_idx++)
+    {
+        tile_cursors[tile_idx].store(0u, std::memory_order_relaxed);
+    }
+    auto for_each_tile = [&](pnanovdb_uint64_t idx, auto&& func)
+    {
+        if (splats.radius[idx] <= 0)
+        {
+            return;
+        }
+        pnanovdb_uint32_t tile_min[2];
+        pnanovdb_uint32_t tile_max[2];
+        cpu_raster_tile_rect(splats, idx, params, num_tiles_w, num_tiles_h, tile_min, tile_max);
+        for (pnanovdb_uint32_t i = tile_min[1]; i < tile_max[1]; i++)
+        {
+            for (pnanovdb_uint32_t j = tile_min[0]; j < tile_max[0]; j++)
+            {
+                func((pnanovdb_uint64_t)i * num_tiles_w + j);
+            }
+        }
+    };
+    pool.parallel_for(gaussians.point_count, 4096u,
+                      [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                      {
+                          for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                          {
+                              for_each_tile(idx, [&](pnanovdb_uint64_t tile_idx)
+                                            { tile_cursors[tile_idx].fetch_add(1u, std::memory_order_relaxed); });
+                          }
+                      });
+    std::vector<pnanovdb_uint64_t> tile_offsets(num_tiles + 1u);
+    tile_offsets[0u] = 0u;
+    for (pnanovdb_uint64_t tile_idx = 0u; tile_idx < num_tiles; tile_idx++)
+    {
+        tile_offsets[tile_idx + 1u] = tile_offsets[tile_idx] + tile_cursors[tile_idx].load(std::memory_order_relaxed);
+        tile_cursors[tile_idx].store(tile_offsets[tile_idx], std::memory_order_relaxed);
+    }
+
+    // the order within a tile depends on the threads until the tile sorts its keys
+    std::vector<pnanovdb_uint64_t> keys(tile_offsets[num_tiles]);
+    pool.parallel_for(gaussians.point_count, 4096u,
+                      [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                      {
+                          for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+                          {
+                              pnanovdb_uint32_t depth_bits = 0u;
+                              memcpy(&depth_bits, &splats.depth[idx], sizeof(depth_bits));
+                              pnanovdb_uint64_t key = ((pnanovdb_uint64_t)depth_bits << 32u) | idx;
+                              for_each_tile(idx,
+                                            [&](pnanovdb_uint64_t tile_idx)
+                                            {
+                                                pnanovdb_uint64_t slot =
+                                                    tile_cursors[tile_idx].fetch_add(1u, std::memory_order_relaxed);
+                                                keys[slot] = key;
+                                            });
+                          }
+                      });
+
+    // dense tiles take longer, idle threads steal the remaining tiles
+    pool.parallel_for(num_tiles, 1u,
+                      [&](pnanovdb_uint64_t begin, pnanovdb_uint64_t end)
+                      {
+                          for (pnanovdb_uint64_t tile_idx = begin; tile_idx < end; tile_idx++)
+                          {
+                              pnanovdb_uint64_t* tile_keys = keys.data() + tile_offsets[tile_idx];
+                              pnanovdb_uint64_t key_count = tile_offsets[tile_idx + 1u] - tile_offsets[tile_idx];
+                              std::sort(tile_keys, tile_keys + key_count);
+                              cpu_raster_blend_tile(splats, gaussians.opacities, tile_keys, key_count,
+                                                    (pnanovdb_uint32_t)(tile_idx / num_tiles_w),
+                                                    (pnanovdb_uint32_t)(tile_idx % num_tiles_w), params, image_width,
+                                                    image_height, color_2d);
+                          }
+                      });
+}
+
+struct cpu_raster_image_diff_t
+{
+    float max_abs_error;
+    double mean_abs_error;
+    double psnr;
+    pnanovdb_uint64_t texels_over_threshold;
+};
+
+// Differences of two float RGBA images over the color channels, psnr for a peak of 1
+static inline cpu_raster_image_diff_t cpu_raster_image_diff(const float* a,
+                                                            const float* b,
+                                                            pnanovdb_uint64_t texel_count,
+                                                            float threshold)
+{
+    cpu_raster_image_diff_t diff = {};
+    double sum_abs = 0.0;
+    double sum_sq = 0.0;
+    for (pnanovdb_uint64_t texel = 0u; texel < texel_count; texel++)
+    {
+        bool over = false;
+        for (pnanovdb_uint32_t channel = 0u; channel < 3u; channel++)
+        {
+            float error = fabsf(a[4u * texel + channel] - b[4u * texel + channel]);
+            diff.max_abs_error = std::max(diff.max_abs_error, error);
+            sum_abs += error;
+            sum_sq += (double)error * error;
+            over = over || error > threshold;
+        }
+        diff.texels_over_threshold += over ? 1u : 0u;
+    }
+    double sample_count = 3.0 * (double)std::max<pnanovdb_uint64_t>(texel_count, 1u);
+    diff.mean_abs_error = sum_abs / sample_count;
+    double mse = sum_sq / sample_count;
+    diff.psnr = mse > 0.0 ? 10.0 * log10(1.0 / mse) : INFINITY;
+    return diff;
+}
+} // namespace pnanovdb_raster
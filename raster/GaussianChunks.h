@@ -0,0 +1,218 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/GaussianChunks.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Spatial chunks of gaussians for frustum and screen size culling before projection
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Compute.h"
+#include "nanovdb_editor/putil/Camera.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+namespace pnanovdb_raster
+{
+// one workgroup of gaussian_cull_chunks.slang per chunk
+static constexpr pnanovdb_uint32_t k_gaussian_chunk_size = 256u;
+
+struct gaussian_chunk_bounds_t
+{
+    float x;
+    float y;
+    float z;
+    float radius;
+};
+
+static inline pnanovdb_uint32_t gaussian_morton_expand_bits(pnanovdb_uint32_t v)
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+// Morton order of the means quantized to 10 bits per axis within their bounding box
+static inline void sort_gaussians_morton(const float* means, pnanovdb_uint64_t point_count, pnanovdb_uint32_t* indices)
+{
+    float bbox_min[3] = { INFINITY, INFINITY, INFINITY };
+    float bbox_max[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (pnanovdb_uint64_t idx = 0u; idx < point_count; idx++)
+    {
+        for (pnanovdb_uint32_t axis = 0u; axis < 3u; axis++)
+        {
+            bbox_min[axis] = std::min(bbox_min[axis], means[3u * idx + axis]);
+            bbox_max[axis] = std::max(bbox_max[axis], means[3u * idx + axis]);
+        }
+    }
+    float scale[3] = {};
+    for (pnanovdb_uint32_t axis = 0u; axis < 3u; axis++)
+    {
+        float extent = bbox_max[axis] - bbox_min[axis];
+        scale[axis] = extent > 0.f ? 1023.f / extent : 0.f;
+    }
+
+    // code in the high bits, index in the low bits, keeps equal codes in load order
+    std::vector<pnanovdb_uint64_t> keys(point_count);
+    for (pnanovdb_uint64_t idx = 0u; idx < point_count; idx++)
+    {
+        pnanovdb_uint32_t code = 0u;
+        for (pnanovdb_uint32_t axis = 0u; axis < 3u; axis++)
+        {
+            float q = (means[3u * idx + axis] - bbox_min[axis]) * scale[axis];
+            pnanovdb_uint32_t qi = q > 0.f ? std::min(pnanovdb_uint32_t(q), 1023u) : 0u;
+            code |= gaussian_morton_expand_bits(qi) << axis;
+        }
+        keys[idx] = (pnanovdb_uint64_t(code) << 32u) | idx;
+    }
+    std::sort(keys.begin(), keys.end());
+    for (pnanovdb_uint64_t idx = 0u; idx < point_count; idx++)
+    {
+        indices[idx] = pnanovdb_uint32_t(keys[idx] & 0xFFFFFFFFu);
+    }
+}
+
+// Bounding sphere per chunk of sorted gaussians, each gaussian covers three sigma of its largest scale
+static inline void compute_gaussian_chunk_bounds(const float* means,
+                                                 const float* scales,
+                                                 const pnanovdb_uint32_t* indices,
+                                                 pnanovdb_uint64_t point_count,
+                                                 gaussian_chunk_bounds_t* bounds)
+{
+    pnanovdb_uint64_t chunk_count = (point_count + k_gaussian_chunk_size - 1u) / k_gaussian_chunk_size;
+    for (pnanovdb_uint64_t chunk_idx = 0u; chunk_idx < chunk_count; chunk_idx++)
+    {
+        pnanovdb_uint64_t begin = chunk_idx * k_gaussian_chunk_size;
+        pnanovdb_uint64_t end = std::min(begin + k_gaussian_chunk_size, point_count);
+
+        float bbox_min[3] = { INFINITY, INFINITY, INFINITY };
+        float bbox_max[3] = { -INFINITY, -INFINITY, -INFINITY };
+        for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+        {
+            const float* mean = means + 3u * pnanovdb_uint64_t(indices[idx]);
+            for (pnanovdb_uint32_t axis = 0u; axis < 3u; axis++)
+            {
+                bbox_min[axis] = std::min(bbox_min[axis], mean[axis]);
+                bbox_max[axis] = std::max(bbox_max[axis], mean[axis]);
+            }
+        }
+        gaussian_chunk_bounds_t chunk = {};
+        chunk.x = 0.5f * (bbox_min[0] + bbox_max[0]);
+        chunk.y = 0.5f * (bbox_min[1] + bbox_max[1]);
+        chunk.z = 0.5f * (bbox_min[2] + bbox_max[2]);
+        for (pnanovdb_uint64_t idx = begin; idx < end; idx++)
+        {
+            const float* mean = means + 3u * pnanovdb_uint64_t(indices[idx]);
+            const float* scale = scales + 3u * pnanovdb_uint64_t(indices[idx]);
+            float dx = mean[0] - chunk.x;
+            float dy = mean[1] - chunk.y;
+            float dz = mean[2] - chunk.z;
+            float scale_max = std::max(std::max(fabsf(scale[0]), fabsf(scale[1])), fabsf(scale[2]));
+            chunk.radius = std::max(chunk.radius, sqrtf(dx * dx + dy * dy + dz * dz) + 3.f * scale_max);
+        }
+        bounds[chunk_idx] = chunk;
+    }
+}
+
+// World space planes of view * projection with 0 <= z <= w, inside is dot(plane, pos) >= 0, normals are unit length
+static inline void extract_frustum_planes(const pnanovdb_camera_mat_t& view_proj, pnanovdb_vec4_t planes[6])
+{
+    const pnanovdb_vec4_t col_x = { view_proj.x.x, view_proj.y.x, view_proj.z.x, view_proj.w.x };
+    const pnanovdb_vec4_t col_y = { view_proj.x.y, view_proj.y.y, view_proj.z.y, view_proj.w.y };
+    const pnanovdb_vec4_t col_z = { view_proj.x.z, view_proj.y.z, view_proj.z.z, view_proj.w.z };
+    const pnanovdb_vec4_t col_w = { view_proj.x.w, view_proj.y.w, view_proj.z.w, view_proj.w.w };
+
+    planes[0] = { col_w.x + col_x.x, col_w.y + col_x.y, col_w.z + col_x.z, col_w.w + col_x.w };
+    planes[1] = { col_w.x - col_x.x, col_w.y - col_x.y, col_w.z - col_x.z, col_w.w - col_x.w };
+    planes[2] = { col_w.x + col_y.x, col_w.y + col_y.y, col_w.z + col_y.z, col_w.w + col_y.w };
+    planes[3] = { col_w.x - col_y.x, col_w.y - col_y.y, col_w.z - col_y.z, col_w.w - col_y.w };
+    planes[4] = col_z;
+    planes[5] = { col_w.x - col_z.x, col_w.y - col_z.y, col_w.z - col_z.z, col_w.w - col_z.w };
+
+    for (pnanovdb_uint32_t idx = 0u; idx < 6u; idx++)
+    {
+        pnanovdb_vec4_t& plane = planes[idx];
+        float len = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        // infinite far planes have no normal and accept everything
+        float inv_len = len > 0.f ? 1.f / len : 0.f;
+        plane = { plane.x * inv_len, plane.y * inv_len, plane.z * inv_len, len > 0.f ? plane.w * inv_len : 1.f };
+    }
+}
+
+// World space view direction and the view space depths of the near and far planes, either may be reverse z
+static inline void extract_camera_info(pnanovdb_camera_mat_t view,
+                                       pnanovdb_camera_mat_t proj,
+                                       pnanovdb_vec3_t* view_dir_out,
+                                       float* near_plane_out,
+                                       float* far_plane_out)
+{
+    pnanovdb_camera_mat_t view_inv = pnanovdb_camera_mat_inverse(view);
+    pnanovdb_camera_mat_t proj_inv = pnanovdb_camera_mat_inverse(proj);
+
+    pnanovdb_vec4_t pos_d0 = pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ 0.f, 0.f, 0.f, 1.f }, proj_inv);
+    pnanovdb_vec4_t pos_d1 = pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ 0.f, 0.f, 1.f, 1.f }, proj_inv);
+
+    float z_d0 = pos_d0.z * (1.f / pos_d0.w);
+    float z_d1 = pos_d1.z * (1.f / pos_d1.w);
+    bool is_reverse_z = fabsf(z_d0) > fabsf(z_d1);
+    pnanovdb_vec4_t ray_dir_near = is_reverse_z ? pos_d1 : pos_d0;
+
+    pnanovdb_vec4_t ray_dir_far =
+        pnanovdb_vec4_add(ray_dir_near, pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ 0.f, 0.f, 1.f, 0.f }, proj_inv));
+    pnanovdb_vec3_t rayDir = { (ray_dir_far.x / ray_dir_far.w) - (ray_dir_near.x / ray_dir_near.w),
+                               (ray_dir_far.y / ray_dir_far.w) - (ray_dir_near.y / ray_dir_near.w),
+                               (ray_dir_far.z / ray_dir_far.w) - (ray_dir_near.z / ray_dir_near.w) };
+    rayDir = pnanovdb_camera_vec3_normalize(rayDir);
+    if (is_reverse_z)
+    {
+        rayDir.x = -rayDir.x;
+        rayDir.y = -rayDir.y;
+        rayDir.z = -rayDir.z;
+    }
+
+    pnanovdb_vec4_t rayDir4 =
+        pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ rayDir.x, rayDir.y, rayDir.z, 0.f }, view_inv);
+    rayDir.x = rayDir4.x;
+    rayDir.y = rayDir4.y;
+    rayDir.z = rayDir4.z;
+
+    *view_dir_out = rayDir;
+    *near_plane_out = is_reverse_z ? z_d1 : z_d0;
+    *far_plane_out = is_reverse_z ? z_d0 : z_d1;
+}
+
+// Host mirror of the test in gaussian_cull_chunks.slang, depth_row is the w column of view * projection
+static inline bool gaussian_chunk_visible(const gaussian_chunk_bounds_t& chunk,
+                                          const pnanovdb_vec4_t planes[6],
+                                          const pnanovdb_vec4_t& depth_row,
+                                          float fx,
+                                          float min_radius_2d)
+{
+    for (pnanovdb_uint32_t idx = 0u; idx < 6u; idx++)
+    {
+        const pnanovdb_vec4_t& plane = planes[idx];
+        if (plane.x * chunk.x + plane.y * chunk.y + plane.z * chunk.z + plane.w < -chunk.radius)
+        {
+            return false;
+        }
+    }
+    if (min_radius_2d > 0.f)
+    {
+        float depth = depth_row.x * chunk.x + depth_row.y * chunk.y + depth_row.z * chunk.z + depth_row.w;
+        // the camera inside the chunk sees it at any size
+        if (fabsf(depth) > chunk.radius && chunk.radius * fx < min_radius_2d * fabsf(depth))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace pnanovdb_raster
@@ -0,0 +1,67 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/MultiView.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Batches of views of raster_gaussian_2d_views, host mirror of the atlas layout in raster2d_common.slang.
+
+    A batch culls, projects and sorts all of its views in one pass over the gaussian data. Each gaussian has one
+    instance per view, the per instance buffers bound the views of a batch to k_multi_view_max_bytes. View v of
+    the call goes to column v % atlas_columns and row v / atlas_columns of the atlas, rows from the top.
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Raster.h"
+
+namespace pnanovdb_raster
+{
+// radii, means2d, depths, conics, compensations, colors, tile counts, tile scan and visible index of an instance
+static constexpr pnanovdb_uint64_t k_multi_view_instance_bytes = 4u + 8u + 4u + 12u + 4u + 12u + 4u + 4u + 4u;
+static constexpr pnanovdb_uint64_t k_multi_view_max_bytes = 512u * 1024u * 1024u;
+// instance indices and the chunk instances of the SH refresh list stay below 2^31
+static constexpr pnanovdb_uint64_t k_multi_view_max_instances = 1llu << 31u;
+
+// Views rasterized together, at least one so a single large view still renders
+static inline pnanovdb_uint32_t multi_view_batch_size(pnanovdb_uint64_t prim_count, pnanovdb_uint32_t view_count)
+{
+    if (prim_count == 0u)
+    {
+        return view_count;
+    }
+    pnanovdb_uint64_t batch_size = k_multi_view_max_bytes / (k_multi_view_instance_bytes * prim_count);
+    pnanovdb_uint64_t max_batch_size = k_multi_view_max_instances / prim_count;
+    if (batch_size > max_batch_size)
+    {
+        batch_size = max_batch_size;
+    }
+    if (batch_size > view_count)
+    {
+        batch_size = view_count;
+    }
+    return batch_size > 0u ? (pnanovdb_uint32_t)batch_size : 1u;
+}
+
+// Rows of the atlas, the texture spans atlas_columns * image_width by rows * image_height texels
+static inline pnanovdb_uint32_t multi_view_atlas_rows(pnanovdb_uint32_t view_count, pnanovdb_uint32_t atlas_columns)
+{
+    return (view_count + atlas_columns - 1u) / atlas_columns;
+}
+
+// matches view_atlas_pixel of raster2d_common.slang, pixel row i counts from the bottom of the view
+static inline void multi_view_atlas_pixel(pnanovdb_uint32_t view_idx,
+                                          pnanovdb_uint32_t atlas_columns,
+                                          pnanovdb_uint32_t image_width,
+                                          pnanovdb_uint32_t image_height,
+                                          pnanovdb_uint32_t i,
+                                          pnanovdb_uint32_t j,
+                                          pnanovdb_uint32_t* x_out,
+                                          pnanovdb_uint32_t* y_out)
+{
+    *x_out = (view_idx % atlas_columns) * image_width + j;
+    *y_out = (view_idx / atlas_columns) * image_height + image_height - 1u - i;
+}
+} // namespace pnanovdb_raster
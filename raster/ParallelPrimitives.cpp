@@ -11,6 +11,7 @@
 
 #define PNANOVDB_BUF_BOUNDS_CHECK
 #include "Common.h"
+#include "CpuParallelPrimitives.h"
 #include "nanovdb_editor/putil/ParallelPrimitives.h"
 #include "nanovdb_editor/putil/ThreadPool.hpp"
 
@@ -63,6 +64,7 @@ enum shader
     scan3_slang,
 
     radix_sort_dual1_slang,
+    radix_sort_dual1_uint64_slang,
     radix_sort_dual2_slang,
     radix_sort_dual3_slang,
     radix_sort_dual4_slang,
@@ -72,6 +74,23 @@ enum shader
     radix_sort1_uint64_slang,
     radix_sort2_uint64_slang,
     radix_sort3_uint64_slang,
+    radix_sort_onesweep_init_slang,
+    radix_sort_onesweep_histogram_slang,
+    radix_sort_onesweep_histogram_uint64_slang,
+    radix_sort_onesweep_scan_slang,
+    radix_sort_onesweep_slang,
+    radix_sort_onesweep_uint64_slang,
+    radix_sort_onesweep_copy_slang,
+    radix_sort_onesweep_copy_uint64_slang,
+    run_length_encode1_slang,
+    run_length_encode1_uint64_slang,
+    run_length_encode3_slang,
+    run_length_encode3_uint64_slang,
+    segmented_scan1_slang,
+    segmented_scan2_slang,
+    segmented_scan3_slang,
+    select1_slang,
+    select3_slang,
 
     shader_count
 };
@@ -81,15 +100,27 @@ static const char* s_shader_names[shader_count] = {
     "raster/scan2_max.slang",         "raster/scan2_uint64.slang",       "raster/scan2.slang",
     "raster/scan3_max.slang",         "raster/scan3_uint64.slang",       "raster/scan3.slang",
 
-    "raster/radix_sort_dual1.slang",  "raster/radix_sort_dual2.slang",   "raster/radix_sort_dual3.slang",
-    "raster/radix_sort_dual4.slang",  "raster/radix_sort1.slang",        "raster/radix_sort2.slang",
-    "raster/radix_sort3.slang",       "raster/radix_sort1_uint64.slang", "raster/radix_sort2_uint64.slang",
-    "raster/radix_sort3_uint64.slang"
+    "raster/radix_sort_dual1.slang",  "raster/radix_sort_dual1_uint64.slang", "raster/radix_sort_dual2.slang",
+    "raster/radix_sort_dual3.slang",  "raster/radix_sort_dual4.slang",        "raster/radix_sort1.slang",
+    "raster/radix_sort2.slang",       "raster/radix_sort3.slang",             "raster/radix_sort1_uint64.slang",
+    "raster/radix_sort2_uint64.slang", "raster/radix_sort3_uint64.slang",
+
+    "raster/radix_sort_onesweep_init.slang",              "raster/radix_sort_onesweep_histogram.slang",
+    "raster/radix_sort_onesweep_histogram_uint64.slang",  "raster/radix_sort_onesweep_scan.slang",
+    "raster/radix_sort_onesweep.slang",                   "raster/radix_sort_onesweep_uint64.slang",
+    "raster/radix_sort_onesweep_copy.slang",              "raster/radix_sort_onesweep_copy_uint64.slang",
+
+    "raster/run_length_encode1.slang",    "raster/run_length_encode1_uint64.slang",
+    "raster/run_length_encode3.slang",    "raster/run_length_encode3_uint64.slang",
+    "raster/segmented_scan1.slang",       "raster/segmented_scan2.slang",
+    "raster/segmented_scan3.slang",       "raster/select1.slang",
+    "raster/select3.slang"
 };
 
 struct parallel_primitives_context_t
 {
     pnanovdb_shader_context_t* shader_ctx[shader_count];
+    pnanovdb_uint32_t radix_sort_mode;
 };
 
 PNANOVDB_CAST_PAIR(pnanovdb_parallel_primitives_context_t, parallel_primitives_context_t)
@@ -103,6 +134,12 @@ static pnanovdb_parallel_primitives_context_t* create_context(const pnanovdb_com
 {
     parallel_primitives_context_t* ctx = new parallel_primitives_context_t();
 
+    // without a queue only the array entry points run, on the host
+    if (!queue)
+    {
+        return cast(ctx);
+    }
+
     pnanovdb_compiler_settings_t compile_settings = {};
     pnanovdb_compiler_settings_init(&compile_settings);
 
@@ -142,7 +179,10 @@ static void destroy_context(const pnanovdb_compute_t* compute,
 
     for (pnanovdb_uint32_t idx = 0u; idx < shader_count; idx++)
     {
-        compute->destroy_shader_context(compute, queue, ctx->shader_ctx[idx]);
+        if (ctx->shader_ctx[idx])
+        {
+            compute->destroy_shader_context(compute, queue, ctx->shader_ctx[idx]);
+        }
     }
 
     delete ctx;
@@ -309,49 +349,14 @@ static void global_scan_max(const pnanovdb_compute_t* compute,
         compute, queue, context_in, val_in, val_out, val_count, PNANOVDB_FALSE, PNANOVDB_TRUE, dispatch_count);
 }
 
-static int global_scan_array(const pnanovdb_compute_t* compute,
-                             pnanovdb_compute_queue_t* queue,
-                             pnanovdb_parallel_primitives_context_t* context_in,
-                             pnanovdb_compute_array_t* val_in,
-                             pnanovdb_compute_array_t* val_out,
-                             pnanovdb_uint64_t val_count,
-                             pnanovdb_uint32_t dispatch_count)
-{
-    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
-    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
-
-    compute_gpu_array_t* val_in_gpu_array = gpu_array_create();
-    compute_gpu_array_t* val_out_gpu_array = gpu_array_create();
-
-    gpu_array_upload(compute, queue, val_in_gpu_array, val_in);
-    gpu_array_alloc_device(compute, queue, val_out_gpu_array, val_out);
-
-    global_scan(compute, queue, context_in, val_in_gpu_array->device_buffer, val_out_gpu_array->device_buffer,
-                val_count, dispatch_count);
-
-    gpu_array_readback(compute, queue, val_out_gpu_array, val_out);
-
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-
-    compute->device_interface.wait_idle(queue);
-
-    gpu_array_map(compute, queue, val_out_gpu_array, val_out);
-
-    gpu_array_destroy(compute, queue, val_in_gpu_array);
-    gpu_array_destroy(compute, queue, val_out_gpu_array);
-
-    return 0;
-}
-
-static void radix_sort(const pnanovdb_compute_t* compute,
-                       pnanovdb_compute_queue_t* queue,
-                       pnanovdb_parallel_primitives_context_t* context_in,
-                       pnanovdb_compute_buffer_t* key_inout,
-                       pnanovdb_compute_buffer_t* val_inout,
-                       pnanovdb_uint64_t key_count,
-                       pnanovdb_uint64_t buffer_key_count,
-                       pnanovdb_uint32_t key_bit_count)
+static void radix_sort_multi_pass(const pnanovdb_compute_t* compute,
+                                  pnanovdb_compute_queue_t* queue,
+                                  pnanovdb_parallel_primitives_context_t* context_in,
+                                  pnanovdb_compute_buffer_t* key_inout,
+                                  pnanovdb_compute_buffer_t* val_inout,
+                                  pnanovdb_uint64_t key_count,
+                                  pnanovdb_uint64_t buffer_key_count,
+                                  pnanovdb_uint32_t key_bit_count)
 {
     auto ctx = cast(context_in);
 
@@ -524,6 +529,248 @@ static void radix_sort(const pnanovdb_compute_t* compute,
     compute_interface->destroy_buffer(context, val_tmp_buffer);
 }
 
+static void radix_sort_onesweep(const pnanovdb_compute_t* compute,
+                                pnanovdb_compute_queue_t* queue,
+                                pnanovdb_parallel_primitives_context_t* context_in,
+                                pnanovdb_compute_buffer_t* key_inout,
+                                pnanovdb_compute_buffer_t* val_inout,
+                                pnanovdb_uint64_t key_count,
+                                pnanovdb_uint64_t buffer_key_count,
+                                pnanovdb_uint32_t key_bit_count,
+                                pnanovdb_bool_t key64)
+{
+    auto ctx = cast(context_in);
+
+    if (key_count == 0u)
+    {
+        return;
+    }
+
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+    pnanovdb_uint32_t histogram_shader = key64 ? radix_sort_onesweep_histogram_uint64_slang :
+                                                 radix_sort_onesweep_histogram_slang;
+    pnanovdb_uint32_t onesweep_shader = key64 ? radix_sort_onesweep_uint64_slang : radix_sort_onesweep_slang;
+    pnanovdb_uint32_t copy_shader = key64 ? radix_sort_onesweep_copy_uint64_slang : radix_sort_onesweep_copy_slang;
+    pnanovdb_uint32_t key_size = key64 ? 8u : 4u;
+
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+
+    // 2048 keys per partition, one pass per 8-bit digit
+    pnanovdb_uint32_t partition_count = (pnanovdb_uint32_t)((key_count + 2047u) / 2048u);
+    grid_dim_t grid_dim = compute_dispatch_grid_dim(partition_count);
+
+    pnanovdb_uint32_t pass_count = (key_bit_count + 7u) / 8u;
+    if (pass_count > key_size)
+    {
+        pass_count = key_size;
+    }
+
+    struct constants_t
+    {
+        pnanovdb_uint32_t key_count;
+        pnanovdb_uint32_t partition_count;
+        pnanovdb_uint32_t key_bit_count;
+        pnanovdb_uint32_t grid_dim_x;
+        pnanovdb_uint32_t grid_dim_y;
+        pnanovdb_uint32_t pass_id;
+        pnanovdb_uint32_t pass_count;
+        pnanovdb_uint32_t status_count;
+    };
+    constants_t constants = {};
+    constants.key_count = (pnanovdb_uint32_t)key_count;
+    constants.partition_count = partition_count;
+    constants.key_bit_count = key_bit_count;
+    constants.grid_dim_x = grid_dim.x;
+    constants.grid_dim_y = grid_dim.y;
+    constants.pass_id = 0u;
+    constants.pass_count = pass_count;
+    constants.status_count = 256u * partition_count;
+
+    // tmp buffers
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = key_size;
+    buf_desc.size_in_bytes = 65536u;
+    while (buf_desc.size_in_bytes < buffer_key_count * key_size)
+    {
+        buf_desc.size_in_bytes *= 2u;
+    }
+    pnanovdb_compute_buffer_t* key_tmp_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    buf_desc.structure_stride = 4u;
+    buf_desc.size_in_bytes = 65536u;
+    while (buf_desc.size_in_bytes < buffer_key_count * 4u)
+    {
+        buf_desc.size_in_bytes *= 2u;
+    }
+    pnanovdb_compute_buffer_t* val_tmp_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    // lookback status, one word per partition and bin
+    buf_desc.size_in_bytes = 65536u;
+    while (buf_desc.size_in_bytes < ((buffer_key_count + 2047u) / 2048u) * 256u * 4u)
+    {
+        buf_desc.size_in_bytes *= 2u;
+    }
+    pnanovdb_compute_buffer_t* status_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    // digit counts of every pass, then their global bin offsets
+    buf_desc.size_in_bytes = 8u * 256u * 4u;
+    pnanovdb_compute_buffer_t* histogram_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    // varying key bits, indirect args per pass, partition tickets and pass ordinals
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
+                     PNANOVDB_COMPUTE_BUFFER_USAGE_INDIRECT;
+    buf_desc.size_in_bytes = 64u * 4u;
+    pnanovdb_compute_buffer_t* info_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    pnanovdb_compute_buffer_transient_t* key_transient =
+        compute_interface->register_buffer_as_transient(context, key_inout);
+    pnanovdb_compute_buffer_transient_t* val_transient =
+        compute_interface->register_buffer_as_transient(context, val_inout);
+    pnanovdb_compute_buffer_transient_t* key_tmp_transient =
+        compute_interface->register_buffer_as_transient(context, key_tmp_buffer);
+    pnanovdb_compute_buffer_transient_t* val_tmp_transient =
+        compute_interface->register_buffer_as_transient(context, val_tmp_buffer);
+    pnanovdb_compute_buffer_transient_t* status_transient =
+        compute_interface->register_buffer_as_transient(context, status_buffer);
+    pnanovdb_compute_buffer_transient_t* histogram_transient =
+        compute_interface->register_buffer_as_transient(context, histogram_buffer);
+    pnanovdb_compute_buffer_transient_t* info_transient =
+        compute_interface->register_buffer_as_transient(context, info_buffer);
+
+    // one constant buffer per pass, the last one for the setup and copy dispatches
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 0u;
+    buf_desc.size_in_bytes = sizeof(constants_t);
+    pnanovdb_compute_buffer_t* constant_buffers[9u] = {};
+    pnanovdb_compute_buffer_transient_t* constant_transients[9u] = {};
+    for (pnanovdb_uint32_t pass_id = 0u; pass_id <= pass_count; pass_id++)
+    {
+        constant_buffers[pass_id] =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+        constants.pass_id = pass_id < pass_count ? pass_id : 0u;
+        void* mapped_constants = compute_interface->map_buffer(context, constant_buffers[pass_id]);
+        memcpy(mapped_constants, &constants, sizeof(constants_t));
+        compute_interface->unmap_buffer(context, constant_buffers[pass_id]);
+
+        constant_transients[pass_id] =
+            compute_interface->register_buffer_as_transient(context, constant_buffers[pass_id]);
+    }
+    pnanovdb_compute_buffer_transient_t* constant_transient = constant_transients[pass_count];
+
+    // clear status, histograms and info
+    {
+        pnanovdb_compute_resource_t resources[4u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = status_transient;
+        resources[2u].buffer_transient = histogram_transient;
+        resources[3u].buffer_transient = info_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[radix_sort_onesweep_init_slang], resources,
+                                 grid_dim.x, grid_dim.y, grid_dim.z, "radix_sort_onesweep_init");
+    }
+    // digit histograms of all passes and the varying key bits
+    {
+        pnanovdb_compute_resource_t resources[4u] = {};
+        resources[0u].buffer_transient = key_transient;
+        resources[1u].buffer_transient = constant_transient;
+        resources[2u].buffer_transient = histogram_transient;
+        resources[3u].buffer_transient = info_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[histogram_shader], resources, grid_dim.x,
+                                 grid_dim.y, grid_dim.z, "radix_sort_onesweep_histogram");
+    }
+    // global bin offsets and the indirect args of the passes that remain
+    {
+        pnanovdb_compute_resource_t resources[3u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = histogram_transient;
+        resources[2u].buffer_transient = info_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[radix_sort_onesweep_scan_slang], resources,
+                                 1u, 1u, 1u, "radix_sort_onesweep_scan");
+    }
+    for (pnanovdb_uint32_t pass_id = 0u; pass_id < pass_count; pass_id++)
+    {
+        pnanovdb_compute_resource_t resources[8u] = {};
+        resources[0u].buffer_transient = constant_transients[pass_id];
+        resources[1u].buffer_transient = histogram_transient;
+        resources[2u].buffer_transient = info_transient;
+        resources[3u].buffer_transient = status_transient;
+        resources[4u].buffer_transient = key_transient;
+        resources[5u].buffer_transient = val_transient;
+        resources[6u].buffer_transient = key_tmp_transient;
+        resources[7u].buffer_transient = val_tmp_transient;
+
+        compute->dispatch_shader_indirect(compute_interface, context, ctx->shader_ctx[onesweep_shader], resources,
+                                          info_transient, (4u + 4u * pass_id) * 4u, "radix_sort_onesweep");
+    }
+    // an odd active pass count leaves the result in the tmp buffers
+    {
+        pnanovdb_compute_resource_t resources[5u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = key_tmp_transient;
+        resources[2u].buffer_transient = val_tmp_transient;
+        resources[3u].buffer_transient = key_transient;
+        resources[4u].buffer_transient = val_transient;
+
+        compute->dispatch_shader_indirect(compute_interface, context, ctx->shader_ctx[copy_shader], resources,
+                                          info_transient, 36u * 4u, "radix_sort_onesweep_copy");
+    }
+
+    for (pnanovdb_uint32_t pass_id = 0u; pass_id <= pass_count; pass_id++)
+    {
+        compute_interface->destroy_buffer(context, constant_buffers[pass_id]);
+    }
+    compute_interface->destroy_buffer(context, key_tmp_buffer);
+    compute_interface->destroy_buffer(context, val_tmp_buffer);
+    compute_interface->destroy_buffer(context, status_buffer);
+    compute_interface->destroy_buffer(context, histogram_buffer);
+    compute_interface->destroy_buffer(context, info_buffer);
+}
+
+// onesweep status words hold 30-bit counts, larger sorts fall back to the multi pass sort
+static pnanovdb_bool_t radix_sort_use_onesweep(pnanovdb_parallel_primitives_context_t* context_in,
+                                               pnanovdb_uint64_t key_count)
+{
+    auto ctx = cast(context_in);
+
+    if (ctx->radix_sort_mode == PNANOVDB_PARALLEL_PRIMITIVES_RADIX_SORT_MODE_MULTI_PASS)
+    {
+        return PNANOVDB_FALSE;
+    }
+    return key_count < (1llu << 30u) ? PNANOVDB_TRUE : PNANOVDB_FALSE;
+}
+
+static void radix_sort(const pnanovdb_compute_t* compute,
+                       pnanovdb_compute_queue_t* queue,
+                       pnanovdb_parallel_primitives_context_t* context_in,
+                       pnanovdb_compute_buffer_t* key_inout,
+                       pnanovdb_compute_buffer_t* val_inout,
+                       pnanovdb_uint64_t key_count,
+                       pnanovdb_uint64_t buffer_key_count,
+                       pnanovdb_uint32_t key_bit_count)
+{
+    if (radix_sort_use_onesweep(context_in, key_count))
+    {
+        radix_sort_onesweep(compute, queue, context_in, key_inout, val_inout, key_count, buffer_key_count,
+                            key_bit_count, PNANOVDB_FALSE);
+    }
+    else
+    {
+        radix_sort_multi_pass(
+            compute, queue, context_in, key_inout, val_inout, key_count, buffer_key_count, key_bit_count);
+    }
+}
+
 static void radix_sort_dual_key(const pnanovdb_compute_t* compute,
                                 pnanovdb_compute_queue_t* queue,
                                 pnanovdb_parallel_primitives_context_t* context_in,
@@ -545,6 +792,10 @@ static void radix_sort_dual_key(const pnanovdb_compute_t* compute,
     pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
     pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
 
+    // with onesweep both keys fit one 64-bit key, one sort replaces the low sort, the high gather and the high sort
+    pnanovdb_bool_t packed = radix_sort_use_onesweep(context_in, key_count) &&
+                             key_low_bit_count <= 32u && key_low_bit_count + key_high_bit_count <= 64u;
+
     pnanovdb_compute_buffer_desc_t buf_desc = {};
 
     grid_dim_t grid_dim = compute_dispatch_grid_dim((key_count + 1023u) / 1024u);
@@ -554,11 +805,13 @@ static void radix_sort_dual_key(const pnanovdb_compute_t* compute,
         pnanovdb_uint32_t workgroup_count;
         pnanovdb_uint32_t key_count;
         pnanovdb_uint32_t grid_dim_x;
+        pnanovdb_uint32_t key_low_bit_count;
     };
     constants_t constants = {};
     constants.workgroup_count = (key_count + 1023u) / 1024u;
     constants.key_count = key_count;
     constants.grid_dim_x = grid_dim.x;
+    constants.key_low_bit_count = key_low_bit_count;
 
     // constants
     buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
@@ -583,8 +836,14 @@ static void radix_sort_dual_key(const pnanovdb_compute_t* compute,
     {
         buf_desc.size_in_bytes *= 2u;
     }
+    pnanovdb_compute_buffer_desc_t key_tmp_desc = buf_desc;
+    if (packed)
+    {
+        key_tmp_desc.structure_stride = 8u;
+        key_tmp_desc.size_in_bytes *= 2u;
+    }
     pnanovdb_compute_buffer_t* key_tmp_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &key_tmp_desc);
     pnanovdb_compute_buffer_t* val_tmp_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
     pnanovdb_compute_buffer_t* key_low_copy_buffer =
@@ -612,35 +871,53 @@ static void radix_sort_dual_key(const pnanovdb_compute_t* compute,
     pnanovdb_compute_buffer_transient_t* val_transient =
         compute_interface->register_buffer_as_transient(context, val_inout);
 
-    // generate key and val for first sort pass
+    if (packed)
     {
-        pnanovdb_compute_resource_t resources[4u] = {};
+        pnanovdb_compute_resource_t resources[5u] = {};
         resources[0u].buffer_transient = key_low_transient;
-        resources[1u].buffer_transient = constant_transient;
-        resources[2u].buffer_transient = key_tmp_transient;
-        resources[3u].buffer_transient = val_tmp_transient;
+        resources[1u].buffer_transient = key_high_transient;
+        resources[2u].buffer_transient = constant_transient;
+        resources[3u].buffer_transient = key_tmp_transient;
+        resources[4u].buffer_transient = val_tmp_transient;
 
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[radix_sort_dual1_slang], resources,
-                                 grid_dim.x, grid_dim.y, grid_dim.z, "radix_sort_dual1");
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[radix_sort_dual1_uint64_slang],
+                                 resources, grid_dim.x, grid_dim.y, grid_dim.z, "radix_sort_dual1_uint64");
+
+        radix_sort_onesweep(compute, queue, context_in, key_tmp_buffer, val_tmp_buffer, key_count, buffer_key_count,
+                            key_low_bit_count + key_high_bit_count, PNANOVDB_TRUE);
     }
+    else
+    {
+        // generate key and val for first sort pass
+        {
+            pnanovdb_compute_resource_t resources[4u] = {};
+            resources[0u].buffer_transient = key_low_transient;
+            resources[1u].buffer_transient = constant_transient;
+            resources[2u].buffer_transient = key_tmp_transient;
+            resources[3u].buffer_transient = val_tmp_transient;
 
-    radix_sort(
-        compute, queue, context_in, key_tmp_buffer, val_tmp_buffer, key_count, buffer_key_count, key_low_bit_count);
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[radix_sort_dual1_slang], resources,
+                                     grid_dim.x, grid_dim.y, grid_dim.z, "radix_sort_dual1");
+        }
 
-    // gather key high to current sorted indices
-    {
-        pnanovdb_compute_resource_t resources[4u] = {};
-        resources[0u].buffer_transient = key_high_transient;
-        resources[1u].buffer_transient = val_tmp_transient;
-        resources[2u].buffer_transient = constant_transient;
-        resources[3u].buffer_transient = key_tmp_transient;
+        radix_sort(compute, queue, context_in, key_tmp_buffer, val_tmp_buffer, key_count, buffer_key_count,
+                   key_low_bit_count);
 
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[radix_sort_dual2_slang], resources,
-                                 grid_dim.x, grid_dim.y, grid_dim.z, "radix_sort_dual2");
-    }
+        // gather key high to current sorted indices
+        {
+            pnanovdb_compute_resource_t resources[4u] = {};
+            resources[0u].buffer_transient = key_high_transient;
+            resources[1u].buffer_transient = val_tmp_transient;
+            resources[2u].buffer_transient = constant_transient;
+            resources[3u].buffer_transient = key_tmp_transient;
+
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[radix_sort_dual2_slang], resources,
+                                     grid_dim.x, grid_dim.y, grid_dim.z, "radix_sort_dual2");
+        }
 
-    radix_sort(
-        compute, queue, context_in, key_tmp_buffer, val_tmp_buffer, key_count, buffer_key_count, key_high_bit_count);
+        radix_sort(compute, queue, context_in, key_tmp_buffer, val_tmp_buffer, key_count, buffer_key_count,
+                   key_high_bit_count);
+    }
 
     // gather values
     {
@@ -682,14 +959,14 @@ static void radix_sort_dual_key(const pnanovdb_compute_t* compute,
     compute_interface->destroy_buffer(context, constant_buffer);
 }
 
-void radix_sort_key64(const pnanovdb_compute_t* compute,
-                      pnanovdb_compute_queue_t* queue,
-                      pnanovdb_parallel_primitives_context_t* context_in,
-                      pnanovdb_compute_buffer_t* key_inout,
-                      pnanovdb_compute_buffer_t* val_inout,
-                      pnanovdb_uint64_t key_count,
-                      pnanovdb_uint64_t buffer_key_count,
-                      pnanovdb_uint32_t key_bit_count)
+static void radix_sort_key64_multi_pass(const pnanovdb_compute_t* compute,
+                                        pnanovdb_compute_queue_t* queue,
+                                        pnanovdb_parallel_primitives_context_t* context_in,
+                                        pnanovdb_compute_buffer_t* key_inout,
+                                        pnanovdb_compute_buffer_t* val_inout,
+                                        pnanovdb_uint64_t key_count,
+                                        pnanovdb_uint64_t buffer_key_count,
+                                        pnanovdb_uint32_t key_bit_count)
 {
     auto ctx = cast(context_in);
 
@@ -868,43 +1145,810 @@ void radix_sort_key64(const pnanovdb_compute_t* compute,
     compute_interface->destroy_buffer(context, val_tmp_buffer);
 }
 
-static int radix_sort_array(const pnanovdb_compute_t* compute,
-                            pnanovdb_compute_queue_t* queue,
-                            pnanovdb_parallel_primitives_context_t* context_in,
-                            pnanovdb_compute_array_t* key_inout,
-                            pnanovdb_compute_array_t* val_inout,
-                            pnanovdb_uint64_t key_count,
-                            pnanovdb_uint32_t key_bit_count)
+static void radix_sort_key64(const pnanovdb_compute_t* compute,
+                             pnanovdb_compute_queue_t* queue,
+                             pnanovdb_parallel_primitives_context_t* context_in,
+                             pnanovdb_compute_buffer_t* key_inout,
+                             pnanovdb_compute_buffer_t* val_inout,
+                             pnanovdb_uint64_t key_count,
+                             pnanovdb_uint64_t buffer_key_count,
+                             pnanovdb_uint32_t key_bit_count)
+{
+    if (radix_sort_use_onesweep(context_in, key_count))
+    {
+        radix_sort_onesweep(compute, queue, context_in, key_inout, val_inout, key_count, buffer_key_count,
+                            key_bit_count, PNANOVDB_TRUE);
+    }
+    else
+    {
+        radix_sort_key64_multi_pass(
+            compute, queue, context_in, key_inout, val_inout, key_count, buffer_key_count, key_bit_count);
+    }
+}
+
+static void set_radix_sort_mode(pnanovdb_parallel_primitives_context_t* context_in, pnanovdb_uint32_t radix_sort_mode)
+{
+    auto ctx = cast(context_in);
+
+    ctx->radix_sort_mode = radix_sort_mode;
+}
+
+static void segmented_scan(const pnanovdb_compute_t* compute,
+                           pnanovdb_compute_queue_t* queue,
+                           pnanovdb_parallel_primitives_context_t* context_in,
+                           pnanovdb_compute_buffer_t* val_in,
+                           pnanovdb_compute_buffer_t* flag_in,
+                           pnanovdb_compute_buffer_t* val_out,
+                           pnanovdb_uint64_t val_count)
 {
     auto ctx = cast(context_in);
 
+    if (val_count == 0u)
+    {
+        return;
+    }
+
     pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
     pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
 
-    compute_gpu_array_t* key_gpu_array = gpu_array_create();
-    compute_gpu_array_t* val_gpu_array = gpu_array_create();
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
 
-    gpu_array_upload(compute, queue, key_gpu_array, key_inout);
-    gpu_array_upload(compute, queue, val_gpu_array, val_inout);
+    struct constants_t
+    {
+        pnanovdb_uint32_t val_count;
+        pnanovdb_uint32_t pad0;
+        pnanovdb_uint32_t pad1;
+        pnanovdb_uint32_t pad2;
+    };
+    constants_t constants = {};
+    constants.val_count = val_count;
 
-    radix_sort_key64(compute, queue, context_in, key_gpu_array->device_buffer, val_gpu_array->device_buffer, key_count,
-                     key_count, key_bit_count);
+    pnanovdb_uint32_t workgroup_count = (val_count + 1023u) / 1024u;
 
-    gpu_array_readback(compute, queue, key_gpu_array, key_inout);
-    gpu_array_readback(compute, queue, val_gpu_array, val_inout);
+    // constants
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 0u;
+    buf_desc.size_in_bytes = sizeof(constants_t);
+    pnanovdb_compute_buffer_t* constant_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+    // copy constants
+    void* mapped_constants = compute_interface->map_buffer(context, constant_buffer);
+    memcpy(mapped_constants, &constants, sizeof(constants_t));
+    compute_interface->unmap_buffer(context, constant_buffer);
 
-    compute->device_interface.wait_idle(queue);
+    // (sum, flag) per workgroup and the sums carried into each workgroup
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 8u;
+    buf_desc.size_in_bytes = workgroup_count * 8u;
+    pnanovdb_compute_buffer_t* reduce_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    buf_desc.structure_stride = 4u;
+    buf_desc.size_in_bytes = workgroup_count * 4u;
+    pnanovdb_compute_buffer_t* reduce_scan_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    pnanovdb_compute_buffer_transient_t* constant_transient =
+        compute_interface->register_buffer_as_transient(context, constant_buffer);
+    pnanovdb_compute_buffer_transient_t* val_in_transient =
+        compute_interface->register_buffer_as_transient(context, val_in);
+    pnanovdb_compute_buffer_transient_t* flag_in_transient =
+        compute_interface->register_buffer_as_transient(context, flag_in);
+    pnanovdb_compute_buffer_transient_t* val_out_transient =
+        compute_interface->register_buffer_as_transient(context, val_out);
+    pnanovdb_compute_buffer_transient_t* reduce_transient =
+        compute_interface->register_buffer_as_transient(context, reduce_buffer);
+    pnanovdb_compute_buffer_transient_t* reduce_scan_transient =
+        compute_interface->register_buffer_as_transient(context, reduce_scan_buffer);
 
-    gpu_array_map(compute, queue, key_gpu_array, key_inout);
-    gpu_array_map(compute, queue, val_gpu_array, val_inout);
+    // segmented scan 1
+    {
+        pnanovdb_compute_resource_t resources[4u] = {};
+        resources[0u].buffer_transient = val_in_transient;
+        resources[1u].buffer_transient = flag_in_transient;
+        resources[2u].buffer_transient = constant_transient;
+        resources[3u].buffer_transient = reduce_transient;
 
-    gpu_array_destroy(compute, queue, key_gpu_array);
-    gpu_array_destroy(compute, queue, val_gpu_array);
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[segmented_scan1_slang], resources,
+                                 workgroup_count, 1u, 1u, "segmented_scan1");
+    }
+    // segmented scan 2
+    {
+        pnanovdb_compute_resource_t resources[3u] = {};
+        resources[0u].buffer_transient = reduce_transient;
+        resources[1u].buffer_transient = constant_transient;
+        resources[2u].buffer_transient = reduce_scan_transient;
 
-    return 0;
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[segmented_scan2_slang], resources, 1u, 1u,
+                                 1u, "segmented_scan2");
+    }
+    // segmented scan 3
+    {
+        pnanovdb_compute_resource_t resources[5u] = {};
+        resources[0u].buffer_transient = val_in_transient;
+        resources[1u].buffer_transient = flag_in_transient;
+        resources[2u].buffer_transient = constant_transient;
+        resources[3u].buffer_transient = reduce_scan_transient;
+        resources[4u].buffer_transient = val_out_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[segmented_scan3_slang], resources,
+                                 workgroup_count, 1u, 1u, "segmented_scan3");
+    }
+
+    compute_interface->destroy_buffer(context, constant_buffer);
+    compute_interface->destroy_buffer(context, reduce_buffer);
+    compute_interface->destroy_buffer(context, reduce_scan_buffer);
+}
+
+// segment ids from the scanned head flags become the high key of a dual key sort,
+// ids never exceed key_count, so only the bits needed to hold key_count are sorted
+static void segmented_radix_sort(const pnanovdb_compute_t* compute,
+                                 pnanovdb_compute_queue_t* queue,
+                                 pnanovdb_parallel_primitives_context_t* context_in,
+                                 pnanovdb_compute_buffer_t* key_inout,
+                                 pnanovdb_compute_buffer_t* val_inout,
+                                 pnanovdb_compute_buffer_t* flag_in,
+                                 pnanovdb_uint64_t key_count,
+                                 pnanovdb_uint64_t buffer_key_count,
+                                 pnanovdb_uint32_t key_bit_count)
+{
+    if (key_count == 0u)
+    {
+        return;
+    }
+
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 4u;
+    buf_desc.size_in_bytes = 65536u;
+    while (buf_desc.size_in_bytes < buffer_key_count * 4u)
+    {
+        buf_desc.size_in_bytes *= 2u;
+    }
+    pnanovdb_compute_buffer_t* segment_id_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    global_scan(compute, queue, context_in, flag_in, segment_id_buffer, key_count, 1u);
+
+    pnanovdb_uint32_t segment_id_bit_count = 0u;
+    while (segment_id_bit_count < 32u && (key_count >> segment_id_bit_count) != 0u)
+    {
+        segment_id_bit_count++;
+    }
+
+    radix_sort_dual_key(compute, queue, context_in, key_inout, segment_id_buffer, val_inout, key_count,
+                        buffer_key_count, key_bit_count, segment_id_bit_count);
+
+    compute_interface->destroy_buffer(context, segment_id_buffer);
+}
+
+// count, scan2.slang and scatter, a partition also scatters the rejected values
+static void select_generic(const pnanovdb_compute_t* compute,
+                           pnanovdb_compute_queue_t* queue,
+                           pnanovdb_parallel_primitives_context_t* context_in,
+                           pnanovdb_compute_buffer_t* val_in,
+                           pnanovdb_compute_buffer_t* flag_in,
+                           pnanovdb_compute_buffer_t* val_out,
+                           pnanovdb_compute_buffer_t* count_out,
+                           pnanovdb_uint64_t val_count,
+                           pnanovdb_bool_t partition)
+{
+    auto ctx = cast(context_in);
+
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+
+    struct constants_t
+    {
+        pnanovdb_uint32_t val_count;
+        pnanovdb_uint32_t partition;
+        pnanovdb_uint32_t pad1;
+        pnanovdb_uint32_t pad2;
+    };
+    constants_t constants = {};
+    constants.val_count = val_count;
+    constants.partition = partition ? 1u : 0u;
+
+    // one workgroup at least, so an empty input still writes a zero count
+    pnanovdb_uint32_t workgroup_count = val_count == 0u ? 1u : (val_count + 1023u) / 1024u;
+
+    // constants
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 0u;
+    buf_desc.size_in_bytes = sizeof(constants_t);
+    pnanovdb_compute_buffer_t* constant_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+    // copy constants
+    void* mapped_constants = compute_interface->map_buffer(context, constant_buffer);
+    memcpy(mapped_constants, &constants, sizeof(constants_t));
+    compute_interface->unmap_buffer(context, constant_buffer);
+
+    // reduce and reduce_scan buffers, and a count buffer when the caller passes none
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 4u;
+    buf_desc.size_in_bytes = workgroup_count * 4u;
+    pnanovdb_compute_buffer_t* reduce_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* reduce_scan_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* count_buffer = nullptr;
+    if (!count_out)
+    {
+        buf_desc.size_in_bytes = 4u;
+        count_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    }
+
+    pnanovdb_compute_buffer_transient_t* constant_transient =
+        compute_interface->register_buffer_as_transient(context, constant_buffer);
+    pnanovdb_compute_buffer_transient_t* val_in_transient =
+        compute_interface->register_buffer_as_transient(context, val_in);
+    pnanovdb_compute_buffer_transient_t* flag_in_transient =
+        compute_interface->register_buffer_as_transient(context, flag_in);
+    pnanovdb_compute_buffer_transient_t* val_out_transient =
+        compute_interface->register_buffer_as_transient(context, val_out);
+    pnanovdb_compute_buffer_transient_t* count_transient =
+        compute_interface->register_buffer_as_transient(context, count_out ? count_out : count_buffer);
+    pnanovdb_compute_buffer_transient_t* reduce_transient =
+        compute_interface->register_buffer_as_transient(context, reduce_buffer);
+    pnanovdb_compute_buffer_transient_t* reduce_scan_transient =
+        compute_interface->register_buffer_as_transient(context, reduce_scan_buffer);
+
+    // select 1
+    {
+        pnanovdb_compute_resource_t resources[3u] = {};
+        resources[0u].buffer_transient = flag_in_transient;
+        resources[1u].buffer_transient = constant_transient;
+        resources[2u].buffer_transient = reduce_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[select1_slang], resources,
+                                 workgroup_count, 1u, 1u, "select1");
+    }
+    // scan 2
+    {
+        pnanovdb_compute_resource_t resources[3u] = {};
+        resources[0u].buffer_transient = reduce_transient;
+        resources[1u].buffer_transient = constant_transient;
+        resources[2u].buffer_transient = reduce_scan_transient;
+
+        compute->dispatch_shader(
+            compute_interface, context, ctx->shader_ctx[scan2_slang], resources, 1u, 1u, 1u, "select2");
+    }
+    // select 3
+    {
+        pnanovdb_compute_resource_t resources[6u] = {};
+        resources[0u].buffer_transient = val_in_transient;
+        resources[1u].buffer_transient = flag_in_transient;
+        resources[2u].buffer_transient = constant_transient;
+        resources[3u].buffer_transient = reduce_scan_transient;
+        resources[4u].buffer_transient = val_out_transient;
+        resources[5u].buffer_transient = count_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[select3_slang], resources,
+                                 workgroup_count, 1u, 1u, "select3");
+    }
+
+    compute_interface->destroy_buffer(context, constant_buffer);
+    compute_interface->destroy_buffer(context, reduce_buffer);
+    compute_interface->destroy_buffer(context, reduce_scan_buffer);
+    if (count_buffer)
+    {
+        compute_interface->destroy_buffer(context, count_buffer);
+    }
+}
+
+static void select_if(const pnanovdb_compute_t* compute,
+                      pnanovdb_compute_queue_t* queue,
+                      pnanovdb_parallel_primitives_context_t* context_in,
+                      pnanovdb_compute_buffer_t* val_in,
+                      pnanovdb_compute_buffer_t* flag_in,
+                      pnanovdb_compute_buffer_t* val_out,
+                      pnanovdb_compute_buffer_t* count_out,
+                      pnanovdb_uint64_t val_count)
+{
+    select_generic(compute, queue, context_in, val_in, flag_in, val_out, count_out, val_count, PNANOVDB_FALSE);
+}
+
+static void partition(const pnanovdb_compute_t* compute,
+                      pnanovdb_compute_queue_t* queue,
+                      pnanovdb_parallel_primitives_context_t* context_in,
+                      pnanovdb_compute_buffer_t* val_in,
+                      pnanovdb_compute_buffer_t* flag_in,
+                      pnanovdb_compute_buffer_t* val_out,
+                      pnanovdb_compute_buffer_t* count_out,
+                      pnanovdb_uint64_t val_count)
+{
+    select_generic(compute, queue, context_in, val_in, flag_in, val_out, count_out, val_count, PNANOVDB_TRUE);
+}
+
+// run starts are counted, scanned by scan2.slang and both ends of each run scattered by the run index
+static void run_length_encode_generic(const pnanovdb_compute_t* compute,
+                                      pnanovdb_compute_queue_t* queue,
+                                      pnanovdb_parallel_primitives_context_t* context_in,
+                                      pnanovdb_compute_buffer_t* key_in,
+                                      pnanovdb_compute_buffer_t* range_out,
+                                      pnanovdb_compute_buffer_t* count_out,
+                                      pnanovdb_uint64_t key_count,
+                                      pnanovdb_bool_t key64)
+{
+    auto ctx = cast(context_in);
+
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+    pnanovdb_uint32_t encode1_shader = key64 ? run_length_encode1_uint64_slang : run_length_encode1_slang;
+    pnanovdb_uint32_t encode3_shader = key64 ? run_length_encode3_uint64_slang : run_length_encode3_slang;
+
+    pnanovdb_compute_buffer_desc_t buf_desc = {};
+
+    struct constants_t
+    {
+        pnanovdb_uint32_t key_count;
+        pnanovdb_uint32_t pad0;
+        pnanovdb_uint32_t pad1;
+        pnanovdb_uint32_t pad2;
+    };
+    constants_t constants = {};
+    constants.key_count = key_count;
+
+    // one workgroup at least, so an empty input still writes a zero count
+    pnanovdb_uint32_t workgroup_count = key_count == 0u ? 1u : (key_count + 1023u) / 1024u;
+
+    // constants
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 0u;
+    buf_desc.size_in_bytes = sizeof(constants_t);
+    pnanovdb_compute_buffer_t* constant_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+    // copy constants
+    void* mapped_constants = compute_interface->map_buffer(context, constant_buffer);
+    memcpy(mapped_constants, &constants, sizeof(constants_t));
+    compute_interface->unmap_buffer(context, constant_buffer);
+
+    // reduce and reduce_scan buffers, and a count buffer when the caller passes none
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 4u;
+    buf_desc.size_in_bytes = workgroup_count * 4u;
+    pnanovdb_compute_buffer_t* reduce_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* reduce_scan_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* count_buffer = nullptr;
+    if (!count_out)
+    {
+        buf_desc.size_in_bytes = 4u;
+        count_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    }
+
+    pnanovdb_compute_buffer_transient_t* constant_transient =
+        compute_interface->register_buffer_as_transient(context, constant_buffer);
+    pnanovdb_compute_buffer_transient_t* key_in_transient =
+        compute_interface->register_buffer_as_transient(context, key_in);
+    pnanovdb_compute_buffer_transient_t* range_out_transient =
+        compute_interface->register_buffer_as_transient(context, range_out);
+    pnanovdb_compute_buffer_transient_t* count_transient =
+        compute_interface->register_buffer_as_transient(context, count_out ? count_out : count_buffer);
+    pnanovdb_compute_buffer_transient_t* reduce_transient =
+        compute_interface->register_buffer_as_transient(context, reduce_buffer);
+    pnanovdb_compute_buffer_transient_t* reduce_scan_transient =
+        compute_interface->register_buffer_as_transient(context, reduce_scan_buffer);
+
+    // run length encode 1
+    {
+        pnanovdb_compute_resource_t resources[4u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = key_in_transient;
+        resources[2u].buffer_transient = reduce_transient;
+        resources[3u].buffer_transient = range_out_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[encode1_shader], resources,
+                                 workgroup_count, 1u, 1u, "run_length_encode1");
+    }
+    // scan 2
+    {
+        pnanovdb_compute_resource_t resources[3u] = {};
+        resources[0u].buffer_transient = reduce_transient;
+        resources[1u].buffer_transient = constant_transient;
+        resources[2u].buffer_transient = reduce_scan_transient;
+
+        compute->dispatch_shader(
+            compute_interface, context, ctx->shader_ctx[scan2_slang], resources, 1u, 1u, 1u, "run_length_encode2");
+    }
+    // run length encode 3
+    {
+        pnanovdb_compute_resource_t resources[5u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = key_in_transient;
+        resources[2u].buffer_transient = reduce_scan_transient;
+        resources[3u].buffer_transient = range_out_transient;
+        resources[4u].buffer_transient = count_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[encode3_shader], resources,
+                                 workgroup_count, 1u, 1u, "run_length_encode3");
+    }
+
+    compute_interface->destroy_buffer(context, constant_buffer);
+    compute_interface->destroy_buffer(context, reduce_buffer);
+    compute_interface->destroy_buffer(context, reduce_scan_buffer);
+    if (count_buffer)
+    {
+        compute_interface->destroy_buffer(context, count_buffer);
+    }
+}
+
+static void run_length_encode(const pnanovdb_compute_t* compute,
+                              pnanovdb_compute_queue_t* queue,
+                              pnanovdb_parallel_primitives_context_t* context_in,
+                              pnanovdb_compute_buffer_t* key_in,
+                              pnanovdb_compute_buffer_t* range_out,
+                              pnanovdb_compute_buffer_t* count_out,
+                              pnanovdb_uint64_t key_count)
+{
+    run_length_encode_generic(compute, queue, context_in, key_in, range_out, count_out, key_count, PNANOVDB_FALSE);
+}
+
+static void run_length_encode_key64(const pnanovdb_compute_t* compute,
+                                    pnanovdb_compute_queue_t* queue,
+                                    pnanovdb_parallel_primitives_context_t* context_in,
+                                    pnanovdb_compute_buffer_t* key_in,
+                                    pnanovdb_compute_buffer_t* range_out,
+                                    pnanovdb_compute_buffer_t* count_out,
+                                    pnanovdb_uint64_t key_count)
+{
+    run_length_encode_generic(compute, queue, context_in, key_in, range_out, count_out, key_count, PNANOVDB_TRUE);
+}
+
+// shared by the array entry points of all contexts without a queue
+static pnanovdb_util::WorkStealingPool& cpu_primitives_pool()
+{
+    static pnanovdb_util::WorkStealingPool pool;
+    return pool;
+}
+
+// uploads the arrays, runs dispatch on their device buffers and reads back the arrays in readback_mask, null arrays
+// are passed on as null buffers
+template <typename F>
+static void gpu_array_dispatch(const pnanovdb_compute_t* compute,
+                               pnanovdb_compute_queue_t* queue,
+                               pnanovdb_compute_array_t* const* arrays,
+                               pnanovdb_uint32_t array_count,
+                               pnanovdb_uint32_t readback_mask,
+                               F&& dispatch)
+{
+    compute_gpu_array_t* gpu_arrays[4u] = {};
+    pnanovdb_compute_buffer_t* buffers[4u] = {};
+    for (pnanovdb_uint32_t idx = 0u; idx < array_count; idx++)
+    {
+        if (arrays[idx])
+        {
+            gpu_arrays[idx] = gpu_array_create();
+            gpu_array_upload(compute, queue, gpu_arrays[idx], arrays[idx]);
+            buffers[idx] = gpu_arrays[idx]->device_buffer;
+        }
+    }
+
+    dispatch(buffers);
+
+    for (pnanovdb_uint32_t idx = 0u; idx < array_count; idx++)
+    {
+        if (gpu_arrays[idx] && (readback_mask & (1u << idx)) != 0u)
+        {
+            gpu_array_readback(compute, queue, gpu_arrays[idx], arrays[idx]);
+        }
+    }
+
+    pnanovdb_uint64_t flushed_frame = 0llu;
+    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
+
+    compute->device_interface.wait_idle(queue);
+
+    for (pnanovdb_uint32_t idx = 0u; idx < array_count; idx++)
+    {
+        if (gpu_arrays[idx] && (readback_mask & (1u << idx)) != 0u)
+        {
+            gpu_array_map(compute, queue, gpu_arrays[idx], arrays[idx]);
+        }
+        gpu_array_destroy(compute, queue, gpu_arrays[idx]);
+    }
+}
+
+static void cpu_array_write_count(pnanovdb_compute_array_t* count_out, pnanovdb_uint64_t count)
+{
+    if (count_out)
+    {
+        ((pnanovdb_uint32_t*)count_out->data)[0u] = (pnanovdb_uint32_t)count;
+    }
+}
+
+static void global_scan_array(const pnanovdb_compute_t* compute,
+                              pnanovdb_compute_queue_t* queue,
+                              pnanovdb_parallel_primitives_context_t* context_in,
+                              pnanovdb_compute_array_t* val_in,
+                              pnanovdb_compute_array_t* val_out,
+                              pnanovdb_uint64_t val_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_global_scan(cpu_primitives_pool(), (const pnanovdb_uint32_t*)val_in->data,
+                                         (pnanovdb_uint32_t*)val_out->data, val_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[2u] = { val_in, val_out };
+    gpu_array_dispatch(compute, queue, arrays, 2u, 0x2,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       { global_scan(compute, queue, context_in, buffers[0u], buffers[1u], val_count, 1u); });
+}
+
+static void global_scan_uint64_array(const pnanovdb_compute_t* compute,
+                                     pnanovdb_compute_queue_t* queue,
+                                     pnanovdb_parallel_primitives_context_t* context_in,
+                                     pnanovdb_compute_array_t* val_in,
+                                     pnanovdb_compute_array_t* val_out,
+                                     pnanovdb_uint64_t val_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_global_scan_uint64(cpu_primitives_pool(), (const pnanovdb_uint64_t*)val_in->data,
+                                                (pnanovdb_uint64_t*)val_out->data, val_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[2u] = { val_in, val_out };
+    gpu_array_dispatch(compute, queue, arrays, 2u, 0x2,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       { global_scan_uint64(compute, queue, context_in, buffers[0u], buffers[1u], val_count, 1u); });
+}
+
+static void global_scan_max_array(const pnanovdb_compute_t* compute,
+                                  pnanovdb_compute_queue_t* queue,
+                                  pnanovdb_parallel_primitives_context_t* context_in,
+                                  pnanovdb_compute_array_t* val_in,
+                                  pnanovdb_compute_array_t* val_out,
+                                  pnanovdb_uint64_t val_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_global_scan_max(cpu_primitives_pool(), (const pnanovdb_uint32_t*)val_in->data,
+                                             (pnanovdb_uint32_t*)val_out->data, val_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[2u] = { val_in, val_out };
+    gpu_array_dispatch(compute, queue, arrays, 2u, 0x2,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       { global_scan_max(compute, queue, context_in, buffers[0u], buffers[1u], val_count, 1u); });
+}
+
+static void radix_sort_array(const pnanovdb_compute_t* compute,
+                             pnanovdb_compute_queue_t* queue,
+                             pnanovdb_parallel_primitives_context_t* context_in,
+                             pnanovdb_compute_array_t* key_inout,
+                             pnanovdb_compute_array_t* val_inout,
+                             pnanovdb_uint64_t key_count,
+                             pnanovdb_uint32_t key_bit_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_radix_sort(cpu_primitives_pool(), (pnanovdb_uint32_t*)key_inout->data,
+                                        (pnanovdb_uint32_t*)val_inout->data, key_count, key_bit_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[2u] = { key_inout, val_inout };
+    gpu_array_dispatch(
+        compute, queue, arrays, 2u, 0x3,
+        [&](pnanovdb_compute_buffer_t* const* buffers)
+        { radix_sort(compute, queue, context_in, buffers[0u], buffers[1u], key_count, key_count, key_bit_count); });
+}
+
+static void radix_sort_dual_key_array(const pnanovdb_compute_t* compute,
+                                      pnanovdb_compute_queue_t* queue,
+                                      pnanovdb_parallel_primitives_context_t* context_in,
+                                      pnanovdb_compute_array_t* key_low_inout,
+                                      pnanovdb_compute_array_t* key_high_inout,
+                                      pnanovdb_compute_array_t* val_inout,
+                                      pnanovdb_uint64_t key_count,
+                                      pnanovdb_uint32_t key_low_bit_count,
+                                      pnanovdb_uint32_t key_high_bit_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_radix_sort_dual_key(
+            cpu_primitives_pool(), (pnanovdb_uint32_t*)key_low_inout->data, (pnanovdb_uint32_t*)key_high_inout->data,
+            (pnanovdb_uint32_t*)val_inout->data, key_count, key_low_bit_count, key_high_bit_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[3u] = { key_low_inout, key_high_inout, val_inout };
+    gpu_array_dispatch(compute, queue, arrays, 3u, 0x7,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       {
+                           radix_sort_dual_key(compute, queue, context_in, buffers[0u], buffers[1u], buffers[2u],
+                                               key_count, key_count, key_low_bit_count, key_high_bit_count);
+                       });
+}
+
+static void radix_sort_key64_array(const pnanovdb_compute_t* compute,
+                                   pnanovdb_compute_queue_t* queue,
+                                   pnanovdb_parallel_primitives_context_t* context_in,
+                                   pnanovdb_compute_array_t* key_inout,
+                                   pnanovdb_compute_array_t* val_inout,
+                                   pnanovdb_uint64_t key_count,
+                                   pnanovdb_uint32_t key_bit_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_radix_sort(cpu_primitives_pool(), (pnanovdb_uint64_t*)key_inout->data,
+                                        (pnanovdb_uint32_t*)val_inout->data, key_count, key_bit_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[2u] = { key_inout, val_inout };
+    gpu_array_dispatch(compute, queue, arrays, 2u, 0x3,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       {
+                           radix_sort_key64(compute, queue, context_in, buffers[0u], buffers[1u], key_count,
+                                            key_count, key_bit_count);
+                       });
+}
+
+static void segmented_scan_array(const pnanovdb_compute_t* compute,
+                                 pnanovdb_compute_queue_t* queue,
+                                 pnanovdb_parallel_primitives_context_t* context_in,
+                                 pnanovdb_compute_array_t* val_in,
+                                 pnanovdb_compute_array_t* flag_in,
+                                 pnanovdb_compute_array_t* val_out,
+                                 pnanovdb_uint64_t val_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_segmented_scan(cpu_primitives_pool(), (const pnanovdb_uint32_t*)val_in->data,
+                                            (const pnanovdb_uint32_t*)flag_in->data,
+                                            (pnanovdb_uint32_t*)val_out->data, val_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[3u] = { val_in, flag_in, val_out };
+    gpu_array_dispatch(
+        compute, queue, arrays, 3u, 0x4,
+        [&](pnanovdb_compute_buffer_t* const* buffers)
+        { segmented_scan(compute, queue, context_in, buffers[0u], buffers[1u], buffers[2u], val_count); });
+}
+
+static void segmented_radix_sort_array(const pnanovdb_compute_t* compute,
+                                       pnanovdb_compute_queue_t* queue,
+                                       pnanovdb_parallel_primitives_context_t* context_in,
+                                       pnanovdb_compute_array_t* key_inout,
+                                       pnanovdb_compute_array_t* val_inout,
+                                       pnanovdb_compute_array_t* flag_in,
+                                       pnanovdb_uint64_t key_count,
+                                       pnanovdb_uint32_t key_bit_count)
+{
+    if (!queue)
+    {
+        pnanovdb_raster::cpu_segmented_radix_sort(cpu_primitives_pool(), (pnanovdb_uint32_t*)key_inout->data,
+                                                  (pnanovdb_uint32_t*)val_inout->data,
+                                                  (const pnanovdb_uint32_t*)flag_in->data, key_count, key_bit_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[3u] = { key_inout, val_inout, flag_in };
+    gpu_array_dispatch(compute, queue, arrays, 3u, 0x3,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       {
+                           segmented_radix_sort(compute, queue, context_in, buffers[0u], buffers[1u], buffers[2u],
+                                                key_count, key_count, key_bit_count);
+                       });
+}
+
+static void select_generic_array(const pnanovdb_compute_t* compute,
+                                 pnanovdb_compute_queue_t* queue,
+                                 pnanovdb_parallel_primitives_context_t* context_in,
+                                 pnanovdb_compute_array_t* val_in,
+                                 pnanovdb_compute_array_t* flag_in,
+                                 pnanovdb_compute_array_t* val_out,
+                                 pnanovdb_compute_array_t* count_out,
+                                 pnanovdb_uint64_t val_count,
+                                 pnanovdb_bool_t partition)
+{
+    if (!queue)
+    {
+        pnanovdb_uint64_t selected_count = pnanovdb_raster::cpu_select(
+            cpu_primitives_pool(), (const pnanovdb_uint32_t*)val_in->data, (const pnanovdb_uint32_t*)flag_in->data,
+            (pnanovdb_uint32_t*)val_out->data, val_count, partition == PNANOVDB_TRUE);
+        cpu_array_write_count(count_out, selected_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[4u] = { val_in, flag_in, val_out, count_out };
+    gpu_array_dispatch(compute, queue, arrays, 4u, 0xC,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       {
+                           select_generic(compute, queue, context_in, buffers[0u], buffers[1u], buffers[2u],
+                                          buffers[3u], val_count, partition);
+                       });
+}
+
+static void select_if_array(const pnanovdb_compute_t* compute,
+                            pnanovdb_compute_queue_t* queue,
+                            pnanovdb_parallel_primitives_context_t* context_in,
+                            pnanovdb_compute_array_t* val_in,
+                            pnanovdb_compute_array_t* flag_in,
+                            pnanovdb_compute_array_t* val_out,
+                            pnanovdb_compute_array_t* count_out,
+                            pnanovdb_uint64_t val_count)
+{
+    select_generic_array(
+        compute, queue, context_in, val_in, flag_in, val_out, count_out, val_count, PNANOVDB_FALSE);
+}
+
+static void partition_array(const pnanovdb_compute_t* compute,
+                            pnanovdb_compute_queue_t* queue,
+                            pnanovdb_parallel_primitives_context_t* context_in,
+                            pnanovdb_compute_array_t* val_in,
+                            pnanovdb_compute_array_t* flag_in,
+                            pnanovdb_compute_array_t* val_out,
+                            pnanovdb_compute_array_t* count_out,
+                            pnanovdb_uint64_t val_count)
+{
+    select_generic_array(compute, queue, context_in, val_in, flag_in, val_out, count_out, val_count, PNANOVDB_TRUE);
+}
+
+static void run_length_encode_generic_array(const pnanovdb_compute_t* compute,
+                                            pnanovdb_compute_queue_t* queue,
+                                            pnanovdb_parallel_primitives_context_t* context_in,
+                                            pnanovdb_compute_array_t* key_in,
+                                            pnanovdb_compute_array_t* range_out,
+                                            pnanovdb_compute_array_t* count_out,
+                                            pnanovdb_uint64_t key_count,
+                                            pnanovdb_bool_t key64)
+{
+    if (!queue)
+    {
+        pnanovdb_uint32_t* range = (pnanovdb_uint32_t*)range_out->data;
+        pnanovdb_uint64_t run_count =
+            key64 ? pnanovdb_raster::cpu_run_length_encode(
+                        cpu_primitives_pool(), (const pnanovdb_uint64_t*)key_in->data, range, key_count) :
+                    pnanovdb_raster::cpu_run_length_encode(
+                        cpu_primitives_pool(), (const pnanovdb_uint32_t*)key_in->data, range, key_count);
+        cpu_array_write_count(count_out, run_count);
+        return;
+    }
+    pnanovdb_compute_array_t* arrays[3u] = { key_in, range_out, count_out };
+    gpu_array_dispatch(compute, queue, arrays, 3u, 0x6,
+                       [&](pnanovdb_compute_buffer_t* const* buffers)
+                       {
+                           run_length_encode_generic(
+                               compute, queue, context_in, buffers[0u], buffers[1u], buffers[2u], key_count, key64);
+                       });
+}
+
+static void run_length_encode_array(const pnanovdb_compute_t* compute,
+                                    pnanovdb_compute_queue_t* queue,
+                                    pnanovdb_parallel_primitives_context_t* context_in,
+                                    pnanovdb_compute_array_t* key_in,
+                                    pnanovdb_compute_array_t* range_out,
+                                    pnanovdb_compute_array_t* count_out,
+                                    pnanovdb_uint64_t key_count)
+{
+    run_length_encode_generic_array(
+        compute, queue, context_in, key_in, range_out, count_out, key_count, PNANOVDB_FALSE);
+}
+
+static void run_length_encode_key64_array(const pnanovdb_compute_t* compute,
+                                          pnanovdb_compute_queue_t* queue,
+                                          pnanovdb_parallel_primitives_context_t* context_in,
+                                          pnanovdb_compute_array_t* key_in,
+                                          pnanovdb_compute_array_t* range_out,
+                                          pnanovdb_compute_array_t* count_out,
+                                          pnanovdb_uint64_t key_count)
+{
+    run_length_encode_generic_array(compute, queue, context_in, key_in, range_out, count_out, key_count, PNANOVDB_TRUE);
 }
 
 static void test_radix_sort_key64(const pnanovdb_compute_t* compute,
@@ -938,7 +1982,7 @@ static void test_radix_sort_key64(const pnanovdb_compute_t* compute,
     compute->unmap_array(key_arr);
     compute->unmap_array(val_arr);
 
-    radix_sort_array(compute, queue, context_in, key_arr, val_arr, element_count, 64u);
+    radix_sort_key64_array(compute, queue, context_in, key_arr, val_arr, element_count, 64u);
 
     pnanovdb_uint32_t old_key = 0u;
     pnanovdb_uint32_t sort_fail_count = 0u;
@@ -979,6 +2023,25 @@ pnanovdb_parallel_primitives_t* pnanovdb_get_parallel_primitives()
     iface.radix_sort = radix_sort;
     iface.radix_sort_dual_key = radix_sort_dual_key;
     iface.radix_sort_key64 = radix_sort_key64;
+    iface.set_radix_sort_mode = set_radix_sort_mode;
+    iface.segmented_scan = segmented_scan;
+    iface.segmented_radix_sort = segmented_radix_sort;
+    iface.select_if = select_if;
+    iface.partition = partition;
+    iface.run_length_encode = run_length_encode;
+    iface.run_length_encode_key64 = run_length_encode_key64;
+    iface.global_scan_array = global_scan_array;
+    iface.global_scan_uint64_array = global_scan_uint64_array;
+    iface.global_scan_max_array = global_scan_max_array;
+    iface.radix_sort_array = radix_sort_array;
+    iface.radix_sort_dual_key_array = radix_sort_dual_key_array;
+    iface.radix_sort_key64_array = radix_sort_key64_array;
+    iface.segmented_scan_array = segmented_scan_array;
+    iface.segmented_radix_sort_array = segmented_radix_sort_array;
+    iface.select_if_array = select_if_array;
+    iface.partition_array = partition_array;
+    iface.run_length_encode_array = run_length_encode_array;
+    iface.run_length_encode_key64_array = run_length_encode_key64_array;
 
     return &iface;
 }
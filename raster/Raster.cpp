@@ -34,8 +34,8 @@ static void raster_profiler_report(void* userdata,
     printf("raster_to_nanovdb() profiler results capture_id(%llu):\n", (unsigned long long int)capture_id);
     for (pnanovdb_uint32_t idx = 0u; idx < num_entries; idx++)
     {
-        printf("[%d] name(%s) cpu_ms(%f) gpu_ms(%f)\n", idx, entries[idx].label, 1000.f * entries[idx].cpu_delta_time,
-               1000.f * entries[idx].gpu_delta_time);
+        printf("[%d] name(%s) cpu_ms(%f) gpu_ms(%f) barriers(%u)\n", idx, entries[idx].label,
+               1000.f * entries[idx].cpu_delta_time, 1000.f * entries[idx].gpu_delta_time, entries[idx].barrier_count);
     }
 }
 
@@ -537,7 +537,8 @@ void raster_gaussian_3d(const pnanovdb_compute_t* compute,
         pnanovdb_uint64_t flushed_frame = 0llu;
         compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
 
-        compute->device_interface.wait_idle(queue);
+        // wait on this queue's own submission, not on the whole VkQueue
+        compute->device_interface.wait_for_frame(queue, flushed_frame);
 
         pnanovdb_uint64_t time_end;
         timestamp_capture(&time_end);
@@ -603,7 +604,7 @@ pnanovdb_compute_array_t* raster_to_nanovdb(const pnanovdb_compute_t* compute,
     pnanovdb_uint64_t flushed_frame = 0llu;
     compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
 
-    compute->device_interface.wait_idle(queue);
+    compute->device_interface.wait_for_frame(queue, flushed_frame);
 
     // to flush profile
     flushed_frame = 0llu;
@@ -835,6 +836,11 @@ pnanovdb_raster_t* pnanovdb_get_raster()
     raster.raster_to_nanovdb_from_arrays = pnanovdb_raster::raster_to_nanovdb_from_arrays;
     raster.create_gaussian_data_from_arrays = pnanovdb_raster::create_gaussian_data_from_arrays;
     raster.create_gaussian_data_from_desc = pnanovdb_raster::create_gaussian_data_from_desc;
+    raster.evict_gaussian_data = pnanovdb_raster::evict_gaussian_data;
+    raster.get_gaussian_data_resident_bytes = pnanovdb_raster::get_gaussian_data_resident_bytes;
+    raster.get_gaussian_cull_stats = pnanovdb_raster::get_gaussian_cull_stats;
+    raster.raster_gaussian_2d_views = pnanovdb_raster::raster_gaussian_2d_views;
+    raster.raster_gaussian_2d_cpu = pnanovdb_raster::raster_gaussian_2d_cpu;
 
     return &raster;
 }
@@ -10,6 +10,13 @@
 */
 
 #include "Common.h"
+#include "CoherentSort.h"
+#include "CpuRaster2D.h"
+#include "GaussianChunks.h"
+#include "MultiView.h"
+#include "ShColorCache.h"
+#include "TileLoadBalance.h"
+#include "TileVariants.h"
 
 #include "nanovdb_editor/putil/Raster.h"
 #include "nanovdb_editor/putil/GridBuild.h"
@@ -26,12 +33,26 @@ static const char* s_shader_names[shader_count] = { "raster/gaussian_frag_alloc.
                                                     "raster/point_frag_color.slang",
 
                                                     "raster/gaussian_count_tiles.slang",
+                                                    "raster/gaussian_cull_args.slang",
+                                                    "raster/gaussian_cull_chunks.slang",
+                                                    "raster/gaussian_cull_finalize.slang",
                                                     "raster/gaussian_projection.slang",
                                                     "raster/gaussian_rasterize_2d.slang",
+                                                    "raster/gaussian_rasterize_2d_32x8.slang",
+                                                    "raster/gaussian_rasterize_2d_8x8.slang",
                                                     "raster/gaussian_rasterize_2d_null.slang",
+                                                    "raster/gaussian_rasterize_2d_null_32x8.slang",
+                                                    "raster/gaussian_rasterize_2d_null_8x8.slang",
+                                                    "raster/gaussian_sort_check.slang",
+                                                    "raster/gaussian_sort_fixup.slang",
+                                                    "raster/gaussian_sort_mark.slang",
+                                                    "raster/gaussian_sort_merge.slang",
+                                                    "raster/gaussian_sort_scatter.slang",
                                                     "raster/gaussian_spherical_harmonics.slang",
                                                     "raster/gaussian_tile_intersections.slang",
-                                                    "raster/gaussian_tile_offsets.slang" };
+                                                    "raster/gaussian_tile_merge.slang",
+                                                    "raster/gaussian_tile_offsets.slang",
+                                                    "raster/gaussian_tile_work.slang" };
 
 struct raster_context_t
 {
@@ -43,6 +64,12 @@ struct raster_context_t
     pnanovdb_grid_build_context_t* grid_build_ctx;
 
     pnanovdb_uint64_t max_isects_count = { 0llu };
+
+    pnanovdb_raster_gaussian_cull_stats_t cull_stats = {};
+    // tile work counters of earlier rasters, mapped once the device is done with them
+    pnanovdb_compute_readback_queue_t* tile_stats_readback = nullptr;
+    // constants of the even and odd coherent sort fixup passes, written once
+    pnanovdb_compute_buffer_t* sort_fixup_params_buffers[2] = {};
 };
 
 PNANOVDB_CAST_PAIR(pnanovdb_raster_context_t, raster_context_t)
@@ -71,6 +98,31 @@ struct gaussian_data_t
     compute_gpu_array_t* sh_n_gpu_array;
     compute_gpu_array_t* opacities_gpu_array;
     compute_gpu_array_t** shader_params_gpu_arrays;
+
+    // gaussian indices in Morton order, one bounding sphere per k_gaussian_chunk_size of them
+    pnanovdb_uint64_t chunk_count;
+    pnanovdb_compute_array_t* chunk_indices_cpu_array;
+    pnanovdb_compute_array_t* chunk_bounds_cpu_array;
+    compute_gpu_array_t* chunk_indices_gpu_array;
+    compute_gpu_array_t* chunk_bounds_gpu_array;
+
+    // depth order of all gaussians, the warm start of the next coherent tile sort, scratch holds the visible order
+    compute_gpu_array_t* depth_order_gpu_array;
+    compute_gpu_array_t* depth_order_scratch_gpu_array;
+    pnanovdb_bool_t has_depth_order;
+    pnanovdb_bool_t has_sort_view;
+    pnanovdb_camera_mat_t sort_view;
+    pnanovdb_vec3_t bounds_center;
+
+    // average splat radius in pixels of the last raster, picks the tile variant, 0 until the first raster
+    float splat_radius_2d;
+
+    // SH colors of all gaussians and the view direction each chunk last evaluated them for
+    compute_gpu_array_t* sh_colors_gpu_array;
+    compute_gpu_array_t* sh_chunk_dirs_gpu_array;
+    pnanovdb_bool_t sh_cache_valid;
+    pnanovdb_int32_t sh_cache_degree;
+    pnanovdb_uint32_t sh_cache_stride_rgbrgbrgb;
 };
 
 PNANOVDB_CAST_PAIR(pnanovdb_raster_gaussian_data_t, gaussian_data_t)
@@ -103,6 +155,14 @@ void destroy_gaussian_data(const pnanovdb_compute_t* compute,
                            pnanovdb_compute_queue_t* queue,
                            pnanovdb_raster_gaussian_data_t* data);
 
+void evict_gaussian_data(const pnanovdb_compute_t* compute,
+                         pnanovdb_compute_queue_t* queue,
+                         pnanovdb_raster_gaussian_data_t* data);
+
+pnanovdb_uint64_t get_gaussian_data_resident_bytes(pnanovdb_raster_gaussian_data_t* data);
+
+void get_gaussian_cull_stats(pnanovdb_raster_context_t* context, pnanovdb_raster_gaussian_cull_stats_t* dst_stats);
+
 void raster_gaussian_2d(const pnanovdb_compute_t* compute,
                         pnanovdb_compute_queue_t* queue,
                         pnanovdb_raster_context_t* context,
@@ -115,6 +175,30 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
                         const pnanovdb_raster_shader_params_t* shader_params,
                         pnanovdb_uint32_t composite);
 
+void raster_gaussian_2d_views(const pnanovdb_compute_t* compute,
+                              pnanovdb_compute_queue_t* queue,
+                              pnanovdb_raster_context_t* context,
+                              pnanovdb_raster_gaussian_data_t* data,
+                              pnanovdb_compute_texture_t* color_2d_atlas,
+                              pnanovdb_uint32_t image_width,
+                              pnanovdb_uint32_t image_height,
+                              const pnanovdb_camera_mat_t* views,
+                              const pnanovdb_camera_mat_t* projections,
+                              pnanovdb_uint32_t view_count,
+                              pnanovdb_uint32_t atlas_columns,
+                              const pnanovdb_raster_shader_params_t* shader_params,
+                              pnanovdb_uint32_t composite);
+
+void raster_gaussian_2d_cpu(const pnanovdb_compute_t* compute,
+                            pnanovdb_raster_gaussian_data_t* data,
+                            pnanovdb_compute_array_t* color_2d,
+                            pnanovdb_uint32_t image_width,
+                            pnanovdb_uint32_t image_height,
+                            const pnanovdb_camera_mat_t* view,
+                            const pnanovdb_camera_mat_t* projection,
+                            const pnanovdb_raster_shader_params_t* shader_params,
+                            pnanovdb_uint32_t composite);
+
 void raster_gaussian_3d(const pnanovdb_compute_t* compute,
                         pnanovdb_compute_queue_t* queue,
                         pnanovdb_raster_context_t* context,
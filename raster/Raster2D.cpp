@@ -14,12 +14,26 @@
 #include "Raster.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <vector>
 
 namespace pnanovdb_raster
 {
 
+// uints of the cull counters, matches raster2d_common.slang
+static const pnanovdb_uint32_t s_cull_counter_visible_points = 3u;
+static const pnanovdb_uint32_t s_cull_counter_sh_args = 8u;
+static const pnanovdb_uint64_t s_cull_counters_size = 12u * sizeof(pnanovdb_uint32_t);
+// uints of the tile work counters, the histogram follows the queue counts
+static const pnanovdb_uint32_t s_tile_work_counter_split_items = 1u;
+static const pnanovdb_uint32_t s_tile_work_counter_tile_items = 2u;
+static const pnanovdb_uint32_t s_tile_work_counter_split_tiles = 3u;
+static const pnanovdb_uint32_t s_tile_work_counter_max_isects = 4u;
+static const pnanovdb_uint32_t s_tile_work_counter_histogram = 8u;
+static const pnanovdb_uint64_t s_tile_work_counters_size =
+    (s_tile_work_counter_histogram + PNANOVDB_RASTER_TILE_HISTOGRAM_BINS) * sizeof(pnanovdb_uint32_t);
+
 struct grid_dim_t
 {
     uint32_t x, y, z;
@@ -48,63 +62,52 @@ grid_dim_t compute_dispatch_grid_dim(uint32_t grid_dim_1d)
     return grid_dim;
 }
 
-static void extract_camera_info(pnanovdb_camera_mat_t view,
-                                pnanovdb_camera_mat_t proj,
-                                pnanovdb_vec3_t* view_dir_out,
-                                float* near_plane_out,
-                                float* far_plane_out)
+// tile work counters of earlier rasters that completed on the device
+static void accumulate_tile_stats(const pnanovdb_compute_t* compute,
+                                  pnanovdb_compute_queue_t* queue,
+                                  raster_context_t* ctx)
 {
-    pnanovdb_camera_mat_t view_inv = pnanovdb_camera_mat_inverse(view);
-    pnanovdb_camera_mat_t proj_inv = pnanovdb_camera_mat_inverse(proj);
-
-    pnanovdb_vec4_t pos_d0 = pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ 0.f, 0.f, 0.f, 1.f }, proj_inv);
-    pnanovdb_vec4_t pos_d1 = pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ 0.f, 0.f, 1.f, 1.f }, proj_inv);
-
-    float z_d0 = pos_d0.z * (1.f / pos_d0.w);
-    float z_d1 = pos_d1.z * (1.f / pos_d1.w);
-    bool is_reverse_z = abs(z_d0) > abs(z_d1);
-    pnanovdb_vec4_t ray_dir_near = is_reverse_z ? pos_d1 : pos_d0;
-
-    pnanovdb_vec4_t ray_dir_far =
-        pnanovdb_vec4_add(ray_dir_near, pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ 0.f, 0.f, 1.f, 0.f }, proj_inv));
-    pnanovdb_vec3_t rayDir = { (ray_dir_far.x / ray_dir_far.w) - (ray_dir_near.x / ray_dir_near.w),
-                               (ray_dir_far.y / ray_dir_far.w) - (ray_dir_near.y / ray_dir_near.w),
-                               (ray_dir_far.z / ray_dir_far.w) - (ray_dir_near.z / ray_dir_near.w) };
-    rayDir = pnanovdb_camera_vec3_normalize(rayDir);
-    if (is_reverse_z)
-    {
-        rayDir.x = -rayDir.x;
-        rayDir.y = -rayDir.y;
-        rayDir.z = -rayDir.z;
-    }
-
-    pnanovdb_vec4_t rayDir4 =
-        pnanovdb_camera_vec4_transform(pnanovdb_vec4_t{ rayDir.x, rayDir.y, rayDir.z, 0.f }, view_inv);
-    rayDir.x = rayDir4.x;
-    rayDir.y = rayDir4.y;
-    rayDir.z = rayDir4.z;
-
-    *view_dir_out = rayDir;
-    *near_plane_out = is_reverse_z ? z_d1 : z_d0;
-    *far_plane_out = is_reverse_z ? z_d0 : z_d1;
+    pnanovdb_uint64_t num_bytes = 0llu;
+    while (const void* mapped = compute->map_readback(compute, queue, ctx->tile_stats_readback, nullptr, &num_bytes))
+    {
+        const pnanovdb_uint32_t* counters = (const pnanovdb_uint32_t*)mapped;
+        pnanovdb_raster_gaussian_cull_stats_t& stats = ctx->cull_stats;
+        pnanovdb_uint64_t tile_count = 0u;
+        for (pnanovdb_uint32_t bin = 0u; bin < PNANOVDB_RASTER_TILE_HISTOGRAM_BINS; bin++)
+        {
+            stats.tile_histogram[bin] += counters[s_tile_work_counter_histogram + bin];
+            tile_count += counters[s_tile_work_counter_histogram + bin];
+        }
+        stats.tile_count += tile_count;
+        stats.split_tile_count += counters[s_tile_work_counter_split_tiles];
+        stats.tile_work_item_count +=
+            counters[s_tile_work_counter_split_items] + counters[s_tile_work_counter_tile_items];
+        if (counters[s_tile_work_counter_max_isects] > stats.max_tile_intersections)
+        {
+            stats.max_tile_intersections = counters[s_tile_work_counter_max_isects];
+        }
+        stats.tile_stats_count++;
+
+        compute->unmap_readback(compute, queue, ctx->tile_stats_readback);
+    }
 }
 
-void raster_gaussian_2d(const pnanovdb_compute_t* compute,
-                        pnanovdb_compute_queue_t* queue,
-                        pnanovdb_raster_context_t* context_in,
-                        pnanovdb_raster_gaussian_data_t* data_in,
-                        pnanovdb_compute_texture_t* color_2d,
-                        pnanovdb_uint32_t image_width,
-                        pnanovdb_uint32_t image_height,
-                        const pnanovdb_camera_mat_t* view,
-                        const pnanovdb_camera_mat_t* projection,
-                        const pnanovdb_raster_shader_params_t* shader_params,
-                        pnanovdb_uint32_t composite)
+// rasterizes view_count views in one pass over the gaussian data, views go to the atlas cells from view_offset
+static void raster_gaussian_2d_batch(const pnanovdb_compute_t* compute,
+                                     pnanovdb_compute_queue_t* queue,
+                                     pnanovdb_raster_context_t* context_in,
+                                     pnanovdb_raster_gaussian_data_t* data_in,
+                                     pnanovdb_compute_texture_t* color_2d,
+                                     pnanovdb_uint32_t image_width,
+                                     pnanovdb_uint32_t image_height,
+                                     const pnanovdb_camera_mat_t* views,
+                                     const pnanovdb_camera_mat_t* projections,
+                                     pnanovdb_uint32_t view_count,
+                                     pnanovdb_uint32_t view_offset,
+                                     pnanovdb_uint32_t atlas_columns,
+                                     const pnanovdb_raster_shader_params_t* shader_params,
+                                     pnanovdb_uint32_t composite)
 {
-    if (shader_params == nullptr)
-    {
-        return;
-    }
 
     auto ctx = cast(context_in);
     auto data = cast(data_in);
@@ -116,11 +119,10 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
 
     pnanovdb_raster_shader_params_t gpu_params = *shader_params;
 
-    // The raster shader uses [numthreads(16,16,1)], so tile_size must be 16 for correct coverage
-    if (gpu_params.tile_size != 16u)
-    {
-        gpu_params.tile_size = 16u;
-    }
+    // each tile size has its own rasterizer shader, the workgroup covers one tile
+    const tile_variant_t& tile_variant =
+        k_tile_variants[select_tile_variant(gpu_params.tile_size, image_width, image_height, data->splat_radius_2d)];
+    gpu_params.tile_size = tile_variant.width;
 
     if (gpu_params.sh_degree_override < 0)
     {
@@ -130,16 +132,6 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
 
     struct constants_t
     {
-        pnanovdb_camera_mat_t view;
-        pnanovdb_vec4_t view_rot0;
-        pnanovdb_vec4_t view_rot1;
-        pnanovdb_vec4_t view_rot2;
-
-        float near_plane;
-        float far_plane;
-        float fx;
-        float fy;
-
         float cx;
         float cy;
         pnanovdb_uint32_t image_width;
@@ -148,7 +140,7 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
         pnanovdb_uint32_t prim_count;
         pnanovdb_uint32_t n_isects;
         pnanovdb_uint32_t composite;
-        pnanovdb_uint32_t pad2;
+        pnanovdb_uint32_t coherent_sort;
 
         pnanovdb_uint32_t image_origin_w;
         pnanovdb_uint32_t image_origin_h;
@@ -160,33 +152,74 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
         pnanovdb_uint32_t num_tiles_w;
         pnanovdb_uint32_t num_tiles_h;
 
-        pnanovdb_vec3_t view_dir;
         pnanovdb_uint32_t num_tiles;
-
-        pnanovdb_uint32_t is_orthographic;
         pnanovdb_uint32_t sh_stride;
         pnanovdb_uint32_t points_grid_dim_x;
         pnanovdb_uint32_t isects_grid_dim_x;
+
+        pnanovdb_uint32_t chunk_count;
+        pnanovdb_uint32_t chunks_grid_dim_x;
+        pnanovdb_uint32_t tile_size_w;
+        pnanovdb_uint32_t tile_size_h;
+
+        pnanovdb_uint32_t tile_split_threshold;
+        pnanovdb_uint32_t tile_split_size;
+        pnanovdb_uint32_t tile_split_capacity;
+        pnanovdb_uint32_t view_count;
+
+        float sh_cache_cos_tolerance;
+        pnanovdb_uint32_t sh_cache_reset;
+        pnanovdb_uint32_t view_offset;
+        pnanovdb_uint32_t atlas_columns;
     };
-    constants_t constants = {};
+    struct view_t
+    {
+        pnanovdb_camera_mat_t view;
+        pnanovdb_vec4_t view_rot0;
+        pnanovdb_vec4_t view_rot1;
+        pnanovdb_vec4_t view_rot2;
 
-    pnanovdb_vec3_t view_dir = {};
-    float near_plane = 0.f;
-    float far_plane = 0.f;
-    extract_camera_info(*view, *projection, &view_dir, &near_plane, &far_plane);
+        pnanovdb_vec4_t frustum_planes[6];
+        pnanovdb_vec4_t depth_row;
 
-    grid_dim_t points_grid_dim = compute_dispatch_grid_dim((data->point_count + 255u) / 256u);
+        pnanovdb_vec3_t view_dir;
+        pnanovdb_uint32_t is_orthographic;
 
+        float near_plane;
+        float far_plane;
+        float fx;
+        float fy;
+    };
+    constants_t constants = {};
+
+    std::vector<view_t> view_constants(view_count);
+    for (pnanovdb_uint32_t view_idx = 0u; view_idx < view_count; view_idx++)
+    {
+        const pnanovdb_camera_mat_t& view = views[view_idx];
+        const pnanovdb_camera_mat_t& projection = projections[view_idx];
+        view_t& dst = view_constants[view_idx];
+
+        extract_camera_info(view, projection, &dst.view_dir, &dst.near_plane, &dst.far_plane);
+        dst.view = pnanovdb_camera_mat_transpose(view);
+        dst.view_rot0 = view.x;
+        dst.view_rot1 = view.y;
+        dst.view_rot2 = view.z;
+        dst.fx = (float)image_width * 0.5f * projection.x.x;
+        dst.fy = (float)image_height * 0.5f * projection.y.y;
+        dst.is_orthographic = projection.z.w == 0.f ? 1u : 0u;
+
+        pnanovdb_camera_mat_t view_proj = pnanovdb_camera_mat_mul(view, projection);
+        extract_frustum_planes(view_proj, dst.frustum_planes);
+        dst.depth_row = { view_proj.x.w, view_proj.y.w, view_proj.z.w, view_proj.w.w };
+    }
+
+    // each gaussian has one instance per view, view_idx * prim_count + prim_idx
     pnanovdb_uint64_t prim_count_64 = data->point_count;
+    pnanovdb_uint64_t instance_count_64 = prim_count_64 * view_count;
+
+    grid_dim_t points_grid_dim = compute_dispatch_grid_dim((pnanovdb_uint32_t)((instance_count_64 + 255u) / 256u));
+    grid_dim_t chunks_grid_dim = compute_dispatch_grid_dim((pnanovdb_uint32_t)(data->chunk_count * view_count));
 
-    constants.view = pnanovdb_camera_mat_transpose(*view);
-    constants.view_rot0 = view->x;
-    constants.view_rot1 = view->y;
-    constants.view_rot2 = view->z;
-    constants.near_plane = near_plane;
-    constants.far_plane = far_plane;
-    constants.fx = (float)image_width * 0.5f * projection->x.x;
-    constants.fy = (float)image_height * 0.5f * projection->y.y;
     constants.cx = (float)image_width * 0.5f; // TODO: this could be extracted from proj matrix
     constants.cy = (float)image_height * 0.5f;
     constants.image_width = image_width;
@@ -197,18 +230,62 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
     constants.image_origin_h = 0u;
     constants.tile_origin_w = 0u;
     constants.tile_origin_h = 0u;
-    constants.tile_width = (image_width + gpu_params.tile_size - 1u) / gpu_params.tile_size;
-    constants.tile_height = (image_height + gpu_params.tile_size - 1u) / gpu_params.tile_size;
-    constants.num_tiles_w = (image_width + gpu_params.tile_size - 1u) / gpu_params.tile_size;
-    constants.num_tiles_h = (image_height + gpu_params.tile_size - 1u) / gpu_params.tile_size;
-    constants.view_dir = view_dir;
-    constants.num_tiles = constants.num_tiles_w * constants.num_tiles_h;
-    constants.is_orthographic = projection->z.w == 0.f ? 1u : 0u;
+    constants.tile_width = (image_width + tile_variant.width - 1u) / tile_variant.width;
+    constants.tile_height = (image_height + tile_variant.height - 1u) / tile_variant.height;
+    constants.num_tiles_w = (image_width + tile_variant.width - 1u) / tile_variant.width;
+    constants.num_tiles_h = (image_height + tile_variant.height - 1u) / tile_variant.height;
+    constants.num_tiles = constants.tile_width * constants.tile_height * view_count;
     constants.sh_stride = data->sh_stride;
     constants.points_grid_dim_x = points_grid_dim.x;
     constants.isects_grid_dim_x = 32768u;
     constants.composite = composite;
 
+    // the previous depth order stays a good warm start while the camera moves little, batches of views sort fully
+    bool coherent_sort = false;
+    if (view_count == 1u)
+    {
+        camera_delta_t camera_delta = {};
+        if (data->has_sort_view)
+        {
+            camera_delta = compute_camera_delta(data->sort_view, views[0u], data->bounds_center);
+        }
+        coherent_sort = use_coherent_sort(gpu_params.tile_sort_mode, data->has_sort_view, camera_delta);
+        data->sort_view = views[0u];
+        data->has_sort_view = PNANOVDB_TRUE;
+    }
+    constants.coherent_sort = coherent_sort ? 1u : 0u;
+
+    constants.chunk_count = (pnanovdb_uint32_t)data->chunk_count;
+    constants.chunks_grid_dim_x = chunks_grid_dim.x;
+    constants.tile_size_w = tile_variant.width;
+    constants.tile_size_h = tile_variant.height;
+    constants.tile_split_threshold = k_tile_split_threshold;
+    constants.tile_split_size = k_tile_split_size;
+    constants.tile_split_capacity = 0u;
+    constants.view_count = view_count;
+    constants.view_offset = view_offset;
+    constants.atlas_columns = atlas_columns;
+
+    // cached SH colors are evaluated again per chunk once the view turned far enough
+    if (!data->sh_colors_gpu_array->device_buffer)
+    {
+        gpu_array_alloc_device(compute, queue, data->sh_colors_gpu_array, data->colors_cpu_array);
+        gpu_array_alloc_device(compute, queue, data->sh_chunk_dirs_gpu_array, data->chunk_bounds_cpu_array);
+        data->sh_cache_valid = PNANOVDB_FALSE;
+    }
+    // batches of views evaluate all visible chunks into their own colors and leave the cache as it is
+    if (view_count == 1u)
+    {
+        constants.sh_cache_cos_tolerance = sh_cache_cos_tolerance(gpu_params.sh_cache_angle);
+        constants.sh_cache_reset =
+            sh_cache_matches(data->sh_cache_valid, data->sh_cache_degree, data->sh_cache_stride_rgbrgbrgb, gpu_params) ?
+                0u :
+                1u;
+        data->sh_cache_valid = PNANOVDB_TRUE;
+        data->sh_cache_degree = gpu_params.sh_degree_override;
+        data->sh_cache_stride_rgbrgbrgb = gpu_params.sh_stride_rgbrgbrgb_override;
+    }
+
     // printf("fx(%f) fy(%f) cx(%f) cy(%f)\n", constants.fx, constants.fy, constants.cx, constants.cy);
 
     pnanovdb_compute_buffer_desc_t buf_desc = {};
@@ -244,6 +321,21 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
     pnanovdb_compute_buffer_transient_t* shader_params_transient =
         shader_params_buffer ? compute_interface->register_buffer_as_transient(context, shader_params_buffer) : nullptr;
 
+    // views, only read before the flush
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = sizeof(view_t);
+    buf_desc.size_in_bytes = sizeof(view_t) * view_count;
+    pnanovdb_compute_buffer_t* views_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+    void* mapped_views = compute_interface->map_buffer(context, views_buffer);
+    memcpy(mapped_views, view_constants.data(), sizeof(view_t) * view_count);
+    compute_interface->unmap_buffer(context, views_buffer);
+
+    pnanovdb_compute_buffer_transient_t* views_transient =
+        compute_interface->register_buffer_as_transient(context, views_buffer);
+
     pnanovdb_compute_buffer_transient_t* means_transient =
         compute_interface->register_buffer_as_transient(context, data->means_gpu_array->device_buffer);
     pnanovdb_compute_buffer_transient_t* quats_transient =
@@ -258,40 +350,77 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
         compute_interface->register_buffer_as_transient(context, data->sh_n_gpu_array->device_buffer);
     pnanovdb_compute_buffer_transient_t* opacities_transient =
         compute_interface->register_buffer_as_transient(context, data->opacities_gpu_array->device_buffer);
+    pnanovdb_compute_buffer_transient_t* chunk_indices_transient =
+        compute_interface->register_buffer_as_transient(context, data->chunk_indices_gpu_array->device_buffer);
+    pnanovdb_compute_buffer_transient_t* chunk_bounds_transient =
+        compute_interface->register_buffer_as_transient(context, data->chunk_bounds_gpu_array->device_buffer);
+
+    // indirect args of the per gaussian passes followed by the visible gaussian, chunk and intersection counts
+    // zeros also clear the larger tile work counters
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC;
+    buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+    buf_desc.structure_stride = 0u;
+    buf_desc.size_in_bytes = s_tile_work_counters_size;
+    pnanovdb_compute_buffer_t* cull_counters_upload_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+
+    void* mapped_cull_counters = compute_interface->map_buffer(context, cull_counters_upload_buffer);
+    memset(mapped_cull_counters, 0, s_tile_work_counters_size);
+    compute_interface->unmap_buffer(context, cull_counters_upload_buffer);
+
+    buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
+                     PNANOVDB_COMPUTE_BUFFER_USAGE_INDIRECT | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC |
+                     PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+    buf_desc.structure_stride = 4u;
+    buf_desc.size_in_bytes = s_cull_counters_size;
+    pnanovdb_compute_buffer_t* cull_counters_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+    pnanovdb_compute_buffer_transient_t* cull_counters_transient =
+        compute_interface->register_buffer_as_transient(context, cull_counters_buffer);
 
     buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
                      PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
     buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
     buf_desc.structure_stride = 4u;
-    buf_desc.size_in_bytes = 4u * prim_count_64;
+    buf_desc.size_in_bytes = 4u * instance_count_64;
     pnanovdb_compute_buffer_t* radii_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
     buf_desc.structure_stride = 8u;
-    buf_desc.size_in_bytes = 8u * prim_count_64;
+    buf_desc.size_in_bytes = 8u * instance_count_64;
     pnanovdb_compute_buffer_t* means2d_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
     buf_desc.structure_stride = 4u;
-    buf_desc.size_in_bytes = 4u * prim_count_64;
+    buf_desc.size_in_bytes = 4u * instance_count_64;
     pnanovdb_compute_buffer_t* depths_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
     buf_desc.structure_stride = 4u;
-    buf_desc.size_in_bytes = 12u * prim_count_64;
+    buf_desc.size_in_bytes = 12u * instance_count_64;
     pnanovdb_compute_buffer_t* conics_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
     buf_desc.structure_stride = 4u;
-    buf_desc.size_in_bytes = 4u * prim_count_64;
+    buf_desc.size_in_bytes = 4u * instance_count_64;
     pnanovdb_compute_buffer_t* compensations_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
     buf_desc.structure_stride = 4u;
-    buf_desc.size_in_bytes = 12u * prim_count_64;
-    pnanovdb_compute_buffer_t* resolved_color_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    buf_desc.structure_stride = 4u;
-    buf_desc.size_in_bytes = 4u * prim_count_64;
+    buf_desc.size_in_bytes = 4u * instance_count_64;
     pnanovdb_compute_buffer_t* num_tiles_per_gaussian_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
     pnanovdb_compute_buffer_t* scan_tiles_per_gaussian_buffer =
         compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* visible_indices_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    buf_desc.size_in_bytes = 4u * (data->chunk_count > 0u ? data->chunk_count * view_count : 1u);
+    pnanovdb_compute_buffer_t* sh_refresh_chunks_buffer =
+        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    pnanovdb_compute_buffer_t* view_colors_buffer = nullptr;
+    if (view_count > 1u)
+    {
+        buf_desc.size_in_bytes = 12u * instance_count_64;
+        view_colors_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+    }
+    pnanovdb_compute_buffer_t* resolved_color_buffer =
+        view_colors_buffer ? view_colors_buffer : data->sh_colors_gpu_array->device_buffer;
 
     pnanovdb_compute_buffer_transient_t* radii_transient =
         compute_interface->register_buffer_as_transient(context, radii_buffer);
@@ -305,81 +434,254 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
         compute_interface->register_buffer_as_transient(context, compensations_buffer);
     pnanovdb_compute_buffer_transient_t* resolved_color_transient =
         compute_interface->register_buffer_as_transient(context, resolved_color_buffer);
+    pnanovdb_compute_buffer_transient_t* sh_chunk_dirs_transient =
+        compute_interface->register_buffer_as_transient(context, data->sh_chunk_dirs_gpu_array->device_buffer);
     pnanovdb_compute_buffer_transient_t* num_tiles_per_gaussian_transient =
         compute_interface->register_buffer_as_transient(context, num_tiles_per_gaussian_buffer);
     pnanovdb_compute_buffer_transient_t* scan_tiles_per_gaussian_transient =
         compute_interface->register_buffer_as_transient(context, scan_tiles_per_gaussian_buffer);
+    pnanovdb_compute_buffer_transient_t* visible_indices_transient =
+        compute_interface->register_buffer_as_transient(context, visible_indices_buffer);
+    pnanovdb_compute_buffer_transient_t* sh_refresh_chunks_transient =
+        compute_interface->register_buffer_as_transient(context, sh_refresh_chunks_buffer);
+
+    // coherent sort, the culling pass only flags visible gaussians, they are compacted in the previous depth order
+    pnanovdb_compute_buffer_t* sort_keys_buffer = nullptr;
+    pnanovdb_compute_buffer_t* visible_scan_buffer = nullptr;
+    if (coherent_sort)
+    {
+        buf_desc.size_in_bytes = 4u * prim_count_64;
+        sort_keys_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+        visible_scan_buffer = compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
 
-    // projection
+        if (!data->has_depth_order)
+        {
+            // the first coherent frame starts from the Morton order
+            gpu_array_alloc_device(compute, queue, data->depth_order_gpu_array, data->chunk_indices_cpu_array);
+            gpu_array_alloc_device(compute, queue, data->depth_order_scratch_gpu_array, data->chunk_indices_cpu_array);
+
+            pnanovdb_compute_copy_buffer_params_t copy_params = {};
+            copy_params.num_bytes = 4u * prim_count_64;
+            copy_params.src = chunk_indices_transient;
+            copy_params.dst =
+                compute_interface->register_buffer_as_transient(context, data->depth_order_gpu_array->device_buffer);
+            copy_params.debug_label = "gaussian_sort_init";
+            compute_interface->copy_buffer(context, &copy_params);
+
+            data->has_depth_order = PNANOVDB_TRUE;
+        }
+    }
+    pnanovdb_compute_buffer_t* visible_order_buffer =
+        coherent_sort ? data->depth_order_scratch_gpu_array->device_buffer : visible_indices_buffer;
+    pnanovdb_compute_buffer_transient_t* visible_order_transient =
+        compute_interface->register_buffer_as_transient(context, visible_order_buffer);
+
+    // clear cull counters
     {
-        pnanovdb_compute_resource_t resources[10u] = {};
+        pnanovdb_compute_copy_buffer_params_t copy_params = {};
+        copy_params.num_bytes = s_cull_counters_size;
+        copy_params.src = compute_interface->register_buffer_as_transient(context, cull_counters_upload_buffer);
+        copy_params.dst = cull_counters_transient;
+        copy_params.debug_label = "gaussian_cull_clear";
+        compute_interface->copy_buffer(context, &copy_params);
+    }
+
+    // cull chunks, appends the gaussians of visible chunks to the visible index list
+    // and the visible chunks whose cached SH colors are stale to the refresh list
+    {
+        pnanovdb_compute_resource_t resources[9u] = {};
         resources[0u].buffer_transient = constant_transient;
         resources[1u].buffer_transient = shader_params_transient;
-        resources[2u].buffer_transient = means_transient;
-        resources[3u].buffer_transient = quats_transient;
-        resources[4u].buffer_transient = scales_transient;
-        resources[5u].buffer_transient = radii_transient;
-        resources[6u].buffer_transient = means2d_transient;
-        resources[7u].buffer_transient = depths_transient;
-        resources[8u].buffer_transient = conics_transient;
-        resources[9u].buffer_transient = compensations_transient;
+        resources[2u].buffer_transient = views_transient;
+        resources[3u].buffer_transient = chunk_bounds_transient;
+        resources[4u].buffer_transient = chunk_indices_transient;
+        resources[5u].buffer_transient = cull_counters_transient;
+        resources[6u].buffer_transient = visible_indices_transient;
+        resources[7u].buffer_transient = sh_chunk_dirs_transient;
+        resources[8u].buffer_transient = sh_refresh_chunks_transient;
+
+        grid_dim_t grid_dim = chunks_grid_dim;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_cull_chunks_slang], resources,
+                                 grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_cull_chunks");
+    }
 
-        grid_dim_t grid_dim = points_grid_dim;
+    // compact the flagged gaussians in the previous depth order
+    if (coherent_sort)
+    {
+        pnanovdb_compute_buffer_transient_t* depth_order_transient =
+            compute_interface->register_buffer_as_transient(context, data->depth_order_gpu_array->device_buffer);
+        pnanovdb_compute_buffer_transient_t* visible_scan_transient =
+            compute_interface->register_buffer_as_transient(context, visible_scan_buffer);
+
+        {
+            pnanovdb_compute_resource_t resources[4u] = {};
+            resources[0u].buffer_transient = constant_transient;
+            resources[1u].buffer_transient = depth_order_transient;
+            resources[2u].buffer_transient = visible_indices_transient;
+            resources[3u].buffer_transient = num_tiles_per_gaussian_transient;
+
+            grid_dim_t grid_dim = points_grid_dim;
+
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_sort_mark_slang], resources,
+                                     grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_sort_mark");
+        }
+
+        // kept until the sorted order is merged back at the end of the frame
+        ctx->parallel_primitives.global_scan(compute, queue, ctx->parallel_primitives_ctx, num_tiles_per_gaussian_buffer,
+                                             visible_scan_buffer, constants.prim_count, 1u);
 
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_projection_slang], resources,
-                                 grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_projection");
+        {
+            pnanovdb_compute_resource_t resources[5u] = {};
+            resources[0u].buffer_transient = constant_transient;
+            resources[1u].buffer_transient = depth_order_transient;
+            resources[2u].buffer_transient = num_tiles_per_gaussian_transient;
+            resources[3u].buffer_transient = visible_scan_transient;
+            resources[4u].buffer_transient = visible_order_transient;
+
+            grid_dim_t grid_dim = points_grid_dim;
+
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_sort_scatter_slang],
+                                     resources, grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_sort_scatter");
+        }
     }
 
-    // spherical harmonics
+    // indirect args from the visible count
     {
-        pnanovdb_compute_resource_t resources[5u] = {};
+        pnanovdb_compute_resource_t resources[2u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = cull_counters_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_cull_args_slang], resources, 1u,
+                                 1u, 1u, "gaussian_cull_args");
+    }
+
+    // projection
+    {
+        pnanovdb_compute_resource_t resources[13u] = {};
         resources[0u].buffer_transient = constant_transient;
         resources[1u].buffer_transient = shader_params_transient;
-        resources[2u].buffer_transient = sh_0_transient;
-        resources[3u].buffer_transient = sh_n_transient;
-        resources[4u].buffer_transient = resolved_color_transient;
+        resources[2u].buffer_transient = views_transient;
+        resources[3u].buffer_transient = means_transient;
+        resources[4u].buffer_transient = quats_transient;
+        resources[5u].buffer_transient = scales_transient;
+        resources[6u].buffer_transient = cull_counters_transient;
+        resources[7u].buffer_transient = visible_order_transient;
+        resources[8u].buffer_transient = radii_transient;
+        resources[9u].buffer_transient = means2d_transient;
+        resources[10u].buffer_transient = depths_transient;
+        resources[11u].buffer_transient = conics_transient;
+        resources[12u].buffer_transient = compensations_transient;
+
+        compute->dispatch_shader_indirect(compute_interface, context, ctx->shader_ctx[gaussian_projection_slang],
+                                          resources, cull_counters_transient, 0u, "gaussian_projection");
+    }
 
-        grid_dim_t grid_dim = points_grid_dim;
+    // spherical harmonics of the refreshed chunks
+    {
+        pnanovdb_compute_resource_t resources[9u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = shader_params_transient;
+        resources[2u].buffer_transient = views_transient;
+        resources[3u].buffer_transient = sh_0_transient;
+        resources[4u].buffer_transient = sh_n_transient;
+        resources[5u].buffer_transient = cull_counters_transient;
+        resources[6u].buffer_transient = sh_refresh_chunks_transient;
+        resources[7u].buffer_transient = chunk_indices_transient;
+        resources[8u].buffer_transient = resolved_color_transient;
+
+        compute->dispatch_shader_indirect(compute_interface, context,
+                                          ctx->shader_ctx[gaussian_spherical_harmonics_slang], resources,
+                                          cull_counters_transient, s_cull_counter_sh_args * 4u,
+                                          "gaussian_spherical_harmonics");
+    }
+
+    // sort the visible order by the new depths, overlapping windows fix up the small moves
+    if (coherent_sort)
+    {
+        for (pnanovdb_uint32_t pass_idx = 0u; pass_idx < k_coherent_sort_fixup_passes; pass_idx++)
+        {
+            // odd passes shift the windows by half
+            pnanovdb_compute_buffer_transient_t* fixup_params_transient =
+                compute_interface->register_buffer_as_transient(context, ctx->sort_fixup_params_buffers[pass_idx & 1u]);
 
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_spherical_harmonics_slang],
-                                 resources, grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_spherical_harmonics");
+            pnanovdb_compute_resource_t resources[6u] = {};
+            resources[0u].buffer_transient = constant_transient;
+            resources[1u].buffer_transient = fixup_params_transient;
+            resources[2u].buffer_transient = radii_transient;
+            resources[3u].buffer_transient = depths_transient;
+            resources[4u].buffer_transient = cull_counters_transient;
+            resources[5u].buffer_transient = visible_order_transient;
+
+            compute->dispatch_shader_indirect(compute_interface, context, ctx->shader_ctx[gaussian_sort_fixup_slang],
+                                              resources, cull_counters_transient, 0u, "gaussian_sort_fixup");
+        }
+
+        // pairs still out of order decide between the tile only sort and the full sort
+        {
+            pnanovdb_compute_resource_t resources[6u] = {};
+            resources[0u].buffer_transient = constant_transient;
+            resources[1u].buffer_transient = radii_transient;
+            resources[2u].buffer_transient = depths_transient;
+            resources[3u].buffer_transient = visible_order_transient;
+            resources[4u].buffer_transient = cull_counters_transient;
+            resources[5u].buffer_transient = compute_interface->register_buffer_as_transient(context, sort_keys_buffer);
+
+            grid_dim_t grid_dim = points_grid_dim;
+
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_sort_check_slang], resources,
+                                     grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_sort_check");
+        }
     }
 
     // counts tiles
     {
-        pnanovdb_compute_resource_t resources[5u] = {};
+        pnanovdb_compute_resource_t resources[7u] = {};
         resources[0u].buffer_transient = constant_transient;
         resources[1u].buffer_transient = shader_params_transient;
         resources[2u].buffer_transient = means2d_transient;
         resources[3u].buffer_transient = radii_transient;
-        resources[4u].buffer_transient = num_tiles_per_gaussian_transient;
+        resources[4u].buffer_transient = cull_counters_transient;
+        resources[5u].buffer_transient = visible_order_transient;
+        resources[6u].buffer_transient = num_tiles_per_gaussian_transient;
 
-        grid_dim_t grid_dim = points_grid_dim;
-
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_count_tiles_slang], resources,
-                                 grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_count_tiles");
+        compute->dispatch_shader_indirect(compute_interface, context, ctx->shader_ctx[gaussian_count_tiles_slang],
+                                          resources, cull_counters_transient, 0u, "gaussian_count_tiles");
     }
 
-    // prefix sum tile counts
+    // prefix sum tile counts, sized for all instances since the visible count stays on the device
     {
         ctx->parallel_primitives.global_scan(compute, queue, ctx->parallel_primitives_ctx, num_tiles_per_gaussian_buffer,
-                                             scan_tiles_per_gaussian_buffer, constants.prim_count, 1u);
+                                             scan_tiles_per_gaussian_buffer, (pnanovdb_uint32_t)instance_count_64, 1u);
     }
 
-    // readback total count, allocate key/val buffers
+    // total intersections of the visible gaussians
+    {
+        pnanovdb_compute_resource_t resources[2u] = {};
+        resources[0u].buffer_transient =
+            compute_interface->register_buffer_as_transient(context, scan_tiles_per_gaussian_buffer);
+        resources[1u].buffer_transient = cull_counters_transient;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_cull_finalize_slang], resources,
+                                 1u, 1u, 1u, "gaussian_cull_finalize");
+    }
+
+    // readback visible and total counts, allocate key/val buffers
     pnanovdb_uint32_t total_count = 0u;
+    pnanovdb_uint32_t visible_count = 0u;
+    pnanovdb_uint32_t sort_inversions = 0u;
     {
         buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
         buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
         buf_desc.structure_stride = 4u;
-        buf_desc.size_in_bytes = 4u;
+        buf_desc.size_in_bytes = 20u;
         pnanovdb_compute_buffer_t* readback_buffer =
             compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK, &buf_desc);
 
         pnanovdb_compute_copy_buffer_params_t copy_params = {};
-        copy_params.num_bytes = 4u; // uint32_t
-        copy_params.src = compute_interface->register_buffer_as_transient(context, scan_tiles_per_gaussian_buffer);
-        copy_params.src_offset = (prim_count_64 - 1u) * 4u;
+        copy_params.num_bytes = 20u; // visible points, visible chunks, intersections, sort inversions, SH chunks
+        copy_params.src = cull_counters_transient;
+        copy_params.src_offset = s_cull_counter_visible_points * 4u;
         copy_params.dst = compute_interface->register_buffer_as_transient(context, readback_buffer);
         copy_params.dst_offset = 0u;
         copy_params.debug_label = "raster_2d_feedback_copy";
@@ -392,7 +694,28 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
 
         pnanovdb_uint32_t* mapped = (pnanovdb_uint32_t*)compute_interface->map_buffer(context, readback_buffer);
 
-        total_count = mapped[0u];
+        visible_count = mapped[0u];
+        total_count = mapped[2u];
+        sort_inversions = mapped[3u];
+
+        if (visible_count != 0u)
+        {
+            data->splat_radius_2d =
+                tile_variant_splat_radius(tile_variant, float(total_count) / float(visible_count));
+        }
+
+        ctx->cull_stats.point_count += data->point_count * view_count;
+        ctx->cull_stats.visible_point_count += mapped[0u];
+        ctx->cull_stats.chunk_count += data->chunk_count * view_count;
+        ctx->cull_stats.visible_chunk_count += mapped[1u];
+        ctx->cull_stats.intersection_count += total_count;
+        ctx->cull_stats.sh_refresh_chunk_count += mapped[4u];
+        ctx->cull_stats.raster_count += view_count;
+        if (coherent_sort)
+        {
+            ctx->cull_stats.coherent_sort_count++;
+            ctx->cull_stats.coherent_fallback_count += sort_inversions != 0u ? 1u : 0u;
+        }
 
         compute_interface->unmap_buffer(context, readback_buffer);
 
@@ -403,6 +726,7 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
     grid_dim_t isect_grid_dim = compute_dispatch_grid_dim((total_count + 255u) / 256u);
     constants.n_isects = total_count;
     constants.isects_grid_dim_x = isect_grid_dim.x;
+    constants.tile_split_capacity = tile_split_capacity(total_count, tile_variant.width * tile_variant.height);
 
     // printf("raster_2d total_intersections(%u)\n", total_count);
 
@@ -440,6 +764,32 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
         compute_interface->register_buffer_as_transient(context, num_tiles_per_gaussian_buffer);
     scan_tiles_per_gaussian_transient =
         compute_interface->register_buffer_as_transient(context, scan_tiles_per_gaussian_buffer);
+    cull_counters_transient = compute_interface->register_buffer_as_transient(context, cull_counters_buffer);
+    visible_indices_transient = compute_interface->register_buffer_as_transient(context, visible_indices_buffer);
+    visible_order_transient = compute_interface->register_buffer_as_transient(context, visible_order_buffer);
+
+    if (coherent_sort)
+    {
+        // the window fixup could not keep up, sort the visible order exactly so the next frame starts sorted
+        if (sort_inversions != 0u)
+        {
+            ctx->parallel_primitives.radix_sort(compute, queue, ctx->parallel_primitives_ctx, sort_keys_buffer,
+                                                visible_order_buffer, visible_count, prim_count_64, 32u);
+        }
+
+        // gaussians leaving the view keep their place in the depth order for when they return
+        pnanovdb_compute_resource_t resources[4u] = {};
+        resources[0u].buffer_transient = constant_transient;
+        resources[1u].buffer_transient = compute_interface->register_buffer_as_transient(context, visible_scan_buffer);
+        resources[2u].buffer_transient = visible_order_transient;
+        resources[3u].buffer_transient =
+            compute_interface->register_buffer_as_transient(context, data->depth_order_gpu_array->device_buffer);
+
+        grid_dim_t grid_dim = points_grid_dim;
+
+        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_sort_merge_slang], resources,
+                                 grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_sort_merge");
+    }
 
     if (total_count != 0u)
     {
@@ -475,21 +825,22 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
 
         // tile intersections
         {
-            pnanovdb_compute_resource_t resources[9u] = {};
+            pnanovdb_compute_resource_t resources[11u] = {};
             resources[0u].buffer_transient = constant_transient;
             resources[1u].buffer_transient = shader_params_transient;
             resources[2u].buffer_transient = means2d_transient;
             resources[3u].buffer_transient = radii_transient;
             resources[4u].buffer_transient = depths_transient;
             resources[5u].buffer_transient = scan_tiles_per_gaussian_transient;
-            resources[6u].buffer_transient = intersection_keys_low_transient;
-            resources[7u].buffer_transient = intersection_keys_high_transient;
-            resources[8u].buffer_transient = intersection_vals_transient;
-
-            grid_dim_t grid_dim = points_grid_dim;
-
-            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_tile_intersections_slang],
-                                     resources, grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_tile_intersections");
+            resources[6u].buffer_transient = cull_counters_transient;
+            resources[7u].buffer_transient = visible_order_transient;
+            resources[8u].buffer_transient = intersection_keys_low_transient;
+            resources[9u].buffer_transient = intersection_keys_high_transient;
+            resources[10u].buffer_transient = intersection_vals_transient;
+
+            compute->dispatch_shader_indirect(compute_interface, context,
+                                              ctx->shader_ctx[gaussian_tile_intersections_slang], resources,
+                                              cull_counters_transient, 0u, "gaussian_tile_intersections");
         }
 
         // radix sort
@@ -500,10 +851,20 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
                 num_tile_id_bits++;
             }
 
-            ctx->parallel_primitives.radix_sort_dual_key(compute, queue, ctx->parallel_primitives_ctx,
-                                                         intersection_keys_low_buffer, intersection_keys_high_buffer,
-                                                         intersection_vals_buffer, constants.n_isects, max_isects_count,
-                                                         32u, num_tile_id_bits);
+            if (coherent_sort && sort_inversions == 0u)
+            {
+                // intersections were emitted in depth order, the stable sort by tile keeps it within each tile
+                ctx->parallel_primitives.radix_sort(compute, queue, ctx->parallel_primitives_ctx,
+                                                    intersection_keys_high_buffer, intersection_vals_buffer,
+                                                    constants.n_isects, max_isects_count, num_tile_id_bits);
+            }
+            else
+            {
+                ctx->parallel_primitives.radix_sort_dual_key(
+                    compute, queue, ctx->parallel_primitives_ctx, intersection_keys_low_buffer,
+                    intersection_keys_high_buffer, intersection_vals_buffer, constants.n_isects, max_isects_count, 32u,
+                    num_tile_id_bits);
+            }
         }
 
         buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
@@ -534,28 +895,110 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
                                      resources, grid_dim.x, grid_dim.y, grid_dim.z, "gaussian_tile_offsets");
         }
 
+        pnanovdb_uint32_t tile_pixels = tile_variant.width * tile_variant.height;
+
+        // tile work counters and work items, split items take the first tile_split_capacity entries
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED |
+                         PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC | PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST;
+        buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+        buf_desc.structure_stride = 4u;
+        buf_desc.size_in_bytes = s_tile_work_counters_size;
+        pnanovdb_compute_buffer_t* tile_work_counters_buffer =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED | PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED;
+        buf_desc.structure_stride = 16u;
+        buf_desc.size_in_bytes = 16u * (pnanovdb_uint64_t(constants.num_tiles) + constants.tile_split_capacity);
+        pnanovdb_compute_buffer_t* tile_work_items_buffer =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+        buf_desc.structure_stride = 8u;
+        buf_desc.size_in_bytes = 8u * pnanovdb_uint64_t(constants.num_tiles);
+        pnanovdb_compute_buffer_t* tile_splits_buffer =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+        buf_desc.structure_stride = 16u;
+        buf_desc.size_in_bytes = 16u * pnanovdb_uint64_t(tile_pixels) *
+                                 (constants.tile_split_capacity == 0u ? 1u : constants.tile_split_capacity);
+        pnanovdb_compute_buffer_t* tile_partials_buffer =
+            compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
+
+        pnanovdb_compute_buffer_transient_t* tile_work_counters_transient =
+            compute_interface->register_buffer_as_transient(context, tile_work_counters_buffer);
+        pnanovdb_compute_buffer_transient_t* tile_work_items_transient =
+            compute_interface->register_buffer_as_transient(context, tile_work_items_buffer);
+        pnanovdb_compute_buffer_transient_t* tile_splits_transient =
+            compute_interface->register_buffer_as_transient(context, tile_splits_buffer);
+        pnanovdb_compute_buffer_transient_t* tile_partials_transient =
+            compute_interface->register_buffer_as_transient(context, tile_partials_buffer);
+
+        {
+            pnanovdb_compute_copy_buffer_params_t copy_params = {};
+            copy_params.num_bytes = s_tile_work_counters_size;
+            copy_params.src = compute_interface->register_buffer_as_transient(context, cull_counters_upload_buffer);
+            copy_params.dst = tile_work_counters_transient;
+            copy_params.debug_label = "gaussian_tile_work_clear";
+            compute_interface->copy_buffer(context, &copy_params);
+        }
+
+        // split tiles with many intersections into work items, histogram of the tile loads
+        {
+            pnanovdb_compute_resource_t resources[5u] = {};
+            resources[0u].buffer_transient = constant_transient;
+            resources[1u].buffer_transient = tile_offsets_transient;
+            resources[2u].buffer_transient = tile_work_counters_transient;
+            resources[3u].buffer_transient = tile_work_items_transient;
+            resources[4u].buffer_transient = tile_splits_transient;
+
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_tile_work_slang], resources,
+                                     (constants.num_tiles + 255u) / 256u, 1u, 1u, "gaussian_tile_work");
+        }
+
         pnanovdb_compute_texture_transient_t* color_2d_transient =
             compute_interface->register_texture_as_transient(context, color_2d);
 
-        // raster
+        // raster, persistent workgroups pull work items until the queue is empty
         {
-            pnanovdb_compute_resource_t resources[9u] = {};
+            pnanovdb_compute_resource_t resources[11u] = {};
             resources[0u].buffer_transient = constant_transient;
             resources[1u].buffer_transient = shader_params_transient;
             resources[2u].buffer_transient = means2d_transient;
             resources[3u].buffer_transient = conics_transient;
             resources[4u].buffer_transient = resolved_color_transient;
             resources[5u].buffer_transient = opacities_transient;
-            resources[6u].buffer_transient = tile_offsets_transient;
-            resources[7u].buffer_transient = intersection_vals_transient;
-            resources[8u].texture_transient = color_2d_transient;
-
-            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_rasterize_2d_slang], resources,
-                                     (constants.image_height + gpu_params.tile_size - 1u) / gpu_params.tile_size,
-                                     (constants.image_width + gpu_params.tile_size - 1u) / gpu_params.tile_size, 1u,
-                                     "gaussian_rasterize_2d");
+            resources[6u].buffer_transient = intersection_vals_transient;
+            resources[7u].buffer_transient = tile_work_items_transient;
+            resources[8u].buffer_transient = tile_work_counters_transient;
+            resources[9u].buffer_transient = tile_partials_transient;
+            resources[10u].texture_transient = color_2d_transient;
+
+            pnanovdb_uint32_t group_count =
+                tile_persistent_groups(constants.num_tiles, constants.tile_split_capacity, tile_pixels);
+
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[tile_variant.shader], resources,
+                                     group_count, 1u, 1u, "gaussian_rasterize_2d");
+        }
+
+        // composite the partials of split tiles front to back over the background
+        if (constants.tile_split_capacity != 0u)
+        {
+            pnanovdb_compute_resource_t resources[4u] = {};
+            resources[0u].buffer_transient = constant_transient;
+            resources[1u].buffer_transient = tile_splits_transient;
+            resources[2u].buffer_transient = tile_partials_transient;
+            resources[3u].texture_transient = color_2d_transient;
+
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_tile_merge_slang], resources,
+                                     (image_width + 15u) / 16u, (image_height + 15u) / 16u, view_count,
+                                     "gaussian_tile_merge");
         }
 
+        accumulate_tile_stats(compute, queue, ctx);
+        compute->enqueue_readback(
+            compute, queue, ctx->tile_stats_readback, tile_work_counters_transient, s_tile_work_counters_size);
+
+        compute_interface->destroy_buffer(context, tile_work_counters_buffer);
+        compute_interface->destroy_buffer(context, tile_work_items_buffer);
+        compute_interface->destroy_buffer(context, tile_splits_buffer);
+        compute_interface->destroy_buffer(context, tile_partials_buffer);
         compute_interface->destroy_buffer(context, tile_offsets_buffer);
         compute_interface->destroy_buffer(context, intersection_keys_low_buffer);
         compute_interface->destroy_buffer(context, intersection_keys_high_buffer);
@@ -573,10 +1016,8 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
             resources[1u].buffer_transient = shader_params_transient;
             resources[2u].texture_transient = color_2d_transient;
 
-            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[gaussian_rasterize_2d_null_slang],
-                                     resources,
-                                     (constants.image_height + gpu_params.tile_size - 1u) / gpu_params.tile_size,
-                                     (constants.image_width + gpu_params.tile_size - 1u) / gpu_params.tile_size, 1u,
+            compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[tile_variant.null_shader], resources,
+                                     constants.num_tiles_h, constants.num_tiles_w, view_count,
                                      "gaussian_rasterize_2d_null");
         }
     }
@@ -612,15 +1053,94 @@ void raster_gaussian_2d(const pnanovdb_compute_t* compute,
 
     compute_interface->destroy_buffer(context, constant_buffer);
     compute_interface->destroy_buffer(context, shader_params_buffer);
+    compute_interface->destroy_buffer(context, views_buffer);
 
     compute_interface->destroy_buffer(context, radii_buffer);
     compute_interface->destroy_buffer(context, means2d_buffer);
     compute_interface->destroy_buffer(context, depths_buffer);
     compute_interface->destroy_buffer(context, conics_buffer);
     compute_interface->destroy_buffer(context, compensations_buffer);
-    compute_interface->destroy_buffer(context, resolved_color_buffer);
     compute_interface->destroy_buffer(context, num_tiles_per_gaussian_buffer);
     compute_interface->destroy_buffer(context, scan_tiles_per_gaussian_buffer);
+    compute_interface->destroy_buffer(context, visible_indices_buffer);
+    compute_interface->destroy_buffer(context, sh_refresh_chunks_buffer);
+    if (view_colors_buffer)
+    {
+        compute_interface->destroy_buffer(context, view_colors_buffer);
+    }
+    compute_interface->destroy_buffer(context, cull_counters_buffer);
+    compute_interface->destroy_buffer(context, cull_counters_upload_buffer);
+    if (coherent_sort)
+    {
+        compute_interface->destroy_buffer(context, sort_keys_buffer);
+        compute_interface->destroy_buffer(context, visible_scan_buffer);
+    }
+}
+
+void raster_gaussian_2d(const pnanovdb_compute_t* compute,
+                        pnanovdb_compute_queue_t* queue,
+                        pnanovdb_raster_context_t* context_in,
+                        pnanovdb_raster_gaussian_data_t* data_in,
+                        pnanovdb_compute_texture_t* color_2d,
+                        pnanovdb_uint32_t image_width,
+                        pnanovdb_uint32_t image_height,
+                        const pnanovdb_camera_mat_t* view,
+                        const pnanovdb_camera_mat_t* projection,
+                        const pnanovdb_raster_shader_params_t* shader_params,
+                        pnanovdb_uint32_t composite)
+{
+    if (shader_params == nullptr)
+    {
+        return;
+    }
+    raster_gaussian_2d_batch(compute, queue, context_in, data_in, color_2d, image_width, image_height, view, projection,
+                             1u, 0u, 1u, shader_params, composite);
+}
+
+void raster_gaussian_2d_views(const pnanovdb_compute_t* compute,
+                              pnanovdb_compute_queue_t* queue,
+                              pnanovdb_raster_context_t* context_in,
+                              pnanovdb_raster_gaussian_data_t* data_in,
+                              pnanovdb_compute_texture_t* color_2d_atlas,
+                              pnanovdb_uint32_t image_width,
+                              pnanovdb_uint32_t image_height,
+                              const pnanovdb_camera_mat_t* views,
+                              const pnanovdb_camera_mat_t* projections,
+                              pnanovdb_uint32_t view_count,
+                              pnanovdb_uint32_t atlas_columns,
+                              const pnanovdb_raster_shader_params_t* shader_params,
+                              pnanovdb_uint32_t composite)
+{
+    if (shader_params == nullptr || views == nullptr || projections == nullptr || view_count == 0u)
+    {
+        return;
+    }
+    auto data = cast(data_in);
+    if (atlas_columns == 0u)
+    {
+        atlas_columns = view_count;
+    }
+
+    // one readback and sync per batch instead of per view
+    pnanovdb_uint32_t batch_size = multi_view_batch_size(data->point_count, view_count);
+    for (pnanovdb_uint32_t view_offset = 0u; view_offset < view_count; view_offset += batch_size)
+    {
+        pnanovdb_uint32_t batch_count = view_count - view_offset < batch_size ? view_count - view_offset : batch_size;
+        raster_gaussian_2d_batch(compute, queue, context_in, data_in, color_2d_atlas, image_width, image_height,
+                                 views + view_offset, projections + view_offset, batch_count, view_offset,
+                                 atlas_columns, shader_params, composite);
+    }
+}
+
+void get_gaussian_cull_stats(pnanovdb_raster_context_t* context_in, pnanovdb_raster_gaussian_cull_stats_t* dst_stats)
+{
+    auto ctx = cast(context_in);
+    if (!ctx || !dst_stats)
+    {
+        return;
+    }
+    *dst_stats = ctx->cull_stats;
+    ctx->cull_stats = {};
 }
 
 }
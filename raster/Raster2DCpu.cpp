@@ -0,0 +1,85 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/Raster2DCpu.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief
+*/
+
+#define PNANOVDB_BUF_BOUNDS_CHECK
+#include "Raster.h"
+
+#include <stdio.h>
+
+namespace pnanovdb_raster
+{
+
+// shared by all rasters of the process, parallel_for calls from several threads run one after another
+static pnanovdb_util::WorkStealingPool& cpu_raster_pool()
+{
+    static pnanovdb_util::WorkStealingPool pool;
+    return pool;
+}
+
+void raster_gaussian_2d_cpu(const pnanovdb_compute_t* compute,
+                            pnanovdb_raster_gaussian_data_t* data_in,
+                            pnanovdb_compute_array_t* color_2d,
+                            pnanovdb_uint32_t image_width,
+                            pnanovdb_uint32_t image_height,
+                            const pnanovdb_camera_mat_t* view,
+                            const pnanovdb_camera_mat_t* projection,
+                            const pnanovdb_raster_shader_params_t* shader_params,
+                            pnanovdb_uint32_t composite)
+{
+    if (!data_in || !color_2d || !view || !projection || !shader_params)
+    {
+        return;
+    }
+    auto data = cast(data_in);
+
+    if (color_2d->element_size * color_2d->element_count < 4u * sizeof(float) * image_width * image_height)
+    {
+        printf("Error: raster_gaussian_2d_cpu color_2d holds less than %u x %u float RGBA texels\n", image_width,
+               image_height);
+        return;
+    }
+
+    cpu_raster_gaussians_t gaussians = {};
+    gaussians.point_count = data->point_count;
+    gaussians.means = (const float*)data->means_cpu_array->data;
+    gaussians.quaternions = (const float*)data->quaternions_cpu_array->data;
+    gaussians.scales = (const float*)data->scales_cpu_array->data;
+    gaussians.opacities = (const float*)data->opacities_cpu_array->data;
+    gaussians.sh_0 = (const float*)data->sh_0_cpu_array->data;
+    gaussians.sh_n = (const float*)data->sh_n_cpu_array->data;
+    gaussians.sh_stride = data->sh_stride;
+    gaussians.chunk_count = data->chunk_count;
+    gaussians.chunk_indices = (const pnanovdb_uint32_t*)data->chunk_indices_cpu_array->data;
+    gaussians.chunk_bounds = (const gaussian_chunk_bounds_t*)data->chunk_bounds_cpu_array->data;
+
+    // the tile variant of an explicit tile_size, as the GPU would pick it, the cost model only fits the GPU
+    const tile_variant_t& tile_variant =
+        k_tile_variants[shader_params->tile_size != 0u ?
+                            select_tile_variant(shader_params->tile_size, image_width, image_height, 0.f) :
+                            k_tile_variant_default];
+
+    cpu_raster_params_t params = {};
+    params.eps2d = shader_params->eps2d;
+    params.radius_clip = shader_params->min_radius_2d;
+    params.cull_radius_2d = shader_params->cull_radius_2d;
+    params.sh_degree = cpu_raster_sh_degree(shader_params->sh_degree_override, data->sh_stride);
+    params.sh_stride_rgbrgbrgb = shader_params->sh_stride_rgbrgbrgb_override;
+    params.tile_width = tile_variant.width;
+    params.tile_height = tile_variant.height;
+    params.composite = composite;
+
+    cpu_raster_camera_t camera = cpu_raster_camera(*view, *projection, image_width, image_height);
+
+    cpu_raster_splats_t splats;
+    cpu_raster_gaussian_2d(cpu_raster_pool(), gaussians, camera, params, splats, (float*)color_2d->data);
+}
+
+}
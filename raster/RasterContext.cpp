@@ -41,6 +41,31 @@ pnanovdb_raster_context_t* create_context(const pnanovdb_compute_t* compute, pna
         return nullptr;
     }
 
+    ctx->tile_stats_readback = compute->create_readback_queue(0u);
+
+    // the fixup passes only alternate between two window offsets, so their constants never change
+    {
+        pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+        pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+
+        pnanovdb_compute_buffer_desc_t buf_desc = {};
+        buf_desc.usage = PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT;
+        buf_desc.format = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
+        buf_desc.structure_stride = 0u;
+        buf_desc.size_in_bytes = sizeof(coherent_sort_fixup_params_t);
+        for (pnanovdb_uint32_t idx = 0u; idx < 2u; idx++)
+        {
+            coherent_sort_fixup_params_t fixup_params = {};
+            fixup_params.window_offset = idx * (k_coherent_sort_window / 2u);
+
+            ctx->sort_fixup_params_buffers[idx] =
+                compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD, &buf_desc);
+            void* mapped_fixup_params = compute_interface->map_buffer(context, ctx->sort_fixup_params_buffers[idx]);
+            memcpy(mapped_fixup_params, &fixup_params, sizeof(coherent_sort_fixup_params_t));
+            compute_interface->unmap_buffer(context, ctx->sort_fixup_params_buffers[idx]);
+        }
+    }
+
     pnanovdb_compiler_settings_t compile_settings = {};
     pnanovdb_compiler_settings_init(&compile_settings);
 
@@ -81,6 +106,15 @@ void destroy_context(const pnanovdb_compute_t* compute,
         compute->destroy_shader_context(compute, queue, ctx->shader_ctx[idx]);
     }
 
+    compute->destroy_readback_queue(compute, queue, ctx->tile_stats_readback);
+
+    pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
+    pnanovdb_compute_context_t* context = compute->device_interface.get_compute_context(queue);
+    for (pnanovdb_uint32_t idx = 0u; idx < 2u; idx++)
+    {
+        compute_interface->destroy_buffer(context, ctx->sort_fixup_params_buffers[idx]);
+    }
+
     ctx->parallel_primitives.destroy_context(compute, queue, ctx->parallel_primitives_ctx);
     pnanovdb_parallel_primitives_free(&ctx->parallel_primitives);
     ctx->grid_build.destroy_context(compute, queue, ctx->grid_build_ctx);
@@ -125,6 +159,37 @@ pnanovdb_raster_gaussian_data_t* create_gaussian_data(const pnanovdb_compute_t*
         ptr->sh_n_cpu_array = compute->create_array(0u, 0u, nullptr);
     }
     ptr->opacities_cpu_array = compute->create_array(opacities->element_size, opacities->element_count, opacities->data);
+
+    // chunks of nearby gaussians, culled as a whole before projection
+    ptr->chunk_count = (ptr->point_count + k_gaussian_chunk_size - 1u) / k_gaussian_chunk_size;
+    ptr->chunk_indices_cpu_array = compute->create_array(sizeof(pnanovdb_uint32_t), ptr->point_count, nullptr);
+    ptr->chunk_bounds_cpu_array = compute->create_array(sizeof(gaussian_chunk_bounds_t), ptr->chunk_count, nullptr);
+    sort_gaussians_morton((const float*)ptr->means_cpu_array->data, ptr->point_count,
+                          (pnanovdb_uint32_t*)ptr->chunk_indices_cpu_array->data);
+    compute_gaussian_chunk_bounds((const float*)ptr->means_cpu_array->data, (const float*)ptr->scales_cpu_array->data,
+                                  (const pnanovdb_uint32_t*)ptr->chunk_indices_cpu_array->data, ptr->point_count,
+                                  (gaussian_chunk_bounds_t*)ptr->chunk_bounds_cpu_array->data);
+
+    // camera motion of the coherent tile sort is measured relative to the distance to this
+    float bbox_min[3] = { INFINITY, INFINITY, INFINITY };
+    float bbox_max[3] = { -INFINITY, -INFINITY, -INFINITY };
+    const gaussian_chunk_bounds_t* chunk_bounds = (const gaussian_chunk_bounds_t*)ptr->chunk_bounds_cpu_array->data;
+    for (pnanovdb_uint64_t chunk_idx = 0u; chunk_idx < ptr->chunk_count; chunk_idx++)
+    {
+        const gaussian_chunk_bounds_t& chunk = chunk_bounds[chunk_idx];
+        bbox_min[0] = std::min(bbox_min[0], chunk.x - chunk.radius);
+        bbox_min[1] = std::min(bbox_min[1], chunk.y - chunk.radius);
+        bbox_min[2] = std::min(bbox_min[2], chunk.z - chunk.radius);
+        bbox_max[0] = std::max(bbox_max[0], chunk.x + chunk.radius);
+        bbox_max[1] = std::max(bbox_max[1], chunk.y + chunk.radius);
+        bbox_max[2] = std::max(bbox_max[2], chunk.z + chunk.radius);
+    }
+    if (ptr->chunk_count > 0u)
+    {
+        ptr->bounds_center = { 0.5f * (bbox_min[0] + bbox_max[0]), 0.5f * (bbox_min[1] + bbox_max[1]),
+                               0.5f * (bbox_min[2] + bbox_max[2]) };
+    }
+
     ptr->shader_params_cpu_arrays = new pnanovdb_compute_array_t*[shader_param_count];
 
     for (pnanovdb_uint32_t idx = 0u; idx < shader_param_count; idx++)
@@ -151,8 +216,24 @@ pnanovdb_raster_gaussian_data_t* create_gaussian_data(const pnanovdb_compute_t*
     ptr->sh_0_gpu_array = gpu_array_create();
     ptr->sh_n_gpu_array = gpu_array_create();
     ptr->opacities_gpu_array = gpu_array_create();
+    ptr->chunk_indices_gpu_array = gpu_array_create();
+    ptr->chunk_bounds_gpu_array = gpu_array_create();
+    ptr->depth_order_gpu_array = gpu_array_create();
+    ptr->depth_order_scratch_gpu_array = gpu_array_create();
+    ptr->sh_colors_gpu_array = gpu_array_create();
+    ptr->sh_chunk_dirs_gpu_array = gpu_array_create();
     ptr->shader_params_gpu_arrays = new compute_gpu_array_t*[shader_param_count];
 
+    // without a queue the data is only rasterized on the host by raster_gaussian_2d_cpu
+    if (!queue)
+    {
+        for (pnanovdb_uint32_t idx = 0u; idx < shader_param_count; idx++)
+        {
+            ptr->shader_params_gpu_arrays[idx] = gpu_array_create();
+        }
+        return cast(ptr);
+    }
+
     pnanovdb_compute_interface_t* compute_interface = compute->device_interface.get_compute_interface(queue);
     pnanovdb_compute_context_t* compute_context = compute->device_interface.get_compute_context(queue);
     pnanovdb_compute_buffer_desc_t buf_desc = {};
@@ -217,6 +298,11 @@ void upload_gaussian_data(const pnanovdb_compute_t* compute,
         gpu_array_upload(compute, queue, ptr->sh_0_gpu_array, ptr->sh_0_cpu_array);
         gpu_array_upload(compute, queue, ptr->sh_n_gpu_array, ptr->sh_n_cpu_array);
         gpu_array_upload(compute, queue, ptr->opacities_gpu_array, ptr->opacities_cpu_array);
+        gpu_array_upload(compute, queue, ptr->chunk_indices_gpu_array, ptr->chunk_indices_cpu_array);
+        gpu_array_upload(compute, queue, ptr->chunk_bounds_gpu_array, ptr->chunk_bounds_cpu_array);
+
+        // new SH coefficients
+        ptr->sh_cache_valid = PNANOVDB_FALSE;
 
         for (pnanovdb_uint32_t idx = 0u; idx < shader_param_count; idx++)
         {
@@ -228,6 +314,65 @@ void upload_gaussian_data(const pnanovdb_compute_t* compute,
     }
 }
 
+void evict_gaussian_data(const pnanovdb_compute_t* compute,
+                         pnanovdb_compute_queue_t* queue,
+                         pnanovdb_raster_gaussian_data_t* data)
+{
+    if (!data)
+    {
+        return;
+    }
+
+    auto ptr = cast(data);
+    if (!ptr->has_uploaded)
+    {
+        return;
+    }
+    ptr->has_uploaded = PNANOVDB_FALSE;
+
+    // buffers still referenced by frames in flight are released after the resource min lifetime
+    gpu_array_release(compute, queue, ptr->means_gpu_array);
+    gpu_array_release(compute, queue, ptr->quaternions_gpu_array);
+    gpu_array_release(compute, queue, ptr->scales_gpu_array);
+    gpu_array_release(compute, queue, ptr->colors_gpu_array);
+    gpu_array_release(compute, queue, ptr->sh_0_gpu_array);
+    gpu_array_release(compute, queue, ptr->sh_n_gpu_array);
+    gpu_array_release(compute, queue, ptr->opacities_gpu_array);
+    gpu_array_release(compute, queue, ptr->chunk_indices_gpu_array);
+    gpu_array_release(compute, queue, ptr->chunk_bounds_gpu_array);
+    gpu_array_release(compute, queue, ptr->depth_order_gpu_array);
+    gpu_array_release(compute, queue, ptr->depth_order_scratch_gpu_array);
+    gpu_array_release(compute, queue, ptr->sh_colors_gpu_array);
+    gpu_array_release(compute, queue, ptr->sh_chunk_dirs_gpu_array);
+    ptr->has_depth_order = PNANOVDB_FALSE;
+    ptr->sh_cache_valid = PNANOVDB_FALSE;
+}
+
+pnanovdb_uint64_t get_gaussian_data_resident_bytes(pnanovdb_raster_gaussian_data_t* data)
+{
+    if (!data)
+    {
+        return 0u;
+    }
+
+    auto ptr = cast(data);
+    pnanovdb_uint64_t bytes = 0u;
+    bytes += gpu_array_resident_bytes(ptr->means_gpu_array, ptr->means_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->quaternions_gpu_array, ptr->quaternions_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->scales_gpu_array, ptr->scales_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->colors_gpu_array, ptr->colors_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->sh_0_gpu_array, ptr->sh_0_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->sh_n_gpu_array, ptr->sh_n_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->opacities_gpu_array, ptr->opacities_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->chunk_indices_gpu_array, ptr->chunk_indices_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->chunk_bounds_gpu_array, ptr->chunk_bounds_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->depth_order_gpu_array, ptr->chunk_indices_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->depth_order_scratch_gpu_array, ptr->chunk_indices_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->sh_colors_gpu_array, ptr->colors_cpu_array);
+    bytes += gpu_array_resident_bytes(ptr->sh_chunk_dirs_gpu_array, ptr->chunk_bounds_cpu_array);
+    return bytes;
+}
+
 void destroy_gaussian_data(const pnanovdb_compute_t* compute,
                            pnanovdb_compute_queue_t* queue,
                            pnanovdb_raster_gaussian_data_t* data)
@@ -238,10 +383,14 @@ void destroy_gaussian_data(const pnanovdb_compute_t* compute,
     }
 
     auto ptr = cast(data);
-    auto context = compute->device_interface.get_compute_context(queue);
+    // host only data has no device buffers to wait for
+    auto context = queue ? compute->device_interface.get_compute_context(queue) : nullptr;
 
     // Set minLifetime to 0 so buffers are freed immediately
-    compute->device_interface.set_resource_min_lifetime(context, 0u);
+    if (context)
+    {
+        compute->device_interface.set_resource_min_lifetime(context, 0u);
+    }
 
     gpu_array_destroy(compute, queue, ptr->means_gpu_array);
     gpu_array_destroy(compute, queue, ptr->quaternions_gpu_array);
@@ -250,6 +399,12 @@ void destroy_gaussian_data(const pnanovdb_compute_t* compute,
     gpu_array_destroy(compute, queue, ptr->sh_0_gpu_array);
     gpu_array_destroy(compute, queue, ptr->sh_n_gpu_array);
     gpu_array_destroy(compute, queue, ptr->opacities_gpu_array);
+    gpu_array_destroy(compute, queue, ptr->chunk_indices_gpu_array);
+    gpu_array_destroy(compute, queue, ptr->chunk_bounds_gpu_array);
+    gpu_array_destroy(compute, queue, ptr->depth_order_gpu_array);
+    gpu_array_destroy(compute, queue, ptr->depth_order_scratch_gpu_array);
+    gpu_array_destroy(compute, queue, ptr->sh_colors_gpu_array);
+    gpu_array_destroy(compute, queue, ptr->sh_chunk_dirs_gpu_array);
 
     compute->destroy_array(ptr->means_cpu_array);
     compute->destroy_array(ptr->quaternions_cpu_array);
@@ -258,6 +413,8 @@ void destroy_gaussian_data(const pnanovdb_compute_t* compute,
     compute->destroy_array(ptr->sh_0_cpu_array);
     compute->destroy_array(ptr->sh_n_cpu_array);
     compute->destroy_array(ptr->opacities_cpu_array);
+    compute->destroy_array(ptr->chunk_indices_cpu_array);
+    compute->destroy_array(ptr->chunk_bounds_cpu_array);
 
     for (pnanovdb_uint32_t idx = 0u; idx < shader_param_count; idx++)
     {
@@ -272,10 +429,13 @@ void destroy_gaussian_data(const pnanovdb_compute_t* compute,
     delete[] ptr->shader_params_cpu_arrays;
     delete ptr;
 
-    compute->device_interface.wait_idle(queue);
+    if (context)
+    {
+        compute->device_interface.wait_idle(queue);
 
-    // Restore original minLifetime
-    compute->device_interface.set_resource_min_lifetime(context, 60u);
+        // Restore original minLifetime
+        compute->device_interface.set_resource_min_lifetime(context, 60u);
+    }
 }
 
 }
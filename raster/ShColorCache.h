@@ -0,0 +1,62 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/ShColorCache.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Cached SH colors of raster_gaussian_2d, host mirror of the refresh test in gaussian_cull_chunks.slang.
+
+    The SH of a gaussian are evaluated for the camera view direction. Each chunk keeps the direction its colors were
+    evaluated for, a visible chunk evaluates them again once the view turned further than sh_cache_angle. New SH
+    coefficients, sh_degree_override or sh_stride_rgbrgbrgb_override mark every chunk stale.
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Raster.h"
+
+#include <math.h>
+
+namespace pnanovdb_raster
+{
+// w of a chunk direction, 0 until the chunk evaluated its colors
+struct sh_chunk_dir_t
+{
+    float x;
+    float y;
+    float z;
+    float w;
+};
+
+// Cosine the view direction dot product is compared against, an angle of 0 refreshes every frame
+static inline float sh_cache_cos_tolerance(float angle_degrees)
+{
+    if (angle_degrees <= 0.f)
+    {
+        return 2.f;
+    }
+    return cosf(angle_degrees * 3.14159265358979f / 180.f);
+}
+
+// Whether the colors cached under the SH layout and degree of the last raster still apply
+static inline bool sh_cache_matches(bool valid,
+                                    pnanovdb_int32_t cached_degree,
+                                    pnanovdb_uint32_t cached_stride_rgbrgbrgb,
+                                    const pnanovdb_raster_shader_params_t& params)
+{
+    return valid && cached_degree == params.sh_degree_override &&
+           cached_stride_rgbrgbrgb == params.sh_stride_rgbrgbrgb_override;
+}
+
+// matches update_sh_cache in gaussian_cull_chunks.slang for a visible chunk
+static inline bool sh_chunk_needs_refresh(const sh_chunk_dir_t& cached_dir,
+                                          const pnanovdb_vec3_t& view_dir,
+                                          float cos_tolerance,
+                                          bool reset)
+{
+    float cos_angle = cached_dir.x * view_dir.x + cached_dir.y * view_dir.y + cached_dir.z * view_dir.z;
+    return reset || cached_dir.w == 0.f || cos_angle < cos_tolerance;
+}
+} // namespace pnanovdb_raster
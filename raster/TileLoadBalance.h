@@ -0,0 +1,90 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/TileLoadBalance.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Work items of the persistent gaussian_rasterize_2d shaders, host mirror of gaussian_tile_work.slang.
+
+    A tile with more than k_tile_split_threshold intersections is split into work items of k_tile_split_size
+    intersections. Each of them composites its range into a partial color and transmittance, gaussian_tile_merge
+    composites the partials of a tile front to back. Split items are queued before the whole tiles, so the longest
+    work starts first. Partial slots are bounded by the intersection count, tiles that do not fit stay whole.
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Raster.h"
+
+namespace pnanovdb_raster
+{
+static constexpr pnanovdb_uint32_t k_tile_split_threshold = 4096u;
+static constexpr pnanovdb_uint32_t k_tile_split_size = 2048u;
+// float4 partial per pixel of each split item
+static constexpr pnanovdb_uint64_t k_tile_partials_max_bytes = 32u * 1024u * 1024u;
+// threads of the persistent rasterizer, enough groups to fill the device at any tile size
+static constexpr pnanovdb_uint32_t k_tile_persistent_threads = 256u * 1024u;
+
+// matches gaussian_tile_work.slang, bin 0 counts empty tiles, bin b counts [2^(b-1), 2^b), the last bin the rest
+static inline pnanovdb_uint32_t tile_histogram_bin(pnanovdb_uint32_t isect_count)
+{
+    pnanovdb_uint32_t bin = 0u;
+    while (isect_count != 0u && bin < PNANOVDB_RASTER_TILE_HISTOGRAM_BINS - 1u)
+    {
+        isect_count >>= 1u;
+        bin++;
+    }
+    return bin;
+}
+
+// Work items of a tile, 1 unless it is split
+static inline pnanovdb_uint32_t tile_split_segments(pnanovdb_uint32_t isect_count)
+{
+    return isect_count > k_tile_split_threshold ? (isect_count + k_tile_split_size - 1u) / k_tile_split_size : 1u;
+}
+
+// Partial slots for all split tiles of n_isects intersections, ceil(c / size) < c / size + c / threshold per tile
+static inline pnanovdb_uint32_t tile_split_capacity(pnanovdb_uint64_t n_isects, pnanovdb_uint32_t tile_pixels)
+{
+    if (n_isects <= k_tile_split_threshold)
+    {
+        return 0u;
+    }
+    pnanovdb_uint64_t capacity = (n_isects + k_tile_split_size - 1u) / k_tile_split_size +
+                                 (n_isects + k_tile_split_threshold - 1u) / k_tile_split_threshold;
+    pnanovdb_uint64_t max_capacity = k_tile_partials_max_bytes / (16u * tile_pixels);
+    return (pnanovdb_uint32_t)(capacity < max_capacity ? capacity : max_capacity);
+}
+
+// Workgroups of the persistent rasterizer, never more than there are work items
+static inline pnanovdb_uint32_t tile_persistent_groups(pnanovdb_uint32_t num_tiles,
+                                                       pnanovdb_uint32_t split_capacity,
+                                                       pnanovdb_uint32_t tile_pixels)
+{
+    pnanovdb_uint32_t group_count = k_tile_persistent_threads / tile_pixels;
+    pnanovdb_uint32_t work_count = num_tiles + split_capacity;
+    return work_count < group_count ? work_count : group_count;
+}
+
+// front to back result of a range of intersections of one pixel, color is premultiplied by the range
+struct tile_partial_t
+{
+    float r;
+    float g;
+    float b;
+    float transmittance;
+};
+
+// matches gaussian_tile_merge.slang, back is composited behind front
+static inline tile_partial_t merge_tile_partial(const tile_partial_t& front, const tile_partial_t& back)
+{
+    tile_partial_t dst = {};
+    dst.r = front.r + front.transmittance * back.r;
+    dst.g = front.g + front.transmittance * back.g;
+    dst.b = front.b + front.transmittance * back.b;
+    dst.transmittance = front.transmittance * back.transmittance;
+    return dst;
+}
+} // namespace pnanovdb_raster
@@ -0,0 +1,125 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   nanovdb_editor/raster/TileVariants.h
+
+    \author Andrew Reidmeyer
+
+    \brief  Tile sizes of the specialized gaussian_rasterize_2d shaders and the choice between them.
+
+    Each variant is compiled with its own workgroup size, gaussian batch size and shared memory. With tile_size 0 the
+    variant is picked from a cost model of the image size and the average splat radius of the previous raster, an
+    intersection costs about as much as evaluating a gaussian at k_tile_isect_cost pixels. The 32x8 tile keeps 256
+    threads with a full warp per tile row, for isotropic splats it never costs less than 16x16 in the model and is
+    chosen with tile_size 32.
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Raster.h"
+
+#include <math.h>
+
+namespace pnanovdb_raster
+{
+struct tile_variant_t
+{
+    pnanovdb_uint32_t width;
+    pnanovdb_uint32_t height;
+    pnanovdb_uint32_t shader;
+    pnanovdb_uint32_t null_shader;
+};
+
+static constexpr pnanovdb_uint32_t k_tile_variant_count = 3u;
+static constexpr tile_variant_t k_tile_variants[k_tile_variant_count] = {
+    { 8u, 8u, gaussian_rasterize_2d_8x8_slang, gaussian_rasterize_2d_null_8x8_slang },
+    { 16u, 16u, gaussian_rasterize_2d_slang, gaussian_rasterize_2d_null_slang },
+    { 32u, 8u, gaussian_rasterize_2d_32x8_slang, gaussian_rasterize_2d_null_32x8_slang },
+};
+static constexpr pnanovdb_uint32_t k_tile_variant_default = 1u;
+
+// pixel evaluations per tile intersection, covers emitting, sorting and loading the intersection
+static constexpr float k_tile_isect_cost = 64.f;
+// fewer tiles than this leave the GPU partly idle, small images prefer smaller tiles
+static constexpr float k_tile_min_count = 2048.f;
+
+// Tiles covered by a splat of radius in pixels, the tile range is rounded out on both sides
+static inline float tile_variant_isects_per_splat(const tile_variant_t& variant, float radius)
+{
+    return (2.f * radius / float(variant.width) + 1.f) * (2.f * radius / float(variant.height) + 1.f);
+}
+
+// Inverse of tile_variant_isects_per_splat, the average radius from the intersections of a raster
+static inline float tile_variant_splat_radius(const tile_variant_t& variant, float isects_per_splat)
+{
+    if (isects_per_splat <= 1.f)
+    {
+        return 0.f;
+    }
+    // (a / w + 1) * (a / h + 1) = n with a = 2 * radius
+    float w = float(variant.width);
+    float h = float(variant.height);
+    float b = 1.f / w + 1.f / h;
+    float a = 0.5f * w * h * (sqrtf(b * b + 4.f * (isects_per_splat - 1.f) / (w * h)) - b);
+    return 0.5f * a;
+}
+
+// Estimated raster cost per splat in pixel evaluations, each pixel of a covered tile evaluates the splat
+static inline float tile_variant_cost(const tile_variant_t& variant,
+                                      pnanovdb_uint32_t image_width,
+                                      pnanovdb_uint32_t image_height,
+                                      float radius)
+{
+    float isects = tile_variant_isects_per_splat(variant, radius);
+    float cost = isects * (k_tile_isect_cost + float(variant.width * variant.height));
+    float tile_count = float((image_width + variant.width - 1u) / variant.width) *
+                       float((image_height + variant.height - 1u) / variant.height);
+    if (tile_count < k_tile_min_count)
+    {
+        cost *= k_tile_min_count / tile_count;
+    }
+    return cost;
+}
+
+// Variant index, tile_size picks the variant of that width, 0 picks by cost, splat_radius 0 means unknown
+static inline pnanovdb_uint32_t select_tile_variant(pnanovdb_uint32_t tile_size,
+                                                    pnanovdb_uint32_t image_width,
+                                                    pnanovdb_uint32_t image_height,
+                                                    float splat_radius)
+{
+    if (tile_size != 0u)
+    {
+        pnanovdb_uint32_t best = k_tile_variant_default;
+        pnanovdb_uint32_t best_diff = ~0u;
+        for (pnanovdb_uint32_t idx = 0u; idx < k_tile_variant_count; idx++)
+        {
+            pnanovdb_uint32_t width = k_tile_variants[idx].width;
+            pnanovdb_uint32_t diff = width > tile_size ? width - tile_size : tile_size - width;
+            if (diff < best_diff)
+            {
+                best = idx;
+                best_diff = diff;
+            }
+        }
+        return best;
+    }
+    if (splat_radius <= 0.f)
+    {
+        // the default tile wins for splats about its size unless the image is small
+        splat_radius = float(k_tile_variants[k_tile_variant_default].width);
+    }
+    pnanovdb_uint32_t best = k_tile_variant_default;
+    float best_cost = tile_variant_cost(k_tile_variants[best], image_width, image_height, splat_radius);
+    for (pnanovdb_uint32_t idx = 0u; idx < k_tile_variant_count; idx++)
+    {
+        float cost = tile_variant_cost(k_tile_variants[idx], image_width, image_height, splat_radius);
+        if (cost < best_cost)
+        {
+            best = idx;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+} // namespace pnanovdb_raster
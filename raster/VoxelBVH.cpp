@@ -29,7 +29,6 @@ namespace
 
 enum shader
 {
-    voxelbvh_find_range_starts_slang,
     voxelbvh_gaussians_bbox_reduce1_slang,
     voxelbvh_gaussians_bbox_reduce2_slang,
     voxelbvh_gaussians_to_ijkl_slang,
@@ -65,7 +64,6 @@ enum shader
     voxelbvh_nanovdb_set_mask_ijkl_apply_slang,
     voxelbvh_nanovdb_set_mask_ijkl_slang,
     voxelbvh_nanovdb_set_value_ijkl_slang,
-    voxelbvh_scatter_range_headers_slang,
     voxelbvh_triangles_bbox_reduce1_slang,
     voxelbvh_triangles_bbox_reduce2_slang,
     voxelbvh_triangles_to_ijkl_slang,
@@ -74,7 +72,6 @@ enum shader
 };
 
 static const char* s_shader_names[shader_count] = {
-    "raster/voxelbvh/voxelbvh_find_range_starts.slang",
     "raster/voxelbvh/voxelbvh_gaussians_bbox_reduce1.slang",
     "raster/voxelbvh/voxelbvh_gaussians_bbox_reduce2.slang",
     "raster/voxelbvh/voxelbvh_gaussians_to_ijkl.slang",
@@ -110,7 +107,6 @@ static const char* s_shader_names[shader_count] = {
     "raster/voxelbvh/voxelbvh_nanovdb_set_mask_ijkl_apply.slang",
     "raster/voxelbvh/voxelbvh_nanovdb_set_mask_ijkl.slang",
     "raster/voxelbvh/voxelbvh_nanovdb_set_value_ijkl.slang",
-    "raster/voxelbvh/voxelbvh_scatter_range_headers.slang",
     "raster/voxelbvh/voxelbvh_triangles_bbox_reduce1.slang",
     "raster/voxelbvh/voxelbvh_triangles_bbox_reduce2.slang",
     "raster/voxelbvh/voxelbvh_triangles_to_ijkl.slang",
@@ -179,6 +175,123 @@ static void destroy_context(const pnanovdb_compute_t* compute,
     delete ctx;
 }
 
+// host side of a submitted _array call, readbacks are mapped once the flushed frame completes
+struct voxelbvh_future_t
+{
+    const pnanovdb_compute_t* compute = nullptr;
+    pnanovdb_compute_queue_t* queue = nullptr;
+    pnanovdb_uint64_t flushed_frame = 0llu;
+    pnanovdb_bool_t resolved = PNANOVDB_FALSE;
+
+    std::vector<compute_gpu_array_t*> gpu_arrays;
+    std::vector<pnanovdb_compute_array_t*> readback_arrays; // parallel to gpu_arrays, nullptr if not read back
+    std::vector<pnanovdb_compute_array_t*> results;
+};
+
+PNANOVDB_CAST_PAIR(pnanovdb_voxelbvh_future_t, voxelbvh_future_t)
+
+static voxelbvh_future_t* future_create(const pnanovdb_compute_t* compute, pnanovdb_compute_queue_t* queue)
+{
+    voxelbvh_future_t* ptr = new voxelbvh_future_t();
+    ptr->compute = compute;
+    ptr->queue = queue;
+    return ptr;
+}
+
+// future takes ownership of gpu_array, readback_array receives the data gpu_array_readback() recorded
+static void future_add_gpu_array(voxelbvh_future_t* ptr,
+                                 compute_gpu_array_t* gpu_array,
+                                 pnanovdb_compute_array_t* readback_array)
+{
+    ptr->gpu_arrays.push_back(gpu_array);
+    ptr->readback_arrays.push_back(readback_array);
+}
+
+static pnanovdb_voxelbvh_future_t* future_submit(voxelbvh_future_t* ptr)
+{
+    ptr->compute->device_interface.flush(ptr->queue, &ptr->flushed_frame, nullptr, nullptr);
+    return cast(ptr);
+}
+
+static void future_resolve(voxelbvh_future_t* ptr)
+{
+    if (ptr->resolved)
+    {
+        return;
+    }
+    for (size_t idx = 0u; idx < ptr->gpu_arrays.size(); idx++)
+    {
+        if (ptr->readback_arrays[idx])
+        {
+            gpu_array_map(ptr->compute, ptr->queue, ptr->gpu_arrays[idx], ptr->readback_arrays[idx]);
+        }
+        gpu_array_destroy(ptr->compute, ptr->queue, ptr->gpu_arrays[idx]);
+    }
+    ptr->gpu_arrays.clear();
+    ptr->readback_arrays.clear();
+    ptr->resolved = PNANOVDB_TRUE;
+}
+
+static pnanovdb_uint64_t future_get_frame(pnanovdb_voxelbvh_future_t* future)
+{
+    auto ptr = cast(future);
+    return ptr->flushed_frame;
+}
+
+static pnanovdb_bool_t future_is_completed(pnanovdb_voxelbvh_future_t* future)
+{
+    auto ptr = cast(future);
+    if (!ptr->resolved && ptr->compute->device_interface.is_frame_completed(ptr->queue, ptr->flushed_frame))
+    {
+        future_resolve(ptr);
+    }
+    return ptr->resolved;
+}
+
+static void future_wait(pnanovdb_voxelbvh_future_t* future)
+{
+    auto ptr = cast(future);
+    if (!ptr->resolved)
+    {
+        ptr->compute->device_interface.wait_for_frame(ptr->queue, ptr->flushed_frame);
+        future_resolve(ptr);
+    }
+}
+
+static pnanovdb_compute_array_t* future_take_result(pnanovdb_voxelbvh_future_t* future, pnanovdb_uint32_t result_idx)
+{
+    auto ptr = cast(future);
+    if (!ptr->resolved || result_idx >= ptr->results.size())
+    {
+        return nullptr;
+    }
+    pnanovdb_compute_array_t* result = ptr->results[result_idx];
+    ptr->results[result_idx] = nullptr;
+    return result;
+}
+
+static void future_destroy(pnanovdb_voxelbvh_future_t* future)
+{
+    auto ptr = cast(future);
+    if (!ptr)
+    {
+        return;
+    }
+    // buffer release is deferred by the context until the frame completes, no need to wait here
+    for (compute_gpu_array_t* gpu_array : ptr->gpu_arrays)
+    {
+        gpu_array_destroy(ptr->compute, ptr->queue, gpu_array);
+    }
+    for (pnanovdb_compute_array_t* result : ptr->results)
+    {
+        if (result)
+        {
+            ptr->compute->destroy_array(result);
+        }
+    }
+    delete ptr;
+}
+
 void nanovdb_generate_node_mask(const pnanovdb_compute_t* compute,
                                 pnanovdb_compute_queue_t* queue,
                                 pnanovdb_voxelbvh_context_t* voxelbvh_context,
@@ -246,10 +359,10 @@ void nanovdb_generate_node_mask(const pnanovdb_compute_t* compute,
     compute_interface->destroy_buffer(context, constant_buffer);
 }
 
-static pnanovdb_compute_array_t* nanovdb_generate_node_mask_array(const pnanovdb_compute_t* compute,
-                                                                  pnanovdb_compute_queue_t* queue,
-                                                                  pnanovdb_voxelbvh_context_t* voxelbvh_context,
-                                                                  pnanovdb_compute_array_t* nanovdb_array)
+static pnanovdb_voxelbvh_future_t* nanovdb_generate_node_mask_array_async(const pnanovdb_compute_t* compute,
+                                                                          pnanovdb_compute_queue_t* queue,
+                                                                          pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                                                          pnanovdb_compute_array_t* nanovdb_array)
 {
     auto ctx = cast(voxelbvh_context);
 
@@ -275,16 +388,23 @@ static pnanovdb_compute_array_t* nanovdb_generate_node_mask_array(const pnanovdb
 
     gpu_array_readback(compute, queue, node_mask_gpu_array, node_mask_array);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-
-    compute->device_interface.wait_idle(queue);
-
-    gpu_array_map(compute, queue, node_mask_gpu_array, node_mask_array);
-
-    gpu_array_destroy(compute, queue, nanovdb_gpu_array);
-    gpu_array_destroy(compute, queue, node_mask_gpu_array);
+    voxelbvh_future_t* future = future_create(compute, queue);
+    future_add_gpu_array(future, nanovdb_gpu_array, nullptr);
+    future_add_gpu_array(future, node_mask_gpu_array, node_mask_array);
+    future->results.push_back(node_mask_array);
+    return future_submit(future);
+}
 
+static pnanovdb_compute_array_t* nanovdb_generate_node_mask_array(const pnanovdb_compute_t* compute,
+                                                                  pnanovdb_compute_queue_t* queue,
+                                                                  pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                                                  pnanovdb_compute_array_t* nanovdb_array)
+{
+    pnanovdb_voxelbvh_future_t* future =
+        nanovdb_generate_node_mask_array_async(compute, queue, voxelbvh_context, nanovdb_array);
+    future_wait(future);
+    pnanovdb_compute_array_t* node_mask_array = future_take_result(future, 0u);
+    future_destroy(future);
     return node_mask_array;
 }
 
@@ -724,13 +844,13 @@ static void nanovdb_duplicate_topology(const pnanovdb_compute_t* compute,
     compute_interface->destroy_buffer(context, node_mask_buffer);
 }
 
-static void nanovdb_duplicate_topology_array(const pnanovdb_compute_t* compute,
-                                             pnanovdb_compute_queue_t* queue,
-                                             pnanovdb_voxelbvh_context_t* voxelbvh_context,
-                                             pnanovdb_compute_array_t** dst_nanovdb_out,
-                                             pnanovdb_compute_array_t* src_nanovdb_in,
-                                             pnanovdb_uint32_t dst_grid_type,
-                                             pnanovdb_uint32_t upsample_factor)
+static pnanovdb_voxelbvh_future_t* nanovdb_duplicate_topology_array_async(
+    const pnanovdb_compute_t* compute,
+    pnanovdb_compute_queue_t* queue,
+    pnanovdb_voxelbvh_context_t* voxelbvh_context,
+    pnanovdb_compute_array_t* src_nanovdb_in,
+    pnanovdb_uint32_t dst_grid_type,
+    pnanovdb_uint32_t upsample_factor)
 {
     auto ctx = cast(voxelbvh_context);
 
@@ -757,17 +877,26 @@ static void nanovdb_duplicate_topology_array(const pnanovdb_compute_t* compute,
 
     gpu_array_readback(compute, queue, dst_nanovdb_gpu_array, dst_nanovdb_array);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-
-    compute->device_interface.wait_idle(queue);
-
-    gpu_array_map(compute, queue, dst_nanovdb_gpu_array, dst_nanovdb_array);
-
-    gpu_array_destroy(compute, queue, src_nanovdb_gpu_array);
-    gpu_array_destroy(compute, queue, dst_nanovdb_gpu_array);
+    voxelbvh_future_t* future = future_create(compute, queue);
+    future_add_gpu_array(future, src_nanovdb_gpu_array, nullptr);
+    future_add_gpu_array(future, dst_nanovdb_gpu_array, dst_nanovdb_array);
+    future->results.push_back(dst_nanovdb_array);
+    return future_submit(future);
+}
 
-    *dst_nanovdb_out = dst_nanovdb_array;
+static void nanovdb_duplicate_topology_array(const pnanovdb_compute_t* compute,
+                                             pnanovdb_compute_queue_t* queue,
+                                             pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                             pnanovdb_compute_array_t** dst_nanovdb_out,
+                                             pnanovdb_compute_array_t* src_nanovdb_in,
+                                             pnanovdb_uint32_t dst_grid_type,
+                                             pnanovdb_uint32_t upsample_factor)
+{
+    pnanovdb_voxelbvh_future_t* future = nanovdb_duplicate_topology_array_async(
+        compute, queue, voxelbvh_context, src_nanovdb_in, dst_grid_type, upsample_factor);
+    future_wait(future);
+    *dst_nanovdb_out = future_take_result(future, 0u);
+    future_destroy(future);
 }
 
 static void nanovdb_add_nodes_from_ijkl_buffer(const pnanovdb_compute_t* compute,
@@ -1059,17 +1188,17 @@ static void nanovdb_add_nodes_from_ijkl_buffer(const pnanovdb_compute_t* compute
     compute_interface->destroy_buffer(context, range_scratch_buffer);
 }
 
-static void nanovdb_add_nodes_from_ijkl_array(const pnanovdb_compute_t* compute,
-                                              pnanovdb_compute_queue_t* queue,
-                                              pnanovdb_voxelbvh_context_t* voxelbvh_context,
-                                              pnanovdb_compute_array_t** out_nanovdb,
-                                              pnanovdb_compute_array_t** out_flat_range,
-                                              pnanovdb_compute_array_t* ijkl_in,
-                                              pnanovdb_compute_array_t* range_in,
-                                              pnanovdb_compute_array_t* world_bbox_in,
-                                              pnanovdb_uint32_t resolution,
-                                              const float* transform_floats,
-                                              pnanovdb_uint32_t transform_float_count)
+// results are [nanovdb, flat_range]
+static pnanovdb_voxelbvh_future_t* nanovdb_add_nodes_from_ijkl_array_async(
+    const pnanovdb_compute_t* compute,
+    pnanovdb_compute_queue_t* queue,
+    pnanovdb_voxelbvh_context_t* voxelbvh_context,
+    pnanovdb_compute_array_t* ijkl_in,
+    pnanovdb_compute_array_t* range_in,
+    pnanovdb_compute_array_t* world_bbox_in,
+    pnanovdb_uint32_t resolution,
+    const float* transform_floats,
+    pnanovdb_uint32_t transform_float_count)
 {
     auto ctx = cast(voxelbvh_context);
 
@@ -1110,22 +1239,36 @@ static void nanovdb_add_nodes_from_ijkl_array(const pnanovdb_compute_t* compute,
     gpu_array_readback(compute, queue, nanovdb_gpu_array, nanovdb_array);
     gpu_array_readback(compute, queue, flat_range_gpu_array, flat_range_array);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-
-    compute->device_interface.wait_idle(queue);
-
-    gpu_array_map(compute, queue, nanovdb_gpu_array, nanovdb_array);
-    gpu_array_map(compute, queue, flat_range_gpu_array, flat_range_array);
-
-    gpu_array_destroy(compute, queue, ijkl_gpu_array);
-    gpu_array_destroy(compute, queue, range_gpu_array);
-    gpu_array_destroy(compute, queue, world_bbox_gpu_array);
-    gpu_array_destroy(compute, queue, nanovdb_gpu_array);
-    gpu_array_destroy(compute, queue, flat_range_gpu_array);
+    voxelbvh_future_t* future = future_create(compute, queue);
+    future_add_gpu_array(future, ijkl_gpu_array, nullptr);
+    future_add_gpu_array(future, range_gpu_array, nullptr);
+    future_add_gpu_array(future, world_bbox_gpu_array, nullptr);
+    future_add_gpu_array(future, nanovdb_gpu_array, nanovdb_array);
+    future_add_gpu_array(future, flat_range_gpu_array, flat_range_array);
+    future->results.push_back(nanovdb_array);
+    future->results.push_back(flat_range_array);
+    return future_submit(future);
+}
 
-    *out_nanovdb = nanovdb_array;
-    *out_flat_range = flat_range_array;
+static void nanovdb_add_nodes_from_ijkl_array(const pnanovdb_compute_t* compute,
+                                              pnanovdb_compute_queue_t* queue,
+                                              pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                              pnanovdb_compute_array_t** out_nanovdb,
+                                              pnanovdb_compute_array_t** out_flat_range,
+                                              pnanovdb_compute_array_t* ijkl_in,
+                                              pnanovdb_compute_array_t* range_in,
+                                              pnanovdb_compute_array_t* world_bbox_in,
+                                              pnanovdb_uint32_t resolution,
+                                              const float* transform_floats,
+                                              pnanovdb_uint32_t transform_float_count)
+{
+    pnanovdb_voxelbvh_future_t* future =
+        nanovdb_add_nodes_from_ijkl_array_async(compute, queue, voxelbvh_context, ijkl_in, range_in, world_bbox_in,
+                                                resolution, transform_floats, transform_float_count);
+    future_wait(future);
+    *out_nanovdb = future_take_result(future, 0u);
+    *out_flat_range = future_take_result(future, 1u);
+    future_destroy(future);
 }
 
 static void ijkl_from_gaussians(const pnanovdb_compute_t* compute,
@@ -1284,60 +1427,14 @@ static void ijkl_from_gaussians(const pnanovdb_compute_t* compute,
                                                   constants.voxel_count, constants.voxel_count, 64u);
     }
 
-    buf_desc.size_in_bytes = 4u * constants.voxel_count;
-    pnanovdb_compute_buffer_t* range_starts_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    pnanovdb_compute_buffer_t* range_scan_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    // buf_desc.size_in_bytes = 2u * 4u * constants.voxel_count;
-    // pnanovdb_compute_buffer_t* range_headers_buffer =
-    //     compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-
-    pnanovdb_compute_buffer_transient_t* range_starts_transient =
-        compute_interface->register_buffer_as_transient(context, range_starts_buffer);
-    pnanovdb_compute_buffer_transient_t* range_scan_transient =
-        compute_interface->register_buffer_as_transient(context, range_scan_buffer);
-    pnanovdb_compute_buffer_transient_t* range_transient =
-        compute_interface->register_buffer_as_transient(context, range_out);
-
-    // identify range starts
-    // voxelbvh_find_range_starts.slang
-    {
-        pnanovdb_compute_resource_t resources[4u] = {};
-        resources[0u].buffer_transient = constant_transient;
-        resources[1u].buffer_transient = ijkl_transient;
-        resources[2u].buffer_transient = range_starts_transient;
-        resources[3u].buffer_transient = range_transient;
-
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[voxelbvh_find_range_starts_slang],
-                                 resources, constants.voxel_workgroup_count, 1u, 1u, "voxelbvh_find_range_starts");
-    }
-
-    // global scan to allocate range headers
+    // begin and end of each run of equal ijk-level requests
     {
-        ctx->parallel_primitives.global_scan(compute, queue, ctx->parallel_primitives_ctx, range_starts_buffer,
-                                             range_scan_buffer, constants.voxel_count, 1u);
-    }
-
-    // scatter range headers
-    // voxelbvh_scatter_range_headers.slang
-    {
-        pnanovdb_compute_resource_t resources[5u] = {};
-        resources[0u].buffer_transient = constant_transient;
-        resources[1u].buffer_transient = ijkl_transient;
-        resources[2u].buffer_transient = range_starts_transient;
-        resources[3u].buffer_transient = range_scan_transient;
-        resources[4u].buffer_transient = range_transient;
-
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[voxelbvh_scatter_range_headers_slang],
-                                 resources, constants.voxel_workgroup_count, 1u, 1u, "voxelbvh_scatter_range_headers");
+        ctx->parallel_primitives.run_length_encode_key64(compute, queue, ctx->parallel_primitives_ctx, ijkl_out,
+                                                         range_out, nullptr, constants.voxel_count);
     }
 
     compute_interface->destroy_buffer(context, constant_buffer);
     compute_interface->destroy_buffer(context, bbox_reduce1_buffer);
-
-    compute_interface->destroy_buffer(context, range_starts_buffer);
-    compute_interface->destroy_buffer(context, range_scan_buffer);
 }
 
 static void ijkl_from_gaussians_file(const pnanovdb_compute_t* compute,
@@ -1465,7 +1562,7 @@ static void ijkl_from_gaussians_file(const pnanovdb_compute_t* compute,
         pnanovdb_uint64_t flushed_frame = 0llu;
         compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
 
-        compute->device_interface.wait_idle(queue);
+        compute->device_interface.wait_for_frame(queue, flushed_frame);
 
         gpu_array_map(compute, queue, ijkl_gpu_array, ijkl_array);
         gpu_array_map(compute, queue, prim_id_gpu_array, prim_id_array);
@@ -1679,73 +1776,24 @@ void ijkl_from_lines(const pnanovdb_compute_t* compute,
                                                   constants.voxel_count, constants.voxel_count, 64u);
     }
 
-    buf_desc.size_in_bytes = 4u * constants.voxel_count;
-    pnanovdb_compute_buffer_t* range_starts_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    pnanovdb_compute_buffer_t* range_scan_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    // buf_desc.size_in_bytes = 2u * 4u * constants.voxel_count;
-    // pnanovdb_compute_buffer_t* range_headers_buffer =
-    //     compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-
-    pnanovdb_compute_buffer_transient_t* range_starts_transient =
-        compute_interface->register_buffer_as_transient(context, range_starts_buffer);
-    pnanovdb_compute_buffer_transient_t* range_scan_transient =
-        compute_interface->register_buffer_as_transient(context, range_scan_buffer);
-    pnanovdb_compute_buffer_transient_t* range_transient =
-        compute_interface->register_buffer_as_transient(context, range_out);
-
-    // identify range starts
-    // voxelbvh_find_range_starts.slang
-    {
-        pnanovdb_compute_resource_t resources[4u] = {};
-        resources[0u].buffer_transient = constant_transient;
-        resources[1u].buffer_transient = ijkl_transient;
-        resources[2u].buffer_transient = range_starts_transient;
-        resources[3u].buffer_transient = range_transient;
-
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[voxelbvh_find_range_starts_slang],
-                                 resources, constants.voxel_workgroup_count, 1u, 1u, "voxelbvh_find_range_starts");
-    }
-
-    // global scan to allocate range headers
-    {
-        ctx->parallel_primitives.global_scan(compute, queue, ctx->parallel_primitives_ctx, range_starts_buffer,
-                                             range_scan_buffer, constants.voxel_count, 1u);
-    }
-
-    // scatter range headers
-    // voxelbvh_scatter_range_headers.slang
+    // begin and end of each run of equal ijk-level requests
     {
-        pnanovdb_compute_resource_t resources[5u] = {};
-        resources[0u].buffer_transient = constant_transient;
-        resources[1u].buffer_transient = ijkl_transient;
-        resources[2u].buffer_transient = range_starts_transient;
-        resources[3u].buffer_transient = range_scan_transient;
-        resources[4u].buffer_transient = range_transient;
-
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[voxelbvh_scatter_range_headers_slang],
-                                 resources, constants.voxel_workgroup_count, 1u, 1u, "voxelbvh_scatter_range_headers");
+        ctx->parallel_primitives.run_length_encode_key64(compute, queue, ctx->parallel_primitives_ctx, ijkl_out,
+                                                         range_out, nullptr, constants.voxel_count);
     }
 
     compute_interface->destroy_buffer(context, constant_buffer);
     compute_interface->destroy_buffer(context, bbox_reduce1_buffer);
-
-    compute_interface->destroy_buffer(context, range_starts_buffer);
-    compute_interface->destroy_buffer(context, range_scan_buffer);
 }
 
-void ijkl_from_lines_array(const pnanovdb_compute_t* compute,
-                           pnanovdb_compute_queue_t* queue,
-                           pnanovdb_voxelbvh_context_t* voxelbvh_context,
-                           pnanovdb_compute_array_t* indices_array,
-                           pnanovdb_compute_array_t* positions_array,
-                           float inflation_radius,
-                           pnanovdb_compute_array_t** ijkl_out,
-                           pnanovdb_compute_array_t** prim_id_out,
-                           pnanovdb_compute_array_t** range_out,
-                           pnanovdb_compute_array_t** world_bbox_out,
-                           pnanovdb_uint32_t resolution)
+// results are [ijkl, prim_id, range, world_bbox]
+static pnanovdb_voxelbvh_future_t* ijkl_from_lines_array_async(const pnanovdb_compute_t* compute,
+                                                               pnanovdb_compute_queue_t* queue,
+                                                               pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                                               pnanovdb_compute_array_t* indices_array,
+                                                               pnanovdb_compute_array_t* positions_array,
+                                                               float inflation_radius,
+                                                               pnanovdb_uint32_t resolution)
 {
     // ignore array semantics, assume 32-bit uint line indices for now
     pnanovdb_uint64_t line_count = indices_array->element_count * indices_array->element_size / (8u);
@@ -1787,25 +1835,47 @@ void ijkl_from_lines_array(const pnanovdb_compute_t* compute,
     gpu_array_readback(compute, queue, range_gpu_array, range_array);
     gpu_array_readback(compute, queue, world_bbox_gpu_array, world_bbox_array);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-
-    compute->device_interface.wait_idle(queue);
-
-    gpu_array_map(compute, queue, ijkl_gpu_array, ijkl_array);
-    gpu_array_map(compute, queue, prim_id_gpu_array, prim_id_array);
-    gpu_array_map(compute, queue, range_gpu_array, range_array);
-    gpu_array_map(compute, queue, world_bbox_gpu_array, world_bbox_array);
+    voxelbvh_future_t* future = future_create(compute, queue);
+    future_add_gpu_array(future, ijkl_gpu_array, ijkl_array);
+    future_add_gpu_array(future, prim_id_gpu_array, prim_id_array);
+    future_add_gpu_array(future, range_gpu_array, range_array);
+    future_add_gpu_array(future, world_bbox_gpu_array, world_bbox_array);
+    future->results.push_back(ijkl_array);
+    future->results.push_back(prim_id_array);
+    future->results.push_back(range_array);
+    future->results.push_back(world_bbox_array);
+    return future_submit(future);
+}
 
-    *ijkl_out = ijkl_array;
-    *prim_id_out = prim_id_array;
-    *range_out = range_array;
-    *world_bbox_out = world_bbox_array;
+static void future_take_ijkl_results(pnanovdb_voxelbvh_future_t* future,
+                                     pnanovdb_compute_array_t** ijkl_out,
+                                     pnanovdb_compute_array_t** prim_id_out,
+                                     pnanovdb_compute_array_t** range_out,
+                                     pnanovdb_compute_array_t** world_bbox_out)
+{
+    future_wait(future);
+    *ijkl_out = future_take_result(future, 0u);
+    *prim_id_out = future_take_result(future, 1u);
+    *range_out = future_take_result(future, 2u);
+    *world_bbox_out = future_take_result(future, 3u);
+    future_destroy(future);
+}
 
-    gpu_array_destroy(compute, queue, ijkl_gpu_array);
-    gpu_array_destroy(compute, queue, prim_id_gpu_array);
-    gpu_array_destroy(compute, queue, range_gpu_array);
-    gpu_array_destroy(compute, queue, world_bbox_gpu_array);
+void ijkl_from_lines_array(const pnanovdb_compute_t* compute,
+                           pnanovdb_compute_queue_t* queue,
+                           pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                           pnanovdb_compute_array_t* indices_array,
+                           pnanovdb_compute_array_t* positions_array,
+                           float inflation_radius,
+                           pnanovdb_compute_array_t** ijkl_out,
+                           pnanovdb_compute_array_t** prim_id_out,
+                           pnanovdb_compute_array_t** range_out,
+                           pnanovdb_compute_array_t** world_bbox_out,
+                           pnanovdb_uint32_t resolution)
+{
+    pnanovdb_voxelbvh_future_t* future = ijkl_from_lines_array_async(
+        compute, queue, voxelbvh_context, indices_array, positions_array, inflation_radius, resolution);
+    future_take_ijkl_results(future, ijkl_out, prim_id_out, range_out, world_bbox_out);
 }
 
 void ijkl_from_triangles(const pnanovdb_compute_t* compute,
@@ -1928,73 +1998,24 @@ void ijkl_from_triangles(const pnanovdb_compute_t* compute,
                                                   constants.voxel_count, constants.voxel_count, 64u);
     }
 
-    buf_desc.size_in_bytes = 4u * constants.voxel_count;
-    pnanovdb_compute_buffer_t* range_starts_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    pnanovdb_compute_buffer_t* range_scan_buffer =
-        compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-    // buf_desc.size_in_bytes = 2u * 4u * constants.voxel_count;
-    // pnanovdb_compute_buffer_t* range_headers_buffer =
-    //     compute_interface->create_buffer(context, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, &buf_desc);
-
-    pnanovdb_compute_buffer_transient_t* range_starts_transient =
-        compute_interface->register_buffer_as_transient(context, range_starts_buffer);
-    pnanovdb_compute_buffer_transient_t* range_scan_transient =
-        compute_interface->register_buffer_as_transient(context, range_scan_buffer);
-    pnanovdb_compute_buffer_transient_t* range_transient =
-        compute_interface->register_buffer_as_transient(context, range_out);
-
-    // identify range starts
-    // voxelbvh_find_range_starts.slang
+    // begin and end of each run of equal ijk-level requests
     {
-        pnanovdb_compute_resource_t resources[4u] = {};
-        resources[0u].buffer_transient = constant_transient;
-        resources[1u].buffer_transient = ijkl_transient;
-        resources[2u].buffer_transient = range_starts_transient;
-        resources[3u].buffer_transient = range_transient;
-
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[voxelbvh_find_range_starts_slang],
-                                 resources, constants.voxel_workgroup_count, 1u, 1u, "voxelbvh_find_range_starts");
-    }
-
-    // global scan to allocate range headers
-    {
-        ctx->parallel_primitives.global_scan(compute, queue, ctx->parallel_primitives_ctx, range_starts_buffer,
-                                             range_scan_buffer, constants.voxel_count, 1u);
-    }
-
-    // scatter range headers
-    // voxelbvh_scatter_range_headers.slang
-    {
-        pnanovdb_compute_resource_t resources[5u] = {};
-        resources[0u].buffer_transient = constant_transient;
-        resources[1u].buffer_transient = ijkl_transient;
-        resources[2u].buffer_transient = range_starts_transient;
-        resources[3u].buffer_transient = range_scan_transient;
-        resources[4u].buffer_transient = range_transient;
-
-        compute->dispatch_shader(compute_interface, context, ctx->shader_ctx[voxelbvh_scatter_range_headers_slang],
-                                 resources, constants.voxel_workgroup_count, 1u, 1u, "voxelbvh_scatter_range_headers");
+        ctx->parallel_primitives.run_length_encode_key64(compute, queue, ctx->parallel_primitives_ctx, ijkl_out,
+                                                         range_out, nullptr, constants.voxel_count);
     }
 
     compute_interface->destroy_buffer(context, constant_buffer);
     compute_interface->destroy_buffer(context, bbox_reduce1_buffer);
-
-    compute_interface->destroy_buffer(context, range_starts_buffer);
-    compute_interface->destroy_buffer(context, range_scan_buffer);
 }
 
-void ijkl_from_triangles_array(const pnanovdb_compute_t* compute,
-                               pnanovdb_compute_queue_t* queue,
-                               pnanovdb_voxelbvh_context_t* voxelbvh_context,
-                               pnanovdb_compute_array_t* indices_array,
-                               pnanovdb_compute_array_t* positions_array,
-                               float inflation_radius,
-                               pnanovdb_compute_array_t** ijkl_out,
-                               pnanovdb_compute_array_t** prim_id_out,
-                               pnanovdb_compute_array_t** range_out,
-                               pnanovdb_compute_array_t** world_bbox_out,
-                               pnanovdb_uint32_t resolution)
+// results are [ijkl, prim_id, range, world_bbox]
+static pnanovdb_voxelbvh_future_t* ijkl_from_triangles_array_async(const pnanovdb_compute_t* compute,
+                                                                   pnanovdb_compute_queue_t* queue,
+                                                                   pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                                                   pnanovdb_compute_array_t* indices_array,
+                                                                   pnanovdb_compute_array_t* positions_array,
+                                                                   float inflation_radius,
+                                                                   pnanovdb_uint32_t resolution)
 {
     // ignore array semantics, assume 32-bit uint triangle for now
     pnanovdb_uint64_t triangle_count = indices_array->element_count * indices_array->element_size / (12u);
@@ -2036,25 +2057,33 @@ void ijkl_from_triangles_array(const pnanovdb_compute_t* compute,
     gpu_array_readback(compute, queue, range_gpu_array, range_array);
     gpu_array_readback(compute, queue, world_bbox_gpu_array, world_bbox_array);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-
-    compute->device_interface.wait_idle(queue);
-
-    gpu_array_map(compute, queue, ijkl_gpu_array, ijkl_array);
-    gpu_array_map(compute, queue, prim_id_gpu_array, prim_id_array);
-    gpu_array_map(compute, queue, range_gpu_array, range_array);
-    gpu_array_map(compute, queue, world_bbox_gpu_array, world_bbox_array);
-
-    *ijkl_out = ijkl_array;
-    *prim_id_out = prim_id_array;
-    *range_out = range_array;
-    *world_bbox_out = world_bbox_array;
+    voxelbvh_future_t* future = future_create(compute, queue);
+    future_add_gpu_array(future, ijkl_gpu_array, ijkl_array);
+    future_add_gpu_array(future, prim_id_gpu_array, prim_id_array);
+    future_add_gpu_array(future, range_gpu_array, range_array);
+    future_add_gpu_array(future, world_bbox_gpu_array, world_bbox_array);
+    future->results.push_back(ijkl_array);
+    future->results.push_back(prim_id_array);
+    future->results.push_back(range_array);
+    future->results.push_back(world_bbox_array);
+    return future_submit(future);
+}
 
-    gpu_array_destroy(compute, queue, ijkl_gpu_array);
-    gpu_array_destroy(compute, queue, prim_id_gpu_array);
-    gpu_array_destroy(compute, queue, range_gpu_array);
-    gpu_array_destroy(compute, queue, world_bbox_gpu_array);
+void ijkl_from_triangles_array(const pnanovdb_compute_t* compute,
+                               pnanovdb_compute_queue_t* queue,
+                               pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                               pnanovdb_compute_array_t* indices_array,
+                               pnanovdb_compute_array_t* positions_array,
+                               float inflation_radius,
+                               pnanovdb_compute_array_t** ijkl_out,
+                               pnanovdb_compute_array_t** prim_id_out,
+                               pnanovdb_compute_array_t** range_out,
+                               pnanovdb_compute_array_t** world_bbox_out,
+                               pnanovdb_uint32_t resolution)
+{
+    pnanovdb_voxelbvh_future_t* future = ijkl_from_triangles_array_async(
+        compute, queue, voxelbvh_context, indices_array, positions_array, inflation_radius, resolution);
+    future_take_ijkl_results(future, ijkl_out, prim_id_out, range_out, world_bbox_out);
 }
 
 static pnanovdb_compute_array_t* nanovdb_from_ijkl_and_metadata(const pnanovdb_compute_t* compute,
@@ -2191,12 +2220,13 @@ static pnanovdb_compute_array_t* nanovdb_from_gaussians_file(const pnanovdb_comp
     return nanovdb_meta;
 }
 
-static pnanovdb_compute_array_t* nanovdb_from_gaussians_array(const pnanovdb_compute_t* compute,
-                                                              pnanovdb_compute_queue_t* queue,
-                                                              pnanovdb_voxelbvh_context_t* voxelbvh_context,
-                                                              pnanovdb_compute_array_t** gaussian_arrays,
-                                                              pnanovdb_uint32_t gaussian_array_count,
-                                                              pnanovdb_uint32_t resolution)
+// results are [ijkl, prim_id, range, world_bbox], nullptr unless gaussian_arrays holds all 6 arrays
+static pnanovdb_voxelbvh_future_t* ijkl_from_gaussians_array_async(const pnanovdb_compute_t* compute,
+                                                                   pnanovdb_compute_queue_t* queue,
+                                                                   pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                                                   pnanovdb_compute_array_t** gaussian_arrays,
+                                                                   pnanovdb_uint32_t gaussian_array_count,
+                                                                   pnanovdb_uint32_t resolution)
 {
     if (gaussian_array_count != 6u || !gaussian_arrays)
     {
@@ -2263,19 +2293,37 @@ static pnanovdb_compute_array_t* nanovdb_from_gaussians_array(const pnanovdb_com
     gpu_array_readback(compute, queue, range_gpu_array, range_array);
     gpu_array_readback(compute, queue, world_bbox_gpu_array, world_bbox_array);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-    compute->device_interface.wait_idle(queue);
+    voxelbvh_future_t* future = future_create(compute, queue);
+    future_add_gpu_array(future, ijkl_gpu_array, ijkl_array);
+    future_add_gpu_array(future, prim_id_gpu_array, prim_id_array);
+    future_add_gpu_array(future, range_gpu_array, range_array);
+    future_add_gpu_array(future, world_bbox_gpu_array, world_bbox_array);
+    future->results.push_back(ijkl_array);
+    future->results.push_back(prim_id_array);
+    future->results.push_back(range_array);
+    future->results.push_back(world_bbox_array);
+    return future_submit(future);
+}
 
-    gpu_array_map(compute, queue, ijkl_gpu_array, ijkl_array);
-    gpu_array_map(compute, queue, prim_id_gpu_array, prim_id_array);
-    gpu_array_map(compute, queue, range_gpu_array, range_array);
-    gpu_array_map(compute, queue, world_bbox_gpu_array, world_bbox_array);
+static pnanovdb_compute_array_t* nanovdb_from_gaussians_array(const pnanovdb_compute_t* compute,
+                                                              pnanovdb_compute_queue_t* queue,
+                                                              pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                                              pnanovdb_compute_array_t** gaussian_arrays,
+                                                              pnanovdb_uint32_t gaussian_array_count,
+                                                              pnanovdb_uint32_t resolution)
+{
+    pnanovdb_voxelbvh_future_t* future = ijkl_from_gaussians_array_async(
+        compute, queue, voxelbvh_context, gaussian_arrays, gaussian_array_count, resolution);
+    if (!future)
+    {
+        return nullptr;
+    }
 
-    gpu_array_destroy(compute, queue, ijkl_gpu_array);
-    gpu_array_destroy(compute, queue, prim_id_gpu_array);
-    gpu_array_destroy(compute, queue, range_gpu_array);
-    gpu_array_destroy(compute, queue, world_bbox_gpu_array);
+    pnanovdb_compute_array_t* ijkl_array = nullptr;
+    pnanovdb_compute_array_t* prim_id_array = nullptr;
+    pnanovdb_compute_array_t* range_array = nullptr;
+    pnanovdb_compute_array_t* world_bbox_array = nullptr;
+    future_take_ijkl_results(future, &ijkl_array, &prim_id_array, &range_array, &world_bbox_array);
 
     return nanovdb_from_ijkl_and_metadata(compute, queue, voxelbvh_context, ijkl_array, prim_id_array, range_array,
                                           world_bbox_array, gaussian_arrays, 6u, resolution);
@@ -2483,12 +2531,14 @@ void nanovdb_rgba8_from_voxelbvh(const pnanovdb_compute_t* compute,
     compute_interface->destroy_buffer(context, node_mask_buffer);
 }
 
-void nanovdb_rgba8_from_voxelbvh_array(const pnanovdb_compute_t* compute,
-                                       pnanovdb_compute_queue_t* queue,
-                                       pnanovdb_voxelbvh_context_t* voxelbvh_context,
-                                       pnanovdb_compute_array_t* dst_nanovdb_inout,
-                                       pnanovdb_compute_array_t* src_nanovdb_in,
-                                       pnanovdb_vec3_t index_space_ray_direction)
+// dst_nanovdb_inout is written on completion and stays owned by the caller, there are no results
+static pnanovdb_voxelbvh_future_t* nanovdb_rgba8_from_voxelbvh_array_async(
+    const pnanovdb_compute_t* compute,
+    pnanovdb_compute_queue_t* queue,
+    pnanovdb_voxelbvh_context_t* voxelbvh_context,
+    pnanovdb_compute_array_t* dst_nanovdb_inout,
+    pnanovdb_compute_array_t* src_nanovdb_in,
+    pnanovdb_vec3_t index_space_ray_direction)
 {
     auto ctx = cast(voxelbvh_context);
 
@@ -2509,15 +2559,23 @@ void nanovdb_rgba8_from_voxelbvh_array(const pnanovdb_compute_t* compute,
 
     gpu_array_readback(compute, queue, dst_nanovdb_gpu_array, dst_nanovdb_inout);
 
-    pnanovdb_uint64_t flushed_frame = 0llu;
-    compute->device_interface.flush(queue, &flushed_frame, nullptr, nullptr);
-
-    compute->device_interface.wait_idle(queue);
-
-    gpu_array_map(compute, queue, dst_nanovdb_gpu_array, dst_nanovdb_inout);
+    voxelbvh_future_t* future = future_create(compute, queue);
+    future_add_gpu_array(future, src_nanovdb_gpu_array, nullptr);
+    future_add_gpu_array(future, dst_nanovdb_gpu_array, dst_nanovdb_inout);
+    return future_submit(future);
+}
 
-    gpu_array_destroy(compute, queue, src_nanovdb_gpu_array);
-    gpu_array_destroy(compute, queue, dst_nanovdb_gpu_array);
+void nanovdb_rgba8_from_voxelbvh_array(const pnanovdb_compute_t* compute,
+                                       pnanovdb_compute_queue_t* queue,
+                                       pnanovdb_voxelbvh_context_t* voxelbvh_context,
+                                       pnanovdb_compute_array_t* dst_nanovdb_inout,
+                                       pnanovdb_compute_array_t* src_nanovdb_in,
+                                       pnanovdb_vec3_t index_space_ray_direction)
+{
+    pnanovdb_voxelbvh_future_t* future = nanovdb_rgba8_from_voxelbvh_array_async(
+        compute, queue, voxelbvh_context, dst_nanovdb_inout, src_nanovdb_in, index_space_ray_direction);
+    future_wait(future);
+    future_destroy(future);
 }
 
 }
@@ -2549,6 +2607,18 @@ pnanovdb_voxelbvh_t* pnanovdb_get_voxelbvh()
     iface.nanovdb_duplicate_topology_array = nanovdb_duplicate_topology_array;
     iface.nanovdb_rgba8_from_voxelbvh = nanovdb_rgba8_from_voxelbvh;
     iface.nanovdb_rgba8_from_voxelbvh_array = nanovdb_rgba8_from_voxelbvh_array;
+    iface.nanovdb_generate_node_mask_array_async = nanovdb_generate_node_mask_array_async;
+    iface.nanovdb_add_nodes_from_ijkl_array_async = nanovdb_add_nodes_from_ijkl_array_async;
+    iface.ijkl_from_lines_array_async = ijkl_from_lines_array_async;
+    iface.ijkl_from_triangles_array_async = ijkl_from_triangles_array_async;
+    iface.nanovdb_duplicate_topology_array_async = nanovdb_duplicate_topology_array_async;
+    iface.nanovdb_rgba8_from_voxelbvh_array_async = nanovdb_rgba8_from_voxelbvh_array_async;
+    iface.ijkl_from_gaussians_array_async = ijkl_from_gaussians_array_async;
+    iface.future_get_frame = future_get_frame;
+    iface.future_is_completed = future_is_completed;
+    iface.future_wait = future_wait;
+    iface.future_take_result = future_take_result;
+    iface.future_destroy = future_destroy;
 
     return &iface;
 }
@@ -23,6 +23,7 @@
 #include <restinio/websocket/websocket.hpp>
 #include <map>
 #include <chrono>
+#include <string>
 
 #include <thread>
 #include <mutex>
@@ -88,8 +89,21 @@ struct server_instance_t
     std::vector<uint8_t> screenshot_data;
     uint32_t screenshot_width = 0u;
     uint32_t screenshot_height = 0u;
+
+    int traces_requested = 0;
+    int traces_pending = 0;
+    std::string trace_json;
+    std::atomic<pnanovdb_compute_trace_scope_t> trace_scope{ nullptr };
 };
 
+// same clock as the compute trace ring
+static pnanovdb_uint64_t trace_now()
+{
+    return (pnanovdb_uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
 PNANOVDB_CAST_PAIR(pnanovdb_server_instance_t, server_instance_t)
 
 static const uint32_t max_instances = 16;
@@ -108,6 +122,11 @@ void send_video(const asio::error_code& ec)
     {
         std::lock_guard<std::mutex> guard(g_mutex[instance_idx]);
 
+        pnanovdb_compute_trace_scope_t trace_scope =
+            g_server_instance[instance_idx] ? g_server_instance[instance_idx]->trace_scope.load() : nullptr;
+        pnanovdb_uint64_t trace_begin_ns = trace_scope ? trace_now() : 0llu;
+        pnanovdb_uint32_t sent_count = 0u;
+
         if (g_server_instance[instance_idx] && g_server_instance[instance_idx]->buffers.size() != 0u &&
             g_ws_registry[instance_idx].size() != 0u)
         {
@@ -146,9 +165,14 @@ void send_video(const asio::error_code& ec)
                                       restinio::writable_item_t(msg.dump()));
                     wsh->send_message(rws::final_frame_flag_t::final_frame, rws::opcode_t::binary_frame,
                                       restinio::writable_item_t(front));
+                    sent_count++;
                 }
             }
         }
+        if (trace_scope && sent_count > 0u)
+        {
+            trace_scope("server", "send_video", trace_begin_ns, trace_now());
+        }
 
         g_timer[instance_idx] = std::make_shared<restinio::asio_ns::steady_timer>(*g_ioctx[instance_idx]);
         g_timer[instance_idx]->expires_after(std::chrono::milliseconds(5));
@@ -236,6 +260,42 @@ std::unique_ptr<router_t> server_handler(restinio::asio_ns::io_context& ioctx)
                              .done();
                      });
 
+    router->http_get("/trace.json",
+                     [](auto req, auto params)
+                     {
+                         for (int attempt = 0; attempt < 60; attempt++)
+                         {
+                             {
+                                 std::lock_guard<std::mutex> guard(g_mutex[instance_idx]);
+                                 if (attempt == 0)
+                                 {
+                                     g_server_instance[instance_idx]->traces_requested++;
+                                 }
+                                 if (g_server_instance[instance_idx]->traces_pending > 0)
+                                 {
+                                     break;
+                                 }
+                             }
+                             std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                         }
+
+                         std::lock_guard<std::mutex> guard(g_mutex[instance_idx]);
+
+                         std::string json = "{\"traceEvents\":[]}\n";
+                         if (g_server_instance[instance_idx]->traces_pending > 0)
+                         {
+                             g_server_instance[instance_idx]->traces_pending = 0;
+                             json.swap(g_server_instance[instance_idx]->trace_json);
+                         }
+
+                         return req->create_response()
+                             .append_header(restinio::http_field::server, "NanoVDB Editor Server")
+                             .append_header_date_field()
+                             .append_header(restinio::http_field::content_type, "application/json")
+                             .set_body(json)
+                             .done();
+                     });
+
     router->http_get(
         "/ws",
         [&ioctx](auto req, auto params)
@@ -632,6 +692,37 @@ void push_screenshot(pnanovdb_server_instance_t* instance,
     }
 }
 
+pnanovdb_bool_t trace_requested(pnanovdb_server_instance_t* instance)
+{
+    auto ptr = cast(instance);
+    uint32_t instance_idx = ptr->instance_idx;
+
+    std::lock_guard<std::mutex> guard(g_mutex[instance_idx]);
+
+    return g_server_instance[instance_idx]->traces_requested > 0;
+}
+
+void push_trace(pnanovdb_server_instance_t* instance, const char* json, pnanovdb_uint64_t json_size)
+{
+    auto ptr = cast(instance);
+    uint32_t instance_idx = ptr->instance_idx;
+
+    std::lock_guard<std::mutex> guard(g_mutex[instance_idx]);
+
+    ptr->trace_json.assign(json, json + json_size);
+    ptr->traces_pending++;
+    if (ptr->traces_requested > 0)
+    {
+        ptr->traces_requested--;
+    }
+}
+
+void set_trace_scope(pnanovdb_server_instance_t* instance, pnanovdb_compute_trace_scope_t trace_scope)
+{
+    auto ptr = cast(instance);
+    ptr->trace_scope.store(trace_scope);
+}
+
 struct key_map_t
 {
     int key;
@@ -818,6 +909,9 @@ pnanovdb_server_t* pnanovdb_get_server()
     iface.destroy_instance = destroy_instance;
     iface.screenshot_requested = screenshot_requested;
     iface.push_screenshot = push_screenshot;
+    iface.trace_requested = trace_requested;
+    iface.push_trace = push_trace;
+    iface.set_trace_scope = set_trace_scope;
 
     return &iface;
 }
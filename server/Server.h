@@ -82,6 +82,15 @@ typedef struct pnanovdb_server_t
                                         pnanovdb_uint32_t width,
                                         pnanovdb_uint32_t height);
 
+    // GET /trace.json waits for the application to push an exported chrome trace
+    pnanovdb_bool_t(PNANOVDB_ABI* trace_requested)(pnanovdb_server_instance_t* instance);
+
+    void(PNANOVDB_ABI* push_trace)(pnanovdb_server_instance_t* instance, const char* json, pnanovdb_uint64_t json_size);
+
+    // websocket sends are reported as cpu scopes through trace_scope, null disables
+    void(PNANOVDB_ABI* set_trace_scope)(pnanovdb_server_instance_t* instance,
+                                        pnanovdb_compute_trace_scope_t trace_scope);
+
 } pnanovdb_server_t;
 
 #define PNANOVDB_REFLECT_TYPE pnanovdb_server_t
@@ -93,6 +102,9 @@ PNANOVDB_REFLECT_FUNCTION_POINTER(wait_until_active, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(destroy_instance, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(screenshot_requested, 0, 0)
 PNANOVDB_REFLECT_FUNCTION_POINTER(push_screenshot, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(trace_requested, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(push_trace, 0, 0)
+PNANOVDB_REFLECT_FUNCTION_POINTER(set_trace_scope, 0, 0)
 PNANOVDB_REFLECT_END(0)
 PNANOVDB_REFLECT_INTERFACE_IMPL()
 #undef PNANOVDB_REFLECT_TYPE
@@ -22,55 +22,73 @@
 namespace pnanovdb_vulkan
 {
 
-void buffer_createBuffer(Context* context, Buffer* ptr, const pnanovdb_compute_interop_handle_t* interopHandle)
+VkBufferUsageFlags buffer_getUsageFlags(Context* context, const pnanovdb_compute_buffer_desc_t* desc)
 {
-    auto loader = &context->deviceQueue->device->loader;
-    auto vulkanDevice = context->deviceQueue->device->vulkanDevice;
-
-    VkBufferCreateInfo bufCreateInfo = {};
-    bufCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufCreateInfo.size = ptr->desc.size_in_bytes;
-    bufCreateInfo.usage = 0u;
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT)
+    VkBufferUsageFlags usage = 0u;
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_CONSTANT)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+        usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
     }
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED)
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     }
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_BUFFER)
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_BUFFER)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
+        usage |= VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
     }
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED)
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     }
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_RW_BUFFER)
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_RW_BUFFER)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT;
+        usage |= VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT;
     }
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_INDIRECT)
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_INDIRECT)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
     }
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC)
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_SRC)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     }
-    if (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST)
+    if (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_COPY_DST)
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
     }
-    bufCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
     // enable device address on SSBO
     if (context->deviceQueue->device->enabledFeatures.bufferDeviceAddress &&
-        ((ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED) != 0u ||
-         (ptr->desc.usage & PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED) != 0u))
+        ((desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_STRUCTURED) != 0u ||
+         (desc->usage & PNANOVDB_COMPUTE_BUFFER_USAGE_RW_STRUCTURED) != 0u))
+    {
+        usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    }
+
+    return usage;
+}
+
+void buffer_createBuffer(Context* context, Buffer* ptr, const pnanovdb_compute_interop_handle_t* interopHandle)
+{
+    auto loader = &context->deviceQueue->device->loader;
+    auto vulkanDevice = context->deviceQueue->device->vulkanDevice;
+
+    VkBufferCreateInfo bufCreateInfo = {};
+    bufCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufCreateInfo.size = ptr->desc.size_in_bytes;
+    bufCreateInfo.usage = buffer_getUsageFlags(context, &ptr->desc);
+    bufCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // results of background work on the compute queue are consumed by the graphics queue without ownership transfers,
+    // the consuming flush makes them visible with a barrier, see resourceHazard_begin
+    auto device = context->deviceQueue->device;
+    uint32_t queueFamilies[2u] = { device->graphicsQueueFamilyIdx, device->computeQueueFamilyIdx };
+    if (queueFamilies[0u] != queueFamilies[1u])
     {
-        bufCreateInfo.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        bufCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufCreateInfo.queueFamilyIndexCount = 2u;
+        bufCreateInfo.pQueueFamilyIndices = queueFamilies;
     }
 
     VkExternalMemoryBufferCreateInfoKHR externalMemoryBufferCreateInfo = {};
@@ -91,6 +109,24 @@ void buffer_createBuffer(Context* context, Buffer* ptr, const pnanovdb_compute_i
     VkMemoryRequirements bufMemReq = {};
     loader->vkGetBufferMemoryRequirements(vulkanDevice, ptr->bufferVk, &bufMemReq);
 
+    // external memory is shared as a whole VkDeviceMemory, everything else is sub-allocated
+    if (!interopHandle && !bufCreateInfo.pNext)
+    {
+        if (memoryHeap_allocate(
+                context->deviceQueue->device, &bufMemReq, ptr->memory_type, PNANOVDB_TRUE, &ptr->allocation))
+        {
+            ptr->allocationBytes = ptr->allocation.sizeInBytes;
+            ptr->mappedData = ptr->allocation.mappedData;
+            buffer_bindPlaced(context, ptr, ptr->allocation.memoryVk, ptr->allocation.offset);
+        }
+        else
+        {
+            loader->vkDestroyBuffer(loader->device, ptr->bufferVk, nullptr);
+            ptr->bufferVk = VK_NULL_HANDLE;
+        }
+        return;
+    }
+
     uint32_t bufMemType = 0u;
     uint32_t bufMemType_sysmem = 0u;
     if (ptr->memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD)
@@ -188,8 +224,7 @@ void buffer_createBuffer(Context* context, Buffer* ptr, const pnanovdb_compute_i
     {
         ptr->allocationBytes = bufMemReq.size;
         device_reportMemoryAllocate(context->deviceQueue->device, ptr->memory_type, ptr->allocationBytes);
-
-        loader->vkBindBufferMemory(vulkanDevice, ptr->bufferVk, ptr->memoryVk, 0u);
+        context->deviceQueue->device->memoryStats.dedicated_allocation_count++;
 
         if (ptr->memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD ||
             ptr->memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK)
@@ -197,17 +232,7 @@ void buffer_createBuffer(Context* context, Buffer* ptr, const pnanovdb_compute_i
             loader->vkMapMemory(vulkanDevice, ptr->memoryVk, 0u, VK_WHOLE_SIZE, 0u, &ptr->mappedData);
         }
 
-        if (bufCreateInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
-        {
-            VkBufferDeviceAddressInfoKHR addressInfo = {};
-            addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
-            addressInfo.buffer = ptr->bufferVk;
-            ptr->bufferAddress = loader->vkGetBufferDeviceAddress(vulkanDevice, &addressInfo);
-
-            // context->deviceQueue->device->logPrint(
-            //     PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "bufferAddress(%zu) allocationBytes(%zu)", ptr->bufferAddress,
-            //     ptr->allocationBytes);
-        }
+        buffer_bindPlaced(context, ptr, ptr->memoryVk, 0u);
     }
     else // free buffer and set null
     {
@@ -216,6 +241,53 @@ void buffer_createBuffer(Context* context, Buffer* ptr, const pnanovdb_compute_i
     }
 }
 
+void buffer_bindPlaced(Context* context, Buffer* ptr, VkDeviceMemory memoryVk, pnanovdb_uint64_t offset)
+{
+    auto loader = &context->deviceQueue->device->loader;
+    auto vulkanDevice = context->deviceQueue->device->vulkanDevice;
+
+    loader->vkBindBufferMemory(vulkanDevice, ptr->bufferVk, memoryVk, offset);
+
+    if (buffer_getUsageFlags(context, &ptr->desc) & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+    {
+        VkBufferDeviceAddressInfoKHR addressInfo = {};
+        addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
+        addressInfo.buffer = ptr->bufferVk;
+        ptr->bufferAddress = loader->vkGetBufferDeviceAddress(vulkanDevice, &addressInfo);
+    }
+}
+
+// creates the VkBuffer only, the caller places it in memory it owns with buffer_bindPlaced()
+Buffer* buffer_createUnbound(Context* context,
+                             const pnanovdb_compute_buffer_desc_t* desc,
+                             VkMemoryRequirements* pMemReq)
+{
+    auto loader = &context->deviceQueue->device->loader;
+    auto vulkanDevice = context->deviceQueue->device->vulkanDevice;
+
+    auto ptr = new Buffer();
+    ptr->desc = *desc;
+    ptr->memory_type = PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE;
+    ptr->isMemoryAliased = PNANOVDB_TRUE;
+
+    VkBufferCreateInfo bufCreateInfo = {};
+    bufCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufCreateInfo.size = desc->size_in_bytes;
+    bufCreateInfo.usage = buffer_getUsageFlags(context, desc);
+    bufCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    loader->vkCreateBuffer(vulkanDevice, &bufCreateInfo, nullptr, &ptr->bufferVk);
+    if (!ptr->bufferVk)
+    {
+        delete ptr;
+        return nullptr;
+    }
+    loader->vkGetBufferMemoryRequirements(vulkanDevice, ptr->bufferVk, pMemReq);
+    ptr->aliasMemReq = *pMemReq;
+
+    return ptr;
+}
+
 void buffer_createBufferView(Context* context, Buffer* ptr, VkBufferView* view)
 {
     auto loader = &context->deviceQueue->device->loader;
@@ -366,6 +438,12 @@ void buffer_destroy(Context* context, Buffer* ptr)
         loader->vkFreeMemory(loader->device, ptr->memoryVk, nullptr);
 
         device_reportMemoryFree(context->deviceQueue->device, ptr->memory_type, ptr->allocationBytes);
+        context->deviceQueue->device->memoryStats.dedicated_allocation_count--;
+    }
+    else if (ptr->allocation.block || ptr->isMemoryAliased)
+    {
+        loader->vkDestroyBuffer(loader->device, ptr->bufferVk, nullptr);
+        memoryHeap_free(context->deviceQueue->device, &ptr->allocation);
     }
 
     delete ptr;
@@ -380,6 +458,23 @@ pnanovdb_bool_t bufferDesc_compare(const pnanovdb_compute_buffer_desc_t* a, cons
     return PNANOVDB_FALSE;
 }
 
+void buffer_placeAliased(Context* context, Buffer* ptr, VkDeviceMemory memoryVk, pnanovdb_uint64_t offset)
+{
+    buffer_bindPlaced(context, ptr, memoryVk, offset);
+    buffer_createBufferView(context, ptr, &ptr->bufferViewVk);
+
+    buffer_initRestoreBarrier(context, ptr);
+    buffer_resetAliased(context, ptr);
+}
+
+void buffer_resetAliased(Context* context, Buffer* ptr)
+{
+    buffer_initCurrentBarrier(context, ptr);
+
+    // earlier transients sharing this range may have written it, so the first barrier must cover those writes
+    ptr->currentBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+}
+
 pnanovdb_compute_buffer_t* createBuffer(pnanovdb_compute_context_t* contextIn,
                                         pnanovdb_compute_memory_type_t memory_type,
                                         const pnanovdb_compute_buffer_desc_t* desc)
@@ -31,6 +31,53 @@ pnanovdb_uint32_t computePipeline_computeNumSets(pnanovdb_uint32_t descriptorsPe
     return numSets;
 }
 
+static void computePipeline_createUpdateTemplate(Context* context, ComputePipeline* ptr)
+{
+    auto device = context->deviceQueue->device;
+    auto loader = &device->loader;
+
+    if (device->descriptorUpdateMode == PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_WRITES || ptr->bindings.empty())
+    {
+        return;
+    }
+
+    std::vector<VkDescriptorUpdateTemplateEntry> entries;
+    for (pnanovdb_uint32_t idx = 0u; idx < ptr->bindings.size(); idx++)
+    {
+        // arrays are written element by element, leave those to the write path
+        if (ptr->bindings[idx].descriptorCount != 1u)
+        {
+            return;
+        }
+        VkDescriptorUpdateTemplateEntry entry = {};
+        entry.dstBinding = ptr->bindings[idx].binding;
+        entry.dstArrayElement = 0u;
+        entry.descriptorCount = 1u;
+        entry.descriptorType = ptr->bindings[idx].descriptorType;
+        entry.offset = idx * sizeof(DescriptorData);
+        entry.stride = sizeof(DescriptorData);
+        entries.push_back(entry);
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo templateCreateInfo = {};
+    templateCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    templateCreateInfo.descriptorUpdateEntryCount = (uint32_t)entries.size();
+    templateCreateInfo.pDescriptorUpdateEntries = entries.data();
+    templateCreateInfo.templateType = ptr->usePushDescriptors ?
+                                          VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR :
+                                          VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    templateCreateInfo.descriptorSetLayout = ptr->descriptorSetLayout;
+    templateCreateInfo.pipelineBindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+    templateCreateInfo.pipelineLayout = ptr->pipelineLayout;
+    templateCreateInfo.set = 0u;
+
+    if (loader->vkCreateDescriptorUpdateTemplate(
+            device->vulkanDevice, &templateCreateInfo, nullptr, &ptr->updateTemplate) != VK_SUCCESS)
+    {
+        ptr->updateTemplate = VK_NULL_HANDLE;
+    }
+}
+
 pnanovdb_compute_pipeline_t* createComputePipeline(pnanovdb_compute_context_t* contextIn,
                                                    const pnanovdb_compute_pipeline_desc_t* desc)
 {
@@ -94,10 +141,18 @@ pnanovdb_compute_pipeline_t* createComputePipeline(pnanovdb_compute_context_t* c
             ptr->bindings.push_back(binding);
         }
 
+        auto device = context->deviceQueue->device;
+        ptr->usePushDescriptors = device->descriptorUpdateMode == PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_PUSH &&
+                                  ptr->totalDescriptors > 0u && ptr->totalDescriptors <= device->maxPushDescriptors;
+
         VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo = {};
         descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
         descriptorSetLayoutInfo.bindingCount = (uint32_t)ptr->bindings.size();
         descriptorSetLayoutInfo.pBindings = ptr->bindings.data();
+        if (ptr->usePushDescriptors)
+        {
+            descriptorSetLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        }
 
         loader->vkCreateDescriptorSetLayout(vulkanDevice, &descriptorSetLayoutInfo, nullptr, &ptr->descriptorSetLayout);
 
@@ -188,8 +243,8 @@ pnanovdb_compute_pipeline_t* createComputePipeline(pnanovdb_compute_context_t* c
             createInfo.pNext = &createFlags;
         }
 
-        VkResult result =
-            loader->vkCreateComputePipelines(vulkanDevice, VK_NULL_HANDLE, 1u, &createInfo, nullptr, &ptr->pipeline);
+        VkResult result = loader->vkCreateComputePipelines(
+            vulkanDevice, context->pipelineCache, 1u, &createInfo, nullptr, &ptr->pipeline);
 
         if (result != VK_SUCCESS)
         {
@@ -207,6 +262,8 @@ pnanovdb_compute_pipeline_t* createComputePipeline(pnanovdb_compute_context_t* c
         ptr->module = VK_NULL_HANDLE;
     }
 
+    computePipeline_createUpdateTemplate(context, ptr);
+
     return cast(ptr);
 }
 
@@ -240,6 +297,12 @@ void computePipeline_destroy(Context* context, pnanovdb_compute_pipeline_t* pipe
         }
     }
 
+    if (ptr->updateTemplate)
+    {
+        loader->vkDestroyDescriptorUpdateTemplate(loader->device, ptr->updateTemplate, nullptr);
+        ptr->updateTemplate = VK_NULL_HANDLE;
+    }
+
     loader->vkDestroyDescriptorSetLayout(loader->device, ptr->descriptorSetLayout, nullptr);
     loader->vkDestroyPipelineLayout(loader->device, ptr->pipelineLayout, nullptr);
     loader->vkDestroyPipeline(loader->device, ptr->pipeline, nullptr);
@@ -337,37 +400,28 @@ VkDescriptorSet computePipeline_allocate(Context* context, ComputePipeline* ptr)
     return descriptorSet;
 }
 
-void computePipeline_updateDescriptorSet(Context* context,
-                                         ComputePipeline* ptr,
-                                         VkDescriptorSet descriptorSet,
-                                         const pnanovdb_compute_dispatch_params_t* params)
+// fills descriptorData in write order, returns true if the writes line up with the update template entries
+static pnanovdb_bool_t computePipeline_fillDescriptorData(Context* context,
+                                                          ComputePipeline* ptr,
+                                                          const pnanovdb_compute_dispatch_params_t* params)
 {
-    auto loader = &context->deviceQueue->device->loader;
-    auto vulkanDevice = context->deviceQueue->device->vulkanDevice;
-
-    ptr->descriptorWrites.reserve(params->descriptor_write_count);
-    ptr->descriptorWrites.resize(0u);
-
-    ptr->bufferInfos.reserve(params->descriptor_write_count);
-    ptr->bufferViews.reserve(params->descriptor_write_count);
-    ptr->imageInfos.reserve(params->descriptor_write_count);
+    pnanovdb_bool_t templateMatch = ptr->updateTemplate && params->descriptor_write_count == ptr->bindings.size();
 
-    ptr->bufferInfos.resize(0u);
-    ptr->bufferViews.resize(0u);
-    ptr->imageInfos.resize(0u);
+    ptr->descriptorData.resize(params->descriptor_write_count);
     for (pnanovdb_uint32_t idx = 0u; idx < params->descriptor_write_count; idx++)
     {
         auto descriptorWrite = &params->descriptor_writes[idx];
         auto resource = &params->resources[idx];
+        DescriptorData& data = ptr->descriptorData[idx];
+        data = {};
 
-        VkWriteDescriptorSet output = {};
-        output.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        output.pNext = nullptr;
-        output.dstSet = descriptorSet;
-        output.dstBinding = descriptorWrite->write.vulkan.binding;
-        output.dstArrayElement = descriptorWrite->write.vulkan.array_index;
-        output.descriptorCount = 1u;
-        output.descriptorType = ptr->pnanovdbDescriptorType_to_vkDescriptorType[descriptorWrite->type];
+        if (templateMatch && (descriptorWrite->write.vulkan.binding != ptr->bindings[idx].binding ||
+                              descriptorWrite->write.vulkan.array_index != 0u ||
+                              ptr->pnanovdbDescriptorType_to_vkDescriptorType[descriptorWrite->type] !=
+                                  ptr->bindings[idx].descriptorType))
+        {
+            templateMatch = PNANOVDB_FALSE;
+        }
 
         if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_CONSTANT_BUFFER ||
             descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER ||
@@ -375,28 +429,21 @@ void computePipeline_updateDescriptorSet(Context* context,
         {
             Buffer* buffer = cast(resource->buffer_transient)->buffer;
 
-            VkDescriptorBufferInfo bufferInfo = {};
-            bufferInfo.buffer = buffer->bufferVk;
-            bufferInfo.offset = 0llu;
-            bufferInfo.range = VK_WHOLE_SIZE;
-
-            output.pBufferInfo = ptr->bufferInfos.data() + ptr->bufferInfos.size();
-            ptr->bufferInfos.push_back(bufferInfo);
+            data.bufferInfo.buffer = buffer->bufferVk;
+            data.bufferInfo.offset = 0llu;
+            data.bufferInfo.range = VK_WHOLE_SIZE;
         }
         else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER ||
                  descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_BUFFER)
         {
             Buffer* buffer = cast(resource->buffer_transient)->buffer;
-            VkBufferView bufferView =
-                buffer_getBufferView(context, buffer, cast(resource->buffer_transient)->aliasFormat);
-            output.pTexelBufferView = ptr->bufferViews.data() + ptr->bufferViews.size();
-            ptr->bufferViews.push_back(bufferView);
+            data.bufferView = buffer_getBufferView(context, buffer, cast(resource->buffer_transient)->aliasFormat);
         }
         else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE ||
                  descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_SAMPLER ||
                  descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_TEXTURE)
         {
-            VkDescriptorImageInfo imageInfo = {};
+            VkDescriptorImageInfo& imageInfo = data.imageInfo;
             if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_TEXTURE)
             {
                 imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
@@ -424,16 +471,48 @@ void computePipeline_updateDescriptorSet(Context* context,
                     texture_getImageViewMipLevel(context, texture, cast(resource->texture_transient)->aliasFormat,
                                                  cast(resource->texture_transient)->aliasAspect);
             }
+        }
+    }
+    return templateMatch;
+}
 
-            output.pImageInfo = ptr->imageInfos.data() + ptr->imageInfos.size();
-            ptr->imageInfos.push_back(imageInfo);
+// builds VkWriteDescriptorSet entries pointing into descriptorData, dstSet is ignored for push descriptors
+static void computePipeline_buildDescriptorWrites(ComputePipeline* ptr,
+                                                  VkDescriptorSet descriptorSet,
+                                                  const pnanovdb_compute_dispatch_params_t* params)
+{
+    ptr->descriptorWrites.resize(0u);
+    for (pnanovdb_uint32_t idx = 0u; idx < params->descriptor_write_count; idx++)
+    {
+        auto descriptorWrite = &params->descriptor_writes[idx];
+
+        VkWriteDescriptorSet output = {};
+        output.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        output.pNext = nullptr;
+        output.dstSet = descriptorSet;
+        output.dstBinding = descriptorWrite->write.vulkan.binding;
+        output.dstArrayElement = descriptorWrite->write.vulkan.array_index;
+        output.descriptorCount = 1u;
+        output.descriptorType = ptr->pnanovdbDescriptorType_to_vkDescriptorType[descriptorWrite->type];
+
+        if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_CONSTANT_BUFFER ||
+            descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER ||
+            descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER)
+        {
+            output.pBufferInfo = &ptr->descriptorData[idx].bufferInfo;
+        }
+        else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER ||
+                 descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_BUFFER)
+        {
+            output.pTexelBufferView = &ptr->descriptorData[idx].bufferView;
+        }
+        else
+        {
+            output.pImageInfo = &ptr->descriptorData[idx].imageInfo;
         }
 
         ptr->descriptorWrites.push_back(output);
     }
-
-    loader->vkUpdateDescriptorSets(
-        vulkanDevice, (uint32_t)ptr->descriptorWrites.size(), ptr->descriptorWrites.data(), 0u, nullptr);
 }
 
 void computePipeline_dispatch(Context* context, const pnanovdb_compute_dispatch_params_t* params)
@@ -454,14 +533,49 @@ void computePipeline_dispatch(Context* context, const pnanovdb_compute_dispatch_
     pnanovdb_uint32_t grid_dim_y = params->grid_dim_y;
     pnanovdb_uint32_t grid_dim_z = params->grid_dim_z;
 
-    VkDescriptorSet descriptorSet = computePipeline_allocate(context, ptr);
+    VkCommandBuffer commandBuffer = context->deviceQueue->commandBuffer;
 
-    computePipeline_updateDescriptorSet(context, ptr, descriptorSet, params);
+    pnanovdb_bool_t templateMatch = computePipeline_fillDescriptorData(context, ptr, params);
+    if (ptr->usePushDescriptors)
+    {
+        if (templateMatch)
+        {
+            loader->vkCmdPushDescriptorSetWithTemplateKHR(
+                commandBuffer, ptr->updateTemplate, ptr->pipelineLayout, 0u, ptr->descriptorData.data());
+        }
+        else
+        {
+            computePipeline_buildDescriptorWrites(ptr, VK_NULL_HANDLE, params);
+            loader->vkCmdPushDescriptorSetKHR(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ptr->pipelineLayout, 0u,
+                                              (uint32_t)ptr->descriptorWrites.size(), ptr->descriptorWrites.data());
+        }
+    }
+    else
+    {
+        VkDescriptorSet descriptorSet = computePipeline_allocate(context, ptr);
+        if (templateMatch)
+        {
+            loader->vkUpdateDescriptorSetWithTemplate(
+                vulkanDevice, descriptorSet, ptr->updateTemplate, ptr->descriptorData.data());
+        }
+        else
+        {
+            computePipeline_buildDescriptorWrites(ptr, descriptorSet, params);
+            loader->vkUpdateDescriptorSets(
+                vulkanDevice, (uint32_t)ptr->descriptorWrites.size(), ptr->descriptorWrites.data(), 0u, nullptr);
+        }
+        loader->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ptr->pipelineLayout, 0u, 1u,
+                                        &descriptorSet, 0u, nullptr);
+    }
 
-    loader->vkCmdBindDescriptorSets(context->deviceQueue->commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                                    ptr->pipelineLayout, 0u, 1u, &descriptorSet, 0u, nullptr);
+    loader->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ptr->pipeline);
 
-    loader->vkCmdBindPipeline(context->deviceQueue->commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ptr->pipeline);
+    if (params->indirect_buffer)
+    {
+        loader->vkCmdDispatchIndirect(
+            commandBuffer, cast(params->indirect_buffer)->buffer->bufferVk, params->indirect_offset);
+        return;
+    }
 
     if ((grid_dim_x > 65535 || grid_dim_y > 65535 || grid_dim_z > 65535) && !ptr->has_warned_grid_dim)
     {
@@ -473,7 +587,7 @@ void computePipeline_dispatch(Context* context, const pnanovdb_compute_dispatch_
 
     if (grid_dim_x > 0 && grid_dim_y > 0 && grid_dim_z > 0)
     {
-        loader->vkCmdDispatch(context->deviceQueue->commandBuffer, grid_dim_x, grid_dim_y, grid_dim_z);
+        loader->vkCmdDispatch(commandBuffer, grid_dim_x, grid_dim_y, grid_dim_z);
     }
 }
 
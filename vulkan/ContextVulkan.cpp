@@ -29,6 +29,8 @@ Context* context_create(DeviceQueue* deviceQueue)
 
     ptr->deviceQueue = deviceQueue;
 
+    context_createPipelineCache(ptr);
+
     pnanovdb_compute_sampler_desc_t samplerDesc = {};
     samplerDesc.address_mode_u = PNANOVDB_COMPUTE_SAMPLER_ADDRESS_MODE_BORDER;
     samplerDesc.address_mode_v = PNANOVDB_COMPUTE_SAMPLER_ADDRESS_MODE_BORDER;
@@ -46,10 +48,12 @@ void context_destroy(Context* ptr)
 {
     profiler_destroy(ptr, ptr->profiler);
 
+    context_destroyTransientArenas(ptr, PNANOVDB_TRUE);
     context_destroyBuffers(ptr);
     context_destroyTextures(ptr);
     context_destroySamplers(ptr);
     context_destroyComputePipelines(ptr);
+    context_destroyPipelineCache(ptr);
 
     delete ptr;
 }
@@ -68,6 +72,7 @@ void context_resetNode(ContextNode* node)
 
     node->bufferBarriers.resize(0u);
     node->imageBarriers.resize(0u);
+    node->barrier = NodeBarrierMasks{};
 }
 
 void addPassCompute(pnanovdb_compute_context_t* contextIn, const pnanovdb_compute_dispatch_params_t* params)
@@ -85,6 +90,16 @@ void addPassCompute(pnanovdb_compute_context_t* contextIn, const pnanovdb_comput
         node->descriptorWrites.push_back(params->descriptor_writes[descriptorIdx]);
         node->resources.push_back(params->resources[descriptorIdx]);
     }
+    // tracked past descriptor_write_count, so the args are visible to barriers without being bound
+    if (params->indirect_buffer)
+    {
+        pnanovdb_compute_resource_t indirect = {};
+        indirect.buffer_transient = params->indirect_buffer;
+
+        node->descriptorWrites.push_back(
+            pnanovdb_compute_descriptor_write_t{ PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_INDIRECT_BUFFER });
+        node->resources.push_back(indirect);
+    }
     node->params.compute.descriptor_writes = node->descriptorWrites.data();
     node->params.compute.resources = node->resources.data();
 }
@@ -112,6 +127,15 @@ void addPassCopyBuffer(pnanovdb_compute_context_t* contextIn, const pnanovdb_com
     node->resources.push_back(dst);
 }
 
+struct NodeResourceAccess
+{
+    Buffer* buffer;
+    Texture* texture;
+    VkPipelineStageFlags stageMask;
+    VkAccessFlags accessMask;
+    VkImageLayout layout;
+};
+
 void context_flushNodes(Context* context)
 {
     auto loader = &context->deviceQueue->device->loader;
@@ -257,6 +281,9 @@ void context_flushNodes(Context* context)
             transient->texture->lastActive = context->deviceQueue->nextFenceValue;
         }
     }
+    // place buffers with disjoint lifetimes in shared memory
+    context_aliasTransientBuffers(context);
+
     // resolve transient resources
     for (pnanovdb_uint32_t nodeIdx = 0u; nodeIdx < context->nodes.size(); nodeIdx++)
     {
@@ -270,7 +297,7 @@ void context_flushNodes(Context* context)
                 transient->buffer = transient->aliasBuffer->buffer;
                 transient->buffer->refCount++;
             }
-            else
+            else if (!transient->memoryAliased)
             {
                 if (transient->buffer)
                 {
@@ -329,104 +356,109 @@ void context_flushNodes(Context* context)
         }
     }
 
-    // precompute barriers
+    // precompute barriers, each node waits only on the earlier nodes it has a hazard with
+    context->flushIdx = ++context->deviceQueue->device->flushCounter;
     for (pnanovdb_uint32_t nodeIdx = 0u; nodeIdx < context->nodes.size(); nodeIdx++)
     {
         ContextNode* node = &context->nodes[nodeIdx];
+
+        // merge descriptors referencing the same resource, so a node never waits on itself
+        std::vector<NodeResourceAccess> accesses;
         for (pnanovdb_uint32_t descriptorIdx = 0u; descriptorIdx < node->descriptorWrites.size(); descriptorIdx++)
         {
             pnanovdb_compute_descriptor_write_t* descriptorWrite = &node->descriptorWrites[descriptorIdx];
             pnanovdb_compute_resource_t* resource = &node->resources[descriptorIdx];
 
+            NodeResourceAccess access = {};
             if (resource->buffer_transient)
             {
-                Buffer* buffer = cast(resource->buffer_transient)->buffer;
+                access.buffer = cast(resource->buffer_transient)->buffer;
+            }
+            else if (resource->texture_transient)
+            {
+                access.texture = cast(resource->texture_transient)->texture;
+            }
+            if (!access.buffer && !access.texture)
+            {
+                continue;
+            }
+            context_getDescriptorAccess(descriptorWrite->type, &access.stageMask, &access.accessMask, &access.layout);
+
+            pnanovdb_bool_t merged = PNANOVDB_FALSE;
+            for (pnanovdb_uint64_t accessIdx = 0u; accessIdx < accesses.size(); accessIdx++)
+            {
+                NodeResourceAccess* other = &accesses[accessIdx];
+                if (other->buffer == access.buffer && other->texture == access.texture)
+                {
+                    context_mergeDescriptorAccess(&other->stageMask, &other->accessMask, &other->layout,
+                                                  access.stageMask, access.accessMask, access.layout);
+                    merged = PNANOVDB_TRUE;
+                    break;
+                }
+            }
+            if (!merged)
+            {
+                accesses.push_back(access);
+            }
+        }
+
+        for (pnanovdb_uint64_t accessIdx = 0u; accessIdx < accesses.size(); accessIdx++)
+        {
+            const NodeResourceAccess& access = accesses[accessIdx];
+
+            VkAccessFlags srcAccessMask = 0u;
+            if (access.buffer)
+            {
+                Buffer* buffer = access.buffer;
+
+                pnanovdb_bool_t needsBarrier = resourceHazard_addNodeAccess(
+                    &buffer->hazard, context->deviceQueue, context->flushIdx, buffer->isMemoryAliased,
+                    access.stageMask, access.accessMask, PNANOVDB_FALSE, &node->barrier, &srcAccessMask);
 
                 VkBufferMemoryBarrier bufferBarrier = buffer->currentBarrier;
 
                 // new becomes old
-                bufferBarrier.srcAccessMask = bufferBarrier.dstAccessMask;
+                bufferBarrier.srcAccessMask = srcAccessMask;
                 bufferBarrier.srcQueueFamilyIndex = bufferBarrier.dstQueueFamilyIndex;
 
                 // establish new
-                if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_CONSTANT_BUFFER ||
-                    descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER ||
-                    descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER)
-                {
-                    bufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-                }
-                else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER ||
-                         descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_BUFFER)
-                {
-                    bufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-                }
-                else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_INDIRECT_BUFFER)
-                {
-                    bufferBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
-                }
-                else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_SRC)
-                {
-                    bufferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                }
-                else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_DST)
-                {
-                    bufferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                }
+                bufferBarrier.dstAccessMask = access.accessMask;
                 bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-                // capture barrier
-                node->bufferBarriers.push_back(bufferBarrier);
+                if (needsBarrier)
+                {
+                    node->bufferBarriers.push_back(bufferBarrier);
+                }
 
                 buffer->currentBarrier = bufferBarrier;
             }
-            if (resource->texture_transient)
+            if (access.texture)
             {
-                Texture* texture = cast(resource->texture_transient)->texture;
+                Texture* texture = access.texture;
+
+                pnanovdb_bool_t layoutTransition = texture->currentBarrier.newLayout != access.layout;
+                pnanovdb_bool_t needsBarrier = resourceHazard_addNodeAccess(
+                    &texture->hazard, context->deviceQueue, context->flushIdx, PNANOVDB_FALSE, access.stageMask,
+                    access.accessMask, layoutTransition, &node->barrier, &srcAccessMask);
 
                 VkImageMemoryBarrier imageBarrier = texture->currentBarrier;
 
                 // new becomes old
-                imageBarrier.srcAccessMask = imageBarrier.dstAccessMask;
+                imageBarrier.srcAccessMask = srcAccessMask;
                 imageBarrier.oldLayout = imageBarrier.newLayout;
                 imageBarrier.srcQueueFamilyIndex = imageBarrier.dstQueueFamilyIndex;
 
                 // establish new
-                if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE)
-                {
-                    imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-                    imageBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                }
-                else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_TEXTURE)
-                {
-                    imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-                    imageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-                }
-                else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE_COPY_SRC)
-                {
-                    imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                    imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                }
-                else if (descriptorWrite->type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE_COPY_DST)
-                {
-                    imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                    imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                }
+                imageBarrier.dstAccessMask = access.accessMask;
+                imageBarrier.newLayout = access.layout;
                 imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-                // commit barrier, except if multiple reads detected
-                pnanovdb_bool_t shouldCommit = PNANOVDB_TRUE;
-                if (imageBarrier.newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
-                    imageBarrier.newLayout == imageBarrier.oldLayout &&
-                    imageBarrier.dstAccessMask == imageBarrier.srcAccessMask)
-                {
-                    shouldCommit = PNANOVDB_FALSE;
-                }
-                if (shouldCommit)
+                if (needsBarrier)
                 {
                     node->imageBarriers.push_back(imageBarrier);
-
-                    texture->currentBarrier = imageBarrier;
                 }
+
+                texture->currentBarrier = imageBarrier;
             }
         }
     }
@@ -438,12 +470,20 @@ void context_flushNodes(Context* context)
     {
         ContextNode* node = &context->nodes[nodeIdx];
 
-        if (node->bufferBarriers.size() > 0u || node->imageBarriers.size() > 0u)
+        pnanovdb_uint32_t barrierCount = 0u;
+        if (node->barrier.dstStageMask != 0u)
         {
-            loader->vkCmdPipelineBarrier(context->deviceQueue->commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0u, nullptr,
+            // first use layout transitions have nothing to wait on
+            VkPipelineStageFlags srcStageMask =
+                node->barrier.srcStageMask != 0u ? node->barrier.srcStageMask : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            VkMemoryBarrier memoryBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr,
+                                              node->barrier.memorySrcAccessMask, node->barrier.memoryDstAccessMask };
+            uint32_t memoryBarrierCount = node->barrier.memoryDstAccessMask != 0u ? 1u : 0u;
+            loader->vkCmdPipelineBarrier(context->deviceQueue->commandBuffer, srcStageMask,
+                                         node->barrier.dstStageMask, 0, memoryBarrierCount, &memoryBarrier,
                                          (uint32_t)node->bufferBarriers.size(), node->bufferBarriers.data(),
                                          (uint32_t)node->imageBarriers.size(), node->imageBarriers.data());
+            barrierCount++;
         }
 
         if (node->type == eContextNodeType_compute)
@@ -480,14 +520,10 @@ void context_flushNodes(Context* context)
             }
         }
 
-        profiler_timestamp(context, context->profiler, node->label);
+        profiler_timestamp(context, context->profiler, node->label, barrierCount);
     }
 
-    profiler_endCapture(context, context->profiler);
-
-    profiler_processCaptures(context, context->profiler);
-
-    // restore resource states
+    // restore resource states, access masks alone are covered by the global barrier
     context->restore_bufferBarriers.resize(0u);
     context->restore_imageBarriers.resize(0u);
     for (pnanovdb_uint32_t idx = 0u; idx < context->bufferTransients.size(); idx++)
@@ -507,8 +543,11 @@ void context_flushNodes(Context* context)
             bufferBarrier.dstAccessMask = buffer->restoreBarrier.dstAccessMask;
             bufferBarrier.dstQueueFamilyIndex = buffer->restoreBarrier.dstQueueFamilyIndex;
 
-            // capture
-            context->restore_bufferBarriers.push_back(bufferBarrier);
+            // capture only ownership transfers
+            if (bufferBarrier.srcQueueFamilyIndex != bufferBarrier.dstQueueFamilyIndex)
+            {
+                context->restore_bufferBarriers.push_back(bufferBarrier);
+            }
 
             buffer->currentBarrier = bufferBarrier;
         }
@@ -532,42 +571,34 @@ void context_flushNodes(Context* context)
             imageBarrier.newLayout = texture->restoreBarrier.newLayout;
             imageBarrier.dstQueueFamilyIndex = texture->restoreBarrier.dstQueueFamilyIndex;
 
-            // commit barrier, except if multiple reads detected
-            pnanovdb_bool_t shouldCommit = PNANOVDB_TRUE;
-            if (imageBarrier.newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
-                imageBarrier.newLayout == imageBarrier.oldLayout &&
-                imageBarrier.dstAccessMask == imageBarrier.srcAccessMask)
-            {
-                shouldCommit = PNANOVDB_FALSE;
-            }
-            if (shouldCommit)
+            // commit barrier, only for layout transitions and ownership transfers
+            if (imageBarrier.newLayout != imageBarrier.oldLayout ||
+                imageBarrier.srcQueueFamilyIndex != imageBarrier.dstQueueFamilyIndex)
             {
                 context->restore_imageBarriers.push_back(imageBarrier);
-
-                texture->currentBarrier = imageBarrier;
             }
+
+            texture->currentBarrier = imageBarrier;
         }
     }
-    if (context->restore_bufferBarriers.size() > 0u || context->restore_imageBarriers.size() > 0u)
-    {
-        loader->vkCmdPipelineBarrier(
-            context->deviceQueue->commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-            0, 0u, nullptr, (uint32_t)context->restore_bufferBarriers.size(), context->restore_bufferBarriers.data(),
-            (uint32_t)context->restore_imageBarriers.size(), context->restore_imageBarriers.data());
-    }
 
-    // global barrier
+    // global barrier, orders this flush against the next one and carries the restore transitions
     {
-        VkMemoryBarrier barriers[3u] = {
-            { VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT },
-            { VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, VK_ACCESS_MEMORY_READ_BIT, VK_ACCESS_MEMORY_WRITE_BIT },
-            { VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_WRITE_BIT },
-        };
+        VkMemoryBarrier memoryBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, VK_ACCESS_MEMORY_WRITE_BIT,
+                                          VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT };
 
         loader->vkCmdPipelineBarrier(context->deviceQueue->commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                     VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 3u, barriers, 0u, nullptr, 0u, nullptr);
+                                     VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1u, &memoryBarrier,
+                                     (uint32_t)context->restore_bufferBarriers.size(),
+                                     context->restore_bufferBarriers.data(),
+                                     (uint32_t)context->restore_imageBarriers.size(),
+                                     context->restore_imageBarriers.data());
     }
 
+    profiler_endCapture(context, context->profiler, 1u);
+
+    profiler_processCaptures(context, context->profiler);
+
     // process buffer acquires
     {
         for (pnanovdb_uint32_t idx = 0u; idx < context->bufferAcquires.size(); idx++)
@@ -678,6 +709,245 @@ void context_flushNodes(Context* context)
             context->pool_textures.erase(context->pool_textures.begin() + idx);
         }
     }
+    context_destroyTransientArenas(context, PNANOVDB_FALSE);
+}
+
+struct TransientPlacement
+{
+    BufferTransient* transient;
+    Buffer* buffer;
+    pnanovdb_uint64_t offset;
+    pnanovdb_uint64_t sizeInBytes;
+    pnanovdb_uint64_t alignment;
+};
+
+void context_aliasTransientBuffers(Context* context)
+{
+    auto device = context->deviceQueue->device;
+    int nodeCount = int(context->nodes.size());
+
+    device->memoryStats.transient_requested_bytes = 0u;
+    device->memoryStats.transient_arena_bytes = 0u;
+
+    // exportable memory cannot be shared between buffers
+    if (device->desc.enable_external_usage)
+    {
+        return;
+    }
+
+    // memory must outlive every transient aliasing it
+    for (pnanovdb_uint32_t idx = 0u; idx < context->bufferTransients.size(); idx++)
+    {
+        auto transient = context->bufferTransients[idx].get();
+        transient->memoryAliased = PNANOVDB_FALSE;
+        transient->memoryNodeBegin = transient->nodeBegin;
+        transient->memoryNodeEnd = transient->nodeEnd;
+    }
+    for (pnanovdb_uint32_t idx = 0u; idx < context->bufferTransients.size(); idx++)
+    {
+        auto transient = context->bufferTransients[idx].get();
+        if (!transient->aliasBuffer || transient->nodeEnd == -1)
+        {
+            continue;
+        }
+        BufferTransient* root = transient->aliasBuffer;
+        while (root->aliasBuffer)
+        {
+            root = root->aliasBuffer;
+        }
+        root->memoryNodeBegin = std::min(root->memoryNodeBegin, transient->nodeBegin);
+        root->memoryNodeEnd = std::max(root->memoryNodeEnd, transient->nodeEnd);
+    }
+
+    // only buffers created and destroyed within this flush qualify, acquired and captured buffers live on
+    std::vector<TransientPlacement> placements;
+    for (pnanovdb_uint32_t idx = 0u; idx < context->bufferTransients.size(); idx++)
+    {
+        auto transient = context->bufferTransients[idx].get();
+        if (!transient->aliasBuffer && !transient->buffer && transient->memoryNodeBegin >= 0 &&
+            transient->memoryNodeEnd >= transient->memoryNodeBegin && transient->memoryNodeEnd < nodeCount)
+        {
+            placements.push_back(TransientPlacement{ transient, nullptr, 0u, 0u, 1u });
+        }
+    }
+    if (placements.size() < 2u)
+    {
+        return;
+    }
+
+    // identical create info gives identical requirements, so only descs never seen before need a VkBuffer here
+    uint32_t memoryTypeBits = ~0u;
+    pnanovdb_uint64_t maxAlignment = 1u;
+    for (pnanovdb_uint64_t idx = 0u; idx < placements.size(); idx++)
+    {
+        VkMemoryRequirements memReq = {};
+        for (pnanovdb_uint64_t bufferIdx = 0u; bufferIdx < context->aliasedBuffers.size(); bufferIdx++)
+        {
+            const Buffer* cached = context->aliasedBuffers[bufferIdx].get();
+            if (bufferDesc_compare(&cached->desc, &placements[idx].transient->desc))
+            {
+                memReq = cached->aliasMemReq;
+                break;
+            }
+        }
+        if (memReq.size == 0u)
+        {
+            placements[idx].buffer = buffer_createUnbound(context, &placements[idx].transient->desc, &memReq);
+            if (!placements[idx].buffer)
+            {
+                placements.erase(placements.begin() + idx);
+                idx--;
+                continue;
+            }
+        }
+        placements[idx].sizeInBytes = memReq.size;
+        placements[idx].alignment = memReq.alignment > 0u ? memReq.alignment : 1u;
+        memoryTypeBits &= memReq.memoryTypeBits;
+        maxAlignment = std::max(maxAlignment, placements[idx].alignment);
+    }
+
+    // buffers whose lifetimes overlap never share memory
+    std::vector<AliasedRange> ranges;
+    pnanovdb_uint64_t requestedSize = 0u;
+    for (pnanovdb_uint64_t idx = 0u; idx < placements.size(); idx++)
+    {
+        const TransientPlacement& placement = placements[idx];
+        ranges.push_back(AliasedRange{ placement.transient->memoryNodeBegin, placement.transient->memoryNodeEnd,
+                                       placement.sizeInBytes, placement.alignment, 0u });
+        requestedSize += placement.sizeInBytes;
+    }
+    pnanovdb_uint64_t arenaSize = aliasedRanges_place(ranges);
+    for (pnanovdb_uint64_t idx = 0u; idx < placements.size(); idx++)
+    {
+        placements[idx].offset = ranges[idx].offset;
+    }
+
+    // recycle an idle arena when possible, so steady state frames do not touch the heap
+    TransientArena* arena = nullptr;
+    for (pnanovdb_uint64_t idx = 0u; idx < context->transientArenas.size(); idx++)
+    {
+        TransientArena* candidate = &context->transientArenas[idx];
+        if (candidate->lastActive <= context->deviceQueue->lastFenceCompleted &&
+            candidate->allocation.sizeInBytes >= arenaSize && candidate->allocation.offset % maxAlignment == 0u &&
+            (memoryTypeBits & (1u << candidate->allocation.block->memoryTypeIndex)) != 0u)
+        {
+            if (!arena || candidate->allocation.sizeInBytes < arena->allocation.sizeInBytes)
+            {
+                arena = candidate;
+            }
+        }
+    }
+    if (!arena)
+    {
+        VkMemoryRequirements arenaReq = {};
+        arenaReq.size = arenaSize;
+        arenaReq.alignment = maxAlignment;
+        arenaReq.memoryTypeBits = memoryTypeBits;
+
+        TransientArena newArena = {};
+        if (memoryTypeBits == 0u || !memoryHeap_allocate(device, &arenaReq, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE,
+                                                         PNANOVDB_TRUE, &newArena.allocation))
+        {
+            for (pnanovdb_uint64_t idx = 0u; idx < placements.size(); idx++)
+            {
+                if (placements[idx].buffer)
+                {
+                    buffer_destroy(context, placements[idx].buffer);
+                }
+            }
+            return;
+        }
+        newArena.id = ++context->transientArenaCounter;
+        context->transientArenas.push_back(newArena);
+        arena = &context->transientArenas.back();
+    }
+    arena->lastActive = context->deviceQueue->nextFenceValue;
+
+    for (pnanovdb_uint64_t idx = 0u; idx < placements.size(); idx++)
+    {
+        TransientPlacement& placement = placements[idx];
+
+        // steady state frames find the buffer and views of the previous flush at the same arena offset
+        Buffer* buffer = nullptr;
+        for (pnanovdb_uint64_t bufferIdx = 0u; bufferIdx < context->aliasedBuffers.size(); bufferIdx++)
+        {
+            Buffer* cached = context->aliasedBuffers[bufferIdx].get();
+            if (cached->refCount == 0 && cached->aliasArenaId == arena->id && cached->aliasOffset == placement.offset &&
+                bufferDesc_compare(&cached->desc, &placement.transient->desc))
+            {
+                buffer = cached;
+                break;
+            }
+        }
+        if (buffer)
+        {
+            if (placement.buffer)
+            {
+                buffer_destroy(context, placement.buffer);
+            }
+            buffer_resetAliased(context, buffer);
+        }
+        else
+        {
+            buffer = placement.buffer;
+            if (!buffer)
+            {
+                VkMemoryRequirements memReq = {};
+                buffer = buffer_createUnbound(context, &placement.transient->desc, &memReq);
+            }
+            if (!buffer)
+            {
+                continue;
+            }
+            buffer_placeAliased(
+                context, buffer, arena->allocation.memoryVk, arena->allocation.offset + placement.offset);
+            buffer->allocationBytes = placement.sizeInBytes;
+            buffer->aliasArenaId = arena->id;
+            buffer->aliasOffset = placement.offset;
+            context->aliasedBuffers.push_back(std::unique_ptr<Buffer>(buffer));
+        }
+        buffer->refCount = 1;
+        buffer->lastActive = context->deviceQueue->nextFenceValue;
+
+        placement.transient->buffer = buffer;
+        placement.transient->memoryAliased = PNANOVDB_TRUE;
+    }
+
+    device->memoryStats.transient_requested_bytes = requestedSize;
+    device->memoryStats.transient_arena_bytes = arenaSize;
+}
+
+void context_destroyTransientArenas(Context* context, pnanovdb_bool_t forceDestroy)
+{
+    // cached aliased buffers go when unused for minLifetime, or with their arena
+    for (pnanovdb_uint64_t idx = context->aliasedBuffers.size() - 1u; idx < context->aliasedBuffers.size(); idx--)
+    {
+        auto ptr = context->aliasedBuffers[idx].get();
+        if (forceDestroy ||
+            (ptr->refCount == 0 && (ptr->lastActive + context->minLifetime) <= context->deviceQueue->lastFenceCompleted))
+        {
+            buffer_destroy(context, context->aliasedBuffers[idx].release());
+            context->aliasedBuffers.erase(context->aliasedBuffers.begin() + idx);
+        }
+    }
+    for (pnanovdb_uint64_t idx = context->transientArenas.size() - 1u; idx < context->transientArenas.size(); idx--)
+    {
+        TransientArena* arena = &context->transientArenas[idx];
+        if (forceDestroy || (arena->lastActive + context->minLifetime) <= context->deviceQueue->lastFenceCompleted)
+        {
+            for (pnanovdb_uint64_t bufferIdx = context->aliasedBuffers.size() - 1u;
+                 bufferIdx < context->aliasedBuffers.size(); bufferIdx--)
+            {
+                if (context->aliasedBuffers[bufferIdx]->aliasArenaId == arena->id)
+                {
+                    buffer_destroy(context, context->aliasedBuffers[bufferIdx].release());
+                    context->aliasedBuffers.erase(context->aliasedBuffers.begin() + bufferIdx);
+                }
+            }
+            memoryHeap_free(context->deviceQueue->device, &arena->allocation);
+            context->transientArenas.erase(context->transientArenas.begin() + idx);
+        }
+    }
 }
 
 /// ***************************** TimerHeap *****************************************************
@@ -796,7 +1066,10 @@ void profilerCapture_reset(Context* context, ProfilerCapture* ptr, pnanovdb_uint
     }
 }
 
-void profilerCapture_timestamp(Context* context, ProfilerCapture* ptr, const char* label)
+void profilerCapture_timestamp(Context* context,
+                               ProfilerCapture* ptr,
+                               const char* label,
+                               pnanovdb_uint32_t barrierCount)
 {
     if (ptr->state == 1u && ptr->entries.size() < ptr->capacity)
     {
@@ -809,6 +1082,7 @@ void profilerCapture_timestamp(Context* context, ProfilerCapture* ptr, const cha
         entry.label = label;
         entry.cpuValue = 0llu;
         entry.gpuValue = 0llu;
+        entry.barrierCount = barrierCount;
 
         loader->vkCmdWriteTimestamp(
             context->deviceQueue->commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, ptr->queryPool, entry_idx);
@@ -836,6 +1110,7 @@ void profilerCapture_download(Context* context, ProfilerCapture* ptr)
                                           sizeof(pnanovdb_uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
 
         ptr->queryReadbackFenceVal = context->deviceQueue->nextFenceValue;
+        ptr->traceSubmitNs = traceTimestamp();
 
         ptr->state = 2u;
     }
@@ -873,6 +1148,7 @@ pnanovdb_bool_t profilerCapture_mapResults(Context* context,
             auto deltaEntry = &ptr->deltaEntries[idx];
 
             deltaEntry->label = entry->label;
+            deltaEntry->barrier_count = entry->barrierCount;
             deltaEntry->cpu_delta_time =
                 (float)(((double)(entry->cpuValue - prevEntry.cpuValue) / (double)(ptr->cpuFreq)));
             deltaEntry->gpu_delta_time =
@@ -927,7 +1203,8 @@ void profiler_destroy(Context* context, Profiler* ptr)
 
 void profiler_beginCapture(Context* context, Profiler* ptr, pnanovdb_uint64_t numEntries)
 {
-    if (!ptr->reportEntries)
+    ptr->active = ptr->reportEntries || trace_isEnabled();
+    if (!ptr->active)
     {
         return;
     }
@@ -957,12 +1234,12 @@ void profiler_beginCapture(Context* context, Profiler* ptr, pnanovdb_uint64_t nu
 
     profilerCapture_reset(context, capture, numEntries, ptr->currentCaptureID);
 
-    profilerCapture_timestamp(context, capture, "BeginCapture");
+    profilerCapture_timestamp(context, capture, "BeginCapture", 0u);
 }
 
-void profiler_endCapture(Context* context, Profiler* ptr)
+void profiler_endCapture(Context* context, Profiler* ptr, pnanovdb_uint32_t barrierCount)
 {
-    if (!ptr->reportEntries)
+    if (!ptr->active)
     {
         return;
     }
@@ -971,19 +1248,34 @@ void profiler_endCapture(Context* context, Profiler* ptr)
     {
         auto capture = &ptr->captures[ptr->currentCaptureIndex];
 
-        profilerCapture_timestamp(context, capture, "EndCapture");
+        profilerCapture_timestamp(context, capture, "EndCapture", barrierCount);
 
         profilerCapture_download(context, capture);
     }
 }
 
-void profiler_processCaptures(Context* context, Profiler* ptr)
+// gpu timestamps have no common origin with the cpu clock, passes are laid out from the submit time
+static void profilerCapture_trace(Context* context, ProfilerCapture* ptr)
 {
-    if (!ptr->reportEntries)
+    if (!trace_isEnabled() || ptr->entries.size() < 2u || ptr->queryFrequency == 0u)
     {
         return;
     }
+    pnanovdb_uint32_t trackId = context->deviceQueue->traceTrackId;
+    pnanovdb_uint64_t gpuOrigin = ptr->entries[0u].gpuValue;
+    double nsPerTick = 1.0E9 / double(ptr->queryFrequency);
+    for (pnanovdb_uint64_t idx = 1u; idx < ptr->entries.size(); idx++)
+    {
+        pnanovdb_uint64_t beginNs =
+            ptr->traceSubmitNs + pnanovdb_uint64_t(double(ptr->entries[idx - 1u].gpuValue - gpuOrigin) * nsPerTick);
+        pnanovdb_uint64_t endNs =
+            ptr->traceSubmitNs + pnanovdb_uint64_t(double(ptr->entries[idx].gpuValue - gpuOrigin) * nsPerTick);
+        trace_recordTrack(trackId, "gpu", ptr->entries[idx].label, beginNs, endNs);
+    }
+}
 
+void profiler_processCaptures(Context* context, Profiler* ptr)
+{
     for (pnanovdb_uint64_t captureIndex = 0u; captureIndex < ptr->captures.size(); captureIndex++)
     {
         auto capture = &ptr->captures[captureIndex];
@@ -992,16 +1284,20 @@ void profiler_processCaptures(Context* context, Profiler* ptr)
         pnanovdb_compute_profiler_entry_t* entries = nullptr;
         if (profilerCapture_mapResults(context, capture, &numEntries, &entries))
         {
-            ptr->reportEntries(ptr->userdata, capture->captureID, (pnanovdb_uint32_t)numEntries, entries);
+            profilerCapture_trace(context, capture);
+            if (ptr->reportEntries)
+            {
+                ptr->reportEntries(ptr->userdata, capture->captureID, (pnanovdb_uint32_t)numEntries, entries);
+            }
 
             profilerCapture_unmapResults(context, capture);
         }
     }
 }
 
-void profiler_timestamp(Context* context, Profiler* ptr, const char* label)
+void profiler_timestamp(Context* context, Profiler* ptr, const char* label, pnanovdb_uint32_t barrierCount)
 {
-    if (!ptr->reportEntries)
+    if (!ptr->active)
     {
         return;
     }
@@ -1010,7 +1306,7 @@ void profiler_timestamp(Context* context, Profiler* ptr, const char* label)
     {
         auto capture = &ptr->captures[ptr->currentCaptureIndex];
 
-        profilerCapture_timestamp(context, capture, label);
+        profilerCapture_timestamp(context, capture, label, barrierCount);
     }
 }
 
@@ -227,6 +227,8 @@ void selectDeviceExtensions(Device* ptr,
     }
     PNANOVDB_VULKAN_TRY_ENABLE_DEVICE_EXTENSION(VK_KHR_MAINTENANCE_5);
     PNANOVDB_VULKAN_TRY_ENABLE_DEVICE_EXTENSION(VK_EXT_SHADER_64BIT_INDEXING);
+    PNANOVDB_VULKAN_TRY_ENABLE_DEVICE_EXTENSION(VK_KHR_PUSH_DESCRIPTOR);
+    PNANOVDB_VULKAN_TRY_ENABLE_DEVICE_EXTENSION(VK_EXT_MEMORY_BUDGET);
 
 #undef PNANOVDB_VULKAN_TRY_ENABLE_DEVICE_EXTENSION
 
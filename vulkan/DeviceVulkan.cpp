@@ -19,6 +19,7 @@
 #    include <dlfcn.h> // Required for dladdr
 #endif
 
+#include <stdio.h>
 #include <string.h>
 
 pnanovdb_compute_interface_t* pnanovdbGetContextInterface_vulkan();
@@ -362,6 +363,7 @@ pnanovdb_compute_device_t* createDevice(pnanovdb_compute_device_manager_t* devic
     }
 
     // identify graphics and compute queues
+    pnanovdb_uint32_t graphicsFamilyQueueCount = 1u;
     {
         std::vector<VkQueueFamilyProperties> queueProps;
 
@@ -383,6 +385,7 @@ pnanovdb_compute_device_t* createDevice(pnanovdb_compute_device_manager_t* devic
             }
         }
         ptr->graphicsQueueFamilyIdx = graphicsQueueFamilyIdx;
+        graphicsFamilyQueueCount = queueCount > 0u ? queueProps[graphicsQueueFamilyIdx].queueCount : 1u;
 
         uint32_t computeQueueFamilyIdx = ~0u;
         // prefer compute and no graphics
@@ -437,7 +440,8 @@ pnanovdb_compute_device_t* createDevice(pnanovdb_compute_device_manager_t* devic
 
     // create device
     {
-        const float queuePriorities[2] = { 1.f, 1.f };
+        // background compute yields to the interactive graphics queue where the driver honors priorities
+        const float queuePriorities[2] = { 1.f, 0.5f };
 
         pnanovdb_uint32_t queueCreateInfoCount = 1u;
         VkDeviceQueueCreateInfo queueCreateInfo[3] = {};
@@ -447,14 +451,17 @@ pnanovdb_compute_device_t* createDevice(pnanovdb_compute_device_manager_t* devic
         queueCreateInfo[0].pQueuePriorities = queuePriorities;
         if (ptr->computeQueueFamilyIdx == ptr->graphicsQueueFamilyIdx)
         {
-            queueCreateInfo[0].queueCount = 2u;
+            if (graphicsFamilyQueueCount >= 2u)
+            {
+                queueCreateInfo[0].queueCount = 2u;
+            }
         }
         else
         {
             queueCreateInfo[queueCreateInfoCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo[queueCreateInfoCount].queueFamilyIndex = ptr->computeQueueFamilyIdx;
             queueCreateInfo[queueCreateInfoCount].queueCount = 1u;
-            queueCreateInfo[queueCreateInfoCount].pQueuePriorities = queuePriorities;
+            queueCreateInfo[queueCreateInfoCount].pQueuePriorities = &queuePriorities[1];
             queueCreateInfoCount++;
         }
         if (ptr->encodeQueueFamilyIdx != ~0u)
@@ -534,18 +541,55 @@ pnanovdb_compute_device_t* createDevice(pnanovdb_compute_device_manager_t* devic
     // get properties
     instanceLoader->vkGetPhysicalDeviceProperties(ptr->physicalDevice, &ptr->physicalDeviceProperties);
     instanceLoader->vkGetPhysicalDeviceMemoryProperties(ptr->physicalDevice, &ptr->memoryProperties);
+    if (ptr->enabledExtensions.VK_KHR_PUSH_DESCRIPTOR && instanceLoader->vkGetPhysicalDeviceProperties2KHR)
+    {
+        VkPhysicalDevicePushDescriptorPropertiesKHR pushDescriptorProperties = {};
+        pushDescriptorProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
+        VkPhysicalDeviceProperties2 properties2 = {};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &pushDescriptorProperties;
+        instanceLoader->vkGetPhysicalDeviceProperties2KHR(ptr->physicalDevice, &properties2);
+        ptr->maxPushDescriptors = pushDescriptorProperties.maxPushDescriptors;
+    }
+
+    // select descriptor update path, falling back when the requested one is not available
+    {
+        pnanovdb_bool_t supportsTemplate = deviceLoader->vkCreateDescriptorUpdateTemplate &&
+                                           deviceLoader->vkUpdateDescriptorSetWithTemplate;
+        pnanovdb_bool_t supportsPush = supportsTemplate && ptr->maxPushDescriptors > 0u &&
+                                       deviceLoader->vkCmdPushDescriptorSetKHR &&
+                                       deviceLoader->vkCmdPushDescriptorSetWithTemplateKHR;
+        pnanovdb_compute_descriptor_update_mode_t mode = desc->descriptor_update_mode;
+        if (mode == PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_AUTO || mode > PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_PUSH)
+        {
+            mode = PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_PUSH;
+        }
+        if (mode == PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_PUSH && !supportsPush)
+        {
+            mode = PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_TEMPLATE;
+        }
+        if (mode == PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_TEMPLATE && !supportsTemplate)
+        {
+            mode = PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_WRITES;
+        }
+        ptr->descriptorUpdateMode = mode;
+
+        ptr->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Vulkan descriptor update mode(%d) max_push_descriptors(%d)",
+                      ptr->descriptorUpdateMode, ptr->maxPushDescriptors);
+    }
 
     // get graphics queue
     deviceLoader->vkGetDeviceQueue(ptr->vulkanDevice, ptr->graphicsQueueFamilyIdx, 0u, &ptr->graphicsQueueVk);
 
     // get compute queue
-    pnanovdb_uint32_t compute_queue_idx = 0u;
-    if (ptr->computeQueueFamilyIdx == ptr->graphicsQueueFamilyIdx)
+    if (ptr->computeQueueFamilyIdx != ptr->graphicsQueueFamilyIdx)
+    {
+        deviceLoader->vkGetDeviceQueue(ptr->vulkanDevice, ptr->computeQueueFamilyIdx, 0u, &ptr->computeQueueVk);
+    }
+    else if (graphicsFamilyQueueCount >= 2u)
     {
-        compute_queue_idx = 1u;
+        deviceLoader->vkGetDeviceQueue(ptr->vulkanDevice, ptr->computeQueueFamilyIdx, 1u, &ptr->computeQueueVk);
     }
-    deviceLoader->vkGetDeviceQueue(
-        ptr->vulkanDevice, ptr->computeQueueFamilyIdx, compute_queue_idx, &ptr->computeQueueVk);
 
     // Fallback if compute queue handle wasn't provided (e.g., only one queue available)
     if (ptr->computeQueueVk == VK_NULL_HANDLE)
@@ -559,8 +603,26 @@ pnanovdb_compute_device_t* createDevice(pnanovdb_compute_device_manager_t* devic
         deviceLoader->vkGetDeviceQueue(ptr->vulkanDevice, ptr->encodeQueueFamilyIdx, 0u, &ptr->encodeQueueVk);
     }
 
-    ptr->deviceQueue = deviceQueue_create(ptr, ptr->graphicsQueueFamilyIdx, ptr->graphicsQueueVk);
-    ptr->computeQueue = deviceQueue_create(ptr, ptr->computeQueueFamilyIdx, ptr->computeQueueVk);
+    ptr->memoryHeap = memoryHeap_create(ptr);
+    device_loadPipelineCache(ptr);
+
+    pnanovdb_bool_t computeQueueShared = ptr->computeQueueVk == ptr->graphicsQueueVk;
+    ptr->deviceQueue =
+        deviceQueue_create(ptr, ptr->graphicsQueueFamilyIdx, ptr->graphicsQueueVk, &ptr->graphicsQueueMutex);
+    ptr->computeQueue = deviceQueue_create(ptr, ptr->computeQueueFamilyIdx, ptr->computeQueueVk,
+                                           computeQueueShared ? &ptr->graphicsQueueMutex : &ptr->computeQueueMutex);
+    ptr->deviceQueue->queueShared = computeQueueShared;
+    ptr->computeQueue->queueShared = computeQueueShared;
+    if (computeQueueShared)
+    {
+        ptr->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_INFO, "No dedicated compute queue, sharing the graphics queue");
+    }
+
+    char trackName[64u] = {};
+    snprintf(trackName, sizeof(trackName), "GPU device %u graphics queue", ptr->desc.device_index);
+    ptr->deviceQueue->traceTrackId = trace_registerTrack(trackName);
+    snprintf(trackName, sizeof(trackName), "GPU device %u compute queue", ptr->desc.device_index);
+    ptr->computeQueue->traceTrackId = trace_registerTrack(trackName);
 
     return cast(ptr);
 }
@@ -572,6 +634,9 @@ void destroyDevice(pnanovdb_compute_device_manager_t* manager, pnanovdb_compute_
     deviceQueue_destroy(ptr->deviceQueue);
     deviceQueue_destroy(ptr->computeQueue);
 
+    device_savePipelineCache(ptr);
+    memoryHeap_destroy(ptr, ptr->memoryHeap);
+
     ptr->loader.vkDestroyDevice(ptr->vulkanDevice, nullptr);
 
     formatConverter_destroy(ptr->formatConverter);
@@ -597,12 +662,44 @@ pnanovdb_uint32_t getDeviceIndex(const pnanovdb_compute_device_t* device)
     return ptr->desc.device_index;
 }
 
+// sums budget and usage over device local heaps, values are refreshed by the driver on each query
+static void device_getMemoryBudget(Device* ptr, pnanovdb_compute_device_memory_stats_t* dstStats)
+{
+    auto instanceLoader = &ptr->deviceManager->loader;
+
+    dstStats->device_local_budget_bytes = 0u;
+    dstStats->device_local_usage_bytes = 0u;
+    if (!ptr->enabledExtensions.VK_EXT_MEMORY_BUDGET || !instanceLoader->vkGetPhysicalDeviceMemoryProperties2KHR)
+    {
+        return;
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {};
+    memoryProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memoryProperties2.pNext = &budgetProperties;
+    instanceLoader->vkGetPhysicalDeviceMemoryProperties2KHR(ptr->physicalDevice, &memoryProperties2);
+
+    const VkPhysicalDeviceMemoryProperties& props = memoryProperties2.memoryProperties;
+    for (uint32_t heapIdx = 0u; heapIdx < props.memoryHeapCount; heapIdx++)
+    {
+        if (props.memoryHeaps[heapIdx].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        {
+            dstStats->device_local_budget_bytes += budgetProperties.heapBudget[heapIdx];
+            dstStats->device_local_usage_bytes += budgetProperties.heapUsage[heapIdx];
+        }
+    }
+}
+
 void getMemoryStats(pnanovdb_compute_device_t* device, pnanovdb_compute_device_memory_stats_t* dstStats)
 {
     auto ptr = cast(device);
     if (dstStats)
     {
         *dstStats = ptr->memoryStats;
+        memoryHeap_getStats(ptr, dstStats);
+        device_getMemoryBudget(ptr, dstStats);
     }
 }
 
@@ -732,7 +829,7 @@ void closeSemaphoreExternalHandle(pnanovdb_compute_semaphore_t* semaphore,
 
 /// ************************** DeviceQueue **************************************
 
-DeviceQueue* deviceQueue_create(Device* device, uint32_t queueFamilyIdx, VkQueue queue)
+DeviceQueue* deviceQueue_create(Device* device, uint32_t queueFamilyIdx, VkQueue queue, std::mutex* queueMutex)
 {
     auto ptr = new DeviceQueue();
 
@@ -741,6 +838,7 @@ DeviceQueue* deviceQueue_create(Device* device, uint32_t queueFamilyIdx, VkQueue
     ptr->vulkanDevice = ptr->device->vulkanDevice;
     ptr->queueFamilyIdx = queueFamilyIdx;
     ptr->queueVk = queue;
+    ptr->queueMutex = queueMutex;
 
     auto loader = &ptr->device->loader;
 
@@ -862,7 +960,13 @@ int flushStepA(DeviceQueue* ptr, pnanovdb_compute_semaphore_t* waitSemaphore, pn
         submitInfo.pSignalSemaphores = signalSemaphores;
     }
 
-    VkResult result = loader->vkQueueSubmit(ptr->queueVk, 1u, &submitInfo, ptr->fences[ptr->commandBufferIdx].fence);
+    VkResult result = VK_SUCCESS;
+    pnanovdb_uint64_t traceBeginNs = traceTimestamp();
+    {
+        std::lock_guard<std::mutex> lock(*ptr->queueMutex);
+        result = loader->vkQueueSubmit(ptr->queueVk, 1u, &submitInfo, ptr->fences[ptr->commandBufferIdx].fence);
+    }
+    trace_record("queue", "vkQueueSubmit", traceBeginNs, traceTimestamp());
 
     // mark signaled fence value
     ptr->fences[ptr->commandBufferIdx].value = ptr->nextFenceValue;
@@ -927,6 +1031,38 @@ void flushStepB(DeviceQueue* ptr)
     {
         context_resetNodes(ptr->context);
     }
+
+    deviceQueue_processFrameCallbacks(ptr);
+}
+
+void deviceQueue_processFrameCallbacks(DeviceQueue* ptr)
+{
+    if (ptr->frameCallbacks.empty())
+    {
+        return;
+    }
+    // move ready callbacks out first, a callback is allowed to register another one
+    std::vector<FrameCallback> ready;
+    std::vector<FrameCallback> pending;
+    for (const FrameCallback& frameCallback : ptr->frameCallbacks)
+    {
+        if (frameCallback.frame <= ptr->lastFenceCompleted)
+        {
+            ready.push_back(frameCallback);
+        }
+        else
+        {
+            pending.push_back(frameCallback);
+        }
+    }
+    ptr->frameCallbacks.swap(pending);
+    // fire in frame order, callbacks of the same frame in the order they were added
+    std::stable_sort(ready.begin(), ready.end(),
+                     [](const FrameCallback& a, const FrameCallback& b) { return a.frame < b.frame; });
+    for (const FrameCallback& frameCallback : ready)
+    {
+        frameCallback.callback(frameCallback.userdata, frameCallback.frame);
+    }
 }
 
 int flush(pnanovdb_compute_queue_t* deviceQueue,
@@ -952,13 +1088,20 @@ void waitIdle(pnanovdb_compute_queue_t* deviceQueue)
         return;
     }
 
-    ptr->device->loader.vkQueueWaitIdle(ptr->queueVk);
+    // a shared VkQueue also carries the other queue's frames, only this queue's fences are waited on then
+    if (!ptr->queueShared)
+    {
+        std::lock_guard<std::mutex> lock(*ptr->queueMutex);
+        ptr->device->loader.vkQueueWaitIdle(ptr->queueVk);
+    }
 
     for (pnanovdb_uint32_t fenceIdx = 0u; fenceIdx < kMaxFramesInFlight; fenceIdx++)
     {
         deviceQueue_fenceUpdate(ptr, fenceIdx, PNANOVDB_TRUE);
     }
 
+    deviceQueue_processFrameCallbacks(ptr);
+
     // update internal context
 }
 
@@ -995,9 +1138,50 @@ void waitForFrame(pnanovdb_compute_queue_t* deviceQueue, pnanovdb_uint64_t frame
         }
     }
 
+    deviceQueue_processFrameCallbacks(ptr);
+
     // update internal context
 }
 
+pnanovdb_bool_t isFrameCompleted(pnanovdb_compute_queue_t* deviceQueue, pnanovdb_uint64_t frameID)
+{
+    auto ptr = cast(deviceQueue);
+
+    if (ptr->lastFenceCompleted < frameID)
+    {
+        // non-blocking update of fence values
+        for (pnanovdb_uint32_t fenceIdx = 0u; fenceIdx < kMaxFramesInFlight; fenceIdx++)
+        {
+            deviceQueue_fenceUpdate(ptr, fenceIdx, PNANOVDB_FALSE);
+        }
+        deviceQueue_processFrameCallbacks(ptr);
+    }
+    return ptr->lastFenceCompleted >= frameID ? PNANOVDB_TRUE : PNANOVDB_FALSE;
+}
+
+void addFrameCallback(pnanovdb_compute_queue_t* deviceQueue,
+                      pnanovdb_uint64_t frameID,
+                      pnanovdb_compute_frame_callback_t callback,
+                      void* userdata)
+{
+    auto ptr = cast(deviceQueue);
+
+    if (!callback)
+    {
+        return;
+    }
+    if (ptr->lastFenceCompleted >= frameID)
+    {
+        callback(userdata, frameID);
+        return;
+    }
+    FrameCallback frameCallback = {};
+    frameCallback.frame = frameID;
+    frameCallback.callback = callback;
+    frameCallback.userdata = userdata;
+    ptr->frameCallbacks.push_back(frameCallback);
+}
+
 pnanovdb_uint64_t getLastFrameCompleted(pnanovdb_compute_queue_t* queue)
 {
     auto ptr = cast(queue);
@@ -1308,7 +1492,11 @@ int presentSwapchain(pnanovdb_compute_swapchain_t* swapchain, pnanovdb_bool_t vs
     presentInfo.waitSemaphoreCount = 1u;
     presentInfo.pWaitSemaphores = &ptr->deviceQueue->currentEndFrameSemaphore;
 
-    VkResult result = loader->vkQueuePresentKHR(ptr->deviceQueue->queueVk, &presentInfo);
+    VkResult result = VK_SUCCESS;
+    {
+        std::lock_guard<std::mutex> lock(*ptr->deviceQueue->queueMutex);
+        result = loader->vkQueuePresentKHR(ptr->deviceQueue->queueVk, &presentInfo);
+    }
 
     ptr->deviceQueue->currentEndFrameSemaphore = VK_NULL_HANDLE;
 
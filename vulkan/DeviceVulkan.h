@@ -12,9 +12,14 @@
 
 #pragma once
 
+#include "MemoryRangesVulkan.h"
+#include "ResourceHazardVulkan.h"
+
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 namespace pnanovdb_vulkan
 {
@@ -59,6 +64,7 @@ PNANOVDB_CAST_PAIR(pnanovdb_compute_pipeline_t, ComputePipeline)
 
 struct Fence;
 struct FormatConverter;
+struct MemoryHeap;
 
 struct DeviceManager
 {
@@ -104,14 +110,31 @@ struct Device
     uint32_t encodeQueueFamilyIdx = 0u;
     VkQueue encodeQueueVk = nullptr;
 
+    // VkQueue access must be externally synchronized, the compute queue shares the graphics mutex on fallback
+    std::mutex graphicsQueueMutex;
+    std::mutex computeQueueMutex;
+
     DeviceQueue* deviceQueue = nullptr;
     DeviceQueue* computeQueue = nullptr;
 
+    // unique across all contexts, so hazard state on resources shared between queues never aliases
+    std::atomic<pnanovdb_uint64_t> flushCounter{ 0llu };
+
     pnanovdb_vulkan_enabled_features_t enabledFeatures = {};
     pnanovdb_vulkan_enabled_device_extensions_t enabledExtensions = {};
     pnanovdb_vulkan_device_loader_t loader = {};
 
     pnanovdb_compute_device_memory_stats_t memoryStats = {};
+
+    MemoryHeap* memoryHeap = nullptr;
+
+    // resolved from desc.descriptor_update_mode and device support, never AUTO
+    pnanovdb_compute_descriptor_update_mode_t descriptorUpdateMode = PNANOVDB_COMPUTE_DESCRIPTOR_UPDATE_MODE_WRITES;
+    pnanovdb_uint32_t maxPushDescriptors = 0u;
+
+    // merge target for all context caches, serialized next to the shader cache
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    std::vector<char> pipelineCacheData;
 };
 
 pnanovdb_compute_device_t* createDevice(pnanovdb_compute_device_manager_t* deviceManager,
@@ -125,6 +148,70 @@ pnanovdb_uint32_t getDeviceIndex(const pnanovdb_compute_device_t* device);
 void device_reportMemoryAllocate(Device* device, pnanovdb_compute_memory_type_t type, pnanovdb_uint64_t bytes);
 void device_reportMemoryFree(Device* device, pnanovdb_compute_memory_type_t type, pnanovdb_uint64_t bytes);
 
+void device_loadPipelineCache(Device* device);
+void device_savePipelineCache(Device* device);
+
+// process wide trace ring shared by all devices, see TraceVulkan.cpp
+pnanovdb_bool_t trace_isEnabled();
+void trace_record(const char* category, const char* name, pnanovdb_uint64_t beginNs, pnanovdb_uint64_t endNs);
+void trace_recordTrack(pnanovdb_uint32_t trackId,
+                       const char* category,
+                       const char* name,
+                       pnanovdb_uint64_t beginNs,
+                       pnanovdb_uint64_t endNs);
+pnanovdb_uint32_t trace_registerTrack(const char* name);
+
+void enableTrace(pnanovdb_bool_t enabled);
+pnanovdb_uint64_t traceTimestamp();
+void traceScope(const char* category, const char* name, pnanovdb_uint64_t beginNs, pnanovdb_uint64_t endNs);
+pnanovdb_uint64_t exportTrace(char* dst, pnanovdb_uint64_t dstSize);
+pnanovdb_bool_t saveTrace(const char* path);
+
+/// Memory heap
+
+struct MemoryBlock;
+
+struct MemoryAllocation
+{
+    MemoryBlock* block = nullptr;
+    VkDeviceMemory memoryVk = VK_NULL_HANDLE;
+    pnanovdb_uint64_t offset = 0llu;
+    pnanovdb_uint64_t sizeInBytes = 0llu;
+    void* mappedData = nullptr;
+};
+
+struct MemoryBlock
+{
+    pnanovdb_compute_memory_type_t memory_type = PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE;
+    uint32_t memoryTypeIndex = 0u;
+    pnanovdb_bool_t isLinear = PNANOVDB_TRUE;
+    pnanovdb_bool_t isDedicated = PNANOVDB_FALSE;
+    pnanovdb_uint64_t sizeInBytes = 0llu;
+    pnanovdb_uint64_t usedBytes = 0llu;
+    pnanovdb_uint32_t allocationCount = 0u;
+
+    VkDeviceMemory memoryVk = VK_NULL_HANDLE;
+    void* mappedData = nullptr;
+
+    std::vector<MemoryRange> freeRanges; // sorted by offset
+};
+
+struct MemoryHeap
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<MemoryBlock>> blocks;
+};
+
+MemoryHeap* memoryHeap_create(Device* device);
+void memoryHeap_destroy(Device* device, MemoryHeap* heap);
+pnanovdb_bool_t memoryHeap_allocate(Device* device,
+                                    const VkMemoryRequirements* memReq,
+                                    pnanovdb_compute_memory_type_t memory_type,
+                                    pnanovdb_bool_t isLinear,
+                                    MemoryAllocation* dst);
+void memoryHeap_free(Device* device, MemoryAllocation* allocation);
+void memoryHeap_getStats(Device* device, pnanovdb_compute_device_memory_stats_t* dstStats);
+
 struct DeviceSemaphore
 {
     Device* device = nullptr;
@@ -146,6 +233,13 @@ struct Fence
     pnanovdb_uint64_t value;
 };
 
+struct FrameCallback
+{
+    pnanovdb_uint64_t frame;
+    pnanovdb_compute_frame_callback_t callback;
+    void* userdata;
+};
+
 struct DeviceQueue
 {
     Device* device = nullptr;
@@ -153,6 +247,8 @@ struct DeviceQueue
     VkDevice vulkanDevice = nullptr;
     pnanovdb_uint32_t queueFamilyIdx = 0u;
     VkQueue queueVk = nullptr;
+    std::mutex* queueMutex = nullptr;
+    pnanovdb_bool_t queueShared = PNANOVDB_FALSE;
 
     VkCommandPool commandPool = VK_NULL_HANDLE;
     int commandBufferIdx = 0u;
@@ -169,6 +265,11 @@ struct DeviceQueue
     pnanovdb_uint64_t lastFenceCompleted = 1u;
     pnanovdb_uint64_t nextFenceValue = 2u;
 
+    std::vector<FrameCallback> frameCallbacks;
+
+    // gpu timeline for profiler passes in the trace
+    pnanovdb_uint32_t traceTrackId = 0u;
+
     Context* context = nullptr;
 };
 
@@ -179,16 +280,22 @@ int flush(pnanovdb_compute_queue_t* ptr,
 pnanovdb_uint64_t getLastFrameCompleted(pnanovdb_compute_queue_t* queue);
 void waitForFrame(pnanovdb_compute_queue_t* ptr, pnanovdb_uint64_t frameID);
 void waitIdle(pnanovdb_compute_queue_t* ptr);
+pnanovdb_bool_t isFrameCompleted(pnanovdb_compute_queue_t* ptr, pnanovdb_uint64_t frameID);
+void addFrameCallback(pnanovdb_compute_queue_t* ptr,
+                      pnanovdb_uint64_t frameID,
+                      pnanovdb_compute_frame_callback_t callback,
+                      void* userdata);
 pnanovdb_compute_interface_t* getContextInterface(const pnanovdb_compute_queue_t* ptr);
 pnanovdb_compute_context_t* getContext(const pnanovdb_compute_queue_t* ptr);
 
-DeviceQueue* deviceQueue_create(Device* device, uint32_t queueFamilyIdx, VkQueue queue);
+DeviceQueue* deviceQueue_create(Device* device, uint32_t queueFamilyIdx, VkQueue queue, std::mutex* queueMutex);
 void deviceQueue_destroy(DeviceQueue* deviceQueue);
 int flushStepA(DeviceQueue* ptr,
                pnanovdb_compute_semaphore_t* waitSemaphore,
                pnanovdb_compute_semaphore_t* signalSemaphore);
 void flushStepB(DeviceQueue* ptr);
 void deviceQueue_fenceUpdate(DeviceQueue* ptr, pnanovdb_uint32_t fenceIdx, pnanovdb_bool_t blocking);
+void deviceQueue_processFrameCallbacks(DeviceQueue* ptr);
 
 struct Swapchain
 {
@@ -299,7 +406,9 @@ struct Buffer
     pnanovdb_compute_memory_type_t memory_type = PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE;
     pnanovdb_uint64_t allocationBytes = 0llu;
 
-    VkDeviceMemory memoryVk = VK_NULL_HANDLE;
+    VkDeviceMemory memoryVk = VK_NULL_HANDLE; // dedicated allocations only
+    MemoryAllocation allocation = {};
+    pnanovdb_bool_t isMemoryAliased = PNANOVDB_FALSE;
     VkBuffer bufferVk = VK_NULL_HANDLE;
     VkBufferView bufferViewVk = VK_NULL_HANDLE;
     std::vector<VkBufferView> aliasBufferViews;
@@ -309,6 +418,12 @@ struct Buffer
 
     VkBufferMemoryBarrier restoreBarrier = {};
     VkBufferMemoryBarrier currentBarrier = {};
+    ResourceHazard hazard = {};
+
+    // aliased transients only, reused by later flushes that place the same desc at the same arena offset
+    VkMemoryRequirements aliasMemReq = {};
+    pnanovdb_uint64_t aliasArenaId = 0llu;
+    pnanovdb_uint64_t aliasOffset = 0llu;
 };
 
 struct BufferTransient
@@ -319,6 +434,10 @@ struct BufferTransient
     pnanovdb_compute_format_t aliasFormat = PNANOVDB_COMPUTE_FORMAT_UNKNOWN;
     int nodeBegin = 0;
     int nodeEnd = 0;
+    // lifetime of the underlying memory, including all transients aliasing this one
+    int memoryNodeBegin = 0;
+    int memoryNodeEnd = 0;
+    pnanovdb_bool_t memoryAliased = PNANOVDB_FALSE;
 };
 
 struct BufferAcquire
@@ -370,6 +489,13 @@ Buffer* buffer_create(Context* context,
                       const pnanovdb_compute_buffer_desc_t* desc,
                       const pnanovdb_compute_interop_handle_t* interopHandle);
 void buffer_destroy(Context* context, Buffer* buffer);
+Buffer* buffer_createUnbound(Context* context,
+                             const pnanovdb_compute_buffer_desc_t* desc,
+                             VkMemoryRequirements* pMemReq);
+void buffer_bindPlaced(Context* context, Buffer* ptr, VkDeviceMemory memoryVk, pnanovdb_uint64_t offset);
+void buffer_placeAliased(Context* context, Buffer* ptr, VkDeviceMemory memoryVk, pnanovdb_uint64_t offset);
+void buffer_resetAliased(Context* context, Buffer* ptr);
+pnanovdb_bool_t bufferDesc_compare(const pnanovdb_compute_buffer_desc_t* a, const pnanovdb_compute_buffer_desc_t* b);
 void context_destroyBuffers(Context* context);
 VkBufferView buffer_getBufferView(Context* context, Buffer* ptr, pnanovdb_compute_format_t aliasFormat);
 pnanovdb_uint64_t getBufferDeviceAddress(pnanovdb_compute_context_t* context, pnanovdb_compute_buffer_t* buffer);
@@ -382,7 +508,8 @@ struct Texture
     VkImageAspectFlags imageAspect = VK_IMAGE_ASPECT_COLOR_BIT;
     pnanovdb_uint64_t allocationBytes = 0llu;
 
-    VkDeviceMemory memoryVk = VK_NULL_HANDLE;
+    VkDeviceMemory memoryVk = VK_NULL_HANDLE; // heap block memory, null for external images
+    MemoryAllocation allocation = {};
     VkImage imageVk = VK_NULL_HANDLE;
     VkImageView imageViewVk_mipLevel = VK_NULL_HANDLE;
     VkImageView imageViewVk_all = VK_NULL_HANDLE;
@@ -393,6 +520,7 @@ struct Texture
 
     VkImageMemoryBarrier restoreBarrier = {};
     VkImageMemoryBarrier currentBarrier = {};
+    ResourceHazard hazard = {};
 };
 
 struct TextureTransient
@@ -472,6 +600,14 @@ struct DescriptorPool
     pnanovdb_uint64_t fenceValue = 0llu;
 };
 
+// update template entry payload, one per binding
+union DescriptorData
+{
+    VkDescriptorBufferInfo bufferInfo;
+    VkDescriptorImageInfo imageInfo;
+    VkBufferView bufferView;
+};
+
 struct ComputePipeline
 {
     pnanovdb_compute_pipeline_desc_t desc = {};
@@ -491,10 +627,12 @@ struct ComputePipeline
 
     std::vector<VkDescriptorSetLayoutBinding> bindings;
 
+    // push descriptors need no pools, template is null if a binding is an array
+    pnanovdb_bool_t usePushDescriptors = PNANOVDB_FALSE;
+    VkDescriptorUpdateTemplate updateTemplate = VK_NULL_HANDLE;
+
     std::vector<VkWriteDescriptorSet> descriptorWrites;
-    std::vector<VkDescriptorBufferInfo> bufferInfos;
-    std::vector<VkBufferView> bufferViews;
-    std::vector<VkDescriptorImageInfo> imageInfos;
+    std::vector<DescriptorData> descriptorData;
 
     pnanovdb_uint32_t poolSizeCount = 0u;
     pnanovdb_uint32_t setsPerPool = 0u;
@@ -518,6 +656,7 @@ struct ProfilerEntry
     const char* label;
     pnanovdb_uint64_t cpuValue;
     pnanovdb_uint64_t gpuValue;
+    pnanovdb_uint32_t barrierCount;
 };
 
 struct ProfilerCapture
@@ -536,6 +675,9 @@ struct ProfilerCapture
 
     std::vector<ProfilerEntry> entries;
     std::vector<pnanovdb_compute_profiler_entry_t> deltaEntries;
+
+    // trace clock at download, gpu passes are placed relative to it
+    pnanovdb_uint64_t traceSubmitNs = 0llu;
 };
 
 void profilerCapture_init(Context* context, ProfilerCapture* ptr, pnanovdb_uint64_t capacity);
@@ -544,7 +686,10 @@ void profilerCapture_reset(Context* context,
                            ProfilerCapture* ptr,
                            pnanovdb_uint64_t minCapacity,
                            pnanovdb_uint64_t captureID);
-void profilerCapture_timestamp(Context* context, ProfilerCapture* ptr, const char* label);
+void profilerCapture_timestamp(Context* context,
+                               ProfilerCapture* ptr,
+                               const char* label,
+                               pnanovdb_uint32_t barrierCount);
 void profilerCapture_download(Context* context, ProfilerCapture* ptr);
 pnanovdb_bool_t profilerCapture_mapResults(Context* context,
                                            ProfilerCapture* ptr,
@@ -558,6 +703,9 @@ struct Profiler
     pnanovdb_uint64_t currentCaptureIndex = 0u;
     pnanovdb_uint64_t currentCaptureID = 0llu;
 
+    // captures run while a report callback is set or tracing is enabled, latched per flush
+    pnanovdb_bool_t active = PNANOVDB_FALSE;
+
     void* userdata = nullptr;
     void(PNANOVDB_ABI* reportEntries)(void* userdata,
                                       pnanovdb_uint64_t captureID,
@@ -568,9 +716,9 @@ struct Profiler
 Profiler* profiler_create(Context* context);
 void profiler_destroy(Context* context, Profiler* ptr);
 void profiler_beginCapture(Context* context, Profiler* ptr, pnanovdb_uint64_t numEntries);
-void profiler_endCapture(Context* context, Profiler* ptr);
+void profiler_endCapture(Context* context, Profiler* ptr, pnanovdb_uint32_t barrierCount);
 void profiler_processCaptures(Context* context, Profiler* ptr);
-void profiler_timestamp(Context* context, Profiler* ptr, const char* label);
+void profiler_timestamp(Context* context, Profiler* ptr, const char* label, pnanovdb_uint32_t barrierCount);
 
 void enableProfiler(pnanovdb_compute_context_t* context,
                     void* userdata,
@@ -615,6 +763,14 @@ struct ContextNode
     std::vector<TextureTransient*> textureTransientsDestroy;
     std::vector<VkBufferMemoryBarrier> bufferBarriers;
     std::vector<VkImageMemoryBarrier> imageBarriers;
+    NodeBarrierMasks barrier;
+};
+
+struct TransientArena
+{
+    MemoryAllocation allocation = {};
+    pnanovdb_uint64_t lastActive = 0llu;
+    pnanovdb_uint64_t id = 0llu;
 };
 
 struct Context
@@ -640,8 +796,17 @@ struct Context
     std::vector<VkBufferMemoryBarrier> restore_bufferBarriers;
     std::vector<VkImageMemoryBarrier> restore_imageBarriers;
 
+    pnanovdb_uint64_t flushIdx = 0llu;
+
+    // transient buffers with disjoint node lifetimes share one arena per flush
+    std::vector<TransientArena> transientArenas;
+    std::vector<std::unique_ptr<Buffer>> aliasedBuffers;
+    pnanovdb_uint64_t transientArenaCounter = 0llu;
+
     Profiler* profiler = nullptr;
 
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
     pnanovdb_uint64_t minLifetime = 60u;
 
     pnanovdb_compute_log_print_t logPrint = nullptr;
@@ -656,6 +821,10 @@ Context* context_create(DeviceQueue* deviceQueue);
 void context_destroy(Context* context);
 void context_resetNodes(Context* context);
 void context_flushNodes(Context* context);
+void context_aliasTransientBuffers(Context* context);
+void context_destroyTransientArenas(Context* context, pnanovdb_bool_t forceDestroy);
+void context_createPipelineCache(Context* context);
+void context_destroyPipelineCache(Context* context);
 
 /// Format conversion
 
@@ -56,6 +56,8 @@ typedef struct pnanovdb_vulkan_enabled_device_extensions_t
     pnanovdb_bool_t VK_KHR_VIDEO_ENCODE_QUEUE;
     pnanovdb_bool_t VK_KHR_MAINTENANCE_5;
     pnanovdb_bool_t VK_EXT_SHADER_64BIT_INDEXING;
+    pnanovdb_bool_t VK_KHR_PUSH_DESCRIPTOR;
+    pnanovdb_bool_t VK_EXT_MEMORY_BUDGET;
 } pnanovdb_vulkan_enabled_device_extensions_t;
 
 typedef struct pnanovdb_vulkan_instance_loader_t
@@ -77,6 +79,7 @@ typedef struct pnanovdb_vulkan_instance_loader_t
 
     PNANOVDB_VK_LOADER_PTR(vkCreateDevice);
     PNANOVDB_VK_LOADER_PTR(vkGetPhysicalDeviceMemoryProperties);
+    PNANOVDB_VK_LOADER_PTR(vkGetPhysicalDeviceMemoryProperties2KHR);
     PNANOVDB_VK_LOADER_PTR(vkEnumerateDeviceExtensionProperties);
     PNANOVDB_VK_LOADER_PTR(vkGetPhysicalDeviceFeatures2);
 
@@ -173,6 +176,10 @@ typedef struct pnanovdb_vulkan_device_loader_t
     PNANOVDB_VK_LOADER_PTR(vkCmdCopyBufferToImage);
     PNANOVDB_VK_LOADER_PTR(vkCmdCopyImageToBuffer);
     PNANOVDB_VK_LOADER_PTR(vkCmdPushConstants);
+    PNANOVDB_VK_LOADER_PTR(vkCreatePipelineCache);
+    PNANOVDB_VK_LOADER_PTR(vkDestroyPipelineCache);
+    PNANOVDB_VK_LOADER_PTR(vkGetPipelineCacheData);
+    PNANOVDB_VK_LOADER_PTR(vkMergePipelineCaches);
 #if defined(_WIN32)
     PNANOVDB_VK_LOADER_PTR(vkGetMemoryWin32HandleKHR);
     PNANOVDB_VK_LOADER_PTR(vkGetSemaphoreWin32HandleKHR);
@@ -204,6 +211,11 @@ typedef struct pnanovdb_vulkan_device_loader_t
     PNANOVDB_VK_LOADER_PTR(vkDestroyVideoSessionParametersKHR);
     PNANOVDB_VK_LOADER_PTR(vkDestroyVideoSessionKHR);
     PNANOVDB_VK_LOADER_PTR(vkGetBufferDeviceAddress);
+    PNANOVDB_VK_LOADER_PTR(vkCreateDescriptorUpdateTemplate);
+    PNANOVDB_VK_LOADER_PTR(vkDestroyDescriptorUpdateTemplate);
+    PNANOVDB_VK_LOADER_PTR(vkUpdateDescriptorSetWithTemplate);
+    PNANOVDB_VK_LOADER_PTR(vkCmdPushDescriptorSetKHR);
+    PNANOVDB_VK_LOADER_PTR(vkCmdPushDescriptorSetWithTemplateKHR);
 } pnanovdb_vulkan_device_loader_t;
 
 PNANOVDB_INLINE void pnanovdb_vulkan_loader_global(pnanovdb_vulkan_instance_loader_t* ptr,
@@ -229,6 +241,7 @@ PNANOVDB_INLINE void pnanovdb_vulkan_loader_instance(pnanovdb_vulkan_instance_lo
 
     PNANOVDB_VK_LOADER_INSTANCE(vkCreateDevice);
     PNANOVDB_VK_LOADER_INSTANCE(vkGetPhysicalDeviceMemoryProperties);
+    PNANOVDB_VK_LOADER_INSTANCE(vkGetPhysicalDeviceMemoryProperties2KHR);
     PNANOVDB_VK_LOADER_INSTANCE(vkEnumerateDeviceExtensionProperties);
     PNANOVDB_VK_LOADER_INSTANCE(vkGetPhysicalDeviceFeatures2);
 
@@ -325,6 +338,10 @@ PNANOVDB_INLINE void pnanovdb_vulkan_loader_device(pnanovdb_vulkan_device_loader
     PNANOVDB_VK_LOADER_DEVICE(vkCmdCopyBufferToImage);
     PNANOVDB_VK_LOADER_DEVICE(vkCmdCopyImageToBuffer);
     PNANOVDB_VK_LOADER_DEVICE(vkCmdPushConstants);
+    PNANOVDB_VK_LOADER_DEVICE(vkCreatePipelineCache);
+    PNANOVDB_VK_LOADER_DEVICE(vkDestroyPipelineCache);
+    PNANOVDB_VK_LOADER_DEVICE(vkGetPipelineCacheData);
+    PNANOVDB_VK_LOADER_DEVICE(vkMergePipelineCaches);
 #if defined(_WIN32)
     PNANOVDB_VK_LOADER_DEVICE(vkGetMemoryWin32HandleKHR);
     PNANOVDB_VK_LOADER_DEVICE(vkGetSemaphoreWin32HandleKHR);
@@ -356,4 +373,9 @@ PNANOVDB_INLINE void pnanovdb_vulkan_loader_device(pnanovdb_vulkan_device_loader
     PNANOVDB_VK_LOADER_DEVICE(vkDestroyVideoSessionParametersKHR);
     PNANOVDB_VK_LOADER_DEVICE(vkDestroyVideoSessionKHR);
     PNANOVDB_VK_LOADER_DEVICE(vkGetBufferDeviceAddress);
+    PNANOVDB_VK_LOADER_DEVICE(vkCreateDescriptorUpdateTemplate);
+    PNANOVDB_VK_LOADER_DEVICE(vkDestroyDescriptorUpdateTemplate);
+    PNANOVDB_VK_LOADER_DEVICE(vkUpdateDescriptorSetWithTemplate);
+    PNANOVDB_VK_LOADER_DEVICE(vkCmdPushDescriptorSetKHR);
+    PNANOVDB_VK_LOADER_DEVICE(vkCmdPushDescriptorSetWithTemplateKHR);
 }
@@ -0,0 +1,185 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   MemoryRangesVulkan.h
+
+    \brief  Range bookkeeping of the memory heap and transient arenas, kept free of Vulkan types so it can be tested
+            without a device.
+*/
+
+#pragma once
+
+#include "nanovdb_editor/putil/Compute.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace pnanovdb_vulkan
+{
+// blocks are sub-allocated in size classes, larger requests get a dedicated block
+static const pnanovdb_uint64_t kMemoryBlockSizeDevice = 64u * 1024u * 1024u;
+static const pnanovdb_uint64_t kMemoryBlockSizeHost = 16u * 1024u * 1024u;
+static const pnanovdb_uint64_t kMemoryMinSizeClass = 256u;
+
+struct MemoryRange
+{
+    pnanovdb_uint64_t offset;
+    pnanovdb_uint64_t sizeInBytes;
+};
+
+// four linear steps per power of two, bounds internal waste to 25%
+inline pnanovdb_uint64_t memoryHeap_getSizeClass(pnanovdb_uint64_t sizeInBytes)
+{
+    if (sizeInBytes <= kMemoryMinSizeClass)
+    {
+        return kMemoryMinSizeClass;
+    }
+    pnanovdb_uint32_t topBit = 63u;
+    while (!(sizeInBytes & (1llu << topBit)))
+    {
+        topBit--;
+    }
+    pnanovdb_uint64_t step = 1llu << (topBit - 2u);
+    return (sizeInBytes + step - 1u) & ~(step - 1u);
+}
+
+inline pnanovdb_uint64_t memoryHeap_getBlockSize(pnanovdb_compute_memory_type_t memory_type)
+{
+    return memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE ? kMemoryBlockSizeDevice : kMemoryBlockSizeHost;
+}
+
+inline pnanovdb_bool_t memoryHeap_needsDedicatedBlock(pnanovdb_compute_memory_type_t memory_type,
+                                                      pnanovdb_uint64_t sizeInBytes)
+{
+    return sizeInBytes > memoryHeap_getBlockSize(memory_type) / 2u;
+}
+
+// best fit over free ranges sorted by offset, returns ~0 if nothing fits
+inline pnanovdb_uint64_t memoryRanges_find(const std::vector<MemoryRange>& freeRanges,
+                                           pnanovdb_uint64_t sizeInBytes,
+                                           pnanovdb_uint64_t alignment,
+                                           pnanovdb_uint64_t* pWaste)
+{
+    pnanovdb_uint64_t bestIdx = ~0llu;
+    pnanovdb_uint64_t bestWaste = ~0llu;
+    for (pnanovdb_uint64_t idx = 0u; idx < freeRanges.size(); idx++)
+    {
+        const MemoryRange& range = freeRanges[idx];
+        pnanovdb_uint64_t alignedOffset = (range.offset + alignment - 1u) / alignment * alignment;
+        pnanovdb_uint64_t padding = alignedOffset - range.offset;
+        if (range.sizeInBytes >= padding + sizeInBytes)
+        {
+            pnanovdb_uint64_t waste = range.sizeInBytes - sizeInBytes;
+            if (waste < bestWaste)
+            {
+                bestIdx = idx;
+                bestWaste = waste;
+            }
+        }
+    }
+    *pWaste = bestWaste;
+    return bestIdx;
+}
+
+// takes sizeInBytes from the free range rangeIdx, returns the aligned offset
+inline pnanovdb_uint64_t memoryRanges_allocate(std::vector<MemoryRange>& freeRanges,
+                                               pnanovdb_uint64_t rangeIdx,
+                                               pnanovdb_uint64_t sizeInBytes,
+                                               pnanovdb_uint64_t alignment)
+{
+    MemoryRange range = freeRanges[rangeIdx];
+    pnanovdb_uint64_t alignedOffset = (range.offset + alignment - 1u) / alignment * alignment;
+    pnanovdb_uint64_t padding = alignedOffset - range.offset;
+    pnanovdb_uint64_t tailSize = range.sizeInBytes - padding - sizeInBytes;
+
+    freeRanges.erase(freeRanges.begin() + rangeIdx);
+    if (tailSize > 0u)
+    {
+        freeRanges.insert(freeRanges.begin() + rangeIdx, MemoryRange{ alignedOffset + sizeInBytes, tailSize });
+    }
+    if (padding > 0u)
+    {
+        freeRanges.insert(freeRanges.begin() + rangeIdx, MemoryRange{ range.offset, padding });
+    }
+    return alignedOffset;
+}
+
+inline void memoryRanges_free(std::vector<MemoryRange>& freeRanges,
+                              pnanovdb_uint64_t offset,
+                              pnanovdb_uint64_t sizeInBytes)
+{
+    pnanovdb_uint64_t insertIdx = 0u;
+    while (insertIdx < freeRanges.size() && freeRanges[insertIdx].offset < offset)
+    {
+        insertIdx++;
+    }
+    freeRanges.insert(freeRanges.begin() + insertIdx, MemoryRange{ offset, sizeInBytes });
+
+    // coalesce with next, then with previous
+    if (insertIdx + 1u < freeRanges.size() &&
+        freeRanges[insertIdx].offset + freeRanges[insertIdx].sizeInBytes == freeRanges[insertIdx + 1u].offset)
+    {
+        freeRanges[insertIdx].sizeInBytes += freeRanges[insertIdx + 1u].sizeInBytes;
+        freeRanges.erase(freeRanges.begin() + insertIdx + 1u);
+    }
+    if (insertIdx > 0u &&
+        freeRanges[insertIdx - 1u].offset + freeRanges[insertIdx - 1u].sizeInBytes == freeRanges[insertIdx].offset)
+    {
+        freeRanges[insertIdx - 1u].sizeInBytes += freeRanges[insertIdx].sizeInBytes;
+        freeRanges.erase(freeRanges.begin() + insertIdx);
+    }
+}
+
+// a transient buffer of one flush, alive from node nodeBegin to node nodeEnd inclusive
+struct AliasedRange
+{
+    int nodeBegin;
+    int nodeEnd;
+    pnanovdb_uint64_t sizeInBytes;
+    pnanovdb_uint64_t alignment;
+    pnanovdb_uint64_t offset;
+};
+
+// largest first, each range takes the lowest offset not overlapping a placed range with an overlapping lifetime,
+// writes the offsets and returns the arena size
+inline pnanovdb_uint64_t aliasedRanges_place(std::vector<AliasedRange>& ranges)
+{
+    std::vector<pnanovdb_uint64_t> order(ranges.size());
+    for (pnanovdb_uint64_t idx = 0u; idx < order.size(); idx++)
+    {
+        order[idx] = idx;
+    }
+    std::stable_sort(order.begin(), order.end(), [&ranges](pnanovdb_uint64_t a, pnanovdb_uint64_t b)
+                     { return ranges[a].sizeInBytes > ranges[b].sizeInBytes; });
+
+    pnanovdb_uint64_t arenaSize = 0u;
+    for (pnanovdb_uint64_t idx = 0u; idx < order.size(); idx++)
+    {
+        AliasedRange& range = ranges[order[idx]];
+        pnanovdb_uint64_t offset = 0u;
+        pnanovdb_bool_t moved = PNANOVDB_TRUE;
+        while (moved)
+        {
+            moved = PNANOVDB_FALSE;
+            for (pnanovdb_uint64_t otherIdx = 0u; otherIdx < idx; otherIdx++)
+            {
+                const AliasedRange& other = ranges[order[otherIdx]];
+                pnanovdb_bool_t lifetimeOverlap = range.nodeBegin <= other.nodeEnd && other.nodeBegin <= range.nodeEnd;
+                pnanovdb_bool_t rangeOverlap =
+                    offset < other.offset + other.sizeInBytes && other.offset < offset + range.sizeInBytes;
+                if (lifetimeOverlap && rangeOverlap)
+                {
+                    offset = (other.offset + other.sizeInBytes + range.alignment - 1u) / range.alignment *
+                             range.alignment;
+                    moved = PNANOVDB_TRUE;
+                }
+            }
+        }
+        range.offset = offset;
+        arenaSize = std::max(arenaSize, offset + range.sizeInBytes);
+    }
+    return arenaSize;
+}
+
+} // namespace pnanovdb_vulkan
@@ -0,0 +1,340 @@
+
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   MemoryVulkan.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  This file is part of the PNanoVDB Compute Vulkan reference implementation.
+*/
+
+#include "CommonVulkan.h"
+
+namespace pnanovdb_vulkan
+{
+
+MemoryHeap* memoryHeap_create(Device* device)
+{
+    return new MemoryHeap();
+}
+
+void memoryHeap_destroy(Device* device, MemoryHeap* heap)
+{
+    auto loader = &device->loader;
+
+    for (pnanovdb_uint64_t idx = 0u; idx < heap->blocks.size(); idx++)
+    {
+        MemoryBlock* block = heap->blocks[idx].get();
+        if (block->allocationCount > 0u)
+        {
+            device->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_WARNING, "Memory block destroyed with %d live allocations",
+                             block->allocationCount);
+        }
+        loader->vkFreeMemory(device->vulkanDevice, block->memoryVk, nullptr);
+        device_reportMemoryFree(device, block->memory_type, block->sizeInBytes);
+    }
+    heap->blocks.clear();
+
+    delete heap;
+}
+
+static uint32_t memoryHeap_getMemoryType(Device* device, uint32_t typeBits, VkMemoryPropertyFlags properties)
+{
+    for (uint32_t i = 0u; i < device->memoryProperties.memoryTypeCount; i++)
+    {
+        if ((typeBits & (1u << i)) != 0u &&
+            (device->memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        {
+            return i;
+        }
+    }
+    return ~0u;
+}
+
+static void memoryHeap_selectMemoryTypes(Device* device,
+                                         uint32_t typeBits,
+                                         pnanovdb_compute_memory_type_t memory_type,
+                                         uint32_t* pPreferred,
+                                         uint32_t* pFallback)
+{
+    uint32_t preferred = ~0u;
+    uint32_t fallback = ~0u;
+    if (memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD)
+    {
+        preferred = memoryHeap_getMemoryType(
+            device, typeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+    else if (memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK)
+    {
+        preferred = memoryHeap_getMemoryType(device, typeBits,
+                                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+                                                 VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        if (preferred == ~0u)
+        {
+            preferred = memoryHeap_getMemoryType(
+                device, typeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        }
+    }
+    else // (memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE)
+    {
+        preferred = memoryHeap_getMemoryType(device, typeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        fallback = memoryHeap_getMemoryType(device, typeBits, 0);
+    }
+    *pPreferred = preferred;
+    *pFallback = fallback;
+}
+
+static MemoryBlock* memoryHeap_createBlock(Device* device,
+                                           MemoryHeap* heap,
+                                           pnanovdb_compute_memory_type_t memory_type,
+                                           uint32_t memoryTypeIndex,
+                                           pnanovdb_bool_t isLinear,
+                                           pnanovdb_bool_t isDedicated,
+                                           pnanovdb_uint64_t sizeInBytes)
+{
+    auto loader = &device->loader;
+
+    VkMemoryAllocateInfo memAllocInfo = {};
+    memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memAllocInfo.allocationSize = sizeInBytes;
+    memAllocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    // any buffer placed in the block might need a device address
+    VkMemoryAllocateFlagsInfo memAllocFlagsInfo = {};
+    memAllocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    if (isLinear && device->enabledFeatures.bufferDeviceAddress)
+    {
+        memAllocInfo.pNext = &memAllocFlagsInfo;
+        memAllocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    }
+
+    VkDeviceMemory memoryVk = VK_NULL_HANDLE;
+    VkResult result = loader->vkAllocateMemory(device->vulkanDevice, &memAllocInfo, nullptr, &memoryVk);
+    if (result != VK_SUCCESS)
+    {
+        return nullptr;
+    }
+    device->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Memory block allocate %lld bytes type(%d) dedicated(%d)",
+                     sizeInBytes, memoryTypeIndex, isDedicated);
+    device_reportMemoryAllocate(device, memory_type, sizeInBytes);
+
+    auto block = new MemoryBlock();
+    block->memory_type = memory_type;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->isLinear = isLinear;
+    block->isDedicated = isDedicated;
+    block->sizeInBytes = sizeInBytes;
+    block->memoryVk = memoryVk;
+    block->freeRanges.push_back(MemoryRange{ 0llu, sizeInBytes });
+
+    if (memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_UPLOAD || memory_type == PNANOVDB_COMPUTE_MEMORY_TYPE_READBACK)
+    {
+        loader->vkMapMemory(device->vulkanDevice, memoryVk, 0u, VK_WHOLE_SIZE, 0u, &block->mappedData);
+    }
+
+    heap->blocks.push_back(std::unique_ptr<MemoryBlock>(block));
+    return block;
+}
+
+static void memoryHeap_destroyBlock(Device* device, MemoryHeap* heap, MemoryBlock* block)
+{
+    for (pnanovdb_uint64_t idx = 0u; idx < heap->blocks.size(); idx++)
+    {
+        if (heap->blocks[idx].get() == block)
+        {
+            device->loader.vkFreeMemory(device->vulkanDevice, block->memoryVk, nullptr);
+            device_reportMemoryFree(device, block->memory_type, block->sizeInBytes);
+
+            heap->blocks.erase(heap->blocks.begin() + idx);
+            break;
+        }
+    }
+}
+
+static void memoryBlock_allocateRange(MemoryBlock* block,
+                                      pnanovdb_uint64_t rangeIdx,
+                                      pnanovdb_uint64_t sizeInBytes,
+                                      pnanovdb_uint64_t alignment,
+                                      MemoryAllocation* dst)
+{
+    pnanovdb_uint64_t alignedOffset = memoryRanges_allocate(block->freeRanges, rangeIdx, sizeInBytes, alignment);
+
+    block->usedBytes += sizeInBytes;
+    block->allocationCount++;
+
+    dst->block = block;
+    dst->memoryVk = block->memoryVk;
+    dst->offset = alignedOffset;
+    dst->sizeInBytes = sizeInBytes;
+    dst->mappedData = block->mappedData ? (unsigned char*)block->mappedData + alignedOffset : nullptr;
+}
+
+static void memoryBlock_freeRange(MemoryBlock* block, pnanovdb_uint64_t offset, pnanovdb_uint64_t sizeInBytes)
+{
+    memoryRanges_free(block->freeRanges, offset, sizeInBytes);
+
+    block->usedBytes -= sizeInBytes;
+    block->allocationCount--;
+}
+
+static pnanovdb_bool_t memoryHeap_allocateFromType(Device* device,
+                                                   MemoryHeap* heap,
+                                                   pnanovdb_uint64_t sizeInBytes,
+                                                   pnanovdb_uint64_t alignment,
+                                                   pnanovdb_compute_memory_type_t memory_type,
+                                                   uint32_t memoryTypeIndex,
+                                                   pnanovdb_bool_t isLinear,
+                                                   MemoryAllocation* dst)
+{
+    // dedicated blocks are sized exactly, the size class only helps reuse inside shared blocks
+    if (memoryHeap_needsDedicatedBlock(memory_type, sizeInBytes))
+    {
+        MemoryBlock* block =
+            memoryHeap_createBlock(device, heap, memory_type, memoryTypeIndex, isLinear, PNANOVDB_TRUE, sizeInBytes);
+        if (!block)
+        {
+            return PNANOVDB_FALSE;
+        }
+        memoryBlock_allocateRange(block, 0u, sizeInBytes, 1u, dst);
+        return PNANOVDB_TRUE;
+    }
+    sizeInBytes = memoryHeap_getSizeClass(sizeInBytes);
+
+    MemoryBlock* bestBlock = nullptr;
+    pnanovdb_uint64_t bestRangeIdx = ~0llu;
+    pnanovdb_uint64_t bestWaste = ~0llu;
+    for (pnanovdb_uint64_t idx = 0u; idx < heap->blocks.size(); idx++)
+    {
+        MemoryBlock* block = heap->blocks[idx].get();
+        if (block->isDedicated || block->memory_type != memory_type || block->memoryTypeIndex != memoryTypeIndex ||
+            block->isLinear != isLinear)
+        {
+            continue;
+        }
+        pnanovdb_uint64_t waste = 0u;
+        pnanovdb_uint64_t rangeIdx = memoryRanges_find(block->freeRanges, sizeInBytes, alignment, &waste);
+        if (rangeIdx != ~0llu && waste < bestWaste)
+        {
+            bestBlock = block;
+            bestRangeIdx = rangeIdx;
+            bestWaste = waste;
+        }
+    }
+    if (!bestBlock)
+    {
+        pnanovdb_uint64_t blockSize = memoryHeap_getBlockSize(memory_type);
+        bestBlock =
+            memoryHeap_createBlock(device, heap, memory_type, memoryTypeIndex, isLinear, PNANOVDB_FALSE, blockSize);
+        bestRangeIdx = 0u;
+    }
+    if (!bestBlock)
+    {
+        return PNANOVDB_FALSE;
+    }
+    memoryBlock_allocateRange(bestBlock, bestRangeIdx, sizeInBytes, alignment, dst);
+    return PNANOVDB_TRUE;
+}
+
+pnanovdb_bool_t memoryHeap_allocate(Device* device,
+                                    const VkMemoryRequirements* memReq,
+                                    pnanovdb_compute_memory_type_t memory_type,
+                                    pnanovdb_bool_t isLinear,
+                                    MemoryAllocation* dst)
+{
+    MemoryHeap* heap = device->memoryHeap;
+    std::lock_guard<std::mutex> lock(heap->mutex);
+
+    uint32_t preferred = ~0u;
+    uint32_t fallback = ~0u;
+    memoryHeap_selectMemoryTypes(device, memReq->memoryTypeBits, memory_type, &preferred, &fallback);
+
+    pnanovdb_uint64_t sizeInBytes = memReq->size;
+    pnanovdb_uint64_t alignment = memReq->alignment > 0u ? memReq->alignment : 1u;
+
+    if (preferred != ~0u &&
+        memoryHeap_allocateFromType(device, heap, sizeInBytes, alignment, memory_type, preferred, isLinear, dst))
+    {
+        return PNANOVDB_TRUE;
+    }
+    if (fallback != ~0u && fallback != preferred &&
+        memoryHeap_allocateFromType(device, heap, sizeInBytes, alignment, memory_type, fallback, isLinear, dst))
+    {
+        device->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Memory sysmem fallback allocate %lld bytes", sizeInBytes);
+        return PNANOVDB_TRUE;
+    }
+    device->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Memory allocate failed %lld bytes", sizeInBytes);
+    return PNANOVDB_FALSE;
+}
+
+void memoryHeap_free(Device* device, MemoryAllocation* allocation)
+{
+    MemoryBlock* block = allocation->block;
+    if (!block)
+    {
+        return;
+    }
+    MemoryHeap* heap = device->memoryHeap;
+    std::lock_guard<std::mutex> lock(heap->mutex);
+
+    memoryBlock_freeRange(block, allocation->offset, allocation->sizeInBytes);
+    *allocation = MemoryAllocation{};
+
+    if (block->allocationCount > 0u)
+    {
+        return;
+    }
+    // keep one empty block per memory type around to avoid churn on resize heavy workloads
+    pnanovdb_bool_t shouldDestroy = block->isDedicated;
+    for (pnanovdb_uint64_t idx = 0u; idx < heap->blocks.size() && !shouldDestroy; idx++)
+    {
+        MemoryBlock* other = heap->blocks[idx].get();
+        if (other != block && !other->isDedicated && other->allocationCount == 0u &&
+            other->memoryTypeIndex == block->memoryTypeIndex && other->memory_type == block->memory_type &&
+            other->isLinear == block->isLinear)
+        {
+            shouldDestroy = PNANOVDB_TRUE;
+        }
+    }
+    if (shouldDestroy)
+    {
+        memoryHeap_destroyBlock(device, heap, block);
+    }
+}
+
+void memoryHeap_getStats(Device* device, pnanovdb_compute_device_memory_stats_t* dstStats)
+{
+    MemoryHeap* heap = device->memoryHeap;
+    std::lock_guard<std::mutex> lock(heap->mutex);
+
+    dstStats->heap_block_count = 0u;
+    dstStats->heap_block_bytes = 0u;
+    dstStats->heap_used_bytes = 0u;
+    dstStats->heap_largest_free_bytes = 0u;
+    dstStats->suballocation_count = 0u;
+    dstStats->dedicated_block_count = 0u;
+    for (pnanovdb_uint64_t idx = 0u; idx < heap->blocks.size(); idx++)
+    {
+        const MemoryBlock* block = heap->blocks[idx].get();
+        if (block->isDedicated)
+        {
+            dstStats->dedicated_block_count++;
+            continue;
+        }
+        dstStats->heap_block_count++;
+        dstStats->heap_block_bytes += block->sizeInBytes;
+        dstStats->heap_used_bytes += block->usedBytes;
+        dstStats->suballocation_count += block->allocationCount;
+        for (pnanovdb_uint64_t rangeIdx = 0u; rangeIdx < block->freeRanges.size(); rangeIdx++)
+        {
+            if (block->freeRanges[rangeIdx].sizeInBytes > dstStats->heap_largest_free_bytes)
+            {
+                dstStats->heap_largest_free_bytes = block->freeRanges[rangeIdx].sizeInBytes;
+            }
+        }
+    }
+}
+
+} // end namespace
@@ -0,0 +1,192 @@
+
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   PipelineCacheVulkan.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  This file is part of the PNanoVDB Compute Vulkan reference implementation.
+*/
+
+#include "CommonVulkan.h"
+
+#include "nanovdb_editor/putil/Shader.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace pnanovdb_vulkan
+{
+
+// one file per vendor, device and driver, a driver update starts from an empty cache
+static std::string device_getPipelineCachePath(Device* ptr)
+{
+    const VkPhysicalDeviceProperties& props = ptr->physicalDeviceProperties;
+
+    char filename[96u] = {};
+    snprintf(filename, sizeof(filename), "pipeline_cache_%08x_%08x_%08x.bin", props.vendorID, props.deviceID,
+             props.driverVersion);
+
+    return (std::filesystem::path(pnanovdb_shader::getShaderCacheDir()) / filename).string();
+}
+
+static pnanovdb_bool_t device_validatePipelineCacheData(Device* ptr, const std::vector<char>& data)
+{
+    if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        return PNANOVDB_FALSE;
+    }
+    VkPipelineCacheHeaderVersionOne header = {};
+    memcpy(&header, data.data(), sizeof(header));
+
+    const VkPhysicalDeviceProperties& props = ptr->physicalDeviceProperties;
+    return header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header.vendorID == props.vendorID &&
+           header.deviceID == props.deviceID &&
+           memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+void device_loadPipelineCache(Device* ptr)
+{
+    auto loader = &ptr->loader;
+
+    std::string path = device_getPipelineCachePath(ptr);
+
+    ptr->pipelineCacheData.clear();
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file)
+    {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (size > 0)
+        {
+            ptr->pipelineCacheData.resize(size_t(size));
+            if (fread(ptr->pipelineCacheData.data(), 1u, size_t(size), file) != size_t(size))
+            {
+                ptr->pipelineCacheData.clear();
+            }
+        }
+        fclose(file);
+    }
+    if (!ptr->pipelineCacheData.empty() && !device_validatePipelineCacheData(ptr, ptr->pipelineCacheData))
+    {
+        ptr->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_WARNING, "Pipeline cache '%s' does not match device, ignoring",
+                      path.c_str());
+        ptr->pipelineCacheData.clear();
+    }
+
+    VkPipelineCacheCreateInfo cacheCreateInfo = {};
+    cacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheCreateInfo.initialDataSize = ptr->pipelineCacheData.size();
+    cacheCreateInfo.pInitialData = ptr->pipelineCacheData.empty() ? nullptr : ptr->pipelineCacheData.data();
+
+    VkResult result = loader->vkCreatePipelineCache(ptr->vulkanDevice, &cacheCreateInfo, nullptr, &ptr->pipelineCache);
+    if (result != VK_SUCCESS && cacheCreateInfo.initialDataSize > 0u)
+    {
+        // the driver rejected the data, fall back to an empty cache
+        ptr->pipelineCacheData.clear();
+        cacheCreateInfo.initialDataSize = 0u;
+        cacheCreateInfo.pInitialData = nullptr;
+        result = loader->vkCreatePipelineCache(ptr->vulkanDevice, &cacheCreateInfo, nullptr, &ptr->pipelineCache);
+    }
+    if (result != VK_SUCCESS)
+    {
+        ptr->pipelineCache = VK_NULL_HANDLE;
+        return;
+    }
+
+    ptr->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_INFO, "Pipeline cache loaded %zu bytes from '%s'",
+                  ptr->pipelineCacheData.size(), path.c_str());
+}
+
+void device_savePipelineCache(Device* ptr)
+{
+    auto loader = &ptr->loader;
+
+    if (!ptr->pipelineCache)
+    {
+        return;
+    }
+
+    size_t dataSize = 0u;
+    VkResult result = loader->vkGetPipelineCacheData(ptr->vulkanDevice, ptr->pipelineCache, &dataSize, nullptr);
+    std::vector<char> data(dataSize);
+    if (result == VK_SUCCESS && dataSize > 0u)
+    {
+        result = loader->vkGetPipelineCacheData(ptr->vulkanDevice, ptr->pipelineCache, &dataSize, data.data());
+        data.resize(dataSize);
+    }
+    loader->vkDestroyPipelineCache(ptr->vulkanDevice, ptr->pipelineCache, nullptr);
+    ptr->pipelineCache = VK_NULL_HANDLE;
+
+    if (result != VK_SUCCESS || data.empty() || data == ptr->pipelineCacheData)
+    {
+        return;
+    }
+
+    // write to a temporary file first, so a crash or a concurrent instance never leaves a torn cache
+    std::string path = device_getPipelineCachePath(ptr);
+    std::string tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (!file)
+    {
+        ptr->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_WARNING, "Pipeline cache '%s' could not be written", path.c_str());
+        return;
+    }
+    size_t written = fwrite(data.data(), 1u, data.size(), file);
+    fclose(file);
+
+    std::error_code ec;
+    if (written == data.size())
+    {
+        std::filesystem::rename(tmpPath, path, ec);
+    }
+    if (written != data.size() || ec)
+    {
+        std::filesystem::remove(tmpPath, ec);
+        ptr->logPrint(PNANOVDB_COMPUTE_LOG_LEVEL_WARNING, "Pipeline cache '%s' could not be written", path.c_str());
+        return;
+    }
+
+    ptr->logPrint(
+        PNANOVDB_COMPUTE_LOG_LEVEL_INFO, "Pipeline cache saved %zu bytes to '%s'", data.size(), path.c_str());
+}
+
+// each context compiles into its own cache, so pipeline creation on different queues does not contend
+void context_createPipelineCache(Context* context)
+{
+    auto device = context->deviceQueue->device;
+    auto loader = &device->loader;
+
+    VkPipelineCacheCreateInfo cacheCreateInfo = {};
+    cacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheCreateInfo.initialDataSize = device->pipelineCacheData.size();
+    cacheCreateInfo.pInitialData = device->pipelineCacheData.empty() ? nullptr : device->pipelineCacheData.data();
+
+    if (loader->vkCreatePipelineCache(device->vulkanDevice, &cacheCreateInfo, nullptr, &context->pipelineCache) !=
+        VK_SUCCESS)
+    {
+        context->pipelineCache = VK_NULL_HANDLE;
+    }
+}
+
+void context_destroyPipelineCache(Context* context)
+{
+    auto device = context->deviceQueue->device;
+    auto loader = &device->loader;
+
+    if (!context->pipelineCache)
+    {
+        return;
+    }
+    if (device->pipelineCache)
+    {
+        loader->vkMergePipelineCaches(device->vulkanDevice, device->pipelineCache, 1u, &context->pipelineCache);
+    }
+    loader->vkDestroyPipelineCache(device->vulkanDevice, context->pipelineCache, nullptr);
+    context->pipelineCache = VK_NULL_HANDLE;
+}
+
+} // end namespace
@@ -142,6 +142,8 @@ pnanovdb_compute_device_interface_t* pnanovdb_get_compute_device_interface(pnano
     iface.get_frame_global_completed = getLastFrameCompleted;
     iface.wait_for_frame = waitForFrame;
     iface.wait_idle = waitIdle;
+    iface.is_frame_completed = isFrameCompleted;
+    iface.add_frame_callback = addFrameCallback;
     iface.get_compute_interface = getContextInterface;
     iface.get_compute_context = getContext;
 
@@ -163,5 +165,11 @@ pnanovdb_compute_device_interface_t* pnanovdb_get_compute_device_interface(pnano
 
     iface.set_resource_min_lifetime = setResourceMinLifetime;
 
+    iface.enable_trace = enableTrace;
+    iface.trace_timestamp = traceTimestamp;
+    iface.trace_scope = traceScope;
+    iface.export_trace = exportTrace;
+    iface.save_trace = saveTrace;
+
     return &iface;
 }
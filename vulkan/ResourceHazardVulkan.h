@@ -0,0 +1,226 @@
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   ResourceHazardVulkan.h
+
+    \brief  Barrier derivation for the passes of one context flush, kept free of device state so it can be tested
+            without a device.
+*/
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "nanovdb_editor/putil/Compute.h"
+
+namespace pnanovdb_vulkan
+{
+struct DeviceQueue;
+
+static const VkAccessFlags kResourceWriteAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+// per flush access history of a resource, used to derive the minimal barrier for the next pass
+struct ResourceHazard
+{
+    pnanovdb_uint64_t flushIdx = ~0llu;
+    VkPipelineStageFlags writeStageMask = 0u;
+    VkAccessFlags writeAccessMask = 0u;
+    VkPipelineStageFlags readStageMask = 0u;
+    VkPipelineStageFlags visibleStageMask = 0u;
+    VkAccessFlags visibleAccessMask = 0u;
+    // queue whose flushes already see the last write, kept across flushes unlike the masks above
+    DeviceQueue* writeVisibleQueue = nullptr;
+};
+
+// the one pipeline barrier recorded before a node
+struct NodeBarrierMasks
+{
+    // global memory barrier for first uses of aliased memory, written through buffers this node does not name
+    VkAccessFlags memorySrcAccessMask = 0u;
+    VkAccessFlags memoryDstAccessMask = 0u;
+    // stages this node waits on and the stages it blocks, zero if it may overlap the previous node
+    VkPipelineStageFlags srcStageMask = 0u;
+    VkPipelineStageFlags dstStageMask = 0u;
+};
+
+inline void context_getDescriptorAccess(pnanovdb_compute_descriptor_type_t type,
+                                        VkPipelineStageFlags* pStageMask,
+                                        VkAccessFlags* pAccessMask,
+                                        VkImageLayout* pLayout)
+{
+    *pStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    *pAccessMask = 0u;
+    *pLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_CONSTANT_BUFFER)
+    {
+        *pAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_STRUCTURED_BUFFER ||
+             type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER)
+    {
+        *pAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_STRUCTURED_BUFFER ||
+             type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_BUFFER)
+    {
+        *pAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_INDIRECT_BUFFER)
+    {
+        *pStageMask = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+        *pAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_SRC)
+    {
+        *pStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        *pAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_BUFFER_COPY_DST)
+    {
+        *pStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        *pAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE)
+    {
+        *pAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        *pLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_RW_TEXTURE)
+    {
+        *pAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        *pLayout = VK_IMAGE_LAYOUT_GENERAL;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE_COPY_SRC)
+    {
+        *pStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        *pAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        *pLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    }
+    else if (type == PNANOVDB_COMPUTE_DESCRIPTOR_TYPE_TEXTURE_COPY_DST)
+    {
+        *pStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        *pAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        *pLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    }
+}
+
+// merges another descriptor of the same resource into one access, so a node never waits on itself
+inline void context_mergeDescriptorAccess(VkPipelineStageFlags* pStageMask,
+                                          VkAccessFlags* pAccessMask,
+                                          VkImageLayout* pLayout,
+                                          VkPipelineStageFlags stageMask,
+                                          VkAccessFlags accessMask,
+                                          VkImageLayout layout)
+{
+    *pStageMask |= stageMask;
+    *pAccessMask |= accessMask;
+    if (*pLayout != layout)
+    {
+        *pLayout = VK_IMAGE_LAYOUT_GENERAL;
+    }
+}
+
+// returns true on the first use this flush of a resource in aliased memory
+inline pnanovdb_bool_t resourceHazard_begin(ResourceHazard* hazard,
+                                            DeviceQueue* deviceQueue,
+                                            pnanovdb_uint64_t flushIdx,
+                                            pnanovdb_bool_t memoryAliased)
+{
+    if (hazard->flushIdx == flushIdx)
+    {
+        return PNANOVDB_FALSE;
+    }
+    // the previous flush ended with a global barrier, so resources enter each flush without hazards
+    DeviceQueue* writeVisibleQueue = hazard->writeVisibleQueue;
+    *hazard = ResourceHazard();
+    hazard->flushIdx = flushIdx;
+    hazard->writeVisibleQueue = deviceQueue;
+    // except memory shared with earlier transients of this flush, whose accesses are not tracked here, and writes
+    // of the other queue, its global barrier and the host fence wait make them available but not visible here
+    if (memoryAliased || (writeVisibleQueue && writeVisibleQueue != deviceQueue))
+    {
+        hazard->writeStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+        hazard->writeAccessMask = kResourceWriteAccessMask;
+        hazard->readStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT |
+                                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    }
+    return memoryAliased;
+}
+
+// returns true if the access needs a barrier, the stages and accesses to wait on are returned either way
+inline pnanovdb_bool_t resourceHazard_resolve(ResourceHazard* hazard,
+                                              VkPipelineStageFlags stageMask,
+                                              VkAccessFlags accessMask,
+                                              pnanovdb_bool_t layoutTransition,
+                                              VkPipelineStageFlags* pSrcStageMask,
+                                              VkAccessFlags* pSrcAccessMask)
+{
+    *pSrcStageMask = 0u;
+    *pSrcAccessMask = 0u;
+
+    VkAccessFlags writeAccessMask = accessMask & kResourceWriteAccessMask;
+    if (writeAccessMask != 0u || layoutTransition)
+    {
+        // write after write and layout transitions need a memory dependency, write after read only execution
+        *pSrcStageMask = hazard->writeStageMask | hazard->readStageMask;
+        *pSrcAccessMask = hazard->writeAccessMask;
+        pnanovdb_bool_t needsBarrier = hazard->writeStageMask != 0u || layoutTransition;
+
+        hazard->writeStageMask = stageMask;
+        hazard->writeAccessMask = writeAccessMask;
+        hazard->readStageMask = writeAccessMask != 0u ? 0u : stageMask;
+        hazard->visibleStageMask = writeAccessMask != 0u ? 0u : stageMask;
+        hazard->visibleAccessMask = writeAccessMask != 0u ? 0u : accessMask;
+        return needsBarrier;
+    }
+
+    // read after read needs nothing, read after write once per stage and access
+    pnanovdb_bool_t needsBarrier = PNANOVDB_FALSE;
+    if (hazard->writeStageMask != 0u && ((hazard->visibleStageMask & stageMask) != stageMask ||
+                                         (hazard->visibleAccessMask & accessMask) != accessMask))
+    {
+        *pSrcStageMask = hazard->writeStageMask;
+        *pSrcAccessMask = hazard->writeAccessMask;
+        needsBarrier = PNANOVDB_TRUE;
+
+        hazard->visibleStageMask |= stageMask;
+        hazard->visibleAccessMask |= accessMask;
+    }
+    hazard->readStageMask |= stageMask;
+    return needsBarrier;
+}
+
+// adds one merged access of a node to its barrier, returns true if the access also needs a buffer or image barrier
+// waiting on *pSrcAccessMask
+inline pnanovdb_bool_t resourceHazard_addNodeAccess(ResourceHazard* hazard,
+                                                    DeviceQueue* deviceQueue,
+                                                    pnanovdb_uint64_t flushIdx,
+                                                    pnanovdb_bool_t memoryAliased,
+                                                    VkPipelineStageFlags stageMask,
+                                                    VkAccessFlags accessMask,
+                                                    pnanovdb_bool_t layoutTransition,
+                                                    NodeBarrierMasks* node,
+                                                    VkAccessFlags* pSrcAccessMask)
+{
+    pnanovdb_bool_t firstAliasedUse = resourceHazard_begin(hazard, deviceQueue, flushIdx, memoryAliased);
+    VkPipelineStageFlags srcStageMask = 0u;
+    pnanovdb_bool_t needsBarrier =
+        resourceHazard_resolve(hazard, stageMask, accessMask, layoutTransition, &srcStageMask, pSrcAccessMask);
+
+    // writes by earlier occupants went through other VkBuffers, a buffer barrier would not order them
+    if (firstAliasedUse)
+    {
+        node->memorySrcAccessMask |= *pSrcAccessMask;
+        node->memoryDstAccessMask |= accessMask;
+    }
+    if (needsBarrier || srcStageMask != 0u)
+    {
+        node->srcStageMask |= srcStageMask;
+        node->dstStageMask |= stageMask;
+    }
+    // execution only dependencies need no barrier struct
+    return needsBarrier && (*pSrcAccessMask != 0u || layoutTransition) && !firstAliasedUse;
+}
+
+} // namespace pnanovdb_vulkan
@@ -190,6 +190,15 @@ void texture_createImage(Context* context, Texture* ptr, VkImageUsageFlags usage
     texCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     texCreateInfo.queueFamilyIndexCount = VK_QUEUE_FAMILY_IGNORED;
     texCreateInfo.pQueueFamilyIndices = nullptr;
+    // like buffers, textures can be written by one queue and read by the other without ownership transfers
+    auto device = context->deviceQueue->device;
+    uint32_t queueFamilies[2u] = { device->graphicsQueueFamilyIdx, device->computeQueueFamilyIdx };
+    if (queueFamilies[0u] != queueFamilies[1u])
+    {
+        texCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        texCreateInfo.queueFamilyIndexCount = 2u;
+        texCreateInfo.pQueueFamilyIndices = queueFamilies;
+    }
     texCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
     loader->vkCreateImage(vulkanDevice, &texCreateInfo, nullptr, &ptr->imageVk);
@@ -197,41 +206,23 @@ void texture_createImage(Context* context, Texture* ptr, VkImageUsageFlags usage
     VkMemoryRequirements texMemReq = {};
     loader->vkGetImageMemoryRequirements(vulkanDevice, ptr->imageVk, &texMemReq);
 
-    uint32_t texMemType_device =
-        context_getMemoryType(context, texMemReq.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    uint32_t texMemType_sysmem = context_getMemoryType(context, texMemReq.memoryTypeBits, 0);
-
-    ptr->allocationBytes = texMemReq.size;
-    device_reportMemoryAllocate(context->deviceQueue->device, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, ptr->allocationBytes);
-
-    VkMemoryAllocateInfo texMemAllocInfo = {};
-    texMemAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    texMemAllocInfo.allocationSize = texMemReq.size;
-    texMemAllocInfo.memoryTypeIndex = texMemType_device;
-
-    VkResult result = loader->vkAllocateMemory(vulkanDevice, &texMemAllocInfo, nullptr, &ptr->memoryVk);
-    if (result == VK_SUCCESS)
+    if (memoryHeap_allocate(context->deviceQueue->device, &texMemReq, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE,
+                            PNANOVDB_FALSE, &ptr->allocation))
     {
-        context->deviceQueue->device->logPrint(
-            PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Texture vidmem allocate %lld bytes", texMemReq.size);
+        ptr->allocationBytes = ptr->allocation.sizeInBytes;
+        ptr->memoryVk = ptr->allocation.memoryVk;
+
+        loader->vkBindImageMemory(vulkanDevice, ptr->imageVk, ptr->memoryVk, ptr->allocation.offset);
     }
     else
     {
-        texMemAllocInfo.memoryTypeIndex = texMemType_sysmem;
-        result = loader->vkAllocateMemory(vulkanDevice, &texMemAllocInfo, nullptr, &ptr->memoryVk);
-        if (result == VK_SUCCESS)
-        {
-            context->deviceQueue->device->logPrint(
-                PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Texture sysmem allocate %lld bytes", texMemReq.size);
-        }
-        else
-        {
-            context->deviceQueue->device->logPrint(
-                PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Texture allocate failed %lld bytes", texMemReq.size);
-        }
-    }
+        context->deviceQueue->device->logPrint(
+            PNANOVDB_COMPUTE_LOG_LEVEL_DEBUG, "Texture allocate failed %lld bytes", texMemReq.size);
 
-    loader->vkBindImageMemory(vulkanDevice, ptr->imageVk, ptr->memoryVk, 0u);
+        // texture_destroy only releases images that got memory
+        loader->vkDestroyImage(vulkanDevice, ptr->imageVk, nullptr);
+        ptr->imageVk = VK_NULL_HANDLE;
+    }
 }
 
 void texture_initRestoreBarrier(Context* context, Texture* ptr)
@@ -298,8 +289,11 @@ Texture* texture_create(Context* context, const pnanovdb_compute_texture_desc_t*
     }
 
     texture_createImage(context, ptr, usage);
-    texture_createImageView(
-        context, ptr, &ptr->imageViewVk_all, &ptr->imageViewVk_mipLevel, ptr->desc.format, ptr->imageAspect);
+    if (ptr->imageVk)
+    {
+        texture_createImageView(
+            context, ptr, &ptr->imageViewVk_all, &ptr->imageViewVk_mipLevel, ptr->desc.format, ptr->imageAspect);
+    }
 
     // texture_computeSubresources(context, ptr);
     texture_initRestoreBarrier(context, ptr);
@@ -356,9 +350,7 @@ void texture_destroy(Context* context, Texture* ptr)
     if (ptr->memoryVk)
     {
         loader->vkDestroyImage(loader->device, ptr->imageVk, nullptr);
-        loader->vkFreeMemory(loader->device, ptr->memoryVk, nullptr);
-
-        device_reportMemoryFree(context->deviceQueue->device, PNANOVDB_COMPUTE_MEMORY_TYPE_DEVICE, ptr->allocationBytes);
+        memoryHeap_free(context->deviceQueue->device, &ptr->allocation);
     }
 
     delete ptr;
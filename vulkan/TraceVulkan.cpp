@@ -0,0 +1,117 @@
+
+// Copyright Contributors to the OpenVDB Project
+// SPDX-License-Identifier: Apache-2.0
+
+/*!
+    \file   TraceVulkan.cpp
+
+    \author Andrew Reidmeyer
+
+    \brief  This file is part of the PNanoVDB Compute Vulkan reference implementation.
+*/
+
+#include "CommonVulkan.h"
+
+#include "nanovdb_editor/putil/Trace.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace pnanovdb_vulkan
+{
+
+static pnanovdb_util::TraceRing& trace_ring()
+{
+    static pnanovdb_util::TraceRing ring;
+    return ring;
+}
+
+// last export, so a size query followed by a copy returns the same json
+static std::mutex g_traceExportMutex;
+static std::string g_traceExport;
+
+pnanovdb_bool_t trace_isEnabled()
+{
+    return trace_ring().isEnabled() ? PNANOVDB_TRUE : PNANOVDB_FALSE;
+}
+
+void trace_record(const char* category, const char* name, pnanovdb_uint64_t beginNs, pnanovdb_uint64_t endNs)
+{
+    trace_ring().record(category, name, beginNs, endNs);
+}
+
+void trace_recordTrack(pnanovdb_uint32_t trackId,
+                       const char* category,
+                       const char* name,
+                       pnanovdb_uint64_t beginNs,
+                       pnanovdb_uint64_t endNs)
+{
+    trace_ring().record(category, name, beginNs, endNs, trackId);
+}
+
+pnanovdb_uint32_t trace_registerTrack(const char* name)
+{
+    return trace_ring().registerTrack(name);
+}
+
+void enableTrace(pnanovdb_bool_t enabled)
+{
+    trace_ring().setEnabled(enabled != PNANOVDB_FALSE);
+}
+
+pnanovdb_uint64_t traceTimestamp()
+{
+    return pnanovdb_util::TraceRing::now();
+}
+
+void traceScope(const char* category, const char* name, pnanovdb_uint64_t beginNs, pnanovdb_uint64_t endNs)
+{
+    trace_ring().record(category, name, beginNs, endNs);
+}
+
+pnanovdb_uint64_t exportTrace(char* dst, pnanovdb_uint64_t dstSize)
+{
+    std::lock_guard<std::mutex> lock(g_traceExportMutex);
+
+    if (!dst || g_traceExport.empty())
+    {
+        g_traceExport = trace_ring().exportChromeJson();
+    }
+    pnanovdb_uint64_t size = g_traceExport.size();
+    if (dst)
+    {
+        if (dstSize < size + 1u)
+        {
+            // a partial json document is useless, report the size and copy nothing
+            if (dstSize > 0u)
+            {
+                dst[0] = '\0';
+            }
+            return size;
+        }
+        memcpy(dst, g_traceExport.data(), size);
+        dst[size] = '\0';
+        g_traceExport.clear();
+    }
+    return size;
+}
+
+pnanovdb_bool_t saveTrace(const char* path)
+{
+    if (!path)
+    {
+        return PNANOVDB_FALSE;
+    }
+    std::string json = trace_ring().exportChromeJson();
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        return PNANOVDB_FALSE;
+    }
+    size_t written = fwrite(json.data(), 1u, json.size(), file);
+    fclose(file);
+    return written == json.size() ? PNANOVDB_TRUE : PNANOVDB_FALSE;
+}
+
+} // end namespace